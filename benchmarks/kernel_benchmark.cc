@@ -0,0 +1,212 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+/*
+ * A micro-benchmark for the kernels of the hyperbolic update.
+ *
+ * For a given spatial dimension and number of global refinement steps
+ * a synthetic shock tube mesh (with a perturbed uniform state) is
+ * created and a number of explicit Euler steps is performed. The time
+ * spent in each phase of EulerModule::single_step() is taken from the
+ * corresponding Scope timers ("time step [E] k - ...") and reported
+ * together with the degrees of freedom processed per second, and the
+ * modeled memory bandwidth and flop rate. All results are printed as
+ * one JSON object per line on rank 0.
+ *
+ * Usage:
+ *
+ *   kernel_benchmark [dim [refinement [warmup [repetitions]]]]
+ *
+ * A dimension of 0 (the default) runs the benchmark in 2D and 3D.
+ */
+
+#include <compile_time_options.h>
+
+#include "discretization.template.h"
+#include "euler_module.template.h"
+#include "initial_values.template.h"
+#include "introspection.h"
+#include "limiter.template.h"
+#include "offline_data.template.h"
+#include "problem_description.template.h"
+#include "riemann_solver.template.h"
+#include "simd.template.h"
+#include "sparse_matrix_simd.template.h"
+
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/parameter_acceptor.h>
+#include <deal.II/base/timer.h>
+
+#include <omp.h>
+
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+
+using namespace ryujin;
+using namespace dealii;
+
+namespace
+{
+  /*
+   * Strip the description of a timer section, i.e., return the common
+   * prefix "time step [E] k" of all timers belonging to the same
+   * phase.
+   */
+  std::string kernel_prefix(const std::string &name)
+  {
+    const auto position = name.find(" - ");
+    return name.substr(0, position);
+  }
+
+
+  template <int dim>
+  void run_benchmark(const MPI_Comm &mpi_communicator,
+                     const unsigned int refinement,
+                     const unsigned int n_warmup,
+                     const unsigned int n_repetitions)
+  {
+    using Number = NUMBER;
+
+    const auto rank = Utilities::MPI::this_mpi_process(mpi_communicator);
+
+    std::map<std::string, dealii::Timer> computing_timer;
+
+    ProblemDescription problem_description("ProblemDescription");
+    Discretization<dim> discretization(mpi_communicator, "Discretization");
+    OfflineData<dim, Number> offline_data(
+        mpi_communicator, discretization, "OfflineData");
+    InitialValues<dim, Number> initial_values(problem_description,
+                                              "InitialValues");
+    EulerModule<dim, Number> euler_module(mpi_communicator,
+                                          computing_timer,
+                                          offline_data,
+                                          problem_description,
+                                          initial_values,
+                                          "EulerModule");
+
+    std::stringstream parameters;
+    parameters << "subsection Discretization\n"
+               << "  set geometry = shocktube\n"
+               << "  set mesh refinement = " << refinement << "\n"
+               << "end\n"
+               << "subsection InitialValues\n"
+               << "  set configuration = uniform\n"
+               << "  set direction = " << (dim == 2 ? "1, 0" : "1, 0, 0")
+               << "\n"
+               << "  set perturbation = 0.01\n"
+               << "end\n";
+
+    ParameterAcceptor::prm.clear();
+    ParameterAcceptor::initialize(parameters);
+
+    discretization.prepare();
+    offline_data.prepare();
+    euler_module.prepare();
+
+    auto U = initial_values.interpolate(offline_data);
+
+    Number t = 0.;
+    for (unsigned int i = 0; i < n_warmup; ++i)
+      t += euler_module.euler_step(U, t);
+
+    /* Take a snapshot of the timers and kernel statistics: */
+
+    std::map<std::string, double> previous_time;
+    for (const auto &[name, timer] : computing_timer)
+      previous_time[kernel_prefix(name)] += timer.wall_time();
+    const auto previous_kernels = euler_module.kernel_statistics();
+
+    MPI_Barrier(mpi_communicator);
+    dealii::Timer total_timer;
+    for (unsigned int i = 0; i < n_repetitions; ++i)
+      t += euler_module.euler_step(U, t);
+    total_timer.stop();
+
+    std::map<std::string, double> kernel_time;
+    for (const auto &[name, timer] : computing_timer)
+      kernel_time[kernel_prefix(name)] += timer.wall_time();
+    kernel_time["total"] = total_timer.wall_time();
+    previous_time["total"] = 0.;
+
+    const double n_dofs = offline_data.dof_handler().n_dofs();
+    const double n_updates = n_dofs * n_repetitions;
+
+    for (const auto &[kernel, time] : kernel_time) {
+      const double seconds = Utilities::MPI::max(
+          time - previous_time[kernel], mpi_communicator);
+
+      double bytes = 0.;
+      double flops = 0.;
+      const auto &kernels = euler_module.kernel_statistics();
+      if (const auto it = kernels.find(kernel); it != kernels.end()) {
+        bytes = it->second.bytes;
+        flops = it->second.flops;
+        if (const auto it2 = previous_kernels.find(kernel);
+            it2 != previous_kernels.end()) {
+          bytes -= it2->second.bytes;
+          flops -= it2->second.flops;
+        }
+      }
+      bytes = Utilities::MPI::sum(bytes, mpi_communicator);
+      flops = Utilities::MPI::sum(flops, mpi_communicator);
+
+      if (rank != 0)
+        continue;
+
+      const double rate = seconds > 0. ? 1. / seconds : 0.;
+      std::cout << std::setprecision(6) << "{\"dim\": " << dim
+                << ", \"refinement\": " << refinement
+                << ", \"n_dofs\": " << n_dofs
+                << ", \"mpi_processes\": "
+                << Utilities::MPI::n_mpi_processes(mpi_communicator)
+                << ", \"threads\": " << MultithreadInfo::n_threads()
+                << ", \"kernel\": \"" << kernel << "\""
+                << ", \"repetitions\": " << n_repetitions
+                << ", \"seconds\": " << seconds
+                << ", \"dofs_per_second\": " << n_updates * rate
+                << ", \"gb_per_second\": " << 1.e-9 * bytes * rate
+                << ", \"gflops_per_second\": " << 1.e-9 * flops * rate << "}"
+                << std::endl;
+    }
+  }
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+  LSAN_DISABLE
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv);
+  omp_set_num_threads(MultithreadInfo::n_threads());
+  LSAN_ENABLE
+
+  MPI_Comm mpi_communicator(MPI_COMM_WORLD);
+
+  AssertThrow(argc <= 5,
+              ExcMessage("Invalid number of parameters. Usage: "
+                         "kernel_benchmark [dim [refinement [warmup "
+                         "[repetitions]]]]"));
+
+  const unsigned int dim = argc > 1 ? std::stoi(argv[1]) : 0;
+  const unsigned int refinement = argc > 2 ? std::stoi(argv[2]) : 5;
+  const unsigned int n_warmup = argc > 3 ? std::stoi(argv[3]) : 2;
+  const unsigned int n_repetitions = argc > 4 ? std::stoi(argv[4]) : 10;
+
+  AssertThrow(dim == 0 || dim == 2 || dim == 3,
+              ExcMessage("Only dim = 2 and dim = 3 are supported"));
+  AssertThrow(n_repetitions > 0,
+              ExcMessage("At least one repetition is necessary"));
+
+  if (dim == 0 || dim == 2)
+    run_benchmark<2>(mpi_communicator, refinement, n_warmup, n_repetitions);
+
+  if (dim == 0 || dim == 3)
+    run_benchmark<3>(mpi_communicator, refinement, n_warmup, n_repetitions);
+
+  return 0;
+}
@@ -0,0 +1,241 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+/*
+ * A weak and strong scaling benchmark of the hyperbolic update.
+ *
+ * For a given geometry configuration ("validation": the isentropic
+ * vortex of tests/validation-euler-*.prm, or "shocktube": a Mach 2
+ * shock front) a mesh is created and a fixed number of full time steps
+ * (EulerModule::step()) is performed:
+ *
+ *  - strong scaling: the mesh refinement is fixed, i.e., the total
+ *    number of degrees of freedom is independent of the number of MPI
+ *    ranks.
+ *  - weak scaling: the mesh refinement is increased by
+ *    round(log2(n_ranks) / dim) over the given refinement, i.e., the
+ *    number of degrees of freedom per rank stays (approximately)
+ *    constant for a number of ranks that is a power of 2^dim.
+ *
+ * Rank 0 prints the results as CSV in long format (one quantity per
+ * line) with the header
+ *
+ *   mode,geometry,dim,ranks,threads,refinement,dofs,dofs_per_rank,
+ *   cycles,quantity,value
+ *
+ * The quantities are the throughput figures of TimeLoop::print_throughput()
+ * ("wall time", "cycles per second", "MQ/s") and the maximal time over
+ * all ranks spent in every Scope timer section ("timer: <name>"). The
+ * output of runs of different releases can thus simply be concatenated
+ * (and compared against a baseline) by any CSV tool.
+ *
+ * Usage:
+ *
+ *   scaling_benchmark [weak|strong [geometry [dim [refinement [warmup
+ *                     [cycles]]]]]]
+ */
+
+#include <compile_time_options.h>
+
+#include "discretization.template.h"
+#include "euler_module.template.h"
+#include "initial_values.template.h"
+#include "introspection.h"
+#include "limiter.template.h"
+#include "offline_data.template.h"
+#include "problem_description.template.h"
+#include "riemann_solver.template.h"
+#include "simd.template.h"
+#include "sparse_matrix_simd.template.h"
+
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/parameter_acceptor.h>
+#include <deal.II/base/timer.h>
+
+#include <omp.h>
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+
+using namespace ryujin;
+using namespace dealii;
+
+namespace
+{
+  template <int dim>
+  void run_benchmark(const MPI_Comm &mpi_communicator,
+                     const std::string &mode,
+                     const std::string &geometry,
+                     const unsigned int base_refinement,
+                     const unsigned int n_warmup,
+                     const unsigned int n_cycles)
+  {
+    using Number = NUMBER;
+
+    const auto rank = Utilities::MPI::this_mpi_process(mpi_communicator);
+    const auto n_ranks = Utilities::MPI::n_mpi_processes(mpi_communicator);
+
+    const unsigned int refinement =
+        base_refinement +
+        (mode == "weak" ? static_cast<unsigned int>(
+                              std::lround(std::log2(double(n_ranks)) / dim))
+                        : 0u);
+
+    std::map<std::string, dealii::Timer> computing_timer;
+
+    ProblemDescription problem_description("ProblemDescription");
+    Discretization<dim> discretization(mpi_communicator, "Discretization");
+    OfflineData<dim, Number> offline_data(
+        mpi_communicator, discretization, "OfflineData");
+    InitialValues<dim, Number> initial_values(problem_description,
+                                              "InitialValues");
+    EulerModule<dim, Number> euler_module(mpi_communicator,
+                                          computing_timer,
+                                          offline_data,
+                                          problem_description,
+                                          initial_values,
+                                          "EulerModule");
+
+    std::stringstream parameters;
+    parameters << "subsection Discretization\n"
+               << "  set geometry = " << geometry << "\n"
+               << "  set mesh refinement = " << refinement << "\n";
+    if (geometry == "validation")
+      parameters << "  subsection validation\n"
+                 << "    set length = 10\n"
+                 << "  end\n"
+                 << "end\n"
+                 << "subsection InitialValues\n"
+                 << "  set configuration = isentropic vortex\n"
+                 << "  set direction = 1, 1\n"
+                 << "  set position = -1, -1\n"
+                 << "  subsection isentropic vortex\n"
+                 << "    set mach number = 1\n"
+                 << "    set beta = 5\n"
+                 << "  end\n"
+                 << "end\n";
+    else
+      parameters << "end\n"
+                 << "subsection InitialValues\n"
+                 << "  set configuration = shockfront\n"
+                 << "  set direction = " << (dim == 2 ? "1, 0" : "1, 0, 0")
+                 << "\n"
+                 << "end\n";
+    parameters << "subsection EulerModule\n"
+               << "  set cfl max = 0.4\n"
+               << "  set cfl update = 0.2\n"
+               << "  set limiter iterations = 2\n"
+               << "  set time step order = 3\n"
+               << "end\n";
+
+    ParameterAcceptor::prm.clear();
+    ParameterAcceptor::initialize(parameters);
+
+    discretization.prepare();
+    offline_data.prepare();
+    euler_module.prepare();
+
+    auto U = initial_values.interpolate(offline_data);
+
+    Number t = 0.;
+    for (unsigned int i = 0; i < n_warmup; ++i)
+      t += euler_module.step(U, t);
+
+    /* Take a snapshot of the timers: */
+
+    std::map<std::string, double> previous_time;
+    for (const auto &[name, timer] : computing_timer)
+      previous_time[name] = timer.wall_time();
+
+    MPI_Barrier(mpi_communicator);
+    dealii::Timer total_timer;
+    for (unsigned int i = 0; i < n_cycles; ++i)
+      t += euler_module.step(U, t);
+    total_timer.stop();
+
+    std::map<std::string, double> timer_sections;
+    for (const auto &[name, timer] : computing_timer)
+      timer_sections[name] = Utilities::MPI::max(
+          timer.wall_time() - previous_time[name], mpi_communicator);
+
+    const double wall_time =
+        Utilities::MPI::max(total_timer.wall_time(), mpi_communicator);
+
+    if (rank != 0)
+      return;
+
+    const double n_dofs = offline_data.dof_handler().n_dofs();
+
+    std::ostringstream prefix;
+    prefix << mode << "," << geometry << "," << dim << "," << n_ranks << ","
+           << MultithreadInfo::n_threads() << "," << refinement << ","
+           << std::setprecision(0) << std::fixed << n_dofs << ","
+           << n_dofs / n_ranks << "," << n_cycles << ",";
+
+    const auto print = [&](const std::string &quantity, const double value) {
+      std::cout << prefix.str() << "\"" << quantity << "\","
+                << std::scientific << std::setprecision(6) << value
+                << std::endl;
+    };
+
+    print("wall time", wall_time);
+    print("cycles per second", n_cycles / wall_time);
+    print("MQ/s", n_cycles * n_dofs / 1.e6 / wall_time);
+    for (const auto &[name, seconds] : timer_sections)
+      print("timer: " + name, seconds);
+  }
+} // namespace
+
+
+int main(int argc, char *argv[])
+{
+  LSAN_DISABLE
+  Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv);
+  omp_set_num_threads(MultithreadInfo::n_threads());
+  LSAN_ENABLE
+
+  MPI_Comm mpi_communicator(MPI_COMM_WORLD);
+
+  AssertThrow(argc <= 7,
+              ExcMessage("Invalid number of parameters. Usage: "
+                         "scaling_benchmark [weak|strong [geometry [dim "
+                         "[refinement [warmup [cycles]]]]]]"));
+
+  const std::string mode = argc > 1 ? argv[1] : "strong";
+  const std::string geometry = argc > 2 ? argv[2] : "validation";
+  const unsigned int dim = argc > 3 ? std::stoi(argv[3]) : 2;
+  const unsigned int refinement = argc > 4 ? std::stoi(argv[4]) : 7;
+  const unsigned int n_warmup = argc > 5 ? std::stoi(argv[5]) : 2;
+  const unsigned int n_cycles = argc > 6 ? std::stoi(argv[6]) : 20;
+
+  AssertThrow(mode == "weak" || mode == "strong",
+              ExcMessage("The scaling mode has to be \"weak\" or \"strong\""));
+  AssertThrow(geometry == "validation" || geometry == "shocktube",
+              ExcMessage("The geometry has to be \"validation\" or "
+                         "\"shocktube\""));
+  AssertThrow(dim == 2 || dim == 3,
+              ExcMessage("Only dim = 2 and dim = 3 are supported"));
+  AssertThrow(geometry != "validation" || dim == 2,
+              ExcMessage("The isentropic vortex is only available in 2D"));
+  AssertThrow(n_cycles > 0, ExcMessage("At least one cycle is necessary"));
+
+  if (Utilities::MPI::this_mpi_process(mpi_communicator) == 0)
+    std::cout << "mode,geometry,dim,ranks,threads,refinement,dofs,"
+              << "dofs_per_rank,cycles,quantity,value" << std::endl;
+
+  if (dim == 2)
+    run_benchmark<2>(
+        mpi_communicator, mode, geometry, refinement, n_warmup, n_cycles);
+  else
+    run_benchmark<3>(
+        mpi_communicator, mode, geometry, refinement, n_warmup, n_cycles);
+
+  return 0;
+}
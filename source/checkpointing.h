@@ -5,23 +5,127 @@
 
 #pragma once
 
+#include "lossy_compression.h"
+#include "offline_data.h"
+
+#include <deal.II/base/mpi.h>
 #include <deal.II/base/utilities.h>
+#include <deal.II/dofs/dof_tools.h>
 
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/core/demangle.hpp>
+#include <boost/serialization/vector.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <future>
+#include <limits>
+#include <map>
+#include <sstream>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 namespace ryujin
 {
+  /**
+   * Read a checkpoint written by write_checkpoint() from the stream @p
+   * input into the locally owned part of @p U, and the saved time @p t
+   * and output cycle @p output_cycle. Ghost values are not updated.
+   *
+   * @ingroup Miscellaneous
+   */
+  template<typename T1, typename T2, typename T3>
+  void read_checkpoint(std::istream &input,
+                       T1 &U,
+                       T2 &t,
+                       T3 &output_cycle,
+                       const std::vector<double> &error_bounds = {})
+  {
+    boost::archive::binary_iarchive ia(input);
+    ia >> t >> output_cycle;
+
+    if (error_bounds.empty()) {
+      for (auto &it : U) {
+        ia >> it;
+      }
+      return;
+    }
+
+    const unsigned int n_components = error_bounds.size();
+    const std::size_t n_values = (U.end() - U.begin()) / n_components;
+
+    for (unsigned int d = 0; d < n_components; ++d) {
+      std::vector<unsigned char> bytes;
+      ia >> bytes;
+      using Number = typename T1::value_type;
+      LossyCompression::decompress(bytes,
+                                   U.begin() + d,
+                                   n_values,
+                                   n_components,
+                                   Number(error_bounds[d]));
+    }
+  }
+
+
+  /**
+   * Serialize the locally owned part of the state @p U at time @p t and
+   * output cycle @p output_cycle into the stream @p output using
+   * boost::archive.
+   *
+   * If @p error_bounds is nonempty, it has to contain one (absolute)
+   * error bound per component of @p U. Every component is then stored
+   * with the error-bounded lossy coder LossyCompression::compress(). A
+   * nonpositive error bound stores the corresponding component
+   * verbatim.
+   *
+   * @ingroup Miscellaneous
+   */
+  template<typename T1, typename T2, typename T3>
+  void write_checkpoint(std::ostream &output,
+                        const T1 &U,
+                        const T2 t,
+                        const T3 output_cycle,
+                        const std::vector<double> &error_bounds = {})
+  {
+    boost::archive::binary_oarchive oa(output);
+    oa << t << output_cycle;
+
+    if (error_bounds.empty()) {
+      for (const auto &it : U)
+        oa << it;
+      return;
+    }
+
+    const unsigned int n_components = error_bounds.size();
+    const std::size_t n_values = (U.end() - U.begin()) / n_components;
+    AssertThrow(n_values * n_components == std::size_t(U.end() - U.begin()),
+                dealii::ExcMessage("The number of error bounds does not "
+                                   "match the number of components"));
+
+    using Number = typename T1::value_type;
+    for (unsigned int d = 0; d < n_components; ++d) {
+      const auto bytes = LossyCompression::compress(
+          U.begin() + d, n_values, n_components, Number(error_bounds[d]));
+      oa << bytes;
+    }
+  }
+
+
   /**
    * Performs a resume operation. Given a @p base_name the function tries
    * to locate correponding checkpoint files and will read in the saved
    * state @p U at saved time @p t with saved output cycle @p output_cycle.
    *
+   * If @p error_bounds is nonempty the checkpoint is expected to have
+   * been written by do_checkpoint() with the same (per component) error
+   * bounds.
+   *
    * @todo Some day, we should refactor this into a class and do something
    * smarter...
    *
@@ -32,18 +136,14 @@ namespace ryujin
                  unsigned int id,
                  T1 &U,
                  T2 &t,
-                 T3 &output_cycle)
+                 T3 &output_cycle,
+                 const std::vector<double> &error_bounds = {})
   {
     std::string name = base_name + "-checkpoint-" +
                        dealii::Utilities::int_to_string(id, 4) + ".archive";
     std::ifstream file(name, std::ios::binary);
 
-    boost::archive::binary_iarchive ia(file);
-    ia >> t >> output_cycle;
-
-    for (auto &it : U) {
-      ia >> it;
-    }
+    read_checkpoint(file, U, t, output_cycle, error_bounds);
     U.update_ghost_values();
   }
 
@@ -52,6 +152,7 @@ namespace ryujin
    * Writes out a checkpoint to disk. Given a @p base_name and a current
    * state @p U at time @p t and output cycle @p output_cycle the function
    * writes out the state to disk using boost::archive for serialization.
+   * See write_checkpoint() for the meaning of @p error_bounds.
    *
    * @todo Some day, we should refactor this into a class and do something
    * smarter...
@@ -63,7 +164,8 @@ namespace ryujin
                      unsigned int id,
                      const T1 &U,
                      const T2 t,
-                     const T3 output_cycle)
+                     const T3 output_cycle,
+                     const std::vector<double> &error_bounds = {})
   {
     std::string name = base_name + "-checkpoint-" +
                        dealii::Utilities::int_to_string(id, 4) + ".archive";
@@ -73,9 +175,841 @@ namespace ryujin
 
     std::ofstream file(name, std::ios::binary | std::ios::trunc);
 
-    boost::archive::binary_oarchive oa(file);
-    oa << t << output_cycle;
-    for (const auto &it : U)
-      oa << it;
+    write_checkpoint(file, U, t, output_cycle, error_bounds);
   }
+
+
+  namespace
+  {
+    /*
+     * Header of a collective checkpoint file. The header is followed
+     * (at offset collective_checkpoint_offset) by the locally owned
+     * state of all ranks in global DoF order and a table of the support
+     * points of all degrees of freedom (again in global DoF order).
+     */
+    struct CollectiveCheckpointHeader {
+      char magic[16];
+      std::uint64_t dim;
+      std::uint64_t n_components;
+      std::uint64_t sizeof_number;
+      std::uint64_t n_global_dofs;
+      std::uint64_t n_mpi_processes;
+      std::uint64_t output_cycle;
+      double t;
+    };
+
+    constexpr char collective_checkpoint_magic[16] = "ryujin-ckpt-v1";
+    constexpr MPI_Offset collective_checkpoint_offset = 4096;
+
+    static_assert(sizeof(CollectiveCheckpointHeader) <=
+                  collective_checkpoint_offset);
+
+
+    /*
+     * Return the support points of all locally owned degrees of freedom
+     * (in local index order).
+     */
+    template <int dim, typename Number>
+    std::vector<dealii::Point<dim>>
+    locally_owned_support_points(const OfflineData<dim, Number> &offline_data)
+    {
+      const auto &dof_handler = offline_data.dof_handler();
+      const auto &locally_owned = dof_handler.locally_owned_dofs();
+
+      std::map<dealii::types::global_dof_index, dealii::Point<dim>> map;
+      dealii::DoFTools::map_dofs_to_support_points(
+          offline_data.discretization().mapping(), dof_handler, map);
+
+      std::vector<dealii::Point<dim>> points(locally_owned.n_elements());
+      for (const auto &[index, point] : map)
+        if (locally_owned.is_element(index))
+          points[locally_owned.index_within_set(index)] = point;
+
+      return points;
+    }
+
+
+    /*
+     * Compare two support points up to a relative tolerance.
+     */
+    template <int dim>
+    bool support_points_match(const dealii::Point<dim> &p,
+                              const double *q)
+    {
+      for (unsigned int d = 0; d < dim; ++d)
+        if (std::abs(p[d] - q[d]) > 1.e-10 * (1. + std::abs(p[d])))
+          return false;
+      return true;
+    }
+  } // namespace
+
+
+  /**
+   * Write out the state @p U at time @p t and output cycle @p
+   * output_cycle into a single checkpoint file
+   * "base_name-checkpoint.data" with collective MPI IO.
+   *
+   * The file consists of a small header, the raw locally owned data of
+   * all ranks in global DoF order, and a table of the support points of
+   * all degrees of freedom. The state is always stored in double
+   * precision: For Number = double it is written directly from the
+   * storage of @p U without any intermediate copy, a single precision
+   * state is promoted to double first.
+   *
+   * @ingroup Miscellaneous
+   */
+  template <int dim, typename Number, int n_components>
+  void do_checkpoint_collective(
+      const std::string &base_name,
+      const OfflineData<dim, Number> &offline_data,
+      const MultiComponentVector<Number, n_components> &U,
+      const Number t,
+      const unsigned int output_cycle,
+      const MPI_Comm &mpi_communicator)
+  {
+    const std::string name = base_name + "-checkpoint.data";
+
+    const auto mpi_rank =
+        dealii::Utilities::MPI::this_mpi_process(mpi_communicator);
+
+    if (mpi_rank == 0 && std::filesystem::exists(name))
+      std::filesystem::rename(name, name + "~");
+    MPI_Barrier(mpi_communicator);
+
+    const auto &locally_owned = offline_data.dof_handler().locally_owned_dofs();
+    const unsigned int n_owned = offline_data.n_locally_owned();
+    const auto n_global = locally_owned.size();
+    const auto first = n_owned > 0 ? locally_owned.nth_index_in_set(0) : 0;
+
+    MPI_File file;
+    int ierr = MPI_File_open(mpi_communicator,
+                             name.c_str(),
+                             MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                             MPI_INFO_NULL,
+                             &file);
+    AssertThrow(ierr == MPI_SUCCESS,
+                dealii::ExcMessage("Could not open checkpoint file " + name));
+
+    if (mpi_rank == 0) {
+      CollectiveCheckpointHeader header;
+      std::memset(&header, 0, sizeof(header));
+      std::memcpy(header.magic, collective_checkpoint_magic, 16);
+      header.dim = dim;
+      header.n_components = n_components;
+      header.sizeof_number = sizeof(double);
+      header.n_global_dofs = n_global;
+      header.n_mpi_processes =
+          dealii::Utilities::MPI::n_mpi_processes(mpi_communicator);
+      header.output_cycle = output_cycle;
+      header.t = t;
+      MPI_File_write_at(
+          file, 0, &header, sizeof(header), MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+
+    /* State, written directly from the vector storage if possible: */
+
+    std::vector<double> promoted;
+    const double *data = nullptr;
+    if constexpr (std::is_same_v<Number, double>) {
+      data = U.begin();
+    } else {
+      promoted.assign(U.begin(), U.begin() + n_owned * n_components);
+      data = promoted.data();
+    }
+
+    MPI_Datatype state_type;
+    MPI_Type_contiguous(n_components * sizeof(double), MPI_BYTE, &state_type);
+    MPI_Type_commit(&state_type);
+
+    ierr = MPI_File_write_at_all(
+        file,
+        collective_checkpoint_offset +
+            MPI_Offset(first) * n_components * sizeof(double),
+        data,
+        n_owned,
+        state_type,
+        MPI_STATUS_IGNORE);
+    AssertThrow(ierr == MPI_SUCCESS,
+                dealii::ExcMessage("Could not write checkpoint file " + name));
+
+    MPI_Type_free(&state_type);
+
+    /* Support point table: */
+
+    const auto points = locally_owned_support_points(offline_data);
+    std::vector<double> coordinates(dim * n_owned);
+    for (unsigned int i = 0; i < n_owned; ++i)
+      for (unsigned int d = 0; d < dim; ++d)
+        coordinates[i * dim + d] = points[i][d];
+
+    ierr = MPI_File_write_at_all(
+        file,
+        collective_checkpoint_offset +
+            MPI_Offset(n_global) * n_components * sizeof(double) +
+            MPI_Offset(first) * dim * sizeof(double),
+        coordinates.data(),
+        dim * n_owned,
+        MPI_DOUBLE,
+        MPI_STATUS_IGNORE);
+    AssertThrow(ierr == MPI_SUCCESS,
+                dealii::ExcMessage("Could not write checkpoint file " + name));
+
+    MPI_File_close(&file);
+  }
+
+
+  /**
+   * Resume from a checkpoint file written by do_checkpoint_collective().
+   *
+   * If the checkpoint was written with the same number of MPI ranks and
+   * the same partitioning, every rank reads its locally owned data in a
+   * single collective read directly into @p U. Otherwise (for example,
+   * when restarting on a different number of ranks), every rank scans the
+   * support point table of the file and picks up the values of all
+   * degrees of freedom it owns. This requires the same mesh and finite
+   * element, but is independent of the partitioning. The (double
+   * precision) state of the file is converted to Number on the fly.
+   *
+   * @ingroup Miscellaneous
+   */
+  template <int dim, typename Number, int n_components>
+  void do_resume_collective(const std::string &base_name,
+                            const OfflineData<dim, Number> &offline_data,
+                            MultiComponentVector<Number, n_components> &U,
+                            Number &t,
+                            unsigned int &output_cycle,
+                            const MPI_Comm &mpi_communicator)
+  {
+    const std::string name = base_name + "-checkpoint.data";
+
+    const auto &locally_owned = offline_data.dof_handler().locally_owned_dofs();
+    const unsigned int n_owned = offline_data.n_locally_owned();
+    const auto n_global = locally_owned.size();
+    const auto first = n_owned > 0 ? locally_owned.nth_index_in_set(0) : 0;
+
+    MPI_File file;
+    int ierr = MPI_File_open(mpi_communicator,
+                             name.c_str(),
+                             MPI_MODE_RDONLY,
+                             MPI_INFO_NULL,
+                             &file);
+    AssertThrow(ierr == MPI_SUCCESS,
+                dealii::ExcMessage("Could not open checkpoint file " + name));
+
+    CollectiveCheckpointHeader header;
+    MPI_File_read_at_all(
+        file, 0, &header, sizeof(header), MPI_BYTE, MPI_STATUS_IGNORE);
+
+    AssertThrow(std::memcmp(header.magic, collective_checkpoint_magic, 16) ==
+                    0,
+                dealii::ExcMessage("Invalid checkpoint file " + name));
+    AssertThrow(header.dim == dim && header.n_components == n_components &&
+                    header.sizeof_number == sizeof(double) &&
+                    header.n_global_dofs == n_global,
+                dealii::ExcMessage("The checkpoint file " + name +
+                                   " does not match the current "
+                                   "discretization"));
+
+    t = header.t;
+    output_cycle = header.output_cycle;
+
+    const MPI_Offset points_offset =
+        collective_checkpoint_offset +
+        MPI_Offset(n_global) * n_components * sizeof(double);
+
+    const auto points = locally_owned_support_points(offline_data);
+
+    /*
+     * Fast path: Verify that our support points are stored at the very
+     * same position in the file.
+     */
+
+    std::vector<double> coordinates(dim * n_owned);
+    MPI_File_read_at_all(file,
+                         points_offset +
+                             MPI_Offset(first) * dim * sizeof(double),
+                         coordinates.data(),
+                         dim * n_owned,
+                         MPI_DOUBLE,
+                         MPI_STATUS_IGNORE);
+
+    bool same_layout = true;
+    for (unsigned int i = 0; same_layout && i < n_owned; ++i)
+      same_layout = support_points_match(points[i], &coordinates[i * dim]);
+
+    same_layout = dealii::Utilities::MPI::min(
+        static_cast<unsigned int>(same_layout), mpi_communicator);
+
+    if (same_layout) {
+      std::vector<double> promoted;
+      double *data = nullptr;
+      if constexpr (std::is_same_v<Number, double>) {
+        data = U.begin();
+      } else {
+        promoted.resize(n_owned * n_components);
+        data = promoted.data();
+      }
+
+      MPI_Datatype state_type;
+      MPI_Type_contiguous(
+          n_components * sizeof(double), MPI_BYTE, &state_type);
+      MPI_Type_commit(&state_type);
+
+      ierr = MPI_File_read_at_all(
+          file,
+          collective_checkpoint_offset +
+              MPI_Offset(first) * n_components * sizeof(double),
+          data,
+          n_owned,
+          state_type,
+          MPI_STATUS_IGNORE);
+      AssertThrow(ierr == MPI_SUCCESS,
+                  dealii::ExcMessage("Could not read checkpoint file " + name));
+
+      MPI_Type_free(&state_type);
+      if constexpr (!std::is_same_v<Number, double>)
+        std::copy(promoted.begin(), promoted.end(), U.begin());
+      MPI_File_close(&file);
+      U.update_ghost_values();
+      return;
+    }
+
+    /*
+     * Slow path: Scan the entire support point table in chunks and pick
+     * up all locally owned degrees of freedom. Local support points are
+     * sorted lexicographically for lookup.
+     */
+
+    std::vector<unsigned int> permutation(n_owned);
+    for (unsigned int i = 0; i < n_owned; ++i)
+      permutation[i] = i;
+    std::sort(permutation.begin(),
+              permutation.end(),
+              [&](const unsigned int a, const unsigned int b) {
+                for (unsigned int d = 0; d < dim; ++d)
+                  if (points[a][d] != points[b][d])
+                    return points[a][d] < points[b][d];
+                return false;
+              });
+
+    constexpr dealii::types::global_dof_index chunk_size = 1 << 20;
+
+    std::vector<double> chunk_coordinates;
+    std::vector<double> chunk_state;
+    std::vector<bool> found(n_owned, false);
+
+    for (dealii::types::global_dof_index begin = 0; begin < n_global;
+         begin += chunk_size) {
+      const auto size = std::min(chunk_size, n_global - begin);
+
+      chunk_coordinates.resize(dim * size);
+      MPI_File_read_at(file,
+                       points_offset + MPI_Offset(begin) * dim * sizeof(double),
+                       chunk_coordinates.data(),
+                       dim * size,
+                       MPI_DOUBLE,
+                       MPI_STATUS_IGNORE);
+
+      chunk_state.resize(n_components * size);
+      MPI_File_read_at(file,
+                       collective_checkpoint_offset +
+                           MPI_Offset(begin) * n_components * sizeof(double),
+                       chunk_state.data(),
+                       n_components * size * sizeof(double),
+                       MPI_BYTE,
+                       MPI_STATUS_IGNORE);
+
+      for (unsigned int k = 0; k < size; ++k) {
+        const double *q = &chunk_coordinates[k * dim];
+        const double tolerance = 1.e-10 * (1. + std::abs(q[0]));
+
+        auto it = std::lower_bound(
+            permutation.begin(),
+            permutation.end(),
+            q[0] - tolerance,
+            [&](const unsigned int a, const double value) {
+              return points[a][0] < value;
+            });
+
+        for (; it != permutation.end() && points[*it][0] <= q[0] + tolerance;
+             ++it) {
+          if (!support_points_match(points[*it], q))
+            continue;
+          std::copy(&chunk_state[k * n_components],
+                    &chunk_state[(k + 1) * n_components],
+                    U.begin() + *it * n_components);
+          found[*it] = true;
+          break;
+        }
+      }
+    }
+
+    MPI_File_close(&file);
+
+    AssertThrow(std::all_of(found.begin(), found.end(), [](bool b) {
+                  return b;
+                }),
+                dealii::ExcMessage("The checkpoint file " + name +
+                                   " does not contain all degrees of "
+                                   "freedom of the current discretization"));
+
+    U.update_ghost_values();
+  }
+
+
+  /**
+   * Asynchronous checkpointing with copy-on-snapshot.
+   *
+   * A call to schedule() copies the locally owned part of the state
+   * vector (and all other data needed for the checkpoint) into a staging
+   * buffer and returns immediately. The checkpoint is then written out
+   * by a background thread that does not call into MPI. Only a
+   * subsequent call to schedule() (or wait()) blocks until the previous
+   * checkpoint has been written.
+   *
+   * Lossless checkpoints are written with the file layout of
+   * do_checkpoint_collective() (and can thus be resumed with
+   * do_resume_collective()): The header is written by rank 0 within
+   * schedule() and every rank writes its disjoint slices of the state and
+   * the support point table into the shared file. If @p error_bounds is
+   * nonempty, per-rank archives are written with do_checkpoint().
+   *
+   * @ingroup Miscellaneous
+   */
+  template <int dim, typename Number>
+  class AsynchronousCheckpointing
+  {
+  public:
+    /**
+     * @copydoc OfflineData::vector_type
+     */
+    using vector_type = typename OfflineData<dim, Number>::vector_type;
+
+    /**
+     * @copydoc ProblemDescription::problem_dimension
+     */
+    // clang-format off
+    static constexpr unsigned int problem_dimension = ProblemDescription::problem_dimension<dim>;
+    // clang-format on
+
+    /**
+     * Constructor.
+     */
+    AsynchronousCheckpointing(const MPI_Comm &mpi_communicator)
+        : mpi_communicator_(mpi_communicator)
+    {
+    }
+
+    /**
+     * Destructor. Waits for a pending checkpoint.
+     */
+    ~AsynchronousCheckpointing()
+    {
+      if (future_.valid())
+        future_.wait();
+    }
+
+    /**
+     * Snapshot the state @p U at time @p t and output cycle @p
+     * output_cycle and write out a checkpoint in the background. This
+     * function is collective and waits for the previous checkpoint on all
+     * ranks to be completed first.
+     */
+    void schedule(const std::string &base_name,
+                  const OfflineData<dim, Number> &offline_data,
+                  const vector_type &U,
+                  const Number t,
+                  const unsigned int output_cycle,
+                  const std::vector<double> &error_bounds = {})
+    {
+      wait();
+      MPI_Barrier(mpi_communicator_);
+
+      if (staging_.size() != U.size() ||
+          staging_.get_partitioner() != U.get_partitioner())
+        staging_.reinit(U, /*omit_zeroing_entries*/ true);
+      std::copy(U.begin(), U.end(), staging_.begin());
+
+      if (!error_bounds.empty()) {
+        const auto id = offline_data.discretization()
+                            .triangulation()
+                            .locally_owned_subdomain();
+        future_ = std::async(
+            std::launch::async,
+            [this, base_name, id, t, output_cycle, error_bounds]() {
+              do_checkpoint(
+                  base_name, id, staging_, t, output_cycle, error_bounds);
+            });
+        return;
+      }
+
+      const std::string name = base_name + "-checkpoint.data";
+
+      const auto &locally_owned =
+          offline_data.dof_handler().locally_owned_dofs();
+      const unsigned int n_owned = offline_data.n_locally_owned();
+      const auto n_global = locally_owned.size();
+      const auto first = n_owned > 0 ? locally_owned.nth_index_in_set(0) : 0;
+
+      /* Move the old checkpoint out of the way and write the header: */
+
+      if (dealii::Utilities::MPI::this_mpi_process(mpi_communicator_) == 0) {
+        if (std::filesystem::exists(name))
+          std::filesystem::rename(name, name + "~");
+
+        CollectiveCheckpointHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, collective_checkpoint_magic, 16);
+        header.dim = dim;
+        header.n_components = problem_dimension;
+        header.sizeof_number = sizeof(double);
+        header.n_global_dofs = n_global;
+        header.n_mpi_processes =
+            dealii::Utilities::MPI::n_mpi_processes(mpi_communicator_);
+        header.output_cycle = output_cycle;
+        header.t = t;
+
+        std::ofstream file(name, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        AssertThrow(file.good(),
+                    dealii::ExcMessage("Could not write checkpoint file " +
+                                       name));
+      }
+      MPI_Barrier(mpi_communicator_);
+
+      const auto points = locally_owned_support_points(offline_data);
+      coordinates_.resize(dim * n_owned);
+      for (unsigned int i = 0; i < n_owned; ++i)
+        for (unsigned int d = 0; d < dim; ++d)
+          coordinates_[i * dim + d] = points[i][d];
+
+      /* The file layout stores the state in double precision: */
+      const double *data = nullptr;
+      if constexpr (std::is_same_v<Number, double>) {
+        data = staging_.begin();
+      } else {
+        promoted_.assign(staging_.begin(),
+                         staging_.begin() + n_owned * problem_dimension);
+        data = promoted_.data();
+      }
+
+      const std::size_t state_offset =
+          collective_checkpoint_offset +
+          std::size_t(first) * problem_dimension * sizeof(double);
+      const std::size_t points_offset =
+          collective_checkpoint_offset +
+          std::size_t(n_global) * problem_dimension * sizeof(double) +
+          std::size_t(first) * dim * sizeof(double);
+
+      future_ = std::async(std::launch::async, [=]() {
+        /* Only touches the staging buffers, no MPI calls: */
+        std::fstream file(name,
+                          std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(state_offset);
+        file.write(reinterpret_cast<const char *>(data),
+                   std::size_t(n_owned) * problem_dimension * sizeof(double));
+        file.seekp(points_offset);
+        file.write(reinterpret_cast<const char *>(coordinates_.data()),
+                   coordinates_.size() * sizeof(double));
+        AssertThrow(file.good(),
+                    dealii::ExcMessage("Could not write checkpoint file " +
+                                       name));
+      });
+    }
+
+    /**
+     * Wait for a pending checkpoint to be written out. Exceptions thrown
+     * by the background thread are rethrown here.
+     */
+    void wait()
+    {
+      if (future_.valid())
+        future_.get();
+    }
+
+  private:
+    const MPI_Comm &mpi_communicator_;
+
+    vector_type staging_;
+    std::vector<double> promoted_;
+    std::vector<double> coordinates_;
+
+    std::future<void> future_;
+  };
+
+
+  namespace
+  {
+    /*
+     * Return the rank offset of the partner that holds a copy of our
+     * node-local checkpoint. We use the number of ranks per shared memory
+     * node so that (for homogeneous node sizes) the partner lives on the
+     * next node.
+     */
+    inline unsigned int partner_offset(const MPI_Comm &mpi_communicator)
+    {
+      MPI_Comm node_communicator;
+      MPI_Comm_split_type(mpi_communicator,
+                          MPI_COMM_TYPE_SHARED,
+                          0,
+                          MPI_INFO_NULL,
+                          &node_communicator);
+      const auto node_size =
+          dealii::Utilities::MPI::n_mpi_processes(node_communicator);
+      MPI_Comm_free(&node_communicator);
+
+      const auto n_mpi_processes =
+          dealii::Utilities::MPI::n_mpi_processes(mpi_communicator);
+      return node_size % n_mpi_processes;
+    }
+
+
+    inline std::string local_checkpoint_name(const std::string &directory,
+                                             const std::string &base_name,
+                                             const std::string &kind,
+                                             const unsigned int id)
+    {
+      const auto file_name =
+          std::filesystem::path(base_name).filename().string();
+      return directory + "/" + file_name + "-" + kind + "-" +
+             dealii::Utilities::int_to_string(id, 4) + ".archive";
+    }
+
+
+    inline void write_buffer(const std::string &name,
+                             const std::string &buffer)
+    {
+      if (std::filesystem::exists(name))
+        std::filesystem::rename(name, name + "~");
+      std::ofstream file(name, std::ios::binary | std::ios::trunc);
+      file.write(buffer.data(), buffer.size());
+      AssertThrow(file.good(),
+                  dealii::ExcMessage("Could not write checkpoint file " +
+                                     name));
+    }
+
+
+    inline bool read_buffer(const std::string &name, std::string &buffer)
+    {
+      std::ifstream file(name, std::ios::binary);
+      if (!file.good())
+        return false;
+      std::ostringstream stream;
+      stream << file.rdbuf();
+      buffer = stream.str();
+      return true;
+    }
+  } // namespace
+
+
+  /**
+   * Write out a node-local checkpoint into @p local_directory (for
+   * example, a RAM disk or a node-local SSD). If @p partner_copy is
+   * true, a copy of the serialized checkpoint is also sent to a partner
+   * rank on the next node (the rank with an offset equal to the number
+   * of ranks per node) and stored in its node-local directory. This
+   * allows to recover from the loss of a single node. See
+   * write_checkpoint() for the meaning of @p error_bounds.
+   *
+   * This function is collective.
+   *
+   * @ingroup Miscellaneous
+   */
+  template<typename T1, typename T2, typename T3>
+  void do_checkpoint_multilevel(const std::string &local_directory,
+                                const std::string &base_name,
+                                const T1 &U,
+                                const T2 t,
+                                const T3 output_cycle,
+                                const bool partner_copy,
+                                const std::vector<double> &error_bounds,
+                                const MPI_Comm &mpi_communicator)
+  {
+    const auto mpi_rank =
+        dealii::Utilities::MPI::this_mpi_process(mpi_communicator);
+    const auto n_mpi_processes =
+        dealii::Utilities::MPI::n_mpi_processes(mpi_communicator);
+
+    std::filesystem::create_directories(local_directory);
+
+    std::ostringstream stream;
+    write_checkpoint(stream, U, t, output_cycle, error_bounds);
+    const std::string buffer = stream.str();
+
+    const auto name = local_checkpoint_name(
+        local_directory, base_name, "checkpoint", mpi_rank);
+    write_buffer(name, buffer);
+
+    const auto offset = partner_offset(mpi_communicator);
+    if (!partner_copy || offset == 0)
+      return;
+
+    const unsigned int holder = (mpi_rank + offset) % n_mpi_processes;
+    const unsigned int source =
+        (mpi_rank + n_mpi_processes - offset) % n_mpi_processes;
+
+    AssertThrow(buffer.size() <= std::numeric_limits<int>::max(),
+                dealii::ExcMessage("Node-local checkpoint too large for a "
+                                   "partner copy"));
+
+    unsigned long long size = buffer.size();
+    unsigned long long partner_size = 0;
+    MPI_Sendrecv(&size,
+                 1,
+                 MPI_UNSIGNED_LONG_LONG,
+                 holder,
+                 0,
+                 &partner_size,
+                 1,
+                 MPI_UNSIGNED_LONG_LONG,
+                 source,
+                 0,
+                 mpi_communicator,
+                 MPI_STATUS_IGNORE);
+
+    std::string partner_buffer(partner_size, '\0');
+    MPI_Sendrecv(buffer.data(),
+                 size,
+                 MPI_BYTE,
+                 holder,
+                 1,
+                 partner_buffer.data(),
+                 partner_size,
+                 MPI_BYTE,
+                 source,
+                 1,
+                 mpi_communicator,
+                 MPI_STATUS_IGNORE);
+
+    write_buffer(
+        local_checkpoint_name(local_directory, base_name, "partner", source),
+        partner_buffer);
+  }
+
+
+  /**
+   * Try to resume from node-local checkpoints written by
+   * do_checkpoint_multilevel(). Every rank reads its own node-local
+   * checkpoint. If it is missing (for example, because the node was
+   * replaced) and @p partner_copy is true, the copy is fetched from the
+   * partner rank instead.
+   *
+   * The function returns false (and leaves @p U in an undefined state)
+   * if not all ranks could recover a checkpoint, or if the recovered
+   * checkpoints belong to different output cycles. In this case, the
+   * caller should fall back to the checkpoint on the parallel
+   * filesystem. Resuming from node-local checkpoints requires the same
+   * number of ranks and the same placement of ranks on nodes.
+   *
+   * This function is collective.
+   *
+   * @ingroup Miscellaneous
+   */
+  template<typename T1, typename T2, typename T3>
+  bool do_resume_multilevel(const std::string &local_directory,
+                            const std::string &base_name,
+                            T1 &U,
+                            T2 &t,
+                            T3 &output_cycle,
+                            const bool partner_copy,
+                            const std::vector<double> &error_bounds,
+                            const MPI_Comm &mpi_communicator)
+  {
+    const auto mpi_rank =
+        dealii::Utilities::MPI::this_mpi_process(mpi_communicator);
+    const auto n_mpi_processes =
+        dealii::Utilities::MPI::n_mpi_processes(mpi_communicator);
+
+    std::string buffer;
+    const auto name = local_checkpoint_name(
+        local_directory, base_name, "checkpoint", mpi_rank);
+    bool found = read_buffer(name, buffer);
+
+    const auto offset = partner_offset(mpi_communicator);
+    if (partner_copy && offset != 0) {
+      const unsigned int holder = (mpi_rank + offset) % n_mpi_processes;
+      const unsigned int source =
+          (mpi_rank + n_mpi_processes - offset) % n_mpi_processes;
+
+      /* Ask our holder for the copy if we are missing a checkpoint: */
+
+      int need = !found;
+      int source_needs = 0;
+      MPI_Sendrecv(&need,
+                   1,
+                   MPI_INT,
+                   holder,
+                   0,
+                   &source_needs,
+                   1,
+                   MPI_INT,
+                   source,
+                   0,
+                   mpi_communicator,
+                   MPI_STATUS_IGNORE);
+
+      std::string partner_buffer;
+      unsigned long long partner_size = 0;
+      std::array<MPI_Request, 2> requests{{MPI_REQUEST_NULL, MPI_REQUEST_NULL}};
+
+      if (source_needs) {
+        if (read_buffer(local_checkpoint_name(
+                            local_directory, base_name, "partner", source),
+                        partner_buffer))
+          partner_size = partner_buffer.size();
+        MPI_Isend(&partner_size,
+                  1,
+                  MPI_UNSIGNED_LONG_LONG,
+                  source,
+                  1,
+                  mpi_communicator,
+                  &requests[0]);
+        MPI_Isend(partner_buffer.data(),
+                  partner_size,
+                  MPI_BYTE,
+                  source,
+                  2,
+                  mpi_communicator,
+                  &requests[1]);
+      }
+
+      if (need) {
+        unsigned long long size = 0;
+        MPI_Recv(&size,
+                 1,
+                 MPI_UNSIGNED_LONG_LONG,
+                 holder,
+                 1,
+                 mpi_communicator,
+                 MPI_STATUS_IGNORE);
+        buffer.resize(size);
+        MPI_Recv(buffer.data(),
+                 size,
+                 MPI_BYTE,
+                 holder,
+                 2,
+                 mpi_communicator,
+                 MPI_STATUS_IGNORE);
+        found = size > 0;
+      }
+
+      MPI_Waitall(2, requests.data(), MPI_STATUSES_IGNORE);
+    }
+
+    if (dealii::Utilities::MPI::min(static_cast<unsigned int>(found),
+                                    mpi_communicator) == 0)
+      return false;
+
+    std::istringstream stream(buffer);
+    read_checkpoint(stream, U, t, output_cycle, error_bounds);
+
+    const unsigned int cycle = output_cycle;
+    if (dealii::Utilities::MPI::min(cycle, mpi_communicator) !=
+        dealii::Utilities::MPI::max(cycle, mpi_communicator))
+      return false;
+
+    U.update_ghost_values();
+    return true;
+  }
+
 } // namespace ryujin
@@ -0,0 +1,291 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include <compile_time_options.h>
+
+#include "trace.h"
+
+#include <deal.II/base/mpi.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace ryujin
+{
+  /**
+   * A small helper class that keeps track of (and optionally drives)
+   * pending nonblocking MPI ghost exchanges.
+   *
+   * Intended use:
+   * ```
+   * communication_progress.start(
+   *     [&]() { vector.update_ghost_values_start(channel++); });
+   *
+   * RYUJIN_PARALLEL_REGION_BEGIN
+   * CommunicationProgress::ComputeSection section(communication_progress);
+   *
+   * // computation
+   *
+   * RYUJIN_PARALLEL_REGION_END
+   *
+   * communication_progress.complete(
+   *     [&]() { vector.update_ghost_values_finish(); });
+   * ```
+   *
+   * The class records how much wall time every exchange spent in flight
+   * (between start() and complete()) and how much time was subsequently
+   * spent blocking in the finish payload. This allows to quantify how
+   * much of the ghost exchange was actually hidden behind computation.
+   * Every exchange is also recorded in the Trace (if enabled).
+   *
+   * If ryujin is configured with USE_COMMUNICATION_PROGRESS_THREAD the
+   * class in addition spawns a dedicated thread that repeatedly calls
+   * MPI_Iprobe() while an exchange is in flight. This forces the MPI
+   * progress engine of most MPI implementations to make progress on
+   * pending requests. In order to keep the MPI_THREAD_SERIALIZED
+   * requirement intact the thread is only ever active while (a) an
+   * exchange is pending and (b) at least one thread is inside a
+   * ComputeSection, i.e., inside a section of pure computation. The start
+   * and finish payloads (the only MPI calls permitted inside a
+   * ComputeSection) are executed with the thread paused and serialized
+   * by a mutex. MPI calls outside of a ComputeSection need no special
+   * care. Otherwise, the thread sleeps on a condition variable. It is
+   * advisable to reserve a hardware thread for this purpose, i.e., to run
+   * with one OpenMP thread less than available cores.
+   *
+   * @ingroup Miscellaneous
+   */
+  class CommunicationProgress
+  {
+  public:
+    /**
+     * A scoped guard marking a section of pure computation (typically
+     * the body of a parallel region) during which the progress thread
+     * may drive pending exchanges. The guard may be instantiated
+     * concurrently by all threads of a parallel region; the progress
+     * thread is paused again when the last guard is destroyed.
+     */
+    class ComputeSection
+    {
+    public:
+      ComputeSection(CommunicationProgress &communication_progress)
+          : communication_progress_(communication_progress)
+      {
+        communication_progress_.enter_compute_section();
+      }
+
+      ~ComputeSection()
+      {
+        communication_progress_.leave_compute_section();
+      }
+
+      ComputeSection(const ComputeSection &) = delete;
+      ComputeSection &operator=(const ComputeSection &) = delete;
+
+    private:
+      CommunicationProgress &communication_progress_;
+    };
+
+    /**
+     * Constructor.
+     */
+    CommunicationProgress(const MPI_Comm &mpi_communicator)
+        : mpi_communicator_(mpi_communicator)
+        , n_pending_(0)
+        , n_compute_sections_(0)
+        , n_exchanges_(0)
+        , time_in_flight_(0.)
+        , time_blocked_(0.)
+#ifdef USE_COMMUNICATION_PROGRESS_THREAD
+        , active_(false)
+        , busy_(false)
+        , terminate_(false)
+        , thread_([this]() { progress_loop(); })
+#endif
+    {
+    }
+
+    /**
+     * Destructor.
+     */
+    ~CommunicationProgress()
+    {
+#ifdef USE_COMMUNICATION_PROGRESS_THREAD
+      {
+        std::lock_guard<std::mutex> lock(thread_mutex_);
+        active_ = false;
+        terminate_ = true;
+      }
+      condition_.notify_all();
+      thread_.join();
+#endif
+    }
+
+    /**
+     * Begin a nonblocking exchange by executing @p start (typically a
+     * call to update_ghost_values_start()) with the progress thread
+     * paused.
+     */
+    template <typename Payload>
+    void start(const Payload &payload)
+    {
+      std::lock_guard<std::mutex> lock(payload_mutex_);
+      pause();
+      payload();
+      if (n_pending_++ == 0)
+        start_time_ = std::chrono::steady_clock::now();
+      Trace::async_begin("ghost exchange", n_exchanges_);
+      update_activity();
+    }
+
+    /**
+     * Complete a pending exchange by executing @p finish (typically a
+     * call to update_ghost_values_finish()) with the progress thread
+     * paused, and update statistics.
+     */
+    template <typename Payload>
+    void complete(const Payload &finish)
+    {
+      std::lock_guard<std::mutex> lock(payload_mutex_);
+      const auto stop_time = std::chrono::steady_clock::now();
+      Trace::begin("ghost exchange finish");
+      pause();
+      finish();
+      Trace::end("ghost exchange finish");
+      const auto done_time = std::chrono::steady_clock::now();
+
+      if (n_pending_ > 0) {
+        Trace::async_end("ghost exchange", n_exchanges_);
+        ++n_exchanges_;
+        time_in_flight_ +=
+            std::chrono::duration<double>(stop_time - start_time_).count();
+        time_blocked_ +=
+            std::chrono::duration<double>(done_time - stop_time).count();
+        --n_pending_;
+      }
+      update_activity();
+    }
+
+    /**
+     * Return the number of recorded exchanges.
+     */
+    unsigned long n_exchanges() const
+    {
+      return n_exchanges_;
+    }
+
+    /**
+     * Return the accumulated wall time all exchanges spent in flight
+     * while computation was carried out.
+     */
+    double time_in_flight() const
+    {
+      return time_in_flight_;
+    }
+
+    /**
+     * Return the accumulated wall time spent blocking in the finish
+     * payload.
+     */
+    double time_blocked() const
+    {
+      return time_blocked_;
+    }
+
+  private:
+    void enter_compute_section()
+    {
+      ++n_compute_sections_;
+      update_activity();
+    }
+
+    void leave_compute_section()
+    {
+      --n_compute_sections_;
+      update_activity();
+    }
+
+    /**
+     * Pause the progress thread (if any) and wait until it has returned
+     * from MPI.
+     */
+    void pause()
+    {
+#ifdef USE_COMMUNICATION_PROGRESS_THREAD
+      std::unique_lock<std::mutex> lock(thread_mutex_);
+      active_ = false;
+      condition_.wait(lock, [this]() { return !busy_; });
+#endif
+    }
+
+    /**
+     * (De)activate the progress thread (if any) depending on whether an
+     * exchange is pending and computation is under way.
+     */
+    void update_activity()
+    {
+#ifdef USE_COMMUNICATION_PROGRESS_THREAD
+      std::unique_lock<std::mutex> lock(thread_mutex_);
+      active_ = n_pending_ > 0 && n_compute_sections_ > 0;
+      if (active_) {
+        lock.unlock();
+        condition_.notify_all();
+      } else {
+        condition_.wait(lock, [this]() { return !busy_; });
+      }
+#endif
+    }
+
+#ifdef USE_COMMUNICATION_PROGRESS_THREAD
+    void progress_loop()
+    {
+      std::unique_lock<std::mutex> lock(thread_mutex_);
+      while (true) {
+        condition_.wait(lock, [this]() { return active_ || terminate_; });
+        if (terminate_)
+          return;
+
+        busy_ = true;
+        lock.unlock();
+        int flag = 0;
+        MPI_Iprobe(MPI_ANY_SOURCE,
+                   MPI_ANY_TAG,
+                   mpi_communicator_,
+                   &flag,
+                   MPI_STATUS_IGNORE);
+        lock.lock();
+        busy_ = false;
+        condition_.notify_all();
+      }
+    }
+#endif
+
+    const MPI_Comm &mpi_communicator_;
+
+    std::mutex payload_mutex_;
+    std::atomic<unsigned int> n_pending_;
+    std::atomic<unsigned int> n_compute_sections_;
+    std::chrono::steady_clock::time_point start_time_;
+
+    unsigned long n_exchanges_;
+    double time_in_flight_;
+    double time_blocked_;
+
+#ifdef USE_COMMUNICATION_PROGRESS_THREAD
+    std::mutex thread_mutex_;
+    std::condition_variable condition_;
+    bool active_;
+    bool busy_;
+    bool terminate_;
+    std::thread thread_;
+#endif
+  };
+
+} /* namespace ryujin */
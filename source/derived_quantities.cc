@@ -0,0 +1,13 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#include "derived_quantities.template.h"
+
+namespace ryujin
+{
+  /* instantiations */
+  template class ryujin::DerivedQuantities<DIM, NUMBER>;
+
+} /* namespace ryujin */
@@ -0,0 +1,207 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include <compile_time_options.h>
+
+#include "offline_data.h"
+#include "problem_description.h"
+
+#include <deal.II/base/subscriptor.h>
+
+#include <array>
+#include <map>
+
+namespace ryujin
+{
+  /**
+   * A shared postprocessing pipeline for derived quantities.
+   *
+   * All output sinks (VTUOutput, PointQuantities, IntegralQuantities)
+   * request the derived fields they need with request() before prepare()
+   * is called. A subsequent call to compute() evaluates all requested
+   * fields in a single fused pass over the state vector: Pointwise
+   * quantities (pressure, Mach number, specific entropy, and velocity),
+   * stencil-based quantities (the magnitude of the density gradient used
+   * for the schlieren plot, and the vorticity)
+   * \f[
+   *   \frac{1}{m_i}\;\Big|\sum_{j\in \mathcal{J}(i)}
+   *   \mathbf{c}_{ij} \rho_j\Big|, \qquad
+   *   \frac{1}{m_i}\;\sum_{j\in \mathcal{J}(i)}
+   *   \mathbf{c}_{ij} \times \mathbf{m}_j / \rho_j,
+   * \f]
+   * as well as the mass weighted integrals and minima of the state are
+   * all computed from the same (vectorized) load of the stencil. The
+   * results are cached for a given state vector and time, so that
+   * subsequent calls to compute() by other consumers are free.
+   *
+   * @ingroup TimeLoop
+   */
+  template <int dim, typename Number = double>
+  class DerivedQuantities : public dealii::Subscriptor
+  {
+  public:
+    /**
+     * @copydoc ProblemDescription::problem_dimension
+     */
+    // clang-format off
+    static constexpr unsigned int problem_dimension = ProblemDescription::problem_dimension<dim>;
+    // clang-format on
+
+    /**
+     * @copydoc ProblemDescription::rank1_type
+     */
+    using rank1_type = ProblemDescription::rank1_type<dim, Number>;
+
+    /**
+     * @copydoc OfflineData::scalar_type
+     */
+    using scalar_type = typename OfflineData<dim, Number>::scalar_type;
+
+    /**
+     * @copydoc OfflineData::vector_type
+     */
+    using vector_type = typename OfflineData<dim, Number>::vector_type;
+
+    /**
+     * The derived fields that can be requested.
+     */
+    enum class Field {
+      /** The pressure p. */
+      pressure,
+      /** The Mach number |v| / c. */
+      mach_number,
+      /** The (scaled) specific entropy. */
+      specific_entropy,
+      /** The velocity v = m / rho (dim components). */
+      velocity,
+      /** The magnitude of the lumped density gradient |grad rho|. */
+      schlieren,
+      /**
+       * The lumped vorticity: A signed scalar in 2D, the magnitude in
+       * 3D (not available in 1D).
+       */
+      vorticity
+    };
+
+    /**
+     * Mass weighted integrals and minima of the state (reduced over all
+     * MPI ranks).
+     */
+    struct Integrals {
+      /** The integral of the conserved state. */
+      rank1_type state;
+      /** The integral of the specific internal energy. */
+      Number internal_energy = Number(0.);
+      /** The integral of the pressure. */
+      Number pressure = Number(0.);
+      /** The minimum of the specific entropy. */
+      Number s_min = Number(0.);
+      /** The minimum of the specific internal energy. */
+      Number e_min = Number(0.);
+    };
+
+    /**
+     * Constructor.
+     */
+    DerivedQuantities(const MPI_Comm &mpi_communicator,
+                      const ProblemDescription &problem_description,
+                      const OfflineData<dim, Number> &offline_data);
+
+    /**
+     * Request the evaluation of the derived field @p field. This function
+     * has to be called before prepare().
+     */
+    void request(const Field field);
+
+    /**
+     * Return whether the derived field @p field has been requested.
+     */
+    bool requested(const Field field) const
+    {
+      return fields_.count(field) != 0;
+    }
+
+    /**
+     * Prepare evaluation. Allocates one scalar vector of type
+     * OfflineData::scalar_type for every requested scalar field and dim
+     * vectors for the velocity. Invalidates the cache.
+     */
+    void prepare();
+
+    /**
+     * Return the memory consumption (in bytes, of this MPI rank) of the
+     * vectors holding the requested fields as a list of (name, size)
+     * pairs.
+     */
+    std::vector<std::pair<std::string, std::size_t>>
+    memory_consumption() const;
+
+    /**
+     * Evaluate all requested fields and the integrals for the state @p U
+     * at time @p t in a single pass. The function returns immediately if
+     * the quantities have already been computed for the same vector and
+     * time. The state vector @p U must have up to date ghost values.
+     *
+     * The function requires MPI communication and is not reentrant.
+     */
+    void compute(const vector_type &U, const Number t);
+
+    /**
+     * Return the (locally owned part of the) scalar field @p field. Ghost
+     * values are not updated, and constraints are not distributed.
+     */
+    const scalar_type &field(const Field field) const
+    {
+      Assert(field != Field::velocity, dealii::ExcInternalError());
+      Assert(requested(field), dealii::ExcMessage("Field not requested"));
+      return fields_.find(field)->second;
+    }
+
+    /**
+     * Return the (locally owned part of the) velocity field.
+     */
+    const std::array<scalar_type, dim> &velocity() const
+    {
+      Assert(requested(Field::velocity),
+             dealii::ExcMessage("Field not requested"));
+      return velocity_;
+    }
+
+    /**
+     * Return the global minimum and maximum of the absolute value of the
+     * scalar field @p field.
+     */
+    std::pair<Number, Number> bounds(const Field field) const
+    {
+      Assert(requested(field), dealii::ExcMessage("Field not requested"));
+      return bounds_.find(field)->second;
+    }
+
+    /**
+     * Return the integral quantities.
+     */
+    const Integrals &integrals() const
+    {
+      return integrals_;
+    }
+
+  private:
+    const MPI_Comm &mpi_communicator_;
+
+    dealii::SmartPointer<const ProblemDescription> problem_description_;
+    dealii::SmartPointer<const OfflineData<dim, Number>> offline_data_;
+
+    std::map<Field, scalar_type> fields_;
+    std::array<scalar_type, dim> velocity_;
+    std::map<Field, std::pair<Number, Number>> bounds_;
+    Integrals integrals_;
+
+    const vector_type *cached_vector_;
+    Number cached_time_;
+  };
+
+} /* namespace ryujin */
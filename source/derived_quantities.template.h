@@ -0,0 +1,395 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include "derived_quantities.h"
+#include "openmp.h"
+#include "simd.h"
+
+#include <limits>
+
+namespace ryujin
+{
+  using namespace dealii;
+
+
+  template <int dim, typename Number>
+  DerivedQuantities<dim, Number>::DerivedQuantities(
+      const MPI_Comm &mpi_communicator,
+      const ProblemDescription &problem_description,
+      const OfflineData<dim, Number> &offline_data)
+      : mpi_communicator_(mpi_communicator)
+      , problem_description_(&problem_description)
+      , offline_data_(&offline_data)
+      , cached_vector_(nullptr)
+      , cached_time_(std::numeric_limits<Number>::quiet_NaN())
+  {
+  }
+
+
+  template <int dim, typename Number>
+  void DerivedQuantities<dim, Number>::request(const Field field)
+  {
+    AssertThrow(field != Field::vorticity || dim > 1,
+                dealii::ExcMessage("The vorticity is only available in 2D "
+                                   "and 3D"));
+    fields_[field];
+  }
+
+
+  template <int dim, typename Number>
+  void DerivedQuantities<dim, Number>::prepare()
+  {
+#ifdef DEBUG_OUTPUT
+    std::cout << "DerivedQuantities<dim, Number>::prepare()" << std::endl;
+#endif
+
+    const auto &scalar_partitioner = offline_data_->scalar_partitioner();
+
+    for (auto &[field, vector] : fields_)
+      if (field != Field::velocity)
+        vector.reinit(scalar_partitioner);
+
+    if (requested(Field::velocity))
+      for (auto &it : velocity_)
+        it.reinit(scalar_partitioner);
+
+    cached_vector_ = nullptr;
+  }
+
+
+  template <int dim, typename Number>
+  std::vector<std::pair<std::string, std::size_t>>
+  DerivedQuantities<dim, Number>::memory_consumption() const
+  {
+    std::size_t fields = 0;
+    for (const auto &it : fields_)
+      fields += it.second.memory_consumption();
+
+    std::size_t velocity = 0;
+    for (const auto &it : velocity_)
+      velocity += it.memory_consumption();
+
+    return {{"scalar fields", fields}, {"velocity", velocity}};
+  }
+
+
+  template <int dim, typename Number>
+  void DerivedQuantities<dim, Number>::compute(const vector_type &U,
+                                               const Number t)
+  {
+#ifdef DEBUG_OUTPUT
+    std::cout << "DerivedQuantities<dim, Number>::compute()" << std::endl;
+#endif
+
+    if (cached_vector_ == &U && cached_time_ == t)
+      return;
+
+    using VA = VectorizedArray<Number>;
+    constexpr auto simd_length = VA::size();
+
+    const unsigned int n_internal = offline_data_->n_locally_internal();
+    const unsigned int n_owned = offline_data_->n_locally_owned();
+
+    const auto &sparsity_simd = offline_data_->sparsity_pattern_simd();
+    const auto &lumped_mass_matrix = offline_data_->lumped_mass_matrix();
+    const auto &lumped_mass_matrix_inverse =
+        offline_data_->lumped_mass_matrix_inverse();
+    const auto &cij_matrix = offline_data_->cij_matrix();
+    const auto &boundary_map = offline_data_->boundary_map();
+
+    const auto field_pointer = [&](const Field field) -> scalar_type * {
+      const auto it = fields_.find(field);
+      return (it == fields_.end() || field == Field::velocity) ? nullptr
+                                                              : &it->second;
+    };
+
+    scalar_type *pressure = field_pointer(Field::pressure);
+    scalar_type *mach_number = field_pointer(Field::mach_number);
+    scalar_type *specific_entropy = field_pointer(Field::specific_entropy);
+    scalar_type *schlieren = field_pointer(Field::schlieren);
+    scalar_type *vorticity = field_pointer(Field::vorticity);
+    const bool compute_velocity = requested(Field::velocity);
+    const bool compute_stencil = schlieren != nullptr || vorticity != nullptr;
+
+    constexpr Number infinity = std::numeric_limits<Number>::infinity();
+
+    Integrals integrals;
+    integrals.s_min = std::numeric_limits<Number>::max();
+    integrals.e_min = std::numeric_limits<Number>::max();
+    std::array<Number, 4> stencil_bounds{{infinity, 0., infinity, 0.}};
+
+    RYUJIN_PARALLEL_REGION_BEGIN
+
+    /* Thread local (vectorized) reduction variables: */
+
+    ProblemDescription::rank1_type<dim, VA> state_simd;
+    VA e_simd = VA(0.);
+    VA p_simd = VA(0.);
+    VA s_min_simd = VA(std::numeric_limits<Number>::max());
+    VA e_min_simd = VA(std::numeric_limits<Number>::max());
+    VA r_min_simd = VA(infinity);
+    VA r_max_simd = VA(0.);
+    VA v_min_simd = VA(infinity);
+    VA v_max_simd = VA(0.);
+
+    /* Parallel SIMD loop (no boundary or constrained degrees of freedom): */
+
+    RYUJIN_OMP_FOR_NOWAIT
+    for (unsigned int i = 0; i < n_internal; i += simd_length) {
+
+      const auto U_i = U.get_vectorized_tensor(i);
+      const auto m_i = simd_load(lumped_mass_matrix, i);
+      const auto rho_i = problem_description_->density(U_i);
+      const auto rho_i_inverse = VA(1.) / rho_i;
+      const auto M_i = problem_description_->momentum(U_i);
+      const auto p_i = problem_description_->pressure(U_i);
+      const auto s_i = problem_description_->specific_entropy(U_i);
+      const auto e_i = problem_description_->internal_energy(U_i) *
+                       rho_i_inverse;
+
+      state_simd += m_i * U_i;
+      e_simd += m_i * e_i;
+      p_simd += m_i * p_i;
+      s_min_simd = std::min(s_min_simd, s_i);
+      e_min_simd = std::min(e_min_simd, e_i);
+
+      if (pressure)
+        simd_store(*pressure, p_i, i);
+
+      if (mach_number) {
+        const auto c_i = problem_description_->speed_of_sound(U_i);
+        simd_store(*mach_number, M_i.norm() * rho_i_inverse / c_i, i);
+      }
+
+      if (specific_entropy)
+        simd_store(*specific_entropy, s_i, i);
+
+      if (compute_velocity)
+        for (unsigned int d = 0; d < dim; ++d)
+          simd_store(velocity_[d], M_i[d] * rho_i_inverse, i);
+
+      if (!compute_stencil)
+        continue;
+
+      Tensor<1, dim, VA> grad_rho_i;
+      Tensor<1, dim == 2 ? 1 : dim, VA> curl_v_i;
+
+      /* Skip diagonal. */
+      const unsigned int row_length = sparsity_simd.row_length(i);
+      const unsigned int *js = sparsity_simd.columns(i) + simd_length;
+      for (unsigned int col_idx = 1; col_idx < row_length;
+           ++col_idx, js += simd_length) {
+
+        const auto U_j = U.get_vectorized_tensor(js);
+        const auto c_ij = cij_matrix.get_vectorized_tensor(i, col_idx);
+        const auto rho_j = problem_description_->density(U_j);
+
+        grad_rho_i += c_ij * rho_j;
+
+        if constexpr (dim == 2) {
+          const auto M_j = problem_description_->momentum(U_j);
+          curl_v_i[0] += cross_product_2d(c_ij) * M_j / rho_j;
+        } else if constexpr (dim == 3) {
+          const auto M_j = problem_description_->momentum(U_j);
+          curl_v_i += cross_product_3d(c_ij, M_j / rho_j);
+        }
+      }
+
+      const auto m_i_inverse = simd_load(lumped_mass_matrix_inverse, i);
+
+      if (schlieren) {
+        const auto r_i = grad_rho_i.norm() * m_i_inverse;
+        simd_store(*schlieren, r_i, i);
+        r_min_simd = std::min(r_min_simd, r_i);
+        r_max_simd = std::max(r_max_simd, r_i);
+      }
+
+      if constexpr (dim > 1) {
+        if (vorticity) {
+          const auto v_i = (dim == 2 ? curl_v_i[0] : curl_v_i.norm()) *
+                           m_i_inverse;
+          simd_store(*vorticity, v_i, i);
+          v_min_simd = std::min(v_min_simd, std::abs(v_i));
+          v_max_simd = std::max(v_max_simd, std::abs(v_i));
+        }
+      }
+    } /* parallel SIMD loop */
+
+    /* Thread local scalar reduction variables: */
+
+    rank1_type state;
+    Number e = 0.;
+    Number p = 0.;
+    Number s_min = std::numeric_limits<Number>::max();
+    Number e_min = std::numeric_limits<Number>::max();
+    Number r_min = infinity;
+    Number r_max = 0.;
+    Number v_min = infinity;
+    Number v_max = 0.;
+
+    for (unsigned int k = 0; k < simd_length; ++k) {
+      for (unsigned int c = 0; c < problem_dimension; ++c)
+        state[c] += state_simd[c][k];
+      e += e_simd[k];
+      p += p_simd[k];
+      s_min = std::min(s_min, s_min_simd[k]);
+      e_min = std::min(e_min, e_min_simd[k]);
+      r_min = std::min(r_min, r_min_simd[k]);
+      r_max = std::max(r_max, r_max_simd[k]);
+      v_min = std::min(v_min, v_min_simd[k]);
+      v_max = std::max(v_max, v_max_simd[k]);
+    }
+
+    /* Parallel non-vectorized loop: */
+
+    RYUJIN_OMP_FOR_NOWAIT
+    for (unsigned int i = n_internal; i < n_owned; ++i) {
+
+      /* Skip constrained degrees of freedom: */
+      const unsigned int row_length = sparsity_simd.row_length(i);
+      if (row_length == 1)
+        continue;
+
+      const auto U_i = U.get_tensor(i);
+      const auto m_i = lumped_mass_matrix.local_element(i);
+      const auto rho_i = problem_description_->density(U_i);
+      const auto rho_i_inverse = Number(1.) / rho_i;
+      const auto M_i = problem_description_->momentum(U_i);
+      const auto p_i = problem_description_->pressure(U_i);
+      const auto s_i = problem_description_->specific_entropy(U_i);
+      const auto e_i = problem_description_->internal_energy(U_i) *
+                       rho_i_inverse;
+
+      state += m_i * U_i;
+      e += m_i * e_i;
+      p += m_i * p_i;
+      s_min = std::min(s_min, s_i);
+      e_min = std::min(e_min, e_i);
+
+      if (pressure)
+        pressure->local_element(i) = p_i;
+
+      if (mach_number) {
+        const auto c_i = problem_description_->speed_of_sound(U_i);
+        mach_number->local_element(i) = M_i.norm() * rho_i_inverse / c_i;
+      }
+
+      if (specific_entropy)
+        specific_entropy->local_element(i) = s_i;
+
+      if (compute_velocity)
+        for (unsigned int d = 0; d < dim; ++d)
+          velocity_[d].local_element(i) = M_i[d] * rho_i_inverse;
+
+      if (!compute_stencil)
+        continue;
+
+      Tensor<1, dim, Number> grad_rho_i;
+      Tensor<1, dim == 2 ? 1 : dim, Number> curl_v_i;
+
+      /* Skip diagonal. */
+      const unsigned int *js = sparsity_simd.columns(i);
+      for (unsigned int col_idx = 1; col_idx < row_length; ++col_idx) {
+        const auto j = js[col_idx];
+
+        const auto U_j = U.get_tensor(j);
+        const auto c_ij = cij_matrix.get_tensor(i, col_idx);
+        const auto rho_j = problem_description_->density(U_j);
+
+        grad_rho_i += c_ij * rho_j;
+
+        if constexpr (dim == 2) {
+          const auto M_j = problem_description_->momentum(U_j);
+          curl_v_i[0] += cross_product_2d(c_ij) * M_j / rho_j;
+        } else if constexpr (dim == 3) {
+          const auto M_j = problem_description_->momentum(U_j);
+          curl_v_i += cross_product_3d(c_ij, M_j / rho_j);
+        }
+      }
+
+      /* Fix up boundaries: */
+
+      const auto range = boundary_map.equal_range(i);
+      for (auto it = range.first; it != range.second; ++it) {
+        const auto [normal, id, _] = it->second;
+        /* Remove normal components of the gradient on the boundary: */
+        if (id == Boundary::slip || id == Boundary::no_slip) {
+          grad_rho_i -= 1. * (grad_rho_i * normal) * normal;
+        } else {
+          grad_rho_i = 0.;
+        }
+        /* Only retain the normal component of the curl on the boundary: */
+        if constexpr (dim == 2) {
+          curl_v_i = 0.;
+        } else if constexpr (dim == 3) {
+          curl_v_i = (curl_v_i * normal) * normal;
+        }
+      }
+
+      const auto m_i_inverse = lumped_mass_matrix_inverse.local_element(i);
+
+      if (schlieren) {
+        const auto r_i = grad_rho_i.norm() * m_i_inverse;
+        schlieren->local_element(i) = r_i;
+        r_min = std::min(r_min, r_i);
+        r_max = std::max(r_max, r_i);
+      }
+
+      if constexpr (dim > 1) {
+        if (vorticity) {
+          const auto v_i = (dim == 2 ? curl_v_i[0] : curl_v_i.norm()) *
+                           m_i_inverse;
+          vorticity->local_element(i) = v_i;
+          v_min = std::min(v_min, std::abs(v_i));
+          v_max = std::max(v_max, std::abs(v_i));
+        }
+      }
+    } /* parallel non-vectorized loop */
+
+    RYUJIN_OMP_CRITICAL
+    {
+      integrals.state += state;
+      integrals.internal_energy += e;
+      integrals.pressure += p;
+      integrals.s_min = std::min(integrals.s_min, s_min);
+      integrals.e_min = std::min(integrals.e_min, e_min);
+      stencil_bounds[0] = std::min(stencil_bounds[0], r_min);
+      stencil_bounds[1] = std::max(stencil_bounds[1], r_max);
+      stencil_bounds[2] = std::min(stencil_bounds[2], v_min);
+      stencil_bounds[3] = std::max(stencil_bounds[3], v_max);
+    }
+
+    RYUJIN_PARALLEL_REGION_END
+
+    /* And synchronize over all processors: */
+
+    for (unsigned int k = 0; k < problem_dimension; ++k)
+      integrals.state[k] =
+          Utilities::MPI::sum(integrals.state[k], mpi_communicator_);
+    integrals.internal_energy =
+        Utilities::MPI::sum(integrals.internal_energy, mpi_communicator_);
+    integrals.pressure =
+        Utilities::MPI::sum(integrals.pressure, mpi_communicator_);
+    integrals.s_min = Utilities::MPI::min(integrals.s_min, mpi_communicator_);
+    integrals.e_min = Utilities::MPI::min(integrals.e_min, mpi_communicator_);
+    integrals_ = integrals;
+
+    if (schlieren)
+      bounds_[Field::schlieren] = {
+          Utilities::MPI::min(stencil_bounds[0], mpi_communicator_),
+          Utilities::MPI::max(stencil_bounds[1], mpi_communicator_)};
+
+    if (vorticity)
+      bounds_[Field::vorticity] = {
+          Utilities::MPI::min(stencil_bounds[2], mpi_communicator_),
+          Utilities::MPI::max(stencil_bounds[3], mpi_communicator_)};
+
+    cached_vector_ = &U;
+    cached_time_ = t;
+  }
+
+} /* namespace ryujin */
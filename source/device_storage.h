@@ -0,0 +1,268 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include <compile_time_options.h>
+
+#include "multicomponent_vector.h"
+#include "sparse_matrix_simd.h"
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/array_view.h>
+#include <deal.II/base/exceptions.h>
+
+#ifdef USE_DEVICE_STORAGE
+#include <cuda_runtime_api.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+
+namespace ryujin
+{
+  /**
+   * A flat, fixed-size array of trivially copyable values that resides in
+   * device memory.
+   *
+   * This is the storage layer of a device backend of
+   * EulerModule::single_step(): the vectors and matrices used in the
+   * stencil kernels (MultiComponentVector, SparseMatrixSIMD) keep their
+   * entries in a single contiguous array in a well-defined (SIMD
+   * blocked) order, so a device mirror is simply a DeviceStorage
+   * of the same size that is synchronized with copy_from_host() and
+   * copy_to_host(), see the mirror() and update_host() functions below.
+   * Device kernels index into data() with exactly the same offsets as
+   * the host code.
+   *
+   * If ryujin is configured with USE_DEVICE_STORAGE (which requires a
+   * deal.II library configured with CUDA) the array is allocated with
+   * cudaMalloc(). Otherwise the array is an ordinary (aligned) host
+   * allocation, which allows to develop and test code using the
+   * abstraction without a device.
+   *
+   * @ingroup SIMD
+   */
+  template <typename Number>
+  class DeviceStorage
+  {
+  public:
+    /**
+     * Constructor. Creates an empty array.
+     */
+    DeviceStorage() = default;
+
+    DeviceStorage(const DeviceStorage &) = delete;
+    DeviceStorage &operator=(const DeviceStorage &) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~DeviceStorage()
+    {
+      clear();
+    }
+
+    /**
+     * Resize the array to @p size elements. Existing entries are
+     * discarded, the new entries are left uninitialized.
+     */
+    void reinit(const std::size_t size)
+    {
+      if (size == size_)
+        return;
+
+      clear();
+#ifdef USE_DEVICE_STORAGE
+      if (size > 0) {
+        const auto error = cudaMalloc(reinterpret_cast<void **>(&data_),
+                                      size * sizeof(Number));
+        AssertThrow(error == cudaSuccess,
+                    dealii::ExcMessage(std::string("cudaMalloc failed: ") +
+                                       cudaGetErrorString(error)));
+      }
+#else
+      host_data_.resize_fast(size);
+      data_ = host_data_.data();
+#endif
+      size_ = size;
+    }
+
+    /**
+     * Release the storage.
+     */
+    void clear()
+    {
+#ifdef USE_DEVICE_STORAGE
+      if (data_ != nullptr)
+        cudaFree(data_);
+#else
+      host_data_.clear();
+#endif
+      data_ = nullptr;
+      size_ = 0;
+    }
+
+    /**
+     * Return the number of elements.
+     */
+    std::size_t size() const
+    {
+      return size_;
+    }
+
+    /**
+     * Return the (device) pointer to the first element.
+     */
+    Number *data()
+    {
+      return data_;
+    }
+
+    /**
+     * @copydoc data()
+     */
+    const Number *data() const
+    {
+      return data_;
+    }
+
+    /**
+     * Copy the host array @p values (which has to have size()
+     * elements) into the storage.
+     */
+    void copy_from_host(const dealii::ArrayView<const Number> &values)
+    {
+      AssertDimension(values.size(), size_);
+      if (size_ == 0)
+        return;
+#ifdef USE_DEVICE_STORAGE
+      const auto error = cudaMemcpy(data_,
+                                    values.data(),
+                                    size_ * sizeof(Number),
+                                    cudaMemcpyHostToDevice);
+      AssertThrow(error == cudaSuccess,
+                  dealii::ExcMessage(std::string("cudaMemcpy failed: ") +
+                                     cudaGetErrorString(error)));
+#else
+      std::copy(values.begin(), values.end(), data_);
+#endif
+    }
+
+    /**
+     * Copy the storage into the host array @p values (which has to have
+     * size() elements).
+     */
+    void copy_to_host(const dealii::ArrayView<Number> &values) const
+    {
+      AssertDimension(values.size(), size_);
+      if (size_ == 0)
+        return;
+#ifdef USE_DEVICE_STORAGE
+      const auto error = cudaMemcpy(values.data(),
+                                    data_,
+                                    size_ * sizeof(Number),
+                                    cudaMemcpyDeviceToHost);
+      AssertThrow(error == cudaSuccess,
+                  dealii::ExcMessage(std::string("cudaMemcpy failed: ") +
+                                     cudaGetErrorString(error)));
+#else
+      std::copy(data_, data_ + size_, values.begin());
+#endif
+    }
+
+    /**
+     * Return the memory consumption in bytes.
+     */
+    std::size_t memory_consumption() const
+    {
+      return size_ * sizeof(Number);
+    }
+
+  private:
+    Number *data_ = nullptr;
+    std::size_t size_ = 0;
+
+#ifndef USE_DEVICE_STORAGE
+    dealii::AlignedVector<Number> host_data_;
+#endif
+  };
+
+
+  /**
+   * Mirror all locally relevant entries (locally owned and ghost
+   * entries) of the MultiComponentVector @p vector into @p storage. The
+   * storage is resized if necessary.
+   */
+  template <typename Number,
+            int n_comp,
+            int simd_length,
+            MultiComponentLayout layout>
+  void mirror(
+      const MultiComponentVector<Number, n_comp, simd_length, layout> &vector,
+      DeviceStorage<Number> &storage)
+  {
+    const std::size_t size = vector.get_partitioner()->local_size() +
+                             vector.get_partitioner()->n_ghost_indices();
+    storage.reinit(size);
+    storage.copy_from_host(
+        dealii::ArrayView<const Number>(vector.begin(), size));
+  }
+
+
+  /**
+   * Copy the locally relevant entries of @p storage (set up with
+   * mirror()) back into the MultiComponentVector @p vector.
+   */
+  template <typename Number,
+            int n_comp,
+            int simd_length,
+            MultiComponentLayout layout>
+  void update_host(const DeviceStorage<Number> &storage,
+                   MultiComponentVector<Number, n_comp, simd_length, layout>
+                       &vector)
+  {
+    storage.copy_to_host(
+        dealii::ArrayView<Number>(vector.begin(), storage.size()));
+  }
+
+
+  /**
+   * Mirror all (locally relevant) entries of the SparseMatrixSIMD
+   * @p matrix into @p storage. The storage is resized if necessary.
+   */
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
+  void mirror(const SparseMatrixSIMD<Number,
+                                     n_components,
+                                     simd_length,
+                                     StorageType> &matrix,
+              DeviceStorage<StorageType> &storage)
+  {
+    const auto entries = matrix.entries();
+    storage.reinit(entries.size());
+    storage.copy_from_host(entries);
+  }
+
+
+  /**
+   * Copy the entries of @p storage (set up with mirror()) back into the
+   * SparseMatrixSIMD @p matrix.
+   */
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
+  void update_host(
+      const DeviceStorage<StorageType> &storage,
+      SparseMatrixSIMD<Number, n_components, simd_length, StorageType> &matrix)
+  {
+    storage.copy_to_host(matrix.entries());
+  }
+
+} /* namespace ryujin */
@@ -139,8 +139,25 @@ namespace ryujin
     /**
      * Create the triangulation and set up the finite element, mapping and
      * quadrature objects.
+     *
+     * If @p n_coarsening is nonzero the mesh is refined globally
+     * @p n_coarsening times less than specified by "mesh refinement".
+     * This is used to resume from a checkpoint of a coarser mesh, see
+     * TimeLoop.
      */
-    void prepare();
+    void prepare(const unsigned int n_coarsening = 0);
+
+    /**
+     * Set the additional weight of a boundary cell (relative to the
+     * default weight of 1000 of every cell) used for partitioning the
+     * mesh. The weight is used for all subsequent repartitioning steps of
+     * the triangulation and only has an effect if "mesh repartitioning"
+     * is enabled.
+     */
+    void set_boundary_cell_weight(const unsigned int weight)
+    {
+      boundary_cell_weight_ = weight;
+    }
 
     /**
      * @name Discretization compile time options
@@ -165,6 +182,8 @@ namespace ryujin
     std::unique_ptr<const dealii::FiniteElement<dim>> finite_element_;
     std::unique_ptr<const dealii::Quadrature<dim>> quadrature_;
     std::unique_ptr<const dealii::Quadrature<1>> quadrature_1d_;
+    std::unique_ptr<const dealii::FiniteElement<dim>> subcell_finite_element_;
+    std::unique_ptr<const dealii::Quadrature<dim>> subcell_quadrature_;
 
   public:
     /**
@@ -200,6 +219,23 @@ namespace ryujin
      */
     ACCESSOR_READ_ONLY(quadrature_1d)
 
+    /**
+     * Return a read-only const reference to the subcell finite element.
+     * This is a continuous, piecewise linear element on the Q1 subcell
+     * decomposition of every cell (dealii::FE_Q_iso_Q1) that shares the
+     * degrees of freedom with finite_element(). It is used for
+     * assembling the (low-order) operators of the hyperbolic update. For
+     * order_finite_element == 1 the subcell finite element is
+     * identical to finite_element().
+     */
+    ACCESSOR_READ_ONLY(subcell_finite_element)
+
+    /**
+     * Return a read-only const reference to the quadrature rule used
+     * with the subcell finite element.
+     */
+    ACCESSOR_READ_ONLY(subcell_quadrature)
+
   private:
     //@}
     /**
@@ -213,6 +249,7 @@ namespace ryujin
 
     unsigned int refinement_;
     bool repartitioning_;
+    ACCESSOR_READ_ONLY(repartitioning)
 
     //@}
     /**
@@ -222,6 +259,11 @@ namespace ryujin
 
     std::set<std::unique_ptr<Geometry<dim>>> geometry_list_;
 
+    unsigned int boundary_cell_weight_;
+    ACCESSOR_READ_ONLY(boundary_cell_weight)
+
+    boost::signals2::connection cell_weight_connection_;
+
     //@}
   };
 
@@ -13,6 +13,7 @@
 
 #include <deal.II/base/quadrature_lib.h>
 #include <deal.II/fe/fe_q.h>
+#include <deal.II/fe/fe_q_iso_q1.h>
 #include <deal.II/fe/mapping_q.h>
 
 #include <fstream>
@@ -31,6 +32,7 @@ namespace ryujin
             dealii::Triangulation<dim>::limit_level_difference_at_vertices,
             dealii::parallel::distributed::Triangulation<
                 dim>::construct_multigrid_hierarchy))
+      , boundary_cell_weight_(0u)
   {
     /* Options: */
 
@@ -68,12 +70,16 @@ namespace ryujin
 
 
   template <int dim>
-  void Discretization<dim>::prepare()
+  void Discretization<dim>::prepare(const unsigned int n_coarsening)
   {
 #ifdef DEBUG_OUTPUT
     std::cout << "Discretization<dim>::prepare()" << std::endl;
 #endif
 
+    AssertThrow(n_coarsening <= refinement_,
+                ExcMessage("Cannot coarsen the mesh beyond the initial "
+                           "(unrefined) mesh"));
+
     auto &triangulation = *triangulation_;
     triangulation.clear();
 
@@ -117,7 +123,6 @@ namespace ryujin
       }
     }
 
-#ifdef USE_SIMD
     if (repartitioning_) {
       /*
        * Try to partition the mesh equilibrating the workload. The usual mesh
@@ -138,31 +143,61 @@ namespace ryujin
        * (additional symmetrization of d_ij, boundary fixup) so it should be
        * safe to assume that the cost incurred is at least
        * VectorizedArray::size() / 2.
+       *
+       * The weight can be updated later on with a measured value, see
+       * set_boundary_cell_weight().
        */
+#ifdef USE_SIMD
       constexpr auto speedup = dealii::VectorizedArray<NUMBER>::size() / 2u;
       constexpr unsigned int weight = 1000u;
+      boundary_cell_weight_ = weight * (speedup == 0u ? 0u : speedup - 1u);
+#else
+      boundary_cell_weight_ = 0u;
+#endif
 
-      triangulation.signals.cell_weight.connect(
-          [](const auto &cell, const auto /*status*/) -> unsigned int {
+      cell_weight_connection_.disconnect();
+      cell_weight_connection_ = triangulation.signals.cell_weight.connect(
+          [this](const auto &cell, const auto /*status*/) -> unsigned int {
             if (cell->at_boundary())
-              return weight * (speedup == 0u ? 0u : speedup - 1u);
+              return boundary_cell_weight_;
             else
               return 0u;
           });
 
       triangulation.repartition();
     }
-#endif
 
-    triangulation.refine_global(refinement_);
+    triangulation.refine_global(refinement_ - n_coarsening);
 
     if (std::abs(mesh_distortion_) > 1.0e-10)
       GridTools::distort_random(mesh_distortion_, triangulation);
 
     mapping_ = std::make_unique<MappingQ<dim>>(order_mapping);
-    finite_element_ = std::make_unique<FE_Q<dim>>(order_finite_element);
     quadrature_ = std::make_unique<QGauss<dim>>(order_quadrature);
     quadrature_1d_ = std::make_unique<QGauss<1>>(order_quadrature);
+
+    if constexpr (order_finite_element == 1) {
+      finite_element_ = std::make_unique<FE_Q<dim>>(order_finite_element);
+      subcell_finite_element_ = std::make_unique<FE_Q<dim>>(1);
+      subcell_quadrature_ = std::make_unique<QGauss<dim>>(order_quadrature);
+
+    } else {
+      /*
+       * For higher order elements we place the support points on an
+       * equidistant lattice so that the degrees of freedom coincide with
+       * the vertices of the Q1 subcell decomposition:
+       */
+#if DEAL_II_VERSION_GTE(9, 3, 0)
+      const QIterated<1> support_points(QTrapezoid<1>(), order_finite_element);
+#else
+      const QIterated<1> support_points(QTrapez<1>(), order_finite_element);
+#endif
+      finite_element_ = std::make_unique<FE_Q<dim>>(support_points);
+      subcell_finite_element_ =
+          std::make_unique<FE_Q_iso_Q1<dim>>(order_finite_element);
+      subcell_quadrature_ = std::make_unique<QIterated<dim>>(
+          QGauss<1>(2), order_finite_element);
+    }
   }
 
 } /* namespace ryujin */
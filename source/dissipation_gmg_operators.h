@@ -14,6 +14,8 @@
 
 #include <deal.II/base/vectorization.h>
 #include <deal.II/lac/diagonal_matrix.h>
+#include <deal.II/lac/solver_cg.h>
+#include <deal.II/lac/solver_control.h>
 #include <deal.II/matrix_free/fe_evaluation.h>
 #include <deal.II/multigrid/mg_base.h>
 #include <deal.II/multigrid/mg_transfer_matrix_free.h>
@@ -171,8 +173,6 @@ namespace ryujin
 
     void vmult(block_vector_type &dst, const block_vector_type &src) const
     {
-      /* Apply action of m_i rho_i V_i: */
-
       using VA = dealii::VectorizedArray<Number>;
       constexpr auto simd_length = VA::size();
 
@@ -186,31 +186,34 @@ namespace ryujin
 
       const unsigned int n_owned =
           lumped_mass_matrix->get_partitioner()->local_size();
-      const unsigned int size_regular = n_owned / simd_length * simd_length;
-
-      RYUJIN_PARALLEL_REGION_BEGIN
 
-      RYUJIN_OMP_FOR
-      for (unsigned int i = 0; i < size_regular; i += simd_length) {
-        const auto m_i = simd_load(*lumped_mass_matrix, i);
-        const auto rho_i = simd_load(*density_, i);
-        for (unsigned int d = 0; d < dim; ++d) {
-          const auto temp = simd_load(src.block(d), i);
-          simd_store(dst.block(d), m_i * rho_i * temp, i);
+      /*
+       * Apply action of m_i rho_i V_i on the index range [begin, end) for
+       * all dim components at once:
+       */
+      const auto mass_term = [&](const unsigned int begin,
+                                 const unsigned int end) {
+        const unsigned int size_regular =
+            begin + (end - begin) / simd_length * simd_length;
+
+        for (unsigned int i = begin; i < size_regular; i += simd_length) {
+          const auto m_i = simd_load(*lumped_mass_matrix, i);
+          const auto rho_i = simd_load(*density_, i);
+          for (unsigned int d = 0; d < dim; ++d) {
+            const auto temp = simd_load(src.block(d), i);
+            simd_store(dst.block(d), m_i * rho_i * temp, i);
+          }
         }
-      }
 
-      RYUJIN_PARALLEL_REGION_END
-
-      for (unsigned int i = size_regular; i < n_owned; ++i) {
-        const auto m_i = lumped_mass_matrix->local_element(i);
-        const auto rho_i = density_->local_element(i);
-
-        for (unsigned int d = 0; d < dim; ++d) {
-          const auto temp = src.block(d).local_element(i);
-          dst.block(d).local_element(i) = m_i * rho_i * temp;
+        for (unsigned int i = size_regular; i < end; ++i) {
+          const auto m_i = lumped_mass_matrix->local_element(i);
+          const auto rho_i = density_->local_element(i);
+          for (unsigned int d = 0; d < dim; ++d) {
+            const auto temp = src.block(d).local_element(i);
+            dst.block(d).local_element(i) = m_i * rho_i * temp;
+          }
         }
-      }
+      };
 
       /* Apply action of stress tensor: + theta * \sum_j B_ij V_j: */
 
@@ -231,8 +234,39 @@ namespace ryujin
         }
       };
 
+#if DEAL_II_VERSION_GTE(9, 3, 0)
+      /*
+       * All dim velocity components are processed by a single
+       * dim-component FEEvaluation, i.e., the geometry of every cell is
+       * only loaded once per operator application. In addition, we fuse
+       * the mass term into the cell loop: MatrixFree calls mass_term()
+       * for every index range right before the first cell touching it is
+       * processed, so that src and dst are still in cache when the cells
+       * are visited. This saves a complete sweep over the 2 * dim + 2
+       * vectors involved.
+       */
+      matrix_free_->template cell_loop<block_vector_type, block_vector_type>(
+          integrator,
+          dst,
+          src,
+          mass_term,
+          [](const unsigned int, const unsigned int) {});
+#else
+      const unsigned int size_regular = n_owned / simd_length * simd_length;
+
+      RYUJIN_PARALLEL_REGION_BEGIN
+
+      RYUJIN_OMP_FOR
+      for (unsigned int i = 0; i < size_regular; i += simd_length)
+        mass_term(i, i + simd_length);
+
+      RYUJIN_PARALLEL_REGION_END
+
+      mass_term(size_regular, n_owned);
+
       matrix_free_->template cell_loop<block_vector_type, block_vector_type>(
           integrator, dst, src, /* zero destination */ false);
+#endif
 
       /* (5.4a) Fix up constrained degrees of freedom: */
 
@@ -758,4 +792,50 @@ namespace ryujin
     const dealii::MGLevelObject<dealii::MatrixFree<dim, Number>>
         *level_matrix_free_;
   };
+
+
+  /**
+   * A coarse grid solver running a conjugate gradient method on the
+   * coarsest level that is preconditioned with the (fixed degree)
+   * Chebyshev smoother of that level. The iteration stops once the
+   * residual has been reduced by the factor @p reduction, or after @p
+   * max_iter iterations. In contrast to
+   * dealii::MGCoarseGridIterativeSolver reaching the maximal number of
+   * iterations is not treated as an error, i.e., the outer solver never
+   * falls back to plain CG because of the coarse solve.
+   *
+   * @ingroup DissipationModule
+   */
+  template <typename VectorType, typename MatrixType, typename SmootherType>
+  class MGCoarseGridCG : public dealii::MGCoarseGridBase<VectorType>
+  {
+  public:
+    MGCoarseGridCG(const dealii::MGLevelObject<MatrixType> &matrices,
+                   const SmootherType &smoother,
+                   const unsigned int max_iter,
+                   const double reduction)
+        : matrices_(&matrices)
+        , smoother_(&smoother)
+        , max_iter_(max_iter)
+        , reduction_(reduction)
+    {
+    }
+
+    void operator()(const unsigned int level,
+                    VectorType &dst,
+                    const VectorType &src) const override
+    {
+      dealii::IterationNumberControl solver_control(
+          max_iter_, reduction_ * src.l2_norm());
+      dealii::SolverCG<VectorType> solver(solver_control);
+      dst = 0.;
+      solver.solve((*matrices_)[level], dst, src, (*smoother_)[level]);
+    }
+
+  private:
+    const dealii::MGLevelObject<MatrixType> *matrices_;
+    const SmootherType *smoother_;
+    const unsigned int max_iter_;
+    const double reduction_;
+  };
 } /* namespace ryujin */
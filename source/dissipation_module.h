@@ -8,11 +8,13 @@
 #include <compile_time_options.h>
 
 #include "convenience_macros.h"
+#include "kernel_statistics.h"
 #include "simd.h"
 
 #include "initial_values.h"
 #include "offline_data.h"
 #include "problem_description.h"
+#include "scratch_vector_pool.h"
 #include "sparse_matrix_simd.h"
 #include "dissipation_gmg_operators.h"
 
@@ -125,6 +127,28 @@ namespace ryujin
     using block_vector_type =
         dealii::LinearAlgebra::distributed::BlockVector<Number>;
 
+    /**
+     * The number type used for the level operators, level vectors and
+     * smoothers of the geometric multigrid preconditioners.
+     *
+     * @note A 16-bit type (fp16/bf16) is not an option at the moment:
+     * dealii::MatrixFree and dealii::VectorizedArray are only available
+     * for float and double.
+     */
+    using level_number_type = float;
+
+    /**
+     * A distributed vector on a multigrid level.
+     */
+    using level_vector_type =
+        dealii::LinearAlgebra::distributed::Vector<level_number_type>;
+
+    /**
+     * A distributed block vector on a multigrid level.
+     */
+    using level_block_vector_type =
+        dealii::LinearAlgebra::distributed::BlockVector<level_number_type>;
+
     /**
      * Constructor.
      */
@@ -133,15 +157,28 @@ namespace ryujin
                       const ryujin::ProblemDescription &problem_description,
                       const ryujin::OfflineData<dim, Number> &offline_data,
                       const ryujin::InitialValues<dim, Number> &initial_values,
+                      ScratchVectorPool &scratch_vector_pool,
                       const std::string &subsection = "DissipationModule");
 
     /**
      * Prepare time stepping. A call to @ref prepare() allocates temporary
      * storage and is necessary before any of the following time-stepping
      * functions can be called.
+     *
+     * The right hand side of the internal energy update and the density
+     * are not allocated but checked out from the ScratchVectorPool for
+     * the duration of a call to step().
      */
     void prepare();
 
+    /**
+     * Return the memory consumption (in bytes, of this MPI rank) of all
+     * temporary vectors and the (level) matrix-free data allocated by
+     * @ref prepare() as a list of (name, size) pairs.
+     */
+    std::vector<std::pair<std::string, std::size_t>>
+    memory_consumption() const;
+
     /**
      * @name Functons for performing explicit time steps
      */
@@ -162,9 +199,73 @@ namespace ryujin
      */
     Number step(vector_type &U, Number t, Number tau, unsigned int cycle);
 
+    /**
+     * Perform the implicit acoustic step of the "Euler IMEX" splitting,
+     * see ProblemDescription::acoustic_splitting(): Keeping the density
+     * fixed we solve the linearized system
+     * \f{align}
+     *   \partial_t \boldsymbol m + \nabla p = 0, \qquad
+     *   \partial_t p + \frac{p^2}{\rho e}\,\nabla\cdot\boldsymbol v = 0,
+     * \f}
+     * with a backward Euler step of size @p tau. Eliminating the velocity
+     * results in a scalar Helmholtz problem for the pressure,
+     * \f{align}
+     *   \kappa_i m_i p_i + \tau^2 \sum_{j\in\mathcal I(i)} \beta_{ij} p_j =
+     *   \kappa_i m_i p_i^\ast - \tau \rho_i \sum_{j\in\mathcal I(i)}
+     *   \boldsymbol c_{ij}\cdot\boldsymbol v^\ast_j, \qquad
+     *   \kappa_i = \frac{\rho_i (\rho e)_i^\ast}{(p_i^\ast)^2},
+     * \f}
+     * that has the structure of the internal energy update and is solved
+     * with the same operator and the same ("multigrid energy") geometric
+     * multigrid preconditioner. The velocity is then corrected with the
+     * new pressure gradient and the internal energy is rescaled with
+     * \f$p_i / p_i^\ast\f$.
+     *
+     * @note The variation of the density is neglected in the
+     * Laplacian, \f$\nabla\cdot(\rho^{-1}\nabla p) \approx
+     * \rho^{-1}\Delta p\f$, and total energy is only conserved up to
+     * the linearization error. The implicit step is not invariant-domain
+     * preserving; the function throws if a non-positive pressure is
+     * encountered.
+     */
+    Number acoustic_step(vector_type &U, Number t, Number tau);
+
     //@}
 
   private:
+    /**
+     * Return whether the time factor or the density changed by more than
+     * gmg_refresh_threshold_ since the last setup of the Chebyshev
+     * smoothers. If so, the new reference values are recorded.
+     */
+    bool gmg_needs_refresh(const scalar_type &density,
+                           const Number time_factor);
+
+    /**
+     * Update the level operators of the internal energy multigrid
+     * preconditioner for a new time factor (and the coefficient
+     * interpolated to level_density_). If @p refresh is set the Chebyshev
+     * smoothers are set up again.
+     */
+    void initialize_gmg_energy(const Number factor, const bool refresh);
+
+    /**
+     * Return the coarsest level visited by the multigrid cycle, i.e., the
+     * minimal level of the hierarchy raised by the level offset selected
+     * by the autotuning.
+     */
+    unsigned int gmg_coarse_level() const;
+
+    /**
+     * Account a call to step() that took @p time seconds for the
+     * autotuning of the multigrid parameters. The Chebyshev degree, the
+     * Chebyshev ranges and the coarse level are swept one after another,
+     * every candidate is timed over "multigrid - autotune samples" steps
+     * (after one untimed step that sets up the smoothers), and the
+     * fastest candidate is locked in before the next sweep.
+     */
+    void autotune_gmg(const double time);
+
     /**
      * @name Run time options
      */
@@ -178,9 +279,16 @@ namespace ryujin
 
     Number tolerance_;
     bool tolerance_linfty_norm_;
+    Number tolerance_update_factor_;
+
+    bool use_pipelined_cg_;
+    ACCESSOR_READ_ONLY(use_pipelined_cg)
 
     Number shift_;
 
+    unsigned int initial_guess_extrapolation_;
+    ACCESSOR_READ_ONLY(initial_guess_extrapolation)
+
     unsigned int gmg_max_iter_vel_;
     unsigned int gmg_max_iter_en_;
     double gmg_smoother_range_vel_;
@@ -190,6 +298,12 @@ namespace ryujin
     unsigned int gmg_smoother_degree_;
     unsigned int gmg_smoother_n_cg_iter_;
     unsigned int gmg_min_level_;
+    unsigned int gmg_coarse_cells_per_rank_;
+    std::string gmg_coarse_solver_;
+    unsigned int gmg_coarse_max_iter_;
+    double gmg_coarse_reduction_;
+    double gmg_refresh_threshold_;
+    unsigned int gmg_autotune_samples_;
 
     //@}
     /**
@@ -204,6 +318,7 @@ namespace ryujin
     dealii::SmartPointer<const ryujin::OfflineData<dim, Number>> offline_data_;
     dealii::SmartPointer<const ryujin::InitialValues<dim, Number>>
         initial_values_;
+    dealii::SmartPointer<ScratchVectorPool> scratch_vector_pool_;
 
     double n_iterations_velocity_;
     ACCESSOR_READ_ONLY(n_iterations_velocity)
@@ -211,6 +326,39 @@ namespace ryujin
     double n_iterations_internal_energy_;
     ACCESSOR_READ_ONLY(n_iterations_internal_energy)
 
+    /*
+     * Relative l2 norm of the momentum update |M^{n+1} - M^n| / |M^n| of
+     * the last call to step(). Used by the TimeLoop to adapt the
+     * splitting schedule:
+     */
+    Number relative_increment_;
+    ACCESSOR_READ_ONLY(relative_increment)
+
+    KernelStatisticsMap kernel_statistics_;
+    ACCESSOR_READ_ONLY(kernel_statistics)
+
+    /*
+     * State of the autotuning, see autotune_gmg(). The sweep is over
+     * once phase reaches 3, gmg_autotune_result_ then holds the selected
+     * parameters in a form suitable for the log:
+     */
+    struct GMGAutotuneState {
+      bool active = false;
+      unsigned int phase = 0;
+      unsigned int candidate = 0;
+      unsigned int sample = 0;
+      double time = 0.;
+      double best_time = 0.;
+      unsigned int best_candidate = 0;
+      double range_vel = 0.;
+      double range_en = 0.;
+    };
+
+    GMGAutotuneState gmg_autotune_;
+    unsigned int gmg_level_offset_;
+    std::string gmg_autotune_result_;
+    ACCESSOR_READ_ONLY(gmg_autotune_result)
+
     dealii::MatrixFree<dim, Number> matrix_free_;
 
     block_vector_type velocity_;
@@ -219,37 +367,50 @@ namespace ryujin
     block_vector_type velocity_rhs_;
 
     scalar_type internal_energy_;
-    scalar_type internal_energy_rhs_;
 
-    scalar_type density_;
+    /*
+     * Ring buffers holding the last increments of the parabolic update
+     * (solution minus hyperbolic state) used for extrapolating the
+     * initial guess:
+     */
+    std::vector<block_vector_type> velocity_increments_;
+    std::vector<scalar_type> internal_energy_increments_;
+    unsigned int n_increments_;
+
+    /*
+     * Density (or the coefficient of the acoustic step) and theta * tau
+     * (or tau^2) used for the last setup of the multigrid smoothers:
+     */
+    scalar_type gmg_reference_density_;
+    Number gmg_reference_theta_x_tau_;
 
     Number tau_;
     Number theta_;
 
-    dealii::MGLevelObject<dealii::MatrixFree<dim, float>> level_matrix_free_;
+    dealii::MGLevelObject<dealii::MatrixFree<dim, level_number_type>>
+        level_matrix_free_;
     dealii::MGConstrainedDoFs mg_constrained_dofs_;
-    dealii::MGLevelObject<dealii::LinearAlgebra::distributed::Vector<float>>
-        level_density_;
-    MGTransferVelocity<dim, float> mg_transfer_velocity_;
-    dealii::MGLevelObject<VelocityMatrix<dim, float, Number>>
+    dealii::MGLevelObject<level_vector_type> level_density_;
+    MGTransferVelocity<dim, level_number_type> mg_transfer_velocity_;
+    dealii::MGLevelObject<VelocityMatrix<dim, level_number_type, Number>>
         level_velocity_matrices_;
-    MGTransferEnergy<dim, float> mg_transfer_energy_;
-    dealii::MGLevelObject<EnergyMatrix<dim, float, Number>>
+    MGTransferEnergy<dim, level_number_type> mg_transfer_energy_;
+    dealii::MGLevelObject<EnergyMatrix<dim, level_number_type, Number>>
         level_energy_matrices_;
 
     dealii::mg::SmootherRelaxation<
         dealii::PreconditionChebyshev<
-            VelocityMatrix<dim, float, Number>,
-            dealii::LinearAlgebra::distributed::BlockVector<float>,
-            DiagonalMatrix<dim, float>>,
-        dealii::LinearAlgebra::distributed::BlockVector<float>>
+            VelocityMatrix<dim, level_number_type, Number>,
+            level_block_vector_type,
+            DiagonalMatrix<dim, level_number_type>>,
+        level_block_vector_type>
         mg_smoother_velocity_;
 
     dealii::mg::SmootherRelaxation<
         dealii::PreconditionChebyshev<
-            EnergyMatrix<dim, float, Number>,
-            dealii::LinearAlgebra::distributed::Vector<float>>,
-        dealii::LinearAlgebra::distributed::Vector<float>>
+            EnergyMatrix<dim, level_number_type, Number>,
+            level_vector_type>,
+        level_vector_type>
         mg_smoother_energy_;
 
     //@}
@@ -10,6 +10,7 @@
 #include "openmp.h"
 #include "scope.h"
 #include "simd.h"
+#include "solver_pipelined_cg.h"
 
 #include <deal.II/lac/linear_operator.h>
 #include <deal.II/lac/precondition.h>
@@ -19,7 +20,10 @@
 #include <deal.II/multigrid/mg_matrix.h>
 #include <deal.II/multigrid/multigrid.h>
 
+#include <array>
 #include <atomic>
+#include <cstdint>
+#include <sstream>
 
 namespace ryujin
 {
@@ -33,6 +37,7 @@ namespace ryujin
       const ryujin::ProblemDescription &problem_description,
       const ryujin::OfflineData<dim, Number> &offline_data,
       const ryujin::InitialValues<dim, Number> &initial_values,
+      ScratchVectorPool &scratch_vector_pool,
       const std::string &subsection /*= "DissipationModule"*/)
       : ParameterAcceptor(subsection)
       , mpi_communicator_(mpi_communicator)
@@ -40,8 +45,13 @@ namespace ryujin
       , problem_description_(&problem_description)
       , offline_data_(&offline_data)
       , initial_values_(&initial_values)
+      , scratch_vector_pool_(&scratch_vector_pool)
       , n_iterations_velocity_(0.)
       , n_iterations_internal_energy_(0.)
+      , relative_increment_(0.)
+      , gmg_level_offset_(0)
+      , n_increments_(0)
+      , gmg_reference_theta_x_tau_(0.)
   {
     use_gmg_velocity_ = false;
     add_parameter("multigrid velocity",
@@ -100,6 +110,54 @@ namespace ryujin
                   "Minimal mesh level to be visited in the geometric multigrid "
                   "cycle where the coarse grid solver (Chebyshev) is called");
 
+    gmg_coarse_cells_per_rank_ = 0;
+    add_parameter("multigrid - coarse cells per rank",
+                  gmg_coarse_cells_per_rank_,
+                  "Raise the minimal mesh level of the geometric multigrid "
+                  "cycle to the coarsest level with at least this number of "
+                  "cells per MPI rank. Coarser levels only exchange small, "
+                  "latency bound ghost messages. A value of 0 disables the "
+                  "limit");
+
+    gmg_coarse_solver_ = "chebyshev";
+    add_parameter("multigrid - coarse solver",
+                  gmg_coarse_solver_,
+                  "Coarse grid solver of the geometric multigrid cycle. "
+                  "Valid choices are \"chebyshev\" (a Chebyshev iteration "
+                  "with an adaptive degree) and \"cg\" (a conjugate "
+                  "gradient method preconditioned with the Chebyshev "
+                  "smoother)");
+
+    gmg_coarse_max_iter_ = 100;
+    add_parameter("multigrid - coarse max iter",
+                  gmg_coarse_max_iter_,
+                  "Maximal number of iterations of the \"cg\" coarse grid "
+                  "solver");
+
+    gmg_coarse_reduction_ = 1.e-4;
+    add_parameter("multigrid - coarse reduction",
+                  gmg_coarse_reduction_,
+                  "Relative residual reduction of the \"cg\" coarse grid "
+                  "solver");
+
+    gmg_refresh_threshold_ = 0.1;
+    add_parameter("multigrid - refresh threshold",
+                  gmg_refresh_threshold_,
+                  "Relative change of the time step size or the density "
+                  "(measured in the l_infty norm) after which the diagonals "
+                  "and eigenvalue estimates of the Chebyshev smoothers are "
+                  "recomputed");
+
+    gmg_autotune_samples_ = 0;
+    add_parameter("multigrid - autotune samples",
+                  gmg_autotune_samples_,
+                  "Tune the Chebyshev degree, the Chebyshev ranges and the "
+                  "minimal level during the first time steps by timing every "
+                  "candidate over this number of steps. The fastest "
+                  "configuration is written to the log and can be reused by "
+                  "setting the corresponding parameters. A value of 0 "
+                  "disables autotuning");
+
     tolerance_ = Number(1.0e-12);
     add_parameter("tolerance", tolerance_, "Tolerance for linear solvers");
 
@@ -109,9 +167,34 @@ namespace ryujin
                   "Use the l_infty norm instead of the l_2 norm for the "
                   "stopping criterion");
 
+    tolerance_update_factor_ = Number(0.);
+    add_parameter(
+        "tolerance update factor",
+        tolerance_update_factor_,
+        "If nonzero, relax the tolerance of the velocity and internal "
+        "energy solvers to this factor times the relative size of the "
+        "momentum update of the previous parabolic step (but never below "
+        "\"tolerance\"). The linear solvers then stop once the algebraic "
+        "error is small compared to the parabolic update itself");
+
+    use_pipelined_cg_ = false;
+    add_parameter("pipelined cg",
+                  use_pipelined_cg_,
+                  "Use a pipelined conjugate gradient method that overlaps the "
+                  "global reductions with the preconditioner and operator "
+                  "application");
+
     shift_ = Number(0.0);
     add_parameter(
         "shift", shift_, "Implicit shift applied to the Crank Nicolson scheme");
+
+    initial_guess_extrapolation_ = 0;
+    add_parameter("initial guess extrapolation",
+                  initial_guess_extrapolation_,
+                  "Number of previous parabolic updates used for a polynomial "
+                  "extrapolation of the initial guess of the linear solvers "
+                  "(0 - start from the hyperbolic state, 1 - constant, 2 - "
+                  "linear, 3 - quadratic extrapolation)");
   }
 
 
@@ -145,18 +228,56 @@ namespace ryujin
     }
 
     internal_energy_.reinit(scalar_partitioner);
-    internal_energy_rhs_.reinit(scalar_partitioner);
 
-    density_.reinit(scalar_partitioner);
+    AssertThrow(initial_guess_extrapolation_ <= 3,
+                ExcMessage("The number of previous updates used for "
+                           "extrapolating the initial guess must be in the "
+                           "interval [0, 3]"));
+
+    velocity_increments_.resize(initial_guess_extrapolation_);
+    internal_energy_increments_.resize(initial_guess_extrapolation_);
+    for (unsigned int k = 0; k < initial_guess_extrapolation_; ++k) {
+      velocity_increments_[k].reinit(dim);
+      for (unsigned int d = 0; d < dim; ++d)
+        velocity_increments_[k].block(d).reinit(scalar_partitioner);
+      velocity_increments_[k].collect_sizes();
+      internal_energy_increments_[k].reinit(scalar_partitioner);
+    }
+    n_increments_ = 0;
 
     /* Initialize multigrid: */
 
     if (!use_gmg_velocity_ && !use_gmg_internal_energy_)
       return;
 
+    AssertThrow(gmg_coarse_solver_ == "chebyshev" || gmg_coarse_solver_ == "cg",
+                ExcMessage("Unknown coarse grid solver \"" +
+                           gmg_coarse_solver_ + "\""));
+
+    gmg_reference_density_.reinit(scalar_partitioner);
+    gmg_reference_theta_x_tau_ = Number(0.);
+
     const unsigned int n_levels =
         offline_data_->dof_handler().get_triangulation().n_global_levels();
-    const unsigned int min_level = std::min(gmg_min_level_, n_levels - 1);
+    unsigned int min_level = std::min(gmg_min_level_, n_levels - 1);
+
+    if (gmg_coarse_cells_per_rank_ != 0) {
+      const auto &triangulation =
+          offline_data_->dof_handler().get_triangulation();
+      const auto n_ranks = Utilities::MPI::n_mpi_processes(mpi_communicator_);
+
+      for (; min_level + 1 < n_levels; ++min_level) {
+        std::uint64_t n_cells = 0;
+        for (const auto &cell :
+             triangulation.cell_iterators_on_level(min_level))
+          if (cell->level_subdomain_id() ==
+              triangulation.locally_owned_subdomain())
+            ++n_cells;
+        n_cells = Utilities::MPI::sum(n_cells, mpi_communicator_);
+        if (n_cells >= std::uint64_t(gmg_coarse_cells_per_rank_) * n_ranks)
+          break;
+      }
+    }
     MGLevelObject<IndexSet> relevant_sets(0, n_levels - 1);
     for (unsigned int level = 0; level < n_levels; ++level)
       dealii::DoFTools::extract_locally_relevant_level_dofs(
@@ -173,9 +294,10 @@ namespace ryujin
     mg_constrained_dofs_.make_zero_boundary_constraints(
         offline_data_->dof_handler(), boundary_ids);
 
-    typename MatrixFree<dim, float>::AdditionalData additional_data_level;
+    typename MatrixFree<dim, level_number_type>::AdditionalData
+        additional_data_level;
     additional_data_level.tasks_parallel_scheme =
-        MatrixFree<dim, float>::AdditionalData::none;
+        MatrixFree<dim, level_number_type>::AdditionalData::none;
 
     level_matrix_free_.resize(min_level, n_levels - 1);
     level_density_.resize(min_level, n_levels - 1);
@@ -197,6 +319,231 @@ namespace ryujin
     mg_transfer_velocity_.build(
         offline_data_->dof_handler(), mg_constrained_dofs_, level_matrix_free_);
     mg_transfer_energy_.build(offline_data_->dof_handler(), level_matrix_free_);
+
+    /* Select the first autotuning candidate (only once): */
+    autotune_gmg(0.);
+  }
+
+
+  template <int dim, typename Number>
+  unsigned int DissipationModule<dim, Number>::gmg_coarse_level() const
+  {
+    return std::min(level_matrix_free_.min_level() + gmg_level_offset_,
+                    level_matrix_free_.max_level());
+  }
+
+
+  template <int dim, typename Number>
+  void DissipationModule<dim, Number>::autotune_gmg(const double time)
+  {
+    if (gmg_autotune_samples_ == 0 || gmg_autotune_.phase == 3 ||
+        (!use_gmg_velocity_ && !use_gmg_internal_energy_))
+      return;
+
+    /* Candidates of the three sweeps: */
+    constexpr std::array<unsigned int, 4> degrees{{2, 3, 4, 5}};
+    constexpr std::array<double, 4> range_factors{{0.5, 1., 2., 4.}};
+    const unsigned int n_levels =
+        level_matrix_free_.max_level() - level_matrix_free_.min_level() + 1;
+    const std::array<unsigned int, 3> n_candidates{
+        {4, 4, std::min(3u, n_levels)}};
+
+    auto &state = gmg_autotune_;
+
+    const auto apply = [&](const unsigned int candidate) {
+      if (state.phase == 0) {
+        gmg_smoother_degree_ = degrees[candidate];
+      } else if (state.phase == 1) {
+        gmg_smoother_range_vel_ = range_factors[candidate] * state.range_vel;
+        gmg_smoother_range_en_ = range_factors[candidate] * state.range_en;
+      } else {
+        gmg_level_offset_ = candidate;
+      }
+      state.sample = 0;
+      state.time = 0.;
+      /* Force a setup of the smoothers in the next step: */
+      gmg_reference_theta_x_tau_ = Number(0.);
+    };
+
+    if (!state.active) {
+      state.active = true;
+      state.range_vel = gmg_smoother_range_vel_;
+      state.range_en = gmg_smoother_range_en_;
+      apply(0);
+      return;
+    }
+
+    /* The first step of every candidate sets up the smoothers: */
+    if (state.sample++ == 0)
+      return;
+
+    state.time += time;
+    if (state.sample <= gmg_autotune_samples_)
+      return;
+
+    state.time = Utilities::MPI::max(state.time, mpi_communicator_);
+    if (state.candidate == 0 || state.time < state.best_time) {
+      state.best_time = state.time;
+      state.best_candidate = state.candidate;
+    }
+
+    if (++state.candidate < n_candidates[state.phase]) {
+      apply(state.candidate);
+      return;
+    }
+
+    /* Lock in the fastest candidate and continue with the next sweep: */
+    apply(state.best_candidate);
+    state.candidate = 0;
+    if (++state.phase < 3) {
+      apply(0);
+      return;
+    }
+
+    std::ostringstream result;
+    result << "multigrid - chebyshev degree = " << gmg_smoother_degree_
+           << ", multigrid velocity - chebyshev range = "
+           << gmg_smoother_range_vel_
+           << ", multigrid energy - chebyshev range = "
+           << gmg_smoother_range_en_
+           << ", multigrid - min level = " << gmg_coarse_level();
+    gmg_autotune_result_ = result.str();
+  }
+
+
+  template <int dim, typename Number>
+  std::vector<std::pair<std::string, std::size_t>>
+  DissipationModule<dim, Number>::memory_consumption() const
+  {
+    std::vector<std::pair<std::string, std::size_t>> result;
+
+    result.emplace_back("matrix free", matrix_free_.memory_consumption());
+    result.emplace_back("velocity",
+                        velocity_.memory_consumption() +
+                            velocity_rhs_.memory_consumption());
+    result.emplace_back("internal energy",
+                        internal_energy_.memory_consumption());
+
+    std::size_t increments = 0;
+    for (const auto &it : velocity_increments_)
+      increments += it.memory_consumption();
+    for (const auto &it : internal_energy_increments_)
+      increments += it.memory_consumption();
+    result.emplace_back("increments", increments);
+
+    if (use_gmg_velocity_ || use_gmg_internal_energy_) {
+      result.emplace_back("gmg reference density",
+                          gmg_reference_density_.memory_consumption());
+      result.emplace_back("level matrix free",
+                          level_matrix_free_.memory_consumption());
+      result.emplace_back("level density",
+                          level_density_.memory_consumption());
+    }
+
+    return result;
+  }
+
+
+  template <int dim, typename Number>
+  bool
+  DissipationModule<dim, Number>::gmg_needs_refresh(const scalar_type &density,
+                                                    const Number time_factor)
+  {
+    bool gmg_refresh = false;
+
+    if (gmg_reference_theta_x_tau_ == Number(0.)) {
+      gmg_refresh = true;
+    } else {
+      const unsigned int n_owned = offline_data_->n_locally_owned();
+
+      Number change = std::abs(time_factor - gmg_reference_theta_x_tau_) /
+                      gmg_reference_theta_x_tau_;
+
+      RYUJIN_PARALLEL_REGION_BEGIN
+
+      Number thread_change = Number(0.);
+
+      RYUJIN_OMP_FOR
+      for (unsigned int i = 0; i < n_owned; ++i) {
+        const auto rho_ref_i = gmg_reference_density_.local_element(i);
+        if (rho_ref_i == Number(0.))
+          continue;
+        const auto rho_i = density.local_element(i);
+        thread_change =
+            std::max(thread_change, std::abs(rho_i - rho_ref_i) / rho_ref_i);
+      }
+
+      RYUJIN_OMP_CRITICAL
+      change = std::max(change, thread_change);
+
+      RYUJIN_PARALLEL_REGION_END
+
+      change = Utilities::MPI::max(change, mpi_communicator_);
+      gmg_refresh = (change > Number(gmg_refresh_threshold_));
+    }
+
+    if (gmg_refresh) {
+      gmg_reference_density_ = density;
+      gmg_reference_theta_x_tau_ = time_factor;
+    }
+
+    return gmg_refresh;
+  }
+
+
+  template <int dim, typename Number>
+  void
+  DissipationModule<dim, Number>::initialize_gmg_energy(const Number factor,
+                                                        const bool refresh)
+  {
+    /* Only update the coefficient and factor of the level operators: */
+    if (!refresh) {
+      for (unsigned int level = level_matrix_free_.min_level();
+           level <= level_matrix_free_.max_level();
+           ++level)
+        level_energy_matrices_[level].initialize(*offline_data_,
+                                                 level_matrix_free_[level],
+                                                 level_density_[level],
+                                                 factor,
+                                                 level);
+      return;
+    }
+
+    MGLevelObject<typename PreconditionChebyshev<
+        EnergyMatrix<dim, level_number_type, Number>,
+        level_vector_type>::AdditionalData>
+        smoother_data(level_matrix_free_.min_level(),
+                      level_matrix_free_.max_level());
+
+    if (level_energy_matrices_.min_level() != level_matrix_free_.min_level() ||
+        level_energy_matrices_.max_level() != level_matrix_free_.max_level())
+      level_energy_matrices_.resize(level_matrix_free_.min_level(),
+                                    level_matrix_free_.max_level());
+
+    for (unsigned int level = level_matrix_free_.min_level();
+         level <= level_matrix_free_.max_level();
+         ++level) {
+      level_energy_matrices_[level].initialize(*offline_data_,
+                                               level_matrix_free_[level],
+                                               level_density_[level],
+                                               factor,
+                                               level);
+      level_energy_matrices_[level].compute_diagonal(
+          smoother_data[level].preconditioner);
+      if (level == gmg_coarse_level() &&
+          gmg_coarse_solver_ == "chebyshev") {
+        smoother_data[level].degree = numbers::invalid_unsigned_int;
+        smoother_data[level].eig_cg_n_iterations = 500;
+        smoother_data[level].smoothing_range = 1e-3;
+      } else {
+        smoother_data[level].degree = gmg_smoother_degree_;
+        smoother_data[level].eig_cg_n_iterations = gmg_smoother_n_cg_iter_;
+        smoother_data[level].smoothing_range = gmg_smoother_range_en_;
+        if (gmg_smoother_n_cg_iter_ == 0)
+          smoother_data[level].max_eigenvalue = gmg_smoother_max_eig_en_;
+      }
+    }
+    mg_smoother_energy_.initialize(level_energy_matrices_, smoother_data);
   }
 
 
@@ -204,7 +551,7 @@ namespace ryujin
   Number DissipationModule<dim, Number>::step(vector_type &U,
                                               Number t,
                                               Number tau,
-                                              unsigned int cycle)
+                                              unsigned int /*cycle*/)
   {
 #ifdef DEBUG_OUTPUT
     std::cout << "DissipationModule<dim, Number>::step()" << std::endl;
@@ -212,6 +559,8 @@ namespace ryujin
 
     CALLGRIND_START_INSTRUMENTATION
 
+    Timer timer;
+
     using VA = VectorizedArray<Number>;
 
     const auto &lumped_mass_matrix = offline_data_->lumped_mass_matrix();
@@ -223,8 +572,24 @@ namespace ryujin
     const unsigned int n_owned = offline_data_->n_locally_owned();
     const unsigned int size_regular = n_owned / simd_length * simd_length;
 
+    /*
+     * The density and the right hand side of the internal energy update
+     * are only needed for the duration of the step:
+     */
+
+    const auto &scalar_partitioner =
+        matrix_free_.get_dof_info(0).vector_partitioner;
+    const auto density_pointer =
+        scratch_vector_pool_->checkout<scalar_type>(scalar_partitioner);
+    const auto internal_energy_rhs_pointer =
+        scratch_vector_pool_->checkout<scalar_type>(scalar_partitioner);
+    auto &density = *density_pointer;
+    auto &internal_energy_rhs = *internal_energy_rhs_pointer;
+
     DiagonalMatrix<dim, Number> diagonal_matrix;
 
+    bool gmg_refresh = false;
+
     /*
      * Set time step size and record the time t_{n+1/2} for the computed
      * velocity.
@@ -236,6 +601,57 @@ namespace ryujin
     tau_ = tau;
     theta_ = Number(0.5) + shift_ * tau; // FIXME
 
+    /*
+     * Solve a linear system either with the classical or the pipelined
+     * conjugate gradient method:
+     */
+    const auto solve = [&](SolverControl &solver_control,
+                           const auto &op,
+                           auto &x,
+                           const auto &b,
+                           const auto &preconditioner) {
+      using VT = std::decay_t<decltype(x)>;
+
+      /*
+       * Record modeled memory traffic and flops of all fine level
+       * matrix-free vmults (reading the source and destination vectors
+       * and the inverse Jacobian and JxW per quadrature point and
+       * writing the destination vector) and vector updates (about eight
+       * vector reads and writes per iteration):
+       */
+      const auto record = [&]() {
+        constexpr double N = sizeof(Number);
+        constexpr bool is_velocity = std::is_same_v<VT, block_vector_type>;
+        const double n_components = is_velocity ? dim : 1;
+        const double dofs = offline_data_->n_locally_owned();
+        kernel_statistics_[is_velocity ? "time step [N] 1"
+                                       : "time step [N] 3"]
+            .record(solver_control.last_step() * dofs,
+                    0.,
+                    (11. * n_components + dim * dim + 1.) * N,
+                    0.,
+                    (25. * dim + 16.) * n_components,
+                    0.);
+      };
+
+      try {
+        if (use_pipelined_cg_) {
+          SolverPipelinedCG<VT> solver(
+              solver_control,
+              mpi_communicator_,
+              computing_timer_["pipelined cg - reduction wait"]);
+          solver.solve(op, x, b, preconditioner);
+        } else {
+          SolverCG<VT> solver(solver_control);
+          solver.solve(op, x, b, preconditioner);
+        }
+      } catch (SolverControl::NoConvergence &) {
+        record();
+        throw;
+      }
+      record();
+    };
+
     /*
      * Step 0:
      *
@@ -257,7 +673,7 @@ namespace ryujin
         const auto rho_e_i = problem_description_->internal_energy(U_i);
         const auto m_i = simd_load(lumped_mass_matrix, i);
 
-        simd_store(density_, rho_i, i);
+        simd_store(density, rho_i, i);
         /* (5.4a) */
         for (unsigned int d = 0; d < dim; ++d) {
           simd_store(velocity_.block(d), M_i[d] / rho_i, i);
@@ -275,7 +691,7 @@ namespace ryujin
         const auto rho_e_i = problem_description_->internal_energy(U_i);
         const auto m_i = lumped_mass_matrix.local_element(i);
 
-        density_.local_element(i) = rho_i;
+        density.local_element(i) = rho_i;
         /* (5.4a) */
         for (unsigned int d = 0; d < dim; ++d) {
           velocity_.block(d).local_element(i) = M_i[d] / rho_i;
@@ -284,6 +700,25 @@ namespace ryujin
         internal_energy_.local_element(i) = rho_e_i / rho_i;
       }
 
+      /*
+       * Improve the initial guess by extrapolating the increments of the
+       * last parabolic updates (assuming constant time step sizes):
+       */
+      {
+        const unsigned int n_history =
+            std::min(n_increments_, initial_guess_extrapolation_);
+        constexpr Number coefficients[3][3] = {
+            {1., 0., 0.}, {2., -1., 0.}, {3., -3., 1.}};
+
+        for (unsigned int k = 0; k < n_history; ++k) {
+          const unsigned int slot =
+              (n_increments_ - 1 - k) % initial_guess_extrapolation_;
+          const Number c = coefficients[n_history - 1][k];
+          velocity_.add(c, velocity_increments_[slot]);
+          internal_energy_.add(c, internal_energy_increments_[slot]);
+        }
+      }
+
       /*
        * Set up "strongly enforced" boundary conditions that are not stored
        * in the AffineConstraints map. In this case we enforce boundary
@@ -348,7 +783,7 @@ namespace ryujin
        * the linear system.
        */
 
-      affine_constraints.set_zero(density_);
+      affine_constraints.set_zero(density);
       affine_constraints.set_zero(internal_energy_);
       for (unsigned int d = 0; d < dim; ++d) {
         affine_constraints.set_zero(velocity_.block(d));
@@ -357,25 +792,50 @@ namespace ryujin
 
       /* Prepare preconditioner: */
 
-      diagonal_matrix.reinit(lumped_mass_matrix, density_, affine_constraints);
+      diagonal_matrix.reinit(lumped_mass_matrix, density, affine_constraints);
 
       /*
-       * Update MG matrices all 4 time steps; this is a balance because more
-       * refreshes will render the approximation better, at some additional
-       * cost.
+       * The multigrid hierarchy (level matrix-free objects, transfer and
+       * level operators) is kept across time steps. The level densities
+       * and the time step size of the level operators are updated in
+       * place every time step. The more expensive setup of the Chebyshev
+       * smoothers (computing the inverse diagonal and an eigenvalue
+       * estimate on every level) is only repeated if theta * tau or the
+       * density changed by more than gmg_refresh_threshold_ since the last
+       * setup.
        */
-      if (use_gmg_velocity_ && (cycle % 4 == 1)) {
+      if (use_gmg_velocity_ || use_gmg_internal_energy_) {
+        gmg_refresh = gmg_needs_refresh(density, theta_ * tau_);
+        mg_transfer_velocity_.interpolate_to_mg(
+            offline_data_->dof_handler(), level_density_, density);
+      }
+
+      if (use_gmg_velocity_ && !gmg_refresh) {
+        for (unsigned int level = level_matrix_free_.min_level();
+             level <= level_matrix_free_.max_level();
+             ++level)
+          level_velocity_matrices_[level].initialize(*problem_description_,
+                                                     *offline_data_,
+                                                     level_matrix_free_[level],
+                                                     level_density_[level],
+                                                     theta_ * tau_,
+                                                     level);
+      }
+
+      if (use_gmg_velocity_ && gmg_refresh) {
         MGLevelObject<typename PreconditionChebyshev<
-            VelocityMatrix<dim, float, Number>,
-            LinearAlgebra::distributed::BlockVector<float>,
-            DiagonalMatrix<dim, float>>::AdditionalData>
+            VelocityMatrix<dim, level_number_type, Number>,
+            level_block_vector_type,
+            DiagonalMatrix<dim, level_number_type>>::AdditionalData>
             smoother_data(level_matrix_free_.min_level(),
                           level_matrix_free_.max_level());
 
-        level_velocity_matrices_.resize(level_matrix_free_.min_level(),
-                                        level_matrix_free_.max_level());
-        mg_transfer_velocity_.interpolate_to_mg(
-            offline_data_->dof_handler(), level_density_, density_);
+        if (level_velocity_matrices_.min_level() !=
+                level_matrix_free_.min_level() ||
+            level_velocity_matrices_.max_level() !=
+                level_matrix_free_.max_level())
+          level_velocity_matrices_.resize(level_matrix_free_.min_level(),
+                                          level_matrix_free_.max_level());
 
         for (unsigned int level = level_matrix_free_.min_level();
              level <= level_matrix_free_.max_level();
@@ -388,7 +848,8 @@ namespace ryujin
                                                      level);
           level_velocity_matrices_[level].compute_diagonal(
               smoother_data[level].preconditioner);
-          if (level == level_matrix_free_.min_level()) {
+          if (level == gmg_coarse_level() &&
+              gmg_coarse_solver_ == "chebyshev") {
             smoother_data[level].degree = numbers::invalid_unsigned_int;
             smoother_data[level].eig_cg_n_iterations = 500;
             smoother_data[level].smoothing_range = 1e-3;
@@ -407,6 +868,15 @@ namespace ryujin
       LIKWID_MARKER_STOP("time_step_0");
     }
 
+    /*
+     * Relative tolerance of the velocity and internal energy solvers. If
+     * requested, relax it to a fraction of the relative size of the last
+     * parabolic update: Solving more accurately has no effect beyond the
+     * splitting and discretization error:
+     */
+    const Number tolerance =
+        std::max(tolerance_, tolerance_update_factor_ * relative_increment_);
+
     /*
      * Step 1: Solve velocity update:
      */
@@ -419,13 +889,13 @@ namespace ryujin
       velocity_operator.initialize(*problem_description_,
                                    *offline_data_,
                                    matrix_free_,
-                                   density_,
+                                   density,
                                    theta_ * tau_);
 
       const auto tolerance_velocity =
           (tolerance_linfty_norm_ ? velocity_rhs_.linfty_norm()
                                   : velocity_rhs_.l2_norm()) *
-          tolerance_;
+          tolerance;
 
       /*
        * Multigrid might lack robustness for some cases, so in case it takes
@@ -436,40 +906,58 @@ namespace ryujin
         if (!use_gmg_velocity_)
           throw SolverControl::NoConvergence(0, 0.);
 
-        using bvt_float = LinearAlgebra::distributed::BlockVector<float>;
-
-        MGCoarseGridApplySmoother<bvt_float> mg_coarse;
-        mg_coarse.initialize(mg_smoother_velocity_);
-
-        mg::Matrix<bvt_float> mg_matrix(level_velocity_matrices_);
-
-        Multigrid<bvt_float> mg(mg_matrix,
+        using bvt_level = level_block_vector_type;
+
+        MGCoarseGridApplySmoother<bvt_level> mg_coarse_chebyshev(
+            mg_smoother_velocity_);
+        MGCoarseGridCG<bvt_level,
+                       VelocityMatrix<dim, level_number_type, Number>,
+                       decltype(mg_smoother_velocity_)>
+            mg_coarse_cg(level_velocity_matrices_,
+                         mg_smoother_velocity_,
+                         gmg_coarse_max_iter_,
+                         gmg_coarse_reduction_);
+        const MGCoarseGridBase<bvt_level> &mg_coarse =
+            gmg_coarse_solver_ == "cg"
+                ? static_cast<const MGCoarseGridBase<bvt_level> &>(mg_coarse_cg)
+                : mg_coarse_chebyshev;
+
+        mg::Matrix<bvt_level> mg_matrix(level_velocity_matrices_);
+
+        Multigrid<bvt_level> mg(mg_matrix,
                                 mg_coarse,
                                 mg_transfer_velocity_,
                                 mg_smoother_velocity_,
                                 mg_smoother_velocity_,
-                                level_velocity_matrices_.min_level(),
+                                gmg_coarse_level(),
                                 level_velocity_matrices_.max_level());
 
         const auto &dof_handler = offline_data_->dof_handler();
-        PreconditionMG<dim, bvt_float, MGTransferVelocity<dim, float>>
+        PreconditionMG<dim,
+                       bvt_level,
+                       MGTransferVelocity<dim, level_number_type>>
             preconditioner(dof_handler, mg, mg_transfer_velocity_);
 
         SolverControl solver_control(gmg_max_iter_vel_, tolerance_velocity);
-        SolverCG<block_vector_type> solver(solver_control);
-        solver.solve(
-            velocity_operator, velocity_, velocity_rhs_, preconditioner);
+        solve(solver_control,
+              velocity_operator,
+              velocity_,
+              velocity_rhs_,
+              preconditioner);
 
         /* update exponential moving average */
         n_iterations_velocity_ =
             0.9 * n_iterations_velocity_ + 0.1 * solver_control.last_step();
+        Trace::counter("CG iterations velocity", solver_control.last_step());
 
       } catch (SolverControl::NoConvergence &) {
 
         SolverControl solver_control(1000, tolerance_velocity);
-        SolverCG<block_vector_type> solver(solver_control);
-        solver.solve(
-            velocity_operator, velocity_, velocity_rhs_, diagonal_matrix);
+        solve(solver_control,
+              velocity_operator,
+              velocity_,
+              velocity_rhs_,
+              diagonal_matrix);
 
         /* update exponential moving average, counting also GMG iterations */
         n_iterations_velocity_ *= 0.9;
@@ -534,7 +1022,7 @@ namespace ryujin
 #endif
             }
           },
-          internal_energy_rhs_,
+          internal_energy_rhs,
           velocity_,
           /* zero destination */ true);
 
@@ -549,24 +1037,24 @@ namespace ryujin
 
       RYUJIN_OMP_FOR
       for (unsigned int i = 0; i < size_regular; i += simd_length) {
-        const auto rhs_i = simd_load(internal_energy_rhs_, i);
+        const auto rhs_i = simd_load(internal_energy_rhs, i);
         const auto m_i = simd_load(lumped_mass_matrix, i);
-        const auto rho_i = simd_load(density_, i);
+        const auto rho_i = simd_load(density, i);
         const auto e_i = simd_load(internal_energy_, i);
         /* rhs_i already contains m_i K_i^{n+1/2} */
         simd_store(
-            internal_energy_rhs_, m_i * rho_i * e_i + theta_ * tau_ * rhs_i, i);
+            internal_energy_rhs, m_i * rho_i * e_i + theta_ * tau_ * rhs_i, i);
       }
 
       RYUJIN_PARALLEL_REGION_END
 
       for (unsigned int i = size_regular; i < n_owned; ++i) {
-        const auto rhs_i = internal_energy_rhs_.local_element(i);
+        const auto rhs_i = internal_energy_rhs.local_element(i);
         const auto m_i = lumped_mass_matrix.local_element(i);
-        const auto rho_i = density_.local_element(i);
+        const auto rho_i = density.local_element(i);
         const auto e_i = internal_energy_.local_element(i);
         /* rhs_i already contains m_i K_i^{n+1/2} */
-        internal_energy_rhs_.local_element(i) =
+        internal_energy_rhs.local_element(i) =
             m_i * rho_i * e_i + theta_ * tau_ * rhs_i;
       }
 
@@ -592,7 +1080,7 @@ namespace ryujin
               initial_values_->initial_state(position, t + theta_ * tau_);
           const auto rho_i = problem_description_->density(U_i);
           const auto e_i = problem_description_->internal_energy(U_i) / rho_i;
-          internal_energy_rhs_.local_element(i) = e_i;
+          internal_energy_rhs.local_element(i) = e_i;
         }
       }
 
@@ -602,48 +1090,16 @@ namespace ryujin
        * the stencil - consequently we have to remove constrained dofs from
        * the linear system.
        */
-      affine_constraints.set_zero(internal_energy_rhs_);
+      affine_constraints.set_zero(internal_energy_rhs);
 
       /*
-       * Update MG matrices all 4 time steps; this is a balance because more
-       * refreshes will render the approximation better, at some additional
-       * cost.
+       * Update the multigrid hierarchy for the internal energy, see the
+       * velocity update above:
        */
-      if (use_gmg_internal_energy_ && (cycle % 4 == 1)) {
-        MGLevelObject<typename PreconditionChebyshev<
-            EnergyMatrix<dim, float, Number>,
-            LinearAlgebra::distributed::Vector<float>>::AdditionalData>
-            smoother_data(level_matrix_free_.min_level(),
-                          level_matrix_free_.max_level());
-
-        level_energy_matrices_.resize(level_matrix_free_.min_level(),
-                                      level_matrix_free_.max_level());
-
-        for (unsigned int level = level_matrix_free_.min_level();
-             level <= level_matrix_free_.max_level();
-             ++level) {
-          level_energy_matrices_[level].initialize(
-              *offline_data_,
-              level_matrix_free_[level],
-              level_density_[level],
-              theta_ * tau_ * problem_description_->cv_inverse_kappa(),
-              level);
-          level_energy_matrices_[level].compute_diagonal(
-              smoother_data[level].preconditioner);
-          if (level == level_matrix_free_.min_level()) {
-            smoother_data[level].degree = numbers::invalid_unsigned_int;
-            smoother_data[level].eig_cg_n_iterations = 500;
-            smoother_data[level].smoothing_range = 1e-3;
-          } else {
-            smoother_data[level].degree = gmg_smoother_degree_;
-            smoother_data[level].eig_cg_n_iterations = gmg_smoother_n_cg_iter_;
-            smoother_data[level].smoothing_range = gmg_smoother_range_en_;
-            if (gmg_smoother_n_cg_iter_ == 0)
-              smoother_data[level].max_eigenvalue = gmg_smoother_max_eig_en_;
-          }
-        }
-        mg_smoother_energy_.initialize(level_energy_matrices_, smoother_data);
-      }
+      if (use_gmg_internal_energy_)
+        initialize_gmg_energy(
+            theta_ * tau_ * problem_description_->cv_inverse_kappa(),
+            gmg_refresh);
 
       LIKWID_MARKER_STOP("time_step_n_2");
     }
@@ -659,56 +1115,69 @@ namespace ryujin
       EnergyMatrix<dim, Number, Number> energy_operator;
       energy_operator.initialize(*offline_data_,
                                  matrix_free_,
-                                 density_,
+                                 density,
                                  theta_ * tau_ *
                                      problem_description_->cv_inverse_kappa());
 
       const auto tolerance_internal_energy =
-          (tolerance_linfty_norm_ ? internal_energy_rhs_.linfty_norm()
-                                  : internal_energy_rhs_.l2_norm()) *
-          tolerance_;
+          (tolerance_linfty_norm_ ? internal_energy_rhs.linfty_norm()
+                                  : internal_energy_rhs.l2_norm()) *
+          tolerance;
 
       try {
         if (!use_gmg_internal_energy_)
           throw SolverControl::NoConvergence(0, 0.);
 
-        using vt_float = LinearAlgebra::distributed::Vector<float>;
-        MGCoarseGridApplySmoother<vt_float> mg_coarse;
-        mg_coarse.initialize(mg_smoother_energy_);
-        mg::Matrix<vt_float> mg_matrix(level_energy_matrices_);
-
-        Multigrid<vt_float> mg(mg_matrix,
+        using vt_level = level_vector_type;
+        MGCoarseGridApplySmoother<vt_level> mg_coarse_chebyshev(
+            mg_smoother_energy_);
+        MGCoarseGridCG<vt_level,
+                       EnergyMatrix<dim, level_number_type, Number>,
+                       decltype(mg_smoother_energy_)>
+            mg_coarse_cg(level_energy_matrices_,
+                         mg_smoother_energy_,
+                         gmg_coarse_max_iter_,
+                         gmg_coarse_reduction_);
+        const MGCoarseGridBase<vt_level> &mg_coarse =
+            gmg_coarse_solver_ == "cg"
+                ? static_cast<const MGCoarseGridBase<vt_level> &>(mg_coarse_cg)
+                : mg_coarse_chebyshev;
+        mg::Matrix<vt_level> mg_matrix(level_energy_matrices_);
+
+        Multigrid<vt_level> mg(mg_matrix,
                                mg_coarse,
                                mg_transfer_energy_,
                                mg_smoother_energy_,
                                mg_smoother_energy_,
-                               level_energy_matrices_.min_level(),
+                               gmg_coarse_level(),
                                level_energy_matrices_.max_level());
 
         const auto &dof_handler = offline_data_->dof_handler();
-        PreconditionMG<dim, vt_float, MGTransferEnergy<dim, float>>
+        PreconditionMG<dim, vt_level, MGTransferEnergy<dim, level_number_type>>
             preconditioner(dof_handler, mg, mg_transfer_energy_);
 
         SolverControl solver_control(gmg_max_iter_en_,
                                      tolerance_internal_energy);
-        SolverCG<scalar_type> solver(solver_control);
-        solver.solve(energy_operator,
-                     internal_energy_,
-                     internal_energy_rhs_,
-                     preconditioner);
+        solve(solver_control,
+              energy_operator,
+              internal_energy_,
+              internal_energy_rhs,
+              preconditioner);
 
         /* update exponential moving average */
         n_iterations_internal_energy_ = 0.9 * n_iterations_internal_energy_ +
                                         0.1 * solver_control.last_step();
+        Trace::counter("CG iterations internal energy",
+                       solver_control.last_step());
 
       } catch (SolverControl::NoConvergence &) {
 
         SolverControl solver_control(1000, tolerance_internal_energy);
-        SolverCG<scalar_type> solver(solver_control);
-        solver.solve(energy_operator,
-                     internal_energy_,
-                     internal_energy_rhs_,
-                     diagonal_matrix);
+        solve(solver_control,
+              energy_operator,
+              internal_energy_,
+              internal_energy_rhs,
+              diagonal_matrix);
 
         /* update exponential moving average, counting also GMG iterations */
         n_iterations_internal_energy_ *= 0.9;
@@ -728,11 +1197,23 @@ namespace ryujin
     {
       const auto alpha = Number(1.) / theta_;
 
+      /* Record the increments of this update for extrapolation: */
+      const bool record_increments = initial_guess_extrapolation_ > 0;
+      const unsigned int slot =
+          record_increments ? n_increments_ % initial_guess_extrapolation_ : 0;
+
       Scope scope(computing_timer_, "time step [N] 4 - write back vectors");
 
+      /* Squared l2 norms of the momentum update and the old momentum: */
+      Number increment_norm_square = Number(0.);
+      Number momentum_norm_square = Number(0.);
+
       RYUJIN_PARALLEL_REGION_BEGIN
       LIKWID_MARKER_START("time_step_4");
 
+      VA thread_increment_norm_square = VA(0.);
+      VA thread_momentum_norm_square = VA(0.);
+
       const unsigned int size_regular = n_owned / simd_length * simd_length;
 
       RYUJIN_OMP_FOR
@@ -740,6 +1221,18 @@ namespace ryujin
         auto U_i = U.get_vectorized_tensor(i);
         const auto rho_i = problem_description_->density(U_i);
 
+        if (record_increments) {
+          const auto M_i = problem_description_->momentum(U_i);
+          const auto rho_e_i = problem_description_->internal_energy(U_i);
+          for (unsigned int d = 0; d < dim; ++d)
+            simd_store(velocity_increments_[slot].block(d),
+                       simd_load(velocity_.block(d), i) - M_i[d] / rho_i,
+                       i);
+          simd_store(internal_energy_increments_[slot],
+                     simd_load(internal_energy_, i) - rho_e_i / rho_i,
+                     i);
+        }
+
         /* (5.4b) */
         auto m_i_new =
             (Number(1.) - alpha) * problem_description_->momentum(U_i);
@@ -755,6 +1248,10 @@ namespace ryujin
         /* (5.18) */
         const auto E_i_new = rho_e_i_new + 0.5 * m_i_new * m_i_new / rho_i;
 
+        const auto M_i = problem_description_->momentum(U_i);
+        thread_increment_norm_square += (m_i_new - M_i).norm_square();
+        thread_momentum_norm_square += M_i.norm_square();
+
         for (unsigned int d = 0; d < dim; ++d)
           U_i[1 + d] = m_i_new[d];
         U_i[1 + dim] = E_i_new;
@@ -762,12 +1259,30 @@ namespace ryujin
         U.write_vectorized_tensor(U_i, i);
       }
 
+      RYUJIN_OMP_CRITICAL
+      {
+        for (unsigned int k = 0; k < simd_length; ++k) {
+          increment_norm_square += thread_increment_norm_square[k];
+          momentum_norm_square += thread_momentum_norm_square[k];
+        }
+      }
+
       RYUJIN_PARALLEL_REGION_END
 
       for (unsigned int i = size_regular; i < n_owned; ++i) {
         auto U_i = U.get_tensor(i);
         const auto rho_i = problem_description_->density(U_i);
 
+        if (record_increments) {
+          const auto M_i = problem_description_->momentum(U_i);
+          const auto rho_e_i = problem_description_->internal_energy(U_i);
+          for (unsigned int d = 0; d < dim; ++d)
+            velocity_increments_[slot].block(d).local_element(i) =
+                velocity_.block(d).local_element(i) - M_i[d] / rho_i;
+          internal_energy_increments_[slot].local_element(i) =
+              internal_energy_.local_element(i) - rho_e_i / rho_i;
+        }
+
         /* (5.4b) */
         auto m_i_new =
             (Number(1.) - alpha) * problem_description_->momentum(U_i);
@@ -783,6 +1298,10 @@ namespace ryujin
         /* (5.18) */
         const auto E_i_new = rho_e_i_new + 0.5 * m_i_new * m_i_new / rho_i;
 
+        const auto M_i = problem_description_->momentum(U_i);
+        increment_norm_square += (m_i_new - M_i).norm_square();
+        momentum_norm_square += M_i.norm_square();
+
         for (unsigned int d = 0; d < dim; ++d)
           U_i[1 + d] = m_i_new[d];
         U_i[1 + dim] = E_i_new;
@@ -792,13 +1311,411 @@ namespace ryujin
 
       U.update_ghost_values();
 
+      increment_norm_square =
+          Utilities::MPI::sum(increment_norm_square, mpi_communicator_);
+      momentum_norm_square =
+          Utilities::MPI::sum(momentum_norm_square, mpi_communicator_);
+      relative_increment_ =
+          momentum_norm_square > Number(0.)
+              ? std::sqrt(increment_norm_square / momentum_norm_square)
+              : Number(0.);
+
+      if (record_increments)
+        ++n_increments_;
+
       LIKWID_MARKER_STOP("time_step_4");
     }
 
+    autotune_gmg(timer.wall_time());
+
     CALLGRIND_STOP_INSTRUMENTATION
 
     return tau;
   }
 
 
+  template <int dim, typename Number>
+  Number DissipationModule<dim, Number>::acoustic_step(vector_type &U,
+                                                       Number t,
+                                                       Number tau)
+  {
+#ifdef DEBUG_OUTPUT
+    std::cout << "DissipationModule<dim, Number>::acoustic_step()" << std::endl;
+#endif
+
+    CALLGRIND_START_INSTRUMENTATION
+
+    const auto &lumped_mass_matrix = offline_data_->lumped_mass_matrix();
+    const auto &affine_constraints = offline_data_->affine_constraints();
+    const auto &boundary_map = offline_data_->boundary_map();
+    const auto &sparsity_simd = offline_data_->sparsity_pattern_simd();
+    const unsigned int n_owned = offline_data_->n_locally_owned();
+
+    const auto &scalar_partitioner =
+        matrix_free_.get_dof_info(0).vector_partitioner;
+    const auto density_pointer =
+        scratch_vector_pool_->checkout<scalar_type>(scalar_partitioner);
+    const auto coefficient_pointer =
+        scratch_vector_pool_->checkout<scalar_type>(scalar_partitioner);
+    const auto pressure_pointer =
+        scratch_vector_pool_->checkout<scalar_type>(scalar_partitioner);
+    const auto pressure_rhs_pointer =
+        scratch_vector_pool_->checkout<scalar_type>(scalar_partitioner);
+    auto &density = *density_pointer;
+    auto &coefficient = *coefficient_pointer;
+    auto &pressure = *pressure_pointer;
+    auto &pressure_rhs = *pressure_rhs_pointer;
+
+    /*
+     * Impose boundary conditions on the velocity: Remove the normal
+     * component on slip boundaries, and prescribe the velocity on no slip
+     * and Dirichlet boundaries:
+     */
+    const auto apply_velocity_boundary_conditions = [&]() {
+      for (auto entry : boundary_map) {
+        const auto i = entry.first;
+        if (i >= n_owned)
+          continue;
+
+        const auto &[normal, id, position] = entry.second;
+
+        Tensor<1, dim, Number> V_i;
+        if (id == Boundary::slip) {
+          for (unsigned int d = 0; d < dim; ++d)
+            V_i[d] = velocity_.block(d).local_element(i);
+          V_i -= 1. * (V_i * normal) * normal;
+        } else if (id == Boundary::dirichlet) {
+          const auto U_i = initial_values_->initial_state(position, t + tau);
+          V_i = problem_description_->momentum(U_i) /
+                problem_description_->density(U_i);
+        } else if (id != Boundary::no_slip) {
+          continue;
+        }
+
+        for (unsigned int d = 0; d < dim; ++d)
+          velocity_.block(d).local_element(i) = V_i[d];
+      }
+    };
+
+    /*
+     * Step 0:
+     *
+     * Extract density, velocity and pressure of the state after the
+     * advective update and compute the coefficient
+     *   kappa_i = rho_i (rho e)_i / p_i^2
+     * of the linearized pressure update dp/dt = -p^2 / (rho e) div v.
+     * For an ideal gas kappa_i = rho_i / ((gamma - 1) p_i).
+     */
+    {
+      Scope scope(computing_timer_, "time step [A] 0 - build pressure rhs");
+
+      RYUJIN_PARALLEL_REGION_BEGIN
+
+      RYUJIN_OMP_FOR
+      for (unsigned int i = 0; i < n_owned; ++i) {
+        const auto U_i = U.get_tensor(i);
+        const auto rho_i = problem_description_->density(U_i);
+        const auto M_i = problem_description_->momentum(U_i);
+        const auto rho_e_i = problem_description_->internal_energy(U_i);
+        const auto p_i = problem_description_->pressure(U_i);
+
+        density.local_element(i) = rho_i;
+        for (unsigned int d = 0; d < dim; ++d)
+          velocity_.block(d).local_element(i) = M_i[d] / rho_i;
+        pressure.local_element(i) = p_i;
+        coefficient.local_element(i) = rho_i * rho_e_i / (p_i * p_i);
+      }
+
+      RYUJIN_PARALLEL_REGION_END
+
+      apply_velocity_boundary_conditions();
+
+      affine_constraints.set_zero(coefficient);
+      for (unsigned int d = 0; d < dim; ++d)
+        affine_constraints.set_zero(velocity_.block(d));
+
+      /* Compute \sum_j c_ij \cdot V_j = (div V, phi_i): */
+      matrix_free_.template cell_loop<scalar_type, block_vector_type>(
+          [](const auto &data,
+             auto &dst,
+             const auto &src,
+             const auto cell_range) {
+            constexpr auto order_fe = Discretization<dim>::order_finite_element;
+            constexpr auto order_quad = Discretization<dim>::order_quadrature;
+            FEEvaluation<dim, order_fe, order_quad, dim, Number> velocity(data);
+            FEEvaluation<dim, order_fe, order_quad, 1, Number> pressure(data);
+
+            for (unsigned int cell = cell_range.first; cell < cell_range.second;
+                 ++cell) {
+              velocity.reinit(cell);
+              pressure.reinit(cell);
+#if DEAL_II_VERSION_GTE(9, 3, 0)
+              velocity.gather_evaluate(src, EvaluationFlags::gradients);
+#else
+              velocity.read_dof_values(src);
+              velocity.evaluate(false, true);
+#endif
+              for (unsigned int q = 0; q < velocity.n_q_points; ++q)
+                pressure.submit_value(velocity.get_divergence(q), q);
+#if DEAL_II_VERSION_GTE(9, 3, 0)
+              pressure.integrate_scatter(EvaluationFlags::values, dst);
+#else
+              pressure.integrate_scatter(true, false, dst);
+#endif
+            }
+          },
+          pressure_rhs,
+          velocity_,
+          /* zero destination */ true);
+
+      RYUJIN_PARALLEL_REGION_BEGIN
+
+      RYUJIN_OMP_FOR
+      for (unsigned int i = 0; i < n_owned; ++i) {
+        const auto m_i = lumped_mass_matrix.local_element(i);
+        const auto rho_i = density.local_element(i);
+        const auto kappa_i = coefficient.local_element(i);
+        const auto p_i = pressure.local_element(i);
+        const auto div_i = pressure_rhs.local_element(i);
+        pressure_rhs.local_element(i) =
+            kappa_i * m_i * p_i - tau * rho_i * div_i;
+      }
+
+      RYUJIN_PARALLEL_REGION_END
+
+      /* Prescribe the pressure on Dirichlet boundaries: */
+      for (auto entry : boundary_map) {
+        const auto i = entry.first;
+        if (i >= n_owned)
+          continue;
+
+        const auto &[normal, id, position] = entry.second;
+        if (id == Boundary::dirichlet) {
+          const auto U_i = initial_values_->initial_state(position, t + tau);
+          const auto p_i = problem_description_->pressure(U_i);
+          pressure.local_element(i) = p_i;
+          pressure_rhs.local_element(i) = p_i;
+        }
+      }
+
+      affine_constraints.set_zero(pressure);
+      affine_constraints.set_zero(pressure_rhs);
+
+      if (use_gmg_internal_energy_) {
+        const bool refresh = gmg_needs_refresh(coefficient, tau * tau);
+        mg_transfer_velocity_.interpolate_to_mg(
+            offline_data_->dof_handler(), level_density_, coefficient);
+        initialize_gmg_energy(tau * tau, refresh);
+      }
+    }
+
+    /*
+     * Step 1: Solve the pressure update
+     *   kappa_i m_i p_i + tau^2 \sum_j beta_ij p_j = m_i kappa_i p_i^* -
+     *   tau rho_i \sum_j c_ij \cdot V_j^*
+     * with the internal energy operator.
+     */
+    {
+      Scope scope(computing_timer_, "time step [A] 1 - update pressure");
+
+      EnergyMatrix<dim, Number, Number> pressure_operator;
+      pressure_operator.initialize(
+          *offline_data_, matrix_free_, coefficient, tau * tau);
+
+      const auto tolerance_pressure =
+          (tolerance_linfty_norm_ ? pressure_rhs.linfty_norm()
+                                  : pressure_rhs.l2_norm()) *
+          tolerance_;
+
+      const auto solve = [&](SolverControl &solver_control,
+                             const auto &preconditioner) {
+        if (use_pipelined_cg_) {
+          SolverPipelinedCG<scalar_type> solver(
+              solver_control,
+              mpi_communicator_,
+              computing_timer_["pipelined cg - reduction wait"]);
+          solver.solve(
+              pressure_operator, pressure, pressure_rhs, preconditioner);
+        } else {
+          SolverCG<scalar_type> solver(solver_control);
+          solver.solve(
+              pressure_operator, pressure, pressure_rhs, preconditioner);
+        }
+      };
+
+      /*
+       * The iteration counts are reported together with the ones of the
+       * internal energy update:
+       */
+      try {
+        if (!use_gmg_internal_energy_)
+          throw SolverControl::NoConvergence(0, 0.);
+
+        using vt_level = level_vector_type;
+        MGCoarseGridApplySmoother<vt_level> mg_coarse_chebyshev(
+            mg_smoother_energy_);
+        MGCoarseGridCG<vt_level,
+                       EnergyMatrix<dim, level_number_type, Number>,
+                       decltype(mg_smoother_energy_)>
+            mg_coarse_cg(level_energy_matrices_,
+                         mg_smoother_energy_,
+                         gmg_coarse_max_iter_,
+                         gmg_coarse_reduction_);
+        const MGCoarseGridBase<vt_level> &mg_coarse =
+            gmg_coarse_solver_ == "cg"
+                ? static_cast<const MGCoarseGridBase<vt_level> &>(mg_coarse_cg)
+                : mg_coarse_chebyshev;
+        mg::Matrix<vt_level> mg_matrix(level_energy_matrices_);
+
+        Multigrid<vt_level> mg(mg_matrix,
+                               mg_coarse,
+                               mg_transfer_energy_,
+                               mg_smoother_energy_,
+                               mg_smoother_energy_,
+                               gmg_coarse_level(),
+                               level_energy_matrices_.max_level());
+
+        const auto &dof_handler = offline_data_->dof_handler();
+        PreconditionMG<dim, vt_level, MGTransferEnergy<dim, level_number_type>>
+            preconditioner(dof_handler, mg, mg_transfer_energy_);
+
+        SolverControl solver_control(gmg_max_iter_en_, tolerance_pressure);
+        solve(solver_control, preconditioner);
+
+        n_iterations_internal_energy_ = 0.9 * n_iterations_internal_energy_ +
+                                        0.1 * solver_control.last_step();
+        Trace::counter("CG iterations pressure", solver_control.last_step());
+
+      } catch (SolverControl::NoConvergence &) {
+
+        DiagonalMatrix<dim, Number> diagonal_matrix;
+        diagonal_matrix.reinit(
+            lumped_mass_matrix, coefficient, affine_constraints);
+
+        SolverControl solver_control(1000, tolerance_pressure);
+        solve(solver_control, diagonal_matrix);
+
+        n_iterations_internal_energy_ *= 0.9;
+        n_iterations_internal_energy_ +=
+            0.1 * (use_gmg_internal_energy_ ? gmg_max_iter_en_ : 0) +
+            0.1 * solver_control.last_step();
+      }
+    }
+
+    /*
+     * Step 2: Correct the velocity with the new pressure gradient,
+     *   V_i = V_i^* - tau / (rho_i m_i) \sum_j c_ij p_j,
+     * scale the internal energy with p_i / p_i^* and write back.
+     */
+    {
+      Scope scope(computing_timer_, "time step [A] 2 - write back vectors");
+
+      /* Compute \sum_j c_ij p_j = (grad p, phi_i): */
+      matrix_free_.template cell_loop<block_vector_type, scalar_type>(
+          [](const auto &data,
+             auto &dst,
+             const auto &src,
+             const auto cell_range) {
+            constexpr auto order_fe = Discretization<dim>::order_finite_element;
+            constexpr auto order_quad = Discretization<dim>::order_quadrature;
+            FEEvaluation<dim, order_fe, order_quad, dim, Number> velocity(data);
+            FEEvaluation<dim, order_fe, order_quad, 1, Number> pressure(data);
+
+            for (unsigned int cell = cell_range.first; cell < cell_range.second;
+                 ++cell) {
+              velocity.reinit(cell);
+              pressure.reinit(cell);
+#if DEAL_II_VERSION_GTE(9, 3, 0)
+              pressure.gather_evaluate(src, EvaluationFlags::gradients);
+#else
+              pressure.read_dof_values(src);
+              pressure.evaluate(false, true);
+#endif
+              for (unsigned int q = 0; q < velocity.n_q_points; ++q)
+                velocity.submit_value(pressure.get_gradient(q), q);
+#if DEAL_II_VERSION_GTE(9, 3, 0)
+              velocity.integrate_scatter(EvaluationFlags::values, dst);
+#else
+              velocity.integrate_scatter(true, false, dst);
+#endif
+            }
+          },
+          velocity_rhs_,
+          pressure,
+          /* zero destination */ true);
+
+      RYUJIN_PARALLEL_REGION_BEGIN
+
+      RYUJIN_OMP_FOR
+      for (unsigned int i = 0; i < n_owned; ++i) {
+        /* Skip constrained degrees of freedom: */
+        if (sparsity_simd.row_length(i) == 1)
+          continue;
+
+        const auto m_i = lumped_mass_matrix.local_element(i);
+        const auto rho_i = density.local_element(i);
+        const auto factor = tau / (rho_i * m_i);
+        for (unsigned int d = 0; d < dim; ++d)
+          velocity_.block(d).local_element(i) -=
+              factor * velocity_rhs_.block(d).local_element(i);
+      }
+
+      RYUJIN_PARALLEL_REGION_END
+
+      apply_velocity_boundary_conditions();
+
+      unsigned int n_negative = 0;
+
+      RYUJIN_PARALLEL_REGION_BEGIN
+
+      unsigned int thread_n_negative = 0;
+
+      RYUJIN_OMP_FOR
+      for (unsigned int i = 0; i < n_owned; ++i) {
+        /* Skip constrained degrees of freedom: */
+        if (sparsity_simd.row_length(i) == 1)
+          continue;
+
+        auto U_i = U.get_tensor(i);
+        const auto rho_i = problem_description_->density(U_i);
+        const auto rho_e_i = problem_description_->internal_energy(U_i);
+        const auto p_old_i = problem_description_->pressure(U_i);
+        const auto p_new_i = pressure.local_element(i);
+
+        if (!(p_new_i > Number(0.)))
+          ++thread_n_negative;
+
+        Tensor<1, dim, Number> m_i_new;
+        for (unsigned int d = 0; d < dim; ++d)
+          m_i_new[d] = rho_i * velocity_.block(d).local_element(i);
+
+        /* At fixed density p is proportional to rho e: */
+        const auto rho_e_i_new = rho_e_i * p_new_i / p_old_i;
+        const auto E_i_new = rho_e_i_new + 0.5 * m_i_new * m_i_new / rho_i;
+
+        for (unsigned int d = 0; d < dim; ++d)
+          U_i[1 + d] = m_i_new[d];
+        U_i[1 + dim] = E_i_new;
+
+        U.write_tensor(U_i, i);
+      }
+
+      RYUJIN_OMP_CRITICAL
+      n_negative += thread_n_negative;
+
+      RYUJIN_PARALLEL_REGION_END
+
+      n_negative = Utilities::MPI::sum(n_negative, mpi_communicator_);
+      AssertThrow(n_negative == 0,
+                  ExcMessage("The implicit acoustic step produced a "
+                             "non-positive pressure. Reduce the CFL number."));
+
+      U.update_ghost_values();
+    }
+
+    CALLGRIND_STOP_INSTRUMENTATION
+
+    return tau;
+  }
+
 } /* namespace ryujin */
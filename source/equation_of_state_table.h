@@ -0,0 +1,328 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/vectorization.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ryujin
+{
+  /**
+   * A tabulated equation of state.
+   *
+   * The class stores the pressure \f$p\f$, the speed of sound \f$c\f$,
+   * and a (scaled) specific entropy \f$s\f$ on a uniform, tensor product
+   * grid in density \f$\rho\f$ and specific internal energy \f$e\f$ and
+   * evaluates these quantities with bicubic (Catmull-Rom) interpolation.
+   * The interpolant reproduces quadratic functions exactly.
+   *
+   * All evaluation functions are templated on the number type and work
+   * on scalar numbers as well as on VectorizedArray: The table cell and
+   * local coordinates are computed lane by lane and the 16 nodal values
+   * of the stencil are gathered, the interpolation itself is performed
+   * vectorized. Arguments outside of the tabulated range are clamped to
+   * the boundary of the table, i.e., there is no branching per lane.
+   *
+   * The nodes are stored with an additional layer of quadratically
+   * extrapolated ghost nodes so that the 4x4 stencil of every cell is
+   * always available.
+   *
+   * @ingroup EulerModule
+   */
+  class EquationOfStateTable
+  {
+  public:
+    /**
+     * Index of the tabulated quantities.
+     */
+    enum Quantity : unsigned int {
+      /**
+       * The pressure p(rho, e).
+       */
+      pressure = 0,
+      /**
+       * The speed of sound c(rho, e).
+       */
+      speed_of_sound = 1,
+      /**
+       * The (scaled) specific entropy s(rho, e).
+       */
+      specific_entropy = 2
+    };
+
+    /**
+     * The number of tabulated quantities.
+     */
+    static constexpr unsigned int n_quantities = 3;
+
+    /**
+     * Return whether a table has been set up.
+     */
+    bool empty() const
+    {
+      return values_.empty();
+    }
+
+    /**
+     * Set up the table by evaluating @p function (a callable returning a
+     * std::array<double, 3> with pressure, speed of sound, and specific
+     * entropy for given density and specific internal energy) on a
+     * uniform @p n_rho times @p n_e grid of the rectangle
+     * [rho_min, rho_max] x [e_min, e_max].
+     */
+    template <typename Function>
+    void interpolate(const unsigned int n_rho,
+                     const unsigned int n_e,
+                     const std::array<double, 2> &rho_range,
+                     const std::array<double, 2> &e_range,
+                     const Function &function)
+    {
+      initialize(n_rho, n_e, rho_range, e_range);
+
+      for (unsigned int i = 0; i < n_rho; ++i)
+        for (unsigned int j = 0; j < n_e; ++j) {
+          const double rho = rho_min_ + i * h_rho_;
+          const double e = e_min_ + j * h_e_;
+          const std::array<double, n_quantities> values = function(rho, e);
+          for (unsigned int q = 0; q < n_quantities; ++q)
+            node(q, i, j) = values[q];
+        }
+
+      extrapolate_ghost_nodes();
+    }
+
+    /**
+     * Read in a table from file @p file_name. The file is a plain text
+     * file (lines starting with '#' are ignored) containing
+     * ```
+     * n_rho n_e
+     * rho_min rho_max e_min e_max
+     * p c s      (for rho_0, e_0)
+     * p c s      (for rho_0, e_1)
+     * ...
+     * ```
+     * i.e., the specific internal energy is the fastest running index.
+     */
+    void read(const std::string &file_name)
+    {
+      std::ifstream file(file_name);
+      AssertThrow(file.is_open(),
+                  dealii::ExcMessage("Could not open equation of state "
+                                     "table \"" +
+                                     file_name + "\""));
+
+      const auto skip_comments = [&]() {
+        while (file >> std::ws && file.peek() == '#')
+          file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+      };
+
+      unsigned int n_rho = 0, n_e = 0;
+      std::array<double, 2> rho_range, e_range;
+      skip_comments();
+      file >> n_rho >> n_e;
+      skip_comments();
+      file >> rho_range[0] >> rho_range[1] >> e_range[0] >> e_range[1];
+      AssertThrow(file.good(),
+                  dealii::ExcMessage("Malformed header in equation of state "
+                                     "table \"" +
+                                     file_name + "\""));
+
+      initialize(n_rho, n_e, rho_range, e_range);
+
+      for (unsigned int i = 0; i < n_rho; ++i)
+        for (unsigned int j = 0; j < n_e; ++j) {
+          skip_comments();
+          for (unsigned int q = 0; q < n_quantities; ++q)
+            file >> node(q, i, j);
+        }
+
+      AssertThrow(!file.fail(),
+                  dealii::ExcMessage("Equation of state table \"" +
+                                     file_name + "\" is incomplete"));
+
+      extrapolate_ghost_nodes();
+    }
+
+    /**
+     * Evaluate the tabulated quantity @p quantity for given density @p
+     * rho and specific internal energy @p e.
+     */
+    template <typename Number>
+    Number
+    evaluate(const Quantity quantity, const Number &rho, const Number &e) const
+    {
+      Assert(!empty(), dealii::ExcMessage("Table is not initialized"));
+
+      constexpr unsigned int n_lanes = lanes<Number>::value;
+      using ScalarNumber = typename lanes<Number>::scalar;
+
+      /* Determine cell and local coordinates lane by lane: */
+
+      std::array<unsigned int, n_lanes> offsets;
+      Number t_rho, t_e;
+
+      for (unsigned int k = 0; k < n_lanes; ++k) {
+        const auto [i, t_i] = locate(lane(rho, k), rho_min_, h_rho_, n_rho_);
+        const auto [j, t_j] = locate(lane(e, k), e_min_, h_e_, n_e_);
+        /* Offset of the lower left ghost node of the 4x4 stencil: */
+        offsets[k] = (quantity * (n_rho_ + 2) + i) * (n_e_ + 2) + j;
+        lane(t_rho, k) = ScalarNumber(t_i);
+        lane(t_e, k) = ScalarNumber(t_j);
+      }
+
+      /* Vectorized Catmull-Rom weights and tensor product sum: */
+
+      const auto w_rho = weights(t_rho);
+      const auto w_e = weights(t_e);
+
+      Number result = Number(0.);
+      for (unsigned int a = 0; a < 4; ++a) {
+        Number row = Number(0.);
+        for (unsigned int b = 0; b < 4; ++b) {
+          Number value;
+          for (unsigned int k = 0; k < n_lanes; ++k)
+            lane(value, k) =
+                ScalarNumber(values_[offsets[k] + a * (n_e_ + 2) + b]);
+          row += w_e[b] * value;
+        }
+        result += w_rho[a] * row;
+      }
+
+      return result;
+    }
+
+  private:
+    /*
+     * Number of lanes and scalar type of a (vectorized) number type.
+     */
+    template <typename Number>
+    struct lanes {
+      static constexpr unsigned int value = 1;
+      using scalar = Number;
+    };
+
+    template <typename T, std::size_t width>
+    struct lanes<dealii::VectorizedArray<T, width>> {
+      static constexpr unsigned int value = width;
+      using scalar = T;
+    };
+
+    template <typename Number>
+    static auto &lane(Number &number, const unsigned int k)
+    {
+      if constexpr (lanes<std::remove_const_t<Number>>::value == 1) {
+        (void)k;
+        return number;
+      } else {
+        return number[k];
+      }
+    }
+
+    /*
+     * Return the index of the table cell containing @p x (clamped to the
+     * tabulated range) and the local coordinate in [0, 1].
+     */
+    static std::pair<unsigned int, double> locate(const double x,
+                                                  const double x_min,
+                                                  const double h,
+                                                  const unsigned int n)
+    {
+      const double s = std::clamp((x - x_min) / h, 0., double(n - 1));
+      const unsigned int i = std::min(static_cast<unsigned int>(s), n - 2);
+      return {i, s - i};
+    }
+
+    template <typename Number>
+    static std::array<Number, 4> weights(const Number &t)
+    {
+      using ScalarNumber = typename lanes<Number>::scalar;
+      const Number t2 = t * t;
+      const Number t3 = t2 * t;
+      const ScalarNumber half(0.5);
+      return {{half * (ScalarNumber(2.) * t2 - t3 - t),
+               half * (ScalarNumber(3.) * t3 - ScalarNumber(5.) * t2 +
+                       ScalarNumber(2.)),
+               half * (ScalarNumber(4.) * t2 - ScalarNumber(3.) * t3 + t),
+               half * (t3 - t2)}};
+    }
+
+    void initialize(const unsigned int n_rho,
+                    const unsigned int n_e,
+                    const std::array<double, 2> &rho_range,
+                    const std::array<double, 2> &e_range)
+    {
+      AssertThrow(n_rho >= 3 && n_e >= 3,
+                  dealii::ExcMessage("The equation of state table must have "
+                                     "at least three nodes in each "
+                                     "direction"));
+      AssertThrow(rho_range[1] > rho_range[0] && e_range[1] > e_range[0],
+                  dealii::ExcMessage("Invalid equation of state table range"));
+
+      n_rho_ = n_rho;
+      n_e_ = n_e;
+      rho_min_ = rho_range[0];
+      e_min_ = e_range[0];
+      h_rho_ = (rho_range[1] - rho_range[0]) / (n_rho - 1);
+      h_e_ = (e_range[1] - e_range[0]) / (n_e - 1);
+
+      values_.assign(n_quantities * (n_rho + 2) * (n_e + 2), 0.);
+    }
+
+    /*
+     * Access to node (i, j), with i in [-1, n_rho] and j in [-1, n_e].
+     */
+    double &node(const unsigned int q, const int i, const int j)
+    {
+      return values_[(q * (n_rho_ + 2) + (i + 1)) * (n_e_ + 2) + (j + 1)];
+    }
+
+    void extrapolate_ghost_nodes()
+    {
+      /* Quadratic extrapolation preserves the quadratic reproduction: */
+      const auto extrapolate = [](double f_0, double f_1, double f_2) {
+        return 3. * f_0 - 3. * f_1 + f_2;
+      };
+
+      const int n_rho = n_rho_;
+      const int n_e = n_e_;
+      for (unsigned int q = 0; q < n_quantities; ++q) {
+        for (int i = 0; i < n_rho; ++i) {
+          node(q, i, -1) = extrapolate(
+              node(q, i, 0), node(q, i, 1), node(q, i, 2));
+          node(q, i, n_e) = extrapolate(
+              node(q, i, n_e - 1), node(q, i, n_e - 2), node(q, i, n_e - 3));
+        }
+        for (int j = -1; j <= n_e; ++j) {
+          node(q, -1, j) = extrapolate(
+              node(q, 0, j), node(q, 1, j), node(q, 2, j));
+          node(q, n_rho, j) = extrapolate(node(q, n_rho - 1, j),
+                                          node(q, n_rho - 2, j),
+                                          node(q, n_rho - 3, j));
+        }
+      }
+    }
+
+    unsigned int n_rho_ = 0;
+    unsigned int n_e_ = 0;
+    double rho_min_ = 0.;
+    double e_min_ = 0.;
+    double h_rho_ = 1.;
+    double h_e_ = 1.;
+
+    std::vector<double> values_;
+  };
+
+} /* namespace ryujin */
@@ -7,14 +7,19 @@
 
 #include <compile_time_options.h>
 
+#include "communication_progress.h"
 #include "convenience_macros.h"
+#include "kernel_statistics.h"
+#include "openmp.h"
 #include "simd.h"
 
 #include "limiter.h"
 
+#include "derived_quantities.h"
 #include "initial_values.h"
 #include "offline_data.h"
 #include "problem_description.h"
+#include "scratch_vector_pool.h"
 #include "sparse_matrix_simd.h"
 
 #include <deal.II/base/parameter_acceptor.h>
@@ -22,6 +27,9 @@
 #include <deal.II/lac/sparse_matrix.templates.h>
 #include <deal.II/lac/vector.h>
 
+#include <array>
+#include <map>
+
 namespace ryujin
 {
   /**
@@ -33,6 +41,14 @@ namespace ryujin
    *
    * @todo Write out some more documentation
    *
+   * @todo Add a device (CUDA/HIP) backend for single_step(). Steps 1 - 5
+   * are row-local stencil kernels over SparsityPatternSIMD and map to one
+   * thread (block) per row. U and the d_ij, p_ij and l_ij matrices can be
+   * kept on the device with DeviceStorage. Missing are device-callable
+   * RiemannSolver, Indicator and Limiter kernels, and a packed ghost
+   * exchange of the export range [0, n_export_indices) through host (or
+   * GPU-aware MPI) buffers.
+   *
    * @ingroup EulerModule
    */
   template <int dim, typename Number = double>
@@ -67,6 +83,11 @@ namespace ryujin
      */
     using vector_type = typename OfflineData<dim, Number>::vector_type;
 
+    /**
+     * @copydoc DerivedQuantities::Integrals
+     */
+    using integrals_type = typename DerivedQuantities<dim, Number>::Integrals;
+
     /**
      * Constructor.
      */
@@ -75,15 +96,29 @@ namespace ryujin
                 const ryujin::OfflineData<dim, Number> &offline_data,
                 const ryujin::ProblemDescription &problem_description,
                 const ryujin::InitialValues<dim, Number> &initial_values,
+                ScratchVectorPool &scratch_vector_pool,
                 const std::string &subsection = "EulerModule");
 
     /**
      * Prepare time stepping. A call to @ref prepare() allocates temporary
      * storage and is necessary before any of the following time-stepping
      * functions can be called.
+     *
+     * The stage temporaries (the updated state and the low-order update
+     * of single_step(), and the registers of the Runge Kutta schemes) are
+     * not allocated but checked out from the ScratchVectorPool for the
+     * duration of a time step.
      */
     void prepare();
 
+    /**
+     * Return the memory consumption (in bytes, of this MPI rank) of all
+     * temporary vectors and matrices allocated by @ref prepare() as a list
+     * of (name, size) pairs.
+     */
+    std::vector<std::pair<std::string, std::size_t>>
+    memory_consumption() const;
+
     /**
      * @name Functons for performing explicit time steps
      */
@@ -126,6 +161,20 @@ namespace ryujin
      */
     Number ssprk3_step(vector_type &U, Number t, Number tau = 0.);
 
+    /**
+     * Given a reference to a previous state vector U perform an explicit
+     * ten stage, fourth order SSP Runge Kutta step in low-storage (2N)
+     * form (and store the result in U). The function returns the full
+     * time step size, which is six times the computed maximal time step
+     * size tau_max of an individual stage.
+     *
+     * The time step is performed with either 6 tau_max (if tau == 0), or
+     * tau (if tau != 0).
+     *
+     * See @cite Ketcheson2008, Algorithm 3.
+     */
+    Number ssprk104_step(vector_type &U, Number t, Number tau = 0.);
+
     /**
      * Given a reference to a previous state vector U perform an explicit
      * time step (and store the result in U). The function returns the
@@ -154,6 +203,72 @@ namespace ryujin
      */
     void compute_residual_mu();
 
+    /**
+     * Group all locally owned degrees of freedom into CFL classes with
+     * respect to the local time step size restriction
+     * \f$\tau_i = c_{\text{cfl}}\,m_i / (-2\,d_{ii}^{L,n})\f$ of the
+     * last computed time step: A degree of freedom belongs to class
+     * \f$k\f$ if \f$2^k\tau_{\min} \le \tau_i < 2^{k+1}\tau_{\min}\f$.
+     * All larger time step sizes are collected in the class
+     * @p n_classes - 1. The function returns the number of degrees of
+     * freedom per class summed over all MPI ranks.
+     *
+     * This is used to estimate the potential gain of a multirate
+     * (subcycling) time stepping strategy.
+     */
+    std::vector<unsigned long> cfl_classes(const unsigned int n_classes) const;
+
+    /**
+     * Request that the next call to single_step() accumulates the mass
+     * weighted integrals and minima of its initial state (see
+     * DerivedQuantities::Integrals) as a by-product of the low-order
+     * update in Step 3. The local contributions are reduced with a
+     * single non-blocking MPI_Iallreduce that overlaps with the remainder
+     * of the time step. Calling request_integrals() before step()
+     * thus records the integrals of the state at the beginning of the
+     * time step.
+     */
+    void request_integrals()
+    {
+      integrals_requested_ = true;
+    }
+
+    /**
+     * Return the integrals recorded during the last requested time step.
+     * The function waits for the completion of the reduction, i.e., it
+     * has to be called collectively.
+     */
+    const integrals_type &integrals();
+
+    /**
+     * Request that the next call to single_step() accumulates the
+     * steady-state residual
+     * \f$\big(\sum_i m_i^{-1}\,(R_i)_\rho^2\big)^{1/2}\f$, i.e., the
+     * discrete \f$L^2\f$ norm of the density rate of change, with the
+     * high-order residual R_i of Step 3. The local contributions are
+     * reduced with a non-blocking MPI_Iallreduce.
+     */
+    void request_residual()
+    {
+      residual_requested_ = true;
+    }
+
+    /**
+     * Return the residual recorded during the last requested time step.
+     * The function waits for the completion of the reduction, i.e., it
+     * has to be called collectively.
+     */
+    Number residual();
+
+    /**
+     * Return the modeled memory traffic (in bytes per locally owned row)
+     * of computing d_ij, d_ii and tau_max with the single fused sweep of
+     * USE_FUSED_D_IJ_COMPUTATION (first entry) and with the two separate
+     * sweeps of Step 1 and Step 2 (second entry). The estimates are the
+     * ones used by record_kernel_statistics().
+     */
+    std::array<double, 2> d_ij_traffic_per_row() const;
+
   private:
     //@}
     /**
@@ -161,10 +276,66 @@ namespace ryujin
      */
     //@{
 
+    /**
+     * Perform a single explicit Euler step. The function dispatches to
+     * the variant of below function instantiated for the limiter
+     * selected at run time.
+     */
+    Number single_step(vector_type &U, Number tau);
+
+    /**
+     * Perform a single explicit Euler step with the final limiting stage
+     * @p limiter.
+     */
+    template <Limiters limiter>
     Number single_step(vector_type &U, Number tau);
 
+    /**
+     * Enforce boundary conditions on the state @p U at time @p t. The
+     * function processes the boundary lists compiled in prepare() layer
+     * by layer in thread parallel (and for slip, no slip and Dirichlet
+     * boundaries SIMD vectorized) passes.
+     */
     void apply_boundary_conditions(vector_type &U, Number t);
 
+    /**
+     * Update the CFL constant used for the next time step. The argument
+     * is the ratio between the maximal admissible time step size (with
+     * respect to cfl max) over all stages of the last step and the time
+     * step size actually taken. A value less than one indicates a
+     * restart.
+     */
+    void adapt_cfl(const Number cfl_margin);
+
+    /**
+     * Record modeled memory traffic and flops of all steps of a call to
+     * single_step() in kernel_statistics(). If @p complete is false only
+     * steps 0 - 2 are recorded (the time step was rejected).
+     */
+    void record_kernel_statistics(const bool complete);
+
+    /**
+     * Modeled memory traffic of Step 1 (bytes per row and per entry) and
+     * Step 2 (bytes per row and per entry) of single_step().
+     */
+    static std::array<double, 4> d_ij_traffic_estimates();
+
+    /**
+     * If the bounds are stored in single precision, relax the density
+     * and specific entropy bounds by a few units in the last place of
+     * single precision, so that rounding does not tighten them. Does
+     * nothing otherwise.
+     */
+    template <typename Bounds>
+    static void widen_bounds(Bounds &bounds);
+
+    /**
+     * Return the (lazily created) MPI reduction operation used for the
+     * integrals: All entries are summed except for the last two that hold
+     * minima.
+     */
+    static MPI_Op integrals_reduction_operation();
+
     //@}
     /**
      * @name Run time options
@@ -173,9 +344,21 @@ namespace ryujin
 
     Number cfl_update_;
     Number cfl_max_;
+    bool cfl_adaptive_;
+    ACCESSOR_READ_ONLY(cfl_adaptive)
 
     unsigned int time_step_order_;
+    std::string limiter_;
     unsigned int limiter_iter_;
+    Number limiter_termination_tolerance_;
+    bool recompute_pij_;
+    Number lambda_max_reuse_tolerance_;
+    ACCESSOR_READ_ONLY(lambda_max_reuse_tolerance)
+
+    bool local_time_stepping_;
+    ACCESSOR_READ_ONLY(local_time_stepping)
+
+    unsigned int tile_size_;
 
     bool enforce_noslip_;
 
@@ -194,33 +377,117 @@ namespace ryujin
     dealii::SmartPointer<const ryujin::ProblemDescription> problem_description_;
     dealii::SmartPointer<const ryujin::InitialValues<dim, Number>>
         initial_values_;
+    dealii::SmartPointer<ScratchVectorPool> scratch_vector_pool_;
 
     unsigned int n_restarts_;
     ACCESSOR_READ_ONLY(n_restarts)
 
+    CommunicationProgress communication_progress_;
+    ACCESSOR_READ_ONLY(communication_progress)
+
+    std::size_t n_locally_owned_entries_;
+    unsigned int tile_size_effective_;
+
+    /*
+     * The locally owned entries of the boundary map with a single
+     * boundary id stored as structure of arrays. A degree of freedom
+     * with several entries in the boundary map appears in consecutive
+     * layers, so that all indices of a layer are distinct:
+     */
+    struct BoundaryList {
+      std::vector<unsigned int> indices;
+      std::array<std::vector<Number>, dim> normals;
+      std::array<std::vector<Number>, dim> positions;
+    };
+
+    using boundary_layer_type =
+        std::map<dealii::types::boundary_id, BoundaryList>;
+    std::vector<boundary_layer_type> boundary_layers_;
+    KernelStatisticsMap kernel_statistics_;
+    ACCESSOR_READ_ONLY(kernel_statistics)
+
+    std::map<std::string, IdleTime> idle_time_;
+    ACCESSOR_READ_ONLY(idle_time)
+
+    Number cfl_;
+    ACCESSOR_READ_ONLY(cfl)
+
+    Number cfl_margin_previous_;
+
+    Limiters limiter_variant_;
+    ACCESSOR_READ_ONLY(limiter_variant)
+
+    unsigned int n_limiter_passes_;
+
+    unsigned long n_skipped_limiter_passes_;
+    ACCESSOR_READ_ONLY(n_skipped_limiter_passes)
+
+    unsigned long n_riemann_solves_;
+    ACCESSOR_READ_ONLY(n_riemann_solves)
+
+    unsigned long n_riemann_iterations_;
+    ACCESSOR_READ_ONLY(n_riemann_iterations)
+
+    bool integrals_requested_;
+    MPI_Request integrals_request_;
+    std::array<double, problem_dimension + 4> integrals_buffer_;
+    integrals_type integrals_;
+
+    bool residual_requested_;
+    MPI_Request residual_request_;
+    double residual_buffer_;
+    Number residual_;
+
     scalar_type residual_mu_;
     ACCESSOR_READ_ONLY(residual_mu)
 
     scalar_type alpha_;
+    ACCESSOR_READ_ONLY(alpha)
 
     scalar_type second_variations_;
     scalar_type specific_entropies_;
-    scalar_type evc_entropies_;
 
-    MultiComponentVector<Number, Limiter<dim, Number>::n_bounds> bounds_;
-
-    vector_type r_;
+    vector_type lambda_max_reference_;
+    scalar_type lambda_max_frozen_;
+    scalar_type evc_entropies_;
 
+#ifdef USE_PRECOMPUTED_EVC_FLUXES
+    /*
+     * The velocity and the pressure of all locally relevant states used by
+     * the entropy-viscosity commutator, see Indicator::precompute():
+     */
+    MultiComponentVector<Number, dim + 1> evc_precomputed_;
+#endif
+
+    /*
+     * The bounds are only ever accessed for locally owned SIMD batches,
+     * store them component wise to avoid a transpose on load and store.
+     * If the USE_MIXED_PRECISION_BOUNDS compile-time option is set the
+     * bounds are stored in single precision, see widen_bounds():
+     */
+#ifdef USE_MIXED_PRECISION_BOUNDS
+    using bounds_number = float;
+#else
+    using bounds_number = Number;
+#endif
+
+    MultiComponentVector<bounds_number,
+                         Limiter<dim, Number>::n_bounds,
+                         dealii::VectorizedArray<Number>::size(),
+                         MultiComponentLayout::structure_of_arrays>
+        bounds_;
+
+#ifdef USE_SYMMETRIC_STORAGE
+    SymmetricSparseMatrixSIMD<Number> dij_matrix_;
+#else
     SparseMatrixSIMD<Number> dij_matrix_;
+#endif
 
     SparseMatrixSIMD<Number> lij_matrix_;
     SparseMatrixSIMD<Number> lij_matrix_next_;
 
     SparseMatrixSIMD<Number, problem_dimension> pij_matrix_;
 
-    vector_type temp_euler_;
-    vector_type temp_ssp_;
-
     //@}
   };
 
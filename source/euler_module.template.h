@@ -10,10 +10,20 @@
 #include "introspection.h"
 #include "openmp.h"
 #include "riemann_solver.h"
+#include "riemann_solver_batch.h"
 #include "scope.h"
 #include "simd.h"
 
 #include <atomic>
+#include <iostream>
+
+#if defined(USE_ON_THE_FLY_CIJ) && defined(USE_FUSED_D_IJ_COMPUTATION)
+#error "USE_ON_THE_FLY_CIJ and USE_FUSED_D_IJ_COMPUTATION are incompatible"
+#endif
+
+#if defined(USE_PIPELINED_COMMUNICATION) && !defined(USE_COMMUNICATION_HIDING)
+#error "USE_PIPELINED_COMMUNICATION requires USE_COMMUNICATION_HIDING"
+#endif
 
 namespace ryujin
 {
@@ -27,6 +37,7 @@ namespace ryujin
       const ryujin::OfflineData<dim, Number> &offline_data,
       const ryujin::ProblemDescription &problem_description,
       const ryujin::InitialValues<dim, Number> &initial_values,
+      ScratchVectorPool &scratch_vector_pool,
       const std::string &subsection /*= "EulerModule"*/)
       : ParameterAcceptor(subsection)
       , mpi_communicator_(mpi_communicator)
@@ -34,7 +45,23 @@ namespace ryujin
       , offline_data_(&offline_data)
       , problem_description_(&problem_description)
       , initial_values_(&initial_values)
+      , scratch_vector_pool_(&scratch_vector_pool)
       , n_restarts_(0)
+      , communication_progress_(mpi_communicator)
+      , n_locally_owned_entries_(0)
+      , cfl_(0.)
+      , cfl_margin_previous_(0.)
+      , limiter_variant_(Limiter<dim, Number>::limiter_)
+      , n_limiter_passes_(0)
+      , n_skipped_limiter_passes_(0)
+      , n_riemann_solves_(0)
+      , n_riemann_iterations_(0)
+      , integrals_requested_(false)
+      , integrals_request_(MPI_REQUEST_NULL)
+      , residual_requested_(false)
+      , residual_request_(MPI_REQUEST_NULL)
+      , residual_buffer_(0.)
+      , residual_(0.)
   {
     cfl_update_ = Number(0.80);
     add_parameter(
@@ -44,17 +71,93 @@ namespace ryujin
     add_parameter(
         "cfl max", cfl_max_, "Maximal admissible relative CFL constant");
 
+    cfl_adaptive_ = false;
+    add_parameter("cfl adaptive",
+                  cfl_adaptive_,
+                  "Adapt the CFL constant used for the update with a PI "
+                  "controller. The controller aims at keeping the margin "
+                  "between the chosen time step and the maximal admissible "
+                  "time step of all Runge Kutta stages at the ratio "
+                  "cfl max / cfl update");
+
     time_step_order_ = 3;
     add_parameter(
         "time step order",
         time_step_order_,
         "Approximation order of time stepping method. Switches between Forward "
-        "Euler, SSP Heun, and SSP Runge Kutta 3rd order");
+        "Euler, SSP Heun, SSP Runge Kutta 3rd order, and low-storage SSP "
+        "Runge Kutta (10,4)");
+
+    switch (Limiter<dim, Number>::limiter_) {
+    case Limiters::none:
+      limiter_ = "none";
+      break;
+    case Limiters::rho:
+      limiter_ = "rho";
+      break;
+    default:
+      limiter_ = "specific entropy";
+    }
+    add_parameter("limiter",
+                  limiter_,
+                  "Final limiting stage. Valid options are \"none\", "
+                  "\"rho\", and \"specific entropy\"");
 
     limiter_iter_ = 2;
     add_parameter(
         "limiter iterations", limiter_iter_, "Number of limiter iterations");
 
+    limiter_termination_tolerance_ = Number(0.);
+    add_parameter("limiter termination tolerance",
+                  limiter_termination_tolerance_,
+                  "Skip the remaining limiter iterations if all limiter "
+                  "coefficients l_ij of the current pass (globally) are "
+                  "within the given tolerance of 1, i.e., if the remaining "
+                  "passes could at most add a fraction of the tolerance of "
+                  "the antidiffusive fluxes. A value of 0 disables early "
+                  "termination");
+
+    recompute_pij_ = false;
+    add_parameter("recompute p_ij",
+                  recompute_pij_,
+                  "Do not store the antidiffusive fluxes P_ij, but recompute "
+                  "them in the high-order update from U, r_i, alpha_i, and "
+                  "d_ij. Saves the memory (and traffic) of a "
+                  "problem_dimension component matrix for one or two "
+                  "limiter iterations");
+
+    lambda_max_reuse_tolerance_ = Number(0.);
+    add_parameter("lambda max reuse tolerance",
+                  lambda_max_reuse_tolerance_,
+                  "Reuse the d_ij (and thus the maximal wave speeds of the "
+                  "Riemann problems) of the previous stage for all edges "
+                  "whose velocities and speeds of sound changed by at most "
+                  "the given tolerance relative to |u| + c. All recomputed "
+                  "d_ij are enlarged by a factor of (1 + tolerance) / (1 - "
+                  "tolerance) to stay an upper bound. A value of 0 disables "
+                  "the reuse");
+
+    local_time_stepping_ = false;
+    add_parameter("local time stepping",
+                  local_time_stepping_,
+                  "Advance every degree of freedom with its own maximal time "
+                  "step size tau_i = cfl m_i / (-2 d_ii) instead of the "
+                  "global minimum. The update is no longer time accurate "
+                  "(and conservative only at a steady state), i.e., this "
+                  "is a pseudo-time iteration towards a steady state");
+
+    tile_size_ = 0;
+    add_parameter("tile size",
+                  tile_size_,
+                  "If nonzero, compute the entropies of the vectorized index "
+                  "range in tiles of (at least) the given number of rows "
+                  "interleaved with the computation of d_ij and alpha_i, so "
+                  "that the states of a tile are still in cache. The tile "
+                  "size is enlarged to the index bandwidth of the sparsity "
+                  "pattern if necessary. Tiling is disabled (with a warning) "
+                  "if the bandwidth exceeds n_internal / n_threads. A value "
+                  "of 0 disables tiling");
+
     enforce_noslip_ = true;
     add_parameter(
         "enforce noslip",
@@ -71,6 +174,41 @@ namespace ryujin
     std::cout << "EulerModule<dim, Number>::prepare()" << std::endl;
 #endif
 
+    cfl_ = cfl_update_;
+    cfl_margin_previous_ = cfl_max_ / cfl_;
+
+    /* Complete a pending reduction of integrals before reinitializing: */
+    integrals();
+
+    if (limiter_ == "none")
+      limiter_variant_ = Limiters::none;
+    else if (limiter_ == "rho")
+      limiter_variant_ = Limiters::rho;
+    else if (limiter_ == "specific entropy")
+      limiter_variant_ = Limiters::specific_entropy;
+    else
+      AssertThrow(false, ExcMessage("Unknown limiter \"" + limiter_ + "\""));
+
+#if defined(USE_FUSED_D_IJ_COMPUTATION) || defined(USE_BATCHED_RIEMANN_SOLVER)
+    AssertThrow(lambda_max_reuse_tolerance_ == Number(0.),
+                ExcMessage("The reuse of lambda_max is not implemented for "
+                           "USE_FUSED_D_IJ_COMPUTATION and "
+                           "USE_BATCHED_RIEMANN_SOLVER"));
+#endif
+
+    AssertThrow(!recompute_pij_ || limiter_iter_ <= 2,
+                ExcMessage("The recomputation of p_ij is only implemented "
+                           "for at most two limiter iterations"));
+
+    AssertThrow(lambda_max_reuse_tolerance_ >= Number(0.) &&
+                    lambda_max_reuse_tolerance_ < Number(1.),
+                ExcMessage("The lambda max reuse tolerance has to be in "
+                           "the interval [0, 1)"));
+
+    AssertThrow(tile_size_ == 0 || lambda_max_reuse_tolerance_ == Number(0.),
+                ExcMessage("The reuse of lambda_max is not implemented for "
+                           "a nonzero tile size"));
+
     /* Initialize vectors: */
 
     const auto &scalar_partitioner = offline_data_->scalar_partitioner();
@@ -80,13 +218,23 @@ namespace ryujin
     second_variations_.reinit(scalar_partitioner);
     specific_entropies_.reinit(scalar_partitioner);
     evc_entropies_.reinit(scalar_partitioner);
+#ifdef USE_PRECOMPUTED_EVC_FLUXES
+    evc_precomputed_.reinit_with_scalar_partitioner(scalar_partitioner);
+#endif
 
     bounds_.reinit_with_scalar_partitioner(scalar_partitioner);
 
     const auto &vector_partitioner = offline_data_->vector_partitioner();
-    r_.reinit(vector_partitioner);
-    temp_euler_.reinit(vector_partitioner);
-    temp_ssp_.reinit(vector_partitioner);
+
+    /*
+     * Reference states for the reuse of lambda_max. A signaling value of
+     * NaN forces a recomputation of all d_ij in the first stage:
+     */
+    if (lambda_max_reuse_tolerance_ > Number(0.)) {
+      lambda_max_reference_.reinit(vector_partitioner);
+      lambda_max_reference_ = std::numeric_limits<Number>::quiet_NaN();
+      lambda_max_frozen_.reinit(scalar_partitioner);
+    }
 
     /* Initialize matrices: */
 
@@ -94,11 +242,168 @@ namespace ryujin
     dij_matrix_.reinit(sparsity_simd);
     lij_matrix_.reinit(sparsity_simd);
     lij_matrix_next_.reinit(sparsity_simd);
-    pij_matrix_.reinit(sparsity_simd);
+    if (!recompute_pij_)
+      pij_matrix_.reinit(sparsity_simd);
+
+    n_locally_owned_entries_ = 0;
+    for (unsigned int i = 0; i < offline_data_->n_locally_owned(); ++i)
+      n_locally_owned_entries_ += sparsity_simd.row_length(i);
+
+    /*
+     * The index bandwidth of the vectorized rows restricted to the
+     * vectorized index range, i.e., the largest distance |j - i| of a
+     * coupling with j < n_internal. Tiles of at least this size only
+     * depend on the entropies of themselves and their two neighbors. We
+     * thus enlarge the tile size to the bandwidth (and round up to a
+     * multiple of the SIMD length):
+     */
+    tile_size_effective_ = 0;
+    if (tile_size_ != 0) {
+      constexpr auto simd_length = VectorizedArray<Number>::size();
+      const unsigned int n_internal = offline_data_->n_locally_internal();
+
+      unsigned int tile_bandwidth = 0;
+      for (unsigned int i = 0; i < n_internal; i += simd_length) {
+        const unsigned int *js = sparsity_simd.columns(i);
+        const unsigned int row_length = sparsity_simd.row_length(i);
+        for (unsigned int n = 0; n < row_length * simd_length; ++n) {
+          const unsigned int j = js[n];
+          const unsigned int row = i + n % simd_length;
+          if (j < n_internal)
+            tile_bandwidth =
+                std::max(tile_bandwidth, j > row ? j - row : row - j);
+        }
+      }
+
+      /*
+       * If the bandwidth is so large that not every thread gets a tile
+       * of its own, tiling only introduces load imbalance and we fall
+       * back to the untiled loop:
+       */
+      const unsigned int n_threads = omp_get_max_threads();
+      if (std::size_t(tile_bandwidth) * n_threads > n_internal) {
+        std::cout << "EulerModule: Warning: the index bandwidth "
+                  << tile_bandwidth << " of the sparsity pattern is larger "
+                  << "than n_internal / n_threads = " << n_internal << " / "
+                  << n_threads << ", disabling tiling" << std::endl;
+      } else {
+        tile_size_effective_ =
+            (std::max(tile_size_, tile_bandwidth) + simd_length - 1) /
+            simd_length * simd_length;
+      }
+    }
+
+    /*
+     * Compile the boundary map into boundary lists. The k-th entry of a
+     * degree of freedom is placed into layer k, so processing the layers
+     * in order preserves the order of the boundary map. The lists that
+     * are processed in SIMD batches are padded to a multiple of the SIMD
+     * length by repeating their last entry:
+     */
+
+    boundary_layers_.clear();
+    {
+      const unsigned int n_owned = offline_data_->n_locally_owned();
+      unsigned int previous = numbers::invalid_unsigned_int;
+      unsigned int layer = 0;
+
+      for (const auto &entry : offline_data_->boundary_map()) {
+        const unsigned int i = entry.first;
+        const auto &[normal, id, position] = entry.second;
+
+        if (i >= n_owned ||
+            (id != Boundary::slip && id != Boundary::no_slip &&
+             id != Boundary::dirichlet && id != Boundary::dynamic))
+          continue;
+
+        layer = (i == previous) ? layer + 1 : 0;
+        previous = i;
+        if (layer >= boundary_layers_.size())
+          boundary_layers_.resize(layer + 1);
+
+        auto &list = boundary_layers_[layer][id];
+        list.indices.push_back(i);
+        for (unsigned int d = 0; d < dim; ++d) {
+          list.normals[d].push_back(normal[d]);
+          list.positions[d].push_back(position[d]);
+        }
+      }
+
+      constexpr auto simd_length = VectorizedArray<Number>::size();
+      for (auto &boundary_layer : boundary_layers_)
+        for (auto &[id, list] : boundary_layer) {
+          if (id == Boundary::dynamic)
+            continue;
+          while (list.indices.size() % simd_length != 0) {
+            list.indices.push_back(list.indices.back());
+            for (unsigned int d = 0; d < dim; ++d) {
+              list.normals[d].push_back(list.normals[d].back());
+              list.positions[d].push_back(list.positions[d].back());
+            }
+          }
+        }
+    }
+  }
+
+
+  template <int dim, typename Number>
+  std::vector<std::pair<std::string, std::size_t>>
+  EulerModule<dim, Number>::memory_consumption() const
+  {
+    std::vector<std::pair<std::string, std::size_t>> result;
+
+    result.emplace_back("residual mu", residual_mu_.memory_consumption());
+    result.emplace_back("alpha", alpha_.memory_consumption());
+    result.emplace_back("second variations",
+                        second_variations_.memory_consumption());
+    result.emplace_back("specific entropies",
+                        specific_entropies_.memory_consumption());
+    result.emplace_back("evc entropies", evc_entropies_.memory_consumption());
+#ifdef USE_PRECOMPUTED_EVC_FLUXES
+    result.emplace_back("evc velocity and pressure",
+                        evc_precomputed_.memory_consumption());
+#endif
+    result.emplace_back("bounds", bounds_.memory_consumption());
+    result.emplace_back("lambda max reference",
+                        lambda_max_reference_.memory_consumption() +
+                            lambda_max_frozen_.memory_consumption());
+    result.emplace_back("dij matrix", dij_matrix_.memory_consumption());
+    result.emplace_back("lij matrices",
+                        lij_matrix_.memory_consumption() +
+                            lij_matrix_next_.memory_consumption());
+    result.emplace_back("pij matrix", pij_matrix_.memory_consumption());
+
+    std::size_t boundary_lists = 0;
+    for (const auto &boundary_layer : boundary_layers_)
+      for (const auto &it : boundary_layer)
+        boundary_lists += it.second.indices.size() *
+                          (sizeof(unsigned int) + 2 * dim * sizeof(Number));
+    result.emplace_back("boundary lists", boundary_lists);
+
+    return result;
+  }
+
+
+  template <int dim, typename Number>
+  Number EulerModule<dim, Number>::single_step(vector_type &U, Number tau)
+  {
+    /*
+     * Dispatch once per step to the variant instantiated for the
+     * selected limiter. All inner kernels are statically dispatched:
+     */
+    switch (limiter_variant_) {
+    case Limiters::none:
+      return single_step<Limiters::none>(U, tau);
+    case Limiters::rho:
+      return single_step<Limiters::rho>(U, tau);
+    default:
+      return single_step<Limiters::specific_entropy>(U, tau);
+    }
   }
 
 
   template <int dim, typename Number>
+  template <Limiters limiter>
   Number EulerModule<dim, Number>::single_step(vector_type &U, Number tau)
   {
 #ifdef DEBUG_OUTPUT
@@ -117,6 +422,24 @@ namespace ryujin
     const unsigned int n_owned = offline_data_->n_locally_owned();
     const unsigned int n_relevant = offline_data_->n_locally_relevant();
 
+#ifdef USE_PIPELINED_COMMUNICATION
+    /*
+     * In steps 3 and later we traverse the SIMD row chunks starting with
+     * the interior chunks [n_export_simd, n_internal), which do not couple
+     * to ghost values, followed by the export chunks [0, n_export_simd).
+     * This allows us to defer the completion of the ghost exchange of the
+     * previous step until the first export chunk is processed.
+     */
+    const unsigned int n_export_simd =
+        std::min(n_internal,
+                 (n_export_indices + simd_length - 1) / simd_length *
+                     simd_length);
+    const auto pipelined_index = [&](const unsigned int ii) {
+      return ii + n_export_simd < n_internal ? ii + n_export_simd
+                                             : ii + n_export_simd - n_internal;
+    };
+#endif
+
     /* References to precomputed matrices and the stencil: */
 
     const auto &sparsity_simd = offline_data_->sparsity_pattern_simd();
@@ -132,9 +455,117 @@ namespace ryujin
     const Number measure_of_omega_inverse =
         Number(1.) / offline_data_->measure_of_omega();
 
+    /*
+     * Small helper lambdas returning the pair (|c_ij|, n_ij), or
+     * (|c_ji|, n_ji) for the transposed variants, either from the
+     * precomputed matrices or by normalizing c_ij on the fly:
+     */
+
+    const bool precompute_nij = offline_data_->precompute_nij();
+    const auto &nij_matrix = offline_data_->nij_matrix();
+    const auto &cij_norm_matrix = offline_data_->cij_norm_matrix();
+
+    const auto normalize = [](const auto &c) {
+      const auto norm = c.norm();
+      return std::make_pair(norm, std::decay_t<decltype(c)>(c / norm));
+    };
+
+    const auto nij_serial = [&](const unsigned int i,
+                                const unsigned int col_idx,
+                                const Tensor<1, dim, Number> &c_ij) {
+      if (precompute_nij)
+        return std::make_pair(cij_norm_matrix.get_entry(i, col_idx),
+                              nij_matrix.get_tensor(i, col_idx));
+      return normalize(c_ij);
+    };
+
+    const auto nji_serial = [&](const unsigned int i,
+                                const unsigned int col_idx) {
+      if (precompute_nij)
+        return std::make_pair(cij_norm_matrix.get_transposed_entry(i, col_idx),
+                              nij_matrix.get_transposed_tensor(i, col_idx));
+      return normalize(cij_matrix.get_transposed_tensor(i, col_idx));
+    };
+
+    const auto nij_simd = [&](const unsigned int i,
+                              const unsigned int col_idx,
+                              const Tensor<1, dim, VA> &c_ij) {
+      if (precompute_nij)
+        return std::make_pair(
+            cij_norm_matrix.get_vectorized_entry(i, col_idx),
+            nij_matrix.get_vectorized_tensor(i, col_idx));
+      return normalize(c_ij);
+    };
+
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+    const auto nji_simd = [&](const unsigned int i,
+                              const unsigned int col_idx) {
+      if (precompute_nij)
+        return std::make_pair(
+            cij_norm_matrix.get_vectorized_transposed_entry(i, col_idx),
+            nij_matrix.get_vectorized_transposed_tensor(i, col_idx));
+      return normalize(cij_matrix.get_vectorized_transposed_tensor(i, col_idx));
+    };
+#endif
+
+    /*
+     * The updated state and the low-order update r_i are only needed
+     * for the duration of the step: Check them out from the scratch
+     * vector pool.
+     */
+
+    const auto &vector_partitioner = offline_data_->vector_partitioner();
+    const auto temp_euler_pointer =
+        scratch_vector_pool_->checkout<vector_type>(vector_partitioner);
+    const auto r_pointer =
+        scratch_vector_pool_->checkout<vector_type>(vector_partitioner);
+    auto &temp_euler = *temp_euler_pointer;
+    auto &r = *r_pointer;
+
     /* A monotonically increasing "channel" variable for mpi_tags: */
     unsigned int channel = 10;
 
+    /* Accumulate the integrals of U in Step 3 if requested: */
+    const bool record_integrals = integrals_requested_;
+    integrals_requested_ = false;
+
+    /* Accumulate the steady-state residual in Step 3 if requested: */
+    const bool record_residual = residual_requested_;
+    residual_requested_ = false;
+
+    /*
+     * If tiling is enabled, Step 0 only computes the entropies of the
+     * non-vectorized index range [n_internal, n_relevant). The entropies
+     * of the vectorized index range are computed tile by tile within the
+     * SIMD loop of Step 1, see below. The tile size is at least the index
+     * bandwidth, see prepare():
+     */
+    const unsigned int tile_size = tile_size_effective_;
+
+    const auto evc_entropy = [&](const auto &U_i) {
+      return Indicator<dim, double>::evc_entropy_ ==
+                     Indicator<dim, double>::Entropy::mathematical
+                 ? problem_description_->mathematical_entropy(U_i)
+                 : problem_description_->harten_entropy(U_i);
+    };
+
+#ifdef USE_PRECOMPUTED_EVC_FLUXES
+    const Indicator<dim, VA> evc_precompute_simd(*problem_description_);
+    const Indicator<dim, Number> evc_precompute_serial(*problem_description_);
+#endif
+
+    const auto compute_entropies_simd = [&](const unsigned int i) {
+      const auto U_i = U.get_vectorized_tensor(i);
+      simd_store(specific_entropies_,
+                 problem_description_->specific_entropy(U_i),
+                 i);
+      simd_store(evc_entropies_, evc_entropy(U_i), i);
+#ifdef USE_PRECOMPUTED_EVC_FLUXES
+      evc_precomputed_.write_vectorized_tensor(
+          evc_precompute_simd.precompute(U_i), i);
+#endif
+    };
+
     /*
      * Step 0: Precompute f(U) and the entropies of U
      */
@@ -142,24 +573,17 @@ namespace ryujin
       Scope scope(computing_timer_, "time step [E] 0 - compute entropies");
 
       RYUJIN_PARALLEL_REGION_BEGIN
+      CommunicationProgress::ComputeSection compute_section(
+          communication_progress_);
       LIKWID_MARKER_START("time_step_0");
 
       const unsigned int size_regular = n_relevant / simd_length * simd_length;
 
       RYUJIN_OMP_FOR
-      for (unsigned int i = 0; i < size_regular; i += simd_length) {
-        const auto U_i = U.get_vectorized_tensor(i);
-        simd_store(specific_entropies_,
-                   problem_description_->specific_entropy(U_i),
-                   i);
-
-        const auto evc_entropy =
-            Indicator<dim, double>::evc_entropy_ ==
-                    Indicator<dim, double>::Entropy::mathematical
-                ? problem_description_->mathematical_entropy(U_i)
-                : problem_description_->harten_entropy(U_i);
-        simd_store(evc_entropies_, evc_entropy, i);
-      }
+      for (unsigned int i = (tile_size == 0 ? 0 : n_internal);
+           i < size_regular;
+           i += simd_length)
+        compute_entropies_simd(i);
 
       for (unsigned int i = size_regular; i < n_relevant; ++i) {
         const auto U_i = U.get_tensor(i);
@@ -167,11 +591,46 @@ namespace ryujin
         specific_entropies_.local_element(i) =
             problem_description_->specific_entropy(U_i);
 
-        evc_entropies_.local_element(i) =
-            Indicator<dim, double>::evc_entropy_ ==
-                    Indicator<dim, double>::Entropy::mathematical
-                ? problem_description_->mathematical_entropy(U_i)
-                : problem_description_->harten_entropy(U_i);
+        evc_entropies_.local_element(i) = evc_entropy(U_i);
+#ifdef USE_PRECOMPUTED_EVC_FLUXES
+        evc_precomputed_.write_tensor(evc_precompute_serial.precompute(U_i),
+                                      i);
+#endif
+      }
+
+      /*
+       * Classify all (locally relevant) states for the reuse of
+       * lambda_max: A state is "frozen" if its velocity u and speed of
+       * sound c satisfy
+       *
+       *   |u - u_ref| + |c - c_ref| <= tolerance * (|u_ref| + c_ref)
+       *
+       * with respect to the reference state. Otherwise the reference
+       * state is reset.
+       */
+      if (lambda_max_reuse_tolerance_ > Number(0.)) {
+        RYUJIN_OMP_FOR
+        for (unsigned int i = 0; i < n_relevant; ++i) {
+          const auto U_i = U.get_tensor(i);
+          const auto U_ref = lambda_max_reference_.get_tensor(i);
+
+          const auto u_i = problem_description_->momentum(U_i) /
+                           problem_description_->density(U_i);
+          const auto c_i = problem_description_->speed_of_sound(U_i);
+          const auto u_ref = problem_description_->momentum(U_ref) /
+                             problem_description_->density(U_ref);
+          const auto c_ref = problem_description_->speed_of_sound(U_ref);
+
+          const Number delta = (u_i - u_ref).norm() + std::abs(c_i - c_ref);
+
+          /* Note: a NaN reference state always fails this comparison: */
+          if (delta <= lambda_max_reuse_tolerance_ * (u_ref.norm() + c_ref)) {
+            lambda_max_frozen_.local_element(i) = Number(1.);
+          } else {
+            lambda_max_frozen_.local_element(i) = Number(0.);
+            lambda_max_reference_.write_tensor(U_i, i);
+          }
+        }
       }
 
       LIKWID_MARKER_STOP("time_step_0");
@@ -200,27 +659,246 @@ namespace ryujin
      *  computing entries for which *IN A GLOBAL* enumeration j > i. But
      *  the index translation, subsequent symmetrization, and exchange
      *  sounds a bit too expensive...
+     *
+     *  If the USE_FUSED_D_IJ_COMPUTATION compile-time option is set we
+     *  instead compute the full row of d_ij and fuse Step 2 into this
+     *  sweep: For j < i we evaluate the Riemann solver with exactly the
+     *  same arguments (U_j, U_i, n_ji) that row j uses, so that d_ij is
+     *  still symmetric. This trades the second sweep over the stencil
+     *  (reading column indices, a gather of the transposed d_ji, reading
+     *  and writing d_ij once more, i.e., about (2 * sizeof(Number) +
+     *  sizeof(unsigned int)) bytes per nonzero plus the transposed
+     *  gather) against twice the number of Riemann solves.
+     */
+
+    ThreadReduction<Number> tau_max_reduction(
+        std::numeric_limits<Number>::infinity());
+    Number tau_max = std::numeric_limits<Number>::infinity();
+
+    /*
+     * The global minimum of tau_max is reduced with a non-blocking
+     * collective. If tau is prescribed (all but the first stage of the
+     * Runge-Kutta schemes) the low-order update of Step 3 does not depend
+     * on tau_max: In this case we perform Step 3 speculatively while the
+     * reduction is in flight and only check the CFL condition afterwards.
+     * The state U is not modified before Step 4, so a rejected update
+     * only wastes the work of Step 3. If integrals or residuals are
+     * recorded in Step 3 we wait right away instead, so that no
+     * quantities of a rejected update are reduced.
+     */
+    double tau_max_buffer = 0.;
+    MPI_Request tau_max_request = MPI_REQUEST_NULL;
+    const bool speculative_step =
+        tau != Number(0.) && !record_integrals && !record_residual;
+
+    /*
+     * Complete the reduction of tau_max and check the CFL condition.
+     * Returns false if the update has to be rejected:
+     */
+    const auto complete_tau_max_reduction = [&]() {
+      MPI_Wait(&tau_max_request, MPI_STATUS_IGNORE);
+      tau_max = Number(tau_max_buffer);
+
+      AssertThrow(!std::isnan(tau_max) && !std::isinf(tau_max) && tau_max > 0.,
+                  ExcMessage("I'm sorry, Dave. I'm afraid I can't "
+                             "do that. - We crashed."));
+
+#ifdef DEBUG_OUTPUT
+      std::cout << "        computed tau_max = " << tau_max << std::endl;
+#endif
+      tau = (tau == Number(0.) ? tau_max : tau);
+#ifdef DEBUG_OUTPUT
+      std::cout << "        perform time-step with tau = " << tau << std::endl;
+#endif
+
+      if (tau * cfl_ > tau_max * cfl_max_) {
+#ifdef DEBUG_OUTPUT
+        std::cout
+            << "        insufficient CFL, refuse update and abort stepping"
+            << std::endl;
+#endif
+        U[0] *= std::numeric_limits<Number>::quiet_NaN();
+        record_kernel_statistics(/*complete*/ false);
+        /* Keep the requests for the integrals for the restarted step: */
+        integrals_requested_ = record_integrals;
+        residual_requested_ = record_residual;
+        return false;
+      }
+
+      return true;
+    };
+
+    std::atomic<unsigned long> n_riemann_solves{0};
+    std::atomic<unsigned long> n_riemann_iterations{0};
+
+    /*
+     * If lambda_max is reused, the velocity and speed of sound of both
+     * states of an edge are within the tolerance of their reference
+     * values, at the time the d_ij was computed as well as now. Thus, the
+     * wave speed scale |u| + c changed at most by a factor of
+     * (1 + tolerance) / (1 - tolerance), and we enlarge every computed
+     * d_ij by this factor:
      */
+    const bool reuse_lambda_max = lambda_max_reuse_tolerance_ > Number(0.);
+    const Number lambda_max_safety_factor =
+        (Number(1.) + lambda_max_reuse_tolerance_) /
+        (Number(1.) - lambda_max_reuse_tolerance_);
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+    (void)reuse_lambda_max;
+    (void)lambda_max_safety_factor;
+#endif
 
     {
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+      Scope scope(computing_timer_,
+                  "time step [E] 1 - compute d_ij, d_ii, alpha_i, and tau_max");
+#else
       Scope scope(computing_timer_,
                   "time step [E] 1 - compute d_ij, and alpha_i");
+#endif
 
       SynchronizationDispatch synchronization_dispatch([&]() {
-        alpha_.update_ghost_values_start(channel++);
-        second_variations_.update_ghost_values_start(channel++);
+        communication_progress_.start([&]() {
+          alpha_.update_ghost_values_start(channel++);
+          second_variations_.update_ghost_values_start(channel++);
+        });
       });
 
+      auto &idle_time_1 = idle_time_["time step [E] 1"];
+
       RYUJIN_PARALLEL_REGION_BEGIN
+      CommunicationProgress::ComputeSection compute_section(
+          communication_progress_);
       LIKWID_MARKER_START("time_step_1");
 
       /* Stored thread locally: */
+#ifdef USE_BATCHED_RIEMANN_SOLVER
+      RiemannSolverBatch<dim, Number> riemann_solver_batch(
+          *problem_description_);
+      std::vector<Number> d_row;
+#else
       RiemannSolver<dim, Number> riemann_solver_serial(*problem_description_);
+#endif
       Indicator<dim, Number> indicator_serial(*problem_description_);
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+      Number tau_max_on_thread = std::numeric_limits<Number>::infinity();
+#endif
+
+#ifdef USE_BATCHED_RIEMANN_SOLVER
+      /*
+       * Parallel non-vectorized loop: We gather all Riemann problems of a
+       * row into SIMD batches. The row buffer d_row holds the resulting
+       * d_ij, which are written after the last batch of the row has been
+       * solved.
+       */
+      const auto serial_range = offline_data_->serial_range(
+          omp_get_thread_num(), omp_get_num_threads());
+      for (unsigned int i = serial_range.first; i < serial_range.second; ++i) {
+
+        const unsigned int row_length = sparsity_simd.row_length(i);
+
+        /* Skip constrained degrees of freedom: */
+        if (row_length == 1) {
+          continue;
+        }
+
+        const auto U_i = U.get_tensor(i);
+        const Number mass = lumped_mass_matrix.local_element(i);
+        const Number hd_i = mass * measure_of_omega_inverse;
+
+        indicator_serial.reset(U_i, evc_entropies_.local_element(i));
+
+        d_row.assign(row_length, Number(0.));
+        riemann_solver_batch.reset(d_row.data());
+
+        /* Skip diagonal. */
+        const unsigned int *js = sparsity_simd.columns(i);
+        for (unsigned int col_idx = 1; col_idx < row_length; ++col_idx) {
+          const unsigned int j = js[col_idx];
+
+          const auto U_j = U.get_tensor(j);
+
+          const auto c_ij = cij_matrix.get_tensor(i, col_idx);
+          const auto beta_ij = betaij_matrix.get_entry(i, col_idx);
+          /*
+           * With tiling, the entropies of the vectorized index range
+           * might not have been computed yet. We recompute them here,
+           * the non-vectorized rows are only a small fraction:
+           */
+          const auto entropy_j = (tile_size != 0 && j < n_internal)
+                                     ? evc_entropy(U_j)
+                                     : evc_entropies_.local_element(j);
+          indicator_serial.add(U_j, c_ij, beta_ij, entropy_j);
+
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+          /*
+           * Lower triangular portion: recompute d_ji exactly the way
+           * row j does. Entries coupling to the vectorized index range
+           * are copied from row j after the SIMD loop instead.
+           */
+          if (j < i) {
+            if (j < n_internal)
+              continue;
+            const auto [norm, n_ji] = nji_serial(i, col_idx);
+            riemann_solver_batch.push(U_j, U_i, norm, n_ji, col_idx);
+            if (boundary_map.count(i) != 0 && boundary_map.count(j) != 0) {
+              const auto [norm_2, n_ij] = nij_serial(i, col_idx, c_ij);
+              riemann_solver_batch.push(U_i, U_j, norm_2, n_ij, col_idx);
+            }
+            continue;
+          }
+#else
+          /* Only iterate over the upper triangular portion of d_ij */
+          if (j <= i)
+            continue;
+#endif
+
+          const auto [norm, n_ij] = nij_serial(i, col_idx, c_ij);
+          riemann_solver_batch.push(U_i, U_j, norm, n_ij, col_idx);
+
+          /*
+           * In case both dofs are located at the boundary we have to
+           * symmetrize.
+           */
+          if (boundary_map.count(i) != 0 && boundary_map.count(j) != 0) {
+            const auto [norm_2, n_ji] = nji_serial(i, col_idx);
+            riemann_solver_batch.push(U_j, U_i, norm_2, n_ji, col_idx);
+          }
+        }
+
+        riemann_solver_batch.flush();
+
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+        Number d_sum = Number(0.);
+#endif
+        for (unsigned int col_idx = 1; col_idx < row_length; ++col_idx) {
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+          d_sum -= d_row[col_idx];
+#ifdef USE_SYMMETRIC_STORAGE
+          if (js[col_idx] < i)
+            continue;
+#endif
+#else
+          if (js[col_idx] <= i)
+            continue;
+#endif
+          dij_matrix_.write_entry(d_row[col_idx], i, col_idx);
+        }
+
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+        /* write (partial) diagonal element, completed below: */
+        dij_matrix_.write_entry(d_sum, i, 0);
+#endif
 
+        alpha_.local_element(i) = indicator_serial.alpha(hd_i);
+        second_variations_.local_element(i) =
+            indicator_serial.second_variations();
+      } /* parallel non-vectorized loop */
+#else
       /* Parallel non-vectorized loop: */
-      RYUJIN_OMP_FOR_NOWAIT
-      for (unsigned int i = n_internal; i < n_owned; ++i) {
+      const auto serial_range = offline_data_->serial_range(
+          omp_get_thread_num(), omp_get_num_threads());
+      for (unsigned int i = serial_range.first; i < serial_range.second; ++i) {
 
         const unsigned int row_length = sparsity_simd.row_length(i);
 
@@ -235,6 +913,10 @@ namespace ryujin
 
         indicator_serial.reset(U_i, evc_entropies_.local_element(i));
 
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+        Number d_sum = Number(0.);
+#endif
+
         /* Skip diagonal. */
         const unsigned int *js = sparsity_simd.columns(i);
         for (unsigned int col_idx = 1; col_idx < row_length; ++col_idx) {
@@ -244,15 +926,70 @@ namespace ryujin
 
           const auto c_ij = cij_matrix.get_tensor(i, col_idx);
           const auto beta_ij = betaij_matrix.get_entry(i, col_idx);
-          indicator_serial.add(
-              U_j, c_ij, beta_ij, evc_entropies_.local_element(j));
+          /*
+           * With tiling, the entropies of the vectorized index range
+           * might not have been computed yet. We recompute them here,
+           * the non-vectorized rows are only a small fraction:
+           */
+          const auto entropy_j = (tile_size != 0 && j < n_internal)
+                                     ? evc_entropy(U_j)
+                                     : evc_entropies_.local_element(j);
+          indicator_serial.add(U_j, c_ij, beta_ij, entropy_j);
+
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+          if (j < i) {
+            /*
+             * Lower triangular portion: recompute d_ji exactly the way
+             * row j does. Entries coupling to the vectorized index range
+             * are copied from row j after the SIMD loop instead.
+             */
+            if (j < n_internal)
+              continue;
+            const auto [norm, n_ji] = nji_serial(i, col_idx);
+
+            const auto [lambda_max, p_star, n_iterations] =
+                riemann_solver_serial.compute(U_j, U_i, n_ji);
+
+            Number d = norm * lambda_max;
+
+            if (boundary_map.count(i) != 0 && boundary_map.count(j) != 0) {
+              const auto [norm_2, n_ij] = nij_serial(i, col_idx, c_ij);
+              Assert(norm_2 > 1.e-12, ExcInternalError());
+
+              auto [lambda_max_2, p_star_2, n_iterations_2] =
+                  riemann_solver_serial.compute(U_i, U_j, n_ij);
+              d = std::max(norm_2 * lambda_max_2, d);
+            }
 
+#ifndef USE_SYMMETRIC_STORAGE
+            dij_matrix_.write_entry(d, i, col_idx);
+#endif
+            d_sum -= d;
+            continue;
+          }
+#else
           /* Only iterate over the upper triangular portion of d_ij */
           if (j <= i)
             continue;
 
-          const auto norm = c_ij.norm();
-          const auto n_ij = c_ij / norm;
+          /* Keep the d_ij of the previous stage if both states froze: */
+          if (reuse_lambda_max &&
+              lambda_max_frozen_.local_element(i) == Number(1.) &&
+              lambda_max_frozen_.local_element(j) == Number(1.)) {
+#ifdef CHECK_BOUNDS
+            const auto [norm, n_ij] = nij_serial(i, col_idx, c_ij);
+            const auto [lambda_max, p_star, n_iterations] =
+                riemann_solver_serial.compute(U_i, U_j, n_ij);
+            AssertThrow(dij_matrix_.get_entry(i, col_idx) >=
+                            norm * lambda_max,
+                        dealii::ExcMessage("Reused d_ij is not an upper "
+                                           "bound of lambda_max |c_ij|."));
+#endif
+            continue;
+          }
+#endif
+
+          const auto [norm, n_ij] = nij_serial(i, col_idx, c_ij);
 
           const auto [lambda_max, p_star, n_iterations] =
               riemann_solver_serial.compute(U_i, U_j, n_ij);
@@ -266,35 +1003,52 @@ namespace ryujin
 
           if (boundary_map.count(i) != 0 && boundary_map.count(j) != 0) {
 
-            const auto c_ji = cij_matrix.get_transposed_tensor(i, col_idx);
-            Assert(c_ji.norm() > 1.e-12, ExcInternalError());
-            const auto norm_2 = c_ji.norm();
-            const auto n_ji = c_ji / norm_2;
+            const auto [norm_2, n_ji] = nji_serial(i, col_idx);
+            Assert(norm_2 > 1.e-12, ExcInternalError());
 
             auto [lambda_max_2, p_star_2, n_iterations_2] =
                 riemann_solver_serial.compute(U_j, U_i, n_ji);
             d = std::max(d, norm_2 * lambda_max_2);
           }
 
+          if (reuse_lambda_max)
+            d *= lambda_max_safety_factor;
+
           dij_matrix_.write_entry(d, i, col_idx);
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+          d_sum -= d;
+#endif
         }
 
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+        /* write (partial) diagonal element, completed below: */
+        dij_matrix_.write_entry(d_sum, i, 0);
+#endif
+
         alpha_.local_element(i) = indicator_serial.alpha(hd_i);
         second_variations_.local_element(i) =
             indicator_serial.second_variations();
       } /* parallel non-vectorized loop */
+#endif
 
       /* Stored thread locally: */
       RiemannSolver<dim, VA> riemann_solver_simd(*problem_description_);
       Indicator<dim, VA> indicator_simd(*problem_description_);
       bool thread_ready = false;
+#ifdef USE_ON_THE_FLY_CIJ
+      std::array<Tensor<1, dim, VA>,
+                 OfflineData<dim, Number>::max_internal_row_length>
+          cij_row;
+#endif
 
-      /* Parallel SIMD loop: */
-      RYUJIN_OMP_FOR
-      for (unsigned int i = 0; i < n_internal; i += simd_length) {
-
+      /* Process the SIMD row block starting at index i: */
+      const auto simd_row = [&](const unsigned int i) {
         synchronization_dispatch.check(thread_ready, i >= n_export_indices);
 
+#ifdef USE_ON_THE_FLY_CIJ
+        offline_data_->reconstruct_cij(i, cij_row.data());
+#endif
+
         const auto U_i = U.get_vectorized_tensor(i);
         const auto entropy_i = simd_load(evc_entropies_, i);
 
@@ -305,6 +1059,10 @@ namespace ryujin
 
         const unsigned int row_length = sparsity_simd.row_length(i);
 
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+        VA d_sum = VA(0.);
+#endif
+
         /* Skip diagonal. */
         const unsigned int *js = sparsity_simd.columns(i) + simd_length;
         for (unsigned int col_idx = 1; col_idx < row_length;
@@ -320,47 +1078,258 @@ namespace ryujin
           const auto U_j = U.get_vectorized_tensor(js);
           const auto entropy_j = simd_load(evc_entropies_, js);
 
+#ifdef USE_ON_THE_FLY_CIJ
+          const auto &c_ij = cij_row[col_idx];
+#else
           const auto c_ij = cij_matrix.get_vectorized_tensor(i, col_idx);
+#endif
           const auto beta_ij = betaij_matrix.get_vectorized_entry(i, col_idx);
+#ifdef USE_PRECOMPUTED_EVC_FLUXES
+          indicator_simd.add(U_j,
+                             c_ij,
+                             beta_ij,
+                             entropy_j,
+                             evc_precomputed_.get_vectorized_tensor(js));
+#else
           indicator_simd.add(U_j, c_ij, beta_ij, entropy_j);
+#endif
+
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+          /*
+           * Evaluate the Riemann problem with (U_left, U_right, n) set to
+           * (U_i, U_j, n_ij) for lanes above, and (U_j, U_i, n_ji) for
+           * lanes below the diagonal:
+           */
+          auto U_left = U_i;
+          auto U_right = U_j;
+
+          bool all_above_diagonal = true;
+          for (unsigned int k = 0; k < simd_length; ++k)
+            if (js[k] < i + k) {
+              all_above_diagonal = false;
+              break;
+            }
+
+          auto [norm, n_ij] = all_below_diagonal
+                                  ? nji_simd(i, col_idx)
+                                  : nij_simd(i, col_idx, c_ij);
+
+          if (all_below_diagonal) {
+            U_left = U_j;
+            U_right = U_i;
+
+          } else if (!all_above_diagonal) {
+            const auto [norm_ji, n_ji] = nji_simd(i, col_idx);
+            for (unsigned int k = 0; k < simd_length; ++k) {
+              if (js[k] >= i + k)
+                continue;
+              for (unsigned int l = 0; l < problem_dimension; ++l) {
+                U_left[l][k] = U_j[l][k];
+                U_right[l][k] = U_i[l][k];
+              }
+              norm[k] = norm_ji[k];
+              for (unsigned int l = 0; l < dim; ++l)
+                n_ij[l][k] = n_ji[l][k];
+            }
+          }
+
+          const auto [lambda_max, p_star, n_iterations] =
+              riemann_solver_simd.compute(U_left, U_right, n_ij);
 
+          const auto d = norm * lambda_max;
+          d_sum -= d;
+#else
           /* Only iterate over the upper triangular portion of d_ij */
           if (all_below_diagonal)
             continue;
 
-          const auto norm = c_ij.norm();
-          const auto n_ij = c_ij / norm;
+          /* Keep the d_ij of the previous stage if all states froze: */
+          if (reuse_lambda_max) {
+            bool all_frozen = true;
+            for (unsigned int k = 0; k < simd_length; ++k)
+              if (lambda_max_frozen_.local_element(i + k) != Number(1.) ||
+                  lambda_max_frozen_.local_element(js[k]) != Number(1.)) {
+                all_frozen = false;
+                break;
+              }
+            if (all_frozen) {
+#ifdef CHECK_BOUNDS
+              const auto [norm, n_ij] = nij_simd(i, col_idx, c_ij);
+              const auto [lambda_max, p_star, n_iterations] =
+                  riemann_solver_simd.compute(U_i, U_j, n_ij);
+              const auto d_margin =
+                  dij_matrix_.get_vectorized_entry(i, col_idx) -
+                  norm * lambda_max;
+              AssertThrowSIMD(
+                  d_margin,
+                  [](auto val) { return val >= Number(0.); },
+                  dealii::ExcMessage("Reused d_ij is not an upper bound of "
+                                     "lambda_max |c_ij|."));
+#endif
+              continue;
+            }
+          }
+
+          const auto [norm, n_ij] = nij_simd(i, col_idx, c_ij);
 
           const auto [lambda_max, p_star, n_iterations] =
               riemann_solver_simd.compute(U_i, U_j, n_ij);
 
-          const auto d = norm * lambda_max;
+          auto d = norm * lambda_max;
+          if (reuse_lambda_max)
+            d *= lambda_max_safety_factor;
+#endif
 
+#ifdef USE_SYMMETRIC_STORAGE
+          /* Blocks strictly below the diagonal are not stored: */
+          if (!all_below_diagonal)
+            dij_matrix_.write_vectorized_entry(d, i, col_idx, true);
+#else
           dij_matrix_.write_vectorized_entry(d, i, col_idx, true);
+#endif
         }
 
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+        /* write diagonal element */
+        dij_matrix_.write_vectorized_entry(d_sum, i, 0, true);
+
+        const auto tau = cfl_ * mass / (Number(-2.) * d_sum);
+        for (unsigned int k = 0; k < simd_length; ++k)
+          tau_max_on_thread = std::min(tau_max_on_thread, tau[k]);
+#endif
+
         simd_store(alpha_, indicator_simd.alpha(hd_i), i);
         simd_store(second_variations_, indicator_simd.second_variations(), i);
+      };
+
+      if (tile_size == 0) {
+        /* Parallel SIMD loop: */
+        RYUJIN_OMP_FOR_NOWAIT
+        for (unsigned int i = 0; i < n_internal; i += simd_length)
+          simd_row(i);
+
+      } else {
+        /*
+         * Tiled parallel SIMD loop: Every thread works on a contiguous
+         * range of tiles [tile_begin, tile_end). Because the tile size is
+         * at least the index bandwidth, the rows of tile t only couple to
+         * the tiles t - 1, t, and t + 1. We thus first compute the
+         * entropies of the two boundary tiles of every range (the only
+         * tiles that neighboring threads depend on), synchronize once,
+         * and then compute the entropies of tile t + 1 right before the
+         * rows of tile t. This way U_j and the entropies of a tile are
+         * read from cache in Step 1 instead of being streamed from
+         * memory a second time.
+         */
+        const unsigned int n_tiles = (n_internal + tile_size - 1) / tile_size;
+        const unsigned int n_threads = omp_get_num_threads();
+        const unsigned int thread = omp_get_thread_num();
+        const unsigned int tile_begin = n_tiles * thread / n_threads;
+        const unsigned int tile_end = n_tiles * (thread + 1) / n_threads;
+
+        const auto entropies_of_tile = [&](const unsigned int t) {
+          const unsigned int end = std::min(n_internal, (t + 1) * tile_size);
+          for (unsigned int i = t * tile_size; i < end; i += simd_length)
+            compute_entropies_simd(i);
+        };
+
+        if (tile_begin < tile_end) {
+          entropies_of_tile(tile_begin);
+          if (tile_end - 1 > tile_begin)
+            entropies_of_tile(tile_end - 1);
+        }
+
+        RYUJIN_OMP_BARRIER
+
+        for (unsigned int t = tile_begin; t < tile_end; ++t) {
+          if (t + 2 < tile_end)
+            entropies_of_tile(t + 1);
+          const unsigned int end = std::min(n_internal, (t + 1) * tile_size);
+          for (unsigned int i = t * tile_size; i < end; i += simd_length)
+            simd_row(i);
+        }
       } /* parallel SIMD loop */
 
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+      /*
+       * Complete the non-vectorized rows: An entry d_ij with j in the
+       * vectorized index range has been computed by row j with the SIMD
+       * Riemann solver. Recomputing it with the scalar Riemann solver
+       * (and the serial pow) is not guaranteed to give a bitwise
+       * identical result, so we copy the transposed entry instead:
+       */
+      RYUJIN_OMP_BARRIER
+
+      for (unsigned int i = serial_range.first; i < serial_range.second; ++i) {
+        const unsigned int row_length = sparsity_simd.row_length(i);
+        if (row_length == 1)
+          continue;
+
+        Number d_sum = dij_matrix_.get_entry(i, 0);
+
+        const unsigned int *js = sparsity_simd.columns(i);
+        for (unsigned int col_idx = 1; col_idx < row_length; ++col_idx) {
+          if (js[col_idx] >= n_internal)
+            continue;
+
+          const auto d_ji = dij_matrix_.get_transposed_entry(i, col_idx);
+#ifndef USE_SYMMETRIC_STORAGE
+          dij_matrix_.write_entry(d_ji, i, col_idx);
+#endif
+          d_sum -= d_ji;
+        }
+
+        /* write diagonal element */
+        dij_matrix_.write_entry(d_sum, i, 0);
+
+        const Number mass = lumped_mass_matrix.local_element(i);
+        const Number tau = cfl_ * mass / (Number(-2.) * d_sum);
+        tau_max_on_thread = std::min(tau_max_on_thread, tau);
+      }
+
+      tau_max_reduction.local() = tau_max_on_thread;
+#endif
+
+      /* Accumulate Riemann solver statistics: */
+#ifdef USE_BATCHED_RIEMANN_SOLVER
+      const auto &riemann_solver_scalar = riemann_solver_batch.riemann_solver();
+#else
+      const auto &riemann_solver_scalar = riemann_solver_serial;
+#endif
+      n_riemann_solves +=
+          riemann_solver_scalar.n_solves() + riemann_solver_simd.n_solves();
+      n_riemann_iterations += riemann_solver_scalar.n_iterations() +
+                              riemann_solver_simd.n_iterations();
+
+      idle_time_1.barrier();
       LIKWID_MARKER_STOP("time_step_1");
       RYUJIN_PARALLEL_REGION_END
     }
 
+    n_riemann_solves_ += n_riemann_solves.load();
+    n_riemann_iterations_ += n_riemann_iterations.load();
+
     /*
      * Step 2: Compute diagonal of d_ij, and maximal time-step size.
+     *
+     * This step is already part of Step 1 if USE_FUSED_D_IJ_COMPUTATION
+     * is set. With USE_SYMMETRIC_STORAGE the lower triangular part of
+     * d_ij is never stored and we only have to compute the row sums.
      */
 
-    std::atomic<Number> tau_max{std::numeric_limits<Number>::infinity()};
-
+#ifndef USE_FUSED_D_IJ_COMPUTATION
     {
       Scope scope(computing_timer_,
                   "time step [E] 2 - compute d_ii, and tau_max");
 
       /* Parallel region */
       RYUJIN_PARALLEL_REGION_BEGIN
+      CommunicationProgress::ComputeSection compute_section(
+          communication_progress_);
       LIKWID_MARKER_START("time_step_2");
 
+      Number tau_max_on_thread = std::numeric_limits<Number>::infinity();
+
       /* Parallel non-vectorized loop: */
       RYUJIN_OMP_FOR
       for (unsigned int i = 0; i < n_owned; ++i) {
@@ -380,11 +1349,15 @@ namespace ryujin
           const auto j =
               *(i < n_internal ? js + col_idx * simd_length : js + col_idx);
 
+#ifndef USE_SYMMETRIC_STORAGE
           // fill lower triangular part of dij_matrix missing from step 1
           if (j < i) {
             const auto d_ji = dij_matrix_.get_transposed_entry(i, col_idx);
             dij_matrix_.write_entry(d_ji, i, col_idx);
           }
+#else
+          (void)j;
+#endif
 
           d_sum -= dij_matrix_.get_entry(i, col_idx);
         }
@@ -393,52 +1366,54 @@ namespace ryujin
         dij_matrix_.write_entry(d_sum, i, 0);
 
         const Number mass = lumped_mass_matrix.local_element(i);
-        const Number tau = cfl_update_ * mass / (Number(-2.) * d_sum);
-
-        Number current_tau_max = tau_max.load();
-        while (current_tau_max > tau &&
-               !tau_max.compare_exchange_weak(current_tau_max, tau))
-          ;
+        const Number tau = cfl_ * mass / (Number(-2.) * d_sum);
+        tau_max_on_thread = std::min(tau_max_on_thread, tau);
       } /* parallel non-vectorized loop */
 
+      tau_max_reduction.local() = tau_max_on_thread;
+
       LIKWID_MARKER_STOP("time_step_2");
       RYUJIN_PARALLEL_REGION_END
     }
+#endif
 
     {
 #if defined(SPLIT_SYNCHRONIZATION_TIMERS) || defined(DEBUG_OUTPUT)
       Scope scope(computing_timer_,
                   "time step [E] 2 - synchronization barrier");
+#elif defined(USE_FUSED_D_IJ_COMPUTATION)
+      Scope scope(computing_timer_,
+                  "time step [E] 1 - compute d_ij, d_ii, alpha_i, and tau_max");
 #else
       Scope scope(computing_timer_,
                   "time step [E] 2 - compute d_ii, and tau_max");
 #endif
 
-      alpha_.update_ghost_values_finish();
-      second_variations_.update_ghost_values_finish();
-
-      /* MPI Barrier: */
-      tau_max.store(Utilities::MPI::min(tau_max.load(), mpi_communicator_));
-
-      AssertThrow(!std::isnan(tau_max) && !std::isinf(tau_max) && tau_max > 0.,
-                  ExcMessage("I'm sorry, Dave. I'm afraid I can't "
-                             "do that. - We crashed."));
-
-#ifdef DEBUG_OUTPUT
-      std::cout << "        computed tau_max = " << tau_max << std::endl;
-#endif
-      tau = (tau == Number(0.) ? tau_max.load() : tau);
-#ifdef DEBUG_OUTPUT
-      std::cout << "        perform time-step with tau = " << tau << std::endl;
+      /* Start the non-blocking reduction of tau_max: */
+      tau_max_buffer = tau_max_reduction.combine(
+          [](const Number a, const Number b) { return std::min(a, b); });
+      MPI_Iallreduce(MPI_IN_PLACE,
+                     &tau_max_buffer,
+                     1,
+                     MPI_DOUBLE,
+                     MPI_MIN,
+                     mpi_communicator_,
+                     &tau_max_request);
+
+#ifndef USE_PIPELINED_COMMUNICATION
+      communication_progress_.complete([&]() {
+        alpha_.update_ghost_values_finish();
+        second_variations_.update_ghost_values_finish();
+      });
 #endif
 
-      if (tau * cfl_update_ > tau_max.load() * cfl_max_) {
-#ifdef DEBUG_OUTPUT
-        std::cout
-            << "        insufficient CFL, refuse update and abort stepping"
-            << std::endl;
+      if (!speculative_step && !complete_tau_max_reduction()) {
+#ifdef USE_PIPELINED_COMMUNICATION
+        communication_progress_.complete([&]() {
+          alpha_.update_ghost_values_finish();
+          second_variations_.update_ghost_values_finish();
+        });
 #endif
-        U[0] *= std::numeric_limits<Number>::quiet_NaN();
         return tau_max;
       }
     }
@@ -451,107 +1426,205 @@ namespace ryujin
      *        R_i = \sum_j - c_ij f_j + d_ij^H (U_j - U_i)
      *
      *   Low-order update: += tau / m_i * 2 d_ij^L (\bar U_ij)
+     *
+     *   With local time stepping tau / m_i is replaced by the local ratio
+     *   tau_i / m_i = cfl / (-2 d_ii^L) (here and in Step 4).
      */
 
     {
       Scope scope(computing_timer_,
                   "time step [E] 3 - l.-o. update, bounds, and r_i");
 
+      /*
+       * Reset the buffer for the (sums and minima of the) integrals. A
+       * reduction that is still in flight has to be completed first:
+       */
+      if (record_integrals) {
+        integrals();
+        std::fill(integrals_buffer_.begin(),
+                  integrals_buffer_.end() - 2,
+                  0.);
+        std::fill(integrals_buffer_.end() - 2,
+                  integrals_buffer_.end(),
+                  std::numeric_limits<double>::max());
+      }
+
+      if (record_residual) {
+        residual();
+        residual_buffer_ = 0.;
+      }
+
       SynchronizationDispatch synchronization_dispatch([&]() {
-        if (RYUJIN_LIKELY(limiter_iter_ != 0))
-          r_.update_ghost_values_start(channel++);
+        if (RYUJIN_LIKELY(limiter_iter_ != 0)) {
+          communication_progress_.start(
+              [&]() { r.update_ghost_values_start(channel++); });
+        }
+      });
+
+#ifdef USE_PIPELINED_COMMUNICATION
+      SynchronizationWait synchronization_wait([&]() {
+        communication_progress_.complete([&]() {
+          alpha_.update_ghost_values_finish();
+          second_variations_.update_ghost_values_finish();
+        });
       });
+#endif
+
+      auto &idle_time_3 = idle_time_["time step [E] 3"];
 
       /* Parallel region */
       RYUJIN_PARALLEL_REGION_BEGIN
+      CommunicationProgress::ComputeSection compute_section(
+          communication_progress_);
       LIKWID_MARKER_START("time_step_3");
 
       /* Nota bene: This bounds variable is thread local: */
-      Limiter<dim, Number> limiter_serial(*problem_description_);
+      Limiter<dim, Number, limiter> limiter_serial(*problem_description_);
+
+      /* Thread local accumulators for the integrals of U: */
+      rank1_type state_serial;
+      Number e_serial = 0.;
+      Number p_serial = 0.;
+      Number s_min_serial = std::numeric_limits<Number>::max();
+      Number e_min_serial = std::numeric_limits<Number>::max();
+      Number residual_serial = 0.;
 
       /* Parallel non-vectorized loop: */
-      RYUJIN_OMP_FOR_NOWAIT
-      for (unsigned int i = n_internal; i < n_owned; ++i) {
+      const auto serial_loop = [&]() {
+        const auto serial_range = offline_data_->serial_range(
+            omp_get_thread_num(), omp_get_num_threads());
+        for (unsigned int i = serial_range.first; i < serial_range.second;
+             ++i) {
 
-        /* Skip constrained degrees of freedom: */
-        const unsigned int row_length = sparsity_simd.row_length(i);
-        if (row_length == 1)
-          continue;
+          /* Skip constrained degrees of freedom: */
+          const unsigned int row_length = sparsity_simd.row_length(i);
+          if (row_length == 1)
+            continue;
 
-        const auto U_i = U.get_tensor(i);
-        const auto f_i = problem_description_->f(U_i);
-        auto U_i_new = U_i;
-        const auto alpha_i = alpha_.local_element(i);
-        const auto variations_i = second_variations_.local_element(i);
+          const auto U_i = U.get_tensor(i);
+          const auto f_i = problem_description_->f(U_i);
+          auto U_i_new = U_i;
+          const auto alpha_i = alpha_.local_element(i);
+          const auto variations_i = second_variations_.local_element(i);
 
-        const Number m_i = lumped_mass_matrix.local_element(i);
-        const Number m_i_inv = lumped_mass_matrix_inverse.local_element(i);
+          const Number m_i = lumped_mass_matrix.local_element(i);
+          const Number m_i_inv = lumped_mass_matrix_inverse.local_element(i);
+          const Number tau_m_i_inv =
+              local_time_stepping_
+                  ? cfl_ / (Number(-2.) * dij_matrix_.get_entry(i, 0))
+                  : tau * m_i_inv;
 
-        rank1_type r_i;
+          rank1_type r_i;
 
-        /* Clear bounds: */
-        limiter_serial.reset(variations_i);
+          /* Clear bounds: */
+          limiter_serial.reset(variations_i);
 
-        const unsigned int *js = sparsity_simd.columns(i);
-        for (unsigned int col_idx = 0; col_idx < row_length; ++col_idx) {
-          const auto j = js[col_idx];
+          const unsigned int *js = sparsity_simd.columns(i);
+          for (unsigned int col_idx = 0; col_idx < row_length; ++col_idx) {
+            const auto j = js[col_idx];
 
-          const auto U_j = U.get_tensor(j);
-          const auto alpha_j = alpha_.local_element(j);
-          const auto variations_j = second_variations_.local_element(j);
+            const auto U_j = U.get_tensor(j);
+            const auto alpha_j = alpha_.local_element(j);
+            const auto variations_j = second_variations_.local_element(j);
 
-          const auto d_ij = dij_matrix_.get_entry(i, col_idx);
-          const Number d_ij_inv = Number(1.) / d_ij;
+            const auto d_ij = dij_matrix_.get_entry(i, col_idx);
+            const Number d_ij_inv = Number(1.) / d_ij;
 
-          const auto d_ijH = Indicator<dim, Number>::indicator_ ==
-                                     Indicator<dim, Number>::Indicators::
-                                         entropy_viscosity_commutator
-                                 ? d_ij * (alpha_i + alpha_j) * Number(.5)
-                                 : d_ij * std::max(alpha_i, alpha_j);
+            const auto d_ijH = Indicator<dim, Number>::indicator_ ==
+                                       Indicator<dim, Number>::Indicators::
+                                           entropy_viscosity_commutator
+                                   ? d_ij * (alpha_i + alpha_j) * Number(.5)
+                                   : d_ij * std::max(alpha_i, alpha_j);
 
-          dealii::Tensor<1, problem_dimension, Number> U_ij_bar;
-          const auto c_ij = cij_matrix.get_tensor(i, col_idx);
-          const auto f_j = problem_description_->f(U_j);
+            dealii::Tensor<1, problem_dimension, Number> U_ij_bar;
+            const auto c_ij = cij_matrix.get_tensor(i, col_idx);
+            const auto f_j = problem_description_->f(U_j);
 
-          for (unsigned int k = 0; k < problem_dimension; ++k) {
-            const auto temp = (f_j[k] - f_i[k]) * c_ij;
+            for (unsigned int k = 0; k < problem_dimension; ++k) {
+              const auto temp = (f_j[k] - f_i[k]) * c_ij;
 
-            r_i[k] += -temp + d_ijH * (U_j - U_i)[k];
-            U_ij_bar[k] =
-                Number(0.5) * (U_i[k] + U_j[k]) - Number(0.5) * temp * d_ij_inv;
-          }
+              r_i[k] += -temp + d_ijH * (U_j - U_i)[k];
+              U_ij_bar[k] = Number(0.5) * (U_i[k] + U_j[k]) -
+                            Number(0.5) * temp * d_ij_inv;
+            }
 
-          U_i_new += tau * m_i_inv * Number(2.) * d_ij * U_ij_bar;
+            U_i_new += tau_m_i_inv * Number(2.) * d_ij * U_ij_bar;
 
-          const auto beta_ij = betaij_matrix.get_entry(i, col_idx);
+            const auto beta_ij = betaij_matrix.get_entry(i, col_idx);
 
-          limiter_serial.accumulate(U_i,
-                                    U_j,
-                                    U_ij_bar,
-                                    beta_ij,
-                                    specific_entropies_.local_element(j),
-                                    variations_j,
-                                    /* is diagonal */ col_idx == 0);
-        }
+            limiter_serial.accumulate(U_i,
+                                      U_j,
+                                      U_ij_bar,
+                                      beta_ij,
+                                      specific_entropies_.local_element(j),
+                                      variations_j,
+                                      /* is diagonal */ col_idx == 0);
+          }
 
-        temp_euler_.write_tensor(U_i_new, i);
-        r_.write_tensor(r_i, i);
+          temp_euler.write_tensor(U_i_new, i);
+          r.write_tensor(r_i, i);
+
+          const Number hd_i = m_i * measure_of_omega_inverse;
+          limiter_serial.apply_relaxation(hd_i);
+          auto bounds = limiter_serial.bounds();
+          widen_bounds(bounds);
+          bounds_.write_tensor(bounds, i);
+
+          if (record_integrals) {
+            const auto rho_i = problem_description_->density(U_i);
+            const auto e_i = problem_description_->internal_energy(U_i) / rho_i;
+            state_serial += m_i * U_i;
+            e_serial += m_i * e_i;
+            p_serial += m_i * problem_description_->pressure(U_i);
+            s_min_serial =
+                std::min(s_min_serial, specific_entropies_.local_element(i));
+            e_min_serial = std::min(e_min_serial, e_i);
+          }
 
-        const Number hd_i = m_i * measure_of_omega_inverse;
-        limiter_serial.apply_relaxation(hd_i);
-        bounds_.write_tensor(limiter_serial.bounds(), i);
-      } /* parallel non-vectorized loop */
+          if (record_residual)
+            residual_serial += r_i[0] * r_i[0] * m_i_inv;
+        } /* parallel non-vectorized loop */
+      };
+
+#ifndef USE_PIPELINED_COMMUNICATION
+      serial_loop();
+#endif
 
       /* Nota bene: This bounds variable is thread local: */
-      Limiter<dim, VA> limiter_simd(*problem_description_);
+      Limiter<dim, VA, limiter> limiter_simd(*problem_description_);
       bool thread_ready = false;
 
+      ProblemDescription::rank1_type<dim, VA> state_simd;
+      VA e_simd = VA(0.);
+      VA p_simd = VA(0.);
+      VA s_min_simd = VA(std::numeric_limits<Number>::max());
+      VA e_min_simd = VA(std::numeric_limits<Number>::max());
+      VA residual_simd = VA(0.);
+#ifdef USE_PIPELINED_COMMUNICATION
+      bool thread_ready_wait = false;
+#endif
+#ifdef USE_ON_THE_FLY_CIJ
+      std::array<Tensor<1, dim, VA>,
+                 OfflineData<dim, Number>::max_internal_row_length>
+          cij_row;
+#endif
+
       /* Parallel SIMD loop: */
 
       RYUJIN_OMP_FOR
-      for (unsigned int i = 0; i < n_internal; i += simd_length) {
+      for (unsigned int ii = 0; ii < n_internal; ii += simd_length) {
 
+#ifdef USE_PIPELINED_COMMUNICATION
+        const unsigned int i = pipelined_index(ii);
+        synchronization_wait.wait(thread_ready_wait, i < n_export_simd);
+#else
+        const unsigned int i = ii;
         synchronization_dispatch.check(thread_ready, i >= n_export_indices);
+#endif
+
+#ifdef USE_ON_THE_FLY_CIJ
+        offline_data_->reconstruct_cij(i, cij_row.data());
+#endif
 
         const auto U_i = U.get_vectorized_tensor(i);
         const auto f_i = problem_description_->f(U_i);
@@ -561,6 +1634,10 @@ namespace ryujin
 
         const auto m_i = simd_load(lumped_mass_matrix, i);
         const auto m_i_inv = simd_load(lumped_mass_matrix_inverse, i);
+        const auto tau_m_i_inv =
+            local_time_stepping_
+                ? cfl_ / (Number(-2.) * dij_matrix_.get_vectorized_entry(i, 0))
+                : tau * m_i_inv;
 
         ProblemDescription::rank1_type<dim, VA> r_i;
 
@@ -587,7 +1664,11 @@ namespace ryujin
           const auto U_j = U.get_vectorized_tensor(js);
 
           dealii::Tensor<1, problem_dimension, VA> U_ij_bar;
+#ifdef USE_ON_THE_FLY_CIJ
+          const auto &c_ij = cij_row[col_idx];
+#else
           const auto c_ij = cij_matrix.get_vectorized_tensor(i, col_idx);
+#endif
           const auto d_ij_inv = Number(1.) / d_ij;
 
           const auto f_j = problem_description_->f(U_j);
@@ -598,7 +1679,7 @@ namespace ryujin
             U_ij_bar[k] = Number(0.5) * (U_i[k] + U_j[k] - temp * d_ij_inv);
           }
 
-          U_i_new += tau * m_i_inv * Number(2.) * d_ij * U_ij_bar;
+          U_i_new += tau_m_i_inv * Number(2.) * d_ij * U_ij_bar;
 
           const auto beta_ij = betaij_matrix.get_vectorized_entry(i, col_idx);
           const auto entropy_j = simd_load(specific_entropies_, js);
@@ -612,16 +1693,94 @@ namespace ryujin
                                   /* is diagonal */ col_idx == 0);
         }
 
-        temp_euler_.write_vectorized_tensor(U_i_new, i);
-        r_.write_vectorized_tensor(r_i, i);
+        temp_euler.write_vectorized_tensor(U_i_new, i);
+        r.write_vectorized_tensor(r_i, i);
 
         const auto hd_i = m_i * measure_of_omega_inverse;
         limiter_simd.apply_relaxation(hd_i);
-        bounds_.write_vectorized_tensor(limiter_simd.bounds(), i);
+        auto bounds = limiter_simd.bounds();
+        widen_bounds(bounds);
+        bounds_.write_vectorized_tensor(bounds, i);
+
+        if (record_integrals) {
+          const auto rho_i = problem_description_->density(U_i);
+          const auto e_i = problem_description_->internal_energy(U_i) / rho_i;
+          state_simd += m_i * U_i;
+          e_simd += m_i * e_i;
+          p_simd += m_i * problem_description_->pressure(U_i);
+          s_min_simd = std::min(s_min_simd, simd_load(specific_entropies_, i));
+          e_min_simd = std::min(e_min_simd, e_i);
+        }
+
+        if (record_residual)
+          residual_simd += r_i[0] * r_i[0] * m_i_inv;
       } /* parallel SIMD loop */
 
+#ifdef USE_PIPELINED_COMMUNICATION
+      synchronization_wait.wait(thread_ready_wait, true);
+      serial_loop();
+      synchronization_dispatch.check(thread_ready, true);
+#endif
+
+      if (record_integrals) {
+        for (unsigned int k = 0; k < simd_length; ++k) {
+          for (unsigned int c = 0; c < problem_dimension; ++c)
+            state_serial[c] += state_simd[c][k];
+          e_serial += e_simd[k];
+          p_serial += p_simd[k];
+          s_min_serial = std::min(s_min_serial, s_min_simd[k]);
+          e_min_serial = std::min(e_min_serial, e_min_simd[k]);
+        }
+
+        RYUJIN_OMP_CRITICAL
+        {
+          auto &buffer = integrals_buffer_;
+          for (unsigned int c = 0; c < problem_dimension; ++c)
+            buffer[c] += state_serial[c];
+          buffer[problem_dimension] += e_serial;
+          buffer[problem_dimension + 1] += p_serial;
+          buffer[problem_dimension + 2] =
+              std::min(buffer[problem_dimension + 2], double(s_min_serial));
+          buffer[problem_dimension + 3] =
+              std::min(buffer[problem_dimension + 3], double(e_min_serial));
+        }
+      }
+
+      if (record_residual) {
+        for (unsigned int k = 0; k < simd_length; ++k)
+          residual_serial += residual_simd[k];
+
+        RYUJIN_OMP_CRITICAL
+        {
+          residual_buffer_ += residual_serial;
+        }
+      }
+
+      idle_time_3.barrier();
       LIKWID_MARKER_STOP("time_step_3");
       RYUJIN_PARALLEL_REGION_END
+
+      /*
+       * Reduce the integrals with a single non-blocking collective that
+       * is overlapped with the remainder of the time step:
+       */
+      if (record_integrals)
+        MPI_Iallreduce(MPI_IN_PLACE,
+                       integrals_buffer_.data(),
+                       integrals_buffer_.size(),
+                       MPI_DOUBLE,
+                       integrals_reduction_operation(),
+                       mpi_communicator_,
+                       &integrals_request_);
+
+      if (record_residual)
+        MPI_Iallreduce(MPI_IN_PLACE,
+                       &residual_buffer_,
+                       1,
+                       MPI_DOUBLE,
+                       MPI_SUM,
+                       mpi_communicator_,
+                       &residual_request_);
     }
 
     {
@@ -632,8 +1791,20 @@ namespace ryujin
                   "time step [E] 3 - l.-o. update, bounds, and r_i");
 #endif
 
+#ifndef USE_PIPELINED_COMMUNICATION
       if (RYUJIN_LIKELY(limiter_iter_ != 0))
-        r_.update_ghost_values_finish();
+        communication_progress_.complete(
+            [&]() { r.update_ghost_values_finish(); });
+#endif
+
+      if (speculative_step && !complete_tau_max_reduction()) {
+#ifdef USE_PIPELINED_COMMUNICATION
+        if (RYUJIN_LIKELY(limiter_iter_ != 0))
+          communication_progress_.complete(
+              [&]() { r.update_ghost_values_finish(); });
+#endif
+        return tau_max;
+      }
     }
 
     /*
@@ -646,89 +1817,126 @@ namespace ryujin
     if (RYUJIN_LIKELY(limiter_iter_ != 0)) {
       Scope scope(computing_timer_, "time step [E] 4 - compute p_ij, and l_ij");
 
-      SynchronizationDispatch synchronization_dispatch(
-          [&]() { lij_matrix_.update_ghost_rows_start(channel++); });
+      SynchronizationDispatch synchronization_dispatch([&]() {
+        communication_progress_.start(
+            [&]() { lij_matrix_.update_ghost_rows_start(channel++); });
+      });
+
+#ifdef USE_PIPELINED_COMMUNICATION
+      SynchronizationWait synchronization_wait([&]() {
+        communication_progress_.complete(
+            [&]() { r.update_ghost_values_finish(); });
+      });
+#endif
 
       RYUJIN_PARALLEL_REGION_BEGIN
+      CommunicationProgress::ComputeSection compute_section(
+          communication_progress_);
       LIKWID_MARKER_START("time_step_4");
 
       /* Parallel non-vectorized loop: */
 
-      RYUJIN_OMP_FOR_NOWAIT
-      for (unsigned int i = n_internal; i < n_owned; ++i) {
+      const auto serial_loop = [&]() {
+        const auto serial_range = offline_data_->serial_range(
+            omp_get_thread_num(), omp_get_num_threads());
+        for (unsigned int i = serial_range.first; i < serial_range.second;
+             ++i) {
 
-        /* Skip constrained degrees of freedom: */
-        const unsigned int row_length = sparsity_simd.row_length(i);
-        if (row_length == 1)
-          continue;
+          /* Skip constrained degrees of freedom: */
+          const unsigned int row_length = sparsity_simd.row_length(i);
+          if (row_length == 1)
+            continue;
 
-        const auto bounds =
-            bounds_.template get_tensor<std::array<Number, 3>>(i);
+          const auto bounds =
+              bounds_.template get_tensor<std::array<Number, 3>>(i);
 
-        const auto U_i_new = temp_euler_.get_tensor(i);
-        const auto U_i = U.get_tensor(i);
-        const auto r_i = r_.get_tensor(i);
+          const auto U_i_new = temp_euler.get_tensor(i);
+          const auto U_i = U.get_tensor(i);
+          const auto r_i = r.get_tensor(i);
 
-        const auto alpha_i = alpha_.local_element(i);
-        const Number m_i_inv = lumped_mass_matrix_inverse.local_element(i);
+          const auto alpha_i = alpha_.local_element(i);
+          const Number m_i_inv = lumped_mass_matrix_inverse.local_element(i);
+          const Number tau_m_i_inv =
+              local_time_stepping_
+                  ? cfl_ / (Number(-2.) * dij_matrix_.get_entry(i, 0))
+                  : tau * m_i_inv;
 
-        const unsigned int *js = sparsity_simd.columns(i);
-        const Number lambda_inv = Number(row_length - 1);
+          const unsigned int *js = sparsity_simd.columns(i);
+          const Number lambda_inv = Number(row_length - 1);
 
-        for (unsigned int col_idx = 0; col_idx < row_length; ++col_idx) {
-          const auto j = js[col_idx];
+          for (unsigned int col_idx = 0; col_idx < row_length; ++col_idx) {
+            const auto j = js[col_idx];
 
-          const auto U_j = U.get_tensor(j);
+            const auto U_j = U.get_tensor(j);
 
-          const auto r_j = r_.get_tensor(j);
+            const auto r_j = r.get_tensor(j);
 
-          const auto alpha_j = alpha_.local_element(j);
-          const Number m_j_inv = lumped_mass_matrix_inverse.local_element(j);
+            const auto alpha_j = alpha_.local_element(j);
+            const Number m_j_inv = lumped_mass_matrix_inverse.local_element(j);
 
-          const auto d_ij = dij_matrix_.get_entry(i, col_idx);
-          const auto d_ijH = Indicator<dim, Number>::indicator_ ==
-                                     Indicator<dim, Number>::Indicators::
-                                         entropy_viscosity_commutator
-                                 ? d_ij * (alpha_i + alpha_j) * Number(.5)
-                                 : d_ij * std::max(alpha_i, alpha_j);
+            const auto d_ij = dij_matrix_.get_entry(i, col_idx);
+            const auto d_ijH = Indicator<dim, Number>::indicator_ ==
+                                       Indicator<dim, Number>::Indicators::
+                                           entropy_viscosity_commutator
+                                   ? d_ij * (alpha_i + alpha_j) * Number(.5)
+                                   : d_ij * std::max(alpha_i, alpha_j);
 
-          const auto m_ij = mass_matrix.get_entry(i, col_idx);
-          const auto b_ij =
-              (col_idx == 0 ? Number(1.) : Number(0.)) - m_ij * m_j_inv;
-          const auto b_ji =
-              (col_idx == 0 ? Number(1.) : Number(0.)) - m_ij * m_i_inv;
+            const auto m_ij = mass_matrix.get_entry(i, col_idx);
+            const auto b_ij =
+                (col_idx == 0 ? Number(1.) : Number(0.)) - m_ij * m_j_inv;
+            const auto b_ji =
+                (col_idx == 0 ? Number(1.) : Number(0.)) - m_ij * m_i_inv;
 
-          const auto p_ij =
-              tau * m_i_inv * lambda_inv *
-              ((d_ijH - d_ij) * (U_j - U_i) + b_ij * r_j - b_ji * r_i);
-          pij_matrix_.write_tensor(p_ij, i, col_idx);
+            const auto p_ij =
+                tau_m_i_inv * lambda_inv *
+                ((d_ijH - d_ij) * (U_j - U_i) + b_ij * r_j - b_ji * r_i);
+            if (!recompute_pij_)
+              pij_matrix_.write_tensor(p_ij, i, col_idx);
 
-          const auto l_ij = Limiter<dim, Number>::limit(
-              *problem_description_, bounds, U_i_new, p_ij);
-          lij_matrix_.write_entry(l_ij, i, col_idx);
-        }
-      } /* parallel non-vectorized loop */
+            const auto l_ij = Limiter<dim, Number>::template limit<limiter>(
+                *problem_description_, bounds, U_i_new, p_ij);
+            lij_matrix_.write_entry(l_ij, i, col_idx);
+          }
+        } /* parallel non-vectorized loop */
+      };
+
+#ifndef USE_PIPELINED_COMMUNICATION
+      serial_loop();
+#endif
 
       /* Parallel SIMD loop: */
 
       bool thread_ready = false;
+#ifdef USE_PIPELINED_COMMUNICATION
+      bool thread_ready_wait = false;
+#endif
 
       RYUJIN_OMP_FOR
-      for (unsigned int i = 0; i < n_internal; i += simd_length) {
+      for (unsigned int ii = 0; ii < n_internal; ii += simd_length) {
 
+#ifdef USE_PIPELINED_COMMUNICATION
+        const unsigned int i = pipelined_index(ii);
+        synchronization_wait.wait(thread_ready_wait, i < n_export_simd);
+#else
+        const unsigned int i = ii;
         synchronization_dispatch.check(thread_ready, i >= n_export_indices);
+#endif
 
         const auto bounds =
             bounds_.template get_vectorized_tensor<std::array<VA, 3>>(i);
 
         const auto m_i_inv = simd_load(lumped_mass_matrix_inverse, i);
+        const auto tau_m_i_inv =
+            local_time_stepping_
+                ? cfl_ / (Number(-2.) * dij_matrix_.get_vectorized_entry(i, 0))
+                : tau * m_i_inv;
 
         const unsigned int row_length = sparsity_simd.row_length(i);
         const VA lambda_inv = Number(row_length - 1);
 
-        const auto U_i_new = temp_euler_.get_vectorized_tensor(i);
+        const auto U_i_new = temp_euler.get_vectorized_tensor(i);
         const auto U_i = U.get_vectorized_tensor(i);
-        const auto r_i = r_.get_vectorized_tensor(i);
+        const auto r_i = r.get_vectorized_tensor(i);
         const auto alpha_i = simd_load(alpha_, i);
 
         const unsigned int *js = sparsity_simd.columns(i);
@@ -753,20 +1961,27 @@ namespace ryujin
           const auto b_ji = (col_idx == 0 ? VA(1.) : VA(0.)) - m_ij * m_i_inv;
 
           const auto U_j = U.get_vectorized_tensor(js);
-          const auto r_j = r_.get_vectorized_tensor(js);
+          const auto r_j = r.get_vectorized_tensor(js);
 
           const auto p_ij =
-              tau * m_i_inv * lambda_inv *
+              tau_m_i_inv * lambda_inv *
               ((d_ijH - d_ij) * (U_j - U_i) + b_ij * r_j - b_ji * r_i);
-          pij_matrix_.write_vectorized_tensor(p_ij, i, col_idx, true);
+          if (!recompute_pij_)
+            pij_matrix_.write_vectorized_tensor(p_ij, i, col_idx, true);
 
-          const auto l_ij = Limiter<dim, VA>::limit(
+          const auto l_ij = Limiter<dim, VA>::template limit<limiter>(
               *problem_description_, bounds, U_i_new, p_ij);
 
           lij_matrix_.write_vectorized_entry(l_ij, i, col_idx, true);
         }
       } /* parallel SIMD loop */
 
+#ifdef USE_PIPELINED_COMMUNICATION
+      synchronization_wait.wait(thread_ready_wait, true);
+      serial_loop();
+      synchronization_dispatch.check(thread_ready, true);
+#endif
+
       LIKWID_MARKER_STOP("time_step_4");
       RYUJIN_PARALLEL_REGION_END
     }
@@ -778,7 +1993,10 @@ namespace ryujin
       Scope scope(computing_timer_, "time step [E] 4 - compute p_ij, and l_ij");
 #endif
 
-      lij_matrix_.update_ghost_rows_finish();
+#ifndef USE_PIPELINED_COMMUNICATION
+      communication_progress_.complete(
+          [&]() { lij_matrix_.update_ghost_rows_finish(); });
+#endif
     }
 
     /*
@@ -789,6 +2007,96 @@ namespace ryujin
      *   Compute next l_ij
      */
 
+    /*
+     * Recompute P_ij exactly as in Step 4 (if recompute_pij_ is set), for
+     * row i of the non-vectorized, or for the SIMD row chunk starting at
+     * i of the vectorized index range. The row-invariant data is loaded
+     * once per row, the returned lambda evaluates P_ij for a given
+     * col_idx:
+     */
+
+    const auto p_ij_row_serial = [&](const unsigned int i) {
+      const unsigned int row_length = sparsity_simd.row_length(i);
+      const unsigned int *js = sparsity_simd.columns(i);
+
+      const auto U_i = U.get_tensor(i);
+      const auto r_i = r.get_tensor(i);
+      const auto alpha_i = alpha_.local_element(i);
+      const Number m_i_inv = lumped_mass_matrix_inverse.local_element(i);
+      const Number tau_m_i_inv =
+          local_time_stepping_
+              ? cfl_ / (Number(-2.) * dij_matrix_.get_entry(i, 0))
+              : tau * m_i_inv;
+      const Number lambda_inv = Number(row_length - 1);
+
+      return [&, i, js, U_i, r_i, alpha_i, m_i_inv, tau_m_i_inv, lambda_inv](
+                 const unsigned int col_idx) {
+        const unsigned int j = js[col_idx];
+
+        const auto U_j = U.get_tensor(j);
+        const auto r_j = r.get_tensor(j);
+        const auto alpha_j = alpha_.local_element(j);
+        const Number m_j_inv = lumped_mass_matrix_inverse.local_element(j);
+
+        const auto d_ij = dij_matrix_.get_entry(i, col_idx);
+        const auto d_ijH = Indicator<dim, Number>::indicator_ ==
+                                   Indicator<dim, Number>::Indicators::
+                                       entropy_viscosity_commutator
+                               ? d_ij * (alpha_i + alpha_j) * Number(.5)
+                               : d_ij * std::max(alpha_i, alpha_j);
+
+        const auto m_ij = mass_matrix.get_entry(i, col_idx);
+        const auto b_ij =
+            (col_idx == 0 ? Number(1.) : Number(0.)) - m_ij * m_j_inv;
+        const auto b_ji =
+            (col_idx == 0 ? Number(1.) : Number(0.)) - m_ij * m_i_inv;
+
+        return tau_m_i_inv * lambda_inv *
+               ((d_ijH - d_ij) * (U_j - U_i) + b_ij * r_j - b_ji * r_i);
+      };
+    };
+
+    const auto p_ij_row_simd = [&](const unsigned int i) {
+      const unsigned int row_length = sparsity_simd.row_length(i);
+      const unsigned int *js = sparsity_simd.columns(i);
+
+      const auto U_i = U.get_vectorized_tensor(i);
+      const auto r_i = r.get_vectorized_tensor(i);
+      const auto alpha_i = simd_load(alpha_, i);
+      const auto m_i_inv = simd_load(lumped_mass_matrix_inverse, i);
+      const auto tau_m_i_inv =
+          local_time_stepping_
+              ? cfl_ / (Number(-2.) * dij_matrix_.get_vectorized_entry(i, 0))
+              : tau * m_i_inv;
+      const VA lambda_inv = Number(row_length - 1);
+
+      return [&, i, js, U_i, r_i, alpha_i, m_i_inv, tau_m_i_inv, lambda_inv](
+                 const unsigned int col_idx) {
+        const unsigned int *js_col = js + col_idx * simd_length;
+
+        const auto U_j = U.get_vectorized_tensor(js_col);
+        const auto r_j = r.get_vectorized_tensor(js_col);
+        const auto alpha_j = simd_load(alpha_, js_col);
+        const auto m_j_inv = simd_load(lumped_mass_matrix_inverse, js_col);
+
+        const auto d_ij = dij_matrix_.get_vectorized_entry(i, col_idx);
+        const auto d_ijH = Indicator<dim, Number>::indicator_ ==
+                                   Indicator<dim, Number>::Indicators::
+                                       entropy_viscosity_commutator
+                               ? d_ij * (alpha_i + alpha_j) * Number(.5)
+                               : d_ij * std::max(alpha_i, alpha_j);
+
+        const auto m_ij = mass_matrix.get_vectorized_entry(i, col_idx);
+        const auto b_ij = (col_idx == 0 ? VA(1.) : VA(0.)) - m_ij * m_j_inv;
+        const auto b_ji = (col_idx == 0 ? VA(1.) : VA(0.)) - m_ij * m_i_inv;
+
+        return tau_m_i_inv * lambda_inv *
+               ((d_ijH - d_ij) * (U_j - U_i) + b_ij * r_j - b_ji * r_i);
+      };
+    };
+
+    n_limiter_passes_ = 0;
+
     for (unsigned int pass = 0; pass < limiter_iter_; ++pass) {
 
       std::string step_no = std::to_string(5 + pass);
@@ -796,127 +2104,185 @@ namespace ryujin
           pass + 1 < limiter_iter_ ? ", next l_ij" : "";
       bool last_round = (pass + 1 == limiter_iter_);
 
+      ++n_limiter_passes_;
+
+      /* Minimal (symmetrized) l_ij of this pass for early termination: */
+      ThreadReduction<Number> l_ij_min_reduction(Number(1.));
+
       {
         Scope scope(computing_timer_,
                     "time step [E] " + step_no + " - " +
                         "symmetrize l_ij, h.-o. update" + additional_step);
 
         SynchronizationDispatch synchronization_dispatch([&]() {
-          if (!last_round)
-            lij_matrix_next_.update_ghost_rows_start(channel++);
+          if (!last_round) {
+            communication_progress_.start(
+                [&]() { lij_matrix_next_.update_ghost_rows_start(channel++); });
+          }
         });
 
+#ifdef USE_PIPELINED_COMMUNICATION
+        /*
+         * Complete the exchange of the l_ij ghost rows started in step 4
+         * (or in the previous limiter pass, followed by a swap):
+         */
+        SynchronizationWait synchronization_wait([&]() {
+          communication_progress_.complete(
+              [&]() { lij_matrix_.update_ghost_rows_finish(); });
+        });
+#endif
+
         RYUJIN_PARALLEL_REGION_BEGIN
+        CommunicationProgress::ComputeSection compute_section(
+            communication_progress_);
         LIKWID_MARKER_START(("time_step_" + step_no).c_str());
 
         /* Stored thread locally: */
         AlignedVector<Number> lij_row_serial;
+        AlignedVector<dealii::Tensor<1, problem_dimension, Number>>
+            pij_row_serial;
+        Number l_ij_min_on_thread = Number(1.);
 
         /* Parallel non-vectorized loop: */
-        RYUJIN_OMP_FOR_NOWAIT
-        for (unsigned int i = n_internal; i < n_owned; ++i) {
-
-          /* Skip constrained degrees of freedom: */
-          const unsigned int row_length = sparsity_simd.row_length(i);
-          if (row_length == 1)
-            continue;
-
-          lij_row_serial.resize_fast(row_length);
+        const auto serial_loop = [&]() {
+          const auto serial_range = offline_data_->serial_range(
+              omp_get_thread_num(), omp_get_num_threads());
+          for (unsigned int i = serial_range.first; i < serial_range.second;
+               ++i) {
 
-          auto U_i_new = temp_euler_.get_tensor(i);
+            /* Skip constrained degrees of freedom: */
+            const unsigned int row_length = sparsity_simd.row_length(i);
+            if (row_length == 1)
+              continue;
 
-          const Number lambda = Number(1.) / Number(row_length - 1);
+            lij_row_serial.resize_fast(row_length);
+            if (recompute_pij_ && !last_round)
+              pij_row_serial.resize_fast(row_length);
 
-          for (unsigned int col_idx = 0; col_idx < row_length; ++col_idx) {
-            auto p_ij = pij_matrix_.get_tensor(i, col_idx);
+            auto U_i_new = temp_euler.get_tensor(i);
 
-            const auto l_ij =
-                std::min(lij_matrix_.get_entry(i, col_idx),
-                         lij_matrix_.get_transposed_entry(i, col_idx));
+            const Number lambda = Number(1.) / Number(row_length - 1);
 
-            U_i_new += l_ij * lambda * p_ij;
+            const auto p_ij_serial = p_ij_row_serial(i);
 
-            if (!last_round)
-              lij_row_serial[col_idx] = l_ij;
-          }
+            for (unsigned int col_idx = 0; col_idx < row_length; ++col_idx) {
+              const auto p_ij = recompute_pij_
+                                    ? p_ij_serial(col_idx)
+                                    : pij_matrix_.get_tensor(i, col_idx);
 
-#ifdef CHECK_BOUNDS
-          const auto rho_new = problem_description_->density(U_i_new);
-          const auto e_new = problem_description_->internal_energy(U_i_new);
-          const auto s_new = problem_description_->specific_entropy(U_i_new);
+              const auto l_ij =
+                  std::min(lij_matrix_.get_entry(i, col_idx),
+                           lij_matrix_.get_transposed_entry(i, col_idx));
 
-          AssertThrowSIMD(
-              rho_new,
-              [](auto val) { return val > Number(0.); },
-              dealii::ExcMessage("Negative density."));
+              U_i_new += l_ij * lambda * p_ij;
 
-          AssertThrowSIMD(
-              e_new,
-              [](auto val) { return val > Number(0.); },
-              dealii::ExcMessage("Negative internal energy."));
+              if (!last_round) {
+                lij_row_serial[col_idx] = l_ij;
+                if (recompute_pij_)
+                  pij_row_serial[col_idx] = p_ij;
+                l_ij_min_on_thread = std::min(l_ij_min_on_thread, l_ij);
+              }
+            }
 
-          AssertThrowSIMD(
-              s_new,
-              [](auto val) { return val > Number(0.); },
-              dealii::ExcMessage("Negative specific entropy."));
+#ifdef CHECK_BOUNDS
+            const auto rho_new = problem_description_->density(U_i_new);
+            const auto e_new = problem_description_->internal_energy(U_i_new);
+            const auto s_new = problem_description_->specific_entropy(U_i_new);
+
+            AssertThrowSIMD(
+                rho_new,
+                [](auto val) { return val > Number(0.); },
+                dealii::ExcMessage("Negative density."));
+
+            AssertThrowSIMD(
+                e_new,
+                [](auto val) { return val > Number(0.); },
+                dealii::ExcMessage("Negative internal energy."));
+
+            AssertThrowSIMD(
+                s_new,
+                [](auto val) { return val > Number(0.); },
+                dealii::ExcMessage("Negative specific entropy."));
 #endif
 
-          temp_euler_.write_tensor(U_i_new, i);
+            temp_euler.write_tensor(U_i_new, i);
 
-          /* Skip computating l_ij and updating p_ij in the last round */
-          if (last_round)
-            continue;
+            /* Skip computating l_ij and updating p_ij in the last round */
+            if (last_round)
+              continue;
 
-          const auto bounds =
-              bounds_.template get_tensor<std::array<Number, 3>>(i);
+            const auto bounds =
+                bounds_.template get_tensor<std::array<Number, 3>>(i);
 
-          for (unsigned int col_idx = 0; col_idx < row_length; ++col_idx) {
-            const auto old_l_ij = lij_row_serial[col_idx];
-            const auto new_p_ij =
-                (Number(1.) - old_l_ij) * pij_matrix_.get_tensor(i, col_idx);
+            for (unsigned int col_idx = 0; col_idx < row_length; ++col_idx) {
+              const auto old_l_ij = lij_row_serial[col_idx];
+              const auto p_ij = recompute_pij_
+                                    ? pij_row_serial[col_idx]
+                                    : pij_matrix_.get_tensor(i, col_idx);
+              const auto new_p_ij = (Number(1.) - old_l_ij) * p_ij;
 
-            const auto new_l_ij = Limiter<dim, Number>::limit(
-                *problem_description_, bounds, U_i_new, new_p_ij);
+              const auto new_l_ij =
+                  Limiter<dim, Number>::template limit<limiter>(
+                      *problem_description_, bounds, U_i_new, new_p_ij);
 
-            /*
-             * FIXME: If this if statement causes too much of a performance
-             * penalty we could refactor it outside of the main loop.
-             */
-            if (RYUJIN_LIKELY(limiter_iter_ == 2)) {
-              /*
-               * Shortcut: We omit updating the p_ij vector and simply
-               * write (1 - l_ij^(1)) * l_ij^(2) into the l_ij matrix. This
-               * approach only works for two limiting steps.
-               */
-              lij_matrix_next_.write_entry(
-                  (Number(1.) - old_l_ij) * new_l_ij, i, col_idx);
-            } else {
               /*
-               * @todo: This is expensive. If we ever end up using more
-               * than two limiter passes we should implement this by
-               * storing a scalar factor instead of writing back into p_ij.
+               * FIXME: If this if statement causes too much of a performance
+               * penalty we could refactor it outside of the main loop.
                */
-              lij_matrix_next_.write_entry(new_l_ij, i, col_idx);
-              pij_matrix_.write_tensor(new_p_ij, i, col_idx);
+              if (RYUJIN_LIKELY(limiter_iter_ == 2)) {
+                /*
+                 * Shortcut: We omit updating the p_ij vector and simply
+                 * write (1 - l_ij^(1)) * l_ij^(2) into the l_ij matrix. This
+                 * approach only works for two limiting steps.
+                 */
+                lij_matrix_next_.write_entry(
+                    (Number(1.) - old_l_ij) * new_l_ij, i, col_idx);
+              } else {
+                /*
+                 * @todo: This is expensive. If we ever end up using more
+                 * than two limiter passes we should implement this by
+                 * storing a scalar factor instead of writing back into p_ij.
+                 */
+                lij_matrix_next_.write_entry(new_l_ij, i, col_idx);
+                pij_matrix_.write_tensor(new_p_ij, i, col_idx);
+              }
             }
-          }
-        } /* parallel non-vectorized loop */
+          } /* parallel non-vectorized loop */
+        };
+
+#ifndef USE_PIPELINED_COMMUNICATION
+        serial_loop();
+#endif
 
         /* Stored thread locally: */
         AlignedVector<VectorizedArray<Number>> lij_row_simd;
+        AlignedVector<dealii::Tensor<1, problem_dimension, VA>> pij_row_simd;
         bool thread_ready = false;
+#ifdef USE_PIPELINED_COMMUNICATION
+        bool thread_ready_wait = false;
+#endif
 
         /* Parallel vectorized loop: */
         RYUJIN_OMP_FOR
-        for (unsigned int i = 0; i < n_internal; i += simd_length) {
+        for (unsigned int ii = 0; ii < n_internal; ii += simd_length) {
 
+#ifdef USE_PIPELINED_COMMUNICATION
+          const unsigned int i = pipelined_index(ii);
+          synchronization_wait.wait(thread_ready_wait, i < n_export_simd);
+#else
+          const unsigned int i = ii;
           synchronization_dispatch.check(thread_ready, i >= n_export_indices);
+#endif
 
-          auto U_i_new = temp_euler_.get_vectorized_tensor(i);
+          auto U_i_new = temp_euler.get_vectorized_tensor(i);
 
           const unsigned int row_length = sparsity_simd.row_length(i);
           const Number lambda = Number(1.) / Number(row_length - 1);
           lij_row_simd.resize_fast(row_length);
+          if (recompute_pij_ && !last_round)
+            pij_row_simd.resize_fast(row_length);
+
+          const auto p_ij_simd = p_ij_row_simd(i);
 
           for (unsigned int col_idx = 0; col_idx < row_length; ++col_idx) {
 
@@ -924,12 +2290,19 @@ namespace ryujin
                 lij_matrix_.get_vectorized_entry(i, col_idx),
                 lij_matrix_.get_vectorized_transposed_entry(i, col_idx));
 
-            auto p_ij = pij_matrix_.get_vectorized_tensor(i, col_idx);
+            const auto p_ij =
+                recompute_pij_ ? p_ij_simd(col_idx)
+                               : pij_matrix_.get_vectorized_tensor(i, col_idx);
 
             U_i_new += l_ij * lambda * p_ij;
 
-            if (!last_round)
+            if (!last_round) {
               lij_row_simd[col_idx] = l_ij;
+              if (recompute_pij_)
+                pij_row_simd[col_idx] = p_ij;
+              for (unsigned int k = 0; k < simd_length; ++k)
+                l_ij_min_on_thread = std::min(l_ij_min_on_thread, l_ij[k]);
+            }
           }
 
 #ifdef CHECK_BOUNDS
@@ -952,7 +2325,7 @@ namespace ryujin
               [](auto val) { return val > Number(0.); },
               dealii::ExcMessage("Negative specific entropy."));
 #endif
-          temp_euler_.write_vectorized_tensor(U_i_new, i);
+          temp_euler.write_vectorized_tensor(U_i_new, i);
 
           /* Skip computating l_ij and updating p_ij in the last round */
           if (last_round)
@@ -964,10 +2337,12 @@ namespace ryujin
 
             const auto old_l_ij = lij_row_simd[col_idx];
 
-            const auto new_p_ij = (VA(1.) - old_l_ij) *
-                                  pij_matrix_.get_vectorized_tensor(i, col_idx);
+            const auto p_ij =
+                recompute_pij_ ? pij_row_simd[col_idx]
+                               : pij_matrix_.get_vectorized_tensor(i, col_idx);
+            const auto new_p_ij = (VA(1.) - old_l_ij) * p_ij;
 
-            const auto new_l_ij = Limiter<dim, VA>::limit(
+            const auto new_l_ij = Limiter<dim, VA>::template limit<limiter>(
                 *problem_description_, bounds, U_i_new, new_p_ij);
 
             /*
@@ -996,6 +2371,14 @@ namespace ryujin
           }
         }
 
+#ifdef USE_PIPELINED_COMMUNICATION
+        synchronization_wait.wait(thread_ready_wait, true);
+        serial_loop();
+        synchronization_dispatch.check(thread_ready, true);
+#endif
+
+        l_ij_min_reduction.local() = l_ij_min_on_thread;
+
         LIKWID_MARKER_STOP(("time_step_" + step_no).c_str());
         RYUJIN_PARALLEL_REGION_END
       }
@@ -1011,21 +2394,170 @@ namespace ryujin
 #endif
 
         if (!last_round) {
-          lij_matrix_next_.update_ghost_rows_finish();
+#ifndef USE_PIPELINED_COMMUNICATION
+          communication_progress_.complete(
+              [&]() { lij_matrix_next_.update_ghost_rows_finish(); });
+#endif
           std::swap(lij_matrix_, lij_matrix_next_);
         }
       }
+
+      /*
+       * Early termination: The remaining passes add at most a fraction
+       * of (1 - l_ij_min) of the antidiffusive fluxes:
+       */
+      if (!last_round && limiter_termination_tolerance_ > Number(0.)) {
+        const Number l_ij_min = l_ij_min_reduction.combine(
+            [](const Number a, const Number b) { return std::min(a, b); });
+        const Number global_l_ij_min =
+            Utilities::MPI::min(l_ij_min, mpi_communicator_);
+
+        if (Number(1.) - global_l_ij_min <= limiter_termination_tolerance_) {
+#ifdef USE_PIPELINED_COMMUNICATION
+          communication_progress_.complete(
+              [&]() { lij_matrix_.update_ghost_rows_finish(); });
+#endif
+          n_skipped_limiter_passes_ += limiter_iter_ - n_limiter_passes_;
+          break;
+        }
+      }
     } /* limiter_iter_ */
 
     /* And finally update the result: */
-    U.swap(temp_euler_);
+    U.swap(temp_euler);
 
     CALLGRIND_STOP_INSTRUMENTATION
 
+    record_kernel_statistics(/*complete*/ true);
+
     return tau_max;
   }
 
 
+  template <int dim, typename Number>
+  template <typename Bounds>
+  DEAL_II_ALWAYS_INLINE inline void
+  EulerModule<dim, Number>::widen_bounds(Bounds &bounds)
+  {
+    if constexpr (!std::is_same_v<bounds_number, Number>) {
+      constexpr auto eps = 4. * std::numeric_limits<bounds_number>::epsilon();
+      /* We always store [rho_min, rho_max, s_min, ...]: */
+      bounds[0] *= Number(1. - eps);
+      bounds[1] *= Number(1. + eps);
+      bounds[2] *= Number(1. - eps);
+    } else {
+      (void)bounds;
+    }
+  }
+
+
+  template <int dim, typename Number>
+  std::array<double, 4> EulerModule<dim, Number>::d_ij_traffic_estimates()
+  {
+    constexpr double N = sizeof(Number);
+    constexpr double I = sizeof(unsigned int);
+    constexpr double pd = problem_dimension;
+
+    return {{/* Step 1: */ (pd + 2.) * N,
+             (dim + pd + 2.) * N + I,
+             /* Step 2: */ 2. * N,
+             2. * N}};
+  }
+
+
+  template <int dim, typename Number>
+  std::array<double, 2> EulerModule<dim, Number>::d_ij_traffic_per_row() const
+  {
+    const double rows = offline_data_->n_locally_owned();
+    const double entries_per_row =
+        rows > 0. ? double(n_locally_owned_entries_) / rows : 0.;
+
+    const auto traffic = d_ij_traffic_estimates();
+    const double step_1 = traffic[0] + entries_per_row * traffic[1];
+    const double step_2 = traffic[2] + entries_per_row * traffic[3];
+
+    /* The fused sweep additionally writes d_ii: */
+    return {{step_1 + sizeof(Number), step_1 + step_2}};
+  }
+
+
+  template <int dim, typename Number>
+  void EulerModule<dim, Number>::record_kernel_statistics(const bool complete)
+  {
+    /*
+     * Per row and per entry estimates of the memory traffic and flops
+     * of the individual steps of single_step(). Column indices and
+     * neighboring states U_j are counted as if they had to be fetched
+     * from main memory. The flop counts of the Riemann solver and the
+     * limiter are rough averages.
+     */
+
+    constexpr double N = sizeof(Number);
+    constexpr double I = sizeof(unsigned int);
+    constexpr double pd = problem_dimension;
+    constexpr double n_bounds = Limiter<dim, Number>::n_bounds;
+
+    const double rows = offline_data_->n_locally_owned();
+    const double entries = n_locally_owned_entries_;
+
+    /* Step 0: U_i -> specific and evc entropies */
+    kernel_statistics_["time step [E] 0"].record(
+        rows, entries, (pd + 2.) * N, 0., 30., 0.);
+
+    const auto traffic = d_ij_traffic_estimates();
+
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+    /* Step 1: U_i, U_j, c_ij -> d_ij, d_ii, tau_max, alpha_i */
+    kernel_statistics_["time step [E] 1"].record(
+        rows, entries, traffic[0] + N, traffic[1], 22., 300.);
+#else
+    /* Step 1: U_i, U_j, c_ij -> d_ij, alpha_i */
+    kernel_statistics_["time step [E] 1"].record(
+        rows, entries, traffic[0], traffic[1], 20., 150.);
+
+    /* Step 2: d_ij, d_ji -> d_ii, tau_max */
+    kernel_statistics_["time step [E] 2"].record(
+        rows, entries, traffic[2], traffic[3], 2., 2.);
+#endif
+
+    if (!complete)
+      return;
+
+    /* Step 3: U_i, U_j, c_ij, d_ij, beta_ij -> U_new, bounds, r_i */
+    kernel_statistics_["time step [E] 3"].record(
+        rows,
+        entries,
+        (3. * pd + n_bounds) * N,
+        (dim + pd + 2.) * N + I,
+        20.,
+        pd * (4. + 2. * dim) + 20.);
+
+    if (limiter_iter_ == 0)
+      return;
+
+    /* Step 4: r_i, r_j, d_ij, beta_ij, bounds -> p_ij, l_ij */
+    kernel_statistics_["time step [E] 4"].record(
+        rows,
+        entries,
+        (pd + n_bounds) * N,
+        (2. * pd + 3.) * N + I,
+        0.,
+        6. * pd + 40.);
+
+    /* Steps 5, ...: p_ij, l_ij, l_ji -> high-order update (next l_ij) */
+    for (unsigned int pass = 0; pass < n_limiter_passes_; ++pass) {
+      const bool last_round = (pass + 1 == limiter_iter_);
+      kernel_statistics_["time step [E] " + std::to_string(5 + pass)].record(
+          rows,
+          entries,
+          2. * pd * N,
+          (pd + 2. + (last_round ? 0. : 1.)) * N + I,
+          0.,
+          3. * pd + (last_round ? 0. : 40.));
+    }
+  }
+
+
   template <int dim, typename Number>
   void EulerModule<dim, Number>::apply_boundary_conditions(vector_type &U,
                                                            Number t)
@@ -1035,84 +2567,152 @@ namespace ryujin
               << std::endl;
 #endif
 
-    const auto &boundary_map = offline_data_->boundary_map();
-    const unsigned int n_owned = offline_data_->n_locally_owned();
-
-    for (auto entry : boundary_map) {
-      const auto i = entry.first;
-      if (i >= n_owned)
-        continue;
-
-      const auto &[normal, id, position] = entry.second;
-
-      if (id == Boundary::do_nothing)
-        continue;
+    using VA = VectorizedArray<Number>;
+    constexpr auto simd_length = VA::size();
 
-      auto U_i = U.get_tensor(i);
+    /* Slip and no slip boundaries: */
+    const auto slip_batch = [&](const BoundaryList &list,
+                                const unsigned int b,
+                                const bool remove_normal) {
+      const unsigned int *js = list.indices.data() + b;
+      auto U_i = U.get_vectorized_tensor(js);
 
-      if (id == Boundary::slip ||
-          (id == Boundary::no_slip && !enforce_noslip_)) {
+      if (remove_normal) {
         /* Remove the normal component of the momentum: */
+        dealii::Tensor<1, dim, VA> normal;
+        for (unsigned int d = 0; d < dim; ++d)
+          normal[d].load(list.normals[d].data() + b);
         auto m = problem_description_->momentum(U_i);
-        m -= 1. * (m * normal) * normal;
+        m -= (m * normal) * normal;
         for (unsigned int k = 0; k < dim; ++k)
           U_i[k + 1] = m[k];
 
-      } else if (id == Boundary::no_slip) {
+      } else {
         /* Enforce no-slip conditions: */
         for (unsigned int k = 0; k < dim; ++k)
-          U_i[k + 1] = Number(0.);
+          U_i[k + 1] = VA(0.);
+      }
+
+      U.write_vectorized_tensor(U_i, js);
+    };
+
+    /* On Dirichlet boundaries enforce initial conditions: */
+    const auto dirichlet_batch = [&](const BoundaryList &list,
+                                     const unsigned int b) {
+      dealii::Point<dim, VA> position;
+      for (unsigned int d = 0; d < dim; ++d)
+        position[d].load(list.positions[d].data() + b);
+      U.write_vectorized_tensor(initial_values_->initial_state(position, t),
+                                list.indices.data() + b);
+    };
+
+    const auto dynamic_entry = [&](const BoundaryList &list,
+                                   const unsigned int n) {
+      const unsigned int i = list.indices[n];
+      dealii::Tensor<1, dim, Number> normal;
+      dealii::Point<dim> position;
+      for (unsigned int d = 0; d < dim; ++d) {
+        normal[d] = list.normals[d][n];
+        position[d] = list.positions[d][n];
+      }
+
+      auto U_i = U.get_tensor(i);
 
-      } else if (id == Boundary::dirichlet) {
-        /* On Dirichlet boundaries enforce initial conditions: */
+      /*
+       * On dynamic boundary conditions, we distinguish four cases:
+       *
+       *  - supersonic inflow: prescribe full state
+       *  - subsonic inflow:
+       *      decompose into Riemann invariants and leave R_2
+       *      characteristic untouched.
+       *  - supersonic outflow: do nothing
+       *  - subsonic outflow:
+       *      decompose into Riemann invariants and prescribe incoming
+       *      R_1 characteristic.
+       */
+      const auto m = problem_description_->momentum(U_i);
+      const auto rho = problem_description_->density(U_i);
+      const auto a = problem_description_->speed_of_sound(U_i);
+      const auto vn = m * normal / rho;
+
+      /* Supersonic inflow: */
+      if (vn < -a) {
         U_i = initial_values_->initial_state(position, t);
+      }
 
-      } else if (id == Boundary::dynamic) {
-        /*
-         * On dynamic boundary conditions, we distinguish four cases:
-         *
-         *  - supersonic inflow: prescribe full state
-         *  - subsonic inflow:
-         *      decompose into Riemann invariants and leave R_2
-         *      characteristic untouched.
-         *  - supersonic outflow: do nothing
-         *  - subsonic outflow:
-         *      decompose into Riemann invariants and prescribe incoming
-         *      R_1 characteristic.
-         */
-        const auto m = problem_description_->momentum(U_i);
-        const auto rho = problem_description_->density(U_i);
-        const auto a = problem_description_->speed_of_sound(U_i);
-        const auto vn = m * normal / rho;
-
-        /* Supersonic inflow: */
-        if (vn < -a) {
-          U_i = initial_values_->initial_state(position, t);
-        }
+      /* Subsonic inflow: */
+      if (vn >= -a && vn <= 0.) {
+        const auto U_i_bar = initial_values_->initial_state(position, t);
+        U_i = problem_description_->prescribe_riemann_characteristic<2>(
+            U_i_bar, U_i, normal);
+      }
 
-        /* Subsonic inflow: */
-        if (vn >= -a && vn <= 0.) {
-          const auto U_i_bar = initial_values_->initial_state(position, t);
-          U_i = problem_description_->prescribe_riemann_characteristic<2>(
-              U_i_bar, U_i, normal);
-        }
+      /* Subsonic outflow: */
+      if (vn > 0. && vn <= a) {
+        const auto U_i_bar = initial_values_->initial_state(position, t);
+        U_i = problem_description_->prescribe_riemann_characteristic<1>(
+            U_i, U_i_bar, normal);
+      }
 
-        /* Subsonic outflow: */
-        if (vn > 0. && vn <= a) {
-          const auto U_i_bar = initial_values_->initial_state(position, t);
-          U_i = problem_description_->prescribe_riemann_characteristic<1>(
-              U_i, U_i_bar, normal);
-        }
+      /* Supersonic outflow: */
+      if (vn > a) {
+        return;
+      }
 
-        /* Supersonic outflow: */
-        if (vn > a) {
-          continue;
+      U.write_tensor(U_i, i);
+    };
+
+    /*
+     * The indices of a layer are distinct, so all lists of a layer are
+     * processed without synchronization. If the initial state cannot be
+     * evaluated concurrently, Dirichlet and dynamic boundaries are
+     * handled by a single thread:
+     */
+
+    const bool thread_safe = initial_values_->thread_safe();
+
+    RYUJIN_PARALLEL_REGION_BEGIN
+
+    for (const auto &boundary_layer : boundary_layers_) {
+      for (const auto &it : boundary_layer) {
+        const auto id = it.first;
+        const auto &list = it.second;
+        const unsigned int n_entries = list.indices.size();
+
+        if (id == Boundary::slip || id == Boundary::no_slip) {
+          const bool remove_normal = id == Boundary::slip || !enforce_noslip_;
+          RYUJIN_OMP_FOR_NOWAIT
+          for (unsigned int b = 0; b < n_entries; b += simd_length)
+            slip_batch(list, b, remove_normal);
+
+        } else if (id == Boundary::dirichlet) {
+          if (thread_safe) {
+            RYUJIN_OMP_FOR_NOWAIT
+            for (unsigned int b = 0; b < n_entries; b += simd_length)
+              dirichlet_batch(list, b);
+          } else if (omp_get_thread_num() == 0) {
+            for (unsigned int b = 0; b < n_entries; b += simd_length)
+              dirichlet_batch(list, b);
+          }
+
+        } else if (id == Boundary::dynamic) {
+          if (thread_safe) {
+            RYUJIN_OMP_FOR_NOWAIT
+            for (unsigned int n = 0; n < n_entries; ++n)
+              dynamic_entry(list, n);
+          } else if (omp_get_thread_num() == 0) {
+            for (unsigned int n = 0; n < n_entries; ++n)
+              dynamic_entry(list, n);
+          }
         }
       }
 
-      U.write_tensor(U_i, i);
+      /* The next layer updates the same degrees of freedom: */
+      RYUJIN_OMP_BARRIER
     }
 
+    RYUJIN_PARALLEL_REGION_END
+
     U.update_ghost_values();
   }
 
@@ -1141,38 +2741,46 @@ namespace ryujin
     std::cout << "EulerModule<dim, Number>::ssph2_step()" << std::endl;
 #endif
 
+    const auto &vector_partitioner = offline_data_->vector_partitioner();
+    const auto temp_ssp_pointer =
+        scratch_vector_pool_->checkout<vector_type>(vector_partitioner);
+    auto &temp_ssp = *temp_ssp_pointer;
+
   restart_ssph2_step:
     /* This also copies ghost elements: */
-    temp_ssp_ = U;
+    temp_ssp = U;
 
     /* Step 1: U1 = U_old + tau * L(U_old) */
     Number tau_1 = single_step(U, tau_0);
     apply_boundary_conditions(U, t + tau_1);
 
-    AssertThrow(tau_1 * cfl_max_ / cfl_update_ >= tau_0,
+    AssertThrow(tau_1 * cfl_max_ / cfl_ >= tau_0,
                 ExcMessage("failed to recover from CFL violation"));
     tau_1 = (tau_0 == 0. ? tau_1 : tau_0);
 
     /* Step 2: U2 = 1/2 U_old + 1/2 (U1 + tau L(U1)) */
     const Number tau_2 = single_step(U, tau_1);
 
-    AssertThrow(tau_2 * cfl_max_ / cfl_update_ >= tau_0,
+    AssertThrow(tau_2 * cfl_max_ / cfl_ >= tau_0,
                 ExcMessage("failed to recover from CFL violation"));
 
-    if (tau_2 * cfl_max_ / cfl_update_ < tau_1) {
+    if (tau_2 * cfl_max_ / cfl_ < tau_1) {
       /* Restart and force smaller time step: */
 #ifdef DEBUG_OUTPUT
       std::cout << "        insufficient step size, restart" << std::endl;
 #endif
       tau_0 = tau_2;
-      U.swap(temp_ssp_);
+      U.swap(temp_ssp);
       ++n_restarts_;
+      adapt_cfl(Number(0.));
       goto restart_ssph2_step;
     }
 
-    U.sadd(Number(1. / 2.), Number(1. / 2.), temp_ssp_);
+    U.sadd(Number(1. / 2.), Number(1. / 2.), temp_ssp);
     apply_boundary_conditions(U, t + tau_1);
 
+    adapt_cfl(tau_2 * cfl_max_ / cfl_ / tau_1);
+
     return tau_1;
   }
 
@@ -1186,16 +2794,21 @@ namespace ryujin
     std::cout << "EulerModule<dim, Number>::ssprk3_step()" << std::endl;
 #endif
 
+    const auto &vector_partitioner = offline_data_->vector_partitioner();
+    const auto temp_ssp_pointer =
+        scratch_vector_pool_->checkout<vector_type>(vector_partitioner);
+    auto &temp_ssp = *temp_ssp_pointer;
+
   restart_ssprk3_step:
     /* This also copies ghost elements: */
-    temp_ssp_ = U;
+    temp_ssp = U;
 
     /* Step 1: U1 = U_old + tau * L(U_old) at time t + tau_1 */
 
     Number tau_1 = single_step(U, tau_0);
     apply_boundary_conditions(U, t + tau_1);
 
-    AssertThrow(tau_1 * cfl_max_ / cfl_update_ >= tau_0,
+    AssertThrow(tau_1 * cfl_max_ / cfl_ >= tau_0,
                 ExcMessage("failed to recover from CFL violation"));
     tau_1 = (tau_0 == 0. ? tau_1 : tau_0);
 
@@ -1203,48 +2816,175 @@ namespace ryujin
 
     const Number tau_2 = single_step(U, tau_1);
 
-    AssertThrow(tau_2 * cfl_max_ / cfl_update_ >= tau_0,
+    AssertThrow(tau_2 * cfl_max_ / cfl_ >= tau_0,
                 ExcMessage("failed to recover from CFL violation"));
 
-    if (tau_2 * cfl_max_ / cfl_update_ < tau_1) {
+    if (tau_2 * cfl_max_ / cfl_ < tau_1) {
       /* Restart and force smaller time step: */
 #ifdef DEBUG_OUTPUT
       std::cout << "        insufficient step size, restart" << std::endl;
 #endif
       tau_0 = tau_2;
-      U.swap(temp_ssp_);
+      U.swap(temp_ssp);
       ++n_restarts_;
+      adapt_cfl(Number(0.));
       goto restart_ssprk3_step;
     }
 
-    U.sadd(Number(1. / 4.), Number(3. / 4.), temp_ssp_);
+    U.sadd(Number(1. / 4.), Number(3. / 4.), temp_ssp);
     apply_boundary_conditions(U, t + 0.5 * tau_1);
 
     /* Step 3: U_new = 1/3 U_old + 2/3 (U2 + tau L(U2)) at time t + tau_1 */
 
     const Number tau_3 = single_step(U, tau_1);
 
-    AssertThrow(tau_3 * cfl_max_ / cfl_update_ >= tau_0,
+    AssertThrow(tau_3 * cfl_max_ / cfl_ >= tau_0,
                 ExcMessage("failed to recover from CFL violation"));
 
-    if (tau_3 * cfl_max_ < tau_1 * cfl_update_) {
+    if (tau_3 * cfl_max_ < tau_1 * cfl_) {
       /* Restart and force smaller time step: */
 #ifdef DEBUG_OUTPUT
       std::cout << "        insufficient step size, restart" << std::endl;
 #endif
       tau_0 = tau_3;
-      U.swap(temp_ssp_);
+      U.swap(temp_ssp);
       ++n_restarts_;
+      adapt_cfl(Number(0.));
       goto restart_ssprk3_step;
     }
 
-    U.sadd(Number(2. / 3.), Number(1. / 3.), temp_ssp_);
+    U.sadd(Number(2. / 3.), Number(1. / 3.), temp_ssp);
     apply_boundary_conditions(U, t + tau_1);
 
+    adapt_cfl(std::min(tau_2, tau_3) * cfl_max_ / cfl_ / tau_1);
+
     return tau_1;
   }
 
 
+  template <int dim, typename Number>
+  Number EulerModule<dim, Number>::ssprk104_step(vector_type &U,
+                                                 Number t,
+                                                 Number tau_0 /*= 0*/)
+  {
+#ifdef DEBUG_OUTPUT
+    std::cout << "EulerModule<dim, Number>::ssprk104_step()" << std::endl;
+#endif
+
+    /*
+     * The scheme consists of ten forward Euler stages of size tau_1 =
+     * tau / 6 (the SSP coefficient is 6) and only needs two registers:
+     *
+     *   q_1 = q_2 = U_old
+     *   for s = 1, ..., 5:  q_1 = q_1 + tau_1 L(q_1)
+     *   q_2 = 1/25 q_2 + 9/25 q_1
+     *   q_1 = 15 q_2 - 5 q_1
+     *   for s = 6, ..., 9:  q_1 = q_1 + tau_1 L(q_1)
+     *   U_new = q_2 + 3/5 (q_1 + tau_1 L(q_1))
+     *
+     * We store q_1 in U and q_2 in temp_ssp. The state U_old is lost
+     * after the fifth stage, so we additionally keep a copy in
+     * temp_ssp_restart in order to be able to restart.
+     */
+
+    Number tau_s = tau_0 / Number(6.);
+
+    const auto &vector_partitioner = offline_data_->vector_partitioner();
+    const auto temp_ssp_pointer =
+        scratch_vector_pool_->checkout<vector_type>(vector_partitioner);
+    const auto temp_ssp_restart_pointer =
+        scratch_vector_pool_->checkout<vector_type>(vector_partitioner);
+    auto &temp_ssp = *temp_ssp_pointer;
+    auto &temp_ssp_restart = *temp_ssp_restart_pointer;
+
+  restart_ssprk104_step:
+    /* This also copies ghost elements: */
+    temp_ssp = U;
+    temp_ssp_restart = U;
+
+    Number tau_1 = Number(0.);
+    Number tau_min = std::numeric_limits<Number>::max();
+
+    for (unsigned int s = 0; s < 10; ++s) {
+      const Number tau = single_step(U, tau_1 == Number(0.) ? tau_s : tau_1);
+
+      AssertThrow(tau * cfl_max_ / cfl_ >= tau_s,
+                  ExcMessage("failed to recover from CFL violation"));
+
+      if (s == 0) {
+        tau_1 = (tau_s == Number(0.) ? tau : tau_s);
+
+      } else {
+        if (tau * cfl_max_ / cfl_ < tau_1) {
+          /* Restart and force smaller time step: */
+#ifdef DEBUG_OUTPUT
+          std::cout << "        insufficient step size, restart" << std::endl;
+#endif
+          tau_s = tau;
+          U.swap(temp_ssp_restart);
+          ++n_restarts_;
+          adapt_cfl(Number(0.));
+          goto restart_ssprk104_step;
+        }
+        tau_min = std::min(tau_min, tau);
+      }
+
+      if (s < 4) {
+        apply_boundary_conditions(U, t + Number(s + 1) * tau_1);
+
+      } else if (s == 4) {
+        temp_ssp.sadd(Number(1. / 25.), Number(9. / 25.), U);
+        U.sadd(Number(-5.), Number(15.), temp_ssp);
+        apply_boundary_conditions(U, t + Number(2.) * tau_1);
+
+      } else if (s < 9) {
+        apply_boundary_conditions(U, t + Number(s - 2) * tau_1);
+
+      } else {
+        U.sadd(Number(3. / 5.), Number(1.), temp_ssp);
+        apply_boundary_conditions(U, t + Number(6.) * tau_1);
+      }
+    }
+
+    adapt_cfl(tau_min * cfl_max_ / cfl_ / tau_1);
+
+    return Number(6.) * tau_1;
+  }
+
+
+  template <int dim, typename Number>
+  void EulerModule<dim, Number>::adapt_cfl(const Number cfl_margin)
+  {
+    if (!cfl_adaptive_)
+      return;
+
+    /*
+     * The target margin between the chosen time step size and the
+     * maximal admissible time step size over all stages:
+     */
+    const Number target = cfl_max_ / cfl_update_;
+
+    if (cfl_margin < Number(1.)) {
+      /* We had to restart, back off: */
+      cfl_ *= Number(0.8);
+      cfl_margin_previous_ = target;
+
+    } else {
+      /*
+       * A PI controller in the spirit of Gustafsson, Lundh and Soderlind
+       * with the margin playing the role of the inverse error:
+       */
+      constexpr Number k_I = 0.3;
+      constexpr Number k_P = 0.4;
+      cfl_ *= std::pow(cfl_margin / target, k_I) *
+              std::pow(cfl_margin / cfl_margin_previous_, k_P);
+      cfl_margin_previous_ = cfl_margin;
+    }
+
+    cfl_ = std::max(Number(0.1) * cfl_update_, std::min(cfl_, cfl_max_));
+  }
+
+
   template <int dim, typename Number>
   Number
   EulerModule<dim, Number>::step(vector_type &U, Number t, Number tau /*= 0*/)
@@ -1260,16 +3000,78 @@ namespace ryujin
       return ssph2_step(U, t, tau);
     case 3:
       return ssprk3_step(U, t, tau);
+    case 4:
+      return ssprk104_step(U, t, tau);
     default:
       AssertThrow(false,
                   ExcMessage("The chosen order of the time stepping method "
-                             "must be in the interval [1, 3]"));
+                             "must be in the interval [1, 4]"));
       __builtin_trap();
     }
 
     __builtin_unreachable();
   }
 
+  template <int dim, typename Number>
+  MPI_Op EulerModule<dim, Number>::integrals_reduction_operation()
+  {
+    /*
+     * Sum all but the last two entries of the buffer and take the
+     * minimum of the last two entries (the minimal specific entropy and
+     * internal energy):
+     */
+    static const MPI_Op operation = []() {
+      MPI_Op result;
+      MPI_Op_create(
+          [](void *in, void *inout, int *length, MPI_Datatype *) {
+            const auto *source = static_cast<const double *>(in);
+            auto *destination = static_cast<double *>(inout);
+            for (int k = 0; k < *length - 2; ++k)
+              destination[k] += source[k];
+            for (int k = *length - 2; k < *length; ++k)
+              destination[k] = std::min(destination[k], source[k]);
+          },
+          /* commutative */ 1,
+          &result);
+      return result;
+    }();
+
+    return operation;
+  }
+
+
+  template <int dim, typename Number>
+  auto EulerModule<dim, Number>::integrals() -> const integrals_type &
+  {
+    if (integrals_request_ == MPI_REQUEST_NULL)
+      return integrals_;
+
+    MPI_Wait(&integrals_request_, MPI_STATUS_IGNORE);
+
+    for (unsigned int c = 0; c < problem_dimension; ++c)
+      integrals_.state[c] = integrals_buffer_[c];
+    integrals_.internal_energy = integrals_buffer_[problem_dimension];
+    integrals_.pressure = integrals_buffer_[problem_dimension + 1];
+    integrals_.s_min = integrals_buffer_[problem_dimension + 2];
+    integrals_.e_min = integrals_buffer_[problem_dimension + 3];
+
+    return integrals_;
+  }
+
+
+  template <int dim, typename Number>
+  Number EulerModule<dim, Number>::residual()
+  {
+    if (residual_request_ == MPI_REQUEST_NULL)
+      return residual_;
+
+    MPI_Wait(&residual_request_, MPI_STATUS_IGNORE);
+    residual_ = std::sqrt(residual_buffer_);
+
+    return residual_;
+  }
+
+
   template <int dim, typename Number>
   void EulerModule<dim, Number>::compute_residual_mu()
   {
@@ -1300,4 +3102,47 @@ namespace ryujin
   }
 
 
+  template <int dim, typename Number>
+  std::vector<unsigned long>
+  EulerModule<dim, Number>::cfl_classes(const unsigned int n_classes) const
+  {
+#ifdef DEBUG_OUTPUT
+    std::cout << "EulerModule<dim, Number>::cfl_classes()" << std::endl;
+#endif
+
+    Assert(n_classes > 0, ExcMessage("need at least one CFL class"));
+
+    const unsigned int n_owned = offline_data_->n_locally_owned();
+    const auto &sparsity_simd = offline_data_->sparsity_pattern_simd();
+    const auto &lumped_mass_matrix = offline_data_->lumped_mass_matrix();
+
+    const auto local_tau = [&](const unsigned int i) {
+      const Number mass = lumped_mass_matrix.local_element(i);
+      const Number d_ii = dij_matrix_.get_entry(i, 0);
+      return cfl_ * mass / (Number(-2.) * d_ii);
+    };
+
+    Number tau_min = std::numeric_limits<Number>::max();
+    for (unsigned int i = 0; i < n_owned; ++i) {
+      /* Skip constrained degrees of freedom: */
+      if (sparsity_simd.row_length(i) == 1)
+        continue;
+      tau_min = std::min(tau_min, local_tau(i));
+    }
+    tau_min = Utilities::MPI::min(tau_min, mpi_communicator_);
+
+    std::vector<unsigned long> classes(n_classes, 0);
+    for (unsigned int i = 0; i < n_owned; ++i) {
+      if (sparsity_simd.row_length(i) == 1)
+        continue;
+      const Number ratio = local_tau(i) / tau_min;
+      const auto k = static_cast<unsigned int>(
+          std::max(Number(0.), std::floor(std::log2(ratio))));
+      classes[std::min(k, n_classes - 1)]++;
+    }
+
+    return Utilities::MPI::sum(classes, mpi_communicator_);
+  }
+
+
 } /* namespace ryujin */
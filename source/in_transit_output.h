@@ -0,0 +1,521 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include "checkpointing.h"
+#include "multicomponent_vector.h"
+#include "offline_data.h"
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/utilities.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ryujin
+{
+  /**
+   * In-transit output: Dedicated I/O server ranks that receive snapshots
+   * of the state from the compute ranks and write them out off the
+   * critical path of the computation.
+   *
+   * The constructor splits @p mpi_communicator: On every shared-memory
+   * node the last @p n_servers_per_node ranks become I/O servers, all
+   * other ranks are compute ranks. Every compute rank is assigned to one
+   * server on the same node (round robin). communicator() returns the
+   * communicator of all compute ranks (or of all servers) that has to be
+   * used for everything else.
+   *
+   * A compute rank pushes a snapshot with push(): It announces the size
+   * of its locally owned data, receives the address of a staging buffer
+   * of its server, and transfers the state and the support points with a
+   * one-sided MPI_Put() into a dynamic RMA window. The transfer is an
+   * intra-node copy and is the only cost on the compute side; push()
+   * only blocks if the server is still busy writing the previous
+   * snapshot (back pressure).
+   *
+   * A server runs serve(): Once all of its clients have deposited a
+   * snapshot, all servers write it collectively into a single file with
+   * the layout of do_checkpoint_collective(). A snapshot can thus be used
+   * to resume a computation (after renaming it to
+   * "base_name-checkpoint.data") and be post-processed independently of
+   * the number of ranks it was written with.
+   *
+   * If @p n_servers_per_node is zero, in-transit output is disabled and
+   * communicator() is simply a duplicate of @p mpi_communicator.
+   *
+   * @note The constructor and the destructor are collective over all MPI
+   * ranks of @p mpi_communicator. A compute rank has to call finish()
+   * (or the destructor) after its last push() to terminate its server.
+   *
+   * @ingroup Miscellaneous
+   */
+  class InTransitOutput
+  {
+  public:
+    /**
+     * Constructor.
+     */
+    InTransitOutput(const MPI_Comm &mpi_communicator,
+                    const unsigned int n_servers_per_node);
+
+    InTransitOutput(const InTransitOutput &) = delete;
+    InTransitOutput &operator=(const InTransitOutput &) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~InTransitOutput();
+
+    /**
+     * Return whether in-transit output is enabled.
+     */
+    bool enabled() const
+    {
+      return n_servers_per_node_ > 0;
+    }
+
+    /**
+     * Return whether this rank is an I/O server.
+     */
+    bool is_server() const
+    {
+      return is_server_;
+    }
+
+    /**
+     * Return the communicator of all compute ranks (on a compute rank),
+     * or of all I/O servers (on a server).
+     */
+    const MPI_Comm &communicator() const
+    {
+      return local_communicator_;
+    }
+
+    /**
+     * Push a snapshot of the locally owned part of the state @p U at
+     * time @p t and output cycle @p output_cycle to the server. The
+     * server writes the snapshot of all compute ranks into the file
+     * "base_name-cycle.data". The function has to be called by all
+     * compute ranks.
+     */
+    template <int dim, typename Number, int n_components>
+    void push(const std::string &base_name,
+              const OfflineData<dim, Number> &offline_data,
+              const MultiComponentVector<Number, n_components> &U,
+              const Number t,
+              const unsigned int output_cycle);
+
+    /**
+     * Terminate the server of this compute rank. Called by the destructor
+     * if necessary.
+     */
+    void finish();
+
+    /**
+     * Serve the clients of this I/O server until all of them have called
+     * finish().
+     */
+    void serve();
+
+  private:
+    struct Header {
+      char name[256];
+      std::uint64_t dim;
+      std::uint64_t n_components;
+      std::uint64_t n_owned;
+      std::uint64_t first;
+      std::uint64_t n_global_dofs;
+      std::uint64_t n_mpi_processes;
+      std::uint64_t output_cycle;
+      std::uint64_t terminate;
+      double t;
+    };
+
+    enum Tags : int { header_tag = 0, address_tag, done_tag };
+
+    /**
+     * Write the snapshot described by @p headers (one per client) and
+     * held in @p buffer collectively with all other servers.
+     */
+    void write_snapshot(const std::vector<Header> &headers,
+                        const std::vector<std::size_t> &offsets,
+                        const std::vector<double> &buffer) const;
+
+    const unsigned int n_servers_per_node_;
+    bool is_server_;
+    bool finished_;
+
+    MPI_Comm communicator_;
+    MPI_Comm local_communicator_;
+    MPI_Win window_;
+
+    int server_;               /* world rank of our server (client) */
+    std::vector<int> clients_; /* world ranks of our clients (server) */
+
+    std::vector<double> promoted_;
+    std::vector<double> coordinates_;
+  };
+
+
+  /* Inline function definitions: */
+
+  inline InTransitOutput::InTransitOutput(
+      const MPI_Comm &mpi_communicator, const unsigned int n_servers_per_node)
+      : n_servers_per_node_(n_servers_per_node)
+      , is_server_(false)
+      , finished_(false)
+      , communicator_(MPI_COMM_NULL)
+      , window_(MPI_WIN_NULL)
+      , server_(-1)
+  {
+    int ierr;
+    if (!enabled()) {
+      ierr = MPI_Comm_dup(mpi_communicator, &local_communicator_);
+      AssertThrowMPI(ierr);
+      return;
+    }
+
+    ierr = MPI_Comm_dup(mpi_communicator, &communicator_);
+    AssertThrowMPI(ierr);
+
+    const int this_rank =
+        dealii::Utilities::MPI::this_mpi_process(communicator_);
+
+    MPI_Comm node_communicator;
+    ierr = MPI_Comm_split_type(communicator_,
+                               MPI_COMM_TYPE_SHARED,
+                               this_rank,
+                               MPI_INFO_NULL,
+                               &node_communicator);
+    AssertThrowMPI(ierr);
+
+    const unsigned int node_rank =
+        dealii::Utilities::MPI::this_mpi_process(node_communicator);
+    const unsigned int node_size =
+        dealii::Utilities::MPI::n_mpi_processes(node_communicator);
+
+    AssertThrow(node_size >= 2 * n_servers_per_node_,
+                dealii::ExcMessage(
+                    "In-transit output needs at least as many compute ranks "
+                    "as I/O ranks on every node"));
+
+    const unsigned int n_compute = node_size - n_servers_per_node_;
+    is_server_ = node_rank >= n_compute;
+
+    std::vector<int> node_ranks(node_size);
+    ierr = MPI_Allgather(&this_rank,
+                         1,
+                         MPI_INT,
+                         node_ranks.data(),
+                         1,
+                         MPI_INT,
+                         node_communicator);
+    AssertThrowMPI(ierr);
+    MPI_Comm_free(&node_communicator);
+
+    if (is_server_) {
+      const unsigned int s = node_rank - n_compute;
+      for (unsigned int c = 0; c < n_compute; ++c)
+        if (c % n_servers_per_node_ == s)
+          clients_.push_back(node_ranks[c]);
+    } else {
+      server_ = node_ranks[n_compute + node_rank % n_servers_per_node_];
+    }
+
+    ierr = MPI_Comm_split(
+        communicator_, is_server_ ? 1 : 0, this_rank, &local_communicator_);
+    AssertThrowMPI(ierr);
+
+    ierr = MPI_Win_create_dynamic(MPI_INFO_NULL, communicator_, &window_);
+    AssertThrowMPI(ierr);
+
+    ierr = MPI_Win_lock_all(MPI_MODE_NOCHECK, window_);
+    AssertThrowMPI(ierr);
+  }
+
+
+  inline InTransitOutput::~InTransitOutput()
+  {
+    if (enabled()) {
+      if (!is_server_)
+        finish();
+
+      int ierr = MPI_Win_unlock_all(window_);
+      AssertNothrow(ierr == MPI_SUCCESS, dealii::ExcInternalError());
+      ierr = MPI_Win_free(&window_);
+      AssertNothrow(ierr == MPI_SUCCESS, dealii::ExcInternalError());
+      MPI_Comm_free(&communicator_);
+      (void)ierr;
+    }
+
+    MPI_Comm_free(&local_communicator_);
+  }
+
+
+  template <int dim, typename Number, int n_components>
+  void
+  InTransitOutput::push(const std::string &base_name,
+                        const OfflineData<dim, Number> &offline_data,
+                        const MultiComponentVector<Number, n_components> &U,
+                        const Number t,
+                        const unsigned int output_cycle)
+  {
+    Assert(enabled() && !is_server_ && !finished_,
+           dealii::ExcInternalError());
+
+    const auto &locally_owned = offline_data.dof_handler().locally_owned_dofs();
+    const unsigned int n_owned = offline_data.n_locally_owned();
+
+    const std::string name = base_name + "-" +
+                             dealii::Utilities::to_string(output_cycle, 6) +
+                             ".data";
+    AssertThrow(name.size() < sizeof(Header::name),
+                dealii::ExcMessage("File name too long: " + name));
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::strcpy(header.name, name.c_str());
+    header.dim = dim;
+    header.n_components = n_components;
+    header.n_owned = n_owned;
+    header.first = n_owned > 0 ? locally_owned.nth_index_in_set(0) : 0;
+    header.n_global_dofs = locally_owned.size();
+    header.n_mpi_processes =
+        dealii::Utilities::MPI::n_mpi_processes(local_communicator_);
+    header.output_cycle = output_cycle;
+    header.t = t;
+
+    int ierr = MPI_Send(&header,
+                        sizeof(header),
+                        MPI_BYTE,
+                        server_,
+                        header_tag,
+                        communicator_);
+    AssertThrowMPI(ierr);
+
+    /* Prepare the data while the server sets up the staging buffer: */
+
+    const double *data = nullptr;
+    if constexpr (std::is_same_v<Number, double>) {
+      data = U.begin();
+    } else {
+      promoted_.assign(U.begin(), U.begin() + n_owned * n_components);
+      data = promoted_.data();
+    }
+
+    const auto points = locally_owned_support_points(offline_data);
+    coordinates_.resize(dim * n_owned);
+    for (unsigned int i = 0; i < n_owned; ++i)
+      for (unsigned int d = 0; d < dim; ++d)
+        coordinates_[i * dim + d] = points[i][d];
+
+    MPI_Aint address;
+    ierr = MPI_Recv(&address,
+                    1,
+                    MPI_AINT,
+                    server_,
+                    address_tag,
+                    communicator_,
+                    MPI_STATUS_IGNORE);
+    AssertThrowMPI(ierr);
+
+    const int n_state = n_owned * n_components;
+    ierr = MPI_Put(data,
+                   n_state,
+                   MPI_DOUBLE,
+                   server_,
+                   address,
+                   n_state,
+                   MPI_DOUBLE,
+                   window_);
+    AssertThrowMPI(ierr);
+
+    ierr = MPI_Put(coordinates_.data(),
+                   coordinates_.size(),
+                   MPI_DOUBLE,
+                   server_,
+                   address + n_state * sizeof(double),
+                   coordinates_.size(),
+                   MPI_DOUBLE,
+                   window_);
+    AssertThrowMPI(ierr);
+
+    ierr = MPI_Win_flush(server_, window_);
+    AssertThrowMPI(ierr);
+
+    ierr = MPI_Send(nullptr, 0, MPI_BYTE, server_, done_tag, communicator_);
+    AssertThrowMPI(ierr);
+  }
+
+
+  inline void InTransitOutput::finish()
+  {
+    if (!enabled() || is_server_ || finished_)
+      return;
+    finished_ = true;
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    header.terminate = 1;
+
+    const int ierr = MPI_Send(&header,
+                              sizeof(header),
+                              MPI_BYTE,
+                              server_,
+                              header_tag,
+                              communicator_);
+    AssertThrowMPI(ierr);
+  }
+
+
+  inline void InTransitOutput::serve()
+  {
+    Assert(enabled() && is_server_, dealii::ExcInternalError());
+
+    std::vector<Header> headers(clients_.size());
+    std::vector<std::size_t> offsets(clients_.size() + 1);
+    std::vector<double> buffer;
+    bool attached = false;
+
+    int ierr;
+    for (;;) {
+      for (unsigned int k = 0; k < clients_.size(); ++k) {
+        ierr = MPI_Recv(&headers[k],
+                        sizeof(Header),
+                        MPI_BYTE,
+                        clients_[k],
+                        header_tag,
+                        communicator_,
+                        MPI_STATUS_IGNORE);
+        AssertThrowMPI(ierr);
+      }
+
+      /* All clients push the same sequence of snapshots: */
+      if (headers[0].terminate != 0)
+        break;
+
+      offsets[0] = 0;
+      for (unsigned int k = 0; k < clients_.size(); ++k)
+        offsets[k + 1] = offsets[k] + headers[k].n_owned *
+                                          (headers[k].n_components +
+                                           headers[k].dim);
+
+      /* (Re)attach a large enough staging buffer: */
+      if (!attached || buffer.size() < offsets.back()) {
+        if (attached)
+          MPI_Win_detach(window_, buffer.data());
+        buffer.resize(std::max<std::size_t>(offsets.back(), 1));
+        ierr = MPI_Win_attach(
+            window_, buffer.data(), buffer.size() * sizeof(double));
+        AssertThrowMPI(ierr);
+        attached = true;
+      }
+
+      for (unsigned int k = 0; k < clients_.size(); ++k) {
+        MPI_Aint address;
+        MPI_Get_address(buffer.data() + offsets[k], &address);
+        ierr = MPI_Send(&address,
+                        1,
+                        MPI_AINT,
+                        clients_[k],
+                        address_tag,
+                        communicator_);
+        AssertThrowMPI(ierr);
+      }
+
+      for (unsigned int k = 0; k < clients_.size(); ++k) {
+        ierr = MPI_Recv(nullptr,
+                        0,
+                        MPI_BYTE,
+                        clients_[k],
+                        done_tag,
+                        communicator_,
+                        MPI_STATUS_IGNORE);
+        AssertThrowMPI(ierr);
+      }
+
+      /* Make the data deposited by MPI_Put() visible: */
+      MPI_Win_sync(window_);
+
+      write_snapshot(headers, offsets, buffer);
+    }
+
+    if (attached)
+      MPI_Win_detach(window_, buffer.data());
+  }
+
+
+  inline void
+  InTransitOutput::write_snapshot(const std::vector<Header> &headers,
+                                  const std::vector<std::size_t> &offsets,
+                                  const std::vector<double> &buffer) const
+  {
+    const auto &front = headers[0];
+    const std::string name = front.name;
+
+    MPI_File file;
+    int ierr = MPI_File_open(local_communicator_,
+                             name.c_str(),
+                             MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                             MPI_INFO_NULL,
+                             &file);
+    AssertThrow(ierr == MPI_SUCCESS,
+                dealii::ExcMessage("Could not open snapshot file " + name));
+
+    if (dealii::Utilities::MPI::this_mpi_process(local_communicator_) == 0) {
+      CollectiveCheckpointHeader header;
+      std::memset(&header, 0, sizeof(header));
+      std::memcpy(header.magic, collective_checkpoint_magic, 16);
+      header.dim = front.dim;
+      header.n_components = front.n_components;
+      header.sizeof_number = sizeof(double);
+      header.n_global_dofs = front.n_global_dofs;
+      header.n_mpi_processes = front.n_mpi_processes;
+      header.output_cycle = front.output_cycle;
+      header.t = front.t;
+      MPI_File_write_at(
+          file, 0, &header, sizeof(header), MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+
+    for (unsigned int k = 0; k < headers.size(); ++k) {
+      const auto &h = headers[k];
+      const double *state = buffer.data() + offsets[k];
+      const double *points = state + h.n_owned * h.n_components;
+
+      ierr = MPI_File_write_at(
+          file,
+          collective_checkpoint_offset +
+              MPI_Offset(h.first) * h.n_components * sizeof(double),
+          state,
+          h.n_owned * h.n_components,
+          MPI_DOUBLE,
+          MPI_STATUS_IGNORE);
+      AssertThrow(ierr == MPI_SUCCESS,
+                  dealii::ExcMessage("Could not write snapshot file " + name));
+
+      ierr = MPI_File_write_at(
+          file,
+          collective_checkpoint_offset +
+              MPI_Offset(h.n_global_dofs) * h.n_components * sizeof(double) +
+              MPI_Offset(h.first) * h.dim * sizeof(double),
+          points,
+          h.n_owned * h.dim,
+          MPI_DOUBLE,
+          MPI_STATUS_IGNORE);
+      AssertThrow(ierr == MPI_SUCCESS,
+                  dealii::ExcMessage("Could not write snapshot file " + name));
+    }
+
+    MPI_File_close(&file);
+  }
+
+} // namespace ryujin
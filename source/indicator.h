@@ -93,6 +93,12 @@ namespace ryujin
      */
     using ScalarNumber = typename get_value_type<Number>::type;
 
+    /**
+     * Type used to store the per state quantities computed by
+     * precompute(): the velocity and the pressure.
+     */
+    using precomputed_type = dealii::Tensor<1, dim + 1, Number>;
+
     /**
      * An enum describing different indicator strategies
      */
@@ -224,6 +230,26 @@ namespace ryujin
              const dealii::Tensor<1, dim, Number> &c_ij,
              const Number beta_ij,
              const Number entropy_j);
+
+    /**
+     * Return the velocity and the pressure of the state @p U (as used in
+     * the flux f(U)). This is computed once per state (in Step 0 of the
+     * EulerModule) so that add() does not need to perform any divisions.
+     */
+    precomputed_type precompute(const rank1_type &U) const;
+
+    /**
+     * Variant of add() that takes the velocity and the pressure of U_j
+     * precomputed by precompute(). The flux \f$\mathbf{f}(\boldsymbol
+     * U_j)\cdot\boldsymbol c_{ij}\f$ and the entropy flux
+     * \f$\eta(\boldsymbol U_j)\,\boldsymbol v_j\cdot\boldsymbol
+     * c_{ij}\f$ are then formed with multiply-adds only.
+     */
+    void add(const rank1_type &U_j,
+             const dealii::Tensor<1, dim, Number> &c_ij,
+             const Number beta_ij,
+             const Number entropy_j,
+             const precomputed_type &precomputed_j);
     /**
      * Return the computed alpha_i value.
      */
@@ -252,6 +278,7 @@ namespace ryujin
 
     Number left = 0.;
     rank1_type right;
+    dealii::Tensor<1, dim, Number> c_sum; // sum of c_ij of precomputed add()
 
     /* Temporary storage used for the smoothness indicator: */
 
@@ -287,6 +314,7 @@ namespace ryujin
 
       left = 0.;
       right = 0.;
+      c_sum = 0.;
     }
 
     if constexpr (indicator_ == Indicators::smoothness_indicator) {
@@ -362,6 +390,67 @@ namespace ryujin
   }
 
 
+  template <int dim, typename Number>
+  DEAL_II_ALWAYS_INLINE inline typename Indicator<dim, Number>::precomputed_type
+  Indicator<dim, Number>::precompute(const rank1_type &U) const
+  {
+    const auto rho_inverse = Number(1.) / problem_description.density(U);
+    const auto m = problem_description.momentum(U);
+
+    precomputed_type result;
+    for (unsigned int d = 0; d < dim; ++d)
+      result[d] = m[d] * rho_inverse;
+    result[dim] = problem_description.acoustic_splitting()
+                      ? Number(0.)
+                      : problem_description.pressure(U);
+    return result;
+  }
+
+
+  template <int dim, typename Number>
+  DEAL_II_ALWAYS_INLINE inline void
+  Indicator<dim, Number>::add(const rank1_type &U_j,
+                              const dealii::Tensor<1, dim, Number> &c_ij,
+                              const Number beta_ij,
+                              const Number entropy_j,
+                              const precomputed_type &precomputed_j)
+  {
+    if constexpr (indicator_ != Indicators::entropy_viscosity_commutator) {
+      add(U_j, c_ij, beta_ij, entropy_j);
+      return;
+    }
+
+    const auto m_j = problem_description.momentum(U_j);
+    const auto E_j = problem_description.total_energy(U_j);
+    const auto &p_j = precomputed_j[dim];
+
+    Number m_c = m_j[0] * c_ij[0];
+    Number v_c = precomputed_j[0] * c_ij[0];
+    for (unsigned int d = 1; d < dim; ++d) {
+      m_c += m_j[d] * c_ij[d];
+      v_c += precomputed_j[d] * c_ij[d];
+    }
+
+    /*
+     * The contributions of U_i are accumulated via the sum of all c_ij
+     * and subtracted in alpha():
+     */
+    left += entropy_j * v_c - eta_i * rho_i_inverse * m_c;
+    right[0] += m_c;
+    for (unsigned int d = 0; d < dim; ++d)
+      right[1 + d] += m_j[d] * v_c + p_j * c_ij[d];
+    right[dim + 1] += (E_j + p_j) * v_c;
+    c_sum += c_ij;
+
+    if constexpr (compute_second_variations_) {
+      const auto &rho_j = problem_description.density(U_j);
+
+      rho_second_variation_numerator += beta_ij * (rho_j - rho_i);
+      rho_second_variation_denominator += beta_ij;
+    }
+  }
+
+
   template <int dim, typename Number>
   DEAL_II_ALWAYS_INLINE inline Number
   Indicator<dim, Number>::alpha(const Number hd_i)
@@ -377,6 +466,9 @@ namespace ryujin
     }
 
     if constexpr (indicator_ == Indicators::entropy_viscosity_commutator) {
+      for (unsigned int k = 0; k < problem_dimension; ++k)
+        right[k] -= f_i[k] * c_sum;
+
       Number numerator = left;
       Number denominator = std::abs(left);
       for (unsigned int k = 0; k < problem_dimension; ++k) {
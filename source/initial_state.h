@@ -11,7 +11,9 @@
 #include "problem_description.h"
 
 #include <deal.II/base/parameter_acceptor.h>
+#include <deal.II/base/point.h>
 #include <deal.II/base/tensor.h>
+#include <deal.II/base/vectorization.h>
 
 #include <string>
 
@@ -39,6 +41,17 @@ namespace ryujin
      */
     using rank1_type = ProblemDescription::rank1_type<dim, Number>;
 
+    /**
+     * Shorthand typedef for the (SIMD packed) dealii::VectorizedArray
+     * type used by the batched compute() function.
+     */
+    using VA = dealii::VectorizedArray<Number>;
+
+    /**
+     * A rank 1 tensor holding a SIMD batch of states.
+     */
+    using vectorized_rank1_type = ProblemDescription::rank1_type<dim, VA>;
+
     /**
      * Constructor taking geometry name @p name and a subsection @p
      * subsection as an argument. The dealii::ParameterAcceptor is
@@ -62,6 +75,31 @@ namespace ryujin
      */
     virtual rank1_type compute(const dealii::Point<dim> &point, Number t) = 0;
 
+    /**
+     * Batched variant of the above function that evaluates the initial
+     * state for a SIMD batch of positions @p point (one position per
+     * lane). The default implementation calls the scalar compute()
+     * function lane by lane; derived classes with a closed form override
+     * it with a vectorized evaluation.
+     *
+     * @note Both functions have to be safe to be called concurrently
+     * from multiple threads.
+     */
+    virtual vectorized_rank1_type
+    compute(const dealii::Point<dim, VA> &point, Number t)
+    {
+      vectorized_rank1_type result;
+      for (unsigned int l = 0; l < VA::size(); ++l) {
+        dealii::Point<dim> lane;
+        for (unsigned int d = 0; d < dim; ++d)
+          lane[d] = point[d][l];
+        const auto state = compute(lane, t);
+        for (unsigned int c = 0; c < rank1_type::dimension; ++c)
+          result[c][l] = state[c];
+      }
+      return result;
+    }
+
   protected:
     const ProblemDescription &problem_description;
 
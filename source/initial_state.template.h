@@ -11,6 +11,40 @@ namespace ryujin
 {
   namespace InitialStates
   {
+    namespace
+    {
+      /*
+       * Return a SIMD batch of states that is equal to the state given
+       * by @p primitive_right in all lanes with a positive
+       * @p position_1d and equal to the state given by @p primitive_left
+       * otherwise.
+       */
+      template <int dim, typename Number>
+      ProblemDescription::rank1_type<dim, dealii::VectorizedArray<Number>>
+      select_state(const ProblemDescription &problem_description,
+                   const dealii::VectorizedArray<Number> &position_1d,
+                   const dealii::Tensor<1, 3, Number> &primitive_left,
+                   const dealii::Tensor<1, 3, Number> &primitive_right)
+      {
+        using VA = dealii::VectorizedArray<Number>;
+        const auto left =
+            problem_description.template from_primitive_state<dim>(
+                primitive_left);
+        const auto right =
+            problem_description.template from_primitive_state<dim>(
+                primitive_right);
+
+        ProblemDescription::rank1_type<dim, VA> result;
+        for (unsigned int c = 0; c < ProblemDescription::problem_dimension<dim>;
+             ++c)
+          result[c] = dealii::compare_and_apply_mask<
+              dealii::SIMDComparison::greater_than>(
+              position_1d, VA(0.), VA(right[c]), VA(left[c]));
+        return result;
+      }
+    } /* namespace */
+
+
     /**
      * Uniform initial state defined by a given primitive state.
      *
@@ -21,6 +55,9 @@ namespace ryujin
     {
     public:
       using typename InitialState<dim, Number>::rank1_type;
+      using typename InitialState<dim, Number>::vectorized_rank1_type;
+      using typename InitialState<dim, Number>::VA;
+      using InitialState<dim, Number>::compute;
 
       Uniform(const ProblemDescription &problem_description,
               const std::string subsection)
@@ -42,6 +79,19 @@ namespace ryujin
             primitive_);
       }
 
+      virtual vectorized_rank1_type
+      compute(const dealii::Point<dim, VA> & /*point*/,
+              Number /*t*/) final override
+      {
+        const auto state =
+            this->problem_description.template from_primitive_state<dim>(
+                primitive_);
+        vectorized_rank1_type result;
+        for (unsigned int c = 0; c < rank1_type::dimension; ++c)
+          result[c] = state[c];
+        return result;
+      }
+
     private:
       dealii::Tensor<1, 3, Number> primitive_;
     };
@@ -60,6 +110,9 @@ namespace ryujin
     {
     public:
       using typename InitialState<dim, Number>::rank1_type;
+      using typename InitialState<dim, Number>::vectorized_rank1_type;
+      using typename InitialState<dim, Number>::VA;
+      using InitialState<dim, Number>::compute;
 
       RampUp(const ProblemDescription &problem_description,
              const std::string subsection)
@@ -136,6 +189,9 @@ namespace ryujin
     {
     public:
       using typename InitialState<dim, Number>::rank1_type;
+      using typename InitialState<dim, Number>::vectorized_rank1_type;
+      using typename InitialState<dim, Number>::VA;
+      using InitialState<dim, Number>::compute;
 
       Contrast(const ProblemDescription &problem_description,
                const std::string subsection)
@@ -166,6 +222,16 @@ namespace ryujin
             point[0] > 0. ? primitive_right_ : primitive_left_);
       }
 
+      virtual vectorized_rank1_type
+      compute(const dealii::Point<dim, VA> &point,
+              Number /*t*/) final override
+      {
+        return select_state<dim>(this->problem_description,
+                                 point[0],
+                                 primitive_left_,
+                                 primitive_right_);
+      }
+
     private:
       dealii::Tensor<1, 3, Number> primitive_left_;
       dealii::Tensor<1, 3, Number> primitive_right_;
@@ -184,6 +250,9 @@ namespace ryujin
     {
     public:
       using typename InitialState<dim, Number>::rank1_type;
+      using typename InitialState<dim, Number>::vectorized_rank1_type;
+      using typename InitialState<dim, Number>::VA;
+      using InitialState<dim, Number>::compute;
 
       ShockFront(const ProblemDescription &problem_description,
                  const std::string subsection)
@@ -248,6 +317,15 @@ namespace ryujin
             position_1d > 0. ? primitive_right_ : primitive_left_);
       }
 
+      virtual vectorized_rank1_type
+      compute(const dealii::Point<dim, VA> &point, Number t) final override
+      {
+        return select_state<dim>(this->problem_description,
+                                 point[0] - VA(S3_ * t),
+                                 primitive_left_,
+                                 primitive_right_);
+      }
+
     private:
       dealii::Tensor<1, 3, Number> primitive_left_;
       dealii::Tensor<1, 3, Number> primitive_right_;
@@ -267,6 +345,9 @@ namespace ryujin
     {
     public:
       using typename InitialState<dim, Number>::rank1_type;
+      using typename InitialState<dim, Number>::vectorized_rank1_type;
+      using typename InitialState<dim, Number>::VA;
+      using InitialState<dim, Number>::compute;
 
       IsentropicVortex(const ProblemDescription &problem_description,
                        const std::string subsection)
@@ -315,6 +396,39 @@ namespace ryujin
         }
       }
 
+      virtual vectorized_rank1_type
+      compute(const dealii::Point<dim, VA> &point, Number t) final override
+      {
+        const auto gamma = this->problem_description.gamma();
+
+        if constexpr (dim == 2) {
+          auto point_bar = point;
+          point_bar[0] -= VA(mach_number_ * t);
+
+          const VA r_square = point_bar.norm_square();
+
+          const VA factor = beta_ / Number(2. * M_PI) *
+                            std::exp(VA(0.5) - Number(0.5) * r_square);
+
+          const VA T = VA(1.) - (gamma - Number(1.)) / (Number(2.) * gamma) *
+                                    factor * factor;
+
+          const VA u = VA(mach_number_) - factor * point_bar[1];
+          const VA v = factor * point_bar[0];
+
+          const VA rho = ryujin::pow(T, Number(1.) / (gamma - Number(1.)));
+          const VA p = ryujin::pow(rho, Number(gamma));
+          const VA E =
+              p / (gamma - Number(1.)) + Number(0.5) * rho * (u * u + v * v);
+
+          return vectorized_rank1_type({rho, rho * u, rho * v, E});
+
+        } else {
+          AssertThrow(false, dealii::ExcNotImplemented());
+          return vectorized_rank1_type();
+        }
+      }
+
     private:
       Number mach_number_;
       Number beta_;
@@ -332,6 +446,9 @@ namespace ryujin
     {
     public:
       using typename InitialState<dim, Number>::rank1_type;
+      using typename InitialState<dim, Number>::vectorized_rank1_type;
+      using typename InitialState<dim, Number>::VA;
+      using InitialState<dim, Number>::compute;
 
       BeckerSolution(const ProblemDescription &problem_description,
                      const std::string subsection)
@@ -43,6 +43,16 @@ namespace ryujin
      */
     using rank1_type = ProblemDescription::rank1_type<dim, Number>;
 
+    /**
+     * @copydoc InitialState::VA
+     */
+    using VA = dealii::VectorizedArray<Number>;
+
+    /**
+     * @copydoc InitialState::vectorized_rank1_type
+     */
+    using vectorized_rank1_type = ProblemDescription::rank1_type<dim, VA>;
+
     /**
      * @copydoc OfflineData::vector_type
      */
@@ -78,14 +88,54 @@ namespace ryujin
     }
 
 
+    /**
+     * Batched variant of initial_state() that returns the initial states
+     * for a SIMD batch of positions @p point.
+     */
+    DEAL_II_ALWAYS_INLINE inline vectorized_rank1_type
+    initial_state(const dealii::Point<dim, VA> &point, Number t) const
+    {
+      return initial_state_simd_(point, t);
+    }
+
+
     /**
      * Given a reference to an OfflineData object (that contains a
      * dealii::DoFHandler) this routine computes and returns a state vector
      * populated with initial values for a specified time @p t.
+     *
+     * The support points of all locally owned degrees of freedom are
+     * collected first. The initial state is then evaluated for SIMD
+     * batches of support points in a thread parallel loop. (If a random
+     * "perturbation" is requested the evaluation is serial.)
      */
     vector_type interpolate(const OfflineData<dim, Number> &offline_data,
                             Number t = 0);
 
+    /**
+     * Return whether initial_state() can be called concurrently from
+     * several threads. This is not the case if a random "perturbation"
+     * is requested.
+     */
+    bool thread_safe() const
+    {
+      return perturbation_ == Number(0.);
+    }
+
+    /**
+     * Select the member @p k of an ensemble run. All subsequent calls
+     * to initial_state() and interpolate() return the initial state with
+     * the velocity rotated by k times the "ensemble rotation" (in the
+     * xy-plane) and scaled by (1 + k times the "ensemble velocity
+     * factor"). Density and internal energy remain unchanged, i.e., the
+     * members sweep over the angle of attack and the Mach number of the
+     * configuration. Member 0 is the unmodified configuration.
+     */
+    void set_ensemble_member(unsigned int k)
+    {
+      ensemble_member_ = k;
+    }
+
   private:
     /**
      * @name Run time options
@@ -100,6 +150,10 @@ namespace ryujin
 
     Number perturbation_;
 
+    Number ensemble_rotation_;
+
+    Number ensemble_velocity_factor_;
+
     //@}
     /**
      * @name Internal data:
@@ -108,11 +162,17 @@ namespace ryujin
 
     const ProblemDescription &problem_description;
 
+    unsigned int ensemble_member_;
+
     std::set<std::unique_ptr<InitialState<dim, Number>>> initial_state_list_;
 
     std::function<rank1_type(const dealii::Point<dim> &point, Number t)>
         initial_state_;
 
+    std::function<vectorized_rank1_type(const dealii::Point<dim, VA> &point,
+                                        Number t)>
+        initial_state_simd_;
+
     //@}
   };
 
@@ -7,6 +7,7 @@
 
 #include "initial_state.template.h"
 #include "initial_values.h"
+#include "openmp.h"
 #include "simd.h"
 
 #include <deal.II/numerics/vector_tools.h>
@@ -24,6 +25,7 @@ namespace ryujin
       const std::string &subsection)
       : ParameterAcceptor(subsection)
       , problem_description(problem_description)
+      , ensemble_member_(0)
   {
     ParameterAcceptor::parse_parameters_call_back.connect(std::bind(
         &InitialValues<dim, Number>::parse_parameters_callback, this));
@@ -52,6 +54,19 @@ namespace ryujin
                   "Add a random perturbation of the specified magnitude to the "
                   "initial state.");
 
+    ensemble_rotation_ = 0.;
+    add_parameter("ensemble rotation",
+                  ensemble_rotation_,
+                  "Ensemble runs: rotate the velocity of member k by k times "
+                  "this angle (in radians) in the xy-plane.");
+
+    ensemble_velocity_factor_ = 0.;
+    add_parameter("ensemble velocity factor",
+                  ensemble_velocity_factor_,
+                  "Ensemble runs: scale the velocity of member k by (1 + k "
+                  "times this factor) keeping density and internal energy "
+                  "fixed.");
+
     using namespace InitialStates;
     initial_state_list_.emplace(std::make_unique<Uniform<dim, Number>>(
         problem_description, subsection));
@@ -70,15 +85,18 @@ namespace ryujin
   namespace
   {
     /**
-     * An affine transformation:
+     * An affine transformation (of a single point, or a SIMD batch of
+     * points):
      */
-    template <int dim>
-    inline DEAL_II_ALWAYS_INLINE dealii::Point<dim>
+    template <int dim, typename Number>
+    inline DEAL_II_ALWAYS_INLINE dealii::Point<dim, Number>
     affine_transform(const dealii::Tensor<1, dim> initial_direction,
                      const dealii::Point<dim> initial_position,
-                     const dealii::Point<dim> x)
+                     const dealii::Point<dim, Number> x)
     {
-      auto direction = x - initial_position;
+      dealii::Tensor<1, dim, Number> direction;
+      for (unsigned int d = 0; d < dim; ++d)
+        direction[d] = x[d] - Number(initial_position[d]);
 
       /* Roll third component of initial_direction onto xy-plane: */
       if constexpr (dim == 3) {
@@ -110,7 +128,7 @@ namespace ryujin
         direction = new_direction;
       }
 
-      return Point<dim>() + direction;
+      return dealii::Point<dim, Number>(direction);
     }
 
 
@@ -174,17 +192,35 @@ namespace ryujin
       bool initialized = false;
       for (auto &it : initial_state_list_)
         if (it->name() == configuration_) {
-          initial_state_ = [this, &it](const dealii::Point<dim> &point,
-                                       Number t) {
+          /* The same (generic) lambda serves scalars and SIMD batches: */
+          const auto compute = [this, &it](const auto &point, Number t) {
             const auto transformed_point =
                 affine_transform(initial_direction_, initial_position_, point);
             auto state = it->compute(transformed_point, t);
             auto M = problem_description.momentum(state);
             M = affine_transform_vector(initial_direction_, M);
+
+            /* Rotate and scale the velocity of an ensemble member: */
+            if (ensemble_member_ != 0) {
+              const Number k = ensemble_member_;
+              const Number angle = k * ensemble_rotation_;
+              const Number factor = Number(1.) + k * ensemble_velocity_factor_;
+              const auto rho = problem_description.density(state);
+              const auto kinetic = M.norm_square() / (Number(2.) * rho);
+
+              auto M_new = M;
+              M_new[0] = std::cos(angle) * M[0] - std::sin(angle) * M[1];
+              M_new[1] = std::sin(angle) * M[0] + std::cos(angle) * M[1];
+              M = factor * M_new;
+              state[1 + dim] += (factor * factor - Number(1.)) * kinetic;
+            }
+
             for (unsigned int d = 0; d < dim; ++d)
               state[1 + d] = M[d];
             return state;
           };
+          initial_state_ = compute;
+          initial_state_simd_ = compute;
           initialized = true;
           break;
         }
@@ -212,6 +248,21 @@ namespace ryujin
 
         return state;
       };
+
+      /* Evaluate SIMD batches lane by lane with the perturbed function: */
+      initial_state_simd_ = [this](const dealii::Point<dim, VA> &point,
+                                   Number t) {
+        vectorized_rank1_type result;
+        for (unsigned int l = 0; l < VA::size(); ++l) {
+          dealii::Point<dim> lane;
+          for (unsigned int d = 0; d < dim; ++d)
+            lane[d] = point[d][l];
+          const auto state = initial_state_(lane, t);
+          for (unsigned int c = 0; c < problem_dimension; ++c)
+            result[c][l] = state[c];
+        }
+        return result;
+      };
     }
   }
 
@@ -232,23 +283,72 @@ namespace ryujin
     constexpr auto problem_dimension =
         ProblemDescription::problem_dimension<dim>;
 
-    using scalar_type = typename OfflineData<dim, Number>::scalar_type;
-
-    const auto callable = [&](const auto &p) { return initial_state(p, t); };
+    const auto &boundary_map = offline_data.boundary_map();
+    const unsigned int n_owned = offline_data.n_locally_owned();
 
-    scalar_type temp;
-    const auto scalar_partitioner = offline_data.scalar_partitioner();
-    temp.reinit(scalar_partitioner);
+    /*
+     * Collect the support points of all locally owned degrees of
+     * freedom (in local index order):
+     */
 
-    for (unsigned int d = 0; d < problem_dimension; ++d) {
-      VectorTools::interpolate(offline_data.dof_handler(),
-                               to_function<dim, Number>(callable, d),
-                               temp);
-      U.insert_component(temp, d);
+    std::vector<Point<dim>> points(n_owned);
+    {
+      const auto &discretization = offline_data.discretization();
+      const auto &mapping = discretization.mapping();
+      const auto &unit_support_points =
+          discretization.finite_element().get_unit_support_points();
+      const auto &scalar_partitioner = *offline_data.scalar_partitioner();
+
+      std::vector<types::global_dof_index> dof_indices(
+          unit_support_points.size());
+
+      for (const auto &cell :
+           offline_data.dof_handler().active_cell_iterators()) {
+        if (!cell->is_locally_owned())
+          continue;
+
+        cell->get_dof_indices(dof_indices);
+        for (unsigned int j = 0; j < dof_indices.size(); ++j) {
+          if (!scalar_partitioner.in_local_range(dof_indices[j]))
+            continue;
+          const auto i = scalar_partitioner.global_to_local(dof_indices[j]);
+          points[i] =
+              mapping.transform_unit_to_real_cell(cell, unit_support_points[j]);
+        }
+      }
     }
 
-    const auto &boundary_map = offline_data.boundary_map();
-    const unsigned int n_owned = offline_data.n_locally_owned();
+    /*
+     * Evaluate the initial state for SIMD batches of support points.
+     * A random perturbation draws from a shared random number
+     * generator, in this case we have to evaluate serially:
+     */
+
+    constexpr auto simd_length = VA::size();
+    const unsigned int n_batched = n_owned - n_owned % simd_length;
+
+    if (perturbation_ == 0.) {
+      RYUJIN_PARALLEL_REGION_BEGIN
+
+      RYUJIN_OMP_FOR_NOWAIT
+      for (unsigned int i = 0; i < n_batched; i += simd_length) {
+        Point<dim, VA> point;
+        for (unsigned int l = 0; l < simd_length; ++l)
+          for (unsigned int d = 0; d < dim; ++d)
+            point[d][l] = points[i + l][d];
+        U.write_vectorized_tensor(initial_state(point, t), i);
+      }
+
+      RYUJIN_OMP_FOR
+      for (unsigned int i = n_batched; i < n_owned; ++i)
+        U.write_tensor(initial_state(points[i], t), i);
+
+      RYUJIN_PARALLEL_REGION_END
+
+    } else {
+      for (unsigned int i = 0; i < n_owned; ++i)
+        U.write_tensor(initial_state(points[i], t), i);
+    }
 
     /*
      * Cosmetic fix up: Ensure that the initial state is compatible with
@@ -7,6 +7,7 @@
 
 #include <compile_time_options.h>
 
+#include "derived_quantities.h"
 #include "offline_data.h"
 #include "problem_description.h"
 
@@ -22,6 +23,8 @@ namespace ryujin
   /**
    * A postprocessor class to compute integral quantities of interest.
    *
+   * The integrals are taken from the shared DerivedQuantities pipeline.
+   *
    * @ingroup TimeLoop
    */
   template <int dim, typename Number = double>
@@ -57,12 +60,18 @@ namespace ryujin
      */
     using vector_type = typename OfflineData<dim, Number>::vector_type;
 
+    /**
+     * @copydoc DerivedQuantities::Integrals
+     */
+    using integrals_type = typename DerivedQuantities<dim, Number>::Integrals;
+
     /**
      * Constructor.
      */
     IntegralQuantities(const MPI_Comm &mpi_communicator,
                        const ProblemDescription &problem_description,
                        const OfflineData<dim, Number> &offline_data,
+                       DerivedQuantities<dim, Number> &derived_quantities,
                        const std::string &subsection = "IntegralQuantities");
 
     /**
@@ -86,6 +95,13 @@ namespace ryujin
      */
     void compute(const vector_type &U, Number t);
 
+    /**
+     * Write out the given (already reduced) @p integrals for time @p t.
+     * This is used for integrals that are accumulated during the time
+     * step, see EulerModule::request_integrals().
+     */
+    void write(const integrals_type &integrals, Number t);
+
   private:
     /**
      * @name Internal data
@@ -97,6 +113,7 @@ namespace ryujin
 
     const ProblemDescription &problem_description;
     dealii::SmartPointer<const ryujin::OfflineData<dim, Number>> offline_data_;
+    dealii::SmartPointer<DerivedQuantities<dim, Number>> derived_quantities_;
 
     std::ofstream output;
 
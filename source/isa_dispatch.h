@@ -0,0 +1,107 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include <compile_time_options.h>
+
+#include <unistd.h>
+
+#include <climits>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace ryujin
+{
+  /**
+   * Return the list of instruction set variants of the executable
+   * (see the ISA_VARIANTS CMake option) that are supported by the CPU we
+   * are running on, ordered from the most to the least preferable one.
+   *
+   * The vector width of dealii::VectorizedArray is a compile-time
+   * property, so every variant is a separate build of all compute kernels
+   * (and of everything that depends on the SIMD width). The variants are
+   * linked into separate executables "ryujin-<variant>" in order to
+   * avoid any ODR violations between (inline) functions compiled for
+   * different instruction sets.
+   *
+   * @note Only the ryujin code itself is compiled per variant; all
+   * variants link against the same deal.II library. deal.II therefore
+   * has to be configured for the baseline instruction set (otherwise the
+   * baseline executable requires the instruction set of deal.II) and has
+   * to provide the MatrixFree instantiations for the SIMD widths of all
+   * variants. The latter is checked when configuring ryujin.
+   *
+   * @note NEON is part of the baseline of every aarch64 target and
+   * dealii::VectorizedArray does not support SVE, so there is nothing to
+   * dispatch to on ARM.
+   *
+   * @ingroup Miscellaneous
+   */
+  inline std::vector<std::string> supported_isa_variants()
+  {
+    std::vector<std::string> result;
+#if defined(__x86_64) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") &&
+        __builtin_cpu_supports("avx512dq") &&
+        __builtin_cpu_supports("avx512vl") &&
+        __builtin_cpu_supports("avx512bw"))
+      result.push_back("avx512");
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+      result.push_back("avx2");
+#endif
+    return result;
+  }
+
+
+  /**
+   * Replace the current process by the most preferable instruction set
+   * variant of the executable that is supported by the CPU and that has
+   * been installed next to the current executable. If no such variant
+   * exists the function returns and the (baseline) executable simply
+   * continues.
+   *
+   * The environment variable RYUJIN_ISA can be used to override the
+   * selection: "baseline" disables dispatching, any other value selects
+   * the given variant (if it is installed and supported).
+   *
+   * This function has to be called at the very beginning of main(),
+   * before MPI is initialized and before any threads are spawned. It
+   * does nothing in a variant executable itself, or if ryujin has been
+   * configured without ISA_VARIANTS.
+   */
+  inline void dispatch_isa_variant(int /*argc*/, char *argv[])
+  {
+#if defined(USE_ISA_DISPATCH) && !defined(RYUJIN_ISA_VARIANT)
+    const char *requested = std::getenv("RYUJIN_ISA");
+    if (requested != nullptr && std::string(requested) == "baseline")
+      return;
+
+    char path[PATH_MAX];
+    const auto length = ::readlink("/proc/self/exe", path, PATH_MAX - 1);
+    if (length <= 0)
+      return;
+    path[length] = '\0';
+    const std::string executable(path);
+
+    for (const auto &variant : supported_isa_variants()) {
+      if (requested != nullptr && variant != requested)
+        continue;
+
+      const std::string candidate = executable + "-" + variant;
+      if (::access(candidate.c_str(), X_OK) != 0)
+        continue;
+
+      /* execv() only returns on failure, in which case we continue: */
+      ::execv(candidate.c_str(), argv);
+    }
+#else
+    (void)argv;
+#endif
+  }
+
+} // namespace ryujin
@@ -0,0 +1,63 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include <map>
+#include <string>
+
+namespace ryujin
+{
+  /**
+   * Accumulated (modeled) memory traffic and floating point operations
+   * of a compute kernel.
+   *
+   * The numbers are not measured but derived from the known stencil
+   * sizes of the kernels, i.e., from the number of locally owned rows and
+   * nonzero entries of the sparsity pattern (or the number of degrees of
+   * freedom for matrix-free operators) multiplied with per-row and
+   * per-entry estimates of the data that has to be moved and the
+   * operations that have to be performed. Together with the time
+   * recorded by the corresponding Scope timers this gives a
+   * roofline-style estimate of the achieved memory bandwidth and flop
+   * rate without the need of hardware performance counters.
+   *
+   * @ingroup Miscellaneous
+   */
+  struct KernelStatistics {
+    /**
+     * Record @p n_rows rows and @p n_entries entries with the given
+     * per-row and per-entry estimates.
+     */
+    void record(const double n_rows,
+                const double n_entries,
+                const double bytes_per_row,
+                const double bytes_per_entry,
+                const double flops_per_row,
+                const double flops_per_entry)
+    {
+      bytes += n_rows * bytes_per_row + n_entries * bytes_per_entry;
+      flops += n_rows * flops_per_row + n_entries * flops_per_entry;
+    }
+
+    /**
+     * Accumulated memory traffic in bytes.
+     */
+    double bytes = 0.;
+
+    /**
+     * Accumulated number of floating point operations.
+     */
+    double flops = 0.;
+  };
+
+  /**
+   * A map of KernelStatistics indexed by the common prefix of the
+   * computing timer sections the kernel is timed in, for example "time
+   * step [E] 1".
+   */
+  using KernelStatisticsMap = std::map<std::string, KernelStatistics>;
+
+} /* namespace ryujin */
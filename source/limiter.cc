@@ -47,6 +47,44 @@ namespace ryujin
       const rank1_type &,
       const VectorizedArray<NUMBER>,
       const VectorizedArray<NUMBER>);
+
+  /* Variants selectable at run time, see EulerModule::single_step(): */
+
+  template NUMBER
+  Limiter<DIM, NUMBER>::limit<Limiter<DIM, NUMBER>::Limiters::none>(
+      const ProblemDescription &,
+      const std::array<NUMBER, 3> &,
+      const rank1_type &,
+      const rank1_type &,
+      const NUMBER,
+      const NUMBER);
+
+  template VectorizedArray<NUMBER> Limiter<DIM, VectorizedArray<NUMBER>>::limit<
+      Limiter<DIM, VectorizedArray<NUMBER>>::Limiters::none>(
+      const ProblemDescription &,
+      const std::array<VectorizedArray<NUMBER>, 3> &,
+      const rank1_type &,
+      const rank1_type &,
+      const VectorizedArray<NUMBER>,
+      const VectorizedArray<NUMBER>);
+
+  template NUMBER
+  Limiter<DIM, NUMBER>::limit<Limiter<DIM, NUMBER>::Limiters::rho>(
+      const ProblemDescription &,
+      const std::array<NUMBER, 3> &,
+      const rank1_type &,
+      const rank1_type &,
+      const NUMBER,
+      const NUMBER);
+
+  template VectorizedArray<NUMBER> Limiter<DIM, VectorizedArray<NUMBER>>::limit<
+      Limiter<DIM, VectorizedArray<NUMBER>>::Limiters::rho>(
+      const ProblemDescription &,
+      const std::array<VectorizedArray<NUMBER>, 3> &,
+      const rank1_type &,
+      const rank1_type &,
+      const VectorizedArray<NUMBER>,
+      const VectorizedArray<NUMBER>);
 #endif
 
 } // namespace ryujin
@@ -15,6 +15,28 @@
 
 namespace ryujin
 {
+  /**
+   * An enum describing the thermodynamical quantities for which the
+   * invariant domain property is enforced by the limiter.
+   *
+   * @ingroup EulerModule
+   */
+  enum class Limiters {
+    /** Do not limit and accept full high-order update. */
+    none,
+    /** Enforce local bounds on density. */
+    rho,
+    /** Enforce local bounds on density and specific entropy. */
+    specific_entropy,
+    /**
+     * Enforce local bounds on density, specific entropy and enforce an
+     * entropy inequality using the Harten-type inequality
+     * ProblemDescription::harten_entropy().
+     */
+    entropy_inequality
+  };
+
+
   /**
    * The convex limiter.
    *
@@ -42,14 +64,26 @@ namespace ryujin
    *     \Psi(\mathbf U)\;=\;\rho^{\gamma+1}(\mathbf U)\,\big(\phi(\mathbf U)-\phi_{\text{min}}\big).
    * \f}
    *
+   * The final limiting stage is selected with the template parameter @p
+   * limiter_variant (defaulting to the compile-time option LIMITER).
+   * EulerModule instantiates the variants none, rho, and specific_entropy
+   * and selects one at run time, see EulerModule::single_step().
+   *
    * @todo document local entropy inequality condition.
    *
    * @ingroup EulerModule
    */
-  template <int dim, typename Number = double>
+  template <int dim,
+            typename Number = double,
+            Limiters limiter_variant = LIMITER>
   class Limiter
   {
   public:
+    /**
+     * @copydoc ryujin::Limiters
+     */
+    using Limiters = ryujin::Limiters;
+
     /**
      * @copydoc ProblemDescription::problem_dimension
      */
@@ -67,25 +101,6 @@ namespace ryujin
      */
     using ScalarNumber = typename get_value_type<Number>::type;
 
-    /**
-     * An enum describing the thermodynamical quantities for which the
-     * invariant domain property is enforced by the limiter.
-     */
-    enum class Limiters {
-      /** Do not limit and accept full high-order update. */
-      none,
-      /** Enforce local bounds on density. */
-      rho,
-      /** Enforce local bounds on density and specific entropy. */
-      specific_entropy,
-      /**
-       * Enforce local bounds on density, specific entropy and enforce an
-       * entropy inequality using the Harten-type inequality
-       * ProblemDescription::harten_entropy().
-       */
-      entropy_inequality
-    };
-
     /**
      * @name Limiter compile time options
      */
@@ -96,7 +111,7 @@ namespace ryujin
      * Selected final limiting stage.
      * @ingroup CompileTimeOptions
      */
-    static constexpr Limiters limiter_ = LIMITER;
+    static constexpr Limiters limiter_ = limiter_variant;
 
     /**
      * Relax accumulated limiter bounds.
@@ -110,6 +125,13 @@ namespace ryujin
      */
     static constexpr unsigned int relaxation_order_ = LIMITER_RELAXATION_ORDER;
 
+    /**
+     * Check whether the full update already satisfies all bounds before
+     * running the line search, see limit().
+     * @ingroup CompileTimeOptions
+     */
+    static constexpr bool precheck_ = LIMITER_PRECHECK;
+
     // clang-format on
 
     //@}
@@ -136,13 +158,13 @@ namespace ryujin
     /**
      * The number of stored entries in the bounds array.
      *
-     * @todo determine number of bounds based on chosen limiter.
+     * We always store [rho_min, rho_max, s_min] (unused entries are left
+     * untouched) so that all variants selectable at run time share the
+     * same storage layout.
      */
     // clang-format off
     static constexpr unsigned int n_bounds =
-          (limiter_ == Limiters::rho) ? 2
-        : (limiter_ == Limiters::specific_entropy) ? 3
-        : (limiter_ == Limiters::entropy_inequality) ? 5 : 0;
+        (limiter_ == Limiters::entropy_inequality) ? 5 : 3;
     // clang-format on
 
     /**
@@ -203,6 +225,25 @@ namespace ryujin
                         const rank1_type &P,
                         const Number t_min = Number(0.),
                         const Number t_max = Number(1.));
+
+    /**
+     * Return true if the state \f$\mathbf U + t\mathbf P\f$ satisfies the
+     * bounds of all limiting stages up to @p limiter in every SIMD lane,
+     * i.e., exactly if limit() called with t_max = t would return t.
+     *
+     * This check is used as a fast path in limit() (if precheck_ is set):
+     * The vast majority of edges in smooth regions of the domain satisfy
+     * the bounds for the full high-order update. For those only a single
+     * evaluation of the density and the scaled specific entropy is
+     * necessary and the rho line search and the Newton iteration (with
+     * its derivative evaluations) are skipped completely.
+     */
+    template <Limiters limiter = limiter_, typename BOUNDS>
+    static bool is_admissible(const ProblemDescription &problem_description,
+                              const BOUNDS &bounds,
+                              const rank1_type &U,
+                              const rank1_type &P,
+                              const Number t = Number(1.));
     //*}
 
   private:
@@ -223,9 +264,9 @@ namespace ryujin
   };
 
 
-  template <int dim, typename Number>
+  template <int dim, typename Number, Limiters limiter_variant>
   DEAL_II_ALWAYS_INLINE inline void
-  Limiter<dim, Number>::reset(const Number new_variations_i)
+  Limiter<dim, Number, limiter_variant>::reset(const Number new_variations_i)
   {
     if constexpr (relax_bounds_) {
       variations_i = new_variations_i;
@@ -249,15 +290,16 @@ namespace ryujin
   }
 
 
-  template <int dim, typename Number>
+  template <int dim, typename Number, Limiters limiter_variant>
   DEAL_II_ALWAYS_INLINE inline void
-  Limiter<dim, Number>::accumulate(const rank1_type &U_i,
-                                   const rank1_type &U_j,
-                                   const rank1_type &U_ij_bar,
-                                   const Number beta_ij,
-                                   const Number entropy_j,
-                                   const Number variations_j,
-                                   const bool is_diagonal_entry)
+  Limiter<dim, Number, limiter_variant>::accumulate(
+      const rank1_type &U_i,
+      const rank1_type &U_j,
+      const rank1_type &U_ij_bar,
+      const Number beta_ij,
+      const Number entropy_j,
+      const Number variations_j,
+      const bool is_diagonal_entry)
   {
     /* Relaxation (the numerical constant 8 is up to debate): */
     if constexpr (relax_bounds_) {
@@ -290,9 +332,9 @@ namespace ryujin
   }
 
 
-  template <int dim, typename Number>
+  template <int dim, typename Number, Limiters limiter_variant>
   DEAL_II_ALWAYS_INLINE inline void
-  Limiter<dim, Number>::apply_relaxation(Number hd_i)
+  Limiter<dim, Number, limiter_variant>::apply_relaxation(Number hd_i)
   {
     if constexpr (!relax_bounds_)
       return;
@@ -321,9 +363,10 @@ namespace ryujin
   }
 
 
-  template <int dim, typename Number>
-  DEAL_II_ALWAYS_INLINE inline const typename Limiter<dim, Number>::Bounds &
-  Limiter<dim, Number>::bounds() const
+  template <int dim, typename Number, Limiters limiter_variant>
+  DEAL_II_ALWAYS_INLINE inline const
+      typename Limiter<dim, Number, limiter_variant>::Bounds &
+      Limiter<dim, Number, limiter_variant>::bounds() const
   {
     return bounds_;
   }
@@ -9,24 +9,30 @@
 
 namespace ryujin
 {
-  template <int dim, typename Number>
-  template <typename Limiter<dim, Number>::Limiters limiter, typename BOUNDS>
+  template <int dim, typename Number, Limiters limiter_variant>
+  template <Limiters limiter, typename BOUNDS>
 #ifdef OBSESSIVE_INLINING
   DEAL_II_ALWAYS_INLINE inline
 #endif
       Number
-      Limiter<dim, Number>::limit(const ProblemDescription &problem_description,
-                                  const BOUNDS &bounds,
-                                  const rank1_type &U,
-                                  const rank1_type &P,
-                                  const Number t_min /* = Number(0.) */,
-                                  const Number t_max /* = Number(1.) */)
+      Limiter<dim, Number, limiter_variant>::limit(
+          const ProblemDescription &problem_description,
+          const BOUNDS &bounds,
+          const rank1_type &U,
+          const rank1_type &P,
+          const Number t_min /* = Number(0.) */,
+          const Number t_max /* = Number(1.) */)
   {
     Number t_r = t_max;
 
     if constexpr (limiter == Limiters::none)
       return t_r;
 
+    if constexpr (precheck_) {
+      if (is_admissible<limiter>(problem_description, bounds, U, P, t_max))
+        return t_max;
+    }
+
     /*
      * First limit the density rho.
      *
@@ -255,7 +261,7 @@ namespace ryujin
         const auto rho_r = problem_description.density(U_r);
         const auto rho_e_r = problem_description.internal_energy(U_r);
         const auto average_r = positive_part(a + b * t_r);
-        const auto average_gamma_r = std::pow(average_r, gamma);
+        const auto average_gamma_r = ryujin::pow(average_r, gamma);
 
         auto psi_r = average_r * average_gamma_r - rho_r * rho_e_r * relaxation;
 
@@ -273,7 +279,7 @@ namespace ryujin
         const auto rho_l = problem_description.density(U_l);
         const auto rho_e_l = problem_description.internal_energy(U_l);
         const auto average_l = positive_part(a + b * t_l);
-        const auto average_gamma_l = std::pow(average_l, gamma);
+        const auto average_gamma_l = ryujin::pow(average_l, gamma);
 
         auto psi_l = average_l * average_gamma_l - rho_l * rho_e_l * relaxation;
 
@@ -331,4 +337,83 @@ namespace ryujin
     return t_l;
   }
 
+
+  template <int dim, typename Number, Limiters limiter_variant>
+  template <Limiters limiter, typename BOUNDS>
+#ifdef OBSESSIVE_INLINING
+  DEAL_II_ALWAYS_INLINE inline
+#endif
+      bool
+      Limiter<dim, Number, limiter_variant>::is_admissible(
+          const ProblemDescription &problem_description,
+          const BOUNDS &bounds,
+          const rank1_type &U,
+          const rank1_type &P,
+          const Number t /* = Number(1.) */)
+  {
+    if constexpr (limiter == Limiters::none)
+      return true;
+
+    /*
+     * The comparisons below are the exact complements of the ones used in
+     * limit() so that the fast path returns bitwise identical results:
+     */
+
+    const auto U_t = U + t * P;
+    const auto rho = problem_description.density(U_t);
+
+    const auto &rho_min = std::get<0>(bounds);
+    const auto &rho_max = std::get<1>(bounds);
+
+    /* Number(1.) in every lane that violates the density bounds: */
+    auto violated =
+        dealii::compare_and_apply_mask<dealii::SIMDComparison::less_than>(
+            rho_max, rho, Number(1.), Number(0.));
+    violated =
+        dealii::compare_and_apply_mask<dealii::SIMDComparison::less_than>(
+            rho, rho_min, Number(1.), violated);
+
+    if (!(violated == Number(0.)))
+      return false;
+
+    if constexpr (limiter == Limiters::rho)
+      return true;
+
+    const ScalarNumber gamma = problem_description.gamma();
+    constexpr ScalarNumber eps = std::numeric_limits<ScalarNumber>::epsilon();
+    constexpr ScalarNumber relaxation = ScalarNumber(1.) + 10. * eps;
+
+    const auto rho_gamma = ryujin::pow(rho, gamma);
+    const auto rho_e = problem_description.internal_energy(U_t);
+
+    {
+      const auto &s_min = std::get<2>(bounds);
+      const auto psi = relaxation * rho * rho_e - s_min * rho * rho_gamma;
+
+      violated = dealii::compare_and_apply_mask<
+          dealii::SIMDComparison::greater_than>(
+          psi, Number(0.), Number(0.), Number(1.));
+
+      if (!(violated == Number(0.)))
+        return false;
+    }
+
+    if constexpr (limiter == Limiters::entropy_inequality) {
+      const auto a = std::get<3>(bounds);
+      const auto b = std::get<4>(bounds);
+      const auto average = positive_part(a + b * t);
+      const auto psi =
+          average * ryujin::pow(average, gamma) - rho * rho_e * relaxation;
+
+      violated = dealii::compare_and_apply_mask<
+          dealii::SIMDComparison::less_than_or_equal>(
+          psi, Number(0.), Number(0.), Number(1.));
+
+      if (!(violated == Number(0.)))
+        return false;
+    }
+
+    return true;
+  }
+
 } /* namespace ryujin */
@@ -6,13 +6,22 @@
 #pragma once
 
 #include <deal.II/base/partitioner.h>
+#include <deal.II/base/table.h>
+#include <deal.II/base/utilities.h>
 #include <deal.II/dofs/dof_handler.h>
 #include <deal.II/dofs/dof_renumbering.h>
 #include <deal.II/dofs/dof_tools.h>
+#include <deal.II/fe/fe_tools.h>
+#include <deal.II/fe/mapping.h>
 #include <deal.II/lac/affine_constraints.h>
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
 #include <deal.II/lac/sparsity_tools.h>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+
 namespace ryujin
 {
   /**
@@ -74,6 +83,143 @@ namespace ryujin
   }
 
 
+  /**
+   * The DoFTools namespace contains a number of custom dof tools
+   * functions.
+   *
+   * @ingroup FiniteElement
+   */
+  namespace DoFTools
+  {
+    /** Import a function from deal.II into the current namespace. */
+    using dealii::DoFTools::extract_locally_relevant_dofs;
+
+    /** Import a function from deal.II into the current namespace. */
+    using dealii::DoFTools::make_hanging_node_constraints;
+
+    /** Import a function from deal.II into the current namespace. */
+    using dealii::DoFTools::make_periodicity_constraints;
+
+    /**
+     * Given a Lagrange finite element @p fe of degree p with support
+     * points on an equidistant lattice this function returns a coupling
+     * mask for the degrees of freedom of a cell that only couples degrees
+     * of freedom that are neighbors on the lattice, i.e., the graph of
+     * the Q1 subcell decomposition of the cell. For p = 1 all degrees of
+     * freedom of the cell are coupled.
+     *
+     * @ingroup FiniteElement
+     */
+    template <int dim>
+    dealii::Table<2, bool>
+    subcell_coupling_mask(const dealii::FiniteElement<dim> &fe)
+    {
+      const unsigned int degree = fe.degree;
+      const unsigned int dofs_per_cell = fe.dofs_per_cell;
+
+      AssertThrow(dofs_per_cell == dealii::Utilities::pow(degree + 1, dim),
+                  dealii::ExcMessage("The subcell graph is only defined for "
+                                     "tensor product Lagrange elements"));
+
+#if DEAL_II_VERSION_GTE(9, 3, 0)
+      const auto lexicographic_to_hierarchic =
+          dealii::FETools::lexicographic_to_hierarchic_numbering<dim>(degree);
+#else
+      const auto lexicographic_to_hierarchic =
+          dealii::FETools::lexicographic_to_hierarchic_numbering<dim>(fe);
+#endif
+
+      /* Determine the lattice coordinates of every degree of freedom: */
+      std::vector<std::array<unsigned int, dim>> coordinates(dofs_per_cell);
+      for (unsigned int l = 0; l < dofs_per_cell; ++l) {
+        unsigned int rest = l;
+        for (unsigned int d = 0; d < dim; ++d) {
+          coordinates[lexicographic_to_hierarchic[l]][d] = rest % (degree + 1);
+          rest /= degree + 1;
+        }
+      }
+
+      dealii::Table<2, bool> dof_mask(dofs_per_cell, dofs_per_cell);
+      for (unsigned int i = 0; i < dofs_per_cell; ++i)
+        for (unsigned int j = 0; j < dofs_per_cell; ++j) {
+          bool neighbors = true;
+          for (unsigned int d = 0; d < dim; ++d)
+            if (coordinates[i][d] + 1 < coordinates[j][d] ||
+                coordinates[j][d] + 1 < coordinates[i][d])
+              neighbors = false;
+          dof_mask(i, j) = neighbors;
+        }
+
+      return dof_mask;
+    }
+
+    /**
+     * Given a @p dof_handler, and constraints @p affine_constraints this
+     * function creates the sparsity pattern of the Q1 subcell graph (see
+     * subcell_coupling_mask()) over all locally owned cells. For Q1 this
+     * is the usual sparsity pattern created by
+     * dealii::DoFTools::make_sparsity_pattern().
+     *
+     * @ingroup FiniteElement
+     */
+    template <int dim, typename Number, typename SPARSITY>
+    void make_sparsity_pattern(
+        const dealii::DoFHandler<dim> &dof_handler,
+        SPARSITY &dsp,
+        const dealii::AffineConstraints<Number> &affine_constraints,
+        bool keep_constrained)
+    {
+      const auto dof_mask = subcell_coupling_mask(dof_handler.get_fe());
+
+      const unsigned int dofs_per_cell = dof_handler.get_fe().dofs_per_cell;
+      std::vector<dealii::types::global_dof_index> dof_indices(dofs_per_cell);
+
+      for (auto cell : dof_handler.active_cell_iterators()) {
+        if (!cell->is_locally_owned())
+          continue;
+
+        cell->get_dof_indices(dof_indices);
+
+        affine_constraints.add_entries_local_to_global(
+            dof_indices, dsp, keep_constrained, dof_mask);
+      }
+    }
+
+    /**
+     * Given a @p dof_handler, and constraints @p affine_constraints this
+     * function creates an extended sparsity pattern (of the Q1 subcell
+     * graph) that also includes locally relevant to locally relevant
+     * couplings.
+     *
+     * @ingroup FiniteElement
+     */
+    template <int dim, typename Number, typename SPARSITY>
+    void make_extended_sparsity_pattern(
+        const dealii::DoFHandler<dim> &dof_handler,
+        SPARSITY &dsp,
+        const dealii::AffineConstraints<Number> &affine_constraints,
+        bool keep_constrained)
+    {
+      const auto dof_mask = subcell_coupling_mask(dof_handler.get_fe());
+
+      const unsigned int dofs_per_cell = dof_handler.get_fe().dofs_per_cell;
+      std::vector<dealii::types::global_dof_index> dof_indices(dofs_per_cell);
+
+      for (auto cell : dof_handler.active_cell_iterators()) {
+        /* iterate over locally owned cells and the ghost layer */
+        if (cell->is_artificial())
+          continue;
+
+        /* translate into local index ranges: */
+        cell->get_dof_indices(dof_indices);
+
+        affine_constraints.add_entries_local_to_global(
+            dof_indices, dsp, keep_constrained, dof_mask);
+      }
+    }
+  } // namespace DoFTools
+
+
   /**
    * The DoFRenumbering namespace contains a number of custom dof
    * renumbering functions.
@@ -88,6 +234,73 @@ namespace ryujin
      */
     using dealii::DoFRenumbering::Cuthill_McKee;
 
+    /**
+     * Reorder all locally owned degrees of freedom along a Hilbert space
+     * filling curve through their support points (scaled to the bounding
+     * box of the locally owned support points).
+     *
+     * In contrast to Cuthill McKee, which minimizes the bandwidth but
+     * creates long, thin level sets, the Hilbert order is cache
+     * oblivious: Every contiguous index range of any size (in particular
+     * ranges of the size of the L1 and L2 caches) covers a compact patch
+     * of the mesh, so that the column indices of consecutive rows touch
+     * almost the same set of state vector entries.
+     *
+     * @note The subsequent export_indices_first() and internal_range()
+     * renumberings are stable, i.e., they preserve the relative order
+     * established here within their respective index ranges.
+     *
+     * @ingroup FiniteElement
+     */
+    template <int dim>
+    void hilbert_curve(dealii::DoFHandler<dim> &dof_handler,
+                       const dealii::Mapping<dim> &mapping)
+    {
+      using namespace dealii;
+
+      const IndexSet &locally_owned = dof_handler.locally_owned_dofs();
+      const auto n_locally_owned = locally_owned.n_elements();
+
+      /* The locally owned index range has to be contiguous */
+      Assert(locally_owned.is_contiguous() == true,
+             dealii::ExcMessage(
+                 "Need a contiguous set of locally owned indices."));
+
+      /* Offset to translate from global to local index range */
+      const auto offset = n_locally_owned != 0 ? *locally_owned.begin() : 0;
+
+      std::map<types::global_dof_index, Point<dim>> support_points;
+      DoFTools::map_dofs_to_support_points(
+          mapping, dof_handler, support_points);
+
+      std::vector<Point<dim>> points(n_locally_owned);
+      for (const auto &[index, point] : support_points)
+        if (locally_owned.is_element(index))
+          points[index - offset] = point;
+
+      /* Use as many bits per coordinate as fit into a 64 bit key: */
+      constexpr int bits_per_dim = 64 / dim;
+
+      const auto integer_points =
+          Utilities::inverse_Hilbert_space_filling_curve(points, bits_per_dim);
+
+      std::vector<std::pair<std::uint64_t, unsigned int>> keys(
+          n_locally_owned);
+      for (unsigned int i = 0; i < n_locally_owned; ++i)
+        keys[i] = {Utilities::pack_integers<dim>(integer_points[i],
+                                                 bits_per_dim),
+                   i};
+
+      std::sort(keys.begin(), keys.end());
+
+      using dof_type = dealii::types::global_dof_index;
+      std::vector<dof_type> new_order(n_locally_owned);
+      for (unsigned int k = 0; k < n_locally_owned; ++k)
+        new_order[keys[k].second] = offset + k;
+
+      dof_handler.renumber_dofs(new_order);
+    }
+
     /**
      * Reorder all export indices in the locally owned index range to the
      * start of the index range.
@@ -267,56 +480,4 @@ namespace ryujin
     }
   } // namespace DoFRenumbering
 
-
-  /**
-   * The DoFTools namespace contains a number of custom dof tools
-   * functions.
-   *
-   * @ingroup FiniteElement
-   */
-  namespace DoFTools
-  {
-    /** Import a function from deal.II into the current namespace. */
-    using dealii::DoFTools::extract_locally_relevant_dofs;
-
-    /** Import a function from deal.II into the current namespace. */
-    using dealii::DoFTools::make_hanging_node_constraints;
-
-    /** Import a function from deal.II into the current namespace. */
-    using dealii::DoFTools::make_periodicity_constraints;
-
-    /** Import a function from deal.II into the current namespace. */
-    using dealii::DoFTools::make_sparsity_pattern;
-
-    /**
-     * Given a @p dof_handler, and constraints @p affine_constraints this
-     * function creates an extended sparsity pattern that also includes
-     * locally relevant to locally relevant couplings.
-     *
-     * @ingroup FiniteElement
-     */
-    template <int dim, typename Number, typename SPARSITY>
-    void make_extended_sparsity_pattern(
-        const dealii::DoFHandler<dim> &dof_handler,
-        SPARSITY &dsp,
-        const dealii::AffineConstraints<Number> &affine_constraints,
-        bool keep_constrained)
-    {
-      const unsigned int dofs_per_cell = dof_handler.get_fe().dofs_per_cell;
-      std::vector<dealii::types::global_dof_index> dof_indices(dofs_per_cell);
-
-      for (auto cell : dof_handler.active_cell_iterators()) {
-        /* iterate over locally owned cells and the ghost layer */
-        if (cell->is_artificial())
-          continue;
-
-        /* translate into local index ranges: */
-        cell->get_dof_indices(dof_indices);
-
-        affine_constraints.add_entries_local_to_global(
-            dof_indices, dsp, keep_constrained);
-      }
-    }
-  } // namespace DoFTools
-
 } // namespace ryujin
@@ -0,0 +1,174 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include <deal.II/base/exceptions.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace ryujin
+{
+  /**
+   * A small collection of error-bounded lossy compression primitives
+   * used for output and checkpointing.
+   *
+   * The error-bounded coder follows the prediction-quantization design
+   * of SZ @cite DiCappello2016: Every value is mapped onto a uniform
+   * lattice of spacing 2 * error_bound (which guarantees a pointwise
+   * reconstruction error of at most error_bound), the lattice index is
+   * predicted by the index of the preceding value, and the prediction
+   * residual is stored as a zigzag encoded variable length integer.
+   * Smooth fields thus compress to one or two bytes per value.
+   *
+   * @ingroup Miscellaneous
+   */
+  namespace LossyCompression
+  {
+    /**
+     * Round @p value to the nearest point of the lattice with spacing 2 *
+     * @p error_bound. A nonpositive error bound disables rounding.
+     */
+    template <typename Number>
+    inline Number round_to_error_bound(const Number value,
+                                       const Number error_bound)
+    {
+      if (error_bound <= Number(0.) || !std::isfinite(value))
+        return value;
+      const Number spacing = Number(2.) * error_bound;
+      return spacing * std::round(value / spacing);
+    }
+
+
+    /**
+     * Round a @p value in the interval [-1, 1] to a fixed rate
+     * representation with @p bits bits. Zero bits disable rounding.
+     */
+    template <typename Number>
+    inline Number round_to_fixed_rate(const Number value,
+                                      const unsigned int bits)
+    {
+      if (bits == 0 || bits >= 32)
+        return value;
+      const Number levels = Number((1u << (bits - 1)) - 1u);
+      if (levels == Number(0.))
+        return Number(0.);
+      return std::round(value * levels) / levels;
+    }
+
+
+    /**
+     * Compress @p n_values values stored at @p values with stride @p
+     * stride. If @p error_bound is nonpositive, or if a value cannot be
+     * represented on the quantization lattice, all values are stored
+     * verbatim.
+     */
+    template <typename Number>
+    std::vector<unsigned char> compress(const Number *values,
+                                        const std::size_t n_values,
+                                        const unsigned int stride,
+                                        const Number error_bound)
+    {
+      /* Largest lattice index we are willing to handle: */
+      constexpr double max_index = 4503599627370496.; /* 2^52 */
+
+      const Number spacing = Number(2.) * error_bound;
+
+      bool quantize = error_bound > Number(0.);
+      for (std::size_t i = 0; quantize && i < n_values; ++i) {
+        const Number value = values[i * stride];
+        if (!std::isfinite(value) || std::abs(value / spacing) > max_index)
+          quantize = false;
+      }
+
+      std::vector<unsigned char> bytes;
+
+      if (!quantize) {
+        bytes.resize(1 + n_values * sizeof(Number));
+        bytes[0] = 0;
+        for (std::size_t i = 0; i < n_values; ++i)
+          std::memcpy(bytes.data() + 1 + i * sizeof(Number),
+                      values + i * stride,
+                      sizeof(Number));
+        return bytes;
+      }
+
+      bytes.reserve(1 + 2 * n_values);
+      bytes.push_back(1);
+
+      std::int64_t previous = 0;
+      for (std::size_t i = 0; i < n_values; ++i) {
+        const std::int64_t index = std::llround(values[i * stride] / spacing);
+        const std::int64_t residual = index - previous;
+        previous = index;
+
+        /* Zigzag and LEB128 encoding: */
+        auto u = (static_cast<std::uint64_t>(residual) << 1) ^
+                 static_cast<std::uint64_t>(residual >> 63);
+        while (u >= 0x80) {
+          bytes.push_back(static_cast<unsigned char>(u | 0x80));
+          u >>= 7;
+        }
+        bytes.push_back(static_cast<unsigned char>(u));
+      }
+
+      return bytes;
+    }
+
+
+    /**
+     * Decompress a byte stream created by compress() into @p n_values
+     * values stored at @p values with stride @p stride. The same @p
+     * error_bound has to be used as for compression.
+     */
+    template <typename Number>
+    void decompress(const std::vector<unsigned char> &bytes,
+                    Number *values,
+                    const std::size_t n_values,
+                    const unsigned int stride,
+                    const Number error_bound)
+    {
+      AssertThrow(!bytes.empty(),
+                  dealii::ExcMessage("Corrupted compressed data stream"));
+
+      if (bytes[0] == 0) {
+        AssertThrow(bytes.size() == 1 + n_values * sizeof(Number),
+                    dealii::ExcMessage("Corrupted compressed data stream"));
+        for (std::size_t i = 0; i < n_values; ++i)
+          std::memcpy(values + i * stride,
+                      bytes.data() + 1 + i * sizeof(Number),
+                      sizeof(Number));
+        return;
+      }
+
+      const Number spacing = Number(2.) * error_bound;
+
+      std::size_t position = 1;
+      std::int64_t previous = 0;
+      for (std::size_t i = 0; i < n_values; ++i) {
+        std::uint64_t u = 0;
+        unsigned int shift = 0;
+        while (true) {
+          AssertThrow(position < bytes.size() && shift < 64,
+                      dealii::ExcMessage("Corrupted compressed data stream"));
+          const unsigned char byte = bytes[position++];
+          u |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+          shift += 7;
+          if ((byte & 0x80) == 0)
+            break;
+        }
+
+        const auto residual = static_cast<std::int64_t>(u >> 1) ^
+                              -static_cast<std::int64_t>(u & 1);
+        previous += residual;
+        values[i * stride] = spacing * Number(previous);
+      }
+    }
+  } /* namespace LossyCompression */
+
+} /* namespace ryujin */
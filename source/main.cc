@@ -5,7 +5,9 @@
 
 #include <compile_time_options.h>
 
+#include "in_transit_output.h"
 #include "introspection.h"
+#include "isa_dispatch.h"
 #include "time_loop.h"
 
 #include <deal.II/base/multithread_info.h>
@@ -13,10 +15,17 @@
 
 #include <omp.h>
 
+#include <cstdlib>
 #include <fstream>
 
 int main (int argc, char *argv[])
 {
+  /*
+   * Replace this process by the best instruction set variant of the
+   * executable (if any) before MPI is initialized:
+   */
+  ryujin::dispatch_isa_variant(argc, argv);
+
 #if defined(DENORMALS_ARE_ZERO) && defined(__x86_64)
   /*
    * Change rounding mode on X86-64 architecture: Denormals are flushed to
@@ -36,11 +45,28 @@ int main (int argc, char *argv[])
   omp_set_num_threads(dealii::MultithreadInfo::n_threads());
   LSAN_ENABLE
 
+  /*
+   * Split off dedicated I/O ranks for in-transit output. The number of
+   * I/O ranks per node has to be known before any of the (parameter
+   * dependent) objects are created, so it is passed as environment
+   * variable:
+   */
+
+  const char *io_ranks = std::getenv("RYUJIN_IO_RANKS_PER_NODE");
+  ryujin::InTransitOutput in_transit_output(
+      MPI_COMM_WORLD, io_ranks != nullptr ? std::stoi(io_ranks) : 0);
+
+  if (in_transit_output.is_server()) {
+    in_transit_output.serve();
+    return 0;
+  }
+
   LIKWID_INIT
 
-  MPI_Comm mpi_communicator(MPI_COMM_WORLD);
+  const MPI_Comm &mpi_communicator = in_transit_output.communicator();
 
-  ryujin::TimeLoop<DIM, NUMBER> time_loop(mpi_communicator);
+  ryujin::TimeLoop<DIM, NUMBER> time_loop(mpi_communicator,
+                                          &in_transit_output);
 
   if (dealii::Utilities::MPI::this_mpi_process(mpi_communicator) == 0)
     std::cout << "[INFO] initiating flux capacitor" << std::endl;
@@ -0,0 +1,308 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/exceptions.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ryujin
+{
+  /**
+   * A read-only file that is mapped into memory with mmap().
+   *
+   * The file is mapped privately with copy-on-write semantic: Pages that
+   * are only read are backed by the page cache, i.e., they are loaded
+   * lazily on the first page fault and are shared among all processes on
+   * the same node that map the same file. Writing to the mapped memory
+   * creates a private copy of the affected page and never modifies the
+   * file.
+   *
+   * @ingroup Miscellaneous
+   */
+  class MemoryMappedFile
+  {
+  public:
+    /**
+     * Map the file @p file_name into memory.
+     */
+    MemoryMappedFile(const std::string &file_name)
+        : data_(nullptr)
+        , size_(0)
+    {
+      const int fd = ::open(file_name.c_str(), O_RDONLY);
+      AssertThrow(fd >= 0,
+                  dealii::ExcMessage("Could not open file \"" + file_name +
+                                     "\" for memory mapping"));
+
+      struct stat status;
+      const int ierr = ::fstat(fd, &status);
+      if (ierr == 0 && status.st_size > 0) {
+        size_ = status.st_size;
+        void *address = ::mmap(nullptr,
+                               size_,
+                               PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE,
+                               fd,
+                               0);
+        data_ = address == MAP_FAILED ? nullptr : static_cast<char *>(address);
+      }
+      ::close(fd);
+
+      AssertThrow(ierr == 0 && (size_ == 0 || data_ != nullptr),
+                  dealii::ExcMessage("Could not memory map file \"" +
+                                     file_name + "\""));
+    }
+
+    MemoryMappedFile(const MemoryMappedFile &) = delete;
+    MemoryMappedFile &operator=(const MemoryMappedFile &) = delete;
+
+    ~MemoryMappedFile()
+    {
+      if (data_ != nullptr)
+        ::munmap(data_, size_);
+    }
+
+    /**
+     * Return a pointer to the beginning of the (page aligned) mapping.
+     */
+    char *data() const
+    {
+      return data_;
+    }
+
+    /**
+     * Return the size of the mapped file in bytes.
+     */
+    std::size_t size() const
+    {
+      return size_;
+    }
+
+    /**
+     * The alignment of all arrays written by MemoryMappedFileWriter.
+     */
+    static std::size_t page_size()
+    {
+      return ::sysconf(_SC_PAGESIZE);
+    }
+
+  private:
+    char *data_;
+    std::size_t size_;
+  };
+
+
+  /**
+   * Write arrays into a binary file such that every array starts at a
+   * page boundary and can be mapped with MemoryMappedFile.
+   *
+   * @ingroup Miscellaneous
+   */
+  class MemoryMappedFileWriter
+  {
+  public:
+    /**
+     * Open (and truncate) the file @p file_name.
+     */
+    MemoryMappedFileWriter(const std::string &file_name)
+        : file_(file_name, std::ios::binary | std::ios::trunc)
+        , offset_(0)
+    {
+      AssertThrow(file_.is_open(),
+                  dealii::ExcMessage("Could not open file \"" + file_name +
+                                     "\" for writing"));
+    }
+
+    /**
+     * Append the array [@p data, @p data + @p size) and return its offset
+     * (in bytes) from the beginning of the file.
+     */
+    template <typename T>
+    std::size_t write(const T *data, const std::size_t size)
+    {
+      const std::size_t page_size = MemoryMappedFile::page_size();
+      const std::size_t padding = (page_size - offset_ % page_size) % page_size;
+      const std::vector<char> zeros(padding, 0);
+      file_.write(zeros.data(), padding);
+      offset_ += padding;
+
+      const std::size_t offset = offset_;
+      file_.write(reinterpret_cast<const char *>(data), size * sizeof(T));
+      offset_ += size * sizeof(T);
+
+      AssertThrow(file_.good(), dealii::ExcMessage("Could not write file"));
+      return offset;
+    }
+
+  private:
+    std::ofstream file_;
+    std::size_t offset_;
+  };
+
+
+  /**
+   * A contiguous array that either owns its storage (as a
+   * dealii::AlignedVector) or refers to an array inside of a
+   * MemoryMappedFile. In the latter case the vector keeps the mapping
+   * alive. Resizing the vector always switches back to owned storage.
+   *
+   * @ingroup Miscellaneous
+   */
+  template <typename T>
+  class MappableVector
+  {
+  public:
+    MappableVector()
+        : data_(nullptr)
+        , size_(0)
+    {
+    }
+
+    MappableVector(const MappableVector &other)
+    {
+      *this = other;
+    }
+
+    MappableVector &operator=(const MappableVector &other)
+    {
+      vector_ = other.vector_;
+      file_ = other.file_;
+      size_ = other.size_;
+      data_ = file_ ? other.data_ : vector_.data();
+      return *this;
+    }
+
+    /**
+     * Resize the (owned) storage to @p size elements. The content is
+     * left uninitialized for trivial types.
+     */
+    void resize_fast(const std::size_t size)
+    {
+      file_.reset();
+      vector_.resize_fast(size);
+      data_ = vector_.data();
+      size_ = size;
+    }
+
+    std::size_t size() const
+    {
+      return size_;
+    }
+
+    T *data()
+    {
+      return data_;
+    }
+
+    const T *data() const
+    {
+      return data_;
+    }
+
+    T *begin()
+    {
+      return data_;
+    }
+
+    const T *begin() const
+    {
+      return data_;
+    }
+
+    T *end()
+    {
+      return data_ + size_;
+    }
+
+    const T *end() const
+    {
+      return data_ + size_;
+    }
+
+    const T &back() const
+    {
+      Assert(size_ > 0, dealii::ExcInternalError());
+      return data_[size_ - 1];
+    }
+
+    T &operator[](const std::size_t index)
+    {
+      AssertIndexRange(index, size_);
+      return data_[index];
+    }
+
+    const T &operator[](const std::size_t index) const
+    {
+      AssertIndexRange(index, size_);
+      return data_[index];
+    }
+
+    /**
+     * Return whether the vector refers to a MemoryMappedFile.
+     */
+    bool is_mapped() const
+    {
+      return file_ != nullptr;
+    }
+
+    /**
+     * Return the memory consumption in bytes. For a mapped vector this is
+     * the size of the mapped array (that is backed by the page cache).
+     */
+    std::size_t memory_consumption() const
+    {
+      return is_mapped() ? size_ * sizeof(T) : vector_.memory_consumption();
+    }
+
+    /**
+     * Append the vector to @p writer and store its size and offset in
+     * the boost archive @p archive.
+     */
+    template <typename Archive>
+    void save(Archive &archive, MemoryMappedFileWriter &writer) const
+    {
+      const std::size_t offset = writer.write(data_, size_);
+      archive << size_ << offset;
+    }
+
+    /**
+     * Map an array written by save() from the file @p file without
+     * copying.
+     */
+    template <typename Archive>
+    void load(Archive &archive,
+              const std::shared_ptr<const MemoryMappedFile> &file)
+    {
+      std::size_t size = 0;
+      std::size_t offset = 0;
+      archive >> size >> offset;
+      AssertThrow(offset + size * sizeof(T) <= file->size(),
+                  dealii::ExcMessage("Corrupted memory mapped file"));
+
+      vector_.clear();
+      file_ = file;
+      data_ = reinterpret_cast<T *>(file->data() + offset);
+      size_ = size;
+    }
+
+  private:
+    dealii::AlignedVector<T> vector_;
+    std::shared_ptr<const MemoryMappedFile> file_;
+    T *data_;
+    std::size_t size_;
+  };
+
+} /* namespace ryujin */
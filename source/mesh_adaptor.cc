@@ -0,0 +1,13 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#include "mesh_adaptor.template.h"
+
+namespace ryujin
+{
+  /* instantiations */
+  template class ryujin::MeshAdaptor<DIM, NUMBER>;
+
+} /* namespace ryujin */
@@ -0,0 +1,145 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include <compile_time_options.h>
+
+#include "convenience_macros.h"
+#include "discretization.h"
+#include "euler_module.h"
+#include "offline_data.h"
+
+#include <deal.II/base/parameter_acceptor.h>
+#include <deal.II/base/timer.h>
+
+#include <map>
+
+namespace ryujin
+{
+  /**
+   * Adaptive mesh refinement driven by the graph viscosity of the
+   * EulerModule.
+   *
+   * Every "adaptation interval" cycles the cells of the (distributed)
+   * triangulation are flagged for refinement and coarsening with a fixed
+   * fraction strategy (see dealii::parallel::distributed::GridRefinement)
+   * with respect to a cell-wise refinement indicator: the maximum of
+   * either the residual viscosity \f$\mu_{\text{res}}\f$ (see
+   * EulerModule::compute_residual_mu()), or the indicator \f$\alpha_i\f$
+   * over all degrees of freedom of the cell. Both are computed during
+   * the last time step and thus concentrate the degrees of freedom at
+   * shocks and contact discontinuities.
+   *
+   * In addition, the class monitors the load balance: Every "rebalance
+   * interval" cycles the wall time every rank spent in the time stepping
+   * kernels (all "time step" Scope timers except for synchronization) is
+   * compared to the average over all ranks. If the imbalance (max / avg)
+   * exceeds "rebalance threshold", the per-cell cost of interior and
+   * boundary cells is estimated with a least squares fit of the measured
+   * times against the number of locally owned interior and boundary
+   * cells of all ranks, and the mesh is repartitioned with the resulting
+   * boundary cell weight (see Discretization::set_boundary_cell_weight()).
+   * Accurate measurements require SPLIT_SYNCHRONIZATION_TIMERS, otherwise
+   * waiting times are partially attributed to the kernels.
+   *
+   * The actual refinement and repartitioning (including the transfer of
+   * the state vector) is performed by the TimeLoop.
+   *
+   * @ingroup TimeLoop
+   */
+  template <int dim, typename Number = double>
+  class MeshAdaptor final : public dealii::ParameterAcceptor
+  {
+  public:
+    /**
+     * @copydoc OfflineData::scalar_type
+     */
+    using scalar_type = typename OfflineData<dim, Number>::scalar_type;
+
+    /**
+     * Constructor.
+     */
+    MeshAdaptor(const MPI_Comm &mpi_communicator,
+                const ryujin::OfflineData<dim, Number> &offline_data,
+                ryujin::EulerModule<dim, Number> &euler_module,
+                const std::string &subsection = "MeshAdaptor");
+
+    /**
+     * Return true if the mesh shall be adapted in the given @p cycle.
+     */
+    bool need_adaptation(const unsigned int cycle) const
+    {
+      /* Nota bene: a refinement indicator is only available after the
+       * first time step: */
+      return adaptation_interval_ != 0 && cycle > 1 &&
+             cycle % adaptation_interval_ == 0;
+    }
+
+    /**
+     * Compute the cell-wise refinement indicator and set refinement and
+     * coarsening flags on @p triangulation (which has to be the
+     * triangulation the OfflineData object is based on).
+     *
+     * The function requires MPI communication.
+     */
+    void mark_cells(typename Discretization<dim>::Triangulation &triangulation);
+
+    /**
+     * Measure the load imbalance for the given @p cycle from the
+     * accumulated @p computing_timer and return true if the mesh shall be
+     * repartitioned. In this case boundary_cell_weight() returns the
+     * updated, measured weight of a boundary cell.
+     *
+     * The function requires MPI communication and has to be called in
+     * every cycle.
+     */
+    bool need_rebalancing(
+        const unsigned int cycle,
+        const std::map<std::string, dealii::Timer> &computing_timer);
+
+  private:
+    /**
+     * @name Run time options
+     */
+    //@{
+
+    unsigned int adaptation_interval_;
+    ACCESSOR_READ_ONLY(adaptation_interval)
+
+    std::string indicator_;
+
+    double refinement_fraction_;
+    double coarsening_fraction_;
+
+    unsigned int min_refinement_level_;
+    unsigned int max_refinement_level_;
+
+    unsigned int rebalance_interval_;
+    double rebalance_threshold_;
+
+    //@}
+    /**
+     * @name Internal data
+     */
+    //@{
+
+    const MPI_Comm &mpi_communicator_;
+
+    dealii::SmartPointer<const ryujin::OfflineData<dim, Number>> offline_data_;
+    dealii::SmartPointer<ryujin::EulerModule<dim, Number>> euler_module_;
+
+    double previous_time_;
+
+    double imbalance_;
+    ACCESSOR_READ_ONLY(imbalance)
+
+    unsigned int boundary_cell_weight_;
+    ACCESSOR_READ_ONLY(boundary_cell_weight)
+
+    //@}
+  };
+
+} /* namespace ryujin */
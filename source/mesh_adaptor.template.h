@@ -0,0 +1,234 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include "mesh_adaptor.h"
+
+#include <deal.II/distributed/grid_refinement.h>
+#include <deal.II/lac/vector.h>
+
+#include <array>
+
+namespace ryujin
+{
+  using namespace dealii;
+
+  template <int dim, typename Number>
+  MeshAdaptor<dim, Number>::MeshAdaptor(
+      const MPI_Comm &mpi_communicator,
+      const ryujin::OfflineData<dim, Number> &offline_data,
+      ryujin::EulerModule<dim, Number> &euler_module,
+      const std::string &subsection /*= "MeshAdaptor"*/)
+      : ParameterAcceptor(subsection)
+      , mpi_communicator_(mpi_communicator)
+      , offline_data_(&offline_data)
+      , euler_module_(&euler_module)
+      , previous_time_(0.)
+      , imbalance_(1.)
+      , boundary_cell_weight_(0u)
+  {
+    adaptation_interval_ = 0;
+    add_parameter("adaptation interval",
+                  adaptation_interval_,
+                  "Number of cycles between two adaptations of the mesh. A "
+                  "value of 0 disables adaptive mesh refinement");
+
+    indicator_ = "residual mu";
+    add_parameter("indicator",
+                  indicator_,
+                  "Refinement indicator - valid options are \"residual mu\" "
+                  "and \"alpha\"");
+
+    refinement_fraction_ = 0.3;
+    add_parameter("refinement fraction",
+                  refinement_fraction_,
+                  "Fraction of the total refinement indicator that is "
+                  "captured by the cells flagged for refinement");
+
+    coarsening_fraction_ = 0.05;
+    add_parameter("coarsening fraction",
+                  coarsening_fraction_,
+                  "Fraction of the total refinement indicator that is "
+                  "captured by the cells flagged for coarsening");
+
+    min_refinement_level_ = 0;
+    add_parameter("minimal refinement level",
+                  min_refinement_level_,
+                  "Cells on this (or a coarser) level are not coarsened");
+
+    max_refinement_level_ = 10;
+    add_parameter("maximal refinement level",
+                  max_refinement_level_,
+                  "Cells on this (or a finer) level are not refined");
+
+    rebalance_interval_ = 0;
+    add_parameter("rebalance interval",
+                  rebalance_interval_,
+                  "Number of cycles between two measurements of the load "
+                  "imbalance. A value of 0 disables dynamic load balancing, "
+                  "which also requires \"mesh repartitioning\"");
+
+    rebalance_threshold_ = 1.1;
+    add_parameter("rebalance threshold",
+                  rebalance_threshold_,
+                  "Repartition the mesh with measured cell weights if the "
+                  "ratio of the maximal over the average kernel time of all "
+                  "ranks exceeds this threshold");
+  }
+
+
+  template <int dim, typename Number>
+  void MeshAdaptor<dim, Number>::mark_cells(
+      typename Discretization<dim>::Triangulation &triangulation)
+  {
+#ifdef DEBUG_OUTPUT
+    std::cout << "MeshAdaptor<dim, Number>::mark_cells()" << std::endl;
+#endif
+
+    AssertThrow(indicator_ == "residual mu" || indicator_ == "alpha",
+                ExcMessage("Unknown refinement indicator \"" + indicator_ +
+                           "\""));
+
+    /*
+     * Copy the dof-wise indicator into a temporary vector with ghost
+     * values (residual_mu() is only computed for locally owned degrees
+     * of freedom):
+     */
+
+    scalar_type indicator;
+    indicator.reinit(offline_data_->scalar_partitioner());
+
+    if (indicator_ == "residual mu") {
+      euler_module_->compute_residual_mu();
+      indicator.copy_locally_owned_data_from(euler_module_->residual_mu());
+    } else {
+      indicator.copy_locally_owned_data_from(euler_module_->alpha());
+    }
+    indicator.update_ghost_values();
+
+    /* Cell-wise maximum: */
+
+    const auto &dof_handler = offline_data_->dof_handler();
+    const auto &scalar_partitioner = offline_data_->scalar_partitioner();
+
+    Vector<float> criteria(triangulation.n_active_cells());
+    std::vector<types::global_dof_index> dof_indices(
+        dof_handler.get_fe().dofs_per_cell);
+
+    for (const auto &cell : dof_handler.active_cell_iterators()) {
+      if (!cell->is_locally_owned())
+        continue;
+
+      cell->get_dof_indices(dof_indices);
+
+      float value = 0.;
+      for (const auto index : dof_indices) {
+        const auto i = scalar_partitioner->global_to_local(index);
+        value = std::max(value, float(std::abs(indicator.local_element(i))));
+      }
+      criteria[cell->active_cell_index()] = value;
+    }
+
+    parallel::distributed::GridRefinement::refine_and_coarsen_fixed_fraction(
+        triangulation, criteria, refinement_fraction_, coarsening_fraction_);
+
+    /* Enforce the minimal and maximal refinement level: */
+
+    for (const auto &cell : triangulation.active_cell_iterators()) {
+      if (!cell->is_locally_owned())
+        continue;
+      if (cell->level() >= static_cast<int>(max_refinement_level_))
+        cell->clear_refine_flag();
+      if (cell->level() <= static_cast<int>(min_refinement_level_))
+        cell->clear_coarsen_flag();
+    }
+  }
+
+
+
+  template <int dim, typename Number>
+  bool MeshAdaptor<dim, Number>::need_rebalancing(
+      const unsigned int cycle,
+      const std::map<std::string, dealii::Timer> &computing_timer)
+  {
+    if (rebalance_interval_ == 0 || cycle % rebalance_interval_ != 0)
+      return false;
+
+#ifdef DEBUG_OUTPUT
+    std::cout << "MeshAdaptor<dim, Number>::need_rebalancing()" << std::endl;
+#endif
+
+    AssertThrow(offline_data_->discretization().repartitioning(),
+                ExcMessage("Dynamic load balancing requires \"mesh "
+                           "repartitioning\" to be enabled"));
+
+    /* Measure the time spent in all kernels since the last measurement: */
+
+    double current_time = 0.;
+    for (const auto &[name, timer] : computing_timer) {
+      if (name.rfind("time step", 0) != 0 ||
+          name.find("synchronization") != std::string::npos)
+        continue;
+      current_time += timer.wall_time();
+    }
+    const double time = current_time - previous_time_;
+    previous_time_ = current_time;
+
+    const auto statistics =
+        Utilities::MPI::min_max_avg(time, mpi_communicator_);
+    imbalance_ = statistics.avg > 0. ? statistics.max / statistics.avg : 1.;
+
+    if (imbalance_ <= rebalance_threshold_)
+      return false;
+
+    /*
+     * Fit the measured times T_r of all ranks against the number of
+     * interior cells I_r and boundary cells B_r, T_r ~ a I_r + b B_r, and
+     * derive the weight of a boundary cell from the ratio b / a:
+     */
+
+    const auto &triangulation = offline_data_->discretization().triangulation();
+
+    double n_interior = 0.;
+    double n_boundary = 0.;
+    for (const auto &cell : triangulation.active_cell_iterators()) {
+      if (!cell->is_locally_owned())
+        continue;
+      if (cell->at_boundary())
+        n_boundary += 1.;
+      else
+        n_interior += 1.;
+    }
+
+    std::array<double, 5> sums{{n_interior * n_interior,
+                                n_interior * n_boundary,
+                                n_boundary * n_boundary,
+                                n_interior * time,
+                                n_boundary * time}};
+    MPI_Allreduce(MPI_IN_PLACE,
+                  sums.data(),
+                  sums.size(),
+                  MPI_DOUBLE,
+                  MPI_SUM,
+                  mpi_communicator_);
+
+    /* Keep the current weight if the fit is meaningless: */
+    boundary_cell_weight_ =
+        offline_data_->discretization().boundary_cell_weight();
+
+    const double determinant = sums[0] * sums[2] - sums[1] * sums[1];
+    if (determinant > 1.e-12 * sums[0] * sums[2]) {
+      const double a = (sums[2] * sums[3] - sums[1] * sums[4]) / determinant;
+      const double b = (sums[0] * sums[4] - sums[1] * sums[3]) / determinant;
+      if (a > 0. && b > 0.)
+        boundary_cell_weight_ = static_cast<unsigned int>(
+            1000. * std::min(std::max(b / a - 1., 0.), 100.));
+    }
+
+    return true;
+  }
+
+} /* namespace ryujin */
@@ -5,12 +5,22 @@
 
 #pragma once
 
+#include <compile_time_options.h>
+
+#include "openmp.h"
+#include "shared_memory_exchange.h"
 #include "simd.h"
 
+#include <deal.II/base/array_view.h>
 #include <deal.II/base/partitioner.h>
 #include <deal.II/base/vectorization.h>
 #include <deal.II/lac/la_parallel_vector.h>
 
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <vector>
+
 namespace ryujin
 {
   /**
@@ -62,19 +72,63 @@ namespace ryujin
   }
 
 
+  /**
+   * The memory layout of the locally stored part of a
+   * MultiComponentVector. Let (U_i)_k denote the k-th component of the
+   * vector element U_i, let n_owned denote the number of locally owned
+   * elements, and n_ghost the number of ghost elements.
+   *
+   * @ingroup SIMD
+   */
+  enum class MultiComponentLayout {
+    /**
+     * Interleaved storage: (U_i)_k is stored at position i * n_comp + k.
+     * Loading and storing all components of a SIMD batch of elements
+     * requires a transpose, but gathering the state of an arbitrary
+     * element touches a single cache line.
+     */
+    array_of_structures,
+
+    /**
+     * Component-wise storage: (U_i)_k is stored at position k * n_owned
+     * + i for locally owned elements and at n_comp * n_owned + k *
+     * n_ghost + (i - n_owned) for ghost elements. The locally owned part
+     * of every component is thus a contiguous array that can be loaded
+     * and stored with aligned SIMD instructions, and that can be handed
+     * out as a view with component().
+     */
+    structure_of_arrays
+  };
+
+
   /**
    * A wrapper around dealii::LinearAlgebra::distributed::Vector<Number>
    * that stores a vector element of @p n_comp components per entry
-   * (instead of a scalar value).
+   * (instead of a scalar value). The memory layout is selected with
+   * @p layout, see MultiComponentLayout.
    *
    * @note reinit() has to be called with an appropriate "vector" MPI
-   * partitioner created by create_vector_partitioner().
+   * partitioner created by create_vector_partitioner(). A vector with
+   * MultiComponentLayout::structure_of_arrays layout must be initialized
+   * with reinit_with_scalar_partitioner() instead. Such a vector
+   * exchanges ghost values with its own update_ghost_values() function;
+   * compress() is not supported.
+   *
+   * @note If ryujin is configured with USE_SHARED_MEMORY_EXCHANGE, a
+   * vector with the (default) MultiComponentLayout::array_of_structures
+   * layout exchanges ghost values through a SharedMemoryExchange that is
+   * created on the first exchange (and recreated whenever the MPI
+   * partitioner changes). The exchange is shared between copies of the
+   * vector, two copies must therefore not update their ghost values
+   * concurrently.
    *
    * @ingroup SIMD
    */
   template <typename Number,
             int n_comp,
-            int simd_length = dealii::VectorizedArray<Number>::size()>
+            int simd_length = dealii::VectorizedArray<Number>::size(),
+            MultiComponentLayout layout =
+                MultiComponentLayout::array_of_structures>
   class MultiComponentVector
       : public dealii::LinearAlgebra::distributed::Vector<Number>
   {
@@ -109,6 +163,49 @@ namespace ryujin
         const std::shared_ptr<const dealii::Utilities::MPI::Partitioner>
             &scalar_partitioner);
 
+    /**
+     * Update ghost values. For the
+     * MultiComponentLayout::array_of_structures layout this simply calls
+     * update_ghost_values_start() and update_ghost_values_finish().
+     * Otherwise all components are exchanged independently (but
+     * concurrently) with the scalar MPI partitioner.
+     */
+    void update_ghost_values() const;
+
+    /**
+     * Start a nonblocking ghost exchange. This calls the function of the
+     * base class unless ryujin is configured with
+     * USE_SHARED_MEMORY_EXCHANGE, in which case the exchange goes through
+     * a SharedMemoryExchange: Ghost values owned by MPI ranks on the same
+     * node are then copied directly out of the shared send buffer of the
+     * owner, and only off-node ghost values are sent with MPI messages.
+     * The @p communication_channel is ignored in the latter case.
+     *
+     * Only available for the MultiComponentLayout::array_of_structures
+     * layout.
+     */
+    void update_ghost_values_start(
+        const unsigned int communication_channel = 0) const;
+
+    /**
+     * Finish a nonblocking ghost exchange started with
+     * update_ghost_values_start().
+     */
+    void update_ghost_values_finish() const;
+
+    /**
+     * Return a view of the locally owned part of component @p component.
+     * Only available for the MultiComponentLayout::structure_of_arrays
+     * layout.
+     */
+    dealii::ArrayView<Number> component(const unsigned int component);
+
+    /**
+     * @copydoc component()
+     */
+    dealii::ArrayView<const Number>
+    component(const unsigned int component) const;
+
     /**
      * Extracts a single component out of the MultiComponentVector and
      * stores it in @p scalar_vector. The destination vector must have a
@@ -191,14 +288,46 @@ namespace ryujin
      */
     template <typename Tensor = dealii::Tensor<1, n_comp, VectorizedArray>>
     void write_vectorized_tensor(const Tensor &tensor, const unsigned int i);
+
+    /**
+     * Variant of above function.
+     * Updates the values of the @p n_comp component vectors at indices
+     * *(js), *(js+1), ..., *(js+simd_length-1) with the values supplied
+     * by @p tensor, i.e., @p js has to point to an array of size @p
+     * simd_length containing all indices. If an index occurs more than
+     * once, the value of the last lane is stored.
+     */
+    template <typename Tensor = dealii::Tensor<1, n_comp, VectorizedArray>>
+    void write_vectorized_tensor(const Tensor &tensor, const unsigned int *js);
+
+  private:
+    /**
+     * Return the position of component @p k of the vector element @p i
+     * in the local storage.
+     */
+    unsigned int position(const unsigned int i, const unsigned int k) const;
+
+    std::shared_ptr<const dealii::Utilities::MPI::Partitioner>
+        scalar_partitioner_;
+    unsigned int n_owned_ = 0;
+    unsigned int n_ghost_ = 0;
+
+#ifdef USE_SHARED_MEMORY_EXCHANGE
+    mutable std::shared_ptr<SharedMemoryExchange> shared_memory_exchange_;
+    mutable std::shared_ptr<const dealii::Utilities::MPI::Partitioner>
+        shared_memory_exchange_partitioner_;
+#endif
   };
 
 
 #ifndef DOXYGEN
   /* Template definitions: */
 
-  template <typename Number, int n_comp, int simd_length>
-  void MultiComponentVector<Number, n_comp, simd_length>::
+  template <typename Number,
+            int n_comp,
+            int simd_length,
+            MultiComponentLayout layout>
+  void MultiComponentVector<Number, n_comp, simd_length, layout>::
       reinit_with_scalar_partitioner(
           const std::shared_ptr<const dealii::Utilities::MPI::Partitioner>
               &scalar_partitioner)
@@ -206,115 +335,412 @@ namespace ryujin
     auto vector_partitioner =
         create_vector_partitioner<n_comp>(scalar_partitioner);
 
-    dealii::LinearAlgebra::distributed::Vector<Number>::reinit(
-        vector_partitioner);
+    scalar_partitioner_ = scalar_partitioner;
+    n_owned_ = scalar_partitioner->local_size();
+    n_ghost_ = scalar_partitioner->n_ghost_indices();
+
+    /*
+     * Allocate memory without zeroing it out: dealii::Vector::reinit()
+     * with omit_zeroing_entries set to true only allocates memory but
+     * does not touch it.
+     *
+     * Nota bene: deal.II offers no way to set up a vector with a given
+     * partitioner without allocating (and zeroing) storage, so the
+     * temporary template vector is allocated and zeroed (serially) as
+     * well. For the duration of this call the memory footprint of the
+     * vector therefore doubles. The temporary is released before the
+     * first touch below, so the placement of the memory pages of *this
+     * is not affected.
+     */
+    {
+      scalar_type temp(vector_partitioner);
+      dealii::LinearAlgebra::distributed::Vector<Number>::reinit(
+          temp, /*omit_zeroing_entries*/ true);
+    }
+
+    /*
+     * Now, first touch all memory pages with the same static OpenMP
+     * schedule that is used in the compute kernels. This places memory
+     * pages on the NUMA domain of the thread that subsequently works on
+     * them:
+     */
+
+    const unsigned int n_scalar = n_owned_ + n_ghost_;
+    Number *data = this->begin();
+
+    RYUJIN_PARALLEL_REGION_BEGIN
+    RYUJIN_OMP_FOR
+    for (unsigned int i = 0; i < n_scalar; i += simd_length) {
+      const unsigned int end = std::min(i + simd_length, n_scalar);
+      if constexpr (layout == MultiComponentLayout::array_of_structures) {
+        std::fill(data + i * n_comp, data + end * n_comp, Number(0.));
+      } else {
+        for (unsigned int j = i; j < end; ++j)
+          for (unsigned int k = 0; k < n_comp; ++k)
+            data[position(j, k)] = Number(0.);
+      }
+    }
+    RYUJIN_PARALLEL_REGION_END
+  }
+
+
+  template <typename Number,
+            int n_comp,
+            int simd_length,
+            MultiComponentLayout layout>
+  void MultiComponentVector<Number, n_comp, simd_length, layout>::
+      update_ghost_values() const
+  {
+    if constexpr (layout == MultiComponentLayout::array_of_structures) {
+      update_ghost_values_start();
+      update_ghost_values_finish();
+    } else {
+      Assert(scalar_partitioner_ != nullptr,
+             dealii::ExcMessage("The vector has to be initialized with "
+                                "reinit_with_scalar_partitioner()"));
+
+      const unsigned int n_import = scalar_partitioner_->n_import_indices();
+      std::vector<Number> import_data(n_comp * n_import);
+      std::array<std::vector<MPI_Request>, n_comp> requests;
+
+      /* The ghost range is logically const: */
+      Number *data = const_cast<Number *>(this->begin());
+
+      for (unsigned int k = 0; k < n_comp; ++k)
+        scalar_partitioner_->export_to_ghosted_array_start(
+            k,
+            dealii::ArrayView<const Number>(data + k * n_owned_, n_owned_),
+            dealii::ArrayView<Number>(import_data.data() + k * n_import,
+                                      n_import),
+            dealii::ArrayView<Number>(
+                data + n_comp * n_owned_ + k * n_ghost_, n_ghost_),
+            requests[k]);
+
+      for (unsigned int k = 0; k < n_comp; ++k)
+        scalar_partitioner_->export_to_ghosted_array_finish(
+            dealii::ArrayView<Number>(
+                data + n_comp * n_owned_ + k * n_ghost_, n_ghost_),
+            requests[k]);
+    }
+  }
+
+
+  template <typename Number,
+            int n_comp,
+            int simd_length,
+            MultiComponentLayout layout>
+  void MultiComponentVector<Number, n_comp, simd_length, layout>::
+      update_ghost_values_start(const unsigned int communication_channel) const
+  {
+    static_assert(layout == MultiComponentLayout::array_of_structures,
+                  "nonblocking ghost exchange requires the "
+                  "array_of_structures layout");
+
+#ifdef USE_SHARED_MEMORY_EXCHANGE
+    const auto &partitioner = this->get_partitioner();
+
+    if (shared_memory_exchange_partitioner_ != partitioner) {
+      SharedMemoryExchange::targets_type send_targets;
+      for (const auto &[rank, n_indices] : partitioner->import_targets())
+        send_targets.emplace_back(rank, n_indices * sizeof(Number));
+
+      SharedMemoryExchange::targets_type receive_targets;
+      for (const auto &[rank, n_indices] : partitioner->ghost_targets())
+        receive_targets.emplace_back(rank, n_indices * sizeof(Number));
+
+      shared_memory_exchange_.reset();
+      shared_memory_exchange_ = std::make_shared<SharedMemoryExchange>(
+          send_targets, receive_targets, partitioner->get_mpi_communicator());
+      shared_memory_exchange_partitioner_ = partitioner;
+    }
+
+    Number *buffer = shared_memory_exchange_->send_buffer<Number>();
+    for (const auto &[begin, end] : partitioner->import_indices())
+      buffer = std::copy(this->begin() + begin, this->begin() + end, buffer);
+
+    /* The ghost range is logically const: */
+    Number *data = const_cast<Number *>(this->begin());
+    shared_memory_exchange_->start(data + partitioner->local_size());
+    (void)communication_channel;
+#else
+    scalar_type::update_ghost_values_start(communication_channel);
+#endif
   }
 
 
-  template <typename Number, int n_comp, int simd_length>
-  void MultiComponentVector<Number, n_comp, simd_length>::extract_component(
-      scalar_type &scalar_vector, unsigned int component) const
+  template <typename Number,
+            int n_comp,
+            int simd_length,
+            MultiComponentLayout layout>
+  void MultiComponentVector<Number, n_comp, simd_length, layout>::
+      update_ghost_values_finish() const
+  {
+#ifdef USE_SHARED_MEMORY_EXCHANGE
+    Assert(shared_memory_exchange_ != nullptr, dealii::ExcInternalError());
+    shared_memory_exchange_->finish();
+#else
+    scalar_type::update_ghost_values_finish();
+#endif
+  }
+
+
+  template <typename Number,
+            int n_comp,
+            int simd_length,
+            MultiComponentLayout layout>
+  void MultiComponentVector<Number, n_comp, simd_length, layout>::
+      extract_component(scalar_type &scalar_vector,
+                        unsigned int component) const
   {
     Assert(n_comp * scalar_vector.get_partitioner()->local_size() ==
                this->get_partitioner()->local_size(),
            dealii::ExcMessage("Called with a scalar_vector argument that has "
                               "incompatible local range."));
     const auto local_size = scalar_vector.get_partitioner()->local_size();
-    for (unsigned int i = 0; i < local_size; ++i)
-      scalar_vector.local_element(i) =
-          this->local_element(i * n_comp + component);
+    if constexpr (layout == MultiComponentLayout::array_of_structures) {
+      for (unsigned int i = 0; i < local_size; ++i)
+        scalar_vector.local_element(i) =
+            this->local_element(i * n_comp + component);
+    } else {
+      const auto view = this->component(component);
+      std::copy(view.begin(), view.end(), scalar_vector.begin());
+    }
     scalar_vector.update_ghost_values();
   }
 
 
-  template <typename Number, int n_comp, int simd_length>
-  void MultiComponentVector<Number, n_comp, simd_length>::insert_component(
-      const scalar_type &scalar_vector, unsigned int component)
+  template <typename Number,
+            int n_comp,
+            int simd_length,
+            MultiComponentLayout layout>
+  void MultiComponentVector<Number, n_comp, simd_length, layout>::
+      insert_component(const scalar_type &scalar_vector,
+                       unsigned int component)
   {
     Assert(n_comp * scalar_vector.get_partitioner()->local_size() ==
                this->get_partitioner()->local_size(),
            dealii::ExcMessage("Called with a scalar_vector argument that has "
                               "incompatible local range."));
     const auto local_size = scalar_vector.get_partitioner()->local_size();
-    for (unsigned int i = 0; i < local_size; ++i)
-      this->local_element(i * n_comp + component) =
-          scalar_vector.local_element(i);
+    if constexpr (layout == MultiComponentLayout::array_of_structures) {
+      for (unsigned int i = 0; i < local_size; ++i)
+        this->local_element(i * n_comp + component) =
+            scalar_vector.local_element(i);
+    } else {
+      std::copy(scalar_vector.begin(),
+                scalar_vector.begin() + local_size,
+                this->component(component).begin());
+    }
   }
 
   /* Inline function  definitions: */
 
-  template <typename Number, int n_comp, int simd_length>
+  template <typename Number,
+            int n_comp,
+            int simd_length,
+            MultiComponentLayout layout>
+  DEAL_II_ALWAYS_INLINE inline unsigned int
+  MultiComponentVector<Number, n_comp, simd_length, layout>::position(
+      const unsigned int i, const unsigned int k) const
+  {
+    if constexpr (layout == MultiComponentLayout::array_of_structures)
+      return i * n_comp + k;
+    else if (i < n_owned_)
+      return k * n_owned_ + i;
+    else
+      return n_comp * n_owned_ + k * n_ghost_ + (i - n_owned_);
+  }
+
+
+  template <typename Number,
+            int n_comp,
+            int simd_length,
+            MultiComponentLayout layout>
+  DEAL_II_ALWAYS_INLINE inline dealii::ArrayView<Number>
+  MultiComponentVector<Number, n_comp, simd_length, layout>::component(
+      const unsigned int component)
+  {
+    static_assert(layout == MultiComponentLayout::structure_of_arrays,
+                  "component views require the structure_of_arrays layout");
+    AssertIndexRange(component, n_comp);
+    return dealii::ArrayView<Number>(this->begin() + component * n_owned_,
+                                     n_owned_);
+  }
+
+
+  template <typename Number,
+            int n_comp,
+            int simd_length,
+            MultiComponentLayout layout>
+  DEAL_II_ALWAYS_INLINE inline dealii::ArrayView<const Number>
+  MultiComponentVector<Number, n_comp, simd_length, layout>::component(
+      const unsigned int component) const
+  {
+    static_assert(layout == MultiComponentLayout::structure_of_arrays,
+                  "component views require the structure_of_arrays layout");
+    AssertIndexRange(component, n_comp);
+    return dealii::ArrayView<const Number>(
+        this->begin() + component * n_owned_, n_owned_);
+  }
+
+
+  template <typename Number,
+            int n_comp,
+            int simd_length,
+            MultiComponentLayout layout>
   template <typename Tensor>
   DEAL_II_ALWAYS_INLINE inline Tensor
-  MultiComponentVector<Number, n_comp, simd_length>::get_tensor(
+  MultiComponentVector<Number, n_comp, simd_length, layout>::get_tensor(
       const unsigned int i) const
   {
     Tensor tensor;
     for (unsigned int d = 0; d < n_comp; ++d)
-      tensor[d] = this->local_element(i * n_comp + d);
+      tensor[d] = this->local_element(position(i, d));
     return tensor;
   }
 
 
-  template <typename Number, int n_comp, int simd_length>
+  template <typename Number,
+            int n_comp,
+            int simd_length,
+            MultiComponentLayout layout>
   template <typename Tensor>
   DEAL_II_ALWAYS_INLINE inline Tensor
-  MultiComponentVector<Number, n_comp, simd_length>::get_vectorized_tensor(
-      const unsigned int i) const
+  MultiComponentVector<Number, n_comp, simd_length, layout>::
+      get_vectorized_tensor(const unsigned int i) const
   {
     Tensor tensor;
-    unsigned int indices[VectorizedArray::size()];
-    for (unsigned int k = 0; k < VectorizedArray::size(); ++k)
-      indices[k] = k * n_comp;
 
-    dealii::vectorized_load_and_transpose(
-        n_comp, this->begin() + i * n_comp, indices, &tensor[0]);
+    if constexpr (layout == MultiComponentLayout::array_of_structures) {
+      unsigned int indices[VectorizedArray::size()];
+      for (unsigned int k = 0; k < VectorizedArray::size(); ++k)
+        indices[k] = k * n_comp;
+
+      dealii::vectorized_load_and_transpose(
+          n_comp, this->begin() + i * n_comp, indices, &tensor[0]);
+
+    } else {
+      /*
+       * A SIMD batch of locally owned elements is a plain load (followed
+       * by a conversion if the tensor has a different number type):
+       */
+      Assert(i + VectorizedArray::size() <= n_owned_,
+             dealii::ExcInternalError());
+      for (unsigned int d = 0; d < n_comp; ++d) {
+        const Number *values = this->begin() + d * n_owned_ + i;
+        if constexpr (std::is_same_v<std::decay_t<decltype(tensor[d])>,
+                                     VectorizedArray>)
+          tensor[d].load(values);
+        else
+          for (unsigned int k = 0; k < VectorizedArray::size(); ++k)
+            tensor[d][k] = values[k];
+      }
+    }
 
     return tensor;
   }
 
 
-  template <typename Number, int n_comp, int simd_length>
+  template <typename Number,
+            int n_comp,
+            int simd_length,
+            MultiComponentLayout layout>
   template <typename Tensor>
   DEAL_II_ALWAYS_INLINE inline Tensor
-  MultiComponentVector<Number, n_comp, simd_length>::get_vectorized_tensor(
-      const unsigned int *js) const
+  MultiComponentVector<Number, n_comp, simd_length, layout>::
+      get_vectorized_tensor(const unsigned int *js) const
   {
     Tensor tensor;
     unsigned int indices[VectorizedArray::size()];
-    for (unsigned int k = 0; k < VectorizedArray::size(); ++k)
-      indices[k] = js[k] * n_comp;
 
-    dealii::vectorized_load_and_transpose(
-        n_comp, this->begin(), indices, &tensor[0]);
+    if constexpr (layout == MultiComponentLayout::array_of_structures) {
+      for (unsigned int k = 0; k < VectorizedArray::size(); ++k)
+        indices[k] = js[k] * n_comp;
+
+      dealii::vectorized_load_and_transpose(
+          n_comp, this->begin(), indices, &tensor[0]);
+
+    } else {
+      for (unsigned int d = 0; d < n_comp; ++d) {
+        for (unsigned int k = 0; k < VectorizedArray::size(); ++k)
+          indices[k] = position(js[k], d);
+        tensor[d].gather(this->begin(), indices);
+      }
+    }
 
     return tensor;
   }
 
 
-  template <typename Number, int n_comp, int simd_length>
+  template <typename Number,
+            int n_comp,
+            int simd_length,
+            MultiComponentLayout layout>
   template <typename Tensor>
   DEAL_II_ALWAYS_INLINE inline void
-  MultiComponentVector<Number, n_comp, simd_length>::write_tensor(
+  MultiComponentVector<Number, n_comp, simd_length, layout>::write_tensor(
       const Tensor &tensor, const unsigned int i)
   {
     for (unsigned int d = 0; d < n_comp; ++d)
-      this->local_element(i * n_comp + d) = tensor[d];
+      this->local_element(position(i, d)) = tensor[d];
   }
 
 
-  template <typename Number, int n_comp, int simd_length>
+  template <typename Number,
+            int n_comp,
+            int simd_length,
+            MultiComponentLayout layout>
   template <typename Tensor>
   DEAL_II_ALWAYS_INLINE inline void
-  MultiComponentVector<Number, n_comp, simd_length>::write_vectorized_tensor(
-      const Tensor &tensor, const unsigned int i)
+  MultiComponentVector<Number, n_comp, simd_length, layout>::
+      write_vectorized_tensor(const Tensor &tensor, const unsigned int i)
   {
-    unsigned int indices[VectorizedArray::size()];
-    for (unsigned int k = 0; k < VectorizedArray::size(); ++k)
-      indices[k] = k * n_comp;
+    if constexpr (layout == MultiComponentLayout::array_of_structures) {
+      unsigned int indices[VectorizedArray::size()];
+      for (unsigned int k = 0; k < VectorizedArray::size(); ++k)
+        indices[k] = k * n_comp;
+
+      dealii::vectorized_transpose_and_store(
+          false, n_comp, &tensor[0], indices, this->begin() + i * n_comp);
+
+    } else {
+      Assert(i + VectorizedArray::size() <= n_owned_,
+             dealii::ExcInternalError());
+      for (unsigned int d = 0; d < n_comp; ++d) {
+        Number *values = this->begin() + d * n_owned_ + i;
+        if constexpr (std::is_same_v<std::decay_t<decltype(tensor[d])>,
+                                     VectorizedArray>)
+          tensor[d].store(values);
+        else
+          for (unsigned int k = 0; k < VectorizedArray::size(); ++k)
+            values[k] = tensor[d][k];
+      }
+    }
+  }
+
 
-    dealii::vectorized_transpose_and_store(
-        false, n_comp, &tensor[0], indices, this->begin() + i * n_comp);
+  template <typename Number,
+            int n_comp,
+            int simd_length,
+            MultiComponentLayout layout>
+  template <typename Tensor>
+  DEAL_II_ALWAYS_INLINE inline void
+  MultiComponentVector<Number, n_comp, simd_length, layout>::
+      write_vectorized_tensor(const Tensor &tensor, const unsigned int *js)
+  {
+    if constexpr (layout == MultiComponentLayout::array_of_structures) {
+      unsigned int indices[VectorizedArray::size()];
+      for (unsigned int k = 0; k < VectorizedArray::size(); ++k)
+        indices[k] = js[k] * n_comp;
+
+      dealii::vectorized_transpose_and_store(
+          false, n_comp, &tensor[0], indices, this->begin());
+
+    } else {
+      for (unsigned int d = 0; d < n_comp; ++d)
+        for (unsigned int k = 0; k < VectorizedArray::size(); ++k)
+          this->local_element(position(js[k], d)) = tensor[d][k];
+    }
   }
 #endif
 
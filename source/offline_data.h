@@ -16,12 +16,20 @@
 #include <deal.II/base/parameter_acceptor.h>
 #include <deal.II/base/partitioner.h>
 #include <deal.II/dofs/dof_handler.h>
+#include <deal.II/grid/cell_id.h>
 #include <deal.II/lac/affine_constraints.h>
+#include <deal.II/lac/full_matrix.h>
 #include <deal.II/lac/la_parallel_vector.h>
 #include <deal.II/lac/sparse_matrix.h>
 
 #include <deal.II/numerics/data_out.h>
 
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace ryujin
 {
 
@@ -69,6 +77,23 @@ namespace ryujin
      */
     using vector_type = MultiComponentVector<Number, problem_dimension>;
 
+    /**
+     * The SIMD width used for all SparseMatrixSIMD objects.
+     */
+    static constexpr int simd_length = dealii::VectorizedArray<Number>::size();
+
+    /**
+     * The storage type used for the geometric coefficient matrices, i.e.,
+     * mass_matrix(), betaij_matrix() and cij_matrix(). This is float if
+     * the USE_MIXED_PRECISION_STORAGE compile-time option is set, and
+     * Number otherwise. All arithmetic is done with Number.
+     */
+#ifdef USE_MIXED_PRECISION_STORAGE
+    using storage_type = float;
+#else
+    using storage_type = Number;
+#endif
+
     /**
      * A tuple describing global dof index, boundary normal and position of
      * a boundary degree of freedom.
@@ -87,11 +112,25 @@ namespace ryujin
     /**
      * Prepare offline data. A call to @ref prepare() internally calls
      * @ref setup() and @ref assemble().
+     *
+     * If a cache directory is set, the DoF numbering, the
+     * SparsityPatternSIMD and all assembled matrices are read from a
+     * per-rank cache file instead, provided that the file was written for
+     * the same mesh, the same number of MPI ranks and the same
+     * compile-time configuration. Otherwise, the data is computed and the
+     * cache file is (re)written. The sparsity pattern and the matrix
+     * entries are stored in a separate, page aligned file that is memory
+     * mapped on reading, i.e., all matrix data is loaded lazily on first
+     * access.
      */
     void prepare()
     {
-      setup();
-      assemble();
+      if (!read_cache()) {
+        setup();
+        assemble();
+        write_cache();
+      }
+      setup_serial_partition();
       create_multigrid_data();
     }
 
@@ -111,7 +150,106 @@ namespace ryujin
      */
     void create_multigrid_data();
 
+    /**
+     * Return the memory consumption (in bytes, of this MPI rank) of all
+     * vectors and matrices owned by the class as a list of (name, size)
+     * pairs. Memory mapped matrices (see @ref prepare()) are reported
+     * with the size of the mapped array.
+     */
+    std::vector<std::pair<std::string, std::size_t>>
+    memory_consumption() const;
+
+    /**
+     * Return the half open index range [begin, end) of the
+     * non-vectorized rows [n_locally_internal(), n_locally_owned()) that
+     * thread @p thread out of @p n_threads processes. The ranges are
+     * contiguous and balanced with respect to an estimated cost of every
+     * row (its stencil size, doubled for boundary rows) that is computed
+     * once in prepare(). Used instead of a static OpenMP schedule, which
+     * distributes rows by count, for the non-vectorized loops.
+     */
+    std::pair<unsigned int, unsigned int>
+    serial_range(const unsigned int thread, const unsigned int n_threads) const
+    {
+      const auto position = [&](const unsigned int t) {
+        const std::size_t target = serial_cost_.back() * t / n_threads;
+        const auto it =
+            std::lower_bound(serial_cost_.begin(), serial_cost_.end(), target);
+        return n_locally_internal_ +
+               static_cast<unsigned int>(it - serial_cost_.begin());
+      };
+      return {position(thread), position(thread + 1)};
+    }
+
+#ifdef USE_ON_THE_FLY_CIJ
+    /**
+     * The maximal row length in the vectorized index range
+     * [0, n_locally_internal()) for Q1 elements.
+     */
+    static constexpr unsigned int max_internal_row_length =
+        dim == 1 ? 3 : (dim == 2 ? 9 : 27);
+
+    /**
+     * Recompute the \f$(c_{ij})\f$ entries of the SIMD row chunk
+     * starting at row @p i from compact per-cell geometry data and store
+     * them at @p c_ij[0], ..., @p c_ij[row_length - 1]. This is only
+     * possible for rows in the vectorized index range [0,
+     * n_locally_internal()).
+     */
+    void reconstruct_cij(
+        const unsigned int i,
+        dealii::Tensor<1, dim, dealii::VectorizedArray<Number>> *c_ij) const;
+#endif
+
   private:
+#ifdef USE_ON_THE_FLY_CIJ
+    /**
+     * Set up the per-cell geometry data needed for reconstruct_cij().
+     */
+    void setup_cij_reconstruction();
+#endif
+
+    /**
+     * Compute the accumulated row costs of the non-vectorized index range
+     * used by serial_range().
+     */
+    void setup_serial_partition();
+
+    /**
+     * Set up the (globally indexed) hanging node and periodicity
+     * constraints.
+     */
+    void setup_affine_constraints(const dealii::IndexSet &locally_relevant);
+
+    /**
+     * Return the name of the cache file of this MPI rank.
+     */
+    std::string cache_file_name() const;
+
+    /**
+     * Return a fingerprint of the (locally relevant part of the) mesh and
+     * the compile-time configuration that is used to validate a cache
+     * file.
+     */
+    std::string cache_signature() const;
+
+    /**
+     * Try to read all offline data from a cache file. Returns false (on
+     * all MPI ranks) if no cache directory is set, or if a valid cache
+     * file is not available on every MPI rank.
+     */
+    bool read_cache();
+
+    /**
+     * Write all offline data into a cache file if a cache directory is
+     * set.
+     */
+    void write_cache() const;
+
+    std::string cache_directory_;
+
+    std::string dof_renumbering_;
+
     std::unique_ptr<dealii::DoFHandler<dim>> dof_handler_;
 
     dealii::AffineConstraints<Number> affine_constraints_;
@@ -134,12 +272,23 @@ namespace ryujin
 
     std::vector<boundary_map_type> level_boundary_map_;
 
+    /*
+     * Prefix sums of the estimated costs of the rows [n_locally_internal_,
+     * n_locally_owned_), see serial_range().
+     */
+    std::vector<std::size_t> serial_cost_;
+
+    /*
+     * A (globally indexed) sparsity pattern that is only needed for the
+     * assembly in the presence of affine constraints. It is cleared at
+     * the end of assemble().
+     */
     dealii::DynamicSparsityPattern sparsity_pattern_;
 
     SparsityPatternSIMD<dealii::VectorizedArray<Number>::size()>
         sparsity_pattern_simd_;
 
-    SparseMatrixSIMD<Number> mass_matrix_;
+    SparseMatrixSIMD<Number, 1, simd_length, storage_type> mass_matrix_;
 
     dealii::LinearAlgebra::distributed::Vector<Number> lumped_mass_matrix_;
     dealii::LinearAlgebra::distributed::Vector<Number>
@@ -148,11 +297,53 @@ namespace ryujin
     std::vector<dealii::LinearAlgebra::distributed::Vector<float>>
         level_lumped_mass_matrix_;
 
-    SparseMatrixSIMD<Number> betaij_matrix_;
-    SparseMatrixSIMD<Number, dim> cij_matrix_;
+#ifdef USE_SYMMETRIC_STORAGE
+    SymmetricSparseMatrixSIMD<Number, simd_length, storage_type> betaij_matrix_;
+#else
+    SparseMatrixSIMD<Number, 1, simd_length, storage_type> betaij_matrix_;
+#endif
+    SparseMatrixSIMD<Number, dim, simd_length, storage_type> cij_matrix_;
+
+    bool precompute_nij_;
+    SparseMatrixSIMD<Number, dim, simd_length, storage_type> nij_matrix_;
+    SparseMatrixSIMD<Number, 1, simd_length, storage_type> cij_norm_matrix_;
 
     Number measure_of_omega_;
 
+    /*
+     * Local cell matrices (mass, c_ij, and beta_ij) and the volume of all
+     * cells that were assembled in the last call to assemble(). The cells
+     * are identified by their dealii::CellId, i.e., cells that are
+     * unchanged by refinement and coarsening are found again.
+     */
+    struct CellMatrices {
+      dealii::FullMatrix<double> mass_matrix;
+      std::array<dealii::FullMatrix<double>, dim> cij_matrix;
+      dealii::FullMatrix<double> betaij_matrix;
+      double volume;
+    };
+
+    bool cache_cell_matrices_;
+    std::map<dealii::CellId, CellMatrices> cell_matrix_cache_;
+
+#ifdef USE_ON_THE_FLY_CIJ
+    /*
+     * For affine cells and Q1 elements the cell contribution to c_ij is
+     * given by |det J| J^{-T} times the reference cell integral
+     * \hat c_ab = \int \hat phi_a \nabla \hat phi_b. We store
+     * |det J| J^{-T} for every (non-artificial) active cell, \hat c_ab,
+     * and for every row in the vectorized index range the adjacent cells,
+     * the local index of the row within these cells, and the column
+     * position of all local indices of the cell.
+     */
+    unsigned int dofs_per_cell_;
+    dealii::AlignedVector<Number> cell_geometry_;
+    std::vector<dealii::Tensor<1, dim, Number>> reference_cij_;
+    dealii::AlignedVector<unsigned int> row_cells_;
+    dealii::AlignedVector<unsigned char> row_local_index_;
+    dealii::AlignedVector<unsigned char> row_columns_;
+#endif
+
     dealii::SmartPointer<const ryujin::Discretization<dim>> discretization_;
 
     const MPI_Comm &mpi_communicator_;
@@ -247,12 +438,6 @@ namespace ryujin
      */
     ACCESSOR_READ_ONLY(level_boundary_map)
 
-    /**
-     * A sparsity pattern for (standard deal.II) matrices storing indices
-     * in (Deal.II typical) global numbering.
-     */
-    ACCESSOR_READ_ONLY(sparsity_pattern)
-
     /**
      * A sparsity pattern for matrices in vectorized format. Local
      * numbering.
@@ -292,6 +477,26 @@ namespace ryujin
      */
     ACCESSOR_READ_ONLY(cij_matrix)
 
+    /**
+     * Returns true if the normalized directions \f$(n_{ij})\f$ and norms
+     * \f$(|c_{ij}|)\f$ are precomputed and accessible via nij_matrix()
+     * and cij_norm_matrix(). This is a run-time parameter.
+     */
+    ACCESSOR_READ_ONLY(precompute_nij)
+
+    /**
+     * The \f$(n_{ij}) = (c_{ij} / |c_{ij}|)\f$ matrix. The diagonal
+     * entries are set to zero. Only initialized if precompute_nij() is
+     * true. (SIMD storage, local numbering)
+     */
+    ACCESSOR_READ_ONLY(nij_matrix)
+
+    /**
+     * The \f$(|c_{ij}|)\f$ matrix. Only initialized if precompute_nij()
+     * is true. (SIMD storage, local numbering)
+     */
+    ACCESSOR_READ_ONLY(cij_norm_matrix)
+
     /**
      * Size of computational domain.
      */
@@ -303,4 +508,50 @@ namespace ryujin
     ACCESSOR_READ_ONLY(discretization)
   };
 
+
+#ifdef USE_ON_THE_FLY_CIJ
+  /* Inline definitions */
+
+  template <int dim, typename Number>
+  DEAL_II_ALWAYS_INLINE inline void OfflineData<dim, Number>::reconstruct_cij(
+      const unsigned int i,
+      dealii::Tensor<1, dim, dealii::VectorizedArray<Number>> *c_ij) const
+  {
+    constexpr unsigned int n_cells =
+        dealii::GeometryInfo<dim>::vertices_per_cell;
+
+    AssertIndexRange(i, n_locally_internal_);
+    Assert(i % simd_length == 0,
+           dealii::ExcMessage(
+               "Access only supported for rows at the SIMD granularity"));
+
+    const unsigned int row_length = sparsity_pattern_simd_.row_length(i);
+    Assert(row_length <= max_internal_row_length, dealii::ExcInternalError());
+
+    for (unsigned int col_idx = 0; col_idx < row_length; ++col_idx)
+      c_ij[col_idx] = dealii::Tensor<1, dim, dealii::VectorizedArray<Number>>();
+
+    for (unsigned int k = 0; k < simd_length; ++k) {
+      for (unsigned int c = 0; c < n_cells; ++c) {
+        const unsigned int index = (i + k) * n_cells + c;
+
+        const Number *geometry =
+            cell_geometry_.data() + row_cells_[index] * dim * dim;
+        const auto *reference =
+            reference_cij_.data() + row_local_index_[index] * dofs_per_cell_;
+        const unsigned char *columns =
+            row_columns_.data() + index * dofs_per_cell_;
+
+        for (unsigned int b = 0; b < dofs_per_cell_; ++b)
+          for (unsigned int d = 0; d < dim; ++d) {
+            Number temp = Number(0.);
+            for (unsigned int e = 0; e < dim; ++e)
+              temp += geometry[d * dim + e] * reference[b][e];
+            c_ij[columns[b]][d][k] += temp;
+          }
+      }
+    }
+  }
+#endif
+
 } /* namespace ryujin */
@@ -13,7 +13,9 @@
 #include "sparse_matrix_simd.template.h" /* instantiate read_in */
 
 #include <deal.II/base/graph_coloring.h>
+#include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/parallel.h>
+#include <deal.II/base/quadrature_lib.h>
 #include <deal.II/base/work_stream.h>
 #include <deal.II/dofs/dof_renumbering.h>
 #include <deal.II/dofs/dof_tools.h>
@@ -24,8 +26,20 @@
 #include <deal.II/lac/trilinos_sparse_matrix.h>
 #endif
 
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/core/demangle.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/range/irange.hpp>
 #include <boost/range/iterator_range.hpp>
+#include <boost/serialization/array_wrapper.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <typeinfo>
 
 #ifdef FORCE_DEAL_II_SPARSE_MATRIX
 #undef DEAL_II_WITH_TRILINOS
@@ -45,6 +59,36 @@ namespace ryujin
       , discretization_(&discretization)
       , mpi_communicator_(mpi_communicator)
   {
+    dof_renumbering_ = "Cuthill McKee";
+    add_parameter("dof renumbering",
+                  dof_renumbering_,
+                  "Renumbering of the locally owned degrees of freedom that "
+                  "determines the memory layout of all vectors and matrices "
+                  "- valid options are \"Cuthill McKee\" and \"Hilbert\" "
+                  "(cache oblivious ordering along a Hilbert curve through "
+                  "the support points)");
+
+    precompute_nij_ = false;
+    add_parameter("precompute nij",
+                  precompute_nij_,
+                  "Precompute and store the normalized directions n_ij and "
+                  "the norms |c_ij| instead of computing them from c_ij in "
+                  "every time step. This trades memory bandwidth for fewer "
+                  "square roots and divisions per edge");
+
+    cache_cell_matrices_ = false;
+    add_parameter("cache cell matrices",
+                  cache_cell_matrices_,
+                  "Keep the local cell matrices of all locally relevant "
+                  "cells and reuse them for cells that are unchanged after "
+                  "a mesh adaptation cycle instead of reassembling them");
+
+    add_parameter("cache directory",
+                  cache_directory_,
+                  "If nonempty, store the DoF numbering, the sparsity "
+                  "pattern and all assembled matrices in one file per MPI "
+                  "rank in this directory and reuse them in subsequent runs "
+                  "on the same mesh with the same number of MPI ranks");
   }
 
 
@@ -68,8 +112,16 @@ namespace ryujin
      * Renumbering:
      */
 
-    /* Cuthill McKee actually helps with cache locality. */
-    DoFRenumbering::Cuthill_McKee(dof_handler);
+    if (dof_renumbering_ == "Cuthill McKee") {
+      /* Cuthill McKee actually helps with cache locality. */
+      DoFRenumbering::Cuthill_McKee(dof_handler);
+    } else if (dof_renumbering_ == "Hilbert") {
+      DoFRenumbering::hilbert_curve(dof_handler, discretization_->mapping());
+    } else {
+      AssertThrow(false,
+                  ExcMessage("Unknown dof renumbering \"" + dof_renumbering_ +
+                             "\""));
+    }
 
 #ifdef USE_COMMUNICATION_HIDING
 #ifdef DEBUG
@@ -104,77 +156,63 @@ namespace ryujin
     IndexSet locally_relevant;
     DoFTools::extract_locally_relevant_dofs(dof_handler, locally_relevant);
 
-    affine_constraints_.reinit(locally_relevant);
-    DoFTools::make_hanging_node_constraints(dof_handler, affine_constraints_);
-
-#ifndef DEAL_II_WITH_TRILINOS
-    AssertThrow(affine_constraints_.n_constraints() == 0,
-                ExcMessage("ryujin was built without Trilinos support - no "
-                           "hanging node support available"));
-#endif
+    setup_affine_constraints(locally_relevant);
 
     /*
-     * Enforce periodic boundary conditions. We assume that the mesh is in
-     * "normal configuration".
+     * Without hanging node and periodicity constraints the SIMD sparsity
+     * pattern is created directly from the cell connectivity and all
+     * matrices are assembled directly into SparseMatrixSIMD objects (see
+     * assemble()). Otherwise, we create a (globally indexed) sparsity
+     * pattern that is only kept until the end of assemble().
      */
-    const auto n_periodic_faces =
-        discretization_->triangulation().get_periodic_face_map().size();
-    if (n_periodic_faces != 0) {
-      if constexpr (dim != 1 && std::is_same<Number, double>::value) {
-        for (int i = 0; i < dim; ++i)
-          DoFTools::make_periodicity_constraints(dof_handler,
-                                                 /*b_id */ Boundary::periodic,
-                                                 /*direction*/ i,
-                                                 affine_constraints_);
-      } else {
-        AssertThrow(false, dealii::ExcNotImplemented());
-      }
-    }
-
-    affine_constraints_.close();
+    const bool direct_assembly = affine_constraints_.n_constraints() == 0;
 
-    sparsity_pattern_.reinit(
-        dof_handler.n_dofs(), dof_handler.n_dofs(), locally_relevant);
+    if (!direct_assembly) {
+      sparsity_pattern_.reinit(
+          dof_handler.n_dofs(), dof_handler.n_dofs(), locally_relevant);
 #ifdef DEAL_II_WITH_TRILINOS
-    DoFTools::make_sparsity_pattern(
-        dof_handler, sparsity_pattern_, affine_constraints_, false);
+      DoFTools::make_sparsity_pattern(
+          dof_handler, sparsity_pattern_, affine_constraints_, false);
 #else
-    /*
-     * In case we use dealii::SparseMatrix<Number> for assembly we need a
-     * sparsity pattern that also includes the full locally relevant -
-     * locally relevant coupling block. This gets thrown out again later,
-     * but nevertheless we have to add it.
-     */
-    DoFTools::make_extended_sparsity_pattern(
-        dof_handler, sparsity_pattern_, affine_constraints_, false);
+      /*
+       * In case we use dealii::SparseMatrix<Number> for assembly we need a
+       * sparsity pattern that also includes the full locally relevant -
+       * locally relevant coupling block. This gets thrown out again later,
+       * but nevertheless we have to add it.
+       */
+      DoFTools::make_extended_sparsity_pattern(
+          dof_handler, sparsity_pattern_, affine_constraints_, false);
 #endif
 
-    /*
-     * We have to complete the local stencil to have consistent size over
-     * all MPI ranks. Otherwise, MPI synchronization in our
-     * SparseMatrixSIMD class will fail.
-     */
+      /*
+       * We have to complete the local stencil to have consistent size over
+       * all MPI ranks. Otherwise, MPI synchronization in our
+       * SparseMatrixSIMD class will fail.
+       */
 
-    SparsityTools::distribute_sparsity_pattern(
-        sparsity_pattern_, locally_owned, mpi_communicator_, locally_relevant);
+      SparsityTools::distribute_sparsity_pattern(sparsity_pattern_,
+                                                 locally_owned,
+                                                 mpi_communicator_,
+                                                 locally_relevant);
 
-    /*
-     * Next, we enlarge the locally relevant set to include all additional
-     * couplings:
-     */
+      /*
+       * Next, we enlarge the locally relevant set to include all additional
+       * couplings:
+       */
 
-    {
-      IndexSet additional_dofs(dof_handler.n_dofs());
+      {
+        IndexSet additional_dofs(dof_handler.n_dofs());
 
-      for (auto &entry : sparsity_pattern_)
-        if (!locally_relevant.is_element(entry.column())) {
-          Assert(locally_owned.is_element(entry.row()), ExcInternalError());
-          additional_dofs.add_index(entry.column());
-        }
+        for (auto &entry : sparsity_pattern_)
+          if (!locally_relevant.is_element(entry.column())) {
+            Assert(locally_owned.is_element(entry.row()), ExcInternalError());
+            additional_dofs.add_index(entry.column());
+          }
 
-      additional_dofs.compress();
-      locally_relevant.add_indices(additional_dofs);
-      locally_relevant.compress();
+        additional_dofs.compress();
+        locally_relevant.add_indices(additional_dofs);
+        locally_relevant.compress();
+      }
     }
 
     /* Set up partitioner: */
@@ -214,8 +252,58 @@ namespace ryujin
      * from global deal.II (typical) dof indexing to local indices.
      */
 
-    sparsity_pattern_simd_.reinit(
-        n_locally_internal_, sparsity_pattern_, scalar_partitioner_);
+    if (direct_assembly) {
+      /*
+       * Create the minimal sparsity pattern in local numbering: Locally
+       * owned rows couple to all indices of adjacent cells, ghost rows
+       * only contain the transposed entries of locally owned rows.
+       */
+      const unsigned int dofs_per_cell =
+          discretization_->finite_element().dofs_per_cell;
+      std::vector<types::global_dof_index> dof_indices(dofs_per_cell);
+      std::vector<unsigned int> local_indices(dofs_per_cell);
+
+      DynamicSparsityPattern dsp(n_locally_relevant_, n_locally_relevant_);
+      for (const auto &cell : dof_handler.active_cell_iterators()) {
+        if (cell->is_artificial())
+          continue;
+
+        cell->get_dof_indices(dof_indices);
+        for (unsigned int k = 0; k < dofs_per_cell; ++k)
+          local_indices[k] =
+              scalar_partitioner_->global_to_local(dof_indices[k]);
+
+        for (const auto i : local_indices)
+          for (const auto j : local_indices)
+            if (i < n_locally_owned_ || j < n_locally_owned_)
+              dsp.add(i, j);
+      }
+
+      SparsityPattern sparsity;
+      sparsity.copy_from(dsp);
+      sparsity_pattern_simd_.reinit(
+          n_locally_internal_, sparsity, scalar_partitioner_);
+
+    } else {
+      sparsity_pattern_simd_.reinit(
+          n_locally_internal_, sparsity_pattern_, scalar_partitioner_);
+    }
+
+#if defined(USE_PIPELINED_COMMUNICATION) && defined(DEBUG)
+    /*
+     * The pipelined ghost exchange in the EulerModule relies on the fact
+     * that no row in [n_export_indices, n_locally_internal) couples to a
+     * ghost index:
+     */
+    for (unsigned int i = n_export_indices_; i < n_locally_internal_; ++i) {
+      const unsigned int *js = sparsity_pattern_simd_.columns(i);
+      for (unsigned int col_idx = 0;
+           col_idx < sparsity_pattern_simd_.row_length(i);
+           ++col_idx)
+        Assert(js[col_idx * simd_length] < n_locally_owned_,
+               dealii::ExcInternalError());
+    }
+#endif
 
     /* Next we can (re)initialize all local matrices: */
 
@@ -225,6 +313,47 @@ namespace ryujin
     mass_matrix_.reinit(sparsity_pattern_simd_);
     betaij_matrix_.reinit(sparsity_pattern_simd_);
     cij_matrix_.reinit(sparsity_pattern_simd_);
+    if (precompute_nij_) {
+      nij_matrix_.reinit(sparsity_pattern_simd_);
+      cij_norm_matrix_.reinit(sparsity_pattern_simd_);
+    }
+  }
+
+
+  template <int dim, typename Number>
+  void OfflineData<dim, Number>::setup_affine_constraints(
+      const dealii::IndexSet &locally_relevant)
+  {
+    const auto &dof_handler = *dof_handler_;
+
+    affine_constraints_.reinit(locally_relevant);
+    DoFTools::make_hanging_node_constraints(dof_handler, affine_constraints_);
+
+#ifndef DEAL_II_WITH_TRILINOS
+    AssertThrow(affine_constraints_.n_constraints() == 0,
+                ExcMessage("ryujin was built without Trilinos support - no "
+                           "hanging node support available"));
+#endif
+
+    /*
+     * Enforce periodic boundary conditions. We assume that the mesh is in
+     * "normal configuration".
+     */
+    const auto n_periodic_faces =
+        discretization_->triangulation().get_periodic_face_map().size();
+    if (n_periodic_faces != 0) {
+      if constexpr (dim != 1 && std::is_same<Number, double>::value) {
+        for (int i = 0; i < dim; ++i)
+          DoFTools::make_periodicity_constraints(dof_handler,
+                                                 /*b_id */ Boundary::periodic,
+                                                 /*direction*/ i,
+                                                 affine_constraints_);
+      } else {
+        AssertThrow(false, dealii::ExcNotImplemented());
+      }
+    }
+
+    affine_constraints_.close();
   }
 
 
@@ -237,7 +366,29 @@ namespace ryujin
 
     auto &dof_handler = *dof_handler_;
 
-    measure_of_omega_ = 0.;
+    /*
+     * The measure of the domain and the lumped mass matrix are
+     * accumulated in double precision, also for Number = float:
+     */
+    double measure_of_omega = 0.;
+
+    /*
+     * Without constraints we assemble directly into SparseMatrixSIMD
+     * objects in local numbering (with full precision storage), see the
+     * discussion in setup():
+     */
+
+    const bool direct_assembly = affine_constraints_.n_constraints() == 0;
+
+    SparseMatrixSIMD<Number, 1, simd_length> mass_matrix_simd;
+    SparseMatrixSIMD<Number, 1, simd_length> betaij_matrix_simd;
+    SparseMatrixSIMD<Number, dim, simd_length> cij_matrix_simd;
+
+    if (direct_assembly) {
+      mass_matrix_simd.reinit(sparsity_pattern_simd_);
+      betaij_matrix_simd.reinit(sparsity_pattern_simd_);
+      cij_matrix_simd.reinit(sparsity_pattern_simd_);
+    }
 
 #ifdef DEAL_II_WITH_TRILINOS
     /* Variant using TrilinosWrappers::SparseMatrix with global numbering */
@@ -253,19 +404,21 @@ namespace ryujin
     }
     affine_constraints_assembly.close();
 
-    const IndexSet &locally_owned = dof_handler.locally_owned_dofs();
-    TrilinosWrappers::SparsityPattern trilinos_sparsity_pattern;
-    trilinos_sparsity_pattern.reinit(
-        locally_owned, sparsity_pattern_, mpi_communicator_);
-
     TrilinosWrappers::SparseMatrix mass_matrix_tmp;
     TrilinosWrappers::SparseMatrix betaij_matrix_tmp;
     std::array<TrilinosWrappers::SparseMatrix, dim> cij_matrix_tmp;
 
-    mass_matrix_tmp.reinit(trilinos_sparsity_pattern);
-    betaij_matrix_tmp.reinit(trilinos_sparsity_pattern);
-    for (auto &matrix : cij_matrix_tmp)
-      matrix.reinit(trilinos_sparsity_pattern);
+    if (!direct_assembly) {
+      const IndexSet &locally_owned = dof_handler.locally_owned_dofs();
+      TrilinosWrappers::SparsityPattern trilinos_sparsity_pattern;
+      trilinos_sparsity_pattern.reinit(
+          locally_owned, sparsity_pattern_, mpi_communicator_);
+
+      mass_matrix_tmp.reinit(trilinos_sparsity_pattern);
+      betaij_matrix_tmp.reinit(trilinos_sparsity_pattern);
+      for (auto &matrix : cij_matrix_tmp)
+        matrix.reinit(trilinos_sparsity_pattern);
+    }
 
 #else
     /* Variant using deal.II SparseMatrix with local numbering */
@@ -275,7 +428,11 @@ namespace ryujin
     transform_to_local_range(*scalar_partitioner_, affine_constraints_assembly);
 
     SparsityPattern sparsity_pattern_assembly;
-    {
+    dealii::SparseMatrix<Number> mass_matrix_tmp;
+    dealii::SparseMatrix<Number> betaij_matrix_tmp;
+    std::array<dealii::SparseMatrix<Number>, dim> cij_matrix_tmp;
+
+    if (!direct_assembly) {
       DynamicSparsityPattern dsp(n_locally_relevant_, n_locally_relevant_);
       for (const auto &entry : sparsity_pattern_) {
         const auto i = scalar_partitioner_->global_to_local(entry.row());
@@ -283,22 +440,19 @@ namespace ryujin
         dsp.add(i, j);
       }
       sparsity_pattern_assembly.copy_from(dsp);
-    }
-
-    dealii::SparseMatrix<Number> mass_matrix_tmp;
-    dealii::SparseMatrix<Number> betaij_matrix_tmp;
-    std::array<dealii::SparseMatrix<Number>, dim> cij_matrix_tmp;
 
-    mass_matrix_tmp.reinit(sparsity_pattern_assembly);
-    betaij_matrix_tmp.reinit(sparsity_pattern_assembly);
-    for (auto &matrix : cij_matrix_tmp)
-      matrix.reinit(sparsity_pattern_assembly);
+      mass_matrix_tmp.reinit(sparsity_pattern_assembly);
+      betaij_matrix_tmp.reinit(sparsity_pattern_assembly);
+      for (auto &matrix : cij_matrix_tmp)
+        matrix.reinit(sparsity_pattern_assembly);
+    }
 #endif
 
     const unsigned int dofs_per_cell =
         discretization_->finite_element().dofs_per_cell;
 
-    const unsigned int n_q_points = discretization_->quadrature().size();
+    const unsigned int n_q_points =
+        discretization_->subcell_quadrature().size();
 
     /*
      * Now, assemble all matrices:
@@ -321,7 +475,12 @@ namespace ryujin
           auto &fe_values = scratch.fe_values_;
 
 #ifdef DEAL_II_WITH_TRILINOS
-          is_locally_owned = cell->is_locally_owned();
+          /*
+           * For direct assembly we need the contributions of the ghost
+           * layer to all locally owned rows as well.
+           */
+          is_locally_owned = direct_assembly ? !cell->is_artificial()
+                                             : cell->is_locally_owned();
 #else
           /*
            * When using a local dealii::SparseMatrix<Number> we don not
@@ -334,15 +493,39 @@ namespace ryujin
           if (!is_locally_owned)
             return;
 
+          copy.cell_id_ = cell->id();
+
+          local_dof_indices.resize(dofs_per_cell);
+          cell->get_dof_indices(local_dof_indices);
+
+          /* reuse the cell matrices of an unchanged cell: */
+          if (cache_cell_matrices_) {
+            const auto it = cell_matrix_cache_.find(copy.cell_id_);
+            if (it != cell_matrix_cache_.end()) {
+              const auto &cached = it->second;
+              cell_mass_matrix = cached.mass_matrix;
+              cell_betaij_matrix = cached.betaij_matrix;
+              for (unsigned int d = 0; d < dim; ++d)
+                cell_cij_matrix[d] = cached.cij_matrix[d];
+              copy.cell_volume_ = cached.volume;
+              cell_measure = cell->is_locally_owned() ? cached.volume : 0.;
+              return;
+            }
+          }
+
           cell_mass_matrix.reinit(dofs_per_cell, dofs_per_cell);
           cell_betaij_matrix.reinit(dofs_per_cell, dofs_per_cell);
           for (auto &matrix : cell_cij_matrix)
             matrix.reinit(dofs_per_cell, dofs_per_cell);
 
-          fe_values.reinit(cell);
-
-          local_dof_indices.resize(dofs_per_cell);
-          cell->get_dof_indices(local_dof_indices);
+          /*
+           * Nota bene: We assemble with the subcell finite element that
+           * differs from the finite element of the DoFHandler for
+           * order_finite_element > 1. We thus reinitialize with a plain
+           * triangulation iterator:
+           */
+          fe_values.reinit(
+              typename dealii::Triangulation<dim>::cell_iterator(cell));
 
           /* clear out copy data: */
           cell_mass_matrix = 0.;
@@ -350,10 +533,12 @@ namespace ryujin
           for (auto &matrix : cell_cij_matrix)
             matrix = 0.;
           cell_measure = 0.;
+          copy.cell_volume_ = 0.;
 
           for (unsigned int q_point = 0; q_point < n_q_points; ++q_point) {
             const auto JxW = fe_values.JxW(q_point);
 
+            copy.cell_volume_ += Number(JxW);
             if (cell->is_locally_owned())
               cell_measure += Number(JxW);
 
@@ -387,24 +572,85 @@ namespace ryujin
       if (!is_locally_owned)
         return;
 
+      if (direct_assembly) {
+        /* Add the contributions to all locally owned rows: */
+
+        std::vector<unsigned int> local_indices(dofs_per_cell);
+        for (unsigned int a = 0; a < dofs_per_cell; ++a)
+          local_indices[a] =
+              scalar_partitioner_->global_to_local(local_dof_indices[a]);
+
+        for (unsigned int a = 0; a < dofs_per_cell; ++a) {
+          const auto i = local_indices[a];
+          if (i >= n_locally_owned_)
+            continue;
+
+          const unsigned int row_length =
+              sparsity_pattern_simd_.row_length(i);
+          const unsigned int stride = sparsity_pattern_simd_.stride_of_row(i);
+          const unsigned int *js = sparsity_pattern_simd_.columns(i);
+
+          for (unsigned int b = 0; b < dofs_per_cell; ++b) {
+            unsigned int col_idx = 0;
+            while (js[col_idx * stride] != local_indices[b])
+              ++col_idx;
+            Assert(col_idx < row_length, ExcInternalError());
+            (void)row_length;
+
+            mass_matrix_simd.write_entry(
+                mass_matrix_simd.get_entry(i, col_idx) +
+                    Number(cell_mass_matrix(a, b)),
+                i,
+                col_idx);
+
+            betaij_matrix_simd.write_entry(
+                betaij_matrix_simd.get_entry(i, col_idx) +
+                    Number(cell_betaij_matrix(a, b)),
+                i,
+                col_idx);
+
+            auto c_ij = cij_matrix_simd.get_tensor(i, col_idx);
+            for (unsigned int d = 0; d < dim; ++d)
+              c_ij[d] += Number(cell_cij_matrix[d](a, b));
+            cij_matrix_simd.write_tensor(c_ij, i, col_idx);
+          }
+        }
+
+      } else {
 #ifndef DEAL_II_WITH_TRILINOS
-      transform_to_local_range(*scalar_partitioner_, local_dof_indices);
+        transform_to_local_range(*scalar_partitioner_, local_dof_indices);
 #endif
 
-      affine_constraints_assembly.distribute_local_to_global(
-          cell_mass_matrix, local_dof_indices, mass_matrix_tmp);
+        affine_constraints_assembly.distribute_local_to_global(
+            cell_mass_matrix, local_dof_indices, mass_matrix_tmp);
+
+        for (int k = 0; k < dim; ++k) {
+          affine_constraints_assembly.distribute_local_to_global(
+              cell_cij_matrix[k], local_dof_indices, cij_matrix_tmp[k]);
+        }
 
-      for (int k = 0; k < dim; ++k) {
         affine_constraints_assembly.distribute_local_to_global(
-            cell_cij_matrix[k], local_dof_indices, cij_matrix_tmp[k]);
+            cell_betaij_matrix, local_dof_indices, betaij_matrix_tmp);
       }
 
-      affine_constraints_assembly.distribute_local_to_global(
-          cell_betaij_matrix, local_dof_indices, betaij_matrix_tmp);
+      measure_of_omega += cell_measure;
 
-      measure_of_omega_ += cell_measure;
+      if (cache_cell_matrices_) {
+        auto &cached = new_cell_matrix_cache[copy.cell_id_];
+        cached.mass_matrix = cell_mass_matrix;
+        cached.betaij_matrix = cell_betaij_matrix;
+        for (unsigned int d = 0; d < dim; ++d)
+          cached.cij_matrix[d] = cell_cij_matrix[d];
+        cached.volume = copy.cell_volume_;
+      }
     };
 
+    /*
+     * The worker only reads from cell_matrix_cache_, the (serial) copier
+     * populates the cache for the current mesh:
+     */
+    decltype(cell_matrix_cache_) new_cell_matrix_cache;
+
     WorkStream::run(dof_handler.begin_active(),
                     dof_handler.end(),
                     local_assemble_system,
@@ -416,74 +662,584 @@ namespace ryujin
                     AssemblyCopyData<dim, Number>());
 #endif
 
+    cell_matrix_cache_.swap(new_cell_matrix_cache);
+
     measure_of_omega_ =
-        Utilities::MPI::sum(measure_of_omega_, mpi_communicator_);
+        Utilities::MPI::sum(measure_of_omega, mpi_communicator_);
+
+    if (direct_assembly) {
+      /* Create lumped mass matrix from the locally owned rows: */
+
+      for (unsigned int i = 0; i < n_locally_owned_; ++i) {
+        double sum = 0.;
+        const unsigned int row_length = sparsity_pattern_simd_.row_length(i);
+        for (unsigned int col_idx = 0; col_idx < row_length; ++col_idx)
+          sum += mass_matrix_simd.get_entry(i, col_idx);
+        lumped_mass_matrix_.local_element(i) = Number(sum);
+        lumped_mass_matrix_inverse_.local_element(i) = Number(1. / sum);
+      }
+      lumped_mass_matrix_.update_ghost_values();
+      lumped_mass_matrix_inverse_.update_ghost_values();
+
+      betaij_matrix_.copy_from(betaij_matrix_simd);
+      mass_matrix_.copy_from(mass_matrix_simd);
+      cij_matrix_.copy_from(cij_matrix_simd);
 
+    } else {
 #ifdef DEAL_II_WITH_TRILINOS
-    betaij_matrix_tmp.compress(VectorOperation::add);
-    mass_matrix_tmp.compress(VectorOperation::add);
-    for (auto &it : cij_matrix_tmp)
-      it.compress(VectorOperation::add);
+      betaij_matrix_tmp.compress(VectorOperation::add);
+      mass_matrix_tmp.compress(VectorOperation::add);
+      for (auto &it : cij_matrix_tmp)
+        it.compress(VectorOperation::add);
 #endif
 
-    /*
-     * Create lumped mass matrix:
-     */
+      /*
+       * Create lumped mass matrix:
+       */
 
-    {
+      {
 #ifdef DEAL_II_WITH_TRILINOS
-      using scalar_type = dealii::LinearAlgebra::distributed::Vector<double>;
-      scalar_type one(scalar_partitioner_);
-      one = 1.;
-
-      scalar_type local_lumped_mass_matrix(scalar_partitioner_);
-      mass_matrix_tmp.vmult(local_lumped_mass_matrix, one);
-      lumped_mass_matrix_.compress(VectorOperation::add);
-
-      for (unsigned int i = 0; i < scalar_partitioner_->local_size(); ++i) {
-        lumped_mass_matrix_.local_element(i) =
-            local_lumped_mass_matrix.local_element(i);
-        lumped_mass_matrix_inverse_.local_element(i) =
-            1. / lumped_mass_matrix_.local_element(i);
-      }
-      lumped_mass_matrix_.update_ghost_values();
-      lumped_mass_matrix_inverse_.update_ghost_values();
+        using scalar_type = dealii::LinearAlgebra::distributed::Vector<double>;
+        scalar_type one(scalar_partitioner_);
+        one = 1.;
+
+        scalar_type local_lumped_mass_matrix(scalar_partitioner_);
+        mass_matrix_tmp.vmult(local_lumped_mass_matrix, one);
+        lumped_mass_matrix_.compress(VectorOperation::add);
+
+        for (unsigned int i = 0; i < scalar_partitioner_->local_size(); ++i) {
+          lumped_mass_matrix_.local_element(i) =
+              local_lumped_mass_matrix.local_element(i);
+          lumped_mass_matrix_inverse_.local_element(i) =
+              1. / lumped_mass_matrix_.local_element(i);
+        }
+        lumped_mass_matrix_.update_ghost_values();
+        lumped_mass_matrix_inverse_.update_ghost_values();
 
 #else
 
-      Vector<Number> one(mass_matrix_tmp.m());
-      one = 1.;
+        Vector<Number> one(mass_matrix_tmp.m());
+        one = 1.;
 
-      Vector<Number> local_lumped_mass_matrix(mass_matrix_tmp.m());
-      mass_matrix_tmp.vmult(local_lumped_mass_matrix, one);
+        Vector<Number> local_lumped_mass_matrix(mass_matrix_tmp.m());
+        mass_matrix_tmp.vmult(local_lumped_mass_matrix, one);
 
-      for (unsigned int i = 0; i < scalar_partitioner_->local_size(); ++i) {
-        lumped_mass_matrix_.local_element(i) = local_lumped_mass_matrix(i);
-        lumped_mass_matrix_inverse_.local_element(i) =
-            1. / lumped_mass_matrix_.local_element(i);
-      }
-      lumped_mass_matrix_.update_ghost_values();
-      lumped_mass_matrix_inverse_.update_ghost_values();
+        for (unsigned int i = 0; i < scalar_partitioner_->local_size(); ++i) {
+          lumped_mass_matrix_.local_element(i) = local_lumped_mass_matrix(i);
+          lumped_mass_matrix_inverse_.local_element(i) =
+              1. / lumped_mass_matrix_.local_element(i);
+        }
+        lumped_mass_matrix_.update_ghost_values();
+        lumped_mass_matrix_inverse_.update_ghost_values();
 #endif
-    }
+      }
 
 #ifdef DEAL_II_WITH_TRILINOS
-    betaij_matrix_.read_in(betaij_matrix_tmp, /*locally_indexed*/ false);
-    mass_matrix_.read_in(mass_matrix_tmp, /*locally_indexed*/ false);
-    cij_matrix_.read_in(cij_matrix_tmp, /*locally_indexed*/ false);
+      betaij_matrix_.read_in(betaij_matrix_tmp, /*locally_indexed*/ false);
+      mass_matrix_.read_in(mass_matrix_tmp, /*locally_indexed*/ false);
+      cij_matrix_.read_in(cij_matrix_tmp, /*locally_indexed*/ false);
 #else
-    betaij_matrix_.read_in(betaij_matrix_tmp, /*locally_indexed*/ true);
-    mass_matrix_.read_in(mass_matrix_tmp, /*locally_indexed*/ true);
-    cij_matrix_.read_in(cij_matrix_tmp, /*locally_indexed*/ true);
+      betaij_matrix_.read_in(betaij_matrix_tmp, /*locally_indexed*/ true);
+      mass_matrix_.read_in(mass_matrix_tmp, /*locally_indexed*/ true);
+      cij_matrix_.read_in(cij_matrix_tmp, /*locally_indexed*/ true);
 #endif
+
+      /* The global sparsity pattern is not needed any more: */
+      sparsity_pattern_ = DynamicSparsityPattern();
+    }
     betaij_matrix_.update_ghost_rows();
     mass_matrix_.update_ghost_rows();
     cij_matrix_.update_ghost_rows();
 
+    /* Precompute n_ij and |c_ij|: */
+
+    if (precompute_nij_) {
+      const unsigned int n_owned = n_locally_owned_;
+      for (unsigned int i = 0; i < n_owned; ++i) {
+        const unsigned int row_length = sparsity_pattern_simd_.row_length(i);
+        for (unsigned int col_idx = 0; col_idx < row_length; ++col_idx) {
+          const auto c_ij = cij_matrix_.get_tensor(i, col_idx);
+          const Number norm = c_ij.norm();
+          /* Skip the diagonal and (possibly) vanishing entries: */
+          const auto n_ij = col_idx == 0 || norm == Number(0.)
+                                ? Tensor<1, dim, Number>()
+                                : Tensor<1, dim, Number>(c_ij / norm);
+          nij_matrix_.write_tensor(n_ij, i, col_idx);
+          cij_norm_matrix_.write_entry(norm, i, col_idx);
+        }
+      }
+      nij_matrix_.update_ghost_rows();
+      cij_norm_matrix_.update_ghost_rows();
+    }
+
     /* Populate boundary map: */
 
     boundary_map_ = construct_boundary_map(
         dof_handler.begin_active(), dof_handler.end(), *scalar_partitioner_);
+
+#ifdef USE_ON_THE_FLY_CIJ
+    setup_cij_reconstruction();
+#endif
+  }
+
+
+  template <int dim, typename Number>
+  void OfflineData<dim, Number>::setup_serial_partition()
+  {
+#ifdef DEBUG_OUTPUT
+    std::cout << "OfflineData<dim, Number>::setup_serial_partition()"
+              << std::endl;
+#endif
+
+    /*
+     * The cost of a non-vectorized row is dominated by the Riemann
+     * problems (and limiter updates) of its stencil. Boundary rows
+     * additionally symmetrize all edges along the boundary and apply
+     * boundary conditions; we simply count them twice. Constrained rows
+     * are skipped by all loops and get a nominal cost of one:
+     */
+
+    const unsigned int n_serial = n_locally_owned_ - n_locally_internal_;
+    serial_cost_.resize(n_serial + 1);
+    serial_cost_[0] = 0;
+
+    for (unsigned int k = 0; k < n_serial; ++k) {
+      const unsigned int i = n_locally_internal_ + k;
+      std::size_t cost = sparsity_pattern_simd_.row_length(i);
+      if (cost > 1 && boundary_map_.count(i) != 0)
+        cost *= 2;
+      serial_cost_[k + 1] = serial_cost_[k] + cost;
+    }
+  }
+
+
+#ifdef USE_ON_THE_FLY_CIJ
+  template <int dim, typename Number>
+  void OfflineData<dim, Number>::setup_cij_reconstruction()
+  {
+#ifdef DEBUG_OUTPUT
+    std::cout << "OfflineData<dim, Number>::setup_cij_reconstruction()"
+              << std::endl;
+#endif
+
+    constexpr unsigned int n_cells = GeometryInfo<dim>::vertices_per_cell;
+
+    const auto &dof_handler = *dof_handler_;
+    const auto &finite_element = discretization_->finite_element();
+    const auto &quadrature = discretization_->quadrature();
+
+    dofs_per_cell_ = finite_element.dofs_per_cell;
+
+    AssertThrow(dofs_per_cell_ == n_cells,
+                ExcMessage("On the fly reconstruction of c_ij is only "
+                           "implemented for Q1 elements"));
+
+    AssertThrow(affine_constraints_.n_constraints() == 0,
+                ExcMessage("On the fly reconstruction of c_ij is not "
+                           "available in the presence of hanging node or "
+                           "periodicity constraints"));
+
+    /*
+     * Reference cell integrals \hat c_ab = \int \hat phi_a \nabla \hat
+     * phi_b:
+     */
+
+    reference_cij_.assign(dofs_per_cell_ * dofs_per_cell_,
+                          Tensor<1, dim, Number>());
+
+    for (unsigned int q = 0; q < quadrature.size(); ++q) {
+      const auto &point = quadrature.point(q);
+      const auto weight = quadrature.weight(q);
+      for (unsigned int a = 0; a < dofs_per_cell_; ++a) {
+        const auto value = finite_element.shape_value(a, point) * weight;
+        for (unsigned int b = 0; b < dofs_per_cell_; ++b) {
+          const auto grad = finite_element.shape_grad(b, point);
+          for (unsigned int d = 0; d < dim; ++d)
+            reference_cij_[a * dofs_per_cell_ + b][d] +=
+                Number(value * grad[d]);
+        }
+      }
+    }
+
+    /*
+     * Per cell geometry |det J| J^{-T} and the cell lists of all rows in
+     * the vectorized index range:
+     */
+
+    const auto &triangulation = dof_handler.get_triangulation();
+    cell_geometry_.resize(triangulation.n_active_cells() * dim * dim);
+
+    row_cells_.resize(n_locally_internal_ * n_cells);
+    row_local_index_.resize(n_locally_internal_ * n_cells);
+    row_columns_.resize(n_locally_internal_ * n_cells * dofs_per_cell_);
+    std::vector<unsigned int> n_cells_of_row(n_locally_internal_, 0);
+
+    FEValues<dim> fe_values(discretization_->mapping(),
+                            finite_element,
+                            quadrature,
+                            update_jacobians);
+
+    std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell_);
+    std::vector<unsigned int> local_indices(dofs_per_cell_);
+
+    for (const auto &cell : dof_handler.active_cell_iterators()) {
+      if (cell->is_artificial())
+        continue;
+
+      fe_values.reinit(cell);
+
+      const Tensor<2, dim> jacobian = fe_values.jacobian(0);
+      for (unsigned int q = 1; q < quadrature.size(); ++q)
+        AssertThrow((Tensor<2, dim>(fe_values.jacobian(q)) - jacobian).norm() <=
+                        1.e-10 * jacobian.norm(),
+                    ExcMessage("On the fly reconstruction of c_ij is only "
+                               "implemented for affine cells"));
+
+      const auto geometry =
+          std::abs(determinant(jacobian)) * transpose(invert(jacobian));
+
+      const auto cell_index = cell->active_cell_index();
+      for (unsigned int d = 0; d < dim; ++d)
+        for (unsigned int e = 0; e < dim; ++e)
+          cell_geometry_[cell_index * dim * dim + d * dim + e] =
+              Number(geometry[d][e]);
+
+      cell->get_dof_indices(local_dof_indices);
+
+      for (unsigned int a = 0; a < dofs_per_cell_; ++a)
+        local_indices[a] =
+            scalar_partitioner_->global_to_local(local_dof_indices[a]);
+
+      for (unsigned int a = 0; a < dofs_per_cell_; ++a) {
+        const auto row = local_indices[a];
+        if (row >= n_locally_internal_ ||
+            !scalar_partitioner_->in_local_range(local_dof_indices[a]))
+          continue;
+
+        auto &c = n_cells_of_row[row];
+        AssertThrow(c < n_cells,
+                    ExcMessage("On the fly reconstruction of c_ij requires "
+                               "a vertex valence of 2^dim in the "
+                               "vectorized index range"));
+
+        const unsigned int index = row * n_cells + c;
+        row_cells_[index] = cell_index;
+        row_local_index_[index] = a;
+
+        const unsigned int row_length = sparsity_pattern_simd_.row_length(row);
+        const unsigned int *js = sparsity_pattern_simd_.columns(row);
+
+        for (unsigned int b = 0; b < dofs_per_cell_; ++b) {
+          unsigned int col_idx = 0;
+          for (; col_idx < row_length; ++col_idx)
+            if (js[col_idx * simd_length] == local_indices[b])
+              break;
+          Assert(col_idx < row_length, ExcInternalError());
+          row_columns_[index * dofs_per_cell_ + b] = col_idx;
+        }
+
+        ++c;
+      }
+    }
+
+    for (unsigned int i = 0; i < n_locally_internal_; ++i)
+      AssertThrow(n_cells_of_row[i] == n_cells,
+                  ExcMessage("On the fly reconstruction of c_ij requires "
+                             "a vertex valence of 2^dim in the vectorized "
+                             "index range"));
+  }
+#endif
+
+
+  template <int dim, typename Number>
+  std::string OfflineData<dim, Number>::cache_file_name() const
+  {
+    const auto n_ranks = Utilities::MPI::n_mpi_processes(mpi_communicator_);
+    const auto rank = Utilities::MPI::this_mpi_process(mpi_communicator_);
+
+    return cache_directory_ + "/offline_data-" + std::to_string(dim) +
+           "d-" + Utilities::int_to_string(n_ranks) + "-" +
+           Utilities::int_to_string(rank, 4) + ".cache";
+  }
+
+
+  template <int dim, typename Number>
+  std::string OfflineData<dim, Number>::cache_signature() const
+  {
+    const auto &triangulation = discretization_->triangulation();
+
+    /*
+     * Hash the cell ids, the vertex positions and the boundary ids of
+     * all locally relevant cells. Both, the coarse mesh and the
+     * partitioning have to be identical for the cache to be valid:
+     */
+
+    std::size_t hash = 0;
+    for (const auto &cell : triangulation.active_cell_iterators()) {
+      if (cell->is_artificial())
+        continue;
+
+      boost::hash_combine(hash, cell->id().to_string());
+      boost::hash_combine(hash, cell->subdomain_id());
+
+      for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell; ++v)
+        for (unsigned int d = 0; d < dim; ++d)
+          boost::hash_combine(hash, cell->vertex(v)[d]);
+
+      for (unsigned int f = 0; f < GeometryInfo<dim>::faces_per_cell; ++f)
+        if (cell->at_boundary(f))
+          boost::hash_combine(hash, cell->face(f)->boundary_id());
+    }
+
+    std::ostringstream signature;
+    signature << "ryujin offline data cache, version 2\n"
+              << boost::core::demangle(typeid(*this).name()) << "\n"
+              << boost::core::demangle(typeid(betaij_matrix_).name()) << "\n"
+              << boost::core::demangle(typeid(cij_matrix_).name()) << "\n"
+              << discretization_->finite_element().get_name() << "\n"
+              << Utilities::MPI::n_mpi_processes(mpi_communicator_) << " "
+              << Utilities::MPI::this_mpi_process(mpi_communicator_) << " "
+              << precompute_nij_ << " " << dof_renumbering_ << " "
+              << triangulation.n_global_active_cells() << " " << hash;
+
+    return signature.str();
+  }
+
+
+  template <int dim, typename Number>
+  bool OfflineData<dim, Number>::read_cache()
+  {
+    if (cache_directory_.empty())
+      return false;
+
+#ifdef DEBUG_OUTPUT
+    std::cout << "OfflineData<dim, Number>::read_cache()" << std::endl;
+#endif
+
+    if (!dof_handler_)
+      dof_handler_ = std::make_unique<dealii::DoFHandler<dim>>(
+          discretization_->triangulation());
+    auto &dof_handler = *dof_handler_;
+
+    dof_handler.distribute_dofs(discretization_->finite_element());
+
+    /*
+     * Read and compare the signature. We only proceed if a valid cache
+     * file is available on all MPI ranks:
+     */
+
+    std::ifstream file(cache_file_name(), std::ios::binary);
+    std::unique_ptr<boost::archive::binary_iarchive> archive;
+    std::shared_ptr<const MemoryMappedFile> mapped_file;
+    std::string signature;
+
+    if (file.is_open()) {
+      try {
+        archive = std::make_unique<boost::archive::binary_iarchive>(file);
+        *archive >> signature;
+        mapped_file =
+            std::make_shared<MemoryMappedFile>(cache_file_name() + ".data");
+      } catch (const boost::archive::archive_exception &) {
+        signature.clear();
+      } catch (const dealii::ExceptionBase &) {
+        signature.clear();
+      }
+    }
+
+    const bool valid = !signature.empty() && signature == cache_signature();
+    if (Utilities::MPI::min(valid ? 1u : 0u, mpi_communicator_) == 0u)
+      return false;
+
+    /*
+     * Restore the DoF numbering. The cache stores the (final) DoF indices
+     * of all locally owned cells:
+     */
+
+    {
+      std::vector<types::global_dof_index> cell_dof_indices;
+      *archive >> cell_dof_indices;
+
+      const IndexSet &locally_owned = dof_handler.locally_owned_dofs();
+      std::vector<types::global_dof_index> new_numbers(
+          locally_owned.n_elements());
+
+      const unsigned int dofs_per_cell =
+          discretization_->finite_element().dofs_per_cell;
+      std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
+
+      auto it = cell_dof_indices.begin();
+      for (const auto &cell : dof_handler.active_cell_iterators()) {
+        if (!cell->is_locally_owned())
+          continue;
+
+        AssertThrow(std::size_t(cell_dof_indices.end() - it) >= dofs_per_cell,
+                    ExcMessage("Corrupted offline data cache"));
+
+        cell->get_dof_indices(local_dof_indices);
+        for (const auto index : local_dof_indices) {
+          if (locally_owned.is_element(index))
+            new_numbers[locally_owned.index_within_set(index)] = *it;
+          ++it;
+        }
+      }
+
+      AssertThrow(it == cell_dof_indices.end(),
+                  ExcMessage("Corrupted offline data cache"));
+
+      dof_handler.renumber_dofs(new_numbers);
+    }
+
+    *archive >> n_locally_internal_ >> n_export_indices_;
+
+    /* Constraints and partitioners: */
+
+    const IndexSet &locally_owned = dof_handler.locally_owned_dofs();
+
+    IndexSet locally_relevant;
+    DoFTools::extract_locally_relevant_dofs(dof_handler, locally_relevant);
+
+    setup_affine_constraints(locally_relevant);
+
+    /* The locally relevant set including all additional couplings: */
+    *archive >> locally_relevant;
+
+    n_locally_owned_ = locally_owned.n_elements();
+    n_locally_relevant_ = locally_relevant.n_elements();
+
+    scalar_partitioner_ = std::make_shared<dealii::Utilities::MPI::Partitioner>(
+        locally_owned, locally_relevant, mpi_communicator_);
+
+    constexpr auto problem_dimension =
+        ProblemDescription::problem_dimension<dim>;
+    vector_partitioner_ =
+        create_vector_partitioner<problem_dimension>(scalar_partitioner_);
+
+    /* The dynamic sparsity pattern is not restored: */
+    sparsity_pattern_ = DynamicSparsityPattern();
+
+    sparsity_pattern_simd_.load(*archive, mapped_file, scalar_partitioner_);
+
+    /* Lumped mass matrix and matrices: */
+
+    lumped_mass_matrix_.reinit(scalar_partitioner_);
+    lumped_mass_matrix_inverse_.reinit(scalar_partitioner_);
+
+    auto lumped_mass_matrix_entries = boost::serialization::make_array(
+        lumped_mass_matrix_.begin(), n_locally_owned_);
+    *archive >> lumped_mass_matrix_entries;
+    for (unsigned int i = 0; i < n_locally_owned_; ++i)
+      lumped_mass_matrix_inverse_.local_element(i) =
+          1. / lumped_mass_matrix_.local_element(i);
+    lumped_mass_matrix_.update_ghost_values();
+    lumped_mass_matrix_inverse_.update_ghost_values();
+
+    mass_matrix_.load(*archive, sparsity_pattern_simd_, mapped_file);
+    betaij_matrix_.load(*archive, sparsity_pattern_simd_, mapped_file);
+    cij_matrix_.load(*archive, sparsity_pattern_simd_, mapped_file);
+
+    if (precompute_nij_) {
+      nij_matrix_.load(*archive, sparsity_pattern_simd_, mapped_file);
+      cij_norm_matrix_.load(*archive, sparsity_pattern_simd_, mapped_file);
+    }
+
+    *archive >> measure_of_omega_;
+
+    /* Boundary map: */
+
+    boundary_map_.clear();
+    std::size_t n_boundary_entries = 0;
+    *archive >> n_boundary_entries;
+    for (std::size_t k = 0; k < n_boundary_entries; ++k) {
+      types::global_dof_index index;
+      dealii::Tensor<1, dim, Number> normal;
+      dealii::types::boundary_id id;
+      dealii::Point<dim> position;
+      *archive >> index >> normal >> id >> position;
+      boundary_map_.insert({index, {normal, id, position}});
+    }
+
+    cell_matrix_cache_.clear();
+
+#ifdef USE_ON_THE_FLY_CIJ
+    setup_cij_reconstruction();
+#endif
+
+    return true;
+  }
+
+
+  template <int dim, typename Number>
+  void OfflineData<dim, Number>::write_cache() const
+  {
+    if (cache_directory_.empty())
+      return;
+
+#ifdef DEBUG_OUTPUT
+    std::cout << "OfflineData<dim, Number>::write_cache()" << std::endl;
+#endif
+
+    std::error_code error_code;
+    std::filesystem::create_directories(cache_directory_, error_code);
+
+    std::ofstream file(cache_file_name(), std::ios::binary | std::ios::trunc);
+    AssertThrow(file.is_open(),
+                ExcMessage("Could not open offline data cache file \"" +
+                           cache_file_name() + "\" for writing"));
+
+    boost::archive::binary_oarchive archive(file);
+    MemoryMappedFileWriter writer(cache_file_name() + ".data");
+
+    const auto signature = cache_signature();
+    archive << signature;
+
+    /* The DoF indices of all locally owned cells: */
+
+    {
+      const auto &dof_handler = *dof_handler_;
+      const unsigned int dofs_per_cell =
+          discretization_->finite_element().dofs_per_cell;
+      std::vector<types::global_dof_index> local_dof_indices(dofs_per_cell);
+
+      std::vector<types::global_dof_index> cell_dof_indices;
+      for (const auto &cell : dof_handler.active_cell_iterators()) {
+        if (!cell->is_locally_owned())
+          continue;
+        cell->get_dof_indices(local_dof_indices);
+        cell_dof_indices.insert(cell_dof_indices.end(),
+                                local_dof_indices.begin(),
+                                local_dof_indices.end());
+      }
+      archive << cell_dof_indices;
+    }
+
+    archive << n_locally_internal_ << n_export_indices_;
+
+    IndexSet locally_relevant = scalar_partitioner_->locally_owned_range();
+    locally_relevant.add_indices(scalar_partitioner_->ghost_indices());
+    archive << locally_relevant;
+
+    sparsity_pattern_simd_.save(archive, writer);
+
+    archive << boost::serialization::make_array(lumped_mass_matrix_.begin(),
+                                                n_locally_owned_);
+
+    mass_matrix_.save(archive, writer);
+    betaij_matrix_.save(archive, writer);
+    cij_matrix_.save(archive, writer);
+
+    if (precompute_nij_) {
+      nij_matrix_.save(archive, writer);
+      cij_norm_matrix_.save(archive, writer);
+    }
+
+    archive << measure_of_omega_;
+
+    const std::size_t n_boundary_entries = boundary_map_.size();
+    archive << n_boundary_entries;
+    for (const auto &[index, description] : boundary_map_) {
+      const auto &[normal, id, position] = description;
+      archive << index << normal << id << position;
+    }
   }
 
 
@@ -547,6 +1303,59 @@ namespace ryujin
   }
 
 
+  template <int dim, typename Number>
+  std::vector<std::pair<std::string, std::size_t>>
+  OfflineData<dim, Number>::memory_consumption() const
+  {
+    std::vector<std::pair<std::string, std::size_t>> result;
+
+    result.emplace_back("dof handler", dof_handler_->memory_consumption());
+    result.emplace_back("affine constraints",
+                        affine_constraints_.memory_consumption());
+    result.emplace_back("sparsity pattern",
+                        sparsity_pattern_simd_.memory_consumption());
+    result.emplace_back("mass matrix", mass_matrix_.memory_consumption());
+    result.emplace_back("lumped mass matrix",
+                        lumped_mass_matrix_.memory_consumption() +
+                            lumped_mass_matrix_inverse_.memory_consumption());
+    result.emplace_back("betaij matrix", betaij_matrix_.memory_consumption());
+    result.emplace_back("cij matrix", cij_matrix_.memory_consumption());
+    if (precompute_nij_) {
+      result.emplace_back("nij matrix", nij_matrix_.memory_consumption());
+      result.emplace_back("cij norm matrix",
+                          cij_norm_matrix_.memory_consumption());
+    }
+
+    std::size_t level_mass = 0;
+    for (const auto &it : level_lumped_mass_matrix_)
+      level_mass += it.memory_consumption();
+    result.emplace_back("level lumped mass matrices", level_mass);
+
+    if (cache_cell_matrices_) {
+      std::size_t cache = 0;
+      for (const auto &[id, matrices] : cell_matrix_cache_) {
+        cache += matrices.mass_matrix.memory_consumption() +
+                 matrices.betaij_matrix.memory_consumption();
+        for (const auto &it : matrices.cij_matrix)
+          cache += it.memory_consumption();
+      }
+      result.emplace_back("cell matrix cache", cache);
+    }
+
+#ifdef USE_ON_THE_FLY_CIJ
+    result.emplace_back(
+        "cij reconstruction",
+        cell_geometry_.memory_consumption() +
+            MemoryConsumption::memory_consumption(reference_cij_) +
+            row_cells_.memory_consumption() +
+            row_local_index_.memory_consumption() +
+            row_columns_.memory_consumption());
+#endif
+
+    return result;
+  }
+
+
   template <int dim, typename Number>
   template <typename ITERATOR1, typename ITERATOR2>
   typename OfflineData<dim, Number>::boundary_map_type
@@ -564,13 +1373,25 @@ namespace ryujin
 
     std::vector<dealii::types::global_dof_index> local_dof_indices;
 
-    const dealii::QGauss<dim - 1> face_quadrature(3);
-    dealii::FEFaceValues<dim> fe_face_values(discretization_->mapping(),
-                                             discretization_->finite_element(),
-                                             face_quadrature,
-                                             dealii::update_normal_vectors |
-                                                 dealii::update_values |
-                                                 dealii::update_JxW_values);
+    /*
+     * Compute boundary normals with the subcell finite element so that
+     * they are consistent with the c_ij matrix:
+     */
+    constexpr auto order_finite_element =
+        Discretization<dim>::order_finite_element;
+    const dealii::Quadrature<dim - 1> face_quadrature = []() {
+      if constexpr (order_finite_element == 1 || dim == 1)
+        return dealii::Quadrature<dim - 1>(dealii::QGauss<dim - 1>(3));
+      else
+        return dealii::Quadrature<dim - 1>(dealii::QIterated<dim - 1>(
+            dealii::QGauss<1>(2), order_finite_element));
+    }();
+    dealii::FEFaceValues<dim> fe_face_values(
+        discretization_->mapping(),
+        discretization_->subcell_finite_element(),
+        face_quadrature,
+        dealii::update_normal_vectors | dealii::update_values |
+            dealii::update_JxW_values);
 
     const unsigned int dofs_per_cell =
         discretization_->finite_element().dofs_per_cell;
@@ -612,7 +1433,8 @@ namespace ryujin
         if (!face->at_boundary())
           continue;
 
-        fe_face_values.reinit(cell, f);
+        fe_face_values.reinit(
+            typename dealii::Triangulation<dim>::cell_iterator(cell), f);
         const unsigned int n_face_q_points = face_quadrature.size();
 
         for (unsigned int j = 0; j < dofs_per_cell; ++j) {
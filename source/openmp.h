@@ -11,6 +11,7 @@
 
 #include <atomic>
 #include <omp.h>
+#include <vector>
 
 /**
  * @name OpenMP parallel for macros
@@ -167,6 +168,191 @@ namespace ryujin
     bool executed_payload_;
     std::atomic_int n_threads_ready_;
   };
+
+
+  /**
+   * The counterpart of SynchronizationDispatch: A helper class that
+   * defers the completion of a (pending) MPI ghost exchange to the point
+   * within a parallel loop where ghost values are actually needed for the
+   * first time.
+   *
+   * The first thread calling wait() with @p condition evaluating to true
+   * executes the payload (typically an update_ghost_values_finish()
+   * call), all other threads arriving at that point spin until the
+   * payload has completed. If no thread ever called wait() with a true
+   * condition the payload is executed in the destructor.
+   *
+   * Intended use:
+   * ```
+   * SynchronizationWait synchronization_wait(
+   *     [&]() { vector.update_ghost_values_finish(); });
+   *
+   * RYUJIN_PARALLEL_REGION_BEGIN
+   * bool thread_ready = false;
+   * RYUJIN_OMP_FOR
+   * for (...) {
+   *   synchronization_wait.wait(thread_ready, needs_ghost_values);
+   *   // ...
+   * }
+   * RYUJIN_PARALLEL_REGION_END
+   * ```
+   *
+   * @note Just like SynchronizationDispatch this requires an MPI
+   * implementation that supports MPI_THREAD_SERIALIZED.
+   *
+   * @ingroup Miscellaneous
+   */
+  template <typename Payload>
+  class SynchronizationWait
+  {
+  public:
+    SynchronizationWait(const Payload &payload)
+        : payload_(payload)
+        , claimed_payload_(false)
+        , executed_payload_(false)
+    {
+    }
+
+    ~SynchronizationWait()
+    {
+      if (!claimed_payload_.load())
+        payload_();
+    }
+
+    DEAL_II_ALWAYS_INLINE inline void wait(bool &thread_ready,
+                                           const bool condition)
+    {
+      if (RYUJIN_UNLIKELY(thread_ready == false && condition)) {
+        thread_ready = true;
+        if (!claimed_payload_.exchange(true)) {
+          payload_();
+          executed_payload_.store(true, std::memory_order_release);
+        } else {
+          while (!executed_payload_.load(std::memory_order_acquire))
+            ;
+        }
+      }
+    }
+
+  private:
+    const Payload payload_;
+    std::atomic_bool claimed_payload_;
+    std::atomic_bool executed_payload_;
+  };
+
+
+  /**
+   * A reduction over all threads of a parallel region without atomic
+   * operations or critical sections: Every thread owns a slot (padded to
+   * a cache line to avoid false sharing) that it updates through local().
+   * After the parallel region, combine() reduces all slots in a
+   * pairwise tree. The order of the tree does not depend on thread
+   * timing, so floating-point sums are reproducible for a fixed number
+   * of threads. The result is typically passed directly to an MPI
+   * reduction.
+   *
+   * Intended use:
+   * ```
+   * ThreadReduction<double> tau_max(infinity);
+   *
+   * RYUJIN_PARALLEL_REGION_BEGIN
+   * auto &tau_max_on_thread = tau_max.local();
+   * RYUJIN_OMP_FOR
+   * for (unsigned int i = 0; i < size; ++i)
+   *   tau_max_on_thread = std::min(tau_max_on_thread, tau_i);
+   * RYUJIN_PARALLEL_REGION_END
+   *
+   * const auto result = Utilities::MPI::min(
+   *     tau_max.combine([](auto a, auto b) { return std::min(a, b); }),
+   *     mpi_communicator);
+   * ```
+   *
+   * @ingroup Miscellaneous
+   */
+  template <typename T>
+  class ThreadReduction
+  {
+  public:
+    ThreadReduction(const T &identity)
+        : slots_(omp_get_max_threads(), Slot{identity})
+    {
+    }
+
+    /**
+     * Return the slot of the calling thread.
+     */
+    T &local()
+    {
+      return slots_[omp_get_thread_num()].value;
+    }
+
+    /**
+     * Reduce all slots with the binary operation @p op. Must be called
+     * outside of a parallel region.
+     */
+    template <typename Op>
+    T combine(const Op &op)
+    {
+      const std::size_t size = slots_.size();
+      for (std::size_t stride = 1; stride < size; stride *= 2)
+        for (std::size_t k = 0; k + stride < size; k += 2 * stride)
+          slots_[k].value = op(slots_[k].value, slots_[k + stride].value);
+      return slots_[0].value;
+    }
+
+  private:
+    struct alignas(64) Slot {
+      T value;
+    };
+
+    std::vector<Slot> slots_;
+  };
+
+
+  /**
+   * Accumulated per-thread idle time of a parallel region: A call to
+   * barrier() (from all threads of the region) executes a barrier and
+   * adds the time every thread spent waiting in it.
+   *
+   * Intended use:
+   * ```
+   * RYUJIN_PARALLEL_REGION_BEGIN
+   * RYUJIN_OMP_FOR_NOWAIT
+   * for (unsigned int i = 0; i < size; ++i) {
+   *   // unevenly distributed work
+   * }
+   * idle_time.barrier();
+   * RYUJIN_PARALLEL_REGION_END
+   * ```
+   *
+   * @ingroup Miscellaneous
+   */
+  class IdleTime
+  {
+  public:
+    IdleTime()
+        : idle_times_(omp_get_max_threads(), 0.)
+    {
+    }
+
+    void barrier()
+    {
+      const double start = omp_get_wtime();
+      RYUJIN_OMP_BARRIER
+      idle_times_[omp_get_thread_num()] += omp_get_wtime() - start;
+    }
+
+    /**
+     * Return the accumulated idle time (in seconds) of every thread.
+     */
+    const std::vector<double> &idle_times() const
+    {
+      return idle_times_;
+    }
+
+  private:
+    std::vector<double> idle_times_;
+  };
 } // namespace ryujin
 
 //@}
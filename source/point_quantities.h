@@ -10,10 +10,12 @@
 #include "convenience_macros.h"
 #include "simd.h"
 
+#include "derived_quantities.h"
 #include "initial_values.h"
 #include "offline_data.h"
 #include "problem_description.h"
 #include "sparse_matrix_simd.h"
+#include "time_averaged_statistics.h"
 
 #include <deal.II/base/parameter_acceptor.h>
 #include <deal.II/base/timer.h>
@@ -22,12 +24,36 @@
 #include <deal.II/lac/vector.h>
 #include <deal.II/matrix_free/matrix_free.h>
 
+#include <array>
+#include <functional>
+#include <future>
+
 namespace ryujin
 {
   /**
    * A postprocessor class to compute point values of quantities of
    * interest.
    *
+   * The velocity and pressure are taken from the shared DerivedQuantities
+   * pipeline; the vorticity and the boundary stress are computed from the
+   * velocity with matrix-free cell and face integrals.
+   *
+   * The points of every manifold are selected once in prepare() and
+   * stored as a sorted index array. In compute() all points of a
+   * manifold are evaluated with SIMD gathers, collected on rank 0 with a
+   * single MPI_Gatherv() of the time dependent values, and written with a
+   * single buffered write.
+   *
+   * If the run time option "asynchronous output" is set, the formatting
+   * and writing of all output files of a call to compute() (or
+   * compute_averages()) is done by a background task on rank 0 that does
+   * not call into MPI. The time loop thus only waits for the (cheap)
+   * evaluation and gather step and continues with the next time steps
+   * while the files are written. The task of the previous call is waited
+   * for at the beginning of the next call to compute(), compute_averages(),
+   * or prepare(). It is advisable to reserve a hardware thread for the
+   * background task on rank 0.
+   *
    * @ingroup TimeLoop
    */
   template <int dim, typename Number = double>
@@ -76,8 +102,14 @@ namespace ryujin
     PointQuantities(const MPI_Comm &mpi_communicator,
                     const ryujin::ProblemDescription &problem_description,
                     const ryujin::OfflineData<dim, Number> &offline_data,
+                    DerivedQuantities<dim, Number> &derived_quantities,
                     const std::string &subsection = "PointQuantities");
 
+    /**
+     * Destructor. Waits for a pending background output task.
+     */
+    ~PointQuantities();
+
     /**
      * Prepare evaluation. A call to @ref prepare() allocates temporary
      * storage and is necessary before compute() can be called.
@@ -86,9 +118,21 @@ namespace ryujin
      * dim + 1) scalar vectors of type OfflineData::scalar_type.
      *
      * The string parameter @ref name is used as base name for output files.
+     *
+     * If the run time option "release scratch storage" is set, the (3 *
+     * dim) scalar vectors holding the velocity, vorticity and boundary
+     * stress are only allocated for the duration of a call to compute().
      */
     void prepare();
 
+    /**
+     * Return the memory consumption (in bytes, of this MPI rank) of all
+     * temporary vectors and the matrix-free data allocated by @ref
+     * prepare() as a list of (name, size) pairs.
+     */
+    std::vector<std::pair<std::string, std::size_t>>
+    memory_consumption() const;
+
     /**
      * Takes a state vector @p U at time t (obtained at the end of a full
      * Strang step) and a velocity vector @p velocity computed at time
@@ -101,6 +145,26 @@ namespace ryujin
                  std::string name,
                  unsigned int cycle);
 
+    /**
+     * Write out the time-averaged state, the mean and the root mean
+     * square of the fluctuations of the pressure, and the mean vorticity
+     * (or boundary stress) accumulated by @p time_averaged_statistics up
+     * to time @p t for all points of interest into the files
+     * "name-manifold-averages.log".
+     *
+     * The function requires MPI communication and is not reentrant.
+     */
+    void compute_averages(
+        const TimeAveragedStatistics<dim, Number> &time_averaged_statistics,
+        const Number t,
+        std::string name);
+
+    /**
+     * Wait for the background task (if any) to finish writing out all
+     * output files of the last call to compute() or compute_averages().
+     */
+    void wait();
+
     //@}
 
   private:
@@ -113,6 +177,10 @@ namespace ryujin
 
     std::vector<std::tuple<std::string, std::string>> boundary_manifolds_;
 
+    bool release_scratch_storage_;
+
+    bool asynchronous_output_;
+
     //@}
     /**
      * @name Internal data
@@ -123,18 +191,68 @@ namespace ryujin
 
     dealii::SmartPointer<const ProblemDescription> problem_description_;
     dealii::SmartPointer<const OfflineData<dim, Number>> offline_data_;
+    dealii::SmartPointer<DerivedQuantities<dim, Number>> derived_quantities_;
+
+    /**
+     * The locally owned points of interest of a manifold: The local
+     * indices are sorted and padded to a multiple of the SIMD width (by
+     * repeating the last index); inverse_masses holds the precomputed
+     * inverse of the lumped (boundary) mass used to normalize the
+     * vorticity (or boundary stress).
+     *
+     * On rank 0, prefixes holds the preformatted static part of all
+     * output lines (position, mass, and normal) sorted by position, and
+     * permutation maps every output line to the corresponding point in
+     * the gathered value array. The number of points per rank is stored
+     * in n_points_per_rank.
+     */
+    struct Manifold {
+      std::string name;
+      unsigned int n_points = 0;
+      std::vector<unsigned int> indices;
+      dealii::AlignedVector<Number> inverse_masses;
+      std::vector<int> n_points_per_rank;
+      std::vector<unsigned int> permutation;
+      std::vector<std::string> prefixes;
+    };
+
+    std::vector<Manifold> interior_points_;
+    std::vector<Manifold> boundary_points_;
+
+    /**
+     * Set up @p manifold from a list of (local index, position, inverse
+     * mass, preformatted static output) tuples of locally owned points.
+     */
+    void setup_manifold(
+        Manifold &manifold,
+        std::vector<std::tuple<unsigned int,
+                               dealii::Point<dim>,
+                               Number,
+                               std::string>> &points) const;
+
+    /**
+     * Gather the time dependent @p values of all points of @p manifold on
+     * rank 0 and write the output file. @p ends holds the (exclusive)
+     * ends of the state, the pressure, and the vorticity (or stress)
+     * values of every point, i.e., ends[2] values are stored per point.
+     *
+     * On rank 0 the formatting and writing of the file is only recorded
+     * in pending_writes_ and carried out by launch_writes().
+     */
+    void write_manifold(const Manifold &manifold,
+                        const std::vector<double> &values,
+                        const std::array<unsigned int, 3> &ends,
+                        const std::string &file_name,
+                        const std::string &header);
 
-    std::vector<std::tuple<
-        std::string,
-        std::map<dealii::types::global_dof_index, dealii::Point<dim>>>>
-        interior_maps_;
+    /**
+     * Carry out all pending writes, either directly or (if
+     * "asynchronous output" is set) in a background task.
+     */
+    void launch_writes();
 
-    using boundary_description =
-        typename OfflineData<dim, Number>::boundary_description;
-    std::vector<std::tuple<
-        std::string,
-        std::multimap<dealii::types::global_dof_index, boundary_description>>>
-        boundary_maps_;
+    std::vector<std::function<void()>> pending_writes_;
+    std::future<void> write_task_;
 
     dealii::MatrixFree<dim, Number> matrix_free_;
 
@@ -143,6 +261,22 @@ namespace ryujin
     block_vector_type boundary_stress_;
     scalar_type lumped_boundary_mass_;
 
+    /**
+     * Compute the (lumped) vorticity_ and boundary_stress_ from the
+     * velocity_ (with up to date ghost values).
+     */
+    void compute_vorticity_and_boundary_stress();
+
+    /**
+     * (Re)allocate the velocity, vorticity and boundary stress vectors.
+     */
+    void allocate_scratch_storage();
+
+    /**
+     * Release the velocity, vorticity and boundary stress vectors.
+     */
+    void release_scratch_storage();
+
     //@}
   };
 
@@ -12,10 +12,18 @@
 #include "simd.h"
 
 #include <deal.II/base/function_parser.h>
+#include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/work_stream.h>
 #include <deal.II/matrix_free/fe_evaluation.h>
 
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/utility.hpp>
+
+#include <array>
 #include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
 
 DEAL_II_NAMESPACE_OPEN
 template <int rank, int dim, typename Number>
@@ -37,11 +45,13 @@ namespace ryujin
       const MPI_Comm &mpi_communicator,
       const ryujin::ProblemDescription &problem_description,
       const ryujin::OfflineData<dim, Number> &offline_data,
+      DerivedQuantities<dim, Number> &derived_quantities,
       const std::string &subsection /*= "PointQuantities"*/)
       : ParameterAcceptor(subsection)
       , mpi_communicator_(mpi_communicator)
       , problem_description_(&problem_description)
       , offline_data_(&offline_data)
+      , derived_quantities_(&derived_quantities)
   {
     add_parameter("interior manifolds",
                   interior_manifolds_,
@@ -56,6 +66,35 @@ namespace ryujin
                   "List of level set functions describing boundary. The "
                   "description is used to only output point values for "
                   "boundary vertices belonging to a certain level set.");
+
+    release_scratch_storage_ = false;
+    add_parameter("release scratch storage",
+                  release_scratch_storage_,
+                  "If enabled the temporary velocity, vorticity, and boundary "
+                  "stress vectors are released after every call to compute() "
+                  "and reallocated on the next call");
+
+    asynchronous_output_ = true;
+    add_parameter("asynchronous output",
+                  asynchronous_output_,
+                  "If enabled the output files are formatted and written by "
+                  "a background task on rank 0 while the time loop "
+                  "continues");
+  }
+
+
+  template <int dim, typename Number>
+  PointQuantities<dim, Number>::~PointQuantities()
+  {
+    wait();
+  }
+
+
+  template <int dim, typename Number>
+  void PointQuantities<dim, Number>::wait()
+  {
+    if (write_task_.valid())
+      write_task_.get();
   }
 
 
@@ -66,6 +105,13 @@ namespace ryujin
     std::cout << "PointQuantities<dim, Number>::prepare()" << std::endl;
 #endif
 
+    /* The pending output task still refers to the old manifolds: */
+    wait();
+
+    using Field = typename DerivedQuantities<dim, Number>::Field;
+    derived_quantities_->request(Field::velocity);
+    derived_quantities_->request(Field::pressure);
+
     /* Initialize matrix free context: */
 
     typename MatrixFree<dim, Number>::AdditionalData additional_data;
@@ -86,17 +132,10 @@ namespace ryujin
     const auto &scalar_partitioner =
         matrix_free_.get_dof_info(0).vector_partitioner;
 
-    velocity_.reinit(dim);
-    vorticity_.reinit(dim == 2 ? 1 : dim);
-    boundary_stress_.reinit(dim);
-    for (unsigned int i = 0; i < dim; ++i) {
-      velocity_.block(i).reinit(scalar_partitioner);
-      if constexpr (dim == 3)
-        vorticity_.block(i).reinit(scalar_partitioner);
-      boundary_stress_.block(i).reinit(scalar_partitioner);
-    }
-    if constexpr (dim == 2)
-      vorticity_.block(0).reinit(scalar_partitioner);
+    if (release_scratch_storage_)
+      release_scratch_storage();
+    else
+      allocate_scratch_storage();
 
     lumped_boundary_mass_.reinit(scalar_partitioner);
 
@@ -133,88 +172,176 @@ namespace ryujin
       lumped_boundary_mass_.compress(VectorOperation::add);
     }
 
-    /* Create interior maps: */
+    /* Select the points of all interior manifolds: */
 
     const unsigned int n_owned = offline_data_->n_locally_owned();
+    const auto &affine_constraints = offline_data_->affine_constraints();
+    const auto &lumped_mass_matrix = offline_data_->lumped_mass_matrix();
 
-    interior_maps_.clear();
-    std::transform(
-        interior_manifolds_.begin(),
-        interior_manifolds_.end(),
-        std::back_inserter(interior_maps_),
-        [this, n_owned](auto it) {
-          const auto &[name, expression] = it;
-          FunctionParser<dim> level_set_function(expression);
+    const auto format = [](const auto &... columns) {
+      std::ostringstream stream;
+      stream << std::scientific << std::setprecision(14);
+      ((stream << columns << "\t"), ...);
+      return stream.str();
+    };
 
-          std::map<types::global_dof_index, Point<dim>> map;
+    interior_points_.resize(interior_manifolds_.size());
+    for (unsigned int m = 0; m < interior_manifolds_.size(); ++m) {
+      const auto &[name, expression] = interior_manifolds_[m];
+      FunctionParser<dim> level_set_function(expression);
 
-          const auto &dof_handler = offline_data_->dof_handler();
-          const auto &scalar_partitioner = offline_data_->scalar_partitioner();
+      std::map<unsigned int, Point<dim>> map;
 
-          for (auto &cell : dof_handler.active_cell_iterators()) {
+      const auto &dof_handler = offline_data_->dof_handler();
+      const auto &scalar_partitioner = offline_data_->scalar_partitioner();
 
-            /* skip non-local cells */
-            if (!cell->is_locally_owned())
-              continue;
+      for (auto &cell : dof_handler.active_cell_iterators()) {
 
-            for (auto v : GeometryInfo<dim>::vertex_indices()) {
+        /* skip non-local cells */
+        if (!cell->is_locally_owned())
+          continue;
 
-              const auto position = cell->vertex(v);
+        for (auto v : GeometryInfo<dim>::vertex_indices()) {
 
-              /* only record points sufficiently close to the level set */
-              if (std::abs(level_set_function.value(position)) > 1.e-12)
-                continue;
+          const auto position = cell->vertex(v);
 
-              const auto global_index = cell->vertex_dof_index(v, 0);
-              const auto index =
-                  scalar_partitioner->global_to_local(global_index);
+          /* only record points sufficiently close to the level set */
+          if (std::abs(level_set_function.value(position)) > 1.e-12)
+            continue;
 
-              /* skip nonlocal */
-              if (index >= n_owned)
-                continue;
+          const auto global_index = cell->vertex_dof_index(v, 0);
+          const auto index = scalar_partitioner->global_to_local(global_index);
 
-              /* skip constrained */
-              if (offline_data_->affine_constraints().is_constrained(
-                      offline_data_->scalar_partitioner()->local_to_global(
-                          index)))
-                continue;
+          /* skip nonlocal */
+          if (index >= n_owned)
+            continue;
 
-              map.insert({index, position});
-            }
-          }
-          return std::make_tuple(name, map);
-        });
+          /* skip constrained */
+          if (affine_constraints.is_constrained(global_index))
+            continue;
 
-    /* Create boundary maps: */
-
-    boundary_maps_.clear();
-    std::transform(
-        boundary_manifolds_.begin(),
-        boundary_manifolds_.end(),
-        std::back_inserter(boundary_maps_),
-        [this, n_owned](auto it) {
-          const auto &[name, expression] = it;
-          FunctionParser<dim> level_set_function(expression);
-
-          std::multimap<types::global_dof_index, boundary_description> map;
-
-          for (const auto &entry : offline_data_->boundary_map()) {
-            /* skip nonlocal */
-            if (entry.first >= n_owned)
-              continue;
-
-            /* skip constrained */
-            if (offline_data_->affine_constraints().is_constrained(
-                    offline_data_->scalar_partitioner()->local_to_global(
-                        entry.first)))
-              continue;
-
-            const auto position = std::get<2>(entry.second);
-            if (std::abs(level_set_function.value(position)) < 1.e-12)
-              map.insert(entry);
-          }
-          return std::make_tuple(name, map);
-        });
+          map.insert({index, position});
+        }
+      }
+
+      std::vector<std::tuple<unsigned int, Point<dim>, Number, std::string>>
+          points;
+      for (const auto &[index, position] : map) {
+        const auto m_i = lumped_mass_matrix.local_element(index);
+        points.emplace_back(
+            index, position, Number(1.) / m_i, format(position, m_i));
+      }
+
+      interior_points_[m].name = name;
+      setup_manifold(interior_points_[m], points);
+    }
+
+    /* Select the points of all boundary manifolds: */
+
+    boundary_points_.resize(boundary_manifolds_.size());
+    for (unsigned int m = 0; m < boundary_manifolds_.size(); ++m) {
+      const auto &[name, expression] = boundary_manifolds_[m];
+      FunctionParser<dim> level_set_function(expression);
+
+      std::vector<std::tuple<unsigned int, Point<dim>, Number, std::string>>
+          points;
+
+      for (const auto &entry : offline_data_->boundary_map()) {
+        /* skip nonlocal */
+        const auto index = entry.first;
+        if (index >= n_owned)
+          continue;
+
+        /* skip constrained */
+        if (affine_constraints.is_constrained(
+                offline_data_->scalar_partitioner()->local_to_global(index)))
+          continue;
+
+        const auto &[normal, id, position] = entry.second;
+        if (std::abs(level_set_function.value(position)) >= 1.e-12)
+          continue;
+
+        const auto m_i = lumped_boundary_mass_.local_element(index);
+        points.emplace_back(index,
+                            position,
+                            Number(1.) / m_i,
+                            format(position, m_i, normal));
+      }
+
+      boundary_points_[m].name = name;
+      setup_manifold(boundary_points_[m], points);
+    }
+  }
+
+
+  template <int dim, typename Number>
+  void PointQuantities<dim, Number>::setup_manifold(
+      Manifold &manifold,
+      std::vector<std::tuple<unsigned int, Point<dim>, Number, std::string>>
+          &points) const
+  {
+    constexpr auto simd_length = VectorizedArray<Number>::size();
+
+    /*
+     * Sort by local index (the boundary map is a multimap that can
+     * contain the same index with different normals):
+     */
+    std::stable_sort(points.begin(),
+                     points.end(),
+                     [](const auto &left, const auto &right) {
+                       return std::get<0>(left) < std::get<0>(right);
+                     });
+
+    const unsigned int n_points = points.size();
+    const unsigned int n_padded =
+        (n_points + simd_length - 1) / simd_length * simd_length;
+
+    manifold.n_points = n_points;
+    manifold.indices.resize(n_padded);
+    manifold.inverse_masses.resize(n_padded);
+
+    std::vector<std::pair<Point<dim>, std::string>> static_data;
+    for (unsigned int k = 0; k < n_padded; ++k) {
+      const auto &[index, position, inverse_mass, prefix] =
+          points[std::min(k, n_points - 1)];
+      manifold.indices[k] = index;
+      manifold.inverse_masses[k] = inverse_mass;
+      if (k < n_points)
+        static_data.emplace_back(position, prefix);
+    }
+
+    /*
+     * Gather the static part of the output on rank 0 and compute the
+     * permutation that sorts all points by position:
+     */
+
+    const auto received =
+        Utilities::MPI::gather(mpi_communicator_, static_data);
+
+    manifold.n_points_per_rank.clear();
+    manifold.permutation.clear();
+    manifold.prefixes.clear();
+
+    if (Utilities::MPI::this_mpi_process(mpi_communicator_) == 0) {
+      std::vector<std::pair<Point<dim>, std::string>> all_static_data;
+      for (auto &&it : received) {
+        manifold.n_points_per_rank.push_back(it.size());
+        std::move(std::begin(it),
+                  std::end(it),
+                  std::back_inserter(all_static_data));
+      }
+
+      manifold.permutation.resize(all_static_data.size());
+      std::iota(manifold.permutation.begin(), manifold.permutation.end(), 0);
+      std::sort(manifold.permutation.begin(),
+                manifold.permutation.end(),
+                [&](const auto left, const auto right) {
+                  return all_static_data[left] < all_static_data[right];
+                });
+
+      for (const auto k : manifold.permutation)
+        manifold.prefixes.push_back(std::move(all_static_data[k].second));
+    }
   }
 
 
@@ -228,47 +355,275 @@ namespace ryujin
     std::cout << "PointQuantities<dim, Number>::compute()" << std::endl;
 #endif
 
-    using VA = VectorizedArray<Number>;
-    constexpr auto simd_length = VA::size();
+    wait();
+
     const unsigned int n_owned = offline_data_->n_locally_owned();
-    const unsigned int size_regular = n_owned / simd_length * simd_length;
+
+    if (release_scratch_storage_)
+      allocate_scratch_storage();
 
     /*
      * Step 0: Copy velocity:
      */
 
+    using Field = typename DerivedQuantities<dim, Number>::Field;
+    derived_quantities_->compute(U, t);
+
+    const auto &derived_velocity = derived_quantities_->velocity();
+    const auto &pressure = derived_quantities_->field(Field::pressure);
+
     {
       RYUJIN_PARALLEL_REGION_BEGIN
       RYUJIN_OMP_FOR
-      for (unsigned int i = 0; i < size_regular; i += simd_length) {
-        const auto U_i = U.get_vectorized_tensor(i);
-        const auto rho_i = problem_description_->density(U_i);
-        const auto M_i = problem_description_->momentum(U_i);
+      for (unsigned int i = 0; i < n_owned; ++i) {
+        for (unsigned int d = 0; d < dim; ++d)
+          velocity_.block(d).local_element(i) =
+              derived_velocity[d].local_element(i);
+      }
+      RYUJIN_PARALLEL_REGION_END
+
+      velocity_.update_ghost_values();
+    }
 
-        for (unsigned int d = 0; d < dim; ++d) {
-          simd_store(velocity_.block(d), M_i[d] / rho_i, i);
+    compute_vorticity_and_boundary_stress();
+
+    /*
+     * Step 3: Evaluate all interior points of interest and output to log
+     * file:
+     */
+
+    constexpr auto simd_length = VectorizedArray<Number>::size();
+    constexpr unsigned int n_curl = dim == 2 ? 1 : dim;
+    const auto file_name = [&](const auto &manifold) {
+      return name + "-" + manifold.name + "-" +
+             Utilities::to_string(cycle, 6) + ".log";
+    };
+
+    std::ostringstream header;
+    header << std::scientific << std::setprecision(14);
+    header << "# state and pressure at time t = " << t << std::endl;
+
+    for (const auto &manifold : interior_points_) {
+      constexpr unsigned int n_values = problem_dimension + 1 + n_curl;
+      std::vector<double> values(n_values * manifold.n_points);
+
+      for (unsigned int k = 0; k < manifold.n_points; k += simd_length) {
+        const unsigned int *js = manifold.indices.data() + k;
+
+        const auto U_j = U.get_vectorized_tensor(js);
+        const auto P_j = simd_load(pressure, js);
+        VectorizedArray<Number> m_j_inverse;
+        m_j_inverse.load(manifold.inverse_masses.data() + k);
+
+        std::array<VectorizedArray<Number>, n_curl> V_j;
+        for (unsigned int d = 0; d < n_curl; ++d)
+          V_j[d] = simd_load(vorticity_.block(d), js) * m_j_inverse;
+
+        const unsigned int n_lanes =
+            std::min<unsigned int>(simd_length, manifold.n_points - k);
+        for (unsigned int l = 0; l < n_lanes; ++l) {
+          double *row = values.data() + (k + l) * n_values;
+          for (unsigned int c = 0; c < problem_dimension; ++c)
+            *row++ = U_j[c][l];
+          *row++ = P_j[l];
+          for (unsigned int d = 0; d < n_curl; ++d)
+            *row++ = V_j[d][l];
         }
       }
-      RYUJIN_PARALLEL_REGION_END
 
-      for (unsigned int i = size_regular; i < n_owned; ++i) {
-        const auto U_i = U.get_tensor(i);
-        const auto rho_i = problem_description_->density(U_i);
-        const auto M_i = problem_description_->momentum(U_i);
+      write_manifold(manifold,
+                     values,
+                     {problem_dimension, problem_dimension + 1, n_values},
+                     file_name(manifold),
+                     header.str() + "# position\tlumped mass\tstate "
+                                    "(rho,M,E)\tpressure\tvorticity\n");
+    } /* interior_points_ */
+
+    /*
+     * Step 4: Evaluate all boundary points of interest and output to log
+     * file:
+     */
 
-        for (unsigned int d = 0; d < dim; ++d) {
-          velocity_.block(d).local_element(i) = M_i[d] / rho_i;
+    for (const auto &manifold : boundary_points_) {
+      constexpr unsigned int n_values = problem_dimension + 1 + dim;
+      std::vector<double> values(n_values * manifold.n_points);
+
+      for (unsigned int k = 0; k < manifold.n_points; k += simd_length) {
+        const unsigned int *js = manifold.indices.data() + k;
+
+        const auto U_j = U.get_vectorized_tensor(js);
+        const auto P_j = simd_load(pressure, js);
+        VectorizedArray<Number> m_j_inverse;
+        m_j_inverse.load(manifold.inverse_masses.data() + k);
+
+        std::array<VectorizedArray<Number>, dim> Sn_j;
+        for (unsigned int d = 0; d < dim; ++d)
+          Sn_j[d] = simd_load(boundary_stress_.block(d), js) * m_j_inverse;
+
+        const unsigned int n_lanes =
+            std::min<unsigned int>(simd_length, manifold.n_points - k);
+        for (unsigned int l = 0; l < n_lanes; ++l) {
+          double *row = values.data() + (k + l) * n_values;
+          for (unsigned int c = 0; c < problem_dimension; ++c)
+            *row++ = U_j[c][l];
+          *row++ = P_j[l];
+          for (unsigned int d = 0; d < dim; ++d)
+            *row++ = Sn_j[d][l];
         }
       }
 
+      write_manifold(manifold,
+                     values,
+                     {problem_dimension, problem_dimension + 1, n_values},
+                     file_name(manifold),
+                     header.str() + "# position\tlumped boundary mass\t"
+                                    "normal\tstate (rho,M,E)\tpressure\t"
+                                    "stress\n");
+    } /* boundary_points_ */
+
+    launch_writes();
+
+    if (release_scratch_storage_)
+      release_scratch_storage();
+  }
+
+
+  template <int dim, typename Number>
+  void PointQuantities<dim, Number>::compute_averages(
+      const TimeAveragedStatistics<dim, Number> &time_averaged_statistics,
+      const Number t,
+      std::string name)
+  {
+#ifdef DEBUG_OUTPUT
+    std::cout << "PointQuantities<dim, Number>::compute_averages()"
+              << std::endl;
+#endif
+
+    const unsigned int n_samples = time_averaged_statistics.n_samples();
+    if (n_samples == 0)
+      return;
+
+    wait();
+
+    const unsigned int n_owned = offline_data_->n_locally_owned();
+    const auto &statistics = time_averaged_statistics.statistics();
+
+    constexpr unsigned int n_fields =
+        TimeAveragedStatistics<dim, Number>::n_fields;
+    constexpr unsigned int p_index = problem_dimension;
+    constexpr unsigned int v_index = problem_dimension + 1;
+
+    if (release_scratch_storage_)
+      allocate_scratch_storage();
+
+    /*
+     * The vorticity and the boundary stress are linear in the velocity,
+     * so evaluating them for the mean velocity results in the mean
+     * vorticity and the mean boundary stress:
+     */
+
+    {
+      RYUJIN_PARALLEL_REGION_BEGIN
+      RYUJIN_OMP_FOR
+      for (unsigned int i = 0; i < n_owned; ++i) {
+        const auto S_i = statistics.get_tensor(i);
+        for (unsigned int d = 0; d < dim; ++d)
+          velocity_.block(d).local_element(i) = S_i[v_index + d];
+      }
+      RYUJIN_PARALLEL_REGION_END
+
       velocity_.update_ghost_values();
     }
 
+    compute_vorticity_and_boundary_stress();
+
+    /*
+     * Evaluate all points of interest: Every line holds the mean state,
+     * the mean and the root mean square of the fluctuations of the
+     * pressure, and the mean vorticity (or boundary stress):
+     */
+
+    using VA = VectorizedArray<Number>;
+    constexpr auto simd_length = VA::size();
+    const VA n_inverse = VA(Number(1.) / Number(n_samples));
+
+    std::ostringstream header;
+    header << std::scientific << std::setprecision(14);
+    header << "# time-averaged state and pressure over " << n_samples
+           << " samples in [" << time_averaged_statistics.t_start() << ", "
+           << t << "]" << std::endl;
+
+    const auto evaluate = [&](const Manifold &manifold,
+                              const auto &tail,
+                              const unsigned int n_tail,
+                              const std::string &description) {
+      const unsigned int n_values = problem_dimension + 2 + n_tail;
+      std::vector<double> values(n_values * manifold.n_points);
+
+      for (unsigned int k = 0; k < manifold.n_points; k += simd_length) {
+        const unsigned int *js = manifold.indices.data() + k;
+
+        const auto S_j = statistics.get_vectorized_tensor(js);
+        const auto p_rms_j =
+            std::sqrt(std::max(S_j[n_fields + p_index] * n_inverse, VA(0.)));
+        VA m_j_inverse;
+        m_j_inverse.load(manifold.inverse_masses.data() + k);
+
+        const unsigned int n_lanes =
+            std::min<unsigned int>(simd_length, manifold.n_points - k);
+        for (unsigned int l = 0; l < n_lanes; ++l) {
+          double *row = values.data() + (k + l) * n_values;
+          for (unsigned int c = 0; c < problem_dimension; ++c)
+            *row++ = S_j[c][l];
+          *row++ = S_j[p_index][l];
+          *row++ = p_rms_j[l];
+        }
+
+        for (unsigned int d = 0; d < n_tail; ++d) {
+          const auto T_j = simd_load(tail.block(d), js) * m_j_inverse;
+          for (unsigned int l = 0; l < n_lanes; ++l)
+            values[(k + l) * n_values + problem_dimension + 2 + d] = T_j[l];
+        }
+      }
+
+      write_manifold(manifold,
+                     values,
+                     {problem_dimension, problem_dimension + 2, n_values},
+                     name + "-" + manifold.name + "-averages.log",
+                     header.str() + description);
+    };
+
+    for (const auto &manifold : interior_points_)
+      evaluate(manifold,
+               vorticity_,
+               dim == 2 ? 1 : dim,
+               "# position\tlumped mass\tmean state (rho,M,E)\tmean and "
+               "rms pressure\tmean vorticity\n");
+
+    for (const auto &manifold : boundary_points_)
+      evaluate(manifold,
+               boundary_stress_,
+               dim,
+               "# position\tlumped boundary mass\tnormal\tmean state "
+               "(rho,M,E)\tmean and rms pressure\tmean stress\n");
+
+    launch_writes();
+
+    if (release_scratch_storage_)
+      release_scratch_storage();
+  }
+
+
+  template <int dim, typename Number>
+  void PointQuantities<dim, Number>::compute_vorticity_and_boundary_stress()
+  {
+    const unsigned int n_owned = offline_data_->n_locally_owned();
+
     /*
      * Step 1: Compute vorticity:
      */
 
-    if (interior_maps_.size() != 0) {
+    if (interior_points_.size() != 0) {
       /*
        * Nota bene: This computes "m_i V_i", i.e., the result has to be
        * divided by the lumped mass matrix (or multiplied with the inverse
@@ -344,7 +699,7 @@ namespace ryujin
      * Step 2: Boundary stress:
      */
 
-    if (boundary_maps_.size() != 0) {
+    if (boundary_points_.size() != 0) {
       /*
        * Nota bene: This computes "m_i Sn_i", i.e., the result has to be
        * divided by the lumped mass matrix (or multiplied with the inverse
@@ -399,138 +754,165 @@ namespace ryujin
 
       boundary_stress_.compress(VectorOperation::add);
     }
+  }
 
-    /*
-     * Step 3: Collect all interior points of interest and output to log file:
-     */
-
-    for (const auto &it : interior_maps_) {
-      const auto &[description, interior_map] = it;
-
-      using entry = std::tuple<Point<dim>, // position
-                               Number,     // lumped mass
-                               rank1_type, // state
-                               Number,     // pressure
-                               curl_type>; // vorticity
-
-      std::vector<entry> entries;
-      for (const auto &it : interior_map) {
-
-        /* Only record locally owned degrees of freedom */
-        const auto i = it.first;
-        if (i >= n_owned)
-          continue;
-
-        const auto &position = it.second;
-
-        const auto U_i = U.get_tensor(i);
-        const auto &lumped_mass_matrix = offline_data_->lumped_mass_matrix();
-        const auto m_i = lumped_mass_matrix.local_element(i);
-        const auto P_i = problem_description_->pressure(U_i);
-
-        curl_type V_i;
-        for (unsigned int d = 0; d < (dim == 2 ? 1 : dim); ++d) {
-          V_i[d] = vorticity_.block(d).local_element(i);
-        }
-
-        entries.push_back({position, m_i, U_i, P_i, V_i / m_i});
-      }
-
-      std::vector<entry> all_entries;
-      {
-        const auto received =
-            Utilities::MPI::gather(mpi_communicator_, entries);
-
-        for (auto &&it : received)
-          std::move(
-              std::begin(it), std::end(it), std::back_inserter(all_entries));
 
-        std::sort(all_entries.begin(), all_entries.end());
+  template <int dim, typename Number>
+  void PointQuantities<dim, Number>::write_manifold(
+      const Manifold &manifold,
+      const std::vector<double> &values,
+      const std::array<unsigned int, 3> &ends,
+      const std::string &file_name,
+      const std::string &header)
+  {
+    const unsigned int n_values = ends[2];
+    const bool is_root =
+        Utilities::MPI::this_mpi_process(mpi_communicator_) == 0;
+
+    /* Gather all time dependent values on rank 0: */
+
+    std::vector<int> counts;
+    std::vector<int> displacements;
+    std::vector<double> all_values;
+    if (is_root) {
+      int offset = 0;
+      for (const auto n_points : manifold.n_points_per_rank) {
+        counts.push_back(n_points * n_values);
+        displacements.push_back(offset);
+        offset += n_points * n_values;
       }
+      all_values.resize(offset);
+    }
 
-      if (Utilities::MPI::this_mpi_process(mpi_communicator_) == 0) {
-        std::ofstream output(name + "-" + description + "-" +
-                             Utilities::to_string(cycle, 6) + ".log");
+    const int ierr = MPI_Gatherv(values.data(),
+                                 values.size(),
+                                 MPI_DOUBLE,
+                                 all_values.data(),
+                                 counts.data(),
+                                 displacements.data(),
+                                 MPI_DOUBLE,
+                                 0,
+                                 mpi_communicator_);
+    AssertThrowMPI(ierr);
 
-        output << std::scientific << std::setprecision(14);
-        output << "# state and pressure at time t = " << t << std::endl;
-        output << "# position\tlumped mass\tstate (rho,M,E)"
-               << "\tpressure\tvorticity" << std::endl;
-
-        for (const auto &entry : all_entries) {
-          const auto &[position, m_i, U_i, P_i, V_i] = entry;
-          output << position << "\t" << m_i << "\t"   //
-                 << U_i << "\t" << P_i << "\t" << V_i //
-                 << std::endl;
-        }
-      }
-    } /* interior_maps_ */
+    if (!is_root)
+      return;
 
     /*
-     * Step 4: Collect all boundary points of interest and output to log file:
+     * Format the complete file into a single buffer and write it at
+     * once. The state, the pressure, and the vorticity (or stress) are
+     * separated by tabs, the components of a quantity by spaces. This
+     * does not call into MPI and only reads from @p manifold, which stays
+     * valid until the next call to prepare():
      */
 
-    for (const auto &it : boundary_maps_) {
-      const auto &[description, boundary_map] = it;
-
-      using entry = std::tuple<Point<dim>,              // position
-                               Number,                  // lumped boundary mass
-                               Tensor<1, dim, Number>,  // normal
-                               rank1_type,              // state
-                               Number,                  // pressure
-                               Tensor<1, dim, Number>>; // stress
-
-      std::vector<entry> entries;
-      for (const auto &it : boundary_map) {
+    pending_writes_.emplace_back([&manifold,
+                                  all_values = std::move(all_values),
+                                  ends,
+                                  file_name,
+                                  header]() {
+      const unsigned int n_values = ends[2];
+
+      std::ostringstream buffer;
+      buffer << std::scientific << std::setprecision(14);
+      buffer << header;
+
+      for (unsigned int k = 0; k < manifold.permutation.size(); ++k) {
+        const double *row =
+            all_values.data() + manifold.permutation[k] * n_values;
+        buffer << manifold.prefixes[k];
+        for (unsigned int c = 0, field = 0; c < n_values; ++c) {
+          buffer << row[c];
+          if (c + 1 == ends[field]) {
+            buffer << (c + 1 == n_values ? "\n" : "\t");
+            ++field;
+          } else {
+            buffer << " ";
+          }
+        }
+      }
 
-        /* Only record locally owned degrees of freedom */
-        const auto i = it.first;
-        if (i >= n_owned)
-          continue;
+      const auto string = buffer.str();
+      std::ofstream output(file_name);
+      output.write(string.data(), string.size());
+    });
+  }
 
-        const auto &[normal, id, position] = it.second;
 
-        const auto U_i = U.get_tensor(i);
-        const auto m_i = lumped_boundary_mass_.local_element(i);
-        const auto P_i = problem_description_->pressure(U_i);
+  template <int dim, typename Number>
+  void PointQuantities<dim, Number>::launch_writes()
+  {
+    if (pending_writes_.empty())
+      return;
+
+    if (!asynchronous_output_) {
+      for (const auto &write : pending_writes_)
+        write();
+      pending_writes_.clear();
+      return;
+    }
 
-        Tensor<1, dim, Number> Sn_i;
-        for (unsigned int d = 0; d < dim; ++d) {
-          Sn_i[d] = boundary_stress_.block(d).local_element(i);
-        }
+    write_task_ = std::async(
+        std::launch::async, [writes = std::move(pending_writes_)]() {
+          for (const auto &write : writes)
+            write();
+        });
+    pending_writes_.clear();
+  }
 
-        entries.push_back({position, m_i, normal, U_i, P_i, Sn_i / m_i});
-      }
 
-      std::vector<entry> all_entries;
-      {
-        const auto received =
-            Utilities::MPI::gather(mpi_communicator_, entries);
+  template <int dim, typename Number>
+  std::vector<std::pair<std::string, std::size_t>>
+  PointQuantities<dim, Number>::memory_consumption() const
+  {
+    std::vector<std::pair<std::string, std::size_t>> result;
+
+    result.emplace_back("matrix free", matrix_free_.memory_consumption());
+    result.emplace_back("velocity", velocity_.memory_consumption());
+    result.emplace_back("vorticity", vorticity_.memory_consumption());
+    result.emplace_back("boundary stress",
+                        boundary_stress_.memory_consumption());
+    result.emplace_back("lumped boundary mass",
+                        lumped_boundary_mass_.memory_consumption());
+
+    std::size_t points = 0;
+    for (const auto *manifolds : {&interior_points_, &boundary_points_})
+      for (const auto &manifold : *manifolds)
+        points += MemoryConsumption::memory_consumption(manifold.indices) +
+                  manifold.inverse_masses.memory_consumption() +
+                  MemoryConsumption::memory_consumption(manifold.prefixes);
+    result.emplace_back("points of interest", points);
+
+    return result;
+  }
 
-        for (auto &&it : received)
-          std::move(
-              std::begin(it), std::end(it), std::back_inserter(all_entries));
 
-        std::sort(all_entries.begin(), all_entries.end());
-      }
+  template <int dim, typename Number>
+  void PointQuantities<dim, Number>::allocate_scratch_storage()
+  {
+    const auto &scalar_partitioner =
+        matrix_free_.get_dof_info(0).vector_partitioner;
 
-      if (Utilities::MPI::this_mpi_process(mpi_communicator_) == 0) {
-        std::ofstream output(name + "-" + description + "-" +
-                             Utilities::to_string(cycle, 6) + ".log");
+    velocity_.reinit(dim);
+    vorticity_.reinit(dim == 2 ? 1 : dim);
+    boundary_stress_.reinit(dim);
+    for (unsigned int i = 0; i < dim; ++i) {
+      velocity_.block(i).reinit(scalar_partitioner);
+      if constexpr (dim == 3)
+        vorticity_.block(i).reinit(scalar_partitioner);
+      boundary_stress_.block(i).reinit(scalar_partitioner);
+    }
+    if constexpr (dim == 2)
+      vorticity_.block(0).reinit(scalar_partitioner);
+  }
 
-        output << std::scientific << std::setprecision(14);
-        output << "# state and pressure at time t = " << t << std::endl;
-        output << "# position\tlumped boundary mass\tnormal\t"
-               << "state (rho,M,E)\tpressure\tstress" << std::endl;
 
-        for (const auto &entry : all_entries) {
-          const auto &[position, m_i, normal, U_i, P_i, Sn_i] = entry;
-          output << position << "\t" << m_i << "\t" << normal << "\t" //
-                 << U_i << "\t" << P_i << "\t" << Sn_i                //
-                 << std::endl;
-        }
-      }
-    } /* boundary_maps_ */
+  template <int dim, typename Number>
+  void PointQuantities<dim, Number>::release_scratch_storage()
+  {
+    velocity_.reinit(0);
+    vorticity_.reinit(0);
+    boundary_stress_.reinit(0);
   }
 
 } /* namespace ryujin */
@@ -8,6 +8,7 @@
 #include <compile_time_options.h>
 
 #include "convenience_macros.h"
+#include "equation_of_state_table.h"
 #include "simd.h"
 
 #include <deal.II/base/parameter_acceptor.h>
@@ -76,7 +77,39 @@ namespace ryujin
        *   \log\left(e^{1/(\gamma-1)}\,\left(\rho^{-1}-b\right)\right).
        * \f}
        */
-      van_der_waals
+      van_der_waals,
+      /**
+       * Tabulated equation of state: The pressure, speed of sound, and
+       * (scaled) specific entropy are interpolated from an
+       * EquationOfStateTable in density and specific internal energy
+       * that is read in from the file given by the "equation of state
+       * table" parameter.
+       *
+       * @note The approximate Riemann solver, the limiter, and the
+       * entropy functionals still use the (effective) ratio of specific
+       * heats @ref gamma_ of a polytropic gas.
+       */
+      tabulated
+    };
+
+
+    /**
+     * Ratios of specific heats for which specialized code paths with
+     * compile-time exponents exist.
+     */
+    enum class GammaSpecialization {
+      /**
+       * Generic gamma, all powers are computed with ryujin::pow().
+       */
+      none,
+      /**
+       * gamma = 7/5 (diatomic gas, e.g., air).
+       */
+      seven_fifths,
+      /**
+       * gamma = 5/3 (monatomic gas).
+       */
+      five_thirds
     };
 
 
@@ -283,6 +316,10 @@ namespace ryujin
      *   \textbf v(E+p)
      * \end{pmatrix},
      * \f]
+     *
+     * If acoustic_splitting() is set the pressure terms are dropped and
+     * the function returns the pressureless transport flux
+     * \f$\textbf v\otimes U\f$ of the explicit part of the IMEX scheme.
      */
     template <int problem_dim, typename Number>
     rank2_type<problem_dim - 2, Number>
@@ -328,6 +365,10 @@ namespace ryujin
     double cv_inverse_kappa_;
     ACCESSOR_READ_ONLY(cv_inverse_kappa)
 
+    std::string equation_of_state_table_name_;
+    EquationOfStateTable equation_of_state_table_;
+    ACCESSOR_READ_ONLY(equation_of_state_table)
+
     //@}
     /**
      * @name Precomputed scalar quantitites
@@ -336,6 +377,18 @@ namespace ryujin
     double gamma_inverse_;
     double gamma_plus_one_inverse_;
 
+    GammaSpecialization gamma_specialization_;
+    ACCESSOR_READ_ONLY(gamma_specialization)
+
+    /*
+     * Set for the "Euler IMEX" description: The explicit Euler update
+     * only treats the pressureless transport part of the flux and the
+     * acoustic part is solved implicitly, see
+     * DissipationModule::acoustic_step().
+     */
+    bool acoustic_splitting_;
+    ACCESSOR_READ_ONLY(acoustic_splitting)
+
     //@}
   };
 
@@ -426,6 +479,14 @@ namespace ryujin
     /* p = (gamma - 1) / (1 - b * rho) * (rho e) */
 
     using ScalarNumber = typename get_value_type<Number>::type;
+
+    if constexpr (equation_of_state_ == EquationOfState::tabulated) {
+      const Number rho = U[0];
+      const Number e = internal_energy(U) / rho;
+      return equation_of_state_table_.evaluate(
+          EquationOfStateTable::pressure, rho, e);
+    }
+
     return ScalarNumber(gamma_ - 1.) * internal_energy(U);
   }
 
@@ -438,6 +499,13 @@ namespace ryujin
 
     using ScalarNumber = typename get_value_type<Number>::type;
 
+    if constexpr (equation_of_state_ == EquationOfState::tabulated) {
+      const Number rho = U[0];
+      const Number e = internal_energy(U) / rho;
+      return equation_of_state_table_.evaluate(
+          EquationOfStateTable::speed_of_sound, rho, e);
+    }
+
     const Number rho_inverse = ScalarNumber(1.) / U[0];
     const Number p = pressure(U);
     return std::sqrt(gamma_ * p * rho_inverse);
@@ -452,6 +520,13 @@ namespace ryujin
 
     using ScalarNumber = typename get_value_type<Number>::type;
 
+    if constexpr (equation_of_state_ == EquationOfState::tabulated) {
+      const Number rho = U[0];
+      const Number e = internal_energy(U) / rho;
+      return equation_of_state_table_.evaluate(
+          EquationOfStateTable::specific_entropy, rho, e);
+    }
+
     const auto rho_inverse = ScalarNumber(1.) / U[0];
     return internal_energy(U) * ryujin::pow(rho_inverse, gamma_);
   }
@@ -471,6 +546,11 @@ namespace ryujin
     const Number E = U[dim + 1];
 
     const Number rho_rho_e = rho * E - ScalarNumber(0.5) * m.norm_square();
+
+    /* For gamma = 5/3 the exponent 1/(gamma+1) = 3/8 is a sqrt chain: */
+    if (gamma_specialization_ == GammaSpecialization::five_thirds)
+      return rational_power<3, 8>(rho_rho_e);
+
     return ryujin::pow(rho_rho_e, gamma_plus_one_inverse_);
   }
 
@@ -499,9 +579,12 @@ namespace ryujin
 
     const Number rho_rho_e = rho * E - ScalarNumber(0.5) * m.norm_square();
 
+    /* For gamma = 5/3 the exponent -gamma/(gamma+1) = -5/8: */
     const auto factor =
         gamma_plus_one_inverse_ *
-        ryujin::pow(rho_rho_e, -gamma_ * gamma_plus_one_inverse_);
+        (gamma_specialization_ == GammaSpecialization::five_thirds
+             ? rational_power<-5, 8>(rho_rho_e)
+             : ryujin::pow(rho_rho_e, -gamma_ * gamma_plus_one_inverse_));
 
     dealii::Tensor<1, problem_dim, Number> result;
 
@@ -666,7 +749,7 @@ namespace ryujin
         1. / (gamma_ * s) * ryujin::pow((gamma_ - 1.) / 4. * (R_2 - R_1), 2);
     rho_new = ryujin::pow(rho_new, 1. / (gamma_ - 1.));
 
-    const auto p_new = s * std::pow(rho_new, gamma_);
+    const auto p_new = s * ryujin::pow(rho_new, gamma_);
 
     rank1_type<dim, Number> U_new;
     U_new[0] = rho_new;
@@ -690,7 +773,7 @@ namespace ryujin
 
     const Number rho_inverse = ScalarNumber(1.) / U[0];
     const auto m = momentum(U);
-    const auto p = pressure(U);
+    const auto p = acoustic_splitting_ ? Number(0.) : pressure(U);
     const Number E = U[dim + 1];
 
     rank2_type<dim, Number> result;
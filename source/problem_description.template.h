@@ -7,6 +7,8 @@
 
 #include "problem_description.h"
 
+#include <cmath>
+
 namespace ryujin
 {
   using namespace dealii;
@@ -23,7 +25,8 @@ namespace ryujin
     add_parameter(
         "description",
         description_,
-        "Description - valid options are \"Euler\" and \"Navier Stokes\"");
+        "Description - valid options are \"Euler\", \"Euler IMEX\", and "
+        "\"Navier Stokes\"");
 
     gamma_ = 7. / 5.;
     add_parameter("gamma", gamma_, "Euler: Ratio of specific heats");
@@ -33,6 +36,21 @@ namespace ryujin
       add_parameter("b", b_, "Euler: Covolume");
     }
 
+    equation_of_state_table_name_ = "equation_of_state.table";
+    if constexpr (equation_of_state_ == EquationOfState::tabulated) {
+      add_parameter("equation of state table",
+                    equation_of_state_table_name_,
+                    "Euler: File containing the tabulated equation of state");
+
+      /*
+       * Only read in the table after the parameters have been parsed,
+       * not in the constructor:
+       */
+      ParameterAcceptor::parse_parameters_call_back.connect([this]() {
+        equation_of_state_table_.read(equation_of_state_table_name_);
+      });
+    }
+
     mu_ = 1.e-3;
     add_parameter("mu", mu_, "Navier Stokes: Shear viscosity");
 
@@ -55,7 +73,17 @@ namespace ryujin
     gamma_inverse_ = 1. / gamma_;
     gamma_plus_one_inverse_ = 1. / (gamma_ + 1.);
 
-    static_assert(equation_of_state_ == EquationOfState::ideal_gas,
+    acoustic_splitting_ = (description_ == "Euler IMEX");
+
+    /* Select a specialized code path for common gases: */
+    gamma_specialization_ = GammaSpecialization::none;
+    if (std::abs(gamma_ - 7. / 5.) < 1.e-12)
+      gamma_specialization_ = GammaSpecialization::seven_fifths;
+    else if (std::abs(gamma_ - 5. / 3.) < 1.e-12)
+      gamma_specialization_ = GammaSpecialization::five_thirds;
+
+    static_assert(equation_of_state_ == EquationOfState::ideal_gas ||
+                      equation_of_state_ == EquationOfState::tabulated,
                   "not implemented");
   }
 
@@ -77,6 +77,8 @@ namespace ryujin
         , gamma_minus_one_inverse(1. / (gamma - 1.))
         , gamma_minus_one_over_gamma_plus_one((gamma - 1.) / (gamma + 1.))
         , gamma_plus_one_inverse(1. / (gamma + 1.))
+        , n_solves_(0)
+        , n_iterations_(0)
     {
     }
 
@@ -105,6 +107,27 @@ namespace ryujin
             const rank1_type &U_j,
             const dealii::Tensor<1, dim, Number> &n_ij);
 
+    /**
+     * Return the number of calls to compute() since construction. For a
+     * vectorized number type every call solves a whole batch of
+     * Riemann problems.
+     */
+    unsigned long n_solves() const
+    {
+      return n_solves_;
+    }
+
+    /**
+     * Return the accumulated number of Newton iterations of all calls to
+     * compute(). The iteration of a batch stops as soon as the gap in
+     * lambda_max is within tolerance in every lane, so n_iterations() /
+     * n_solves() is the average number of iterations per batch.
+     */
+    unsigned long n_iterations() const
+    {
+      return n_iterations_;
+    }
+
     //@}
 
   protected:
@@ -258,6 +281,9 @@ namespace ryujin
     const ScalarNumber gamma_minus_one_over_gamma_plus_one;
     const ScalarNumber gamma_plus_one_inverse;
 
+    unsigned long n_solves_;
+    unsigned long n_iterations_;
+
     //@}
   };
 
@@ -12,6 +12,8 @@
 #include "riemann_solver.h"
 #include "simd.h"
 
+#include <limits>
+
 namespace ryujin
 {
   using namespace dealii;
@@ -301,9 +303,25 @@ namespace ryujin
     const Number denominator =
         a_i * ryujin::pow(p_i / p_j, -factor * gamma_inverse) + a_j;
 
-    const auto exponent = ScalarNumber(2.0) * gamma * gamma_minus_one_inverse;
+    /*
+     * The exponent 2 gamma / (gamma - 1) is an integer for the common
+     * cases gamma = 7/5 and gamma = 5/3. (A negative ratio indicates
+     * vacuum generation, for which we return p_star = 0.)
+     */
 
-    return p_j * ryujin::pow(numerator / denominator, exponent);
+    const Number ratio = numerator / denominator;
+
+    switch (problem_description.gamma_specialization()) {
+    case ProblemDescription::GammaSpecialization::seven_fifths:
+      return p_j * fixed_power<7>(positive_part(ratio));
+    case ProblemDescription::GammaSpecialization::five_thirds:
+      return p_j * fixed_power<5>(positive_part(ratio));
+    default:
+      break;
+    }
+
+    const auto exponent = ScalarNumber(2.0) * gamma * gamma_minus_one_inverse;
+    return p_j * ryujin::pow(ratio, exponent);
   }
 
 
@@ -385,6 +403,21 @@ namespace ryujin
           const std::array<Number, 4> &riemann_data_i,
           const std::array<Number, 4> &riemann_data_j)
   {
+    /*
+     * With acoustic splitting only the pressureless transport part of
+     * the flux is treated explicitly. All waves of this subsystem travel
+     * with the normal velocity. We add a tiny fraction of the speed of
+     * sound so that d_ij never vanishes in a stagnant region:
+     */
+    if (problem_description.acoustic_splitting()) {
+      ++n_solves_;
+      const Number lambda_max =
+          std::max(std::abs(riemann_data_i[1]), std::abs(riemann_data_j[1])) +
+          std::numeric_limits<ScalarNumber>::epsilon() *
+              (riemann_data_i[3] + riemann_data_j[3]);
+      return {lambda_max, std::max(riemann_data_i[2], riemann_data_j[2]), 0};
+    }
+
     /*
      * Step 1:
      *
@@ -438,6 +471,8 @@ namespace ryujin
         dealii::compare_and_apply_mask<dealii::SIMDComparison::less_than>(
             phi_p_max, Number(0.), p_star_tilde, std::min(p_max, p_star_tilde));
 
+    ++n_solves_;
+
     /* If we do no Newton iteration, cut it short: */
 
     if constexpr (newton_max_iter_ == 0) {
@@ -499,6 +534,8 @@ namespace ryujin
         dealii::ExcMessage("Invalid state in Riemann problem."));
 #endif
 
+    n_iterations_ += i;
+
     return {lambda_max, p_2, i};
   }
 
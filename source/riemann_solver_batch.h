@@ -0,0 +1,181 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include <compile_time_options.h>
+
+#include "riemann_solver.h"
+
+#include <deal.II/base/tensor.h>
+#include <deal.II/base/vectorization.h>
+
+#include <algorithm>
+#include <array>
+
+namespace ryujin
+{
+  /**
+   * A small helper class that gathers scalar Riemann problems into SIMD
+   * batches and solves them with a vectorized RiemannSolver.
+   *
+   * This class is used for the non-vectorized index range
+   * [n_locally_internal, n_locally_owned) where rows have varying length
+   * and (possibly) non-contiguous column indices. Intended use:
+   * ```
+   * riemann_solver_batch.reset(d_row.data());
+   * for (...)
+   *   riemann_solver_batch.push(U_i, U_j, c_ij, col_idx);
+   * riemann_solver_batch.flush();
+   * ```
+   * After the call to flush() the result buffer holds
+   * d_row[col_idx] = max( d_row[col_idx], |c_ij| * lambda_max(U_i, U_j) )
+   * for all pushed Riemann problems. Intermediate flushes happen
+   * automatically whenever a batch is complete.
+   *
+   * An incomplete batch is solved with masked lanes: Unused lanes are
+   * filled with a copy of lane 0 (so that we never evaluate the Riemann
+   * solver on invalid states) and their results are discarded.
+   *
+   * @ingroup EulerModule
+   */
+  template <int dim, typename Number = double>
+  class RiemannSolverBatch
+  {
+  public:
+    /**
+     * Shorthand typedef for the vectorized number type.
+     */
+    using VA = dealii::VectorizedArray<Number>;
+
+    /**
+     * The number of Riemann problems solved simultaneously.
+     */
+    static constexpr unsigned int simd_length = VA::size();
+
+    /**
+     * @copydoc ProblemDescription::problem_dimension
+     */
+    // clang-format off
+    static constexpr unsigned int problem_dimension = ProblemDescription::problem_dimension<dim>;
+    // clang-format on
+
+    /**
+     * @copydoc ProblemDescription::rank1_type
+     */
+    using rank1_type = ProblemDescription::rank1_type<dim, Number>;
+
+    /**
+     * Constructor taking a ProblemDescription instance as argument
+     */
+    RiemannSolverBatch(const ProblemDescription &problem_description)
+        : riemann_solver_simd_(problem_description)
+        , results_(nullptr)
+        , n_pending_(0)
+    {
+    }
+
+    /**
+     * Set the result buffer for subsequent calls to push(). The batch
+     * must be empty, i.e., flush() has to be called before switching
+     * the result buffer.
+     */
+    void reset(Number *results)
+    {
+      Assert(n_pending_ == 0, dealii::ExcInternalError());
+      results_ = results;
+    }
+
+    /**
+     * Enqueue the Riemann problem (U_i, U_j, c_ij / |c_ij|). The result
+     * |c_ij| * lambda_max is combined into results[slot] by taking the
+     * maximum.
+     */
+    void push(const rank1_type &U_i,
+              const rank1_type &U_j,
+              const dealii::Tensor<1, dim, Number> &c_ij,
+              const unsigned int slot)
+    {
+      const Number norm = c_ij.norm();
+      push(U_i, U_j, norm, c_ij / norm, slot);
+    }
+
+    /**
+     * Variant of above function taking a precomputed norm |c_ij| and
+     * normalized direction n_ij as argument.
+     */
+    void push(const rank1_type &U_i,
+              const rank1_type &U_j,
+              const Number norm,
+              const dealii::Tensor<1, dim, Number> &n_ij,
+              const unsigned int slot)
+    {
+      const unsigned int k = n_pending_;
+
+      for (unsigned int l = 0; l < problem_dimension; ++l) {
+        U_i_[l][k] = U_i[l];
+        U_j_[l][k] = U_j[l];
+      }
+      for (unsigned int l = 0; l < dim; ++l)
+        n_ij_[l][k] = n_ij[l];
+      norm_[k] = norm;
+      slots_[k] = slot;
+
+      if (++n_pending_ == simd_length)
+        flush();
+    }
+
+    /**
+     * Solve all pending Riemann problems and write the results.
+     */
+    void flush()
+    {
+      if (n_pending_ == 0)
+        return;
+
+      /* Mask unused lanes: */
+      for (unsigned int k = n_pending_; k < simd_length; ++k) {
+        for (unsigned int l = 0; l < problem_dimension; ++l) {
+          U_i_[l][k] = U_i_[l][0];
+          U_j_[l][k] = U_j_[l][0];
+        }
+        for (unsigned int l = 0; l < dim; ++l)
+          n_ij_[l][k] = n_ij_[l][0];
+        norm_[k] = norm_[0];
+      }
+
+      const auto [lambda_max, p_star, n_iterations] =
+          riemann_solver_simd_.compute(U_i_, U_j_, n_ij_);
+      const auto d = norm_ * lambda_max;
+
+      for (unsigned int k = 0; k < n_pending_; ++k)
+        results_[slots_[k]] = std::max(results_[slots_[k]], d[k]);
+
+      n_pending_ = 0;
+    }
+
+    /**
+     * Return the underlying vectorized Riemann solver, for example for
+     * querying RiemannSolver::n_solves() and RiemannSolver::n_iterations().
+     */
+    const RiemannSolver<dim, VA> &riemann_solver() const
+    {
+      return riemann_solver_simd_;
+    }
+
+  private:
+    RiemannSolver<dim, VA> riemann_solver_simd_;
+
+    Number *results_;
+    unsigned int n_pending_;
+
+    typename RiemannSolver<dim, VA>::rank1_type U_i_;
+    typename RiemannSolver<dim, VA>::rank1_type U_j_;
+    dealii::Tensor<1, dim, VA> n_ij_;
+    VA norm_;
+    std::array<unsigned int, simd_length> slots_;
+  };
+
+} /* namespace ryujin */
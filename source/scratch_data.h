@@ -8,6 +8,7 @@
 #include "discretization.h"
 
 #include <deal.II/fe/fe_values.h>
+#include <deal.II/grid/cell_id.h>
 #include <deal.II/lac/full_matrix.h>
 
 namespace ryujin
@@ -30,8 +31,8 @@ namespace ryujin
     AssemblyScratchData(const ryujin::Discretization<dim> &discretization)
         : discretization_(discretization)
         , fe_values_(discretization_.mapping(),
-                     discretization_.finite_element(),
-                     discretization_.quadrature(),
+                     discretization_.subcell_finite_element(),
+                     discretization_.subcell_quadrature(),
                      dealii::update_values | dealii::update_gradients |
                          dealii::update_quadrature_points |
                          dealii::update_JxW_values)
@@ -51,11 +52,13 @@ namespace ryujin
   {
   public:
     bool is_locally_owned_;
+    dealii::CellId cell_id_;
     std::vector<dealii::types::global_dof_index> local_dof_indices_;
     dealii::FullMatrix<Number> cell_mass_matrix_;
     std::array<dealii::FullMatrix<Number>, dim> cell_cij_matrix_;
     dealii::FullMatrix<Number> cell_betaij_matrix_;
     Number cell_measure_;
+    Number cell_volume_;
   };
 
 } // namespace ryujin
@@ -0,0 +1,209 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/partitioner.h>
+#include <deal.II/base/subscriptor.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace ryujin
+{
+  /**
+   * A pool of temporary vectors that is shared between all modules.
+   *
+   * Most temporaries of the individual modules (the stage vectors of the
+   * EulerModule, the right hand side and density of the
+   * DissipationModule, the postprocessed fields of VTUOutput, ...) are
+   * never in use at the same time. Instead of allocating them for the
+   * lifetime of the module, a module checks out a vector of given type
+   * and MPI partitioner for the duration of a function call. On
+   * destruction of the returned Pointer the vector is handed back to the
+   * pool and can be reused by the next checkout with the same type and
+   * partitioner. The storage held by the pool is thus given by the
+   * maximal set of simultaneously checked out vectors instead of the sum
+   * over all modules.
+   *
+   * The vector types must provide reinit(partitioner),
+   * get_partitioner(), zero_out_ghosts(), and memory_consumption(), i.e.,
+   * dealii::LinearAlgebra::distributed::Vector and MultiComponentVector
+   * are supported.
+   *
+   * @note The class is not thread safe.
+   *
+   * @ingroup Miscellaneous
+   */
+  class ScratchVectorPool : public dealii::Subscriptor
+  {
+  public:
+    /**
+     * A unique pointer to a checked out vector that returns the vector
+     * to the pool on destruction. This follows
+     * dealii::VectorMemory::Pointer.
+     */
+    template <typename VectorType>
+    using Pointer =
+        std::unique_ptr<VectorType, std::function<void(VectorType *)>>;
+
+    ScratchVectorPool()
+        : checked_out_bytes_(0)
+        , n_checked_out_(0)
+        , n_allocated_(0)
+    {
+    }
+
+    ~ScratchVectorPool()
+    {
+      AssertNothrow(n_checked_out_ == 0,
+                    dealii::ExcMessage("The scratch vector pool was "
+                                       "destroyed while vectors were "
+                                       "still checked out"));
+      clear();
+    }
+
+    /**
+     * Check out a vector of type @p VectorType with MPI partitioner @p
+     * partitioner. Ghost values are not set. A newly allocated vector is
+     * zero, the content of a reused vector is undefined.
+     */
+    template <typename VectorType>
+    Pointer<VectorType>
+    checkout(const std::shared_ptr<const dealii::Utilities::MPI::Partitioner>
+                 &partitioner)
+    {
+      const key_type key{partitioner.get(), typeid(VectorType)};
+
+      VectorType *vector = nullptr;
+      std::size_t bytes = 0;
+      std::size_t id = 0;
+      const auto it = free_buffers_.find(key);
+      if (it != free_buffers_.end()) {
+        vector = static_cast<VectorType *>(it->second.vector.release());
+        bytes = it->second.bytes;
+        id = it->second.id;
+        free_buffers_.erase(it);
+      } else {
+        vector = new VectorType();
+        vector->reinit(partitioner);
+        bytes = vector->memory_consumption();
+        id = n_allocated_++;
+      }
+
+      ++n_checked_out_;
+      checked_out_bytes_ += bytes;
+      return Pointer<VectorType>(vector, [this, bytes, id](VectorType *v) {
+        give_back(v, bytes, id);
+      });
+    }
+
+    /**
+     * Release all vectors that are currently not checked out. This has to
+     * be called whenever the MPI partitioners of the vectors in the pool
+     * become invalid, i.e., after the mesh has been changed.
+     *
+     * Vectors are destroyed in the order of their allocation. This order
+     * is identical on all MPI ranks (whereas the order of the keys is
+     * not), which is required if destroying a vector involves collective
+     * MPI communication (see SharedMemoryExchange).
+     */
+    void clear()
+    {
+      std::vector<Buffer> buffers;
+      for (auto &it : free_buffers_)
+        buffers.push_back(std::move(it.second));
+      free_buffers_.clear();
+
+      std::sort(buffers.begin(),
+                buffers.end(),
+                [](const auto &left, const auto &right) {
+                  return left.id < right.id;
+                });
+      for (auto &buffer : buffers)
+        buffer.vector.reset();
+    }
+
+    /**
+     * Return the memory consumption of all vectors allocated by the pool
+     * (checked out or not) as a list of (name, size) pairs.
+     */
+    std::vector<std::pair<std::string, std::size_t>>
+    memory_consumption() const
+    {
+      std::size_t free_bytes = 0;
+      for (const auto &it : free_buffers_)
+        free_bytes += it.second.bytes;
+
+      return {{"checked out vectors", checked_out_bytes_},
+              {"free vectors", free_bytes}};
+    }
+
+    /**
+     * Return the number of currently checked out vectors.
+     */
+    unsigned int n_checked_out() const
+    {
+      return n_checked_out_;
+    }
+
+  private:
+    /**
+     * The pool is keyed by the (address of the) MPI partitioner and the
+     * vector type. Every vector holds a shared pointer to its
+     * partitioner, so the address of a partitioner cannot be reused as
+     * long as a vector is stored in the pool.
+     */
+    using key_type =
+        std::pair<const dealii::Utilities::MPI::Partitioner *, std::type_index>;
+
+    /**
+     * A type erased, owned vector.
+     */
+    struct Buffer {
+      std::unique_ptr<void, void (*)(void *)> vector;
+      std::size_t bytes;
+      std::size_t id;
+    };
+
+    template <typename VectorType>
+    void give_back(VectorType *vector,
+                   const std::size_t bytes,
+                   const std::size_t id)
+    {
+      Assert(n_checked_out_ > 0, dealii::ExcInternalError());
+      --n_checked_out_;
+      checked_out_bytes_ -= bytes;
+
+      /*
+       * A checked out vector might have been swapped with another vector
+       * of the same layout, we thus key the vector by its current
+       * partitioner:
+       */
+      vector->zero_out_ghosts();
+      const key_type key{vector->get_partitioner().get(), typeid(VectorType)};
+
+      const auto deleter = [](void *pointer) {
+        delete static_cast<VectorType *>(pointer);
+      };
+      free_buffers_.emplace(key, Buffer{{vector, deleter}, bytes, id});
+    }
+
+    std::multimap<key_type, Buffer> free_buffers_;
+
+    std::size_t checked_out_bytes_;
+    unsigned int n_checked_out_;
+    std::size_t n_allocated_;
+  };
+
+} /* namespace ryujin */
@@ -0,0 +1,371 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include <deal.II/base/exceptions.h>
+#include <deal.II/base/mpi.h>
+
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ryujin
+{
+  /**
+   * A nonblocking point-to-point exchange of contiguous byte ranges that
+   * bypasses MPI messages for partners on the same shared-memory node.
+   *
+   * The send buffer of every rank is allocated in an MPI-3 shared memory
+   * window spanning all ranks of the node. After packing the send buffer
+   * (obtained with send_buffer()) a call to start() issues regular MPI
+   * messages for all off-node partners, whereas on-node partners are only
+   * notified with an empty "ready" message. In finish() every rank then
+   * copies the data of its on-node partners directly out of their send
+   * buffers into its receive buffer and acknowledges with an empty
+   * "done" message. The acknowledgements are collected by the next call
+   * to send_buffer() before the send buffer is overwritten.
+   *
+   * The payload of on-node exchanges is thus copied exactly once, and no
+   * MPI rendezvous protocol (and no intermediate MPI buffer) is involved.
+   *
+   * All messages are sent over a duplicated communicator, so the class
+   * does not need (and ignores) communication channels.
+   *
+   * @note The constructor and the destructor are collective over all MPI
+   * ranks of @p mpi_communicator and have to be called in the same order
+   * on all ranks.
+   *
+   * @ingroup Miscellaneous
+   */
+  class SharedMemoryExchange
+  {
+  public:
+    /**
+     * A list of (MPI rank, size in bytes) pairs. The byte ranges of all
+     * partners are stored consecutively in the send (and receive)
+     * buffer.
+     */
+    using targets_type = std::vector<std::pair<unsigned int, std::size_t>>;
+
+    /**
+     * Constructor.
+     */
+    SharedMemoryExchange(const targets_type &send_targets,
+                         const targets_type &receive_targets,
+                         const MPI_Comm &mpi_communicator);
+
+    SharedMemoryExchange(const SharedMemoryExchange &) = delete;
+    SharedMemoryExchange &operator=(const SharedMemoryExchange &) = delete;
+
+    /**
+     * Destructor.
+     */
+    ~SharedMemoryExchange();
+
+    /**
+     * Return a pointer to the send buffer. The function waits for all
+     * on-node partners to have finished reading the previous exchange.
+     */
+    template <typename T>
+    T *send_buffer();
+
+    /**
+     * Start the exchange. The send buffer must have been fully packed
+     * and @p receive_buffer has to remain valid until finish() returns.
+     */
+    void start(void *receive_buffer);
+
+    /**
+     * Finish the exchange: Wait for all off-node messages and copy the
+     * data of all on-node partners into the receive buffer.
+     */
+    void finish();
+
+    /**
+     * Return the size of the (shared) send buffer in bytes.
+     */
+    std::size_t memory_consumption() const
+    {
+      return send_buffer_size_;
+    }
+
+  private:
+    struct Target {
+      int rank;
+      int node_rank; /* MPI_UNDEFINED for off-node partners */
+      std::size_t offset;
+      std::size_t size;
+      const char *remote; /* send buffer of an on-node partner */
+    };
+
+    enum Tags : int { setup_tag = 0, data_tag, ready_tag, done_tag };
+
+    MPI_Comm communicator_;
+    MPI_Comm node_communicator_;
+    MPI_Win window_;
+
+    char *send_buffer_;
+    std::size_t send_buffer_size_;
+    char *receive_buffer_;
+
+    std::vector<Target> send_targets_;
+    std::vector<Target> receive_targets_;
+
+    std::vector<MPI_Request> requests_;
+    std::vector<MPI_Request> ready_requests_;
+    std::vector<MPI_Request> done_requests_;
+  };
+
+
+  /* Inline function definitions: */
+
+  inline SharedMemoryExchange::SharedMemoryExchange(
+      const targets_type &send_targets,
+      const targets_type &receive_targets,
+      const MPI_Comm &mpi_communicator)
+      : send_buffer_(nullptr)
+      , send_buffer_size_(0)
+      , receive_buffer_(nullptr)
+  {
+    int ierr = MPI_Comm_dup(mpi_communicator, &communicator_);
+    AssertThrowMPI(ierr);
+
+    const int this_rank =
+        dealii::Utilities::MPI::this_mpi_process(communicator_);
+    ierr = MPI_Comm_split_type(communicator_,
+                               MPI_COMM_TYPE_SHARED,
+                               this_rank,
+                               MPI_INFO_NULL,
+                               &node_communicator_);
+    AssertThrowMPI(ierr);
+
+    /* Translate the ranks of all partners into ranks on the node: */
+
+    MPI_Group group, node_group;
+    MPI_Comm_group(communicator_, &group);
+    MPI_Comm_group(node_communicator_, &node_group);
+
+    const auto populate = [&](const targets_type &targets, auto &result) {
+      std::size_t offset = 0;
+      for (const auto &[rank, size] : targets) {
+        const int global_rank = rank;
+        int node_rank = MPI_UNDEFINED;
+        MPI_Group_translate_ranks(
+            group, 1, &global_rank, node_group, &node_rank);
+        result.push_back({global_rank, node_rank, offset, size, nullptr});
+        offset += size;
+      }
+      return offset;
+    };
+
+    send_buffer_size_ = populate(send_targets, send_targets_);
+    populate(receive_targets, receive_targets_);
+
+    MPI_Group_free(&node_group);
+    MPI_Group_free(&group);
+
+    /*
+     * Allocate the send buffers. Every segment is first touched by its
+     * owning rank, so we ask for non-contiguous (page aligned, NUMA
+     * local) segments:
+     */
+
+    MPI_Info info;
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "alloc_shared_noncontig", "true");
+    ierr = MPI_Win_allocate_shared(send_buffer_size_,
+                                   1,
+                                   info,
+                                   node_communicator_,
+                                   &send_buffer_,
+                                   &window_);
+    AssertThrowMPI(ierr);
+    MPI_Info_free(&info);
+
+    ierr = MPI_Win_lock_all(MPI_MODE_NOCHECK, window_);
+    AssertThrowMPI(ierr);
+
+    /* Tell on-node partners where their data lives in our send buffer: */
+
+    std::vector<MPI_Request> requests;
+    std::vector<std::size_t> remote_offsets(receive_targets_.size());
+
+    for (unsigned int p = 0; p < receive_targets_.size(); ++p) {
+      const auto &target = receive_targets_[p];
+      if (target.node_rank == MPI_UNDEFINED)
+        continue;
+      requests.emplace_back();
+      ierr = MPI_Irecv(&remote_offsets[p],
+                       sizeof(std::size_t),
+                       MPI_BYTE,
+                       target.rank,
+                       setup_tag,
+                       communicator_,
+                       &requests.back());
+      AssertThrowMPI(ierr);
+    }
+
+    for (const auto &target : send_targets_) {
+      if (target.node_rank == MPI_UNDEFINED)
+        continue;
+      requests.emplace_back();
+      ierr = MPI_Isend(&target.offset,
+                       sizeof(std::size_t),
+                       MPI_BYTE,
+                       target.rank,
+                       setup_tag,
+                       communicator_,
+                       &requests.back());
+      AssertThrowMPI(ierr);
+    }
+
+    ierr = MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    AssertThrowMPI(ierr);
+
+    for (unsigned int p = 0; p < receive_targets_.size(); ++p) {
+      auto &target = receive_targets_[p];
+      if (target.node_rank == MPI_UNDEFINED)
+        continue;
+      MPI_Aint size;
+      int disp_unit;
+      char *base = nullptr;
+      ierr = MPI_Win_shared_query(
+          window_, target.node_rank, &size, &disp_unit, &base);
+      AssertThrowMPI(ierr);
+      target.remote = base + remote_offsets[p];
+    }
+  }
+
+
+  inline SharedMemoryExchange::~SharedMemoryExchange()
+  {
+    int ierr = MPI_Waitall(
+        done_requests_.size(), done_requests_.data(), MPI_STATUSES_IGNORE);
+    AssertNothrow(ierr == MPI_SUCCESS, dealii::ExcInternalError());
+
+    ierr = MPI_Win_unlock_all(window_);
+    AssertNothrow(ierr == MPI_SUCCESS, dealii::ExcInternalError());
+    ierr = MPI_Win_free(&window_);
+    AssertNothrow(ierr == MPI_SUCCESS, dealii::ExcInternalError());
+
+    MPI_Comm_free(&node_communicator_);
+    MPI_Comm_free(&communicator_);
+    (void)ierr;
+  }
+
+
+  template <typename T>
+  inline T *SharedMemoryExchange::send_buffer()
+  {
+    const int ierr = MPI_Waitall(
+        done_requests_.size(), done_requests_.data(), MPI_STATUSES_IGNORE);
+    AssertThrowMPI(ierr);
+    done_requests_.clear();
+
+    MPI_Win_sync(window_);
+    return reinterpret_cast<T *>(send_buffer_);
+  }
+
+
+  inline void SharedMemoryExchange::start(void *receive_buffer)
+  {
+    receive_buffer_ = static_cast<char *>(receive_buffer);
+    requests_.clear();
+    ready_requests_.clear();
+
+    /* Make the packed send buffer visible to all ranks on the node: */
+    MPI_Win_sync(window_);
+
+    int ierr;
+    for (const auto &target : receive_targets_) {
+      if (target.node_rank == MPI_UNDEFINED) {
+        requests_.emplace_back();
+        ierr = MPI_Irecv(receive_buffer_ + target.offset,
+                         target.size,
+                         MPI_BYTE,
+                         target.rank,
+                         data_tag,
+                         communicator_,
+                         &requests_.back());
+      } else {
+        ready_requests_.emplace_back();
+        ierr = MPI_Irecv(nullptr,
+                         0,
+                         MPI_BYTE,
+                         target.rank,
+                         ready_tag,
+                         communicator_,
+                         &ready_requests_.back());
+      }
+      AssertThrowMPI(ierr);
+    }
+
+    for (const auto &target : send_targets_) {
+      requests_.emplace_back();
+      if (target.node_rank == MPI_UNDEFINED) {
+        ierr = MPI_Isend(send_buffer_ + target.offset,
+                         target.size,
+                         MPI_BYTE,
+                         target.rank,
+                         data_tag,
+                         communicator_,
+                         &requests_.back());
+      } else {
+        ierr = MPI_Isend(nullptr,
+                         0,
+                         MPI_BYTE,
+                         target.rank,
+                         ready_tag,
+                         communicator_,
+                         &requests_.back());
+        AssertThrowMPI(ierr);
+        done_requests_.emplace_back();
+        ierr = MPI_Irecv(nullptr,
+                         0,
+                         MPI_BYTE,
+                         target.rank,
+                         done_tag,
+                         communicator_,
+                         &done_requests_.back());
+      }
+      AssertThrowMPI(ierr);
+    }
+  }
+
+
+  inline void SharedMemoryExchange::finish()
+  {
+    int ierr = MPI_Waitall(
+        ready_requests_.size(), ready_requests_.data(), MPI_STATUSES_IGNORE);
+    AssertThrowMPI(ierr);
+
+    if (!ready_requests_.empty()) {
+      MPI_Win_sync(window_);
+
+      for (const auto &target : receive_targets_) {
+        if (target.node_rank == MPI_UNDEFINED)
+          continue;
+        std::memcpy(
+            receive_buffer_ + target.offset, target.remote, target.size);
+
+        done_requests_.emplace_back();
+        ierr = MPI_Isend(nullptr,
+                         0,
+                         MPI_BYTE,
+                         target.rank,
+                         done_tag,
+                         communicator_,
+                         &done_requests_.back());
+        AssertThrowMPI(ierr);
+      }
+    }
+
+    ierr = MPI_Waitall(requests_.size(), requests_.data(), MPI_STATUSES_IGNORE);
+    AssertThrowMPI(ierr);
+  }
+
+} // namespace ryujin
@@ -126,11 +126,74 @@ namespace ryujin
   /**
    * Custom implementation of a vectorized pow function.
    *
+   * For vectorized types (and for scalar types if USE_CUSTOM_POW is
+   * set) the implementation of the vectorclass library is used. It
+   * computes exp(b * log(x)) with an extended precision logarithm; the
+   * relative error stays within 4 ULP for the moderate exponents (of the
+   * order of gamma) used throughout.
+   *
    * @ingroup SIMD
    */
   template <typename T>
   T pow(const T x, const typename get_value_type<T>::type b);
 
+
+  /**
+   * Custom implementation of a vectorized natural logarithm.
+   *
+   * For vectorized types the implementation of the vectorclass library
+   * is used, which is accurate to within 4 ULP for normal, positive
+   * arguments. Scalar types (and VectorizedArray of width 1) use
+   * std::log (accurate to within 1 ULP).
+   *
+   * @ingroup SIMD
+   */
+  template <typename T>
+  T log(const T x);
+
+
+  /**
+   * Custom implementation of a vectorized exponential function.
+   *
+   * For vectorized types the implementation of the vectorclass library
+   * is used, which is accurate to within 4 ULP as long as the result is
+   * a normal number. Scalar types (and VectorizedArray of width 1) use
+   * std::exp (accurate to within 1 ULP).
+   *
+   * @ingroup SIMD
+   */
+  template <typename T>
+  T exp(const T x);
+
+
+  /**
+   * Compute the rational power x^(N/D) for a compile-time exponent. If
+   * the denominator @p D is a power of two the power is evaluated with
+   * fixed_power() and a chain of square roots, otherwise the function
+   * falls back to ryujin::pow(). The argument has to be nonnegative.
+   *
+   * @ingroup SIMD
+   */
+  template <int N, int D, typename T>
+  inline DEAL_II_ALWAYS_INLINE T rational_power(const T x)
+  {
+    static_assert(D > 0, "the denominator has to be positive");
+
+    if constexpr (D == 1) {
+      if constexpr (N >= 0)
+        return fixed_power<N>(x);
+      else
+        return T(1.) / fixed_power<-N>(x);
+
+    } else if constexpr (D % 2 == 0) {
+      return std::sqrt(rational_power<N, D / 2>(x));
+
+    } else {
+      using ScalarNumber = typename get_value_type<T>::type;
+      return ryujin::pow(x, ScalarNumber(N) / ScalarNumber(D));
+    }
+  }
+
   //@}
   /**
    * @name SIMD based access to vectors and arrays of vectors
@@ -141,6 +141,200 @@ namespace ryujin
     return result;
   }
 
+#endif
+
+  /* log and exp: */
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  float log(const float x)
+  {
+    return std::log(x);
+  }
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  double log(const double x)
+  {
+    return std::log(x);
+  }
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  float exp(const float x)
+  {
+    return std::exp(x);
+  }
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  double exp(const double x)
+  {
+    return std::exp(x);
+  }
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  dealii::VectorizedArray<float, 1>
+  log(const dealii::VectorizedArray<float, 1> x)
+  {
+    return std::log(x.data);
+  }
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  dealii::VectorizedArray<float, 1>
+  exp(const dealii::VectorizedArray<float, 1> x)
+  {
+    return std::exp(x.data);
+  }
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  dealii::VectorizedArray<double, 1>
+  log(const dealii::VectorizedArray<double, 1> x)
+  {
+    return std::log(x.data);
+  }
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  dealii::VectorizedArray<double, 1>
+  exp(const dealii::VectorizedArray<double, 1> x)
+  {
+    return std::exp(x.data);
+  }
+
+#if DEAL_II_COMPILER_VECTORIZATION_LEVEL >= 3 && defined(__AVX512F__)
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  dealii::VectorizedArray<float, 16>
+  log(const dealii::VectorizedArray<float, 16> x)
+  {
+    dealii::VectorizedArray<float, 16> result;
+    result.data = log(Vec16f(x.data));
+    return result;
+  }
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  dealii::VectorizedArray<float, 16>
+  exp(const dealii::VectorizedArray<float, 16> x)
+  {
+    dealii::VectorizedArray<float, 16> result;
+    result.data = exp(Vec16f(x.data));
+    return result;
+  }
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  dealii::VectorizedArray<double, 8>
+  log(const dealii::VectorizedArray<double, 8> x)
+  {
+    dealii::VectorizedArray<double, 8> result;
+    result.data = log(Vec8d(x.data));
+    return result;
+  }
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  dealii::VectorizedArray<double, 8>
+  exp(const dealii::VectorizedArray<double, 8> x)
+  {
+    dealii::VectorizedArray<double, 8> result;
+    result.data = exp(Vec8d(x.data));
+    return result;
+  }
+
+#endif
+
+#if DEAL_II_COMPILER_VECTORIZATION_LEVEL >= 2 && defined(__AVX__)
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  dealii::VectorizedArray<float, 8>
+  log(const dealii::VectorizedArray<float, 8> x)
+  {
+    dealii::VectorizedArray<float, 8> result;
+    result.data = log(Vec8f(x.data));
+    return result;
+  }
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  dealii::VectorizedArray<float, 8>
+  exp(const dealii::VectorizedArray<float, 8> x)
+  {
+    dealii::VectorizedArray<float, 8> result;
+    result.data = exp(Vec8f(x.data));
+    return result;
+  }
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  dealii::VectorizedArray<double, 4>
+  log(const dealii::VectorizedArray<double, 4> x)
+  {
+    dealii::VectorizedArray<double, 4> result;
+    result.data = log(Vec4d(x.data));
+    return result;
+  }
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  dealii::VectorizedArray<double, 4>
+  exp(const dealii::VectorizedArray<double, 4> x)
+  {
+    dealii::VectorizedArray<double, 4> result;
+    result.data = exp(Vec4d(x.data));
+    return result;
+  }
+
+#endif
+
+#if DEAL_II_COMPILER_VECTORIZATION_LEVEL >= 1 && defined(__SSE2__)
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  dealii::VectorizedArray<float, 4>
+  log(const dealii::VectorizedArray<float, 4> x)
+  {
+    dealii::VectorizedArray<float, 4> result;
+    result.data = log(Vec4f(x.data));
+    return result;
+  }
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  dealii::VectorizedArray<float, 4>
+  exp(const dealii::VectorizedArray<float, 4> x)
+  {
+    dealii::VectorizedArray<float, 4> result;
+    result.data = exp(Vec4f(x.data));
+    return result;
+  }
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  dealii::VectorizedArray<double, 2>
+  log(const dealii::VectorizedArray<double, 2> x)
+  {
+    dealii::VectorizedArray<double, 2> result;
+    result.data = log(Vec2d(x.data));
+    return result;
+  }
+
+  template <>
+  // DEAL_II_ALWAYS_INLINE inline
+  dealii::VectorizedArray<double, 2>
+  exp(const dealii::VectorizedArray<double, 2> x)
+  {
+    dealii::VectorizedArray<double, 2> result;
+    result.data = exp(Vec2d(x.data));
+    return result;
+  }
+
 #endif
 
 } // namespace ryujin
@@ -0,0 +1,304 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include "openmp.h"
+
+#include <deal.II/base/mpi.h>
+#include <deal.II/base/timer.h>
+#include <deal.II/lac/la_parallel_block_vector.h>
+#include <deal.II/lac/la_parallel_vector.h>
+#include <deal.II/lac/solver_control.h>
+#include <deal.II/lac/vector_memory.h>
+
+#include <array>
+#include <cmath>
+
+namespace ryujin
+{
+  namespace
+  {
+    /*
+     * Small helpers that allow us to treat distributed vectors and
+     * distributed block vectors uniformly:
+     */
+
+    template <typename Number>
+    unsigned int
+    n_vector_blocks(const dealii::LinearAlgebra::distributed::Vector<Number> &)
+    {
+      return 1;
+    }
+
+    template <typename Number>
+    unsigned int n_vector_blocks(
+        const dealii::LinearAlgebra::distributed::BlockVector<Number> &vector)
+    {
+      return vector.n_blocks();
+    }
+
+    template <typename Number>
+    dealii::LinearAlgebra::distributed::Vector<Number> &
+    vector_block(dealii::LinearAlgebra::distributed::Vector<Number> &vector,
+                 const unsigned int)
+    {
+      return vector;
+    }
+
+    template <typename Number>
+    dealii::LinearAlgebra::distributed::Vector<Number> &vector_block(
+        dealii::LinearAlgebra::distributed::BlockVector<Number> &vector,
+        const unsigned int block)
+    {
+      return vector.block(block);
+    }
+  } // namespace
+
+
+  /**
+   * A preconditioned pipelined conjugate gradient method following
+   * @cite GhyselsVanroose2014, Algorithm 3.
+   *
+   * In contrast to dealii::SolverCG, which performs two blocking global
+   * reductions per iteration, this solver merges all scalar products of
+   * an iteration into a single nonblocking MPI_Iallreduce that is
+   * overlapped with the preconditioner application and the matrix-vector
+   * product of the next iteration. All vector updates and the local
+   * contributions of the scalar products are fused into a single sweep
+   * over memory.
+   *
+   * The price to pay are five additional auxiliary vectors and a
+   * slightly increased sensitivity to round-off errors. The stopping
+   * criterion is the unpreconditioned l_2 norm of the residual, exactly
+   * as for dealii::SolverCG. If the iteration does not converge within
+   * the maximal number of iterations set in the SolverControl object a
+   * dealii::SolverControl::NoConvergence exception is thrown.
+   *
+   * @ingroup DissipationModule
+   */
+  template <typename VectorType>
+  class SolverPipelinedCG
+  {
+  public:
+    /**
+     * The underlying scalar type.
+     */
+    using Number = typename VectorType::value_type;
+
+    /**
+     * Constructor. The time spent waiting for the completion of global
+     * reductions is accumulated in @p wait_timer.
+     */
+    SolverPipelinedCG(dealii::SolverControl &solver_control,
+                      const MPI_Comm &mpi_communicator,
+                      dealii::Timer &wait_timer)
+        : solver_control_(solver_control)
+        , mpi_communicator_(mpi_communicator)
+        , wait_timer_(wait_timer)
+    {
+    }
+
+    /**
+     * Solve the linear system A x = b with the given preconditioner.
+     */
+    template <typename MatrixType, typename PreconditionerType>
+    void solve(const MatrixType &A,
+               VectorType &x,
+               const VectorType &b,
+               const PreconditionerType &preconditioner)
+    {
+      typename dealii::VectorMemory<VectorType>::Pointer r(memory_);
+      typename dealii::VectorMemory<VectorType>::Pointer u(memory_);
+      typename dealii::VectorMemory<VectorType>::Pointer w(memory_);
+      typename dealii::VectorMemory<VectorType>::Pointer m(memory_);
+      typename dealii::VectorMemory<VectorType>::Pointer n(memory_);
+      typename dealii::VectorMemory<VectorType>::Pointer p(memory_);
+      typename dealii::VectorMemory<VectorType>::Pointer q(memory_);
+      typename dealii::VectorMemory<VectorType>::Pointer s(memory_);
+      typename dealii::VectorMemory<VectorType>::Pointer z(memory_);
+
+      r->reinit(x, true);
+      u->reinit(x, true);
+      w->reinit(x, true);
+      m->reinit(x, true);
+      n->reinit(x, true);
+      p->reinit(x);
+      q->reinit(x);
+      s->reinit(x);
+      z->reinit(x);
+
+      /* r = b - A x, u = M r, w = A u: */
+
+      A.vmult(*r, x);
+      r->sadd(Number(-1.), Number(1.), b);
+      preconditioner.vmult(*u, *r);
+      A.vmult(*w, *u);
+
+      std::array<double, 3> sums = local_sums(*r, *u, *w);
+
+      Number gamma_old = Number(0.);
+      Number alpha_old = Number(0.);
+
+      for (unsigned int iteration = 0;; ++iteration) {
+        MPI_Request request;
+        MPI_Iallreduce(MPI_IN_PLACE,
+                       sums.data(),
+                       3,
+                       MPI_DOUBLE,
+                       MPI_SUM,
+                       mpi_communicator_,
+                       &request);
+
+        /* m = M w, n = A m, overlapped with the reduction: */
+
+        preconditioner.vmult(*m, *w);
+        A.vmult(*n, *m);
+
+        wait_timer_.start();
+        MPI_Wait(&request, MPI_STATUS_IGNORE);
+        wait_timer_.stop();
+
+        const Number gamma = sums[0];
+        const Number delta = sums[1];
+        const Number residual = std::sqrt(sums[2]);
+
+        const auto state = solver_control_.check(iteration, residual);
+        if (state == dealii::SolverControl::success)
+          return;
+
+        AssertThrow(state == dealii::SolverControl::iterate,
+                    dealii::SolverControl::NoConvergence(iteration, residual));
+
+        Number alpha;
+        Number beta;
+        if (iteration == 0) {
+          beta = Number(0.);
+          alpha = gamma / delta;
+        } else {
+          beta = gamma / gamma_old;
+          alpha = gamma / (delta - beta * gamma / alpha_old);
+        }
+
+        AssertThrow(std::isfinite(alpha) && alpha > Number(0.),
+                    dealii::SolverControl::NoConvergence(iteration, residual));
+
+        gamma_old = gamma;
+        alpha_old = alpha;
+
+        sums = fused_update(alpha, beta, x, *r, *u, *w, *m, *n, *p, *q, *s, *z);
+      }
+    }
+
+  private:
+    /**
+     * Compute the local contributions to (r, u), (w, u), and (r, r).
+     */
+    std::array<double, 3>
+    local_sums(VectorType &r, VectorType &u, VectorType &w) const
+    {
+      std::array<double, 3> sums{{0., 0., 0.}};
+
+      for (unsigned int b = 0; b < n_vector_blocks(r); ++b) {
+        const Number *r_b = vector_block(r, b).begin();
+        const Number *u_b = vector_block(u, b).begin();
+        const Number *w_b = vector_block(w, b).begin();
+        const unsigned int size =
+            vector_block(r, b).get_partitioner()->local_size();
+
+        RYUJIN_PARALLEL_REGION_BEGIN
+
+        std::array<double, 3> thread_sums{{0., 0., 0.}};
+
+        RYUJIN_OMP_FOR
+        for (unsigned int i = 0; i < size; ++i) {
+          thread_sums[0] += r_b[i] * u_b[i];
+          thread_sums[1] += w_b[i] * u_b[i];
+          thread_sums[2] += r_b[i] * r_b[i];
+        }
+
+        RYUJIN_OMP_CRITICAL
+        for (unsigned int k = 0; k < 3; ++k)
+          sums[k] += thread_sums[k];
+
+        RYUJIN_PARALLEL_REGION_END
+      }
+
+      return sums;
+    }
+
+    /**
+     * Perform all vector updates of one iteration in a single sweep and
+     * return the local contributions to the scalar products needed for
+     * the next iteration.
+     */
+    std::array<double, 3> fused_update(const Number alpha,
+                                       const Number beta,
+                                       VectorType &x,
+                                       VectorType &r,
+                                       VectorType &u,
+                                       VectorType &w,
+                                       VectorType &m,
+                                       VectorType &n,
+                                       VectorType &p,
+                                       VectorType &q,
+                                       VectorType &s,
+                                       VectorType &z) const
+    {
+      std::array<double, 3> sums{{0., 0., 0.}};
+
+      for (unsigned int b = 0; b < n_vector_blocks(x); ++b) {
+        Number *x_b = vector_block(x, b).begin();
+        Number *r_b = vector_block(r, b).begin();
+        Number *u_b = vector_block(u, b).begin();
+        Number *w_b = vector_block(w, b).begin();
+        const Number *m_b = vector_block(m, b).begin();
+        const Number *n_b = vector_block(n, b).begin();
+        Number *p_b = vector_block(p, b).begin();
+        Number *q_b = vector_block(q, b).begin();
+        Number *s_b = vector_block(s, b).begin();
+        Number *z_b = vector_block(z, b).begin();
+        const unsigned int size =
+            vector_block(x, b).get_partitioner()->local_size();
+
+        RYUJIN_PARALLEL_REGION_BEGIN
+
+        std::array<double, 3> thread_sums{{0., 0., 0.}};
+
+        RYUJIN_OMP_FOR
+        for (unsigned int i = 0; i < size; ++i) {
+          z_b[i] = n_b[i] + beta * z_b[i];
+          q_b[i] = m_b[i] + beta * q_b[i];
+          s_b[i] = w_b[i] + beta * s_b[i];
+          p_b[i] = u_b[i] + beta * p_b[i];
+
+          x_b[i] += alpha * p_b[i];
+          r_b[i] -= alpha * s_b[i];
+          u_b[i] -= alpha * q_b[i];
+          w_b[i] -= alpha * z_b[i];
+
+          thread_sums[0] += r_b[i] * u_b[i];
+          thread_sums[1] += w_b[i] * u_b[i];
+          thread_sums[2] += r_b[i] * r_b[i];
+        }
+
+        RYUJIN_OMP_CRITICAL
+        for (unsigned int k = 0; k < 3; ++k)
+          sums[k] += thread_sums[k];
+
+        RYUJIN_PARALLEL_REGION_END
+      }
+
+      return sums;
+    }
+
+    dealii::SolverControl &solver_control_;
+    const MPI_Comm &mpi_communicator_;
+    dealii::Timer &wait_timer_;
+
+    dealii::GrowingVectorMemory<VectorType> memory_;
+  };
+
+} /* namespace ryujin */
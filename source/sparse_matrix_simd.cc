@@ -23,4 +23,25 @@ namespace ryujin
   template class SparseMatrixSIMD<NUMBER,
                                   ProblemDescription::problem_dimension<DIM>>;
 
+  template class SymmetricSparseMatrixSIMD<NUMBER>;
+
+#ifdef USE_MIXED_PRECISION_STORAGE
+  template class SparseMatrixSIMD<NUMBER,
+                                  1,
+                                  dealii::VectorizedArray<NUMBER>::size(),
+                                  float>;
+
+#if DIM != 1
+  template class SparseMatrixSIMD<NUMBER,
+                                  DIM,
+                                  dealii::VectorizedArray<NUMBER>::size(),
+                                  float>;
+#endif
+
+  template class SymmetricSparseMatrixSIMD<
+      NUMBER,
+      dealii::VectorizedArray<NUMBER>::size(),
+      float>;
+#endif
+
 } /* namespace ryujin */
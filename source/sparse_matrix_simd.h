@@ -5,20 +5,32 @@
 
 #pragma once
 
+#include <compile_time_options.h>
+
 #include <deal.II/base/aligned_vector.h>
+#include <deal.II/base/array_view.h>
 #include <deal.II/base/partitioner.h>
 #include <deal.II/lac/dynamic_sparsity_pattern.h>
+#include <deal.II/lac/sparsity_pattern.h>
 
+#include "memory_mapped_file.h"
 #include "openmp.h"
+#include "shared_memory_exchange.h"
 #include "simd.h"
 
 namespace ryujin
 {
   template <typename Number,
             int n_components = 1,
-            int simd_length = dealii::VectorizedArray<Number>::size()>
+            int simd_length = dealii::VectorizedArray<Number>::size(),
+            typename StorageType = Number>
   class SparseMatrixSIMD;
 
+  template <typename Number,
+            int simd_length = dealii::VectorizedArray<Number>::size(),
+            typename StorageType = Number>
+  class SymmetricSparseMatrixSIMD;
+
   /**
    * A specialized sparsity pattern for efficient vectorized SIMD access.
    *
@@ -55,13 +67,27 @@ namespace ryujin
 
 
     /**
-     *
+     * Set up the SIMD sparsity pattern from a sparsity pattern @p sparsity
+     * in global (deal.II typical) numbering. Only the locally owned rows
+     * of @p sparsity are accessed.
      */
     void reinit(const unsigned int n_internal_dofs,
                 const dealii::DynamicSparsityPattern &sparsity,
                 const std::shared_ptr<const dealii::Utilities::MPI::Partitioner>
                     &partitioner);
 
+    /**
+     * Set up the SIMD sparsity pattern from a "minimal" sparsity pattern
+     * @p sparsity in local numbering that has one row for every locally
+     * relevant index. Locally owned rows have to contain all couplings,
+     * whereas ghost rows only contain the transposed entries of the
+     * couplings of locally owned rows (and the diagonal).
+     */
+    void reinit(const unsigned int n_internal_dofs,
+                const dealii::SparsityPattern &sparsity,
+                const std::shared_ptr<const dealii::Utilities::MPI::Partitioner>
+                    &partitioner);
+
     unsigned int stride_of_row(const unsigned int row) const;
 
     const unsigned int *columns(const unsigned int row) const;
@@ -72,22 +98,80 @@ namespace ryujin
 
     std::size_t n_nonzero_elements() const;
 
+    /**
+     * Return the fraction of SIMD lanes that carry a nonzero entry when
+     * iterating over all locally owned rows: Rows in [0, n_internal_dofs)
+     * are processed in SIMD blocks with all lanes active, whereas for
+     * the CSR rows [n_internal_dofs, n_locally_owned_dofs) only a single
+     * lane is active.
+     */
+    double lane_utilization() const;
+
+    /**
+     * Return an estimate of the lane utilization if the CSR rows
+     * [n_internal_dofs, n_locally_owned_dofs) were stored in a
+     * SELL-C-sigma layout @cite KreutzerEtAl2014 with chunk size C =
+     * simd_length: Rows are sorted by length within windows of @p sigma
+     * consecutive rows, and every chunk of C rows is padded to the
+     * maximal row length within the chunk.
+     */
+    double sell_c_sigma_lane_utilization(const unsigned int sigma) const;
+
+    /**
+     * Return the memory consumption of the sparsity pattern in bytes.
+     */
+    std::size_t memory_consumption() const;
+
+    /**
+     * Write the sparsity pattern into the boost archive @p archive. The
+     * (large) row start, column index, and transposed index arrays are
+     * appended page aligned to @p writer.
+     */
+    template <typename Archive>
+    void save(Archive &archive, MemoryMappedFileWriter &writer) const;
+
+    /**
+     * Read a sparsity pattern written by save() from the boost archive
+     * @p archive. The row start, column index, and transposed index
+     * arrays are not copied but refer directly to the memory mapped file
+     * @p file. The MPI partitioner @p partitioner has to be identical to
+     * the one used for the original call to reinit().
+     */
+    template <typename Archive>
+    void load(Archive &archive,
+              const std::shared_ptr<const MemoryMappedFile> &file,
+              const std::shared_ptr<const dealii::Utilities::MPI::Partitioner>
+                  &partitioner);
+
   private:
+#ifdef USE_SHARED_MEMORY_EXCHANGE
+    /**
+     * Create a SharedMemoryExchange for the ghost rows of a matrix that
+     * stores @p bytes_per_entry bytes for every entry of the sparsity
+     * pattern.
+     */
+    std::shared_ptr<SharedMemoryExchange>
+    create_shared_memory_exchange(const std::size_t bytes_per_entry) const;
+#endif
+
     unsigned int n_internal_dofs;
     unsigned int n_locally_owned_dofs;
     std::shared_ptr<const dealii::Utilities::MPI::Partitioner> partitioner;
 
-    dealii::AlignedVector<std::size_t> row_starts;
-    dealii::AlignedVector<unsigned int> column_indices;
-    dealii::AlignedVector<unsigned int> indices_transposed;
+    MappableVector<std::size_t> row_starts;
+    MappableVector<unsigned int> column_indices;
+    MappableVector<unsigned int> indices_transposed;
 
     dealii::AlignedVector<std::size_t> indices_to_be_sent;
     std::vector<std::pair<unsigned int, unsigned int>> send_targets;
     std::vector<std::pair<unsigned int, unsigned int>> receive_targets;
     MPI_Comm mpi_communicator;
 
-    template <typename, int, int>
+    template <typename, int, int, typename>
     friend class SparseMatrixSIMD;
+
+    template <typename, int, typename>
+    friend class SymmetricSparseMatrixSIMD;
   };
 
 
@@ -99,8 +183,16 @@ namespace ryujin
    * SparsityPatternSIMD for details). For the non-vectorized row index
    * region [n_internal_dofs, n_locally_relevant_dofs) we store the matrix in
    * CSR format (equivalent to the static dealii::SparsityPattern).
+   *
+   * The optional @p StorageType template parameter allows to store the
+   * matrix entries with a lower precision than the arithmetic type
+   * @p Number (e.g. float instead of double). All entries are converted
+   * to @p Number on access.
    */
-  template <typename Number, int n_components, int simd_length>
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
   class SparseMatrixSIMD
   {
   public:
@@ -114,6 +206,16 @@ namespace ryujin
     void read_in(const std::array<SparseMatrix, n_components> &sparse_matrix,
                  bool locally_indexed = true);
 
+    /**
+     * Copy all entries of @p other, which has to be set up with the same
+     * sparsity pattern, and convert them to StorageType.
+     */
+    template <typename OtherStorageType>
+    void copy_from(const SparseMatrixSIMD<Number,
+                                          n_components,
+                                          simd_length,
+                                          OtherStorageType> &other);
+
     template <typename SparseMatrix>
     void read_in(const SparseMatrix &sparse_matrix,
                  bool locally_indexed = true);
@@ -151,7 +253,10 @@ namespace ryujin
         const unsigned int row,
         const unsigned int position_within_column) const;
 
-    /* FIXME: Implement get_vectorized_transposed_tensor */
+    dealii::Tensor<1, n_components, VectorizedArray>
+    get_vectorized_transposed_tensor(
+        const unsigned int row,
+        const unsigned int position_within_column) const;
 
     /* Write scalar or tensor entry: */
 
@@ -174,17 +279,216 @@ namespace ryujin
         const unsigned int position_within_column,
         const bool do_streaming_store = false);
 
-    /* Synchronize over MPI ranks: */
+    /*
+     * Synchronize over MPI ranks. If ryujin is configured with
+     * USE_SHARED_MEMORY_EXCHANGE, ghost rows owned by ranks on the same
+     * node are copied directly out of a shared send buffer (see
+     * SharedMemoryExchange) and the communication channel is ignored:
+     */
 
     void update_ghost_rows_start(const unsigned int communication_channel = 0);
     void update_ghost_rows_finish();
     void update_ghost_rows();
 
+    /**
+     * Return the memory consumption of the matrix entries (and
+     * communication buffers) in bytes. The sparsity pattern is not
+     * included.
+     */
+    std::size_t memory_consumption() const;
+
+    /**
+     * Return a view of all (locally relevant) matrix entries in the
+     * order of the internal storage, for example for mirroring them into
+     * device memory with DeviceStorage.
+     */
+    dealii::ArrayView<const StorageType> entries() const
+    {
+      return {data.data(), data.size()};
+    }
+
+    /**
+     * @copydoc entries()
+     */
+    dealii::ArrayView<StorageType> entries()
+    {
+      return {data.data(), data.size()};
+    }
+
+    /**
+     * Append all (locally relevant) matrix entries page aligned to @p
+     * writer and store the offset in the boost archive @p archive.
+     */
+    template <typename Archive>
+    void save(Archive &archive, MemoryMappedFileWriter &writer) const;
+
+    /**
+     * Initialize the matrix for the sparsity pattern @p sparsity with the
+     * entries written by save(). The entries are not copied but refer
+     * directly to the memory mapped file @p file.
+     */
+    template <typename Archive>
+    void load(Archive &archive,
+              const SparsityPatternSIMD<simd_length> &sparsity,
+              const std::shared_ptr<const MemoryMappedFile> &file);
+
   private:
     const SparsityPatternSIMD<simd_length> *sparsity;
-    dealii::AlignedVector<Number> data;
-    dealii::AlignedVector<Number> exchange_buffer;
+    MappableVector<StorageType> data;
+    dealii::AlignedVector<StorageType> exchange_buffer;
     std::vector<MPI_Request> requests;
+#ifdef USE_SHARED_MEMORY_EXCHANGE
+    std::shared_ptr<SharedMemoryExchange> shared_memory_exchange;
+#endif
+
+    template <typename, int, int, typename>
+    friend class SparseMatrixSIMD;
+
+    template <typename, int, typename>
+    friend class SymmetricSparseMatrixSIMD;
+  };
+
+
+  /**
+   * A variant of SparseMatrixSIMD for symmetric, scalar-valued matrices
+   * that only stores the upper triangular part in the vectorized row
+   * index region [0, n_internal_dofs).
+   *
+   * Within the vectorized region we drop every block of simd_length
+   * entries (i.e., a given column position of a SIMD row chunk) for
+   * which all columns lie strictly below the diagonal. All remaining
+   * blocks are stored in the same array-of-struct-of-array layout as for
+   * SparseMatrixSIMD; a bit mask per SIMD row chunk records which column
+   * positions are present. Entries below the diagonal are looked up via
+   * the transposed index of the sparsity pattern, which always points to
+   * a stored block. The non-vectorized region [n_internal_dofs,
+   * n_locally_relevant_dofs) is stored in full CSR format.
+   *
+   * Only entries on or above the diagonal can be written to. The
+   * @p StorageType template parameter has the same meaning as for
+   * SparseMatrixSIMD.
+   */
+  template <typename Number, int simd_length, typename StorageType>
+  class SymmetricSparseMatrixSIMD
+  {
+  public:
+    SymmetricSparseMatrixSIMD();
+
+    SymmetricSparseMatrixSIMD(const SparsityPatternSIMD<simd_length> &sparsity);
+
+    void reinit(const SparsityPatternSIMD<simd_length> &sparsity);
+
+    template <typename SparseMatrix>
+    void read_in(const SparseMatrix &sparse_matrix,
+                 bool locally_indexed = true);
+
+    /**
+     * Copy all stored entries of the (full) matrix @p other, which has to
+     * be set up with the same sparsity pattern, and convert them to
+     * StorageType.
+     */
+    template <typename OtherStorageType>
+    void copy_from(
+        const SparseMatrixSIMD<Number, 1, simd_length, OtherStorageType>
+            &other);
+
+    using VectorizedArray = dealii::VectorizedArray<Number, simd_length>;
+
+    /* Get scalar entry: */
+
+    Number get_entry(const unsigned int row,
+                     const unsigned int position_within_column) const;
+
+    VectorizedArray
+    get_vectorized_entry(const unsigned int row,
+                         const unsigned int position_within_column) const;
+
+    /* Get transposed scalar entry (identical to the entry itself): */
+
+    Number
+    get_transposed_entry(const unsigned int row,
+                         const unsigned int position_within_column) const;
+
+    VectorizedArray get_vectorized_transposed_entry(
+        const unsigned int row,
+        const unsigned int position_within_column) const;
+
+    /* Write scalar entry on or above the diagonal: */
+
+    void write_entry(const Number entry,
+                     const unsigned int row,
+                     const unsigned int position_within_column);
+
+    void write_vectorized_entry(const VectorizedArray entry,
+                                const unsigned int row,
+                                const unsigned int position_within_column,
+                                const bool do_streaming_store = false);
+
+    /*
+     * Synchronize over MPI ranks. If ryujin is configured with
+     * USE_SHARED_MEMORY_EXCHANGE, ghost rows owned by ranks on the same
+     * node are copied directly out of a shared send buffer (see
+     * SharedMemoryExchange) and the communication channel is ignored:
+     */
+
+    void update_ghost_rows_start(const unsigned int communication_channel = 0);
+    void update_ghost_rows_finish();
+    void update_ghost_rows();
+
+    /**
+     * Return the memory consumption of the matrix entries (and
+     * communication buffers) in bytes. The sparsity pattern is not
+     * included.
+     */
+    std::size_t memory_consumption() const;
+
+    /**
+     * Append all (locally relevant) matrix entries page aligned to @p
+     * writer and store the offset in the boost archive @p archive.
+     */
+    template <typename Archive>
+    void save(Archive &archive, MemoryMappedFileWriter &writer) const;
+
+    /**
+     * Initialize the matrix for the sparsity pattern @p sparsity with the
+     * entries written by save(). The entries are not copied but refer
+     * directly to the memory mapped file @p file.
+     */
+    template <typename Archive>
+    void load(Archive &archive,
+              const SparsityPatternSIMD<simd_length> &sparsity,
+              const std::shared_ptr<const MemoryMappedFile> &file);
+
+  private:
+    /**
+     * Return the position in the data array of the first lane of the
+     * (stored) block at @p position_within_column of SIMD row chunk
+     * @p simd_row.
+     */
+    std::size_t block_index(const unsigned int simd_row,
+                            const unsigned int position_within_column) const;
+
+    /**
+     * Translate an index into the (full) storage layout of the
+     * SparsityPatternSIMD for an entry of row @p row into the index of
+     * the data array.
+     */
+    std::size_t data_index(const std::size_t index,
+                           const unsigned int row) const;
+
+    const SparsityPatternSIMD<simd_length> *sparsity;
+
+    dealii::AlignedVector<std::uint64_t> stored_columns;
+    dealii::AlignedVector<std::size_t> row_starts;
+    std::size_t csr_shift;
+
+    MappableVector<StorageType> data;
+    dealii::AlignedVector<std::size_t> indices_to_be_sent;
+    dealii::AlignedVector<StorageType> exchange_buffer;
+    std::vector<MPI_Request> requests;
+#ifdef USE_SHARED_MEMORY_EXCHANGE
+    std::shared_ptr<SharedMemoryExchange> shared_memory_exchange;
+#endif
   };
 
   /*
@@ -252,18 +556,24 @@ namespace ryujin
   }
 
 
-  template <typename Number, int n_components, int simd_length>
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
   DEAL_II_ALWAYS_INLINE inline Number
-  SparseMatrixSIMD<Number, n_components, simd_length>::get_entry(
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::get_entry(
       const unsigned int row, const unsigned int position_within_column) const
   {
     return get_tensor(row, position_within_column)[0];
   }
 
 
-  template <typename Number, int n_components, int simd_length>
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
   DEAL_II_ALWAYS_INLINE inline dealii::Tensor<1, n_components, Number>
-  SparseMatrixSIMD<Number, n_components, simd_length>::get_tensor(
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::get_tensor(
       const unsigned int row, const unsigned int position_within_column) const
   {
     Assert(sparsity != nullptr, dealii::ExcNotInitialized());
@@ -293,20 +603,30 @@ namespace ryujin
   }
 
 
-  template <typename Number, int n_components, int simd_length>
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
   DEAL_II_ALWAYS_INLINE inline dealii::VectorizedArray<Number, simd_length>
-  SparseMatrixSIMD<Number, n_components, simd_length>::get_vectorized_entry(
-      const unsigned int row, const unsigned int position_within_column) const
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::
+      get_vectorized_entry(
+          const unsigned int row,
+          const unsigned int position_within_column) const
   {
     return get_vectorized_tensor(row, position_within_column)[0];
   }
 
 
-  template <typename Number, int n_components, int simd_length>
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
   DEAL_II_ALWAYS_INLINE inline auto
-  SparseMatrixSIMD<Number, n_components, simd_length>::get_vectorized_tensor(
-      const unsigned int row, const unsigned int position_within_column) const
-      -> dealii::Tensor<1, n_components, VectorizedArray>
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::
+      get_vectorized_tensor(
+          const unsigned int row,
+          const unsigned int position_within_column) const
+          -> dealii::Tensor<1, n_components, VectorizedArray>
   {
     Assert(sparsity != nullptr, dealii::ExcNotInitialized());
 
@@ -322,29 +642,43 @@ namespace ryujin
     dealii::
         Tensor<1, n_components, dealii::VectorizedArray<Number, simd_length>>
             result;
-    const Number *load_pos =
+    const StorageType *load_pos =
         data.data() + (sparsity->row_starts[row / simd_length] +
                        position_within_column * simd_length) *
                           n_components;
     for (unsigned int d = 0; d < n_components; ++d)
-      result[d].load(load_pos + d * simd_length);
+      if constexpr (std::is_same<StorageType, Number>::value)
+        result[d].load(load_pos + d * simd_length);
+      else
+        for (unsigned int k = 0; k < simd_length; ++k)
+          result[d][k] = load_pos[d * simd_length + k];
     return result;
   }
 
 
-  template <typename Number, int n_components, int simd_length>
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
   DEAL_II_ALWAYS_INLINE inline Number
-  SparseMatrixSIMD<Number, n_components, simd_length>::get_transposed_entry(
-      const unsigned int row, const unsigned int position_within_column) const
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::
+      get_transposed_entry(
+          const unsigned int row,
+          const unsigned int position_within_column) const
   {
     return get_transposed_tensor(row, position_within_column)[0];
   }
 
 
-  template <typename Number, int n_components, int simd_length>
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
   DEAL_II_ALWAYS_INLINE inline dealii::Tensor<1, n_components, Number>
-  SparseMatrixSIMD<Number, n_components, simd_length>::get_transposed_tensor(
-      const unsigned int row, const unsigned int position_within_column) const
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::
+      get_transposed_tensor(
+          const unsigned int row,
+          const unsigned int position_within_column) const
   {
     Assert(sparsity != nullptr, dealii::ExcNotInitialized());
 
@@ -397,9 +731,12 @@ namespace ryujin
   }
 
 
-  template <typename Number, int n_components, int simd_length>
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
   DEAL_II_ALWAYS_INLINE inline dealii::VectorizedArray<Number, simd_length>
-  SparseMatrixSIMD<Number, n_components, simd_length>::
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::
       get_vectorized_transposed_entry(
           const unsigned int row,
           const unsigned int position_within_column) const
@@ -418,14 +755,69 @@ namespace ryujin
     const unsigned int offset = sparsity->row_starts[row / simd_length] +
                                 position_within_column * simd_length;
     dealii::VectorizedArray<Number, simd_length> result;
-    result.gather(data.data(), sparsity->indices_transposed.data() + offset);
+    if constexpr (std::is_same<StorageType, Number>::value)
+      result.gather(data.data(), sparsity->indices_transposed.data() + offset);
+    else
+      for (unsigned int k = 0; k < simd_length; ++k)
+        result[k] = data[sparsity->indices_transposed[offset + k]];
+    return result;
+  }
+
+
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
+  DEAL_II_ALWAYS_INLINE inline auto
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::
+      get_vectorized_transposed_tensor(
+          const unsigned int row,
+          const unsigned int position_within_column) const
+      -> dealii::Tensor<1, n_components, VectorizedArray>
+  {
+    Assert(sparsity != nullptr, dealii::ExcNotInitialized());
+
+    AssertIndexRange(row, sparsity->row_starts.size() - 1);
+    AssertIndexRange(position_within_column, sparsity->row_length(row));
+    Assert(row < sparsity->n_internal_dofs,
+           dealii::ExcMessage(
+               "Vectorized access only possible in vectorized part"));
+    Assert(row % simd_length == 0,
+           dealii::ExcMessage(
+               "Access only supported for rows at the SIMD granularity"));
+
+    const unsigned int offset = sparsity->row_starts[row / simd_length] +
+                                position_within_column * simd_length;
+
+    dealii::Tensor<1, n_components, VectorizedArray> result;
+
+    if (n_components == 1) {
+      result[0] = get_vectorized_transposed_entry(row, position_within_column);
+      return result;
+    }
+
+    for (unsigned int k = 0; k < simd_length; ++k) {
+      const std::size_t index = sparsity->indices_transposed[offset + k];
+      const unsigned int col = sparsity->column_indices[offset + k];
+      if (col < sparsity->n_internal_dofs)
+        for (unsigned int d = 0; d < n_components; ++d)
+          result[d][k] = data[index / simd_length * simd_length * n_components +
+                              simd_length * d + index % simd_length];
+      else
+        for (unsigned int d = 0; d < n_components; ++d)
+          result[d][k] = data[index * n_components + d];
+    }
+
     return result;
   }
 
 
-  template <typename Number, int n_components, int simd_length>
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
   DEAL_II_ALWAYS_INLINE inline void
-  SparseMatrixSIMD<Number, n_components, simd_length>::write_entry(
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::write_entry(
       const Number entry,
       const unsigned int row,
       const unsigned int position_within_column)
@@ -437,12 +829,16 @@ namespace ryujin
   }
 
 
-  template <typename Number, int n_components, int simd_length>
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
   DEAL_II_ALWAYS_INLINE inline void
-  SparseMatrixSIMD<Number, n_components, simd_length>::write_tensor(
-      const dealii::Tensor<1, n_components, Number> &entry,
-      const unsigned int row,
-      const unsigned int position_within_column)
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::
+      write_tensor(
+          const dealii::Tensor<1, n_components, Number> &entry,
+          const unsigned int row,
+          const unsigned int position_within_column)
   {
     Assert(sparsity != nullptr, dealii::ExcNotInitialized());
 
@@ -468,13 +864,17 @@ namespace ryujin
   }
 
 
-  template <typename Number, int n_components, int simd_length>
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
   DEAL_II_ALWAYS_INLINE inline void
-  SparseMatrixSIMD<Number, n_components, simd_length>::write_vectorized_entry(
-      const dealii::VectorizedArray<Number, simd_length> entry,
-      const unsigned int row,
-      const unsigned int position_within_column,
-      const bool do_streaming_store)
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::
+      write_vectorized_entry(
+          const dealii::VectorizedArray<Number, simd_length> entry,
+          const unsigned int row,
+          const unsigned int position_within_column,
+          const bool do_streaming_store)
   {
     dealii::Tensor<1, n_components, VectorizedArray> tensor;
     tensor[0] = entry;
@@ -484,13 +884,17 @@ namespace ryujin
   }
 
 
-  template <typename Number, int n_components, int simd_length>
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
   DEAL_II_ALWAYS_INLINE inline void
-  SparseMatrixSIMD<Number, n_components, simd_length>::write_vectorized_tensor(
-      const dealii::Tensor<1, n_components, VectorizedArray> &entry,
-      const unsigned int row,
-      const unsigned int position_within_column,
-      const bool do_streaming_store)
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::
+      write_vectorized_tensor(
+          const dealii::Tensor<1, n_components, VectorizedArray> &entry,
+          const unsigned int row,
+          const unsigned int position_within_column,
+          const bool do_streaming_store)
   {
     Assert(sparsity != nullptr, dealii::ExcNotInitialized());
 
@@ -502,10 +906,15 @@ namespace ryujin
     Assert(row % simd_length == 0,
            dealii::ExcMessage(
                "Access only supported for rows at the SIMD granularity"));
-    Number *store_pos = data.data() + (sparsity->row_starts[row / simd_length] +
-                                       position_within_column * simd_length) *
-                                          n_components;
-    if (do_streaming_store)
+    StorageType *store_pos =
+        data.data() + (sparsity->row_starts[row / simd_length] +
+                       position_within_column * simd_length) *
+                          n_components;
+    if constexpr (!std::is_same<StorageType, Number>::value)
+      for (unsigned int d = 0; d < n_components; ++d)
+        for (unsigned int k = 0; k < simd_length; ++k)
+          store_pos[d * simd_length + k] = StorageType(entry[d][k]);
+    else if (do_streaming_store)
       for (unsigned int d = 0; d < n_components; ++d)
         entry[d].streaming_store(store_pos + d * simd_length);
     else
@@ -514,14 +923,43 @@ namespace ryujin
   }
 
 
-  template <typename Number, int n_components, int simd_length>
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
   inline void
-  SparseMatrixSIMD<Number, n_components, simd_length>::update_ghost_rows_start(
-      const unsigned int communication_channel)
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::
+      update_ghost_rows_start(
+          const unsigned int communication_channel)
   {
 #ifdef DEAL_II_WITH_MPI
     AssertIndexRange(communication_channel, 200);
 
+#ifdef USE_SHARED_MEMORY_EXCHANGE
+    if (!shared_memory_exchange)
+      shared_memory_exchange = sparsity->create_shared_memory_exchange(
+          n_components * sizeof(StorageType));
+
+    {
+      const std::size_t n_indices = sparsity->indices_to_be_sent.size();
+      StorageType *buffer =
+          shared_memory_exchange->send_buffer<StorageType>();
+
+      RYUJIN_PARALLEL_REGION_BEGIN
+
+      RYUJIN_OMP_FOR
+      for (std::size_t c = 0; c < n_indices; ++c)
+        for (unsigned int comp = 0; comp < n_components; ++comp)
+          buffer[n_components * c + comp] =
+              data[n_components * sparsity->indices_to_be_sent[c] + comp];
+
+      RYUJIN_PARALLEL_REGION_END
+
+      shared_memory_exchange->start(
+          data.data() +
+          n_components * sparsity->row_starts[sparsity->n_locally_owned_dofs]);
+    }
+#else
     const unsigned int mpi_tag =
         dealii::Utilities::MPI::internal::Tags::partitioner_export_start +
         communication_channel;
@@ -543,7 +981,7 @@ namespace ryujin
                     (sparsity->row_starts[sparsity->n_locally_owned_dofs] +
                      (p == 0 ? 0 : targets[p - 1].second)),
             (targets[p].second - (p == 0 ? 0 : targets[p - 1].second)) *
-                n_components * sizeof(Number),
+                n_components * sizeof(StorageType),
             MPI_BYTE,
             targets[p].first,
             mpi_tag,
@@ -571,7 +1009,326 @@ namespace ryujin
             exchange_buffer.data() +
                 n_components * (p == 0 ? 0 : targets[p - 1].second),
             (targets[p].second - (p == 0 ? 0 : targets[p - 1].second)) *
-                n_components * sizeof(Number),
+                n_components * sizeof(StorageType),
+            MPI_BYTE,
+            targets[p].first,
+            mpi_tag,
+            sparsity->mpi_communicator,
+            &requests[p + sparsity->receive_targets.size()]);
+        AssertThrowMPI(ierr);
+      }
+    }
+#endif
+#endif
+  }
+
+
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
+  inline void SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::
+      update_ghost_rows_finish()
+  {
+#ifdef DEAL_II_WITH_MPI
+#ifdef USE_SHARED_MEMORY_EXCHANGE
+    shared_memory_exchange->finish();
+#else
+    const int ierr =
+        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    AssertThrowMPI(ierr);
+#endif
+#endif
+  }
+
+
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
+  inline void
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::
+      update_ghost_rows()
+  {
+    update_ghost_rows_start();
+    update_ghost_rows_finish();
+  }
+
+
+  template <typename Number, int simd_length, typename StorageType>
+  DEAL_II_ALWAYS_INLINE inline std::size_t
+  SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::block_index(
+      const unsigned int simd_row,
+      const unsigned int position_within_column) const
+  {
+    const std::uint64_t mask = stored_columns[simd_row];
+    Assert((mask >> position_within_column) & 1,
+           dealii::ExcMessage("Access to a block that is not stored"));
+
+    const std::uint64_t preceding =
+        mask & ((std::uint64_t(1) << position_within_column) - 1);
+    return row_starts[simd_row] + __builtin_popcountll(preceding) * simd_length;
+  }
+
+
+  template <typename Number, int simd_length, typename StorageType>
+  DEAL_II_ALWAYS_INLINE inline std::size_t
+  SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::data_index(
+      const std::size_t index, const unsigned int row) const
+  {
+    if (row < sparsity->n_internal_dofs) {
+      const unsigned int simd_row = row / simd_length;
+      const unsigned int position_within_column =
+          (index - sparsity->row_starts[simd_row]) / simd_length;
+      return block_index(simd_row, position_within_column) +
+             index % simd_length;
+    } else {
+      return index - csr_shift;
+    }
+  }
+
+
+  template <typename Number, int simd_length, typename StorageType>
+  DEAL_II_ALWAYS_INLINE inline Number
+  SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::get_entry(
+      const unsigned int row, const unsigned int position_within_column) const
+  {
+    Assert(sparsity != nullptr, dealii::ExcNotInitialized());
+
+    AssertIndexRange(row, sparsity->row_starts.size() - 1);
+    AssertIndexRange(position_within_column, sparsity->row_length(row));
+
+    const std::size_t index =
+        row < sparsity->n_internal_dofs
+            ? sparsity->row_starts[row / simd_length] + row % simd_length +
+                  position_within_column * simd_length
+            : sparsity->row_starts[row] + position_within_column;
+
+    const unsigned int column = sparsity->column_indices[index];
+    if (column >= row)
+      return data[data_index(index, row)];
+
+    /* Lower triangular part: */
+    return data[data_index(sparsity->indices_transposed[index], column)];
+  }
+
+
+  template <typename Number, int simd_length, typename StorageType>
+  DEAL_II_ALWAYS_INLINE inline dealii::VectorizedArray<Number, simd_length>
+  SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::
+      get_vectorized_entry(
+          const unsigned int row,
+          const unsigned int position_within_column) const
+  {
+    Assert(sparsity != nullptr, dealii::ExcNotInitialized());
+
+    AssertIndexRange(row, sparsity->row_starts.size() - 1);
+    AssertIndexRange(position_within_column, sparsity->row_length(row));
+    Assert(row < sparsity->n_internal_dofs,
+           dealii::ExcMessage(
+               "Vectorized access only possible in vectorized part"));
+    Assert(row % simd_length == 0,
+           dealii::ExcMessage(
+               "Access only supported for rows at the SIMD granularity"));
+
+    const std::size_t offset = sparsity->row_starts[row / simd_length] +
+                               position_within_column * simd_length;
+    const unsigned int *js = sparsity->column_indices.data() + offset;
+
+    bool all_above_diagonal = true;
+    for (unsigned int k = 0; k < simd_length; ++k)
+      if (js[k] < row + k) {
+        all_above_diagonal = false;
+        break;
+      }
+
+    VectorizedArray result;
+
+    if (RYUJIN_LIKELY(all_above_diagonal)) {
+      const StorageType *load_pos =
+          data.data() + block_index(row / simd_length, position_within_column);
+      if constexpr (std::is_same<StorageType, Number>::value)
+        result.load(load_pos);
+      else
+        for (unsigned int k = 0; k < simd_length; ++k)
+          result[k] = load_pos[k];
+      return result;
+    }
+
+    for (unsigned int k = 0; k < simd_length; ++k) {
+      if (js[k] >= row + k)
+        result[k] =
+            data[block_index(row / simd_length, position_within_column) + k];
+      else
+        result[k] =
+            data[data_index(sparsity->indices_transposed[offset + k], js[k])];
+    }
+
+    return result;
+  }
+
+
+  template <typename Number, int simd_length, typename StorageType>
+  DEAL_II_ALWAYS_INLINE inline Number
+  SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::
+      get_transposed_entry(
+          const unsigned int row,
+          const unsigned int position_within_column) const
+  {
+    return get_entry(row, position_within_column);
+  }
+
+
+  template <typename Number, int simd_length, typename StorageType>
+  DEAL_II_ALWAYS_INLINE inline dealii::VectorizedArray<Number, simd_length>
+  SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::
+      get_vectorized_transposed_entry(
+          const unsigned int row,
+          const unsigned int position_within_column) const
+  {
+    return get_vectorized_entry(row, position_within_column);
+  }
+
+
+  template <typename Number, int simd_length, typename StorageType>
+  DEAL_II_ALWAYS_INLINE inline void
+  SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::write_entry(
+      const Number entry,
+      const unsigned int row,
+      const unsigned int position_within_column)
+  {
+    Assert(sparsity != nullptr, dealii::ExcNotInitialized());
+
+    AssertIndexRange(row, sparsity->row_starts.size() - 1);
+    AssertIndexRange(position_within_column, sparsity->row_length(row));
+
+    const std::size_t index =
+        row < sparsity->n_internal_dofs
+            ? sparsity->row_starts[row / simd_length] + row % simd_length +
+                  position_within_column * simd_length
+            : sparsity->row_starts[row] + position_within_column;
+
+    Assert(sparsity->column_indices[index] >= row,
+           dealii::ExcMessage("Only entries on or above the diagonal are "
+                              "stored in a SymmetricSparseMatrixSIMD"));
+
+    data[data_index(index, row)] = entry;
+  }
+
+
+  template <typename Number, int simd_length, typename StorageType>
+  DEAL_II_ALWAYS_INLINE inline void
+  SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::
+      write_vectorized_entry(
+          const dealii::VectorizedArray<Number, simd_length> entry,
+          const unsigned int row,
+          const unsigned int position_within_column,
+          const bool do_streaming_store)
+  {
+    Assert(sparsity != nullptr, dealii::ExcNotInitialized());
+
+    AssertIndexRange(row, sparsity->row_starts.size() - 1);
+    AssertIndexRange(position_within_column, sparsity->row_length(row));
+    Assert(row < sparsity->n_internal_dofs,
+           dealii::ExcMessage(
+               "Vectorized access only possible in vectorized part"));
+    Assert(row % simd_length == 0,
+           dealii::ExcMessage(
+               "Access only supported for rows at the SIMD granularity"));
+
+    /*
+     * Note: for a block straddling the diagonal we also store the lanes
+     * below the diagonal. These values are never read back.
+     */
+    StorageType *store_pos =
+        data.data() + block_index(row / simd_length, position_within_column);
+    if constexpr (!std::is_same<StorageType, Number>::value)
+      for (unsigned int k = 0; k < simd_length; ++k)
+        store_pos[k] = StorageType(entry[k]);
+    else if (do_streaming_store)
+      entry.streaming_store(store_pos);
+    else
+      entry.store(store_pos);
+  }
+
+
+  template <typename Number, int simd_length, typename StorageType>
+  inline void
+  SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::
+      update_ghost_rows_start(
+          const unsigned int communication_channel)
+  {
+#ifdef DEAL_II_WITH_MPI
+    AssertIndexRange(communication_channel, 200);
+
+#ifdef USE_SHARED_MEMORY_EXCHANGE
+    if (!shared_memory_exchange)
+      shared_memory_exchange =
+          sparsity->create_shared_memory_exchange(sizeof(StorageType));
+
+    {
+      const std::size_t n_indices = indices_to_be_sent.size();
+      StorageType *buffer =
+          shared_memory_exchange->send_buffer<StorageType>();
+
+      RYUJIN_PARALLEL_REGION_BEGIN
+
+      RYUJIN_OMP_FOR
+      for (std::size_t c = 0; c < n_indices; ++c)
+        buffer[c] = data[indices_to_be_sent[c]];
+
+      RYUJIN_PARALLEL_REGION_END
+
+      shared_memory_exchange->start(
+          data.data() +
+          (sparsity->row_starts[sparsity->n_locally_owned_dofs] - csr_shift));
+    }
+#else
+    const unsigned int mpi_tag =
+        dealii::Utilities::MPI::internal::Tags::partitioner_export_start +
+        communication_channel;
+    Assert(mpi_tag <=
+               dealii::Utilities::MPI::internal::Tags::partitioner_export_end,
+           dealii::ExcInternalError());
+
+    const std::size_t n_indices = indices_to_be_sent.size();
+    exchange_buffer.resize_fast(n_indices);
+
+    requests.resize(sparsity->receive_targets.size() +
+                    sparsity->send_targets.size());
+    {
+      const auto &targets = sparsity->receive_targets;
+      for (unsigned int p = 0; p < targets.size(); ++p) {
+        const int ierr = MPI_Irecv(
+            data.data() +
+                (sparsity->row_starts[sparsity->n_locally_owned_dofs] -
+                 csr_shift + (p == 0 ? 0 : targets[p - 1].second)),
+            (targets[p].second - (p == 0 ? 0 : targets[p - 1].second)) *
+                sizeof(StorageType),
+            MPI_BYTE,
+            targets[p].first,
+            mpi_tag,
+            sparsity->mpi_communicator,
+            &requests[p]);
+        AssertThrowMPI(ierr);
+      }
+    }
+
+    RYUJIN_PARALLEL_REGION_BEGIN
+
+    RYUJIN_OMP_FOR
+    for (std::size_t c = 0; c < n_indices; ++c)
+      exchange_buffer[c] = data[indices_to_be_sent[c]];
+
+    RYUJIN_PARALLEL_REGION_END
+
+    {
+      const auto &targets = sparsity->send_targets;
+      for (unsigned int p = 0; p < targets.size(); ++p) {
+        const int ierr = MPI_Isend(
+            exchange_buffer.data() + (p == 0 ? 0 : targets[p - 1].second),
+            (targets[p].second - (p == 0 ? 0 : targets[p - 1].second)) *
+                sizeof(StorageType),
             MPI_BYTE,
             targets[p].first,
             mpi_tag,
@@ -580,25 +1337,32 @@ namespace ryujin
         AssertThrowMPI(ierr);
       }
     }
+#endif
 #endif
   }
 
 
-  template <typename Number, int n_components, int simd_length>
-  inline void SparseMatrixSIMD<Number, n_components, simd_length>::
+  template <typename Number, int simd_length, typename StorageType>
+  inline void
+  SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::
       update_ghost_rows_finish()
   {
 #ifdef DEAL_II_WITH_MPI
+#ifdef USE_SHARED_MEMORY_EXCHANGE
+    shared_memory_exchange->finish();
+#else
     const int ierr =
         MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
     AssertThrowMPI(ierr);
+#endif
 #endif
   }
 
 
-  template <typename Number, int n_components, int simd_length>
+  template <typename Number, int simd_length, typename StorageType>
   inline void
-  SparseMatrixSIMD<Number, n_components, simd_length>::update_ghost_rows()
+  SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::
+      update_ghost_rows()
   {
     update_ghost_rows_start();
     update_ghost_rows_finish();
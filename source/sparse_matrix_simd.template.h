@@ -7,11 +7,60 @@
 
 #include "sparse_matrix_simd.h"
 
+#include <deal.II/base/memory_consumption.h>
 #include <deal.II/base/vectorization.h>
 #include <deal.II/lac/sparse_matrix.h>
 
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <functional>
+
 namespace ryujin
 {
+  namespace
+  {
+    /*
+     * Zero out an array that consists of SIMD row chunks in the index
+     * range [0, n_internal_dofs) laid out according to @p simd_row_starts
+     * and CSR rows in [n_internal_dofs, n_rows) laid out according to
+     * @p csr_row_starts (shifted by @p csr_shift). We use the same static
+     * OpenMP schedule that is used in the compute kernels. On NUMA
+     * systems this places (by virtue of the first-touch policy) all
+     * memory pages on the memory domain of the thread that will
+     * subsequently work on them.
+     */
+    template <int simd_length,
+              typename T,
+              typename SIMDRowStarts,
+              typename CSRRowStarts>
+    void first_touch(T *data,
+                     const SIMDRowStarts &simd_row_starts,
+                     const CSRRowStarts &csr_row_starts,
+                     const unsigned int n_internal_dofs,
+                     const unsigned int n_rows,
+                     const unsigned int stride = 1,
+                     const std::size_t csr_shift = 0)
+    {
+      RYUJIN_PARALLEL_REGION_BEGIN
+
+      RYUJIN_OMP_FOR_NOWAIT
+      for (unsigned int i = n_internal_dofs; i < n_rows; ++i)
+        std::fill(data + stride * (csr_row_starts[i] - csr_shift),
+                  data + stride * (csr_row_starts[i + 1] - csr_shift),
+                  T(0));
+
+      RYUJIN_OMP_FOR
+      for (unsigned int i = 0; i < n_internal_dofs; i += simd_length)
+        std::fill(data + stride * simd_row_starts[i / simd_length],
+                  data + stride * simd_row_starts[i / simd_length + 1],
+                  T(0));
+
+      RYUJIN_PARALLEL_REGION_END
+    }
+  } // namespace
+
 
   template <int simd_length>
   SparsityPatternSIMD<simd_length>::SparsityPatternSIMD()
@@ -76,6 +125,26 @@ namespace ryujin
     dealii::SparsityPattern sparsity;
     sparsity.copy_from(dsp_minimal);
 
+    reinit(n_internal_dofs, sparsity, partitioner);
+  }
+
+
+  template <int simd_length>
+  void SparsityPatternSIMD<simd_length>::reinit(
+      const unsigned int n_internal_dofs,
+      const dealii::SparsityPattern &sparsity,
+      const std::shared_ptr<const dealii::Utilities::MPI::Partitioner>
+          &partitioner)
+  {
+    this->mpi_communicator = partitioner->get_mpi_communicator();
+
+    this->n_internal_dofs = n_internal_dofs;
+    this->n_locally_owned_dofs = partitioner->local_size();
+    this->partitioner = partitioner;
+
+    Assert(sparsity.n_rows() ==
+               partitioner->local_size() + partitioner->n_ghost_indices(),
+           dealii::ExcInternalError());
     Assert(n_internal_dofs <= sparsity.n_rows(), dealii::ExcInternalError());
     Assert(n_internal_dofs % simd_length == 0, dealii::ExcInternalError());
     Assert(n_internal_dofs <= n_locally_owned_dofs, dealii::ExcInternalError());
@@ -91,9 +160,32 @@ namespace ryujin
                                    "billion matrix entries per MPI rank. Try to"
                                    " split into smaller problems with MPI"));
 
-    /* Vectorized part: */
+    /*
+     * Determine the row starts upfront so that we can first touch the
+     * column index arrays with the static schedule of the compute loops:
+     */
 
     row_starts[0] = 0;
+    for (unsigned int i = 0; i < n_internal_dofs; i += simd_length)
+      row_starts[i / simd_length + 1] =
+          row_starts[i / simd_length] + sparsity.row_length(i) * simd_length;
+
+    row_starts[n_internal_dofs] = row_starts[n_internal_dofs / simd_length];
+    for (unsigned int i = n_internal_dofs; i < sparsity.n_rows(); ++i)
+      row_starts[i + 1] = row_starts[i] + sparsity.row_length(i);
+
+    first_touch<simd_length>(column_indices.data(),
+                             row_starts,
+                             row_starts,
+                             n_internal_dofs,
+                             sparsity.n_rows());
+    first_touch<simd_length>(indices_transposed.data(),
+                             row_starts,
+                             row_starts,
+                             n_internal_dofs,
+                             sparsity.n_rows());
+
+    /* Vectorized part: */
 
     unsigned int *col_ptr = column_indices.data();
     unsigned int *transposed_ptr = indices_transposed.data();
@@ -119,13 +211,13 @@ namespace ryujin
             *transposed_ptr++ = position;
         }
 
-      row_starts[i / simd_length + 1] = col_ptr - column_indices.data();
+      Assert(row_starts[i / simd_length + 1] ==
+                 std::size_t(col_ptr - column_indices.data()),
+             dealii::ExcInternalError());
     }
 
     /* Rest: */
 
-    row_starts[n_internal_dofs] = row_starts[n_internal_dofs / simd_length];
-
     for (unsigned int i = n_internal_dofs; i < sparsity.n_rows(); ++i) {
       for (auto j = sparsity.begin(i); j != sparsity.end(i); ++j) {
         const unsigned int column = j->column();
@@ -142,7 +234,9 @@ namespace ryujin
         } else
           *transposed_ptr++ = position;
       }
-      row_starts[i + 1] = col_ptr - column_indices.data();
+      Assert(row_starts[i + 1] ==
+                 std::size_t(col_ptr - column_indices.data()),
+             dealii::ExcInternalError());
     }
 
     Assert(col_ptr == column_indices.end(), dealii::ExcInternalError());
@@ -240,34 +334,191 @@ namespace ryujin
   }
 
 
-  template <typename Number, int n_components, int simd_length>
-  SparseMatrixSIMD<Number, n_components, simd_length>::SparseMatrixSIMD()
-      : sparsity(nullptr)
+  template <int simd_length>
+  double SparsityPatternSIMD<simd_length>::lane_utilization() const
   {
+    const double n_simd_entries = row_starts[n_internal_dofs];
+    const double n_csr_entries =
+        row_starts[n_locally_owned_dofs] - row_starts[n_internal_dofs];
+
+    const double n_lanes = n_simd_entries + simd_length * n_csr_entries;
+    if (n_lanes == 0.)
+      return 1.;
+
+    return (n_simd_entries + n_csr_entries) / n_lanes;
   }
 
 
-  template <typename Number, int n_components, int simd_length>
-  SparseMatrixSIMD<Number, n_components, simd_length>::SparseMatrixSIMD(
-      const SparsityPatternSIMD<simd_length> &sparsity)
-      : sparsity(&sparsity)
+  template <int simd_length>
+  double SparsityPatternSIMD<simd_length>::sell_c_sigma_lane_utilization(
+      const unsigned int sigma) const
+  {
+    std::vector<unsigned int> row_lengths;
+    row_lengths.reserve(n_locally_owned_dofs - n_internal_dofs);
+    for (unsigned int i = n_internal_dofs; i < n_locally_owned_dofs; ++i)
+      row_lengths.push_back(row_length(i));
+
+    /* Sort rows by length within every window of sigma rows: */
+    const unsigned int window = std::max(sigma, 1u);
+    for (auto it = row_lengths.begin(); it < row_lengths.end();) {
+      const auto last = row_lengths.end() - it > std::ptrdiff_t(window)
+                            ? it + window
+                            : row_lengths.end();
+      std::sort(it, last, std::greater<unsigned int>());
+      it = last;
+    }
+
+    /* Pad every chunk of simd_length rows to its maximal row length: */
+    double n_padded_entries = 0.;
+    for (std::size_t i = 0; i < row_lengths.size(); i += simd_length) {
+      unsigned int max_length = 0;
+      for (std::size_t k = i; k < std::min(i + simd_length, row_lengths.size());
+           ++k)
+        max_length = std::max(max_length, row_lengths[k]);
+      n_padded_entries += simd_length * max_length;
+    }
+
+    const double n_simd_entries = row_starts[n_internal_dofs];
+    const double n_csr_entries =
+        row_starts[n_locally_owned_dofs] - row_starts[n_internal_dofs];
+
+    const double n_lanes = n_simd_entries + n_padded_entries;
+    if (n_lanes == 0.)
+      return 1.;
+
+    return (n_simd_entries + n_csr_entries) / n_lanes;
+  }
+
+
+  template <int simd_length>
+  std::size_t SparsityPatternSIMD<simd_length>::memory_consumption() const
+  {
+    return row_starts.memory_consumption() +
+           column_indices.memory_consumption() +
+           indices_transposed.memory_consumption() +
+           indices_to_be_sent.memory_consumption() +
+           dealii::MemoryConsumption::memory_consumption(send_targets) +
+           dealii::MemoryConsumption::memory_consumption(receive_targets);
+  }
+
+
+#ifdef USE_SHARED_MEMORY_EXCHANGE
+  template <int simd_length>
+  std::shared_ptr<SharedMemoryExchange>
+  SparsityPatternSIMD<simd_length>::create_shared_memory_exchange(
+      const std::size_t bytes_per_entry) const
+  {
+    /*
+     * Translate the (rank, end of range) pairs of send_targets and
+     * receive_targets into (rank, size in bytes) pairs:
+     */
+    const auto translate = [&](const auto &targets) {
+      SharedMemoryExchange::targets_type result;
+      for (unsigned int p = 0; p < targets.size(); ++p)
+        result.emplace_back(
+            targets[p].first,
+            (targets[p].second - (p == 0 ? 0 : targets[p - 1].second)) *
+                bytes_per_entry);
+      return result;
+    };
+
+    return std::make_shared<SharedMemoryExchange>(
+        translate(send_targets), translate(receive_targets), mpi_communicator);
+  }
+#endif
+
+
+  template <int simd_length>
+  template <typename Archive>
+  void SparsityPatternSIMD<simd_length>::save(
+      Archive &archive, MemoryMappedFileWriter &writer) const
+  {
+    archive << n_internal_dofs << n_locally_owned_dofs;
+    row_starts.save(archive, writer);
+    column_indices.save(archive, writer);
+    indices_transposed.save(archive, writer);
+    archive << indices_to_be_sent << send_targets << receive_targets;
+  }
+
+
+  template <int simd_length>
+  template <typename Archive>
+  void SparsityPatternSIMD<simd_length>::load(
+      Archive &archive,
+      const std::shared_ptr<const MemoryMappedFile> &file,
+      const std::shared_ptr<const dealii::Utilities::MPI::Partitioner>
+          &partitioner)
+  {
+    this->mpi_communicator = partitioner->get_mpi_communicator();
+    this->partitioner = partitioner;
+
+    archive >> n_internal_dofs >> n_locally_owned_dofs;
+    row_starts.load(archive, file);
+    column_indices.load(archive, file);
+    indices_transposed.load(archive, file);
+    archive >> indices_to_be_sent >> send_targets >> receive_targets;
+
+    AssertThrow(n_locally_owned_dofs == partitioner->local_size() &&
+                    n_rows() == partitioner->local_size() +
+                                    partitioner->n_ghost_indices(),
+                dealii::ExcMessage("The stored sparsity pattern does not "
+                                   "match the MPI partitioner"));
+  }
+
+
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::
+      SparseMatrixSIMD()
+          : sparsity(nullptr)
   {
-    data.resize(sparsity.n_nonzero_elements() * n_components);
   }
 
 
-  template <typename Number, int n_components, int simd_length>
-  void SparseMatrixSIMD<Number, n_components, simd_length>::reinit(
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::
+      SparseMatrixSIMD(
+          const SparsityPatternSIMD<simd_length> &sparsity)
+          : sparsity(nullptr)
+  {
+    reinit(sparsity);
+  }
+
+
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
+  void SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::reinit(
       const SparsityPatternSIMD<simd_length> &sparsity)
   {
     this->sparsity = &sparsity;
-    data.resize(sparsity.n_nonzero_elements() * n_components);
+#ifdef USE_SHARED_MEMORY_EXCHANGE
+    shared_memory_exchange.reset();
+#endif
+
+    data.resize_fast(sparsity.n_nonzero_elements() * n_components);
+    first_touch<simd_length>(data.data(),
+                             sparsity.row_starts,
+                             sparsity.row_starts,
+                             sparsity.n_internal_dofs,
+                             sparsity.n_rows(),
+                             n_components);
   }
 
 
-  template <typename Number, int n_components, int simd_length>
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
   template <typename SparseMatrix>
-  void SparseMatrixSIMD<Number, n_components, simd_length>::read_in(
+  void
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::read_in(
       const std::array<SparseMatrix, n_components> &sparse_matrix,
       bool locally_indexed /*= true*/)
   {
@@ -327,9 +578,13 @@ namespace ryujin
   }
 
 
-  template <typename Number, int n_components, int simd_length>
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
   template <typename SparseMatrix>
-  void SparseMatrixSIMD<Number, n_components, simd_length>::read_in(
+  void
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::read_in(
       const SparseMatrix &sparse_matrix, bool locally_indexed /*= true*/)
   {
     RYUJIN_PARALLEL_REGION_BEGIN
@@ -385,4 +640,341 @@ namespace ryujin
     RYUJIN_PARALLEL_REGION_END
   }
 
+
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
+  std::size_t
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::
+      memory_consumption() const
+  {
+    std::size_t result =
+        data.memory_consumption() + exchange_buffer.memory_consumption() +
+        dealii::MemoryConsumption::memory_consumption(requests);
+#ifdef USE_SHARED_MEMORY_EXCHANGE
+    if (shared_memory_exchange)
+      result += shared_memory_exchange->memory_consumption();
+#endif
+    return result;
+  }
+
+
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
+  template <typename Archive>
+  void SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::save(
+      Archive &archive, MemoryMappedFileWriter &writer) const
+  {
+    data.save(archive, writer);
+  }
+
+
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
+  template <typename Archive>
+  void SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::load(
+      Archive &archive,
+      const SparsityPatternSIMD<simd_length> &sparsity,
+      const std::shared_ptr<const MemoryMappedFile> &file)
+  {
+    this->sparsity = &sparsity;
+#ifdef USE_SHARED_MEMORY_EXCHANGE
+    shared_memory_exchange.reset();
+#endif
+
+    data.load(archive, file);
+    AssertThrow(data.size() == sparsity.n_nonzero_elements() * n_components,
+                dealii::ExcMessage("The stored matrix does not match the "
+                                   "sparsity pattern"));
+  }
+
+
+  template <typename Number,
+            int n_components,
+            int simd_length,
+            typename StorageType>
+  template <typename OtherStorageType>
+  void
+  SparseMatrixSIMD<Number, n_components, simd_length, StorageType>::copy_from(
+      const SparseMatrixSIMD<Number,
+                             n_components,
+                             simd_length,
+                             OtherStorageType> &other)
+  {
+    Assert(other.sparsity == sparsity,
+           dealii::ExcMessage("The matrices have to share the same sparsity "
+                              "pattern"));
+    AssertDimension(other.data.size(), data.size());
+
+    const std::size_t size = data.size();
+
+    RYUJIN_PARALLEL_REGION_BEGIN
+
+    RYUJIN_OMP_FOR
+    for (std::size_t k = 0; k < size; ++k)
+      data[k] = StorageType(other.data[k]);
+
+    RYUJIN_PARALLEL_REGION_END
+  }
+
+
+  template <typename Number, int simd_length, typename StorageType>
+  SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::
+      SymmetricSparseMatrixSIMD()
+          : sparsity(nullptr)
+          , csr_shift(0)
+  {
+  }
+
+
+  template <typename Number, int simd_length, typename StorageType>
+  SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::
+      SymmetricSparseMatrixSIMD(
+          const SparsityPatternSIMD<simd_length> &sparsity)
+          : sparsity(nullptr)
+          , csr_shift(0)
+  {
+    reinit(sparsity);
+  }
+
+
+  template <typename Number, int simd_length, typename StorageType>
+  void SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::reinit(
+      const SparsityPatternSIMD<simd_length> &sparsity)
+  {
+    this->sparsity = &sparsity;
+#ifdef USE_SHARED_MEMORY_EXCHANGE
+    shared_memory_exchange.reset();
+#endif
+
+    const unsigned int n_internal_dofs = sparsity.n_internal_dofs;
+    const unsigned int n_simd_rows = n_internal_dofs / simd_length;
+
+    /*
+     * Determine which column positions of a SIMD row chunk have to be
+     * stored, i.e., contain at least one entry on or above the diagonal:
+     */
+
+    stored_columns.resize_fast(n_simd_rows);
+    row_starts.resize_fast(n_simd_rows + 1);
+    row_starts[0] = 0;
+
+    for (unsigned int i = 0; i < n_internal_dofs; i += simd_length) {
+      const unsigned int row_length = sparsity.row_length(i);
+
+      AssertThrow(row_length <= 64,
+                  dealii::ExcMessage("SymmetricSparseMatrixSIMD only supports "
+                                     "up to 64 entries per row in the "
+                                     "vectorized index range"));
+
+      std::uint64_t mask = 0;
+      const unsigned int *js = sparsity.columns(i);
+      for (unsigned int col_idx = 0; col_idx < row_length;
+           ++col_idx, js += simd_length)
+        for (unsigned int k = 0; k < simd_length; ++k)
+          if (js[k] >= i + k) {
+            mask |= std::uint64_t(1) << col_idx;
+            break;
+          }
+
+      stored_columns[i / simd_length] = mask;
+      row_starts[i / simd_length + 1] =
+          row_starts[i / simd_length] +
+          __builtin_popcountll(mask) * simd_length;
+    }
+
+    /* The CSR part is stored in full right after the vectorized part: */
+
+    csr_shift = sparsity.row_starts[n_simd_rows] - row_starts[n_simd_rows];
+
+    data.resize_fast(sparsity.n_nonzero_elements() - csr_shift);
+    first_touch<simd_length>(data.data(),
+                             row_starts,
+                             sparsity.row_starts,
+                             n_internal_dofs,
+                             sparsity.n_rows(),
+                             /*stride*/ 1,
+                             csr_shift);
+
+    /* Translate the indices for the ghost row exchange: */
+
+    indices_to_be_sent.resize_fast(sparsity.indices_to_be_sent.size());
+    for (std::size_t c = 0; c < indices_to_be_sent.size(); ++c) {
+      const std::size_t index = sparsity.indices_to_be_sent[c];
+      if (index >= sparsity.row_starts[n_simd_rows]) {
+        indices_to_be_sent[c] = index - csr_shift;
+      } else {
+        const auto simd_row =
+            std::upper_bound(sparsity.row_starts.begin(),
+                             sparsity.row_starts.begin() + n_simd_rows + 1,
+                             index) -
+            sparsity.row_starts.begin() - 1;
+        indices_to_be_sent[c] =
+            data_index(index, simd_row * simd_length + index % simd_length);
+      }
+    }
+  }
+
+
+  template <typename Number, int simd_length, typename StorageType>
+  template <typename SparseMatrix>
+  void SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::read_in(
+      const SparseMatrix &sparse_matrix, bool locally_indexed /*= true*/)
+  {
+    RYUJIN_PARALLEL_REGION_BEGIN
+
+    /*
+     * We use the indirect (and slow) access via operator()(i, j) into the
+     * sparse matrix we are copying from. Only the upper triangular part is
+     * read.
+     */
+
+    RYUJIN_OMP_FOR
+    for (unsigned int i = 0; i < sparsity->n_internal_dofs; i += simd_length) {
+
+      const unsigned int row_length = sparsity->row_length(i);
+
+      const unsigned int *js = sparsity->columns(i);
+      for (unsigned int col_idx = 0; col_idx < row_length;
+           ++col_idx, js += simd_length) {
+
+        if (((stored_columns[i / simd_length] >> col_idx) & 1) == 0)
+          continue;
+
+        dealii::VectorizedArray<Number, simd_length> temp = {};
+        for (unsigned int k = 0; k < simd_length; ++k)
+          if (locally_indexed)
+            temp[k] = sparse_matrix(i + k, js[k]);
+          else
+            temp[k] =
+                sparse_matrix.el(sparsity->partitioner->local_to_global(i + k),
+                                 sparsity->partitioner->local_to_global(js[k]));
+
+        write_vectorized_entry(temp, i, col_idx, true);
+      }
+    }
+
+    RYUJIN_OMP_FOR
+    for (unsigned int i = sparsity->n_internal_dofs;
+         i < sparsity->n_locally_owned_dofs;
+         ++i) {
+
+      const unsigned int row_length = sparsity->row_length(i);
+      const unsigned int *js = sparsity->columns(i);
+      for (unsigned int col_idx = 0; col_idx < row_length; ++col_idx, ++js) {
+
+        if (js[0] < i)
+          continue;
+
+        const auto temp =
+            locally_indexed
+                ? sparse_matrix(i, js[0])
+                : sparse_matrix.el(
+                      sparsity->partitioner->local_to_global(i),
+                      sparsity->partitioner->local_to_global(js[0]));
+        write_entry(temp, i, col_idx);
+      }
+    }
+
+    RYUJIN_PARALLEL_REGION_END
+  }
+
+
+  template <typename Number, int simd_length, typename StorageType>
+  template <typename OtherStorageType>
+  void SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::copy_from(
+      const SparseMatrixSIMD<Number, 1, simd_length, OtherStorageType> &other)
+  {
+    Assert(other.sparsity == sparsity,
+           dealii::ExcMessage("The matrices have to share the same sparsity "
+                              "pattern"));
+
+    const unsigned int n_internal_dofs = sparsity->n_internal_dofs;
+    const std::size_t csr_start = sparsity->row_starts[n_internal_dofs];
+    const std::size_t csr_end = sparsity->n_nonzero_elements();
+
+    RYUJIN_PARALLEL_REGION_BEGIN
+
+    /* Copy all stored blocks of the vectorized part: */
+
+    RYUJIN_OMP_FOR_NOWAIT
+    for (unsigned int i = 0; i < n_internal_dofs; i += simd_length) {
+      const unsigned int simd_row = i / simd_length;
+      const unsigned int row_length = sparsity->row_length(i);
+
+      for (unsigned int col_idx = 0; col_idx < row_length; ++col_idx) {
+        if (((stored_columns[simd_row] >> col_idx) & 1) == 0)
+          continue;
+
+        const std::size_t source =
+            sparsity->row_starts[simd_row] + col_idx * simd_length;
+        const std::size_t target = block_index(simd_row, col_idx);
+        for (unsigned int k = 0; k < simd_length; ++k)
+          data[target + k] = StorageType(other.data[source + k]);
+      }
+    }
+
+    /* The CSR part is stored in full: */
+
+    RYUJIN_OMP_FOR
+    for (std::size_t index = csr_start; index < csr_end; ++index)
+      data[index - csr_shift] = StorageType(other.data[index]);
+
+    RYUJIN_PARALLEL_REGION_END
+  }
+
+
+  template <typename Number, int simd_length, typename StorageType>
+  std::size_t SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::
+      memory_consumption() const
+  {
+    std::size_t result =
+        stored_columns.memory_consumption() + row_starts.memory_consumption() +
+        data.memory_consumption() + indices_to_be_sent.memory_consumption() +
+        exchange_buffer.memory_consumption() +
+        dealii::MemoryConsumption::memory_consumption(requests);
+#ifdef USE_SHARED_MEMORY_EXCHANGE
+    if (shared_memory_exchange)
+      result += shared_memory_exchange->memory_consumption();
+#endif
+    return result;
+  }
+
+
+  template <typename Number, int simd_length, typename StorageType>
+  template <typename Archive>
+  void SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::save(
+      Archive &archive, MemoryMappedFileWriter &writer) const
+  {
+    archive << stored_columns << row_starts << csr_shift;
+    archive << indices_to_be_sent;
+    data.save(archive, writer);
+  }
+
+
+  template <typename Number, int simd_length, typename StorageType>
+  template <typename Archive>
+  void SymmetricSparseMatrixSIMD<Number, simd_length, StorageType>::load(
+      Archive &archive,
+      const SparsityPatternSIMD<simd_length> &sparsity,
+      const std::shared_ptr<const MemoryMappedFile> &file)
+  {
+    this->sparsity = &sparsity;
+#ifdef USE_SHARED_MEMORY_EXCHANGE
+    shared_memory_exchange.reset();
+#endif
+
+    archive >> stored_columns >> row_starts >> csr_shift;
+    archive >> indices_to_be_sent;
+    data.load(archive, file);
+    AssertThrow(data.size() == sparsity.n_nonzero_elements() - csr_shift,
+                dealii::ExcMessage("The stored matrix does not match the "
+                                   "sparsity pattern"));
+  }
+
 } // namespace ryujin
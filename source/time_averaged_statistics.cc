@@ -0,0 +1,13 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#include "time_averaged_statistics.template.h"
+
+namespace ryujin
+{
+  /* instantiations */
+  template class ryujin::TimeAveragedStatistics<DIM, NUMBER>;
+
+} /* namespace ryujin */
@@ -0,0 +1,193 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include <compile_time_options.h>
+
+#include "multicomponent_vector.h"
+#include "offline_data.h"
+#include "problem_description.h"
+
+#include <deal.II/base/parameter_acceptor.h>
+
+namespace ryujin
+{
+
+  /**
+   * A running accumulator for time-averaged statistics.
+   *
+   * Every "sampling interval" cycles (and after "start time") the
+   * function accumulate() updates the running mean
+   * \f$\bar x_i\f$ and the sum of squared deviations
+   * \f$M_i = \sum_n (x_i^n - \bar x_i)^2\f$ of the conserved state, the
+   * pressure, and the velocity with Welford's algorithm in a single
+   * (vectorized) pass over the locally owned degrees of freedom:
+   * \f[
+   *   \bar x_i \leftarrow \bar x_i + \frac{x_i - \bar x_i}{n}, \qquad
+   *   M_i \leftarrow M_i + (x_i - \bar x_i^{\text{old}})(x_i - \bar x_i).
+   * \f]
+   * The root mean square of the fluctuations is given by
+   * \f$\sqrt{M_i / n}\f$.
+   *
+   * The statistics are only written out at the end of the computation
+   * with write() and as part of every checkpoint with checkpoint(). A
+   * checkpoint is written with do_checkpoint_collective() and can thus be
+   * resumed on a different number of MPI ranks.
+   *
+   * @note The statistics are reset by prepare(), i.e., whenever the mesh
+   * changes.
+   *
+   * @ingroup TimeLoop
+   */
+  template <int dim, typename Number = double>
+  class TimeAveragedStatistics final : public dealii::ParameterAcceptor
+  {
+  public:
+    /**
+     * @copydoc ProblemDescription::problem_dimension
+     */
+    // clang-format off
+    static constexpr unsigned int problem_dimension = ProblemDescription::problem_dimension<dim>;
+    // clang-format on
+
+    /**
+     * The number of averaged fields: The conserved state, the pressure,
+     * and the velocity.
+     */
+    static constexpr unsigned int n_fields = problem_dimension + 1 + dim;
+
+    /**
+     * @copydoc OfflineData::scalar_type
+     */
+    using scalar_type = typename OfflineData<dim, Number>::scalar_type;
+
+    /**
+     * @copydoc OfflineData::vector_type
+     */
+    using vector_type = typename OfflineData<dim, Number>::vector_type;
+
+    /**
+     * Type used to store the statistics: The first n_fields components
+     * hold the running mean, the remaining n_fields components the sum
+     * of squared deviations from the mean.
+     */
+    using statistics_type = MultiComponentVector<Number, 2 * n_fields>;
+
+    /**
+     * Constructor.
+     */
+    TimeAveragedStatistics(
+        const MPI_Comm &mpi_communicator,
+        const ProblemDescription &problem_description,
+        const OfflineData<dim, Number> &offline_data,
+        const std::string &subsection = "TimeAveragedStatistics");
+
+    /**
+     * Return whether the accumulation of statistics is enabled, i.e.,
+     * whether "sampling interval" is nonzero.
+     */
+    bool enabled() const
+    {
+      return sampling_interval_ != 0;
+    }
+
+    /**
+     * Prepare accumulation. Allocates a vector with 2 * n_fields
+     * components per degree of freedom and resets the statistics.
+     */
+    void prepare();
+
+    /**
+     * Return the memory consumption (in bytes, of this MPI rank) of the
+     * statistics vector as a list of (name, size) pairs.
+     */
+    std::vector<std::pair<std::string, std::size_t>>
+    memory_consumption() const;
+
+    /**
+     * Accumulate the state @p U at time @p t if @p cycle is a multiple of
+     * the "sampling interval" and @p t is past the "start time".
+     * Otherwise the function returns immediately.
+     */
+    void accumulate(const vector_type &U, const Number t, unsigned int cycle);
+
+    /**
+     * Return the number of accumulated samples.
+     */
+    unsigned int n_samples() const
+    {
+      return n_samples_;
+    }
+
+    /**
+     * Return the time of the first accumulated sample.
+     */
+    Number t_start() const
+    {
+      return t_start_;
+    }
+
+    /**
+     * Return the (locally owned part of the) statistics.
+     */
+    const statistics_type &statistics() const
+    {
+      return statistics_;
+    }
+
+    /**
+     * Extract the mean (or the root mean square of the fluctuations if
+     * @p rms is true) of field @p k into the scalar vector @p vector.
+     * Constraints are distributed and ghost values are updated.
+     */
+    void extract(scalar_type &vector, unsigned int k, bool rms = false) const;
+
+    /**
+     * Write out the mean and the root mean square of the fluctuations of
+     * all fields as a pvtu record "name_000000.pvtu" for time @p t.
+     */
+    void write(const std::string &name, const Number t) const;
+
+    /**
+     * Write the statistics into a collective checkpoint file
+     * "name-checkpoint.data".
+     */
+    void checkpoint(const std::string &name) const;
+
+    /**
+     * Resume from a collective checkpoint file "name-checkpoint.data" if
+     * it exists. Returns whether the checkpoint has been found.
+     */
+    bool resume(const std::string &name);
+
+  private:
+    /**
+     * @name Run time options
+     */
+    //@{
+
+    unsigned int sampling_interval_;
+    Number start_time_;
+
+    //@}
+    /**
+     * @name Internal data
+     */
+    //@{
+
+    const MPI_Comm &mpi_communicator_;
+
+    dealii::SmartPointer<const ProblemDescription> problem_description_;
+    dealii::SmartPointer<const OfflineData<dim, Number>> offline_data_;
+
+    statistics_type statistics_;
+    unsigned int n_samples_;
+    Number t_start_;
+
+    //@}
+  };
+
+} /* namespace ryujin */
@@ -0,0 +1,256 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include "checkpointing.h"
+#include "openmp.h"
+#include "simd.h"
+#include "time_averaged_statistics.h"
+
+#include <deal.II/numerics/data_out.h>
+
+#include <filesystem>
+
+namespace ryujin
+{
+  using namespace dealii;
+
+
+  template <int dim, typename Number>
+  TimeAveragedStatistics<dim, Number>::TimeAveragedStatistics(
+      const MPI_Comm &mpi_communicator,
+      const ProblemDescription &problem_description,
+      const OfflineData<dim, Number> &offline_data,
+      const std::string &subsection /*= "TimeAveragedStatistics"*/)
+      : ParameterAcceptor(subsection)
+      , mpi_communicator_(mpi_communicator)
+      , problem_description_(&problem_description)
+      , offline_data_(&offline_data)
+      , n_samples_(0)
+      , t_start_(0.)
+  {
+    sampling_interval_ = 0;
+    add_parameter("sampling interval",
+                  sampling_interval_,
+                  "Number of cycles between two samples of the running mean "
+                  "and variance of the state, the pressure, and the "
+                  "velocity. A value of 0 disables time-averaged statistics");
+
+    start_time_ = Number(0.);
+    add_parameter("start time",
+                  start_time_,
+                  "Only accumulate statistics after this time (for example, "
+                  "after the initial transient has left the domain)");
+  }
+
+
+  template <int dim, typename Number>
+  void TimeAveragedStatistics<dim, Number>::prepare()
+  {
+#ifdef DEBUG_OUTPUT
+    std::cout << "TimeAveragedStatistics<dim, Number>::prepare()" << std::endl;
+#endif
+
+    n_samples_ = 0;
+    t_start_ = Number(0.);
+
+    if (!enabled()) {
+      statistics_.reinit(0);
+      return;
+    }
+
+    statistics_.reinit_with_scalar_partitioner(
+        offline_data_->scalar_partitioner());
+  }
+
+
+  template <int dim, typename Number>
+  std::vector<std::pair<std::string, std::size_t>>
+  TimeAveragedStatistics<dim, Number>::memory_consumption() const
+  {
+    return {{"statistics", statistics_.memory_consumption()}};
+  }
+
+
+  template <int dim, typename Number>
+  void TimeAveragedStatistics<dim, Number>::accumulate(const vector_type &U,
+                                                       const Number t,
+                                                       unsigned int cycle)
+  {
+    if (!enabled() || cycle % sampling_interval_ != 0 || t < start_time_)
+      return;
+
+#ifdef DEBUG_OUTPUT
+    std::cout << "TimeAveragedStatistics<dim, Number>::accumulate()"
+              << std::endl;
+#endif
+
+    if (n_samples_ == 0)
+      t_start_ = t;
+    ++n_samples_;
+
+    using VA = VectorizedArray<Number>;
+    constexpr auto simd_length = VA::size();
+
+    const unsigned int n_internal = offline_data_->n_locally_internal();
+    const unsigned int n_owned = offline_data_->n_locally_owned();
+    const auto &sparsity_simd = offline_data_->sparsity_pattern_simd();
+
+    const Number n_inverse = Number(1.) / Number(n_samples_);
+
+    /*
+     * Welford update of the mean and the sum of squared deviations. The
+     * values of the new sample are formed in registers from the state
+     * @p U, so this is a single streaming pass over @p U and the
+     * statistics vector:
+     */
+
+    const auto update = [&](auto &S, const auto &U_i, const auto n_inv) {
+      using T = std::remove_cv_t<std::remove_reference_t<decltype(n_inv)>>;
+
+      const auto rho_i_inverse = T(1.) / problem_description_->density(U_i);
+      const auto M_i = problem_description_->momentum(U_i);
+
+      dealii::Tensor<1, n_fields, T> x;
+      for (unsigned int c = 0; c < problem_dimension; ++c)
+        x[c] = U_i[c];
+      x[problem_dimension] = problem_description_->pressure(U_i);
+      for (unsigned int d = 0; d < dim; ++d)
+        x[problem_dimension + 1 + d] = M_i[d] * rho_i_inverse;
+
+      for (unsigned int k = 0; k < n_fields; ++k) {
+        const auto delta = x[k] - S[k];
+        S[k] += delta * n_inv;
+        S[n_fields + k] += delta * (x[k] - S[k]);
+      }
+    };
+
+    RYUJIN_PARALLEL_REGION_BEGIN
+
+    RYUJIN_OMP_FOR_NOWAIT
+    for (unsigned int i = 0; i < n_internal; i += simd_length) {
+      auto S_i = statistics_.get_vectorized_tensor(i);
+      update(S_i, U.get_vectorized_tensor(i), VA(n_inverse));
+      statistics_.write_vectorized_tensor(S_i, i);
+    }
+
+    RYUJIN_OMP_FOR
+    for (unsigned int i = n_internal; i < n_owned; ++i) {
+      /* Skip constrained degrees of freedom: */
+      if (sparsity_simd.row_length(i) == 1)
+        continue;
+
+      auto S_i = statistics_.get_tensor(i);
+      update(S_i, U.get_tensor(i), n_inverse);
+      statistics_.write_tensor(S_i, i);
+    }
+
+    RYUJIN_PARALLEL_REGION_END
+  }
+
+
+  template <int dim, typename Number>
+  void TimeAveragedStatistics<dim, Number>::extract(scalar_type &vector,
+                                                    unsigned int k,
+                                                    bool rms) const
+  {
+    Assert(k < n_fields, dealii::ExcIndexRange(k, 0, n_fields));
+
+    vector.reinit(offline_data_->scalar_partitioner());
+    statistics_.extract_component(vector, rms ? n_fields + k : k);
+
+    if (rms) {
+      const Number n_inverse =
+          n_samples_ > 0 ? Number(1.) / Number(n_samples_) : Number(0.);
+      for (auto &it : vector)
+        it = std::sqrt(std::max(it * n_inverse, Number(0.)));
+    }
+
+    offline_data_->affine_constraints().distribute(vector);
+    vector.update_ghost_values();
+  }
+
+
+  template <int dim, typename Number>
+  void TimeAveragedStatistics<dim, Number>::write(const std::string &name,
+                                                  const Number t) const
+  {
+    if (!enabled())
+      return;
+
+#ifdef DEBUG_OUTPUT
+    std::cout << "TimeAveragedStatistics<dim, Number>::write()" << std::endl;
+#endif
+
+    std::vector<std::string> names(
+        ProblemDescription::component_names<dim>.begin(),
+        ProblemDescription::component_names<dim>.end());
+    names.push_back("p");
+    for (unsigned int d = 0; d < dim; ++d)
+      names.push_back("v_" + std::to_string(d + 1));
+
+    std::array<scalar_type, 2 * n_fields> vectors;
+
+    DataOut<dim> data_out;
+    data_out.attach_dof_handler(offline_data_->dof_handler());
+    for (unsigned int k = 0; k < n_fields; ++k) {
+      extract(vectors[k], k);
+      data_out.add_data_vector(vectors[k], "mean_" + names[k]);
+      extract(vectors[n_fields + k], k, /*rms*/ true);
+      data_out.add_data_vector(vectors[n_fields + k], "rms_" + names[k]);
+    }
+
+    const auto &discretization = offline_data_->discretization();
+    data_out.build_patches(discretization.mapping(),
+                           discretization.finite_element().degree - 1);
+
+    DataOutBase::VtkFlags flags(
+        t, n_samples_, true, DataOutBase::VtkFlags::best_speed);
+    data_out.set_flags(flags);
+
+    data_out.write_vtu_with_pvtu_record("", name, 0, mpi_communicator_, 6);
+  }
+
+
+  template <int dim, typename Number>
+  void
+  TimeAveragedStatistics<dim, Number>::checkpoint(const std::string &name) const
+  {
+    if (!enabled())
+      return;
+
+    do_checkpoint_collective(name,
+                             *offline_data_,
+                             statistics_,
+                             t_start_,
+                             n_samples_,
+                             mpi_communicator_);
+  }
+
+
+  template <int dim, typename Number>
+  bool TimeAveragedStatistics<dim, Number>::resume(const std::string &name)
+  {
+    if (!enabled())
+      return false;
+
+    const bool exists =
+        Utilities::MPI::min(static_cast<unsigned int>(std::filesystem::exists(
+                                name + "-checkpoint.data")),
+                            mpi_communicator_);
+    if (!exists)
+      return false;
+
+    do_resume_collective(name,
+                         *offline_data_,
+                         statistics_,
+                         t_start_,
+                         n_samples_,
+                         mpi_communicator_);
+    return true;
+  }
+
+} /* namespace ryujin */
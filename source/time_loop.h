@@ -7,14 +7,20 @@
 
 #include <compile_time_options.h>
 
+#include "checkpointing.h"
+#include "derived_quantities.h"
 #include "discretization.h"
 #include "dissipation_module.h"
 #include "euler_module.h"
+#include "in_transit_output.h"
 #include "initial_values.h"
 #include "integral_quantities.h"
+#include "mesh_adaptor.h"
 #include "offline_data.h"
 #include "point_quantities.h"
 #include "problem_description.h"
+#include "scratch_vector_pool.h"
+#include "time_averaged_statistics.h"
 #include "vtu_output.h"
 
 #include <deal.II/base/parameter_acceptor.h>
@@ -47,9 +53,12 @@ namespace ryujin
     using vector_type = typename OfflineData<dim, Number>::vector_type;
 
     /**
-     * Constructor.
+     * Constructor. If @p in_transit_output is given (and enabled),
+     * snapshots of the state can be streamed to dedicated I/O ranks, see
+     * "enable output in transit".
      */
-    TimeLoop(const MPI_Comm &mpi_comm);
+    TimeLoop(const MPI_Comm &mpi_comm,
+             InTransitOutput *in_transit_output = nullptr);
 
     /**
      * Run the high-level time loop.
@@ -72,8 +81,10 @@ namespace ryujin
     void print_parameters(std::ostream &stream);
     void print_mpi_partition(std::ostream &stream);
     void print_memory_statistics(std::ostream &stream);
+    void print_memory_footprint(std::ostream &stream);
     void print_timers(std::ostream &stream);
     void print_throughput(unsigned int cycle, Number t, std::ostream &stream);
+    void print_cfl_classes(std::ostream &stream);
 
     void print_info(const std::string &header);
     void print_head(const std::string &header,
@@ -102,20 +113,44 @@ namespace ryujin
     Number output_granularity;
 
     bool enable_checkpointing;
+    bool asynchronous_checkpointing;
+    std::vector<double> checkpoint_error_bounds;
+    unsigned int checkpoint_flush_multiplier;
+    std::string checkpoint_local_directory;
+    bool checkpoint_partner_copy;
     bool enable_output_full;
+    bool enable_output_in_transit;
     bool enable_output_levelsets;
     bool enable_compute_error;
     bool enable_compute_quantities;
+    bool enable_trace;
+
+    unsigned int ensemble_size;
 
     unsigned int output_checkpoint_multiplier;
     unsigned int output_full_multiplier;
+    unsigned int output_in_transit_multiplier;
     unsigned int output_levelsets_multiplier;
     unsigned int output_quantities_multiplier;
 
     bool resume;
+    unsigned int resume_coarse_levels;
+
+    unsigned int splitting_max_hyperbolic_steps;
+    Number splitting_tolerance;
+
+    Number steady_state_tolerance;
+    unsigned int steady_state_plateau_cycles;
+
+    bool stream_integral_quantities;
 
     unsigned int terminal_update_interval;
 
+    unsigned int trace_max_events;
+
+    double peak_flop_rate;
+    double peak_memory_bandwidth;
+
     //@}
     /**
      * @name Internal data:
@@ -129,18 +164,27 @@ namespace ryujin
     ryujin::ProblemDescription problem_description;
     ryujin::Discretization<dim> discretization;
     ryujin::OfflineData<dim, Number> offline_data;
+    ryujin::ScratchVectorPool scratch_vector_pool;
     ryujin::InitialValues<dim, Number> initial_values;
     ryujin::EulerModule<dim, Number> euler_module;
     ryujin::DissipationModule<dim, Number> dissipation_module;
+    ryujin::DerivedQuantities<dim, Number> derived_quantities;
     ryujin::VTUOutput<dim, Number> vtu_output;
     ryujin::PointQuantities<dim, Number> point_quantities;
     ryujin::IntegralQuantities<dim, Number> integral_quantities;
+    ryujin::TimeAveragedStatistics<dim, Number> time_averaged_statistics;
+    ryujin::MeshAdaptor<dim, Number> mesh_adaptor;
+    ryujin::AsynchronousCheckpointing<dim, Number> checkpointing;
+    ryujin::InTransitOutput *in_transit_output;
 
     const unsigned int mpi_rank;
     const unsigned int n_mpi_processes;
 
     std::ofstream logfile; /* log file */
 
+    /* Number of hyperbolic steps per half step of the Strang splitting: */
+    unsigned int n_splitting_steps;
+
     //@}
   };
 
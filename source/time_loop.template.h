@@ -20,15 +20,22 @@
 #include <deal.II/numerics/vector_tools.h>
 #include <deal.II/numerics/vector_tools.templates.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <fstream>
 #include <iomanip>
+#include <limits>
+#include <memory>
+#include <set>
 
 using namespace dealii;
 
 namespace ryujin
 {
   template <int dim, typename Number>
-  TimeLoop<dim, Number>::TimeLoop(const MPI_Comm &mpi_comm)
+  TimeLoop<dim, Number>::TimeLoop(const MPI_Comm &mpi_comm,
+                                  InTransitOutput *in_transit_output)
       : ParameterAcceptor("/A - TimeLoop")
       , mpi_communicator(mpi_comm)
       , problem_description("/B - ProblemDescription")
@@ -40,25 +47,43 @@ namespace ryujin
                      offline_data,
                      problem_description,
                      initial_values,
+                     scratch_vector_pool,
                      "/F - EulerModule")
       , dissipation_module(mpi_communicator,
                            computing_timer,
                            problem_description,
                            offline_data,
                            initial_values,
+                           scratch_vector_pool,
                            "/G - DissipationModule")
-      , vtu_output(mpi_communicator, offline_data, "/H - VTUOutput")
+      , derived_quantities(mpi_communicator, problem_description, offline_data)
+      , vtu_output(mpi_communicator,
+                   offline_data,
+                   derived_quantities,
+                   scratch_vector_pool,
+                   "/H - VTUOutput")
       , point_quantities(mpi_communicator,
                          problem_description,
                          offline_data,
+                         derived_quantities,
                          "/I - PointQuantities")
       , integral_quantities(mpi_communicator,
                             problem_description,
                             offline_data,
+                            derived_quantities,
                             "/I - IntegralQuantities")
+      , time_averaged_statistics(mpi_communicator,
+                                 problem_description,
+                                 offline_data,
+                                 "/K - TimeAveragedStatistics")
+      , mesh_adaptor(
+            mpi_communicator, offline_data, euler_module, "/J - MeshAdaptor")
+      , checkpointing(mpi_communicator)
+      , in_transit_output(in_transit_output)
       , mpi_rank(dealii::Utilities::MPI::this_mpi_process(mpi_communicator))
       , n_mpi_processes(
             dealii::Utilities::MPI::n_mpi_processes(mpi_communicator))
+      , n_splitting_steps(1)
   {
     base_name = "cylinder";
     add_parameter("basename", base_name, "Base name for all output files");
@@ -88,12 +113,59 @@ namespace ryujin
         "at output granularity intervals. The frequency is determined by "
         "\"output granularity\" times \"output checkpoint multiplier\"");
 
+    asynchronous_checkpointing = true;
+    add_parameter("asynchronous checkpointing",
+                  asynchronous_checkpointing,
+                  "Copy the state into a staging buffer and write out "
+                  "checkpoints in a background thread. Only the next "
+                  "checkpoint has to wait for the previous one to complete");
+
+    add_parameter(
+        "checkpoint error bounds",
+        checkpoint_error_bounds,
+        "List of absolute error bounds (one per conserved component) for "
+        "error-bounded lossy compression of checkpoints (one archive per "
+        "rank). An empty list writes lossless checkpoints into a single "
+        "file with collective MPI IO that can be resumed on a different "
+        "number of ranks. Resuming requires the same setting");
+
+    checkpoint_flush_multiplier = 1;
+    add_parameter("checkpoint flush multiplier",
+                  checkpoint_flush_multiplier,
+                  "If node-local checkpointing is enabled, only every n-th "
+                  "checkpoint is also written to the parallel filesystem");
+
+    add_parameter(
+        "checkpoint local directory",
+        checkpoint_local_directory,
+        "If nonempty, write every checkpoint to this node-local directory "
+        "(for example a RAM disk or SSD) in addition to the parallel "
+        "filesystem. The frequency of the latter is further modified by "
+        "\"checkpoint flush multiplier\"");
+
+    checkpoint_partner_copy = true;
+    add_parameter("checkpoint partner copy",
+                  checkpoint_partner_copy,
+                  "Store a copy of every node-local checkpoint on a partner "
+                  "rank on a different node so that a computation can be "
+                  "resumed after the loss of a single node");
+
     enable_output_full = false;
     add_parameter("enable output full",
                   enable_output_full,
                   "Write out full pvtu records. The frequency is determined by "
                   "\"output granularity\" times \"output full multiplier\"");
 
+    enable_output_in_transit = false;
+    add_parameter("enable output in transit",
+                  enable_output_in_transit,
+                  "Stream snapshots of the state to dedicated I/O ranks that "
+                  "write them out (in the collective checkpoint format) off "
+                  "the critical path. The number of I/O ranks per node is "
+                  "set by the environment variable RYUJIN_IO_RANKS_PER_NODE. "
+                  "The frequency is determined by \"output granularity\" "
+                  "times \"output in transit multiplier\"");
+
     enable_output_levelsets = false;
     add_parameter(
         "enable output levelsets",
@@ -108,6 +180,16 @@ namespace ryujin
                   "the difference to an analytic solution. Implemented only "
                   "for certain initial state configurations.");
 
+    ensemble_size = 1;
+    add_parameter("ensemble size",
+                  ensemble_size,
+                  "Number of independent states (ensemble members) advanced "
+                  "on the same mesh with shared offline data. Member k is "
+                  "initialized with member k of the initial values and "
+                  "writes its output files with the base name augmented by "
+                  "\"-member_k\". Quantities of interest, time-averaged "
+                  "statistics, and errors are only computed for member 0");
+
     enable_compute_quantities = false;
     add_parameter(
         "enable compute quantities",
@@ -116,6 +198,13 @@ namespace ryujin
         "frequency how often quantities are logged is determined by \"output "
         "granularity\" times \"output quantities multiplier\"");
 
+    enable_trace = false;
+    add_parameter("enable trace",
+                  enable_trace,
+                  "Record a per-rank event trace of all timer scopes, ghost "
+                  "exchanges, and linear solver iteration counts and write it "
+                  "out in the Chrome trace event format");
+
     output_checkpoint_multiplier = 1;
     add_parameter("output checkpoint multiplier",
                   output_checkpoint_multiplier,
@@ -128,6 +217,12 @@ namespace ryujin
                   "Multiplicative modifier applied to \"output granularity\" "
                   "that determines the full pvtu writeout granularity");
 
+    output_in_transit_multiplier = 1;
+    add_parameter("output in transit multiplier",
+                  output_in_transit_multiplier,
+                  "Multiplicative modifier applied to \"output granularity\" "
+                  "that determines the in-transit snapshot granularity");
+
     output_levelsets_multiplier = 1;
     add_parameter("output levelsets multiplier",
                   output_levelsets_multiplier,
@@ -144,11 +239,82 @@ namespace ryujin
     resume = false;
     add_parameter("resume", resume, "Resume an interrupted computation");
 
+    resume_coarse_levels = 0;
+    add_parameter("resume coarse levels",
+                  resume_coarse_levels,
+                  "If nonzero (and \"resume\" is set), resume from a "
+                  "lossless checkpoint of a computation on a mesh with this "
+                  "many global refinements less. The state is transferred "
+                  "to the current mesh by interpolation, for example, to "
+                  "skip the spin-up transient on a fine mesh");
+
+    splitting_max_hyperbolic_steps = 1;
+    add_parameter("splitting max hyperbolic steps",
+                  splitting_max_hyperbolic_steps,
+                  "Navier Stokes: Maximal number of explicit hyperbolic steps "
+                  "on either side of a dissipation solve in the Strang "
+                  "splitting. The dissipation step then covers the combined "
+                  "time step size of both halves");
+
+    splitting_tolerance = Number(0.);
+    add_parameter("splitting tolerance",
+                  splitting_tolerance,
+                  "Navier Stokes: If nonzero, adapt the number of hyperbolic "
+                  "steps per dissipation solve (between one and \"splitting "
+                  "max hyperbolic steps\") such that the relative momentum "
+                  "update of a dissipation step stays below this tolerance. "
+                  "If zero, always use the maximal number of steps");
+
+    steady_state_tolerance = Number(0.);
+    add_parameter("steady state tolerance",
+                  steady_state_tolerance,
+                  "If nonzero, monitor the steady-state residual (see "
+                  "EulerModule::request_residual()) in every cycle, write "
+                  "the convergence history to \"basename-convergence.log\" "
+                  "and stop as soon as the residual has dropped below this "
+                  "tolerance relative to the residual of the first cycle. "
+                  "Use together with \"local time stepping\"");
+
+    steady_state_plateau_cycles = 0;
+    add_parameter("steady state plateau cycles",
+                  steady_state_plateau_cycles,
+                  "If nonzero, monitor the steady-state residual and stop "
+                  "if its minimum has not decreased by at least one percent "
+                  "within this number of cycles");
+
+    stream_integral_quantities = false;
+    add_parameter("stream integral quantities",
+                  stream_integral_quantities,
+                  "If enabled (and \"enable compute quantities\" is set), the "
+                  "integral quantities are accumulated in every cycle as a "
+                  "by-product of the time step and written out every cycle "
+                  "instead of at the output granularity");
+
     terminal_update_interval = 10;
     add_parameter("terminal update interval",
                   terminal_update_interval,
                   "number of cycles after which output statistics are "
                   "recomputed and printed on the terminal");
+
+    peak_flop_rate = 0.;
+    add_parameter("peak flop rate",
+                  peak_flop_rate,
+                  "Peak floating point performance (in GFlop/s) per MPI "
+                  "rank. If nonzero, the modeled flop rate of all kernels "
+                  "is also reported relative to this peak");
+
+    peak_memory_bandwidth = 0.;
+    add_parameter("peak memory bandwidth",
+                  peak_memory_bandwidth,
+                  "Peak memory bandwidth (in GB/s) per MPI rank. If nonzero, "
+                  "the modeled memory bandwidth of all kernels is also "
+                  "reported relative to this peak");
+
+    trace_max_events = 1000000;
+    add_parameter("trace max events",
+                  trace_max_events,
+                  "Maximal number of events recorded per rank if \"enable "
+                  "trace\" is set. Subsequent events are dropped");
   }
 
 
@@ -162,8 +328,78 @@ namespace ryujin
     AssertThrow(!enable_checkpointing || !enable_compute_error,
                 ExcNotImplemented());
 
-    const bool write_output_files =
-        enable_checkpointing || enable_output_full || enable_output_levelsets;
+    AssertThrow(!enable_checkpointing ||
+                    mesh_adaptor.adaptation_interval() == 0,
+                ExcMessage("Checkpointing is not supported in combination "
+                           "with adaptive mesh refinement"));
+
+    AssertThrow(checkpoint_flush_multiplier >= 1,
+                ExcMessage("The checkpoint flush multiplier must be at "
+                           "least one"));
+
+    AssertThrow(checkpoint_error_bounds.empty() ||
+                    checkpoint_error_bounds.size() ==
+                        ProblemDescription::problem_dimension<dim>,
+                ExcMessage("The number of checkpoint error bounds must match "
+                           "the number of conserved components"));
+
+    AssertThrow(resume_coarse_levels == 0 || checkpoint_error_bounds.empty(),
+                ExcMessage("Resuming from a coarser mesh requires a lossless "
+                           "checkpoint"));
+
+    AssertThrow(!euler_module.local_time_stepping() ||
+                    problem_description.description() == "Euler",
+                ExcMessage("Local time stepping is only supported for the "
+                           "Euler equations"));
+
+    AssertThrow(ensemble_size >= 1,
+                ExcMessage("The ensemble size must be at least one"));
+
+    AssertThrow(splitting_max_hyperbolic_steps >= 1,
+                ExcMessage("The maximal number of hyperbolic steps per "
+                           "dissipation solve must be at least one"));
+
+    /* Start adaptive splitting schedules with a single hyperbolic step: */
+    n_splitting_steps = splitting_tolerance > Number(0.)
+                            ? 1
+                            : splitting_max_hyperbolic_steps;
+
+    AssertThrow(ensemble_size == 1 || (!enable_checkpointing && !resume),
+                ExcMessage("Checkpointing is not supported in combination "
+                           "with ensemble runs"));
+
+    /*
+     * All ensemble members share the modules. Reject all options that
+     * carry state from one time step to the next:
+     */
+    AssertThrow(ensemble_size == 1 || !euler_module.cfl_adaptive(),
+                ExcMessage("An adaptive CFL number is not supported in "
+                           "combination with ensemble runs"));
+
+    AssertThrow(ensemble_size == 1 ||
+                    euler_module.lambda_max_reuse_tolerance() == Number(0.),
+                ExcMessage("The reuse of lambda_max is not supported in "
+                           "combination with ensemble runs"));
+
+    AssertThrow(ensemble_size == 1 ||
+                    dissipation_module.initial_guess_extrapolation() == 0,
+                ExcMessage("The initial guess extrapolation is not "
+                           "supported in combination with ensemble runs"));
+
+    AssertThrow(ensemble_size == 1 || splitting_tolerance == Number(0.),
+                ExcMessage("An adaptive splitting schedule is not supported "
+                           "in combination with ensemble runs"));
+
+    AssertThrow(!enable_output_in_transit ||
+                    (in_transit_output != nullptr &&
+                     in_transit_output->enabled()),
+                ExcMessage("In-transit output requires dedicated I/O ranks, "
+                           "see RYUJIN_IO_RANKS_PER_NODE"));
+
+    const bool write_output_files = enable_checkpointing ||
+                                    enable_output_full ||
+                                    enable_output_in_transit ||
+                                    enable_output_levelsets;
 
     /* Attach log file: */
     if (mpi_rank == 0)
@@ -171,26 +407,83 @@ namespace ryujin
 
     print_parameters(logfile);
 
+    if (enable_trace) {
+      MPI_Barrier(mpi_communicator);
+      Trace::enable(trace_max_events);
+    }
+
     Number t = 0.;
     unsigned int output_cycle = 0;
     vector_type U;
 
+    /*
+     * The remaining members of an ensemble run: All members share the
+     * mesh, the offline data, and all modules (and thus all temporary
+     * storage). Every member carries its own time and output cycle.
+     */
+    std::vector<vector_type> U_members(ensemble_size - 1);
+    std::vector<Number> t_members(ensemble_size - 1, t);
+    std::vector<unsigned int> output_cycle_members(ensemble_size - 1, 1);
+
+    const auto state = [&](const unsigned int k) -> vector_type & {
+      return k == 0 ? U : U_members[k - 1];
+    };
+
+    const auto member_name = [&](const unsigned int k) {
+      return base_name + "-member_" + Utilities::int_to_string(k, 3);
+    };
+
     /* Prepare data structures: */
 
     const auto prepare_compute_kernels = [&]() {
+      /* All pooled vectors refer to the MPI partitioners of the old mesh: */
+      scratch_vector_pool.clear();
       offline_data.prepare();       // Storage: dim + 2 matrices; 2 vectors
-      euler_module.prepare();       // Storage: 3 * dim + 9 vectors
-      dissipation_module.prepare(); // Storage: 2 * dim + 2 vectors
-      vtu_output.prepare();         // Storage: dim + 5 vectors
+      euler_module.prepare();       // Storage: 2 * dim + 6 vectors
+      dissipation_module.prepare(); // Storage: 2 * dim vectors
+      vtu_output.prepare();         // Storage: none (pooled)
       point_quantities.prepare();   // Storage: 3 * dim + 1 vectors
+      derived_quantities.prepare(); // Storage: dim + 4 vectors
+      /* Storage: 4 * dim + 6 vectors (if enabled) */
+      time_averaged_statistics.prepare();
       print_mpi_partition(logfile);
+      print_memory_footprint(logfile);
+    };
+
+    /* Interpolate all states onto the mesh created by change_mesh(): */
+
+    const auto transfer_states = [&](const auto &change_mesh) {
+      std::vector<std::unique_ptr<SolutionTransfer<dim, Number>>> transfers;
+      for (unsigned int k = 0; k < ensemble_size; ++k) {
+        transfers.emplace_back(std::make_unique<SolutionTransfer<dim, Number>>(
+            offline_data, problem_description));
+        transfers.back()->prepare_for_interpolation(state(k));
+      }
+
+      change_mesh();
+      prepare_compute_kernels();
+
+      for (unsigned int k = 0; k < ensemble_size; ++k)
+        transfers[k]->interpolate(state(k));
+    };
+
+    /* Refine the mesh globally and interpolate U onto the new mesh: */
+
+    const auto refine_globally = [&]() {
+      auto &triangulation = discretization.triangulation();
+      for (auto &cell : triangulation.active_cell_iterators())
+        cell->set_refine_flag();
+      triangulation.prepare_coarsening_and_refinement();
+
+      transfer_states(
+          [&]() { triangulation.execute_coarsening_and_refinement(); });
     };
 
     {
       Scope scope(computing_timer, "(re)initialize data structures");
       print_info("initializing data structures");
 
-      discretization.prepare();
+      discretization.prepare(resume ? resume_coarse_levels : 0);
       prepare_compute_kernels();
       if (enable_compute_quantities)
         integral_quantities.prepare(base_name + "-integral_quantities.log");
@@ -201,7 +494,33 @@ namespace ryujin
         print_info("resuming interrupted computation");
         const auto id =
             discretization.triangulation().locally_owned_subdomain();
-        do_resume(base_name, id, U, t, output_cycle);
+        const bool resumed_locally =
+            resume_coarse_levels == 0 && !checkpoint_local_directory.empty() &&
+            do_resume_multilevel(checkpoint_local_directory,
+                                 base_name,
+                                 U,
+                                 t,
+                                 output_cycle,
+                                 checkpoint_partner_copy,
+                                 checkpoint_error_bounds,
+                                 mpi_communicator);
+        if (resumed_locally)
+          print_info("resumed from node-local checkpoint");
+        else if (checkpoint_error_bounds.empty())
+          do_resume_collective(
+              base_name, offline_data, U, t, output_cycle, mpi_communicator);
+        else
+          do_resume(
+              base_name, id, U, t, output_cycle, checkpoint_error_bounds);
+
+        if (resume_coarse_levels != 0) {
+          print_info("interpolating checkpoint onto the refined mesh");
+          for (unsigned int k = 0; k < resume_coarse_levels; ++k)
+            refine_globally();
+        } else if (time_averaged_statistics.resume(base_name +
+                                                   "-statistics")) {
+          print_info("resumed time-averaged statistics");
+        }
         t_initial = t;
       } else {
         print_info("interpolating initial values");
@@ -218,6 +537,16 @@ namespace ryujin
                            i);
         }
 #endif
+        for (unsigned int k = 1; k < ensemble_size; ++k) {
+          initial_values.set_ensemble_member(k);
+          U_members[k - 1] = initial_values.interpolate(offline_data);
+          if (write_output_files)
+            output(U_members[k - 1],
+                   member_name(k) + "-solution",
+                   t,
+                   /*cycle*/ 0);
+        }
+        initial_values.set_ensemble_member(0);
       }
     }
 
@@ -227,6 +556,116 @@ namespace ryujin
     /* Loop: */
 
     unsigned int cycle = 1;
+
+    /* Monitor the steady-state residual (of member 0) if requested: */
+
+    const bool monitor_steady_state = steady_state_tolerance > Number(0.) ||
+                                      steady_state_plateau_cycles != 0;
+
+    std::ofstream convergence_log;
+    if (monitor_steady_state && mpi_rank == 0) {
+      convergence_log.open(base_name + "-convergence.log");
+      convergence_log << "# cycle\tt\tresidual\trelative residual"
+                      << std::endl;
+    }
+
+    Number residual_initial = Number(0.);
+    Number residual_min = std::numeric_limits<Number>::max();
+    unsigned int cycle_min = 0;
+    bool steady_state_reached = false;
+    bool steady_state_output_pending = false;
+
+    /* Perform a (split) time step of a single state: */
+
+    std::vector<Number> taus;
+
+    const auto advance = [&](vector_type &U_k,
+                             Number &t_k,
+                             const bool stream_integrals) {
+      if (stream_integrals)
+        euler_module.request_integrals();
+
+      if (problem_description.description() == "Euler") {
+
+        /* Pure hyperbolic update: */
+        const auto tau = euler_module.step(U_k, t_k);
+        if (stream_integrals)
+          integral_quantities.write(euler_module.integrals(), t_k);
+        t_k += tau;
+
+      } else if (problem_description.description() == "Navier Stokes") {
+
+        /*
+         * Strang's splitting: We perform n_splitting_steps explicit steps,
+         * a single dissipation solve over the combined time step size of
+         * both halves, and then cover the same time interval with
+         * explicit steps again:
+         */
+        taus.clear();
+        Number tau_sum = Number(0.);
+        for (unsigned int s = 0; s < n_splitting_steps; ++s) {
+          const auto tau = euler_module.step(U_k, t_k + tau_sum);
+          if (s == 0 && stream_integrals)
+            integral_quantities.write(euler_module.integrals(), t_k);
+          taus.push_back(tau);
+          tau_sum += tau;
+        }
+
+        dissipation_module.step(U_k, t_k, 2. * tau_sum, cycle);
+
+        /*
+         * The step sizes of the second half are prescribed and thus only
+         * have the margin cfl_max / cfl with respect to the admissible
+         * step sizes of the (different) states of the second half. We
+         * therefore cap every step at the smallest admissible step size
+         * over the first half and subdivide the interval uniformly:
+         */
+        const auto tau_min = *std::min_element(taus.begin(), taus.end());
+        const auto n_second_half =
+            static_cast<unsigned int>(std::ceil(tau_sum / tau_min));
+        const auto tau_second_half = tau_sum / Number(n_second_half);
+
+        Number t_second_half = t_k + tau_sum;
+        for (unsigned int s = 0; s < n_second_half; ++s) {
+          euler_module.step(U_k, t_second_half, tau_second_half);
+          t_second_half += tau_second_half;
+        }
+        t_k += 2. * tau_sum;
+
+        /*
+         * Adapt the schedule: Take fewer hyperbolic steps per dissipation
+         * solve if the relative momentum update of the dissipation step
+         * exceeds the tolerance, and more if it is well below:
+         */
+        if (splitting_tolerance > Number(0.)) {
+          const auto increment = dissipation_module.relative_increment();
+          if (increment > splitting_tolerance && n_splitting_steps > 1)
+            --n_splitting_steps;
+          else if (increment < Number(0.5) * splitting_tolerance &&
+                   n_splitting_steps < splitting_max_hyperbolic_steps)
+            ++n_splitting_steps;
+        }
+
+      } else if (problem_description.description() == "Euler IMEX") {
+
+        /*
+         * Strang's splitting of the explicit (pressureless) transport and
+         * the implicit acoustic update. The time step size is set by the
+         * advective wave speeds only:
+         */
+        const auto tau = euler_module.step(U_k, t_k);
+        if (stream_integrals)
+          integral_quantities.write(euler_module.integrals(), t_k);
+        dissipation_module.acoustic_step(U_k, t_k, 2. * tau);
+        euler_module.step(U_k, t_k + tau, tau);
+        t_k += 2. * tau;
+
+      } else {
+
+        AssertThrow(false, ExcMessage("Unknown problem description"));
+      }
+    };
+
     for (;; ++cycle) {
 
 #ifdef DEBUG_OUTPUT
@@ -235,7 +674,9 @@ namespace ryujin
 
       /* Perform output: */
 
-      if (t >= output_cycle * output_granularity) {
+      if (t >= output_cycle * output_granularity ||
+          steady_state_output_pending) {
+        steady_state_output_pending = false;
         if (write_output_files) {
           output(U, base_name + "-solution", t, output_cycle);
           if (enable_compute_error) {
@@ -248,7 +689,8 @@ namespace ryujin
           Scope scope(computing_timer, "quantities of interest");
           point_quantities.compute(
               U, t, base_name + "-point_quantities", output_cycle);
-          integral_quantities.compute(U, t);
+          if (!stream_integral_quantities)
+            integral_quantities.compute(U, t);
         }
         ++output_cycle;
       }
@@ -263,50 +705,128 @@ namespace ryujin
             Scope scope(computing_timer, "(re)initialize data structures");
 
             print_info("performing global refinement");
+            refine_globally();
 
-            SolutionTransfer<dim, Number> solution_transfer(
-                offline_data, problem_description);
+            return true;
+          });
+      t_refinements.erase(new_end, t_refinements.end());
 
-            auto &triangulation = discretization.triangulation();
-            for (auto &cell : triangulation.active_cell_iterators())
-              cell->set_refine_flag();
-            triangulation.prepare_coarsening_and_refinement();
+      /* Perform adaptive mesh refinement: */
 
-            solution_transfer.prepare_for_interpolation(U);
+      if (mesh_adaptor.need_adaptation(cycle)) {
+        Scope scope(computing_timer, "(re)initialize data structures");
 
-            triangulation.execute_coarsening_and_refinement();
-            prepare_compute_kernels();
+        print_info("performing adaptive mesh refinement");
 
-            solution_transfer.interpolate(U);
+        auto &triangulation = discretization.triangulation();
+        mesh_adaptor.mark_cells(triangulation);
+        triangulation.prepare_coarsening_and_refinement();
 
-            return true;
-          });
-      t_refinements.erase(new_end, t_refinements.end());
+        transfer_states(
+            [&]() { triangulation.execute_coarsening_and_refinement(); });
+      }
 
-      /* Break if we have reached the final time: */
+      /* Perform dynamic load balancing: */
 
-      if (t >= t_final)
-        break;
+      if (mesh_adaptor.need_rebalancing(cycle, computing_timer)) {
+        Scope scope(computing_timer, "(re)initialize data structures");
 
-      /* Do a time step: */
+        std::stringstream message;
+        message << "repartitioning the mesh (imbalance "
+                << std::setprecision(2) << std::fixed
+                << mesh_adaptor.imbalance() << ", boundary cell weight "
+                << mesh_adaptor.boundary_cell_weight() << ")";
+        print_info(message.str());
 
-      if (problem_description.description() == "Euler") {
+        discretization.set_boundary_cell_weight(
+            mesh_adaptor.boundary_cell_weight());
 
-        /* Pure hyperbolic update: */
-        const auto tau = euler_module.step(U, t);
-        t += tau;
+        transfer_states(
+            [&]() { discretization.triangulation().repartition(); });
+      }
 
-      } else if (problem_description.description() == "Navier Stokes") {
+      /* Break if all ensemble members have reached the final time: */
 
-        /* Strang's splitting: */
-        const auto tau = euler_module.step(U, t);
-        dissipation_module.step(U, t, 2. * tau, cycle);
-        euler_module.step(U, t + tau, tau);
-        t += 2. * tau;
+      if ((t >= t_final || steady_state_reached) &&
+          std::all_of(t_members.begin(), t_members.end(), [&](Number t_k) {
+            return t_k >= t_final;
+          }))
+        break;
 
-      } else {
+      /*
+       * Advance the remaining ensemble members. Their output is written
+       * right after their own time step because the residual viscosity
+       * refers to the last time step performed by the EulerModule. For
+       * the same reason member 0 is advanced last:
+       */
+
+      for (unsigned int k = 1; k < ensemble_size; ++k) {
+        auto &U_k = U_members[k - 1];
+        auto &t_k = t_members[k - 1];
+        auto &output_cycle_k = output_cycle_members[k - 1];
+        if (t_k >= t_final)
+          continue;
+
+        initial_values.set_ensemble_member(k);
+        advance(U_k, t_k, /*stream_integrals*/ false);
+
+        if (t_k >= output_cycle_k * output_granularity) {
+          if (write_output_files)
+            output(U_k, member_name(k) + "-solution", t_k, output_cycle_k);
+          ++output_cycle_k;
+        }
+      }
+      initial_values.set_ensemble_member(0);
 
-        AssertThrow(false, ExcMessage("Unknown problem description"));
+      /* Do a time step: */
+
+      if (t < t_final && !steady_state_reached) {
+        if (monitor_steady_state)
+          euler_module.request_residual();
+
+        advance(U,
+                t,
+                enable_compute_quantities && stream_integral_quantities);
+        time_averaged_statistics.accumulate(U, t, cycle);
+
+        /* Check for convergence to a steady state: */
+        if (monitor_steady_state) {
+          const Number residual = euler_module.residual();
+          if (residual_initial == Number(0.))
+            residual_initial = residual;
+          const Number relative = residual_initial > Number(0.)
+                                      ? residual / residual_initial
+                                      : Number(0.);
+
+          if (mpi_rank == 0)
+            convergence_log << cycle << "\t" << t << "\t" << residual << "\t"
+                            << relative << "\n";
+
+          if (residual < Number(0.99) * residual_min) {
+            residual_min = residual;
+            cycle_min = cycle;
+          }
+
+          const bool converged = relative < steady_state_tolerance;
+          const bool stagnated =
+              steady_state_plateau_cycles != 0 &&
+              cycle - cycle_min >= steady_state_plateau_cycles;
+
+          if (converged || stagnated) {
+            steady_state_reached = true;
+            steady_state_output_pending = true;
+
+            std::stringstream message;
+            message << (converged ? "steady state reached"
+                                  : "steady-state residual stagnated")
+                    << " after " << cycle << " cycles (relative residual "
+                    << std::scientific << std::setprecision(2) << relative
+                    << ")";
+            print_info(message.str());
+            if (mpi_rank == 0)
+              logfile << std::endl << message.str() << std::endl;
+          }
+        }
       }
 
       /* Print and record cycle statistics: */
@@ -319,8 +839,24 @@ namespace ryujin
         print_cycle_statistics(cycle, t, output_cycle);
     } /* end of loop */
 
-    /* Wait for output thread: */
+    /* Wait for output thread and pending checkpoint: */
     vtu_output.wait();
+    checkpointing.wait();
+
+    /* Write out time-averaged statistics: */
+    if (time_averaged_statistics.enabled()) {
+      Scope scope(computing_timer, "output statistics");
+      print_info("writing time-averaged statistics");
+      time_averaged_statistics.write(base_name + "-statistics", t);
+      if (enable_compute_quantities)
+        point_quantities.compute_averages(
+            time_averaged_statistics, t, base_name + "-point_quantities");
+    }
+
+    if (enable_trace)
+      Trace::write(base_name + "-trace-" +
+                       dealii::Utilities::int_to_string(mpi_rank, 4) + ".json",
+                   mpi_rank);
 
     /* We have actually performed one cycle less. */
     --cycle;
@@ -476,17 +1012,17 @@ namespace ryujin
         (cycle % output_levelsets_multiplier == 0) && enable_output_levelsets;
     const bool do_checkpointing =
         (cycle % output_checkpoint_multiplier == 0) && enable_checkpointing;
+    const bool do_in_transit =
+        (cycle % output_in_transit_multiplier == 0) && enable_output_in_transit;
 
     /* There is nothing to do: */
-    if (!(do_full_output || do_levelsets || do_checkpointing))
+    if (!(do_full_output || do_levelsets || do_checkpointing || do_in_transit))
       return;
 
-    /* Wait for a previous thread to finish before scheduling a new one: */
-    {
-      Scope scope(computing_timer, "output stall");
-      print_info("waiting for previous output cycle to finish");
-
-      vtu_output.wait();
+    /* In-transit snapshot: */
+    if (do_in_transit) {
+      Scope scope(computing_timer, "output in transit");
+      in_transit_output->push(name, offline_data, U, t, cycle);
     }
 
     /* Data output: */
@@ -510,8 +1046,41 @@ namespace ryujin
       Scope scope(computing_timer, "checkpointing");
       print_info("scheduling checkpointing");
 
-      const auto id = discretization.triangulation().locally_owned_subdomain();
-      do_checkpoint(base_name, id, U, t, cycle);
+      /* Statistics are always written synchronously with MPI IO: */
+      time_averaged_statistics.checkpoint(base_name + "-statistics");
+
+      const bool multilevel = !checkpoint_local_directory.empty();
+      if (multilevel)
+        do_checkpoint_multilevel(checkpoint_local_directory,
+                                 base_name,
+                                 U,
+                                 t,
+                                 cycle,
+                                 checkpoint_partner_copy,
+                                 checkpoint_error_bounds,
+                                 mpi_communicator);
+
+      /* Flush to the parallel filesystem: */
+
+      const auto n_checkpoint = cycle / output_checkpoint_multiplier;
+      if (multilevel && n_checkpoint % checkpoint_flush_multiplier != 0)
+        return;
+
+      if (asynchronous_checkpointing) {
+        checkpointing.schedule(base_name,
+                               offline_data,
+                               U,
+                               t,
+                               cycle,
+                               checkpoint_error_bounds);
+      } else if (checkpoint_error_bounds.empty()) {
+        do_checkpoint_collective(
+            base_name, offline_data, U, t, cycle, mpi_communicator);
+      } else {
+        const auto id =
+            discretization.triangulation().locally_owned_subdomain();
+        do_checkpoint(base_name, id, U, t, cycle, checkpoint_error_bounds);
+      }
     }
   }
 
@@ -554,12 +1123,68 @@ namespace ryujin
     stream << "SIMD width == " << "(( disabled ))" << std::endl;
 #endif
 
+#ifdef RYUJIN_ISA_VARIANT
+    stream << "ISA variant == " << RYUJIN_ISA_VARIANT << std::endl;
+#else
+    stream << "ISA variant == " << "baseline" << std::endl;
+#endif
+
 #ifdef USE_CUSTOM_POW
     stream << "serial pow == broadcasted pow(Vec4f)/pow(Vec2d)" << std::endl;
 #else
     stream << "serial pow == std::pow"<< std::endl;
 #endif
 
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+    stream << "d_ij, d_ii, tau_max == fused single sweep" << std::endl;
+#else
+    stream << "d_ij, d_ii, tau_max == two sweeps" << std::endl;
+#endif
+
+#ifdef USE_BATCHED_RIEMANN_SOLVER
+    stream << "d_ij (non-vectorized range) == batched SIMD Riemann solver"
+           << std::endl;
+#else
+    stream << "d_ij (non-vectorized range) == serial Riemann solver"
+           << std::endl;
+#endif
+
+#ifdef USE_SYMMETRIC_STORAGE
+    stream << "d_ij, beta_ij storage == upper triangular part" << std::endl;
+#else
+    stream << "d_ij, beta_ij storage == full" << std::endl;
+#endif
+
+#ifdef USE_MIXED_PRECISION_BOUNDS
+    stream << "limiter bounds storage type == float" << std::endl;
+#else
+    stream << "limiter bounds storage type == NUMBER" << std::endl;
+#endif
+
+#ifdef USE_MIXED_PRECISION_STORAGE
+    stream << "m_ij, c_ij, beta_ij storage type == float" << std::endl;
+#else
+    stream << "m_ij, c_ij, beta_ij storage type == NUMBER" << std::endl;
+#endif
+
+#ifdef USE_ON_THE_FLY_CIJ
+    stream << "c_ij (vectorized range) == recomputed on the fly" << std::endl;
+#else
+    stream << "c_ij (vectorized range) == loaded from memory" << std::endl;
+#endif
+
+#ifdef USE_PIPELINED_COMMUNICATION
+    stream << "ghost exchange == pipelined with the next step" << std::endl;
+#else
+    stream << "ghost exchange == completed after each step" << std::endl;
+#endif
+
+#ifdef USE_COMMUNICATION_PROGRESS_THREAD
+    stream << "MPI progress == dedicated progress thread" << std::endl;
+#else
+    stream << "MPI progress == MPI library" << std::endl;
+#endif
+
     stream << "Indicator<dim, Number>::indicators_ == ";
     switch (Indicator<dim, Number>::indicator_) {
     case Indicator<dim, Number>::Indicators::zero:
@@ -630,6 +1255,9 @@ namespace ryujin
     stream << "Limiter<dim, Number>::relaxation_order_ == "
            << Limiter<dim, Number>::relaxation_order_ << std::endl;
 
+    stream << "Limiter<dim, Number>::precheck_ == "
+           << Limiter<dim, Number>::precheck_ << std::endl;
+
     stream << "ProblemDescription::equation_of_state_ == ";
     switch (ProblemDescription::equation_of_state_) {
     case ProblemDescription::EquationOfState::ideal_gas:
@@ -661,13 +1289,27 @@ namespace ryujin
   template <int dim, typename Number>
   void TimeLoop<dim, Number>::print_mpi_partition(std::ostream &stream)
   {
-    unsigned int dofs[4] = {offline_data.n_export_indices(),
+    /*
+     * The number of neighboring MPI ranks is the number of distinct ranks
+     * we either import ghost values from, or export locally owned values
+     * to:
+     */
+
+    const auto &partitioner = *offline_data.scalar_partitioner();
+    std::set<unsigned int> neighbors;
+    for (const auto &[rank, n_indices] : partitioner.ghost_targets())
+      neighbors.insert(rank);
+    for (const auto &[rank, n_indices] : partitioner.import_targets())
+      neighbors.insert(rank);
+
+    unsigned int dofs[5] = {offline_data.n_export_indices(),
                             offline_data.n_locally_internal(),
                             offline_data.n_locally_owned(),
-                            offline_data.n_locally_relevant()};
+                            offline_data.n_locally_relevant(),
+                            static_cast<unsigned int>(neighbors.size())};
 
     if (mpi_rank > 0) {
-      MPI_Send(&dofs, 4, MPI_UNSIGNED, 0, 0, mpi_communicator);
+      MPI_Send(&dofs, 5, MPI_UNSIGNED, 0, 0, mpi_communicator);
 
     } else {
 
@@ -684,22 +1326,61 @@ namespace ryujin
       stream << "Qdofs: " << n_dofs
              << " global DoFs, local DoF distribution:" << std::endl;
 
+      double min_ghost_ratio = std::numeric_limits<double>::max();
+      double max_ghost_ratio = 0.;
+      double min_simd_ratio = std::numeric_limits<double>::max();
+      unsigned int n_ghosts = 0;
+      unsigned int n_exports = 0;
+      unsigned int max_neighbors = 0;
+      unsigned int n_neighbors = 0;
 
       for (unsigned int p = 0; p < n_mpi_processes; ++p) {
         stream << "    Rank " << p << std::flush;
 
         if (p != 0)
           MPI_Recv(&dofs,
-                   4,
+                   5,
                    MPI_UNSIGNED,
                    p,
                    0,
                    mpi_communicator,
                    MPI_STATUS_IGNORE);
 
+        const unsigned int n_ghost = dofs[3] - dofs[2];
+        const double ghost_ratio = dofs[2] > 0 ? double(n_ghost) / dofs[2] : 0.;
+        const double simd_ratio = dofs[2] > 0 ? double(dofs[1]) / dofs[2] : 1.;
+
         stream << ":\t(exp) " << dofs[0] << ",\t(int) " << dofs[1]
-               << ",\t(own) " << dofs[2] << ",\t(rel) " << dofs[3] << std::endl;
+               << ",\t(own) " << dofs[2] << ",\t(rel) " << dofs[3]
+               << ",\t(gho) " << n_ghost << ",\t(nbr) " << dofs[4]
+               << ",\t(simd) " << std::fixed << std::setprecision(1)
+               << 100. * simd_ratio << "%" << std::defaultfloat << std::endl;
+
+        min_ghost_ratio = std::min(min_ghost_ratio, ghost_ratio);
+        max_ghost_ratio = std::max(max_ghost_ratio, ghost_ratio);
+        min_simd_ratio = std::min(min_simd_ratio, simd_ratio);
+        n_ghosts += n_ghost;
+        n_exports += dofs[0];
+        max_neighbors = std::max(max_neighbors, dofs[4]);
+        n_neighbors += dofs[4];
       } /* p */
+
+      /*
+       * Summarize the partition quality: The ghost volume relative to the
+       * locally owned DoFs, the number of neighbors (i.e., the number of
+       * point-to-point messages per ghost exchange) and the fraction of
+       * SIMD vectorized (internal) rows:
+       */
+
+      stream << "Ghost DoFs: " << n_ghosts << " total, " << n_exports
+             << " exported, ghost/owned ratio (min/max): " << std::fixed
+             << std::setprecision(3) << min_ghost_ratio << " / "
+             << max_ghost_ratio << std::endl;
+      stream << "Neighbors:  " << std::setprecision(1)
+             << double(n_neighbors) / n_mpi_processes << " average, "
+             << max_neighbors << " maximum" << std::endl;
+      stream << "SIMD rows:  " << 100. * min_simd_ratio << "% minimum"
+             << std::defaultfloat << std::endl;
     }   /* mpi_rank */
   }
 
@@ -731,6 +1412,70 @@ namespace ryujin
   }
 
 
+  template <int dim, typename Number>
+  void TimeLoop<dim, Number>::print_memory_footprint(std::ostream &stream)
+  {
+    using statistics_type = std::vector<std::pair<std::string, std::size_t>>;
+
+    const std::vector<std::pair<std::string, statistics_type>> modules{
+        {"OfflineData", offline_data.memory_consumption()},
+        {"EulerModule", euler_module.memory_consumption()},
+        {"DissipationModule", dissipation_module.memory_consumption()},
+        {"DerivedQuantities", derived_quantities.memory_consumption()},
+        {"VTUOutput", vtu_output.memory_consumption()},
+        {"PointQuantities", point_quantities.memory_consumption()},
+        {"TimeAveragedStatistics",
+         time_averaged_statistics.memory_consumption()},
+        {"ScratchVectorPool", scratch_vector_pool.memory_consumption()}};
+
+    /*
+     * The list of entries only depends on run time parameters and is thus
+     * identical on all MPI ranks. Sum up over all ranks:
+     */
+
+    std::vector<double> bytes;
+    for (const auto &[module, statistics] : modules)
+      for (const auto &[name, size] : statistics)
+        bytes.push_back(size);
+
+    std::vector<double> total_bytes(bytes.size());
+    Utilities::MPI::sum(bytes, mpi_communicator, total_bytes);
+
+    if (mpi_rank != 0)
+      return;
+
+    const double n_dofs = offline_data.dof_handler().n_dofs();
+
+    std::ostringstream output;
+    output << std::endl << "Memory footprint:" << std::endl << std::endl;
+    output << std::left << std::setw(32) << "" << std::right << std::setw(12)
+           << "[MiB]" << std::setw(12) << "[B/DoF]" << std::endl;
+
+    const auto print_line = [&](const std::string &name, const double size) {
+      output << std::left << std::setw(32) << name << std::right
+             << std::fixed << std::setprecision(2) << std::setw(12)
+             << size / 1024. / 1024. << std::setw(12) << size / n_dofs
+             << std::endl;
+    };
+
+    double sum = 0.;
+    unsigned int k = 0;
+    for (const auto &[module, statistics] : modules) {
+      double module_sum = 0.;
+      for (unsigned int i = 0; i < statistics.size(); ++i)
+        module_sum += total_bytes[k + i];
+      print_line(module, module_sum);
+      sum += module_sum;
+
+      for (const auto &[name, size] : statistics)
+        print_line("    " + name, total_bytes[k++]);
+    }
+    print_line("Total", sum);
+
+    stream << output.str() << std::flush;
+  }
+
+
   template <int dim, typename Number>
   void TimeLoop<dim, Number>::print_timers(std::ostream &stream)
   {
@@ -795,12 +1540,29 @@ namespace ryujin
       print_cpu_time(it.second, *jt++, it.first.find("time s") == 0);
     equalize();
 
+    /* Back pressure statistics of the output queue: */
+
+    const auto n_snapshots =
+        Utilities::MPI::max(vtu_output.n_snapshots(), mpi_communicator);
+    const auto n_stalls =
+        Utilities::MPI::max(vtu_output.n_stalls(), mpi_communicator);
+    const auto stall_time = Utilities::MPI::min_max_avg(
+        vtu_output.stall_time(), mpi_communicator);
+    const auto max_queue_depth =
+        Utilities::MPI::max(vtu_output.max_queue_depth(), mpi_communicator);
+
     if (mpi_rank != 0)
       return;
 
     stream << std::endl << "Timer statistics:" << std::endl << std::endl;
     for (auto &it : output)
       stream << it.str() << std::endl;
+
+    stream << std::endl
+           << "Output queue: " << n_snapshots << " snapshots, " << n_stalls
+           << " stalls, " << std::setprecision(2) << std::fixed
+           << stall_time.max << "s max stall time, max queue depth "
+           << max_queue_depth << std::endl;
   }
 
 
@@ -821,6 +1583,10 @@ namespace ryujin
       double cpu_time_min = 0.;
       double cpu_time_max = 0.;
       double wall_time = 0.;
+      double time_in_flight = 0.;
+      double time_blocked = 0.;
+      double riemann_solves = 0.;
+      double riemann_iterations = 0.;
     } previous, current;
 
     static double time_per_second_exp = 0.;
@@ -843,6 +1609,18 @@ namespace ryujin
       current.cpu_time_avg = cpu_time_statistics.avg;
       current.cpu_time_min = cpu_time_statistics.min;
       current.cpu_time_max = cpu_time_statistics.max;
+
+      const auto &communication_progress =
+          euler_module.communication_progress();
+      current.time_in_flight = Utilities::MPI::sum(
+          communication_progress.time_in_flight(), mpi_communicator);
+      current.time_blocked = Utilities::MPI::sum(
+          communication_progress.time_blocked(), mpi_communicator);
+
+      current.riemann_solves = Utilities::MPI::sum(
+          double(euler_module.n_riemann_solves()), mpi_communicator);
+      current.riemann_iterations = Utilities::MPI::sum(
+          double(euler_module.n_riemann_iterations()), mpi_communicator);
     }
 
     /* Take averages: */
@@ -869,6 +1647,24 @@ namespace ryujin
         cpu_time_skew * delta_cycles /
         (current.cpu_time_avg - previous.cpu_time_avg);
 
+    const double delta_time_in_flight =
+        current.time_in_flight - previous.time_in_flight;
+    const double delta_time_blocked =
+        current.time_blocked - previous.time_blocked;
+    const double hidden_percentage =
+        delta_time_in_flight + delta_time_blocked > 0.
+            ? 100. * delta_time_in_flight /
+                  (delta_time_in_flight + delta_time_blocked)
+            : 100.;
+
+    const double delta_riemann_solves =
+        current.riemann_solves - previous.riemann_solves;
+    const double riemann_iterations_per_solve =
+        delta_riemann_solves > 0.
+            ? (current.riemann_iterations - previous.riemann_iterations) /
+                  delta_riemann_solves
+            : 0.;
+
     const double delta_time = current.t - previous.t;
     const double time_per_second =
         delta_time / (current.wall_time - previous.wall_time);
@@ -903,7 +1699,14 @@ namespace ryujin
 
     output << "                     [ "
            << std::setprecision(0) << std::fixed << euler_module.n_restarts()
-           << " rsts ]";
+           << " rsts ]"
+           << "[ " << euler_module.n_skipped_limiter_passes()
+           << " lskp ]"
+           << "[ " << std::setprecision(2) << riemann_iterations_per_solve
+           << " rsit ]"
+           << "[ cfl "
+           << std::setprecision(2) << std::fixed << euler_module.cfl()
+           << " ]";
 
     output << "[ "
            << std::setprecision(2) << std::fixed
@@ -911,8 +1714,20 @@ namespace ryujin
            << (dissipation_module.use_gmg_velocity() ? " GMG vel -- " : " CG vel -- ")
            << dissipation_module.n_iterations_internal_energy()
            << (dissipation_module.use_gmg_internal_energy() ? " GMG int ]" : " CG int ]")
+           << (dissipation_module.use_pipelined_cg() ? "[ pipelined ]" : "")
+           << "[ " << n_splitting_steps << " hyp/dis ]"
            << std::endl;
 
+    if (!dissipation_module.gmg_autotune_result().empty())
+      output << "                     [ GMG autotuned: "
+             << dissipation_module.gmg_autotune_result() << " ]" << std::endl;
+
+    output << "                     [ "
+           << std::setprecision(1) << std::fixed << hidden_percentage
+           << "% of ghost exchange hidden, "
+           << std::scientific << delta_time_blocked / delta_cycles
+           << " s/cycle blocked ]" << std::endl;
+
     output << "                     dt = "
            << std::scientific << std::setprecision(2) << delta_time
            << " ( "
@@ -920,6 +1735,99 @@ namespace ryujin
            << " dt/s)" << std::endl << std::endl;
     /* clang-format on */
 
+    /* Print modeled memory bandwidth and flop rate per kernel: */
+
+    {
+      static std::map<std::string, std::array<double, 3>> previous_kernels;
+
+      auto kernel_statistics = euler_module.kernel_statistics();
+      for (const auto &[prefix, it] : dissipation_module.kernel_statistics())
+        kernel_statistics[prefix] = it;
+
+      const double peak_bandwidth = peak_memory_bandwidth * n_mpi_processes;
+      const double peak_flops = peak_flop_rate * n_mpi_processes;
+
+      output << "Kernels:     (modeled traffic and flops)" << std::endl;
+
+      for (const auto &[prefix, it] : kernel_statistics) {
+        double wall_time = 0.;
+        for (const auto &[section, timer] : computing_timer)
+          if (section.compare(0, prefix.size() + 2, prefix + " -") == 0)
+            wall_time += timer.wall_time();
+
+        const std::array<double, 3> current_kernel{
+            {Utilities::MPI::sum(it.bytes, mpi_communicator),
+             Utilities::MPI::sum(it.flops, mpi_communicator),
+             Utilities::MPI::max(wall_time, mpi_communicator)}};
+        auto &previous_kernel = previous_kernels[prefix];
+
+        const double delta_wall_time = current_kernel[2] - previous_kernel[2];
+        const double bandwidth =
+            (current_kernel[0] - previous_kernel[0]) / delta_wall_time / 1.e9;
+        const double flop_rate =
+            (current_kernel[1] - previous_kernel[1]) / delta_wall_time / 1.e9;
+        previous_kernel = current_kernel;
+
+        if (delta_wall_time <= 0.)
+          continue;
+
+        /* clang-format off */
+        output << "             " << prefix.substr(prefix.find('['))
+               << std::setprecision(2) << std::fixed
+               << std::setw(10) << bandwidth << " GB/s";
+        if (peak_bandwidth > 0.)
+          output << " (" << std::setprecision(1) << std::setw(5)
+                 << 100. * bandwidth / peak_bandwidth << "% peak)";
+        output << std::setprecision(2) << std::setw(10) << flop_rate
+               << " GFlop/s";
+        if (peak_flops > 0.)
+          output << " (" << std::setprecision(1) << std::setw(5)
+                 << 100. * flop_rate / peak_flops << "% peak)";
+        output << std::endl;
+        /* clang-format on */
+      }
+
+#ifdef USE_FUSED_D_IJ_COMPUTATION
+      const auto [fused, unfused] = euler_module.d_ij_traffic_per_row();
+      /* clang-format off */
+      output << "             [E] 1+2 fused d_ij"
+             << std::setprecision(0) << std::fixed
+             << std::setw(8) << fused << " B/row (unfused "
+             << unfused << " B/row, saved "
+             << unfused - fused << " B/row)" << std::endl;
+      /* clang-format on */
+#endif
+      output << std::endl;
+    }
+
+    /* Print the accumulated time threads spent waiting in barriers: */
+
+    if (!euler_module.idle_time().empty()) {
+      output << "Idle time:   (per thread, max / average)" << std::endl;
+
+      for (const auto &[prefix, it] : euler_module.idle_time()) {
+        double max_idle = 0.;
+        double sum_idle = 0.;
+        for (const auto &idle : it.idle_times()) {
+          max_idle = std::max(max_idle, idle);
+          sum_idle += idle;
+        }
+        max_idle = Utilities::MPI::max(max_idle, mpi_communicator);
+        const double average_idle =
+            Utilities::MPI::sum(sum_idle, mpi_communicator) /
+            Utilities::MPI::sum(double(it.idle_times().size()),
+                                mpi_communicator);
+
+        /* clang-format off */
+        output << "             " << prefix.substr(prefix.find('['))
+               << std::setprecision(2) << std::scientific
+               << std::setw(10) << max_idle << " s"
+               << std::setw(10) << average_idle << " s" << std::endl;
+        /* clang-format on */
+      }
+      output << std::endl;
+    }
+
     /* and print an ETA */
     time_per_second_exp = 0.8 * time_per_second_exp + 0.2 * time_per_second;
     unsigned int eta =
@@ -949,6 +1857,45 @@ namespace ryujin
   }
 
 
+  template <int dim, typename Number>
+  void TimeLoop<dim, Number>::print_cfl_classes(std::ostream &stream)
+  {
+    constexpr unsigned int n_classes = 8;
+    const auto classes = euler_module.cfl_classes(n_classes);
+
+    unsigned long n_total = 0;
+    for (const auto it : classes)
+      n_total += it;
+
+    if (n_total == 0)
+      return;
+
+    /*
+     * Estimate the work of a multirate scheme that advances class k with
+     * a time step size of 2^k tau_min relative to global time stepping
+     * with tau_min:
+     */
+    double work = 0.;
+    for (unsigned int k = 0; k < n_classes; ++k)
+      work += double(classes[k]) / double(1u << k);
+    const double speedup = double(n_total) / work;
+
+    std::ostringstream output;
+
+    output << "CFL classes: ";
+    for (unsigned int k = 0; k < n_classes; ++k)
+      output << (k == 0 ? "[ " : " | ") << std::setprecision(1) << std::fixed
+             << 100. * double(classes[k]) / double(n_total) << "%";
+    output << " ]" << std::endl;
+
+    output << "             (potential multirate speedup: "
+           << std::setprecision(2) << std::fixed << speedup << ")"
+           << std::endl;
+
+    stream << output.str();
+  }
+
+
   template <int dim, typename Number>
   void TimeLoop<dim, Number>::print_info(const std::string &header)
   {
@@ -1030,8 +1977,11 @@ namespace ryujin
              << " ranks performing output !!!" << std::flush;
 
     print_memory_statistics(output);
+    if (final_time)
+      print_memory_footprint(output);
     print_timers(output);
     print_throughput(cycle, t, output);
+    print_cfl_classes(output);
 
     if (mpi_rank == 0) {
       if (write_to_logfile) {
@@ -0,0 +1,184 @@
+//
+// SPDX-License-Identifier: MIT
+// Copyright (C) 2020 - 2021 by the ryujin authors
+//
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ryujin
+{
+  /**
+   * A minimal per-rank event trace.
+   *
+   * If enabled, every Scope entry and exit, every ghost exchange recorded
+   * by CommunicationProgress, and selected counters (such as linear
+   * solver iteration counts) are stored with a timestamp. The trace is
+   * written out in the Chrome trace event format (readable by
+   * chrome://tracing, Perfetto, or speedscope) with the MPI rank as
+   * process id. Traces of different ranks can be merged by concatenating
+   * the "traceEvents" arrays.
+   *
+   * If the trace is not enabled, all recording functions reduce to a
+   * single branch.
+   *
+   * @ingroup Miscellaneous
+   */
+  class Trace
+  {
+  public:
+    /**
+     * Enable recording. At most @p max_events events are recorded, all
+     * subsequent events are dropped. Timestamps are taken relative to the
+     * time of this call. It is thus advisable to synchronize all ranks
+     * (with an MPI_Barrier) before calling this function.
+     */
+    static void enable(const std::size_t max_events)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      enabled_ = true;
+      max_events_ = max_events;
+      epoch_ = std::chrono::steady_clock::now();
+      events_.clear();
+      events_.reserve(std::min<std::size_t>(max_events, 1 << 16));
+      n_dropped_ = 0;
+    }
+
+    /**
+     * Return whether the trace is enabled.
+     */
+    static bool enabled()
+    {
+      return enabled_;
+    }
+
+    /**
+     * Record the beginning of a (synchronous) region @p name.
+     */
+    static void begin(const std::string &name)
+    {
+      if (enabled_)
+        record(name, 'B', 0, 0.);
+    }
+
+    /**
+     * Record the end of a (synchronous) region @p name.
+     */
+    static void end(const std::string &name)
+    {
+      if (enabled_)
+        record(name, 'E', 0, 0.);
+    }
+
+    /**
+     * Record the beginning of an asynchronous operation @p name (such as
+     * a nonblocking ghost exchange) identified by @p id.
+     */
+    static void async_begin(const std::string &name, const unsigned long id)
+    {
+      if (enabled_)
+        record(name, 'b', id, 0.);
+    }
+
+    /**
+     * Record the end of an asynchronous operation @p name identified by
+     * @p id.
+     */
+    static void async_end(const std::string &name, const unsigned long id)
+    {
+      if (enabled_)
+        record(name, 'e', id, 0.);
+    }
+
+    /**
+     * Record the value @p value of a counter @p name.
+     */
+    static void counter(const std::string &name, const double value)
+    {
+      if (enabled_)
+        record(name, 'C', 0, value);
+    }
+
+    /**
+     * Write out the trace into @p file_name in the Chrome trace event
+     * format using @p pid (typically the MPI rank) as process id.
+     */
+    static void write(const std::string &file_name, const unsigned int pid)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      std::ofstream output(file_name);
+      output << std::setprecision(16);
+      output << "{\"displayTimeUnit\": \"ms\",\n";
+      output << " \"otherData\": {\"dropped events\": " << n_dropped_
+             << "},\n";
+      output << " \"traceEvents\": [\n";
+
+      for (std::size_t k = 0; k < events_.size(); ++k) {
+        const auto &event = events_[k];
+        output << "  {\"name\": \"" << escape(event.name) << "\", \"ph\": \""
+               << event.phase << "\", \"ts\": " << event.timestamp
+               << ", \"pid\": " << pid << ", \"tid\": 0";
+        if (event.phase == 'b' || event.phase == 'e')
+          output << ", \"cat\": \"communication\", \"id\": " << event.id;
+        if (event.phase == 'C')
+          output << ", \"args\": {\"value\": " << event.value << "}";
+        output << (k + 1 < events_.size() ? "},\n" : "}\n");
+      }
+
+      output << " ]\n}" << std::endl;
+    }
+
+  private:
+    struct Event {
+      std::string name;
+      char phase;
+      double timestamp; /* in microseconds */
+      unsigned long id;
+      double value;
+    };
+
+    static void record(const std::string &name,
+                       const char phase,
+                       const unsigned long id,
+                       const double value)
+    {
+      const auto now = std::chrono::steady_clock::now();
+      const double timestamp =
+          std::chrono::duration<double, std::micro>(now - epoch_).count();
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (events_.size() >= max_events_) {
+        ++n_dropped_;
+        return;
+      }
+      events_.push_back({name, phase, timestamp, id, value});
+    }
+
+    static std::string escape(const std::string &name)
+    {
+      std::string result;
+      for (const char c : name) {
+        if (c == '"' || c == '\\')
+          result += '\\';
+        result += c;
+      }
+      return result;
+    }
+
+    static inline bool enabled_ = false;
+    static inline std::size_t max_events_ = 0;
+    static inline std::size_t n_dropped_ = 0;
+    static inline std::chrono::steady_clock::time_point epoch_;
+    static inline std::vector<Event> events_;
+    static inline std::mutex mutex_;
+  };
+
+} /* namespace ryujin */
@@ -9,6 +9,11 @@
 #include <deal.II/base/config.h>
 #include <deal.II/grid/manifold.h>
 
+#include <boost/container/small_vector.hpp>
+
+#include <shared_mutex>
+#include <unordered_map>
+
 namespace ryujin
 {
   using namespace dealii; // FIXME: namespace pollution
@@ -18,6 +23,17 @@ namespace ryujin
    * deal.II. In contrast to the deal.II version it copies the coarse grid
    * and all relevant Manifold information. That way it can be initialized
    * with one Triangulation and be used with another Triangulation.
+   *
+   * Furthermore, all chart space coordinates (together with the coarse
+   * cell they belong to) that are computed for surrounding points, or
+   * that are used to create new points, are cached. Because the
+   * surrounding points of a new point are (almost always) vertices of
+   * the coarse mesh or points created by the manifold on a coarser
+   * level, every refinement level reuses the chart points of its parent
+   * level: The search for a suitable coarse cell and the Newton inversion
+   * in pull_back() are skipped whenever all surrounding points are found
+   * in the cache. Points are identified by their exact coordinates. The
+   * cache is thread safe.
    */
   template <int dim, int spacedim = dim>
   class TransfiniteInterpolationManifold : public Manifold<dim, spacedim>
@@ -71,6 +87,36 @@ namespace ryujin
     std::vector<bool> coarse_cell_is_flat;
 
     std::unique_ptr<Manifold<dim, spacedim>> chart_manifold;
+
+    unsigned int lookup_chart_points(
+        const ArrayView<const Point<spacedim>> &surrounding_points,
+        ArrayView<Point<dim>> chart_points) const;
+
+    void
+    cache_chart_points(const unsigned int cell_index,
+                       const ArrayView<const Point<spacedim>> &points,
+                       const ArrayView<const Point<dim>> &chart_points) const;
+
+    struct PointHash {
+      std::size_t operator()(const Point<spacedim> &point) const
+      {
+        std::size_t seed = 0;
+        for (unsigned int d = 0; d < spacedim; ++d)
+          seed ^= std::hash<double>()(point[d]) + 0x9e3779b9 + (seed << 6) +
+                  (seed >> 2);
+        return seed;
+      }
+    };
+
+    using cache_entry_type = std::pair<unsigned int, Point<dim>>;
+
+    mutable std::unordered_map<
+        Point<spacedim>,
+        boost::container::small_vector<cache_entry_type, 2>,
+        PointHash>
+        chart_point_cache;
+
+    mutable std::shared_mutex chart_point_cache_mutex;
   };
 
 } // namespace ryujin
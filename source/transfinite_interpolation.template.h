@@ -10,6 +10,9 @@
 
 #include <boost/container/small_vector.hpp>
 
+#include <algorithm>
+#include <mutex>
+
 namespace ryujin
 {
 
@@ -69,6 +72,19 @@ namespace ryujin
                        coarse_cell_is_flat.size());
       coarse_cell_is_flat[cell->index()] = cell_is_flat;
     }
+
+    /* Seed the cache with the vertices of all coarse cells: */
+
+    std::unique_lock lock(chart_point_cache_mutex);
+    chart_point_cache.clear();
+    for (cell = triangulation.begin(level_coarse); cell != endc; ++cell) {
+      /* FIXME: Remove workaround - ignore certain cells. */
+      if (cell->material_id() == 42)
+        continue;
+      for (const unsigned int v : GeometryInfo<dim>::vertex_indices())
+        chart_point_cache[cell->vertex(v)].emplace_back(
+            cell->index(), GeometryInfo<dim>::unit_cell_vertex(v));
+    }
   }
 
 
@@ -643,6 +659,14 @@ namespace ryujin
            ExcMessage("The chart points array view must be as large as the "
                       "surrounding points array view."));
 
+    /* Fast path: All chart points are known from a coarser level: */
+
+    const auto cell_index =
+        lookup_chart_points(surrounding_points, chart_points);
+    if (cell_index != numbers::invalid_unsigned_int)
+      return typename Triangulation<dim, spacedim>::cell_iterator(
+          &triangulation, level_coarse, cell_index);
+
     std::array<unsigned int, 20> nearby_cells =
         get_possible_cells_around_points(surrounding_points);
 
@@ -843,6 +867,7 @@ namespace ryujin
         }
       }
       if (inside_unit_cell == true) {
+        cache_chart_points(cell->index(), surrounding_points, chart_points);
         return cell;
       }
 
@@ -900,7 +925,12 @@ namespace ryujin
     const Point<dim> p_chart =
         chart_manifold->get_new_point(chart_points_view, weights);
 
-    return push_forward(cell, p_chart);
+    const Point<spacedim> new_point = push_forward(cell, p_chart);
+    cache_chart_points(cell->index(),
+                       make_array_view(&new_point, &new_point + 1),
+                       make_array_view(&p_chart, &p_chart + 1));
+
+    return new_point;
   }
 
 
@@ -929,6 +959,80 @@ namespace ryujin
 
     for (unsigned int row = 0; row < weights.size(0); ++row)
       new_points[row] = push_forward(cell, new_points_on_chart[row]);
+
+    cache_chart_points(cell->index(),
+                       new_points,
+                       make_array_view(new_points_on_chart.begin(),
+                                       new_points_on_chart.end()));
+  }
+
+
+  template <int dim, int spacedim>
+  unsigned int
+  TransfiniteInterpolationManifold<dim, spacedim>::lookup_chart_points(
+      const ArrayView<const Point<spacedim>> &surrounding_points,
+      ArrayView<Point<dim>> chart_points) const
+  {
+    std::shared_lock lock(chart_point_cache_mutex);
+
+    boost::container::small_vector<const cache_entry_type *, 100> entries(
+        surrounding_points.size());
+
+    /*
+     * Try all coarse cells the first point belongs to and check whether
+     * chart coordinates of all other points are known for the same cell:
+     */
+
+    const auto first = chart_point_cache.find(surrounding_points[0]);
+    if (first == chart_point_cache.end())
+      return numbers::invalid_unsigned_int;
+
+    for (const auto &candidate : first->second) {
+      const unsigned int cell_index = candidate.first;
+      entries[0] = &candidate;
+
+      bool found = true;
+      for (unsigned int i = 1; found && i < surrounding_points.size(); ++i) {
+        const auto it = chart_point_cache.find(surrounding_points[i]);
+        found = false;
+        if (it == chart_point_cache.end())
+          return numbers::invalid_unsigned_int;
+        for (const auto &entry : it->second)
+          if (entry.first == cell_index) {
+            entries[i] = &entry;
+            found = true;
+            break;
+          }
+      }
+
+      if (found) {
+        for (unsigned int i = 0; i < surrounding_points.size(); ++i)
+          chart_points[i] = entries[i]->second;
+        return cell_index;
+      }
+    }
+
+    return numbers::invalid_unsigned_int;
+  }
+
+
+  template <int dim, int spacedim>
+  void TransfiniteInterpolationManifold<dim, spacedim>::cache_chart_points(
+      const unsigned int cell_index,
+      const ArrayView<const Point<spacedim>> &points,
+      const ArrayView<const Point<dim>> &chart_points) const
+  {
+    std::unique_lock lock(chart_point_cache_mutex);
+
+    for (unsigned int i = 0; i < points.size(); ++i) {
+      auto &entries = chart_point_cache[points[i]];
+      const bool known =
+          std::any_of(entries.begin(), entries.end(), [&](const auto &entry) {
+            return entry.first == cell_index;
+          });
+      if (!known)
+        entries.emplace_back(cell_index, chart_points[i]);
+    }
   }
 
 } // namespace ryujin
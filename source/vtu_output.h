@@ -7,17 +7,95 @@
 
 #include <compile_time_options.h>
 
+#include "derived_quantities.h"
 #include "offline_data.h"
 #include "problem_description.h"
+#include "scratch_vector_pool.h"
 
 #include <deal.II/base/parameter_acceptor.h>
 #include <deal.II/grid/intergrid_map.h>
 #include <deal.II/multigrid/mg_transfer_matrix_free.h>
+#include <deal.II/numerics/data_out.h>
 
-#include <future>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
 
 namespace ryujin
 {
+  /**
+   * A DataOut object that caches the patches created by build_patches().
+   *
+   * After a call to cache_patches() the point data of all patches can be
+   * recomputed with update_point_data() from the data vectors passed to
+   * it, without rebuilding the patches, i.e., without reevaluating the
+   * mapping for all patch points and without reallocating the patch
+   * geometry. For this we store the (MPI rank local) degrees of freedom
+   * of every patch and the values of all shape functions at the patch
+   * points.
+   *
+   * The vectors passed to update_point_data() need not be the ones that
+   * were passed to cache_patches() (for example, they may come from a
+   * pool of output buffers), but they have to share the same MPI
+   * partitioner and have to be given in the same order. The cache is
+   * only valid as long as the triangulation and the DoFHandler remain
+   * unchanged.
+   *
+   * @ingroup TimeLoop
+   */
+  template <int dim, typename Number = double>
+  class CachedDataOut : public dealii::DataOut<dim>
+  {
+  public:
+    /**
+     * Shorthand typedef for
+     * dealii::LinearAlgebra::distributed::Vector<Number>.
+     */
+    using scalar_type = dealii::LinearAlgebra::distributed::Vector<Number>;
+
+    /**
+     * The type of the cell selection predicate.
+     */
+    using cell_selection_type = std::function<bool(
+        const typename dealii::Triangulation<dim>::cell_iterator &)>;
+
+    /**
+     * Build patches for all cells of @p dof_handler selected by @p
+     * cell_selection and cache local dof indices and shape function
+     * values. The function expects the DoFHandler to be attached and the
+     * data vectors @p vectors to have been added (in the same order) with
+     * add_data_vector().
+     */
+    void cache_patches(const dealii::DoFHandler<dim> &dof_handler,
+                       const dealii::Mapping<dim> &mapping,
+                       const unsigned int n_subdivisions,
+                       const cell_selection_type &cell_selection,
+                       const std::vector<const scalar_type *> &vectors);
+
+    /**
+     * Recompute the point data of all cached patches from the current
+     * values of the data vectors @p vectors. The vectors have to be
+     * passed in the same order as for cache_patches(), have to have the
+     * same MPI partitioner, and must have up to date ghost values.
+     */
+    void update_point_data(const std::vector<const scalar_type *> &vectors);
+
+    /**
+     * Return the memory consumption of the cached patches (including a
+     * copy of all point data), local dof indices and shape function
+     * values in bytes.
+     */
+    std::size_t memory_consumption() const;
+
+  private:
+    unsigned int dofs_per_cell_;
+    std::vector<Number> shape_values_;
+    std::vector<unsigned int> local_dof_indices_;
+  };
+
 
   /**
    * the VTUOutput class implements a number of postprocessing
@@ -39,6 +117,9 @@ namespace ryujin
    *       \mathbf q_i =  \frac{1}{m_i}\;\sum_{j\in \mathcal{J}(i)}
    * \mathbf{c}_{ij} \times \mathbf{m}_j / \rho_j. \f]
    *
+   * The quantities \f$\mathbf q_i\f$ are taken from the shared
+   * DerivedQuantities pipeline.
+   *
    * In addition, the generated VTU output also contains the full state
    * vector, and a local estimate of the effective residual viscosity
    * \f$\mu_{\text{res}}\f$ caused by the graph viscosity stabilization.
@@ -93,32 +174,71 @@ namespace ryujin
      */
     VTUOutput(const MPI_Comm &mpi_communicator,
               const ryujin::OfflineData<dim, Number> &offline_data,
+              DerivedQuantities<dim, Number> &derived_quantities,
+              ScratchVectorPool &scratch_vector_pool,
               const std::string &subsection = "VTUOutput");
 
+    /**
+     * Destructor. Waits for the writer thread to write out all pending
+     * snapshots.
+     */
+    ~VTUOutput();
+
     /**
      * Prepare VTU output. A call to @ref prepare() allocates temporary
      * storage and is necessary before schedule_output() can be called.
      *
-     * Calling prepare() allocates temporary storage for additional (dim +
-     * 5) scalar vectors of type OfflineData::scalar_type.
+     * Calling prepare() requests the schlieren and vorticity fields from
+     * the DerivedQuantities object and (re)allocates the snapshot buffers
+     * of the output queue, which invalidates the cached output patches.
+     *
+     * The additional (dim + 5) scalar vectors of type
+     * OfflineData::scalar_type needed for postprocessing are checked out
+     * from the ScratchVectorPool for the duration of a call to
+     * schedule_output(). All data written out is held by the snapshot
+     * buffers.
      */
     void prepare();
 
+    /**
+     * Return the memory consumption (in bytes, of this MPI rank) of all
+     * snapshot buffers as a list of (name, size) pairs.
+     */
+    std::vector<std::pair<std::string, std::size_t>>
+    memory_consumption() const;
+
     /**
      * Given a state vector @p U and a scalar vector @p alpha (as well as a
      * file name prefix @p name, the current time @p t, and the current
      * output cycle @p cycle) schedule a solution output.
      *
-     * The function post-processes quantities synchronously, and (depending
-     * on configuration options) schedules the write-out asynchronously
-     * onto a background worker thread. This implies that @p U and @p alpha
-     * can again be modified once schedule_output() returned.
+     * The function post-processes quantities synchronously and copies
+     * them into one of "output queue size" preallocated snapshot buffers.
+     * Depending on configuration options the snapshot is then written out
+     * synchronously, or enqueued for a background writer thread. This
+     * implies that @p U and @p alpha can again be modified once
+     * schedule_output() returned. If all snapshot buffers are still
+     * waiting to be written out the function blocks until a buffer
+     * becomes available (back pressure).
      *
      * The booleans @p output_full controls whether the full vector field
      * is written out. Correspondingly, @p output_cutplanes controls
      * whether cells in the vicinity of predefined cutplanes are written
      * out.
      *
+     * If the run time option "use hdf5" is set, the mesh is written
+     * once (after every call to prepare()) into a file
+     * "name-mesh_cycle.h5" and for every output cycle only the
+     * state and the postprocessed quantities are written collectively into
+     * a single file "name_cycle.h5". An XDMF index "name.xdmf" ties all
+     * cycles together. This keeps the number of files (and the load on
+     * the metadata servers of a parallel file system) independent of the
+     * number of MPI ranks.
+     *
+     * The patches (i.e., the output geometry) are built once after each
+     * call to prepare() and cached across output cycles. Subsequent calls
+     * only recompute the point data.
+     *
      * The function requires MPI communication and is not reentrant.
      */
     void schedule_output(const vector_type &U,
@@ -130,17 +250,52 @@ namespace ryujin
                          bool output_cutplanes = true);
 
     /**
-     * Returns true if at least one background thread is active writing out
-     * the solution to disk.
+     * Returns true if at least one snapshot is still waiting to be, or
+     * currently being, written out to disk.
      */
     bool is_active();
 
     /**
-     * Wait for all background threads to finish writing out the solution
-     * to disk.
+     * Wait for the writer thread to finish writing out all pending
+     * snapshots to disk.
      */
     void wait();
 
+    /**
+     * Return the total number of scheduled snapshots.
+     */
+    unsigned long n_snapshots() const
+    {
+      return n_snapshots_;
+    }
+
+    /**
+     * Return the number of times schedule_output() had to wait for a free
+     * snapshot buffer.
+     */
+    unsigned long n_stalls() const
+    {
+      return n_stalls_;
+    }
+
+    /**
+     * Return the accumulated wall time schedule_output() spent waiting for
+     * a free snapshot buffer.
+     */
+    double stall_time() const
+    {
+      return stall_time_;
+    }
+
+    /**
+     * Return the maximal number of snapshots that were simultaneously
+     * waiting for the writer thread.
+     */
+    unsigned int max_queue_depth() const
+    {
+      return max_queue_depth_;
+    }
+
   private:
     /**
      * @name Run time options
@@ -150,11 +305,19 @@ namespace ryujin
     bool use_mpi_io_;
     ACCESSOR_READ_ONLY(use_mpi_io)
 
+    bool use_hdf5_;
+    ACCESSOR_READ_ONLY(use_hdf5)
+
     Number schlieren_beta_;
     Number vorticity_beta_;
 
+    std::vector<double> output_error_bounds_;
+    unsigned int quantities_fixed_rate_bits_;
+
     std::vector<std::string> manifolds_;
 
+    unsigned int output_queue_size_;
+
     //@}
     /**
      * @name Internal data
@@ -164,13 +327,77 @@ namespace ryujin
     const MPI_Comm &mpi_communicator_;
 
     dealii::SmartPointer<const ryujin::OfflineData<dim, Number>> offline_data_;
+    dealii::SmartPointer<DerivedQuantities<dim, Number>> derived_quantities_;
+    dealii::SmartPointer<ScratchVectorPool> scratch_vector_pool_;
 
-    std::future<void> background_thread_status;
+    std::map<std::string, std::vector<dealii::XDMFEntry>> xdmf_entries_;
+    std::map<std::string, std::string> hdf5_mesh_filenames_;
+
+    //@}
+    /**
+     * @name Output queue
+     */
+    //@{
 
-    std::array<scalar_type, problem_dimension> state_vector_;
-    std::array<scalar_type, n_quantities> quantities_;
+    /**
+     * A snapshot buffer holding cached patches (with a copy of all point
+     * data) and the metadata of one output cycle.
+     */
+    struct Snapshot {
+      std::unique_ptr<CachedDataOut<dim, Number>> data_out;
+      std::unique_ptr<CachedDataOut<dim, Number>> data_out_levelsets;
+
+      std::string name;
+      Number t;
+      unsigned int cycle;
+      bool output_full;
+      bool output_levelsets;
+    };
+
+    std::vector<Snapshot> snapshots_;
+    std::vector<unsigned int> free_snapshots_;
+    std::deque<unsigned int> pending_snapshots_;
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool terminate_;
+    std::thread writer_thread_;
+
+    unsigned long n_snapshots_;
+    unsigned long n_stalls_;
+    double stall_time_;
+    unsigned int max_queue_depth_;
+
+    /**
+     * Block until a snapshot buffer is available and return its index.
+     */
+    unsigned int acquire_snapshot();
+
+    /**
+     * Return the snapshot buffer with given @p index to the pool.
+     */
+    void release_snapshot(const unsigned int index);
+
+    /**
+     * Write out the given snapshot.
+     */
+    void write_snapshot(const Snapshot &snapshot);
+
+    /**
+     * The main loop of the writer thread.
+     */
+    void writer_loop();
 
     //@}
+
+    /**
+     * Collectively write the content of @p data_out into HDF5 files and
+     * update the XDMF index for the output stream @p name.
+     */
+    void write_hdf5(const dealii::DataOut<dim> &data_out,
+                    const std::string &name,
+                    Number t,
+                    unsigned int cycle);
   };
 
 } /* namespace ryujin */
@@ -5,16 +5,22 @@
 
 #pragma once
 
+#include "lossy_compression.h"
 #include "simd.h"
 #include "vtu_output.h"
 
 #include <deal.II/base/function_parser.h>
+#include <deal.II/base/memory_consumption.h>
+#include <deal.II/base/quadrature_lib.h>
 #include <deal.II/numerics/data_out.h>
 #include <deal.II/numerics/vector_tools.h>
 
 #include <atomic>
 #include <chrono>
+#include <filesystem>
 #include <fstream>
+#include <mutex>
+#include <tuple>
 
 namespace ryujin
 {
@@ -47,14 +53,126 @@ namespace ryujin
 #endif
 
 
+  template <int dim, typename Number>
+  void CachedDataOut<dim, Number>::cache_patches(
+      const dealii::DoFHandler<dim> &dof_handler,
+      const dealii::Mapping<dim> &mapping,
+      const unsigned int n_subdivisions,
+      const cell_selection_type &cell_selection,
+      const std::vector<const scalar_type *> &vectors)
+  {
+    this->set_cell_selection(cell_selection);
+    this->build_patches(mapping, n_subdivisions);
+
+    Assert(vectors.size() > 0, dealii::ExcInternalError());
+
+    /*
+     * Tabulate all shape functions on the patch points. DataOut places
+     * the patch points on the lattice given by an iterated trapezoidal
+     * rule (in lexicographic order):
+     */
+
+    const auto &finite_element = dof_handler.get_fe();
+    dofs_per_cell_ = finite_element.dofs_per_cell;
+
+    const unsigned int patch_subdivisions =
+        this->patches.empty() ? 1 : this->patches[0].n_subdivisions;
+#if DEAL_II_VERSION_GTE(9, 3, 0)
+    const QIterated<dim> patch_points(QTrapezoid<1>(), patch_subdivisions);
+#else
+    const QIterated<dim> patch_points(QTrapez<1>(), patch_subdivisions);
+#endif
+
+    shape_values_.resize(patch_points.size() * dofs_per_cell_);
+    for (unsigned int q = 0; q < patch_points.size(); ++q)
+      for (unsigned int k = 0; k < dofs_per_cell_; ++k)
+        shape_values_[q * dofs_per_cell_ + k] =
+            finite_element.shape_value(k, patch_points.point(q));
+
+    /*
+     * Record local dof indices of all patches. Patches are created in
+     * the order in which the selected cells are traversed:
+     */
+
+    const auto &partitioner = *vectors[0]->get_partitioner();
+
+    local_dof_indices_.clear();
+    local_dof_indices_.reserve(this->patches.size() * dofs_per_cell_);
+
+    std::vector<dealii::types::global_dof_index> dof_indices(dofs_per_cell_);
+    for (const auto &cell : dof_handler.cell_iterators()) {
+      if (!cell_selection(
+              typename dealii::Triangulation<dim>::cell_iterator(cell)))
+        continue;
+      cell->get_dof_indices(dof_indices);
+      for (const auto index : dof_indices)
+        local_dof_indices_.push_back(partitioner.global_to_local(index));
+    }
+
+    AssertThrow(local_dof_indices_.size() ==
+                    this->patches.size() * dofs_per_cell_,
+                dealii::ExcMessage("Cell traversal does not match the order "
+                                   "of the patches built by DataOut"));
+  }
+
+
+  template <int dim, typename Number>
+  void CachedDataOut<dim, Number>::update_point_data(
+      const std::vector<const scalar_type *> &vectors)
+  {
+    auto &patches = this->patches;
+    const unsigned int n_points = shape_values_.size() / dofs_per_cell_;
+    const unsigned int n_patches = patches.size();
+
+    RYUJIN_PARALLEL_REGION_BEGIN
+
+    RYUJIN_OMP_FOR
+    for (unsigned int p = 0; p < n_patches; ++p) {
+      const unsigned int *dofs =
+          local_dof_indices_.data() + p * dofs_per_cell_;
+
+      for (unsigned int c = 0; c < vectors.size(); ++c) {
+        const auto &vector = *vectors[c];
+        for (unsigned int q = 0; q < n_points; ++q) {
+          const Number *shape = shape_values_.data() + q * dofs_per_cell_;
+          Number value = Number(0.);
+          for (unsigned int k = 0; k < dofs_per_cell_; ++k)
+            value += shape[k] * vector.local_element(dofs[k]);
+          patches[p].data(c, q) = value;
+        }
+      }
+    }
+
+    RYUJIN_PARALLEL_REGION_END
+  }
+
+
+  template <int dim, typename Number>
+  std::size_t CachedDataOut<dim, Number>::memory_consumption() const
+  {
+    return dealii::DataOut<dim>::memory_consumption() +
+           MemoryConsumption::memory_consumption(shape_values_) +
+           MemoryConsumption::memory_consumption(local_dof_indices_);
+  }
+
+
   template <int dim, typename Number>
   VTUOutput<dim, Number>::VTUOutput(
       const MPI_Comm &mpi_communicator,
       const ryujin::OfflineData<dim, Number> &offline_data,
+      DerivedQuantities<dim, Number> &derived_quantities,
+      ScratchVectorPool &scratch_vector_pool,
       const std::string &subsection /*= "VTUOutput"*/)
       : ParameterAcceptor(subsection)
       , mpi_communicator_(mpi_communicator)
       , offline_data_(&offline_data)
+      , derived_quantities_(&derived_quantities)
+      , scratch_vector_pool_(&scratch_vector_pool)
+      , terminate_(false)
+      , n_snapshots_(0)
+      , n_stalls_(0)
+      , stall_time_(0.)
+      , max_queue_depth_(0)
   {
     use_mpi_io_ = false;
     add_parameter("use mpi io",
@@ -63,6 +181,12 @@ namespace ryujin
                   "write_vtu_in_parallel() instead of independent output files "
                   "via write_vtu_with_pvtu_record()");
 
+    use_hdf5_ = false;
+    add_parameter("use hdf5",
+                  use_hdf5_,
+                  "If enabled write out the mesh once and the solution of "
+                  "every output cycle collectively into HDF5 files indexed "
+                  "by an XDMF file. Takes precedence over \"use mpi io\"");
 
     schlieren_beta_ = 10.;
     add_parameter(
@@ -76,10 +200,45 @@ namespace ryujin
         vorticity_beta_,
         "Beta factor used in the exponential scale for the vorticity");
 
+    add_parameter(
+        "output error bounds",
+        output_error_bounds_,
+        "List of absolute error bounds (one per conserved component). If "
+        "nonempty, the conserved fields are rounded to a lattice of "
+        "spacing twice the error bound before output which greatly "
+        "improves the compression ratio of the (zlib/HDF5) payload");
+
+    quantities_fixed_rate_bits_ = 0;
+    add_parameter(
+        "quantities fixed rate bits",
+        quantities_fixed_rate_bits_,
+        "If nonzero, round the normalized schlieren and vorticity fields to "
+        "a fixed rate representation with the given number of bits");
+
     add_parameter("manifolds",
                   manifolds_,
                   "List of level set functions. The description is used to "
                   "only output cells that intersect the given level set.");
+
+    output_queue_size_ = 2;
+    add_parameter("output queue size",
+                  output_queue_size_,
+                  "Number of preallocated snapshot buffers for asynchronous "
+                  "output. The time loop only stalls if all buffers are "
+                  "waiting to be written out");
+  }
+
+
+  template <int dim, typename Number>
+  VTUOutput<dim, Number>::~VTUOutput()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      terminate_ = true;
+      condition_.notify_all();
+    }
+    if (writer_thread_.joinable())
+      writer_thread_.join();
   }
 
 
@@ -90,10 +249,35 @@ namespace ryujin
     std::cout << "VTUOutput<dim, Number>::prepare()" << std::endl;
 #endif
 
-    const auto &partitioner = offline_data_->scalar_partitioner();
+    using Field = typename DerivedQuantities<dim, Number>::Field;
+    derived_quantities_->request(Field::schlieren);
+    if constexpr (dim > 1)
+      derived_quantities_->request(Field::vorticity);
+
+    AssertThrow(output_error_bounds_.empty() ||
+                    output_error_bounds_.size() == problem_dimension,
+                dealii::ExcMessage("The number of output error bounds must "
+                                   "match the number of conserved components"));
+
+    /*
+     * (Re)allocate snapshot buffers, which invalidates all cached patches
+     * and mesh files. We have to wait for the writer thread to finish
+     * all pending snapshots first:
+     */
+    AssertThrow(output_queue_size_ >= 1,
+                dealii::ExcMessage("The output queue size must be at least "
+                                   "one"));
 
-    for (auto &it : quantities_)
-      it.reinit(partitioner);
+    wait();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshots_.clear();
+    snapshots_.resize(output_queue_size_);
+    free_snapshots_.clear();
+    for (unsigned int i = 0; i < output_queue_size_; ++i)
+      free_snapshots_.push_back(i);
+
+    hdf5_mesh_filenames_.clear();
   }
 
 
@@ -110,163 +294,78 @@ namespace ryujin
     std::cout << "VTUOutput<dim, Number>::schedule_output()" << std::endl;
 #endif
 
-    constexpr auto simd_length = VectorizedArray<Number>::size();
-
     const auto &affine_constraints = offline_data_->affine_constraints();
     const auto &sparsity_simd = offline_data_->sparsity_pattern_simd();
-    const auto &lumped_mass_matrix = offline_data_->lumped_mass_matrix();
-    const auto &cij_matrix = offline_data_->cij_matrix();
-    const auto &boundary_map = offline_data_->boundary_map();
 
-    const unsigned int n_internal = offline_data_->n_locally_internal();
     const unsigned int n_locally_owned = offline_data_->n_locally_owned();
 
+    /*
+     * Check out temporary vectors for the state and the postprocessed
+     * quantities from the scratch vector pool. They are handed back once
+     * the snapshot holds a copy of all point data:
+     */
+
+    const auto &scalar_partitioner = offline_data_->scalar_partitioner();
+
+    std::vector<ScratchVectorPool::Pointer<scalar_type>> scratch_vectors;
+    for (unsigned int k = 0; k < problem_dimension + n_quantities; ++k)
+      scratch_vectors.push_back(
+          scratch_vector_pool_->checkout<scalar_type>(scalar_partitioner));
+
+    std::array<scalar_type *, problem_dimension> state_vector;
+    for (unsigned int k = 0; k < problem_dimension; ++k)
+      state_vector[k] = scratch_vectors[k].get();
+
+    std::array<scalar_type *, n_quantities> quantities;
+    for (unsigned int k = 0; k < n_quantities; ++k)
+      quantities[k] = scratch_vectors[problem_dimension + k].get();
+
     /*
      * Step 1: Copy state vector:
      */
     {
       unsigned int d = 0;
-      for (auto &it : state_vector_) {
-        it.reinit(offline_data_->scalar_partitioner());
-        U.extract_component(it, d++);
+      for (auto *vector : state_vector) {
+        auto &it = *vector;
+        U.extract_component(it, d);
         affine_constraints.distribute(it);
+
+        if (!output_error_bounds_.empty()) {
+          const Number error_bound = output_error_bounds_[d];
+          for (auto &value : it)
+            value = LossyCompression::round_to_error_bound(value, error_bound);
+        }
+
         it.update_ghost_values();
+        ++d;
       }
     }
 
     /*
-     * Step 2: Compute r_i and r_i_max, r_i_min:
+     * Step 2: Compute r_i and r_i_max, r_i_min (from the unrounded state):
      */
 
-    std::atomic<Number> r_i_max{0.};
-    std::atomic<Number> r_i_min{std::numeric_limits<Number>::infinity()};
-    std::atomic<Number> v_i_max{0.};
-    std::atomic<Number> v_i_min{std::numeric_limits<Number>::infinity()};
-
-    {
-      RYUJIN_PARALLEL_REGION_BEGIN
-
-      Number r_i_max_on_subrange = 0.;
-      Number r_i_min_on_subrange = std::numeric_limits<Number>::infinity();
-      Number v_i_max_on_subrange = 0.;
-      Number v_i_min_on_subrange = std::numeric_limits<Number>::infinity();
-
-      RYUJIN_OMP_FOR
-      for (unsigned int i = 0; i < n_locally_owned; ++i) {
-
-        const unsigned int row_length = sparsity_simd.row_length(i);
-
-        /* Skip constrained degrees of freedom */
-        if (row_length == 1)
-          continue;
-
-        Tensor<1, dim, Number> grad_rho_i;
-        curl_type curl_v_i;
+    using Field = typename DerivedQuantities<dim, Number>::Field;
+    derived_quantities_->compute(U, t);
 
-        /* Skip diagonal. */
-        const unsigned int *js = sparsity_simd.columns(i);
-        for (unsigned int col_idx = 1; col_idx < row_length; ++col_idx) {
-          const auto j =
-              *(i < n_internal ? js + col_idx * simd_length : js + col_idx);
-
-          rank1_type U_j;
-          for (unsigned int d = 0; d < problem_dimension; ++d)
-            U_j[d] = state_vector_[d].local_element(j);
-          const auto M_j = ProblemDescription::momentum(U_j);
-
-          const auto c_ij = cij_matrix.get_tensor(i, col_idx);
-
-          const auto rho_j = ProblemDescription::density(U_j);
-
-          grad_rho_i += c_ij * rho_j;
-
-          if constexpr (dim == 2) {
-            curl_v_i[0] += cross_product_2d(c_ij) * M_j / rho_j;
-          } else if constexpr (dim == 3) {
-            curl_v_i += cross_product_3d(c_ij, M_j / rho_j);
-          }
-        }
-
-        /* Fix up boundaries: */
-
-        const auto range = boundary_map.equal_range(i);
-        for (auto it = range.first; it != range.second; ++it) {
-          const auto [normal, id, _] = it->second;
-          /* Remove normal components of the gradient on the boundary: */
-          if (id == Boundary::slip || id == Boundary::no_slip) {
-            grad_rho_i -= 1. * (grad_rho_i * normal) * normal;
-          } else {
-            grad_rho_i = 0.;
-          }
-          /* Only retain the normal component of the curl on the boundary: */
-          if constexpr (dim == 2) {
-            curl_v_i = 0.;
-          } else if constexpr (dim == 3) {
-            curl_v_i = (curl_v_i * normal) * normal;
-          }
-        }
-
-
-        /* Populate quantities: */
-
-        const Number m_i = lumped_mass_matrix.local_element(i);
-
-        Tensor<1, n_quantities, Number> quantities;
-
-        quantities[0] = grad_rho_i.norm() / m_i;
-        if constexpr (dim == 2) {
-          quantities[1] = curl_v_i[0] / m_i;
-        } else if constexpr (dim == 3) {
-          quantities[1] = curl_v_i.norm() / m_i;
-        }
-        quantities[n_quantities - 1] = residual_mu.local_element(i);
-
-        r_i_max_on_subrange = std::max(r_i_max_on_subrange, quantities[0]);
-        r_i_min_on_subrange = std::min(r_i_min_on_subrange, quantities[0]);
-        if constexpr (dim > 1) {
-          v_i_max_on_subrange =
-              std::max(v_i_max_on_subrange, std::abs(quantities[1]));
-          v_i_min_on_subrange =
-              std::min(v_i_min_on_subrange, std::abs(quantities[1]));
-        }
-
-        for (unsigned int j = 0; j < n_quantities; ++j)
-          quantities_[j].local_element(i) = quantities[j];
-      }
-
-      /* Synchronize over all threads: */
-
-      Number temp = r_i_max.load();
-      while (temp < r_i_max_on_subrange &&
-             !r_i_max.compare_exchange_weak(temp, r_i_max_on_subrange))
-        ;
-      temp = r_i_min.load();
-      while (temp > r_i_min_on_subrange &&
-             !r_i_min.compare_exchange_weak(temp, r_i_min_on_subrange))
-        ;
-
-      temp = v_i_max.load();
-      while (temp < v_i_max_on_subrange &&
-             !v_i_max.compare_exchange_weak(temp, v_i_max_on_subrange))
-        ;
-      temp = v_i_min.load();
-      while (temp > v_i_min_on_subrange &&
-             !v_i_min.compare_exchange_weak(temp, v_i_min_on_subrange))
-        ;
-
-      RYUJIN_PARALLEL_REGION_END
-    }
+    const auto &schlieren = derived_quantities_->field(Field::schlieren);
+    const scalar_type *vorticity = nullptr;
+    if constexpr (dim > 1)
+      vorticity = &derived_quantities_->field(Field::vorticity);
 
     /*
-     * And synchronize over all processors: Add +-eps to avoid division by
-     * zero in the exponentiation further down below.
+     * Add +-eps to avoid division by zero in the exponentiation further
+     * down below.
      */
 
     constexpr auto eps = std::numeric_limits<Number>::epsilon();
-    r_i_max.store(Utilities::MPI::max(r_i_max.load() + eps, mpi_communicator_));
-    r_i_min.store(Utilities::MPI::min(r_i_min.load() - eps, mpi_communicator_));
-    v_i_max.store(Utilities::MPI::max(v_i_max.load() + eps, mpi_communicator_));
-    v_i_min.store(Utilities::MPI::min(v_i_min.load() - eps, mpi_communicator_));
+    Number r_i_min, r_i_max;
+    std::tie(r_i_min, r_i_max) = derived_quantities_->bounds(Field::schlieren);
+    Number v_i_min = 0.;
+    Number v_i_max = 0.;
+    if constexpr (dim > 1)
+      std::tie(v_i_min, v_i_max) =
+          derived_quantities_->bounds(Field::vorticity);
 
     /*
      * Step 3: Normalize schlieren and vorticity:
@@ -284,18 +383,25 @@ namespace ryujin
         if (row_length == 1)
           continue;
 
-        auto &r_i = quantities_[0].local_element(i);
-        r_i = Number(1.) - std::exp(-schlieren_beta_ * (r_i - r_i_min) /
-                                    (r_i_max - r_i_min));
+        const auto r_i = schlieren.local_element(i);
+        quantities[0]->local_element(i) = LossyCompression::round_to_fixed_rate(
+            Number(1.) - std::exp(-schlieren_beta_ * (r_i - r_i_min + eps) /
+                                  (r_i_max - r_i_min + Number(2.) * eps)),
+            quantities_fixed_rate_bits_);
 
         if constexpr (dim > 1) {
-          auto &v_i = quantities_[1].local_element(i);
+          const auto v_i = vorticity->local_element(i);
           const auto magnitude =
               Number(1.) -
-              std::exp(-vorticity_beta_ * (std::abs(v_i) - v_i_min) /
-                       (v_i_max - v_i_min));
-          v_i = std::copysign(magnitude, v_i);
+              std::exp(-vorticity_beta_ * (std::abs(v_i) - v_i_min + eps) /
+                       (v_i_max - v_i_min + Number(2.) * eps));
+          quantities[1]->local_element(i) =
+              LossyCompression::round_to_fixed_rate(
+                  std::copysign(magnitude, v_i), quantities_fixed_rate_bits_);
         }
+
+        quantities[n_quantities - 1]->local_element(i) =
+            residual_mu.local_element(i);
       }
 
       RYUJIN_PARALLEL_REGION_END
@@ -305,142 +411,334 @@ namespace ryujin
      * Step 4: Fix up constraints and distribute:
      */
 
-    for (auto &it : quantities_) {
-      affine_constraints.distribute(it);
-      it.update_ghost_values();
+    for (auto *it : quantities) {
+      affine_constraints.distribute(*it);
+      it->update_ghost_values();
     }
 
     /*
-     * Step 5: DataOut:
+     * Step 5: Acquire a free snapshot buffer:
      */
 
-    auto data_out = std::make_unique<dealii::DataOut<dim>>();
-    auto data_out_levelsets = std::make_unique<dealii::DataOut<dim>>();
+    const unsigned int index = acquire_snapshot();
+    Snapshot &snapshot = snapshots_[index];
+
+    /*
+     * Step 6: DataOut:
+     *
+     * We build patches only once per snapshot buffer after prepare() has
+     * been called and afterwards only update the point data. This copies
+     * all data into the snapshot, from here on @p U and @p residual_mu
+     * can be modified again.
+     */
 
     const auto &discretization = offline_data_->discretization();
     const auto &mapping = discretization.mapping();
     const auto patch_order = discretization.finite_element().degree - 1;
 
-    if (output_full) {
-      data_out->attach_dof_handler(offline_data_->dof_handler());
+    std::vector<const scalar_type *> vectors;
+    for (const auto &it : scratch_vectors)
+      vectors.push_back(it.get());
 
+    const auto attach_data_vectors = [&](auto &data_out) {
+      data_out.attach_dof_handler(offline_data_->dof_handler());
       for (unsigned int i = 0; i < problem_dimension; ++i)
-        data_out->add_data_vector(state_vector_[i],
-                                  ProblemDescription::component_names<dim>[i]);
+        data_out.add_data_vector(*state_vector[i],
+                                 ProblemDescription::component_names<dim>[i]);
       for (unsigned int i = 0; i < n_quantities; ++i)
-        data_out->add_data_vector(quantities_[i], component_names[i]);
-
-      data_out->build_patches(mapping, patch_order);
+        data_out.add_data_vector(*quantities[i], component_names[i]);
+    };
+
+    snapshot.name = name;
+    snapshot.t = t;
+    snapshot.cycle = cycle;
+    snapshot.output_full = output_full;
+    snapshot.output_levelsets = output_levelsets && manifolds_.size() != 0;
+
+    if (snapshot.output_full) {
+      auto &data_out = snapshot.data_out;
+      if (!data_out) {
+        data_out = std::make_unique<CachedDataOut<dim, Number>>();
+        attach_data_vectors(*data_out);
+        data_out->cache_patches(
+            offline_data_->dof_handler(),
+            mapping,
+            patch_order,
+            [](const auto &cell) {
+              return cell->is_active() && cell->is_locally_owned();
+            },
+            vectors);
+      } else {
+        data_out->update_point_data(vectors);
+      }
 
       DataOutBase::VtkFlags flags(
           t, cycle, true, DataOutBase::VtkFlags::best_speed);
       data_out->set_flags(flags);
     }
 
-    if (output_levelsets && manifolds_.size() != 0) {
-      data_out_levelsets->attach_dof_handler(offline_data_->dof_handler());
+    if (snapshot.output_levelsets) {
+      auto &data_out_levelsets = snapshot.data_out_levelsets;
+      if (!data_out_levelsets) {
+        data_out_levelsets = std::make_unique<CachedDataOut<dim, Number>>();
+        attach_data_vectors(*data_out_levelsets);
 
-      for (unsigned int i = 0; i < problem_dimension; ++i)
-        data_out_levelsets->add_data_vector(
-            state_vector_[i], ProblemDescription::component_names<dim>[i]);
-      for (unsigned int i = 0; i < n_quantities; ++i)
-        data_out_levelsets->add_data_vector(quantities_[i], component_names[i]);
-
-      /*
-       * Specify an output filter that selects only cells for output that are
-       * in the viscinity of a specified set of output planes:
-       */
-
-      std::vector<std::shared_ptr<FunctionParser<dim>>> level_set_functions;
-      for (const auto &expression : manifolds_)
-        level_set_functions.emplace_back(
-            std::make_shared<FunctionParser<dim>>(expression));
-
-      data_out_levelsets->set_cell_selection(
-          [level_set_functions](const auto &cell) {
-            if (!cell->is_active() || cell->is_artificial())
-              return false;
-
-            for (const auto &function : level_set_functions) {
-
-              unsigned int above = 0;
-              unsigned int below = 0;
-
-              for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell;
-                   ++v) {
-                const auto vertex = cell->vertex(v);
-                constexpr auto eps = std::numeric_limits<Number>::epsilon();
-                if (function->value(vertex) >= 0. - 100. * eps)
-                  above++;
-                if (function->value(vertex) <= 0. + 100. * eps)
-                  below++;
-                if (above > 0 && below > 0)
-                  return true;
-              }
-            }
+        /*
+         * Specify an output filter that selects only cells for output
+         * that are in the viscinity of a specified set of output planes:
+         */
+
+        std::vector<std::shared_ptr<FunctionParser<dim>>> level_set_functions;
+        for (const auto &expression : manifolds_)
+          level_set_functions.emplace_back(
+              std::make_shared<FunctionParser<dim>>(expression));
+
+        const auto cell_selection = [level_set_functions](const auto &cell) {
+          if (!cell->is_active() || cell->is_artificial())
             return false;
-          });
 
-      data_out_levelsets->build_patches(mapping, patch_order);
+          for (const auto &function : level_set_functions) {
+
+            unsigned int above = 0;
+            unsigned int below = 0;
+
+            for (unsigned int v = 0; v < GeometryInfo<dim>::vertices_per_cell;
+                 ++v) {
+              const auto vertex = cell->vertex(v);
+              constexpr auto eps = std::numeric_limits<Number>::epsilon();
+              if (function->value(vertex) >= 0. - 100. * eps)
+                above++;
+              if (function->value(vertex) <= 0. + 100. * eps)
+                below++;
+              if (above > 0 && below > 0)
+                return true;
+            }
+          }
+          return false;
+        };
+
+        data_out_levelsets->cache_patches(offline_data_->dof_handler(),
+                                          mapping,
+                                          patch_order,
+                                          cell_selection,
+                                          vectors);
+      } else {
+        data_out_levelsets->update_point_data(vectors);
+      }
 
       DataOutBase::VtkFlags flags(
           t, cycle, true, DataOutBase::VtkFlags::best_speed);
       data_out_levelsets->set_flags(flags);
     }
 
-    if (use_mpi_io_) {
-      /* synchronous IO */
-      if (output_full) {
-        data_out->write_vtu_in_parallel(
+    /* The snapshot now holds a copy of all point data: */
+    scratch_vectors.clear();
+
+    /*
+     * Step 7: Write out:
+     */
+
+    if (use_hdf5_ || use_mpi_io_) {
+      /* synchronous, collective IO */
+      write_snapshot(snapshot);
+      release_snapshot(index);
+
+    } else {
+      /* enqueue for the asynchronous writer thread: */
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_snapshots_.push_back(index);
+      max_queue_depth_ = std::max(
+          max_queue_depth_, (unsigned int)pending_snapshots_.size());
+
+      if (!writer_thread_.joinable())
+        writer_thread_ = std::thread([this]() { writer_loop(); });
+
+      condition_.notify_all();
+    }
+  }
+
+
+  template <int dim, typename Number>
+  void VTUOutput<dim, Number>::write_snapshot(const Snapshot &snapshot)
+  {
+    const auto &name = snapshot.name;
+    const auto cycle = snapshot.cycle;
+
+    if (use_hdf5_) {
+      if (snapshot.output_full)
+        write_hdf5(*snapshot.data_out, name, snapshot.t, cycle);
+      if (snapshot.output_levelsets)
+        write_hdf5(*snapshot.data_out_levelsets,
+                   name + "-levelsets",
+                   snapshot.t,
+                   cycle);
+
+    } else if (use_mpi_io_) {
+      if (snapshot.output_full)
+        snapshot.data_out->write_vtu_in_parallel(
             name + "_" + Utilities::to_string(cycle, 6) + ".vtu",
             mpi_communicator_);
-      }
-      if (output_levelsets && manifolds_.size() != 0) {
-        data_out_levelsets->write_vtu_in_parallel(
+      if (snapshot.output_levelsets)
+        snapshot.data_out_levelsets->write_vtu_in_parallel(
             name + "-levelsets_" + Utilities::to_string(cycle, 6) + ".vtu",
             mpi_communicator_);
-      }
 
     } else {
+      if (snapshot.output_full)
+        snapshot.data_out->write_vtu_with_pvtu_record(
+            "", name, cycle, mpi_communicator_, 6);
+      if (snapshot.output_levelsets)
+        snapshot.data_out_levelsets->write_vtu_with_pvtu_record(
+            "", name + "-levelsets", cycle, mpi_communicator_, 6);
+    }
+  }
 
-      /* schedule asynchronous writeback: */
-      background_thread_status = std::async(
-          std::launch::async,
-          [=,
-           data_out = std::move(data_out),
-           data_out_levelsets = std::move(data_out_levelsets)]() mutable {
-            if (output_full) {
-              data_out->write_vtu_with_pvtu_record(
-                  "", name, cycle, mpi_communicator_, 6);
-            }
-            if (output_levelsets && manifolds_.size() != 0) {
-              data_out_levelsets->write_vtu_with_pvtu_record(
-                  "", name + "-levelsets", cycle, mpi_communicator_, 6);
-            }
-            /* Explicitly delete pointer to free up memory early: */
-            data_out.reset();
-            data_out_levelsets.reset();
-          });
+
+  template <int dim, typename Number>
+  std::vector<std::pair<std::string, std::size_t>>
+  VTUOutput<dim, Number>::memory_consumption() const
+  {
+    std::vector<std::pair<std::string, std::size_t>> result;
+
+    /*
+     * The writer thread only reads from the snapshot buffers, the cached
+     * patches are created and updated by schedule_output():
+     */
+    std::size_t snapshots = 0;
+    for (const auto &it : snapshots_) {
+      if (it.data_out)
+        snapshots += it.data_out->memory_consumption();
+      if (it.data_out_levelsets)
+        snapshots += it.data_out_levelsets->memory_consumption();
     }
+    result.emplace_back("snapshot buffers", snapshots);
+
+    return result;
+  }
+
+
+  template <int dim, typename Number>
+  unsigned int VTUOutput<dim, Number>::acquire_snapshot()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    ++n_snapshots_;
+
+    if (free_snapshots_.empty()) {
+      /* Back pressure: The queue is full and we have to wait. */
+      ++n_stalls_;
+      const auto start_time = std::chrono::steady_clock::now();
+      condition_.wait(lock, [&]() { return !free_snapshots_.empty(); });
+      stall_time_ += std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start_time)
+                         .count();
+    }
+
+    const unsigned int index = free_snapshots_.back();
+    free_snapshots_.pop_back();
+    return index;
+  }
+
+
+  template <int dim, typename Number>
+  void VTUOutput<dim, Number>::release_snapshot(const unsigned int index)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_snapshots_.push_back(index);
+    condition_.notify_all();
+  }
+
+
+  template <int dim, typename Number>
+  void VTUOutput<dim, Number>::writer_loop()
+  {
+    while (true) {
+      unsigned int index;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [&]() {
+          return terminate_ || !pending_snapshots_.empty();
+        });
+        if (pending_snapshots_.empty())
+          return;
+        index = pending_snapshots_.front();
+        pending_snapshots_.pop_front();
+      }
+
+      write_snapshot(snapshots_[index]);
+      release_snapshot(index);
+    }
+  }
+
+
+  template <int dim, typename Number>
+  void VTUOutput<dim, Number>::write_hdf5(const dealii::DataOut<dim> &data_out,
+                                          const std::string &name,
+                                          Number t,
+                                          unsigned int cycle)
+  {
+#ifdef DEAL_II_WITH_HDF5
+    DataOutBase::DataOutFilter data_filter(
+        DataOutBase::DataOutFilterFlags(/*filter duplicates*/ true,
+                                        /*xdmf_hdf5_output*/ true));
+    data_out.write_filtered_data(data_filter);
+
+    /*
+     * The mesh only changes when prepare() is called (after a
+     * refinement), so we write it alongside the first output cycle that
+     * follows:
+     */
+    auto &entries = xdmf_entries_[name];
+    const bool write_mesh_file = hdf5_mesh_filenames_.count(name) == 0;
+    if (write_mesh_file)
+      hdf5_mesh_filenames_[name] =
+          name + "-mesh_" + Utilities::to_string(cycle, 6) + ".h5";
+
+    const std::string &mesh_filename = hdf5_mesh_filenames_[name];
+    const std::string solution_filename =
+        name + "_" + Utilities::to_string(cycle, 6) + ".h5";
+
+    data_out.write_hdf5_parallel(data_filter,
+                                 write_mesh_file,
+                                 mesh_filename,
+                                 solution_filename,
+                                 mpi_communicator_);
+
+    /* The XDMF index references the HDF5 files relative to its location: */
+    entries.push_back(data_out.create_xdmf_entry(
+        data_filter,
+        std::filesystem::path(mesh_filename).filename().string(),
+        std::filesystem::path(solution_filename).filename().string(),
+        t,
+        mpi_communicator_));
+
+    data_out.write_xdmf_file(entries, name + ".xdmf", mpi_communicator_);
+#else
+    (void)data_out;
+    (void)name;
+    (void)t;
+    (void)cycle;
+    AssertThrow(false,
+                dealii::ExcMessage("HDF5 output requires a deal.II library "
+                                   "configured with HDF5 support"));
+#endif
   }
 
 
   template <int dim, typename Number>
   void VTUOutput<dim, Number>::wait()
   {
-    if (background_thread_status.valid())
-      background_thread_status.wait();
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(
+        lock, [&]() { return free_snapshots_.size() == snapshots_.size(); });
   }
 
 
   template <int dim, typename Number>
   bool VTUOutput<dim, Number>::is_active()
   {
-    if (!background_thread_status.valid())
-      return false;
-
-    return (std::future_status::ready !=
-            background_thread_status.wait_for(std::chrono::nanoseconds(0)));
+    std::lock_guard<std::mutex> lock(mutex_);
+    return free_snapshots_.size() != snapshots_.size();
   }
 
 } /* namespace ryujin */
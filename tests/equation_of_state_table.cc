@@ -0,0 +1,77 @@
+#include <equation_of_state_table.h>
+
+#include <deal.II/base/vectorization.h>
+
+#include <cmath>
+#include <iostream>
+
+/*
+ * Tabulate the ideal gas equation of state and compare the bicubic
+ * interpolant against the analytic expressions (relative errors). The
+ * pressure is bilinear in (rho, e) and has to be reproduced exactly. Also
+ * check that the vectorized evaluation agrees with the scalar one and
+ * that arguments outside of the table are clamped.
+ */
+
+int main()
+{
+  using namespace ryujin;
+
+  constexpr double gamma = 7. / 5.;
+
+  const auto ideal_gas = [&](const double rho, const double e) {
+    return std::array<double, 3>{{(gamma - 1.) * rho * e,
+                                  std::sqrt(gamma * (gamma - 1.) * e),
+                                  e * std::pow(rho, 1. - gamma)}};
+  };
+
+  EquationOfStateTable table;
+  table.interpolate(129, 129, {{0.1, 2.}}, {{0.5, 5.}}, ideal_gas);
+
+  double error[3] = {0., 0., 0.};
+  for (unsigned int i = 0; i <= 100; ++i)
+    for (unsigned int j = 0; j <= 100; ++j) {
+      const double rho = 0.1 + 1.9 * i / 100.;
+      const double e = 0.5 + 4.5 * j / 100.;
+      const auto exact = ideal_gas(rho, e);
+      for (unsigned int q = 0; q < 3; ++q) {
+        const auto value = table.evaluate(
+            EquationOfStateTable::Quantity(q), rho, e);
+        error[q] = std::max(
+            error[q], std::abs(value - exact[q]) / std::abs(exact[q]));
+      }
+    }
+
+  std::cout << std::boolalpha;
+  std::cout << "pressure exact: " << (error[0] < 1.e-12) << std::endl;
+  std::cout << "speed of sound accurate: " << (error[1] < 1.e-5) << std::endl;
+  std::cout << "specific entropy accurate: " << (error[2] < 1.e-4)
+            << std::endl;
+
+  using VA = dealii::VectorizedArray<double>;
+  VA rho, e;
+  for (unsigned int k = 0; k < VA::size(); ++k) {
+    rho[k] = 0.3 + 0.17 * k;
+    e[k] = 4.9 - 0.61 * k;
+  }
+
+  bool consistent = true;
+  for (unsigned int q = 0; q < 3; ++q) {
+    const auto quantity = EquationOfStateTable::Quantity(q);
+    const VA values = table.evaluate(quantity, rho, e);
+    for (unsigned int k = 0; k < VA::size(); ++k)
+      consistent &=
+          std::abs(values[k] - table.evaluate(quantity, rho[k], e[k])) <
+          1.e-14;
+  }
+  std::cout << "vectorized evaluation consistent: " << consistent
+            << std::endl;
+
+  const double clamped =
+      table.evaluate(EquationOfStateTable::pressure, 10., 10.);
+  std::cout << "clamped to table range: "
+            << (std::abs(clamped - (gamma - 1.) * 2. * 5.) < 1.e-12)
+            << std::endl;
+
+  return 0;
+}
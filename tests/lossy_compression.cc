@@ -0,0 +1,79 @@
+#include <lossy_compression.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+/*
+ * Round trip of the error-bounded lossy coder on a smooth, interleaved
+ * three component field. We only print robust predicates: the pointwise
+ * error bound, exactness of the lossless fallback, and the compression
+ * ratio.
+ */
+
+int main()
+{
+  using namespace ryujin::LossyCompression;
+
+  constexpr unsigned int n_values = 10000;
+  constexpr unsigned int stride = 3;
+
+  std::vector<double> values(n_values * stride);
+  for (unsigned int i = 0; i < n_values; ++i)
+    for (unsigned int d = 0; d < stride; ++d)
+      values[i * stride + d] =
+          std::sin(0.001 * i * (d + 1)) + 1.5 * d + 0.25 * std::cos(0.01 * i);
+
+  for (const double error_bound : {1.e-3, 1.e-6, 0.}) {
+    std::vector<double> result(values.size(), 0.);
+    std::size_t n_bytes = 0;
+
+    for (unsigned int d = 0; d < stride; ++d) {
+      const auto bytes =
+          compress(values.data() + d, n_values, stride, error_bound);
+      n_bytes += bytes.size();
+      decompress(bytes, result.data() + d, n_values, stride, error_bound);
+    }
+
+    double max_error = 0.;
+    for (unsigned int i = 0; i < values.size(); ++i)
+      max_error = std::max(max_error, std::abs(values[i] - result[i]));
+
+    const double bytes_per_value = double(n_bytes) / values.size();
+
+    std::cout << "error bound = " << error_bound << std::endl;
+    if (error_bound > 0.) {
+      std::cout << "  error within bound: " << std::boolalpha
+                << (max_error <= error_bound * (1. + 1.e-12)) << std::endl;
+      std::cout << "  less than 4 bytes per value: " << std::boolalpha
+                << (bytes_per_value < 4.) << std::endl;
+    } else {
+      std::cout << "  lossless round trip: " << std::boolalpha
+                << (max_error == 0.) << std::endl;
+    }
+  }
+
+  /* Non-finite values fall back to lossless storage: */
+  {
+    std::vector<double> data{1., std::nan(""), 3.};
+    std::vector<double> result(3, 0.);
+    decompress(compress(data.data(), 3, 1, 1.e-2), result.data(), 3, 1, 1.e-2);
+    std::cout << "non-finite fallback: " << std::boolalpha
+              << (result[0] == 1. && std::isnan(result[1]) && result[2] == 3.)
+              << std::endl;
+  }
+
+  /* Fixed rate rounding: */
+  {
+    double max_error = 0.;
+    for (unsigned int i = 0; i <= 1000; ++i) {
+      const double value = -1. + 0.002 * i;
+      max_error =
+          std::max(max_error, std::abs(round_to_fixed_rate(value, 8) - value));
+    }
+    std::cout << "fixed rate (8 bits) error within 1/254: " << std::boolalpha
+              << (max_error <= 1. / 254. + 1.e-14) << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,90 @@
+#include <multicomponent_vector.h>
+
+#include <iostream>
+
+/*
+ * Check that the structure_of_arrays layout of MultiComponentVector
+ * returns the same values as the (default) array_of_structures layout
+ * for all scalar, vectorized, and indirect accessors.
+ */
+
+int main()
+{
+  constexpr int simd_length = 4;
+  constexpr int n_comp = 3;
+  constexpr unsigned int size = 37;
+
+  using VA = dealii::VectorizedArray<double, simd_length>;
+
+  dealii::IndexSet locally_owned(size);
+  locally_owned.add_range(0, size);
+  dealii::IndexSet locally_relevant(size);
+  auto partitioner = std::make_shared<dealii::Utilities::MPI::Partitioner>(
+      locally_owned, locally_relevant, MPI_COMM_SELF);
+
+  ryujin::MultiComponentVector<double, n_comp, simd_length> aos;
+  constexpr auto layout = ryujin::MultiComponentLayout::structure_of_arrays;
+  ryujin::MultiComponentVector<double, n_comp, simd_length, layout> soa;
+  aos.reinit_with_scalar_partitioner(partitioner);
+  soa.reinit_with_scalar_partitioner(partitioner);
+
+  for (unsigned int i = 0; i < size; ++i) {
+    dealii::Tensor<1, n_comp> tensor;
+    for (unsigned int k = 0; k < n_comp; ++k)
+      tensor[k] = 100. * k + i;
+    aos.write_tensor(tensor, i);
+    soa.write_tensor(tensor, i);
+  }
+
+  std::cout << "soa component 1, entries 0..3:";
+  for (unsigned int i = 0; i < 4; ++i)
+    std::cout << " " << soa.component(1)[i];
+  std::cout << std::endl;
+
+  double error = 0.;
+
+  for (unsigned int i = 0; i < size; ++i)
+    error += (aos.get_tensor(i) - soa.get_tensor(i)).norm();
+
+  for (unsigned int i = 0; i + simd_length <= size; i += simd_length) {
+    const auto U_aos = aos.get_vectorized_tensor(i);
+    const auto U_soa = soa.get_vectorized_tensor(i);
+    for (unsigned int k = 0; k < n_comp; ++k)
+      for (unsigned int l = 0; l < simd_length; ++l)
+        error += std::abs(U_aos[k][l] - U_soa[k][l]);
+  }
+
+  const unsigned int js[simd_length] = {36, 3, 17, 0};
+  {
+    const auto U_aos = aos.get_vectorized_tensor(js);
+    const auto U_soa = soa.get_vectorized_tensor(js);
+    for (unsigned int k = 0; k < n_comp; ++k)
+      for (unsigned int l = 0; l < simd_length; ++l)
+        error += std::abs(U_aos[k][l] - U_soa[k][l]);
+  }
+
+  /* Scale a SIMD batch and write it back: */
+  {
+    const auto U = soa.get_vectorized_tensor(8);
+    dealii::Tensor<1, n_comp, VA> U_new;
+    for (unsigned int k = 0; k < n_comp; ++k)
+      U_new[k] = 2. * U[k];
+    soa.write_vectorized_tensor(U_new, 8);
+    aos.write_vectorized_tensor(U_new, 8);
+  }
+
+  dealii::LinearAlgebra::distributed::Vector<double> scalar_aos(partitioner);
+  dealii::LinearAlgebra::distributed::Vector<double> scalar_soa(partitioner);
+  for (unsigned int k = 0; k < n_comp; ++k) {
+    aos.extract_component(scalar_aos, k);
+    soa.extract_component(scalar_soa, k);
+    scalar_soa -= scalar_aos;
+    error += scalar_soa.l1_norm();
+  }
+
+  std::cout << "soa component 2, entry 9: " << soa.component(2)[9]
+            << std::endl;
+  std::cout << "l1 norm (aos): " << aos.l1_norm() << std::endl;
+  std::cout << "l1 norm (soa): " << soa.l1_norm() << std::endl;
+  std::cout << "accumulated error: " << error << std::endl;
+}
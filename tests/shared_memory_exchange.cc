@@ -0,0 +1,53 @@
+#include <shared_memory_exchange.h>
+
+#include <iostream>
+
+/*
+ * Exchange a ring of messages with SharedMemoryExchange: Every rank sends
+ * two values to its left and two values to its right neighbor. The
+ * exchange is repeated to check that the send buffer can be reused.
+ */
+
+int main(int argc, char *argv[])
+{
+  dealii::Utilities::MPI::MPI_InitFinalize mpi_initialization(argc, argv, 1);
+
+  const MPI_Comm mpi_communicator = MPI_COMM_WORLD;
+  const unsigned int rank =
+      dealii::Utilities::MPI::this_mpi_process(mpi_communicator);
+  const unsigned int n_ranks =
+      dealii::Utilities::MPI::n_mpi_processes(mpi_communicator);
+  const unsigned int left = (rank + n_ranks - 1) % n_ranks;
+  const unsigned int right = (rank + 1) % n_ranks;
+
+  const ryujin::SharedMemoryExchange::targets_type targets{
+      {left, 2 * sizeof(double)}, {right, 2 * sizeof(double)}};
+  ryujin::SharedMemoryExchange exchange(targets, targets, mpi_communicator);
+
+  unsigned int n_errors = 0;
+  for (unsigned int round = 0; round < 3; ++round) {
+    auto buffer = exchange.send_buffer<double>();
+    buffer[0] = rank;
+    buffer[1] = round;
+    buffer[2] = rank;
+    buffer[3] = 10 + round;
+
+    double received[4];
+    exchange.start(received);
+    exchange.finish();
+
+    /* From the left we receive its message to the right and vice versa: */
+    if (received[0] != left || received[1] != 10 + round ||
+        received[2] != right || received[3] != round)
+      ++n_errors;
+
+    if (rank == 0)
+      std::cout << "round " << round << ": " << received[0] << " "
+                << received[1] << " " << received[2] << " " << received[3]
+                << std::endl;
+  }
+
+  n_errors = dealii::Utilities::MPI::sum(n_errors, mpi_communicator);
+  if (rank == 0)
+    std::cout << "errors: " << n_errors << std::endl;
+}
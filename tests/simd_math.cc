@@ -0,0 +1,68 @@
+#include <simd.h>
+#include <simd.template.h>
+
+#include <deal.II/base/vectorization.h>
+
+#include <iostream>
+#include <limits>
+
+using namespace ryujin;
+using namespace dealii;
+
+/*
+ * Compare the vectorized log, exp, and pow against the scalar std
+ * implementations and check the documented bound of 4 ULP (relative to
+ * max(1, |log x|) for the logarithm).
+ */
+
+template <typename Number>
+void test(const std::string &name)
+{
+  using VA = VectorizedArray<Number>;
+  constexpr auto eps = std::numeric_limits<Number>::epsilon();
+
+  Number error_log = 0.;
+  Number error_exp = 0.;
+  Number error_pow = 0.;
+
+  for (unsigned int i = 0; i < 1000; ++i) {
+    VA x, y;
+    for (unsigned int k = 0; k < VA::size(); ++k) {
+      const Number s = Number(i * VA::size() + k) / (1000 * VA::size());
+      x[k] = std::pow(Number(10.), Number(-3. + 6. * s)); /* [1e-3, 1e3] */
+      y[k] = Number(-20. + 40. * s);                       /* [-20, 20] */
+    }
+
+    const auto log_x = ryujin::log(x);
+    const auto exp_y = ryujin::exp(y);
+    const auto pow_x = ryujin::pow(x, Number(1.4));
+
+    for (unsigned int k = 0; k < VA::size(); ++k) {
+      /* Reference values are computed in double precision: */
+      const auto error = [](const Number a, const double b) {
+        return Number(std::abs(a - b) / std::max(1., std::abs(b)));
+      };
+      const auto relative = [](const Number a, const double b) {
+        return Number(std::abs(a - b) / std::abs(b));
+      };
+      const double x_k = x[k];
+      const double y_k = y[k];
+      const double b = Number(1.4);
+      error_log = std::max(error_log, error(log_x[k], std::log(x_k)));
+      error_exp = std::max(error_exp, relative(exp_y[k], std::exp(y_k)));
+      error_pow = std::max(error_pow, relative(pow_x[k], std::pow(x_k, b)));
+    }
+  }
+
+  std::cout << name << std::boolalpha << std::endl;
+  std::cout << "  log within 4 ULP: " << (error_log <= 4 * eps) << std::endl;
+  std::cout << "  exp within 4 ULP: " << (error_exp <= 4 * eps) << std::endl;
+  std::cout << "  pow within 4 ULP: " << (error_pow <= 4 * eps) << std::endl;
+}
+
+int main()
+{
+  test<double>("double");
+  test<float>("float");
+  return 0;
+}
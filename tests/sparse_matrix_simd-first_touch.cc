@@ -0,0 +1,100 @@
+#include <sparse_matrix_simd.h>
+#include <sparse_matrix_simd.template.h>
+
+#include <iostream>
+
+/*
+ * Streaming benchmark for the first-touch initialization of
+ * SparseMatrixSIMD. We stream over a matrix that was first touched with
+ * the static OpenMP schedule of the compute loops and compare against an
+ * array of the same size that was touched by a single thread. On a
+ * multi-socket machine (with OMP_PROC_BIND=spread or close and
+ * OMP_PLACES=cores) the former reaches the aggregate bandwidth of all
+ * sockets, the latter is limited by the bandwidth of socket 0.
+ *
+ * Timings are printed to std::cerr and do not enter the test output.
+ */
+
+int main()
+{
+  constexpr int simd_length = 4;
+  constexpr unsigned int n_rows = 1 << 21;
+  constexpr unsigned int n_repetitions = 20;
+
+  dealii::DynamicSparsityPattern spars(n_rows, n_rows);
+  for (unsigned int i = 0; i < n_rows; ++i) {
+    spars.add(i, (i + n_rows - 1) % n_rows);
+    spars.add(i, i);
+    spars.add(i, (i + 1) % n_rows);
+  }
+  spars.compress();
+
+  dealii::IndexSet locally_owned(n_rows);
+  locally_owned.add_range(0, n_rows);
+  dealii::IndexSet locally_relevant(n_rows);
+  auto partitioner = std::make_shared<dealii::Utilities::MPI::Partitioner>(
+      locally_owned, locally_relevant, MPI_COMM_SELF);
+
+  ryujin::SparsityPatternSIMD<simd_length> sparsity(n_rows, spars, partitioner);
+  ryujin::SparseMatrixSIMD<double, 1, simd_length> matrix(sparsity);
+
+  /* Reference: an array of the same size touched by a single thread. */
+  const unsigned int n_entries = sparsity.n_nonzero_elements();
+  dealii::AlignedVector<double> serial;
+  serial.resize_fast(n_entries);
+  std::fill(serial.begin(), serial.end(), 0.);
+
+  /* Set all entries to one: */
+
+  for (unsigned int i = 0; i < n_rows; ++i)
+    for (unsigned int j = 0; j < sparsity.row_length(i); ++j)
+      matrix.write_entry(1., i, j);
+  std::fill(serial.begin(), serial.end(), 1.);
+
+  const auto stream = [&](const auto &get_entry) {
+    double sum = 0.;
+    double time = 0.;
+    for (unsigned int r = 0; r < n_repetitions; ++r) {
+      sum = 0.;
+      const double start = omp_get_wtime();
+      RYUJIN_PARALLEL_REGION_BEGIN
+      dealii::VectorizedArray<double> sum_on_thread = 0.;
+      RYUJIN_OMP_FOR
+      for (unsigned int i = 0; i < n_rows; i += simd_length) {
+        for (unsigned int j = 0; j < sparsity.row_length(i); ++j)
+          sum_on_thread += get_entry(i, j);
+      }
+      RYUJIN_OMP_CRITICAL
+      for (unsigned int k = 0; k < simd_length; ++k)
+        sum += sum_on_thread[k];
+      RYUJIN_PARALLEL_REGION_END
+      time += omp_get_wtime() - start;
+    }
+    const double bandwidth =
+        double(n_repetitions) * n_entries * sizeof(double) / time * 1.e-9;
+    return std::make_pair(sum, bandwidth);
+  };
+
+  const auto [sum_first_touch, bandwidth_first_touch] =
+      stream([&](const unsigned int i, const unsigned int j) {
+        return matrix.get_vectorized_entry(i, j);
+      });
+
+  const auto [sum_serial, bandwidth_serial] =
+      stream([&](const unsigned int i, const unsigned int j) {
+        dealii::VectorizedArray<double> result;
+        result.load(serial.data() + 3 * i + j * simd_length);
+        return result;
+      });
+
+  std::cout << "Number of entries:     " << n_entries << std::endl;
+  std::cout << "Sum (first touch):     " << sum_first_touch << std::endl;
+  std::cout << "Sum (serial touch):    " << sum_serial << std::endl;
+
+  std::cerr << "Threads:                   " << omp_get_max_threads()
+            << std::endl;
+  std::cerr << "Bandwidth (first touch):   " << bandwidth_first_touch
+            << " GB/s" << std::endl;
+  std::cerr << "Bandwidth (serial touch):  " << bandwidth_serial << " GB/s"
+            << std::endl;
+}
@@ -0,0 +1,90 @@
+#include <sparse_matrix_simd.h>
+#include <sparse_matrix_simd.template.h>
+
+#include <iomanip>
+#include <iostream>
+
+/*
+ * Lane utilization of the SIMD layout for the 9-point stencil of Q1
+ * elements on an n x n grid with the interior degrees of freedom
+ * numbered first (as done by DoFRenumbering::internal_range()). We
+ * compare the current layout (SIMD-blocked internal rows followed by CSR
+ * rows) against a SELL-C-sigma layout with C = simd_length for the
+ * remaining rows.
+ *
+ * The time for a sweep over all matrix entries is printed to std::cerr
+ * and does not enter the test output.
+ */
+
+int main()
+{
+  constexpr int simd_length = 4;
+
+  for (const unsigned int n : {8u, 32u, 128u}) {
+    const unsigned int n_rows = n * n;
+
+    /* Number interior grid points first, followed by the boundary: */
+    std::vector<unsigned int> index(n_rows);
+    unsigned int n_interior = 0;
+    for (unsigned int y = 1; y + 1 < n; ++y)
+      for (unsigned int x = 1; x + 1 < n; ++x)
+        index[y * n + x] = n_interior++;
+    unsigned int counter = n_interior;
+    for (unsigned int y = 0; y < n; ++y)
+      for (unsigned int x = 0; x < n; ++x)
+        if (x == 0 || y == 0 || x + 1 == n || y + 1 == n)
+          index[y * n + x] = counter++;
+
+    dealii::DynamicSparsityPattern spars(n_rows, n_rows);
+    for (unsigned int y = 0; y < n; ++y)
+      for (unsigned int x = 0; x < n; ++x)
+        for (unsigned int dy = 0; dy < 3; ++dy)
+          for (unsigned int dx = 0; dx < 3; ++dx) {
+            if (x + dx < 1 || y + dy < 1 || x + dx > n || y + dy > n)
+              continue;
+            spars.add(index[y * n + x],
+                      index[(y + dy - 1) * n + (x + dx - 1)]);
+          }
+    spars.compress();
+
+    dealii::IndexSet locally_owned(n_rows);
+    locally_owned.add_range(0, n_rows);
+    dealii::IndexSet locally_relevant(n_rows);
+    auto partitioner = std::make_shared<dealii::Utilities::MPI::Partitioner>(
+        locally_owned, locally_relevant, MPI_COMM_SELF);
+
+    const unsigned int n_internal = n_interior - n_interior % simd_length;
+    ryujin::SparsityPatternSIMD<simd_length> sparsity(
+        n_internal, spars, partitioner);
+    ryujin::SparseMatrixSIMD<double, 1, simd_length> matrix(sparsity);
+
+    for (unsigned int i = 0; i < n_rows; ++i)
+      for (unsigned int j = 0; j < sparsity.row_length(i); ++j)
+        matrix.write_entry(1., i, j);
+
+    /* Time a sweep over all entries: */
+    const double start = omp_get_wtime();
+    dealii::VectorizedArray<double> sum_simd = 0.;
+    for (unsigned int i = 0; i < n_internal; i += simd_length)
+      for (unsigned int j = 0; j < sparsity.row_length(i); ++j)
+        sum_simd += matrix.get_vectorized_entry(i, j);
+    double sum = 0.;
+    for (unsigned int k = 0; k < simd_length; ++k)
+      sum += sum_simd[k];
+    for (unsigned int i = n_internal; i < n_rows; ++i)
+      for (unsigned int j = 0; j < sparsity.row_length(i); ++j)
+        sum += matrix.get_entry(i, j);
+    std::cerr << "n = " << n << ": sweep over " << sum << " entries took "
+              << omp_get_wtime() - start << "s" << std::endl;
+
+    std::cout << "n_rows = " << n_rows << ", n_internal = " << n_internal
+              << std::endl;
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "  current layout: " << sparsity.lane_utilization()
+              << std::endl;
+    for (const unsigned int sigma : {1u, 4u, 32u, n_rows})
+      std::cout << "  SELL-4-" << sigma << ": "
+                << sparsity.sell_c_sigma_lane_utilization(sigma) << std::endl;
+    std::cout << std::defaultfloat;
+  }
+}
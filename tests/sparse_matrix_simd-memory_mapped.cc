@@ -0,0 +1,87 @@
+#include <sparse_matrix_simd.h>
+#include <sparse_matrix_simd.template.h>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include <sstream>
+
+int main()
+{
+  dealii::DynamicSparsityPattern spars(14, 14);
+  spars.add(0, 0);
+  spars.add(0, 1);
+  spars.add(0, 13);
+  for (unsigned int i = 1; i < 12; ++i) {
+    spars.add(i, i - 1);
+    spars.add(i, i);
+    spars.add(i, i + 1);
+  }
+  spars.add(12, 12);
+  spars.add(12, 11);
+  spars.add(13, 13);
+  spars.add(13, 0);
+  spars.compress();
+
+  dealii::IndexSet locally_owned(14);
+  locally_owned.add_range(0, 14);
+  dealii::IndexSet locally_relevant(14);
+  auto partitioner = std::make_shared<dealii::Utilities::MPI::Partitioner>(
+      locally_owned, locally_relevant, MPI_COMM_SELF);
+
+  ryujin::SparsityPatternSIMD<4> my_sparsity(12, spars, partitioner);
+  ryujin::SparseMatrixSIMD<double, 2, 4> my_sparse(my_sparsity);
+  for (unsigned i = 0; i < my_sparsity.n_rows(); ++i)
+    for (unsigned j = 0; j < my_sparsity.row_length(i); ++j) {
+      dealii::Tensor<1, 2, double> entry;
+      entry[0] = i * 3 + j;
+      entry[1] = 2. * entry[0];
+      my_sparse.write_tensor(entry, i, j);
+    }
+
+  /* Write the pattern and the matrix: */
+
+  std::stringstream stream;
+  {
+    ryujin::MemoryMappedFileWriter writer("sparse_matrix_simd.data");
+    boost::archive::binary_oarchive archive(stream);
+    my_sparsity.save(archive, writer);
+    my_sparse.save(archive, writer);
+  }
+
+  /* Map them again: */
+
+  const auto file =
+      std::make_shared<ryujin::MemoryMappedFile>("sparse_matrix_simd.data");
+
+  ryujin::SparsityPatternSIMD<4> mapped_sparsity;
+  ryujin::SparseMatrixSIMD<double, 2, 4> mapped_sparse;
+  {
+    boost::archive::binary_iarchive archive(stream);
+    mapped_sparsity.load(archive, file, partitioner);
+    mapped_sparse.load(archive, mapped_sparsity, file);
+  }
+
+  std::cout << "Matrix entries row by row" << std::endl;
+  for (unsigned int i = 0; i < mapped_sparsity.n_rows(); ++i) {
+    for (unsigned int j = 0; j < mapped_sparsity.row_length(i); ++j) {
+      const auto a = mapped_sparse.get_tensor(i, j);
+      std::cout << a << "  ";
+    }
+    std::cout << std::endl;
+  }
+
+  std::cout << "Matrix entries transposed by SIMD row" << std::endl;
+  for (unsigned int i = 0; i < 12; i += 4) {
+    for (unsigned int j = 0; j < 3; ++j) {
+      const auto a = mapped_sparse.get_vectorized_transposed_tensor(i, j);
+      std::cout << a[0] << "   ";
+    }
+    std::cout << std::endl;
+  }
+
+  std::cout << "Identical to original: "
+            << (mapped_sparse.get_tensor(13, 1) ==
+                my_sparse.get_tensor(13, 1))
+            << std::endl;
+}